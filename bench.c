@@ -0,0 +1,591 @@
+// Headless benchmark of the table operations.
+//
+// Loads one or more datasets (a data directory each, e.g. written by
+// generate_dataset at different scales) with the application's own
+// loaders and times load and save of every file, the *_find_by_* lookups,
+// the sorts, the calculate_*_stats functions, index builds,
+// mark_attendance, auth_login and the exports. Links only the modules that
+// do not need GTK. Results go to a JSON file so runs can be compared
+// release to release; the modules' own log lines go to stdout.
+//
+// Build and run: ./build.sh bench [options]
+// Usage: student_bench [--data DIR]... [--out FILE] [--scratch DIR]
+//                      [--repeat N] [--lookups N] [--mutations N] [--logins N]
+//                      [--password P]
+//
+// Saves and exports are written to the scratch directory, never to the
+// dataset. Operations that change the tables (sorts, mark_attendance,
+// auth_login) run once per dataset, after the read-only ones.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <glib.h>
+#include "include/config.h"
+#include "include/auth.h"
+#include "include/student.h"
+#include "include/professor.h"
+#include "include/grade.h"
+#include "include/attendance.h"
+#include "include/club.h"
+#include "include/prof_note.h"
+#include "include/stats.h"
+#include "include/search.h"
+#include "include/complete.h"
+#include "include/export.h"
+#include "include/arena.h"
+#include "include/utils.h"
+
+#define BENCH_MAX_DATASETS 16
+#define BENCH_DEFAULT_OUT "bench_results.json"
+#define BENCH_DEFAULT_SCRATCH "bench_scratch"
+#define BENCH_DEFAULT_REPEAT 3
+#define BENCH_DEFAULT_LOOKUPS 10000
+#define BENCH_DEFAULT_MUTATIONS 1000
+#define BENCH_DEFAULT_LOGINS 200
+#define BENCH_DEFAULT_PASSWORD "Password123!"   // Password of generate_dataset accounts
+// trier_notes_par_etudiant() is quadratic; larger grade tables are skipped
+#define BENCH_QUADRATIC_LIMIT 50000
+
+typedef struct {
+    const char* out_file;
+    const char* scratch_dir;
+    const char* password;
+    int repeat;
+    int lookups;
+    int mutations;
+    int logins;
+} BenchOptions;
+
+typedef struct {
+    UserList* users;
+    StudentList* students;
+    ProfessorList* professors;
+    liste_note* grades;
+    AttendanceList* attendance;
+    ClubList* clubs;
+    MembershipList* memberships;
+    ListeModules* modules;
+    liste_examen* exams;
+    ProfessorNoteList* prof_notes;
+    SearchIndex* search;
+    CompletionIndex* completer;
+} BenchTables;
+
+typedef struct {
+    FILE* out;
+    const BenchOptions* options;
+    int results;                // results written in the current dataset
+} BenchReport;
+
+// ============================================================================
+// JSON OUTPUT
+// ============================================================================
+
+static void json_string(FILE* out, const char* s) {
+    fputc('"', out);
+    for (; *s; s++) {
+        unsigned char c = (unsigned char)*s;
+        if (c == '"' || c == '\\') {
+            fprintf(out, "\\%c", c);
+        } else if (c < 0x20) {
+            fprintf(out, "\\u%04x", c);
+        } else {
+            fputc(c, out);
+        }
+    }
+    fputc('"', out);
+}
+
+// One timed operation. ops is the number of calls or rows it covers.
+static void bench_record(BenchReport* report, const char* group, const char* name,
+                         long long ops, int runs, double best, double mean) {
+    FILE* out = report->out;
+    fprintf(out, "%s\n        {\"group\": ", report->results++ ? "," : "");
+    json_string(out, group);
+    fprintf(out, ", \"name\": ");
+    json_string(out, name);
+    fprintf(out, ", \"ops\": %lld, \"runs\": %d, \"seconds_min\": %.6f, \"seconds_mean\": %.6f",
+            ops, runs, best, mean);
+    if (ops > 0) {
+        fprintf(out, ", \"ns_per_op\": %.1f", best * 1e9 / (double)ops);
+    }
+    fprintf(out, "}");
+    fflush(out);
+    fprintf(stderr, "  %-8s %-40s %10lld ops %10.4f s\n", group, name, ops, best);
+}
+
+static void bench_skip(BenchReport* report, const char* group, const char* name, const char* reason) {
+    FILE* out = report->out;
+    fprintf(out, "%s\n        {\"group\": ", report->results++ ? "," : "");
+    json_string(out, group);
+    fprintf(out, ", \"name\": ");
+    json_string(out, name);
+    fprintf(out, ", \"skipped\": ");
+    json_string(out, reason);
+    fprintf(out, "}");
+    fprintf(stderr, "  %-8s %-40s skipped: %s\n", group, name, reason);
+}
+
+// Times stmt runs times and records the fastest and the mean run
+#define BENCH_RUNS(report, runs, group, name, ops, stmt) do {              \
+        double best_ = 0.0, total_ = 0.0;                                  \
+        for (int run_ = 0; run_ < (runs); run_++) {                        \
+            gint64 start_ = g_get_monotonic_time();                        \
+            stmt;                                                          \
+            double seconds_ = (g_get_monotonic_time() - start_) / 1e6;     \
+            total_ += seconds_;                                            \
+            if (run_ == 0 || seconds_ < best_) best_ = seconds_;           \
+        }                                                                  \
+        bench_record((report), (group), (name), (ops), (runs), best_, total_ / (runs)); \
+    } while (0)
+
+#define BENCH(report, group, name, ops, stmt) \
+    BENCH_RUNS(report, (report)->options->repeat, group, name, ops, stmt)
+#define BENCH_ONCE(report, group, name, ops, stmt) \
+    BENCH_RUNS(report, 1, group, name, ops, stmt)
+
+// ============================================================================
+// TABLES
+// ============================================================================
+
+static int tables_create(BenchTables* t) {
+    memset(t, 0, sizeof(*t));
+    t->users = user_list_create();
+    t->students = student_list_create();
+    t->professors = professor_list_create();
+    t->grades = liste_note_create();
+    t->attendance = attendance_list_create();
+    t->clubs = club_list_create();
+    t->memberships = membership_list_create();
+    t->modules = liste_module_create();
+    t->exams = liste_examen_create();
+    t->prof_notes = prof_note_list_create();
+    t->search = search_index_create();
+    t->completer = completion_index_create();
+    if (!t->users || !t->students || !t->professors || !t->grades || !t->attendance ||
+        !t->clubs || !t->memberships || !t->modules || !t->exams || !t->prof_notes ||
+        !t->search || !t->completer) {
+        return 0;
+    }
+    strcpy(t->modules->filename, "modules.txt");
+    strcpy(t->exams->filename, "examens.txt");
+    return 1;
+}
+
+static void tables_destroy(BenchTables* t) {
+    // The indexes watch the lists, so they go first
+    if (t->search) search_index_destroy(t->search);
+    if (t->completer) completion_index_destroy(t->completer);
+    if (t->users) user_list_destroy(t->users);
+    if (t->students) student_list_destroy(t->students);
+    if (t->professors) professor_list_destroy(t->professors);
+    if (t->grades) liste_note_destroy(t->grades);
+    if (t->attendance) attendance_list_destroy(t->attendance);
+    if (t->clubs) club_list_destroy(t->clubs);
+    if (t->memberships) membership_list_destroy(t->memberships);
+    if (t->modules) liste_module_destroy(t->modules);
+    if (t->exams) liste_examen_destroy(t->exams);
+    if (t->prof_notes) prof_note_list_destroy(t->prof_notes);
+    memset(t, 0, sizeof(*t));
+}
+
+static void prof_notes_path(char* buffer, size_t size) {
+    if (!utils_get_data_file_path(PROF_NOTES_FILE, buffer, size)) buffer[0] = '\0';
+}
+
+// ============================================================================
+// BENCHMARKS
+// ============================================================================
+
+// Deterministic sample of indices into a table of count rows
+static int* sample_indices(int count, int n) {
+    int* indices = malloc(sizeof(int) * (n > 0 ? n : 1));
+    if (!indices) return NULL;
+    guint32 state = 2463534242u;
+    for (int i = 0; i < n; i++) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        indices[i] = count > 0 ? (int)(state % (guint32)count) : 0;
+    }
+    return indices;
+}
+
+static void bench_load(BenchReport* r, BenchTables* t) {
+    char notes_path[UTILS_MAX_PATH_LENGTH];
+    prof_notes_path(notes_path, sizeof(notes_path));
+
+    BENCH(r, "load", USERS_FILE, t->users->count, auth_load_users(t->users, USERS_FILE));
+    BENCH(r, "load", STUDENTS_FILE, t->students->count,
+          student_list_load_from_file(t->students, STUDENTS_FILE));
+    BENCH(r, "load", "professors.txt", t->professors->count,
+          professor_list_load_from_file(t->professors, "professors.txt"));
+    BENCH(r, "load", GRADES_FILE, t->grades->count, grade_list_load_from_file(t->grades, GRADES_FILE));
+    BENCH(r, "load", ATTENDANCE_FILE, t->attendance->count,
+          attendance_list_load_from_file(t->attendance, ATTENDANCE_FILE));
+    BENCH(r, "load", CLUBS_FILE, t->clubs->count, club_list_load_from_file(t->clubs, CLUBS_FILE));
+    BENCH(r, "load", MEMBERSHIPS_FILE, t->memberships->count,
+          membership_list_load_from_file(t->memberships, MEMBERSHIPS_FILE));
+    // These loaders append, so they run once
+    BENCH_ONCE(r, "load", "modules.txt", t->modules->count, remplire_liste_appartit_file(t->modules));
+    BENCH_ONCE(r, "load", "examens.txt", t->exams->count, liste_examen_a_partir_file(t->exams));
+    BENCH_ONCE(r, "load", PROF_NOTES_FILE, t->prof_notes->count, prof_note_load(t->prof_notes, notes_path));
+
+    BENCH(r, "index", "search_index_build", t->students->count,
+          search_index_build(t->search, t->students));
+    BENCH(r, "index", "completion_index_build",
+          (long long)t->students->count + t->professors->count + t->users->count,
+          completion_index_build(t->completer, t->students, t->professors, t->users));
+}
+
+static void bench_lookups(BenchReport* r, BenchTables* t) {
+    int n = r->options->lookups;
+    volatile int hits = 0;
+
+    int* s = sample_indices(t->students->count, n);
+    if (s && t->students->count > 0) {
+        Student* st = t->students->students;
+        BENCH(r, "lookup", "student_list_find_by_id", n,
+              for (int i = 0; i < n; i++) hits += student_list_find_by_id(t->students, st[s[i]].id) != NULL);
+        BENCH(r, "lookup", "student_list_find_by_email", n,
+              for (int i = 0; i < n; i++) hits += student_list_find_by_email(t->students, st[s[i]].email) != NULL);
+        BENCH(r, "lookup", "student_list_find_by_name", n,
+              for (int i = 0; i < n; i++) hits += student_list_find_by_name(t->students, st[s[i]].first_name,
+                                                                            st[s[i]].last_name) != NULL);
+    }
+    free(s);
+
+    s = sample_indices(t->users->count, n);
+    if (s && t->users->count > 0) {
+        User* u = t->users->users;
+        BENCH(r, "lookup", "user_list_find_by_id", n,
+              for (int i = 0; i < n; i++) hits += user_list_find_by_id(t->users, u[s[i]].id) != NULL);
+        BENCH(r, "lookup", "user_list_find_by_username", n,
+              for (int i = 0; i < n; i++) hits += user_list_find_by_username(t->users, u[s[i]].username) != NULL);
+        BENCH(r, "lookup", "user_list_find_by_email", n,
+              for (int i = 0; i < n; i++) hits += user_list_find_by_email(t->users, u[s[i]].email) != NULL);
+    }
+    free(s);
+
+    s = sample_indices(t->professors->count, n);
+    if (s && t->professors->count > 0) {
+        Professor* p = t->professors->professors;
+        BENCH(r, "lookup", "professor_list_find_by_id", n,
+              for (int i = 0; i < n; i++) hits += professor_list_find_by_id(t->professors, p[s[i]].id) != NULL);
+        BENCH(r, "lookup", "professor_list_find_by_email", n,
+              for (int i = 0; i < n; i++) hits += professor_list_find_by_email(t->professors, p[s[i]].email) != NULL);
+        BENCH(r, "lookup", "professor_list_find_by_name", n,
+              for (int i = 0; i < n; i++) hits += professor_list_find_by_name(t->professors, p[s[i]].first_name,
+                                                                              p[s[i]].last_name) != NULL);
+    }
+    free(s);
+
+    s = sample_indices(t->clubs->count, n);
+    if (s && t->clubs->count > 0) {
+        Club* c = t->clubs->clubs;
+        BENCH(r, "lookup", "club_list_find_by_id", n,
+              for (int i = 0; i < n; i++) hits += club_list_find_by_id(t->clubs, c[s[i]].id) != NULL);
+        BENCH(r, "lookup", "club_list_find_by_name", n,
+              for (int i = 0; i < n; i++) hits += club_list_find_by_name(t->clubs, c[s[i]].name) != NULL);
+    }
+    free(s);
+
+    s = sample_indices(t->memberships->count, n);
+    if (s && t->memberships->count > 0) {
+        ClubMembership* m = t->memberships->memberships;
+        BENCH(r, "lookup", "membership_list_find_by_id", n,
+              for (int i = 0; i < n; i++) hits += membership_list_find_by_id(t->memberships, m[s[i]].id) != NULL);
+    }
+    free(s);
+
+    s = sample_indices(t->attendance->count, n);
+    if (s && t->attendance->count > 0) {
+        AttendanceRecord* a = t->attendance->records;
+        BENCH(r, "lookup", "attendance_list_find_by_student_date", n,
+              for (int i = 0; i < n; i++) hits += attendance_list_find_by_student_date(t->attendance,
+                                                      a[s[i]].student_id, a[s[i]].date) != NULL);
+        BENCH(r, "lookup", "attendance_list_find_by_course_date", n,
+              for (int i = 0; i < n; i++) hits += attendance_list_find_by_course_date(t->attendance,
+                                                      a[s[i]].course_id, a[s[i]].date) != NULL);
+    }
+    free(s);
+
+    s = sample_indices(t->prof_notes->count, n);
+    if (s && t->prof_notes->count > 0) {
+        ProfessorNote* pn = t->prof_notes->notes;
+        int found;
+        // The results live in the scratch arena; reset it as the UI loop would
+        BENCH(r, "lookup", "prof_note_find_by_student", n,
+              for (int i = 0; i < n; i++) {
+                  hits += prof_note_find_by_student(t->prof_notes, pn[s[i]].student_id, &found) != NULL;
+                  arena_scratch_reset();
+              });
+        BENCH(r, "lookup", "prof_note_find_by_module", n,
+              for (int i = 0; i < n; i++) {
+                  hits += prof_note_find_by_module(t->prof_notes, pn[s[i]].module_id, &found) != NULL;
+                  arena_scratch_reset();
+              });
+    }
+    free(s);
+    (void)hits;
+}
+
+static void bench_stats(BenchReport* r, BenchTables* t) {
+    BENCH(r, "stats", "calculate_student_stats", t->students->count,
+          free_student_stats(calculate_student_stats(t->students, t->grades)));
+    BENCH(r, "stats", "calculate_grade_stats", t->grades->count,
+          free_grade_stats(calculate_grade_stats(t->grades, t->modules)));
+    BENCH(r, "stats", "calculate_attendance_stats", t->attendance->count,
+          free_attendance_stats(calculate_attendance_stats(t->attendance)));
+    BENCH(r, "stats", "calculate_club_stats", t->memberships->count,
+          free_club_stats(calculate_club_stats(t->clubs, t->memberships)));
+    BENCH(r, "stats", "calculate_system_stats", t->students->count,
+          free_system_stats(calculate_system_stats(t->students, t->modules, t->grades,
+                                                   t->attendance, t->clubs, t->memberships)));
+    arena_scratch_reset();
+}
+
+static void bench_exports(BenchReport* r, BenchTables* t) {
+    static const struct {
+        ExportKind kind;
+        const char* name;
+    } kinds[] = {
+        { EXPORT_STUDENTS, "students" },
+        { EXPORT_GRADES, "grades" },
+        { EXPORT_ATTENDANCE, "attendance" },
+        { EXPORT_CLUBS, "clubs" },
+        { EXPORT_MEMBERSHIPS, "memberships" },
+        { EXPORT_PROF_NOTES, "prof_notes" },
+    };
+    const void* tables[] = {
+        t->students, t->grades, t->attendance, t->clubs, t->memberships, t->prof_notes
+    };
+
+    ExportExamIndex* exams = export_exam_index_build(t->exams, t->modules);
+    for (int i = 0; i < (int)G_N_ELEMENTS(kinds); i++) {
+        for (int format = EXPORT_CSV; format <= EXPORT_NDJSON; format++) {
+            ExportOptions options = { 0 };
+            options.kind = kinds[i].kind;
+            options.format = format;
+            options.exams = exams;
+
+            char name[64], path[UTILS_MAX_PATH_LENGTH];
+            const char* extension = format == EXPORT_CSV ? "csv" : "ndjson";
+            snprintf(name, sizeof(name), "export %s %s", kinds[i].name, extension);
+            snprintf(path, sizeof(path), "%s/export_%s.%s", r->options->scratch_dir, kinds[i].name, extension);
+
+            int rows = 0;
+            BENCH(r, "export", name, rows, export_table_to_file(tables[i], &options, path, &rows));
+        }
+    }
+    export_exam_index_destroy(exams);
+}
+
+static void bench_save(BenchReport* r, BenchTables* t) {
+    char notes_path[UTILS_MAX_PATH_LENGTH];
+    utils_set_data_dir(r->options->scratch_dir);
+    prof_notes_path(notes_path, sizeof(notes_path));
+
+    BENCH(r, "save", USERS_FILE, t->users->count, auth_save_users(t->users, USERS_FILE));
+    BENCH(r, "save", STUDENTS_FILE, t->students->count, student_list_save_to_file(t->students, STUDENTS_FILE));
+    BENCH(r, "save", "professors.txt", t->professors->count,
+          professor_list_save_to_file(t->professors, "professors.txt"));
+    BENCH(r, "save", GRADES_FILE, t->grades->count, grade_list_save_to_file(t->grades, GRADES_FILE));
+    BENCH(r, "save", ATTENDANCE_FILE, t->attendance->count,
+          attendance_list_save_to_file(t->attendance, ATTENDANCE_FILE));
+    BENCH(r, "save", CLUBS_FILE, t->clubs->count, club_list_save_to_file(t->clubs, CLUBS_FILE));
+    BENCH(r, "save", MEMBERSHIPS_FILE, t->memberships->count,
+          membership_list_save_to_file(t->memberships, MEMBERSHIPS_FILE));
+    BENCH(r, "save", "modules.txt", t->modules->count, sauvegarder_modules_ds_file(*t->modules));
+    BENCH(r, "save", "examens.txt", t->exams->count, sauvegarder_liste_examen_ds_file(t->exams));
+    BENCH(r, "save", PROF_NOTES_FILE, t->prof_notes->count, prof_note_save(t->prof_notes, notes_path));
+}
+
+// Operations that change the tables; each runs once
+static void bench_mutations(BenchReport* r, BenchTables* t) {
+    BENCH_ONCE(r, "sort", "student_list_sort_by_name", t->students->count, student_list_sort_by_name(t->students));
+    BENCH_ONCE(r, "sort", "student_list_sort_by_gpa", t->students->count, student_list_sort_by_gpa(t->students));
+    BENCH_ONCE(r, "sort", "student_list_sort_by_id", t->students->count, student_list_sort_by_id(t->students));
+    BENCH_ONCE(r, "sort", "professor_list_sort_by_name", t->professors->count,
+               professor_list_sort_by_name(t->professors));
+    BENCH_ONCE(r, "sort", "professor_list_sort_by_department", t->professors->count,
+               professor_list_sort_by_department(t->professors));
+    BENCH_ONCE(r, "sort", "professor_list_sort_by_id", t->professors->count,
+               professor_list_sort_by_id(t->professors));
+    BENCH_ONCE(r, "sort", "trie_liste_id", t->modules->count, trie_liste_id(*t->modules, 1));
+    BENCH_ONCE(r, "sort", "trie_liste_examen_id", t->exams->count, trie_liste_examen_id(*t->exams, 1));
+    if (t->grades->count <= BENCH_QUADRATIC_LIMIT) {
+        BENCH_ONCE(r, "sort", "trier_notes_par_etudiant", t->grades->count, trier_notes_par_etudiant(t->grades));
+    } else {
+        bench_skip(r, "sort", "trier_notes_par_etudiant", "quadratic, table above BENCH_QUADRATIC_LIMIT");
+    }
+
+    int n = r->options->mutations;
+    int students = t->students->count;
+    if (students > 0 && n > 0) {
+        Student* st = t->students->students;
+        // A day after the last generated session, so every call adds a record
+        time_t day = (time_t)1767225600;
+        BENCH_ONCE(r, "mutate", "mark_attendance", n,
+                   for (int i = 0; i < n; i++) {
+                       mark_attendance(t->attendance, st[i % students].id, 1 + i % 10, day + i,
+                                       ATTENDANCE_PRESENT, 1);
+                   });
+    }
+
+    int logins = r->options->logins;
+    int* s = sample_indices(t->users->count, logins);
+    Session* session = session_create();
+    if (s && session && t->users->count > 0 && logins > 0) {
+        char (*names)[50] = malloc(sizeof(*names) * logins);
+        if (names) {
+            for (int i = 0; i < logins; i++) {
+                snprintf(names[i], sizeof(names[i]), "%s", t->users->users[s[i]].username);
+            }
+            volatile int ok = 0;
+            BENCH_ONCE(r, "auth", "auth_login", logins,
+                       for (int i = 0; i < logins; i++) ok += auth_login(t->users, names[i], r->options->password, session));
+            fprintf(stderr, "  auth_login: %d of %d logins accepted\n", ok, logins);
+            free(names);
+        }
+    }
+    if (session) session_destroy(session);
+    free(s);
+}
+
+static int bench_dataset(BenchReport* r, const char* data_dir, int first) {
+    BenchTables t;
+    if (!tables_create(&t)) {
+        fprintf(stderr, "[ERROR] Out of memory\n");
+        tables_destroy(&t);
+        return 0;
+    }
+    fprintf(stderr, "[INFO] Dataset %s\n", data_dir);
+
+    FILE* out = r->out;
+    fprintf(out, "%s\n    {\n      \"data_dir\": ", first ? "" : ",");
+    json_string(out, data_dir);
+    fprintf(out, ",\n      \"results\": [");
+    r->results = 0;
+
+    utils_set_data_dir(data_dir);
+    bench_load(r, &t);
+    bench_lookups(r, &t);
+    bench_stats(r, &t);
+    bench_exports(r, &t);
+    bench_save(r, &t);
+    bench_mutations(r, &t);
+    utils_set_data_dir(NULL);
+
+    fprintf(out, "\n      ],\n      \"rows\": {\"users\": %d, \"students\": %d, \"professors\": %d, "
+                 "\"grades\": %d, \"attendance\": %d, \"clubs\": %d, \"memberships\": %d, "
+                 "\"modules\": %d, \"exams\": %d, \"prof_notes\": %d}\n    }",
+            t.users->count, t.students->count, t.professors->count, t.grades->count,
+            t.attendance->count, t.clubs->count, t.memberships->count, t.modules->count,
+            t.exams->count, t.prof_notes->count);
+    fflush(out);
+
+    tables_destroy(&t);
+    arena_scratch_reset();
+    return 1;
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+static void usage(const char* program) {
+    fprintf(stderr, "Usage: %s [--data DIR]... [--out FILE] [--scratch DIR] [--repeat N]\n"
+                    "          [--lookups N] [--mutations N] [--logins N] [--password P]\n", program);
+    fprintf(stderr, "  --data DIR      dataset to benchmark, may be repeated (default data)\n");
+    fprintf(stderr, "  --out FILE      JSON results (default %s)\n", BENCH_DEFAULT_OUT);
+    fprintf(stderr, "  --scratch DIR   where saves and exports are written (default %s)\n", BENCH_DEFAULT_SCRATCH);
+    fprintf(stderr, "  --repeat N      runs of each read-only operation (default %d)\n", BENCH_DEFAULT_REPEAT);
+    fprintf(stderr, "  --lookups N     calls per lookup benchmark (default %d)\n", BENCH_DEFAULT_LOOKUPS);
+    fprintf(stderr, "  --mutations N   mark_attendance calls (default %d)\n", BENCH_DEFAULT_MUTATIONS);
+    fprintf(stderr, "  --logins N      auth_login calls (default %d)\n", BENCH_DEFAULT_LOGINS);
+    fprintf(stderr, "  --password P    password tried by auth_login (default %s)\n", BENCH_DEFAULT_PASSWORD);
+}
+
+int main(int argc, char** argv) {
+    BenchOptions options = {
+        .out_file = BENCH_DEFAULT_OUT,
+        .scratch_dir = BENCH_DEFAULT_SCRATCH,
+        .password = BENCH_DEFAULT_PASSWORD,
+        .repeat = BENCH_DEFAULT_REPEAT,
+        .lookups = BENCH_DEFAULT_LOOKUPS,
+        .mutations = BENCH_DEFAULT_MUTATIONS,
+        .logins = BENCH_DEFAULT_LOGINS,
+    };
+    const char* datasets[BENCH_MAX_DATASETS];
+    int n_datasets = 0;
+
+    for (int i = 1; i < argc; i++) {
+        const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!value || strncmp(argv[i], "--", 2) != 0) {
+            usage(argv[0]);
+            return strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        }
+        if (strcmp(argv[i], "--data") == 0) {
+            if (n_datasets == BENCH_MAX_DATASETS) {
+                fprintf(stderr, "[ERROR] At most %d datasets\n", BENCH_MAX_DATASETS);
+                return 1;
+            }
+            datasets[n_datasets++] = value;
+        } else if (strcmp(argv[i], "--out") == 0) {
+            options.out_file = value;
+        } else if (strcmp(argv[i], "--scratch") == 0) {
+            options.scratch_dir = value;
+        } else if (strcmp(argv[i], "--password") == 0) {
+            options.password = value;
+        } else if (strcmp(argv[i], "--repeat") == 0) {
+            options.repeat = atoi(value);
+        } else if (strcmp(argv[i], "--lookups") == 0) {
+            options.lookups = atoi(value);
+        } else if (strcmp(argv[i], "--mutations") == 0) {
+            options.mutations = atoi(value);
+        } else if (strcmp(argv[i], "--logins") == 0) {
+            options.logins = atoi(value);
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+        i++;
+    }
+    if (n_datasets == 0) datasets[n_datasets++] = "data";
+    if (options.repeat < 1) options.repeat = 1;
+    if (options.lookups < 0) options.lookups = 0;
+
+    if (g_mkdir_with_parents(options.scratch_dir, 0755) != 0) {
+        fprintf(stderr, "[ERROR] Cannot create %s\n", options.scratch_dir);
+        return 1;
+    }
+    FILE* out = fopen(options.out_file, "w");
+    if (!out) {
+        fprintf(stderr, "[ERROR] Cannot open %s for writing\n", options.out_file);
+        return 1;
+    }
+
+    fprintf(out, "{\n  \"version\": ");
+    json_string(out, APP_VERSION);
+    fprintf(out, ",\n  \"timestamp\": %lld,\n  \"processors\": %u,\n  \"repeat\": %d,\n"
+                 "  \"lookups\": %d,\n  \"mutations\": %d,\n  \"logins\": %d,\n  \"datasets\": [",
+            (long long)time(NULL), g_get_num_processors(), options.repeat,
+            options.lookups, options.mutations, options.logins);
+
+    BenchReport report = { out, &options, 0 };
+    int ok = 1;
+    for (int i = 0; i < n_datasets; i++) {
+        ok &= bench_dataset(&report, datasets[i], i == 0);
+    }
+
+    fprintf(out, "\n  ]\n}\n");
+    if (fclose(out) != 0) ok = 0;
+    arena_scratch_destroy();
+
+    fprintf(stderr, ok ? "[OK] Results written to %s\n" : "[ERROR] Benchmark incomplete, see %s\n",
+            options.out_file);
+    return ok ? 0 : 1;
+}
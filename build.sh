@@ -1,6 +1,82 @@
 #!/bin/bash
 # Build script for Student Management System
 
+# ./build.sh bench [options] builds and runs the headless benchmark instead
+# (see bench.c); it needs only GLib and the modules that do not use GTK
+if [ "$1" = "bench" ]; then
+    shift
+    echo "Building benchmark..."
+    cd "$(dirname "$0")"
+    BENCH_MODULES="auth student professor grade attendance club prof_note stats utils \
+        intern arena tombstone table_lock changelog search complete export"
+    BENCH_SRC=""
+    for module in $BENCH_MODULES; do
+        BENCH_SRC="$BENCH_SRC src/$module.c"
+    done
+    gcc -O2 -o /tmp/student_bench.exe bench.c $BENCH_SRC -Iinclude \
+        $(pkg-config --cflags --libs glib-2.0) -lm -Wall 2>&1 || {
+        echo "Build failed! Check errors above."
+        exit 1
+    }
+    /tmp/student_bench.exe "$@"
+    exit $?
+fi
+
+# ./build.sh cli builds the headless command-line tool alone, without GTK
+# (see include/headless.h). The GTK build runs the same commands with
+# student_mgmt --headless.
+if [ "$1" = "cli" ]; then
+    echo "Building headless CLI..."
+    cd "$(dirname "$0")"
+    CLI_MODULES="student grade attendance club prof_note stats utils intern arena \
+        tombstone table_lock changelog import export http_server"
+    CLI_SRC=""
+    for module in $CLI_MODULES; do
+        CLI_SRC="$CLI_SRC src/$module.c"
+    done
+    gcc -O2 -DHEADLESS_MAIN -o /tmp/student_cli.exe src/headless.c $CLI_SRC -Iinclude \
+        $(pkg-config --cflags --libs glib-2.0) -lm -Wall 2>&1 || {
+        echo "Build failed! Check errors above."
+        exit 1
+    }
+    echo "Build successful! Executable: /tmp/student_cli.exe"
+    exit 0
+fi
+
+# ./build.sh replica builds the read replica client library for other
+# processes (see include/replica_client.h); it needs only libc
+if [ "$1" = "replica" ]; then
+    echo "Building replica client library..."
+    cd "$(dirname "$0")"
+    gcc -O2 -c -o /tmp/replica_client.o src/replica_client.c -Iinclude -Wall 2>&1 &&
+        ar rcs /tmp/libstudent_replica.a /tmp/replica_client.o || {
+        echo "Build failed! Check errors above."
+        exit 1
+    }
+    echo "Build successful! Library: /tmp/libstudent_replica.a (headers: include/replica_client.h, include/replica_format.h)"
+    exit 0
+fi
+
+# ./build.sh test-replication builds and runs test_replication.c, a primary
+# and a forked follower exchanging changes over a Unix socket
+if [ "$1" = "test-replication" ]; then
+    echo "Building replication test..."
+    cd "$(dirname "$0")"
+    TEST_MODULES="auth student grade attendance club prof_note utils intern arena \
+        tombstone table_lock trace changelog replication"
+    TEST_SRC=""
+    for module in $TEST_MODULES; do
+        TEST_SRC="$TEST_SRC src/$module.c"
+    done
+    gcc -O2 -o /tmp/test_replication.exe test_replication.c $TEST_SRC -Iinclude \
+        $(pkg-config --cflags --libs glib-2.0) -lm -Wall 2>&1 || {
+        echo "Build failed! Check errors above."
+        exit 1
+    }
+    /tmp/test_replication.exe
+    exit $?
+fi
+
 echo "Building Student Management System..."
 
 # Get GTK flags
@@ -10,9 +86,27 @@ GTK_LIBS=$(pkg-config --libs gtk+-3.0)
 # Remove old executable if exists
 rm -f /tmp/student_mgmt.exe
 
+# Link the logo and background images into the executable when
+# glib-compile-resources is available; otherwise they are read from src/
+RESOURCE_SRC=""
+rm -f /tmp/student_mgmt_assets.c
+if command -v glib-compile-resources >/dev/null 2>&1; then
+    if glib-compile-resources --sourcedir=. --generate-source \
+        --target=/tmp/student_mgmt_assets.c src/assets.gresource.xml; then
+        RESOURCE_SRC=/tmp/student_mgmt_assets.c
+    fi
+fi
+
+# TRACE=1 ./build.sh records hot-path spans and writes them to
+# student_mgmt_trace.json at exit (see include/trace.h)
+TRACE_CFLAGS=""
+if [ "$TRACE" = "1" ]; then
+    TRACE_CFLAGS="-DTRACE_ENABLED"
+fi
+
 # Compile to /tmp directory
-gcc -o /tmp/student_mgmt.exe main.c src/*.c -Iinclude \
-    $GTK_CFLAGS $GTK_LIBS \
+gcc -o /tmp/student_mgmt.exe main.c src/*.c $RESOURCE_SRC -Iinclude \
+    $GTK_CFLAGS $GTK_LIBS $TRACE_CFLAGS \
     -lm -Wall 2>&1
 
 if [ $? -eq 0 ]; then
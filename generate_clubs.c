@@ -1,8 +1,12 @@
+// Writes the seven default clubs to data/clubs.txt.
+// Build: gcc -O2 -o generate_clubs generate_clubs.c src/intern.c src/arena.c -Iinclude $(pkg-config --cflags --libs glib-2.0)
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 #include "include/club.h"
+#include "include/intern.h"
 
 int main() {
     FILE* file = fopen("data/clubs.txt", "w");
@@ -19,7 +23,7 @@ int main() {
     clubs[0].id = 1;
     strcpy(clubs[0].name, "Quran Club");
     strcpy(clubs[0].description, "A club dedicated to Quran study and memorization");
-    strcpy(clubs[0].category, "Religious");
+    clubs[0].category = intern_string("Religious");
     clubs[0].president_id = 0;
     clubs[0].advisor_id = 0;
     clubs[0].member_count = 0;
@@ -36,7 +40,7 @@ int main() {
     clubs[1].id = 2;
     strcpy(clubs[1].name, "Sport Club");
     strcpy(clubs[1].description, "Promotes physical fitness and sports activities");
-    strcpy(clubs[1].category, "Sports");
+    clubs[1].category = intern_string("Sports");
     clubs[1].president_id = 0;
     clubs[1].advisor_id = 0;
     clubs[1].member_count = 0;
@@ -53,7 +57,7 @@ int main() {
     clubs[2].id = 3;
     strcpy(clubs[2].name, "Chess Club");
     strcpy(clubs[2].description, "Strategic thinking and chess tournaments");
-    strcpy(clubs[2].category, "Academic");
+    clubs[2].category = intern_string("Academic");
     clubs[2].president_id = 0;
     clubs[2].advisor_id = 0;
     clubs[2].member_count = 0;
@@ -70,7 +74,7 @@ int main() {
     clubs[3].id = 4;
     strcpy(clubs[3].name, "01 Club");
     strcpy(clubs[3].description, "Technology and binary enthusiasts");
-    strcpy(clubs[3].category, "Technology");
+    clubs[3].category = intern_string("Technology");
     clubs[3].president_id = 0;
     clubs[3].advisor_id = 0;
     clubs[3].member_count = 0;
@@ -87,7 +91,7 @@ int main() {
     clubs[4].id = 5;
     strcpy(clubs[4].name, "Tech Club");
     strcpy(clubs[4].description, "Programming and technology innovation");
-    strcpy(clubs[4].category, "Technology");
+    clubs[4].category = intern_string("Technology");
     clubs[4].president_id = 0;
     clubs[4].advisor_id = 0;
     clubs[4].member_count = 0;
@@ -104,7 +108,7 @@ int main() {
     clubs[5].id = 6;
     strcpy(clubs[5].name, "CSS Club");
     strcpy(clubs[5].description, "Web design and styling workshops");
-    strcpy(clubs[5].category, "Technology");
+    clubs[5].category = intern_string("Technology");
     clubs[5].president_id = 0;
     clubs[5].advisor_id = 0;
     clubs[5].member_count = 0;
@@ -121,7 +125,7 @@ int main() {
     clubs[6].id = 7;
     strcpy(clubs[6].name, "TGD Club");
     strcpy(clubs[6].description, "Graphic Design and Digital Arts");
-    strcpy(clubs[6].category, "Arts");
+    clubs[6].category = intern_string("Arts");
     clubs[6].president_id = 0;
     clubs[6].advisor_id = 0;
     clubs[6].member_count = 0;
@@ -141,7 +145,7 @@ int main() {
             c->id,
             c->name,
             c->description,
-            c->category,
+            intern_lookup(c->category),
             c->president_id,
             c->advisor_id,
             c->member_count,
@@ -157,6 +161,7 @@ int main() {
     }
     
     fclose(file);
+    intern_clear();
     printf("✓ Successfully generated 7 clubs in data/clubs.txt\n");
     return 0;
 }
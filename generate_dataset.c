@@ -0,0 +1,777 @@
+// Synthetic campus generator for scale testing.
+//
+// Writes every data file the application loads (students, users,
+// professors, modules, exams, grades, attendance, clubs, club memberships
+// and professor notes) for a campus of 1k to 10M students, in the exact
+// formats of the loaders. The records agree with each other: every student
+// has a user account with the same e-mail, grades and attendance follow the
+// modules of the student's program and year, modules name professors that
+// exist, and club member counts match the memberships.
+//
+// The output depends only on the seed and the number of students, never on
+// the number of threads: each student's rows come from a random stream
+// seeded by (seed, student id). Students are generated in blocks on worker
+// threads and the main thread writes the finished blocks in order, so the
+// files are streamed to disk and memory is bounded by the blocks in flight.
+//
+// Build: gcc -O2 -o generate_dataset generate_dataset.c -Iinclude $(pkg-config --cflags --libs glib-2.0)
+// Usage: ./generate_dataset [--students N] [--seed S] [--threads T] [--out DIR]
+//
+// Every generated account, the admin included, has the password
+// GEN_PASSWORD. Copy the files into data/ to run the application on them.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <glib.h>
+#include "include/config.h"
+#include "include/attendance.h"
+
+#define GEN_MIN_STUDENTS 1000
+#define GEN_MAX_STUDENTS 10000000
+#define GEN_DEFAULT_STUDENTS 10000
+#define GEN_DEFAULT_OUT "data_generated"
+#define GEN_BLOCK_STUDENTS 4096         // Students generated by one worker at a time
+#define GEN_SLOTS_PER_THREAD 2          // Finished blocks waiting to be written, per worker
+#define GEN_FILE_BUFFER (1 << 20)
+#define GEN_PASSWORD "Password123!"
+#define GEN_BASE_TIME 1725148800LL      // 2024-09-01, start of the generated academic year
+#define GEN_DAY 86400LL
+
+#define GEN_PROGRAMS 9
+#define GEN_YEARS 5
+#define GEN_MAX_MODULES 240             // The modules loader holds 300
+#define GEN_EXAMS_PER_MODULE 2          // Midterm and final; the exams loader holds 3000
+#define GEN_SESSIONS_PER_MODULE 4       // Attendance records per student and module
+#define GEN_MAX_CLUBS_PER_STUDENT 3
+#define GEN_MAX_NOTES_PER_STUDENT 2
+
+// Files written per student block, in the order of the streams below
+enum {
+    GEN_STUDENTS = 0,
+    GEN_USERS,
+    GEN_GRADES,
+    GEN_ATTENDANCE,
+    GEN_MEMBERSHIPS,
+    GEN_PROF_NOTES,
+    GEN_STREAM_COUNT
+};
+
+static const char* stream_files[GEN_STREAM_COUNT] = {
+    STUDENTS_FILE, USERS_FILE, GRADES_FILE, ATTENDANCE_FILE, MEMBERSHIPS_FILE, PROF_NOTES_FILE
+};
+
+// ============================================================================
+// WORD LISTS
+// ============================================================================
+
+#define N_ITEMS(a) ((int)(sizeof(a) / sizeof((a)[0])))
+
+static const char* first_names[] = {
+    "Ahmed", "Fatima", "Youssef", "Khadija", "Omar", "Salma", "Mehdi", "Imane",
+    "Hamza", "Meryem", "Anas", "Sara", "Amine", "Hiba", "Ayoub", "Nour",
+    "Karim", "Yasmine", "Ilyas", "Zineb", "Othmane", "Rim", "Adam", "Lina",
+    "Reda", "Asmae", "Bilal", "Ghita", "Zakaria", "Houda", "Ismail", "Kenza"
+};
+
+static const char* last_names[] = {
+    "Alami", "Benali", "Cherkaoui", "Diouri", "Elfassi", "Filali", "Ghazi", "Hajji",
+    "Idrissi", "Jabri", "Kettani", "Lahlou", "Mansouri", "Naciri", "Ouazzani", "Qadiri",
+    "Rachidi", "Squalli", "Tazi", "Bennani", "Berrada", "Chraibi", "Amrani", "Sefrioui",
+    "Tahiri", "Alaoui", "Bouazza", "Zniber", "Skalli", "Mouline", "Senhaji", "Benjelloun"
+};
+
+static const char* streets[] = {
+    "Rue Hassan II", "Avenue Mohammed V", "Boulevard Zerktouni", "Rue Oukaimeden",
+    "Boulevard Anfa", "Avenue des FAR", "Rue Ibn Batouta", "Boulevard Ghandi"
+};
+
+static const char* cities[] = {
+    "Casablanca", "Rabat", "Marrakech", "Fes", "Tanger", "Agadir", "Meknes", "Oujda"
+};
+
+// Program of a student; a module's filiere is its index + 1
+static const char* programs[GEN_PROGRAMS] = {
+    "Cycle Préparatoire",
+    "Génie Civil",
+    "Génie Informatique",
+    "Génie Mécanique",
+    "Génie de l'Eau et de l'Environnement",
+    "Génie Énergétiques et Énergies Renouvelables",
+    "Ingénierie des données",
+    "Transformation Digitale et Intelligence Artificielle",
+    "Génie Industriel"
+};
+
+// At most 14 characters, so that "<subject> <n>" fits an exam's module name
+static const char* subjects[] = {
+    "Mathematiques", "Physique", "Chimie", "Algorithmique", "Programmation",
+    "Electronique", "Mecanique", "Statistiques", "Bases Donnees", "Reseaux",
+    "Thermique", "Economie", "Anglais", "Communication", "Optimisation"
+};
+
+static const char* departments[] = {
+    "Preparatory Engineering", "Civil Engineering", "Computer Science",
+    "Mechanical Engineering", "Environmental Engineering", "Energy Engineering",
+    "Data Engineering", "Digital Transformation", "Industrial Engineering"
+};
+
+static const char* club_themes[] = {
+    "Chess", "Robotics", "Music", "Theatre", "Football", "Basketball", "Photography",
+    "Debate", "Hiking", "Coding", "Astronomy", "Volunteering", "Cinema", "Reading"
+};
+
+static const char* club_categories[] = {
+    "Academic", "Sports", "Arts", "Technology", "Social", "Religious"
+};
+
+static const char* weekdays[] = {
+    "Monday", "Tuesday", "Wednesday", "Thursday", "Friday"
+};
+
+static const char* note_phrases[] = {
+    "Good participation in class",
+    "Needs to review the last chapter",
+    "Excellent project work",
+    "Frequently late to sessions",
+    "Should attend the tutorial sessions",
+    "Strong progress since the midterm"
+};
+
+// ============================================================================
+// RANDOM STREAMS
+// ============================================================================
+
+typedef struct {
+    guint64 state;
+} GenRng;
+
+// splitmix64
+static guint64 rng_next(GenRng* rng) {
+    guint64 z = (rng->state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Independent stream for one record of one kind
+static GenRng rng_for(guint64 seed, guint64 kind, guint64 id) {
+    GenRng rng = { seed ^ (kind * 0xD1B54A32D192ED03ULL) ^ (id * 0x9E3779B97F4A7C15ULL) };
+    rng_next(&rng);
+    return rng;
+}
+
+static int rng_range(GenRng* rng, int n) {
+    return (int)(rng_next(rng) % (guint64)n);
+}
+
+static double rng_unit(GenRng* rng) {
+    return (double)(rng_next(rng) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static void rng_salt(GenRng* rng, char* salt) {
+    static const char alphabet[] = "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    for (int i = 0; i < 32; i++) {
+        salt[i] = alphabet[rng_range(rng, 62)];
+    }
+    salt[32] = '\0';
+}
+
+// Same as auth_hash_password() in src/auth.c
+static void auth_hash_password(const char* password, const char* salt, char* hash) {
+    char combined[256];
+    snprintf(combined, sizeof(combined), "%s%s", salt, password);
+    unsigned long long hash_value = 5381;
+    for (int i = 0; combined[i] != '\0'; i++) {
+        hash_value = ((hash_value << 5) + hash_value) + combined[i];
+    }
+    sprintf(hash, "%016llx%016llx%016llx%016llx", hash_value, hash_value ^ 0xAAAAAAAA,
+            hash_value ^ 0x55555555, hash_value ^ 0xFFFFFFFF);
+}
+
+static void lowercase_copy(char* dst, const char* src, size_t size) {
+    size_t i = 0;
+    for (; src[i] && i + 1 < size; i++) {
+        dst[i] = (char)g_ascii_tolower(src[i]);
+    }
+    dst[i] = '\0';
+}
+
+static void format_date(long long t, char* buffer, size_t size) {
+    time_t tt = (time_t)t;
+    struct tm tm_info;
+#ifdef _WIN32
+    gmtime_s(&tm_info, &tt);
+#else
+    gmtime_r(&tt, &tm_info);
+#endif
+    strftime(buffer, size, "%Y-%m-%d", &tm_info);
+}
+
+// ============================================================================
+// CAMPUS LAYOUT
+// ============================================================================
+
+// Sizes of the shared tables and the modules of each class, derived from
+// the number of students. Read-only once built.
+typedef struct {
+    int students;
+    int professors;
+    int modules;
+    int clubs;
+    guint64 seed;
+    int* class_modules[GEN_PROGRAMS][GEN_YEARS];    // module indices of each (program, year)
+    int class_module_count[GEN_PROGRAMS][GEN_YEARS];
+} Campus;
+
+static int clamp_int(long long value, int low, int high) {
+    if (value < low) return low;
+    if (value > high) return high;
+    return (int)value;
+}
+
+static int module_program(int m) { return m % GEN_PROGRAMS; }
+static int module_year(int m) { return (m / GEN_PROGRAMS) % GEN_YEARS; }
+static int module_semester(int m) { return (m / (GEN_PROGRAMS * GEN_YEARS)) % 2 + 1; }
+static int module_professor(const Campus* campus, int m) { return m % campus->professors; }
+
+// Admin first, then professors, then students
+static int professor_user_id(int p) { return 2 + p; }
+static int student_user_id(const Campus* campus, int sid) { return 1 + campus->professors + sid; }
+
+static void module_name(int m, char* buffer, size_t size) {
+    snprintf(buffer, size, "%s %d", subjects[m % N_ITEMS(subjects)], m / N_ITEMS(subjects) + 1);
+}
+
+static void professor_name(const Campus* campus, int p, char* first, size_t first_size,
+                           char* last, size_t last_size) {
+    GenRng rng = rng_for(campus->seed, 2, (guint64)p);
+    snprintf(first, first_size, "%c.", first_names[rng_range(&rng, N_ITEMS(first_names))][0]);
+    // Modules name their professor as "first last", so keep names unique
+    if (p < N_ITEMS(last_names)) {
+        snprintf(last, last_size, "%s", last_names[p]);
+    } else {
+        snprintf(last, last_size, "%s%d", last_names[p % N_ITEMS(last_names)], p / N_ITEMS(last_names) + 1);
+    }
+}
+
+static long long exam_date(int m, int e) {
+    int term = module_semester(m) - 1;
+    int week = term * 20 + (e == 0 ? 8 : 16);
+    return GEN_BASE_TIME + (week * 7 + m % 5) * GEN_DAY + (e == 0 ? 9 : 14) * 3600LL;
+}
+
+static int campus_init(Campus* campus, int students, guint64 seed) {
+    memset(campus, 0, sizeof(*campus));
+    campus->students = students;
+    campus->seed = seed;
+    campus->professors = clamp_int(students / 40, 20, 250000);
+    campus->modules = clamp_int(students / 20, 2 * GEN_PROGRAMS * GEN_YEARS, GEN_MAX_MODULES);
+    campus->clubs = clamp_int(students / 150, 7, 100000);
+
+    for (int m = 0; m < campus->modules; m++) {
+        campus->class_module_count[module_program(m)][module_year(m)]++;
+    }
+    for (int p = 0; p < GEN_PROGRAMS; p++) {
+        for (int y = 0; y < GEN_YEARS; y++) {
+            campus->class_modules[p][y] = malloc(sizeof(int) * (campus->class_module_count[p][y] + 1));
+            if (!campus->class_modules[p][y]) return 0;
+            campus->class_module_count[p][y] = 0;
+        }
+    }
+    for (int m = 0; m < campus->modules; m++) {
+        int p = module_program(m), y = module_year(m);
+        campus->class_modules[p][y][campus->class_module_count[p][y]++] = m;
+    }
+    return 1;
+}
+
+static void campus_destroy(Campus* campus) {
+    for (int p = 0; p < GEN_PROGRAMS; p++) {
+        for (int y = 0; y < GEN_YEARS; y++) {
+            free(campus->class_modules[p][y]);
+        }
+    }
+}
+
+// ============================================================================
+// SHARED TABLES
+// ============================================================================
+
+static FILE* open_output(const char* dir, const char* name) {
+    char* path = g_build_filename(dir, name, NULL);
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        printf("[ERROR] Cannot open %s for writing\n", path);
+    } else {
+        setvbuf(file, NULL, _IOFBF, GEN_FILE_BUFFER);
+    }
+    g_free(path);
+    return file;
+}
+
+static int close_output(FILE* file, const char* name) {
+    int failed = ferror(file);
+    if (fclose(file) != 0) failed = 1;
+    if (failed) printf("[ERROR] Failed to write %s\n", name);
+    return !failed;
+}
+
+static void write_staff_users(const Campus* campus, FILE* users) {
+    char salt[33], hash[129];
+    GenRng rng = rng_for(campus->seed, 3, 0);
+    rng_salt(&rng, salt);
+    auth_hash_password(GEN_PASSWORD, salt, hash);
+    fprintf(users, "%d,%s,%s,%s,%s,%d,%lld,%lld,%d\n",
+            1, "admin", "admin@school.com", hash, salt, ROLE_ADMIN,
+            GEN_BASE_TIME, GEN_BASE_TIME, 1);
+
+    for (int p = 0; p < campus->professors; p++) {
+        char first[8], last[64], username[64], login[80];
+        professor_name(campus, p, first, sizeof(first), last, sizeof(last));
+        snprintf(login, sizeof(login), "%c.%s", first[0], last);
+        lowercase_copy(username, login, sizeof(username));
+
+        rng = rng_for(campus->seed, 3, (guint64)p + 1);
+        rng_salt(&rng, salt);
+        auth_hash_password(GEN_PASSWORD, salt, hash);
+        fprintf(users, "%d,%s,%s@university.edu,%s,%s,%d,%lld,%lld,%d\n",
+                professor_user_id(p), username, username, hash, salt, ROLE_TEACHER,
+                GEN_BASE_TIME, GEN_BASE_TIME, 1);
+    }
+}
+
+static int write_professors(const Campus* campus, const char* dir) {
+    FILE* file = open_output(dir, "professors.txt");
+    if (!file) return 0;
+
+    for (int p = 0; p < campus->professors; p++) {
+        char first[8], last[64], login[80], username[64];
+        professor_name(campus, p, first, sizeof(first), last, sizeof(last));
+        snprintf(login, sizeof(login), "%c.%s", first[0], last);
+        lowercase_copy(username, login, sizeof(username));
+
+        GenRng rng = rng_for(campus->seed, 4, (guint64)p);
+        int department = p % N_ITEMS(departments);
+        int experience = 1 + rng_range(&rng, 30);
+        fprintf(file, "%d|%s|%s|%s@university.edu|555-%04d|%d %s %s|%s|%s|%d|Building %c - Room %d|%lld|%d\n",
+                p + 1, first, last, username, p % 10000,
+                1 + rng_range(&rng, 200), streets[rng_range(&rng, N_ITEMS(streets))],
+                cities[rng_range(&rng, N_ITEMS(cities))],
+                departments[department], subjects[rng_range(&rng, N_ITEMS(subjects))],
+                experience, 'A' + department, 100 + p % 400,
+                GEN_BASE_TIME - experience * 365 * GEN_DAY, 1);
+    }
+    return close_output(file, "professors.txt");
+}
+
+static int write_modules(const Campus* campus, const char* dir) {
+    FILE* file = open_output(dir, "modules.txt");
+    if (!file) return 0;
+
+    for (int m = 0; m < campus->modules; m++) {
+        char name[32], first[8], last[64];
+        module_name(m, name, sizeof(name));
+        professor_name(campus, module_professor(campus, m), first, sizeof(first), last, sizeof(last));
+        GenRng rng = rng_for(campus->seed, 5, (guint64)m);
+        fprintf(file, "%d,%s,%s for year %d,%d,%d,%d,%d,%d,%d,%s %s\n",
+                m + 1, name, subjects[m % N_ITEMS(subjects)], module_year(m) + 1,
+                20 + 5 * rng_range(&rng, 5), 10 + 5 * rng_range(&rng, 4), 5 * rng_range(&rng, 4),
+                module_year(m) + 1, module_program(m) + 1, module_semester(m),
+                first, last);
+    }
+    return close_output(file, "modules.txt");
+}
+
+// Same layout as sauvegarder_liste_examen_ds_file(), records back to back
+static int write_exams(const Campus* campus, const char* dir) {
+    FILE* file = open_output(dir, "examens.txt");
+    if (!file) return 0;
+
+    for (int m = 0; m < campus->modules; m++) {
+        char name[32];
+        module_name(m, name, sizeof(name));
+        for (int e = 0; e < GEN_EXAMS_PER_MODULE; e++) {
+            time_t date = (time_t)exam_date(m, e);
+            struct tm info;
+#ifdef _WIN32
+            gmtime_s(&info, &date);
+#else
+            gmtime_r(&date, &info);
+#endif
+            fprintf(file, "| %d | %d | %s | %d/%d/%d | %d:%d:%d | %d |",
+                    m * GEN_EXAMS_PER_MODULE + e + 1, m + 1, name,
+                    info.tm_mday, info.tm_mon + 1, info.tm_year + 1900,
+                    info.tm_hour, info.tm_min, info.tm_sec,
+                    e == 0 ? 90 : 120);
+        }
+    }
+    return close_output(file, "examens.txt");
+}
+
+static int write_clubs(const Campus* campus, const char* dir, const gint64* members) {
+    FILE* file = open_output(dir, CLUBS_FILE);
+    if (!file) return 0;
+
+    for (int c = 0; c < campus->clubs; c++) {
+        GenRng rng = rng_for(campus->seed, 6, (guint64)c);
+        const char* theme = club_themes[c % N_ITEMS(club_themes)];
+        long long founded = GEN_BASE_TIME - (long long)rng_range(&rng, 3650) * GEN_DAY;
+        fprintf(file, "%d|%s Club %d|A student club about %s|%s|%d|%d|%lld|%lld|%lld|%lld|%s|%d:00|Room %d|%.2f|%d\n",
+                c + 1, theme, c / N_ITEMS(club_themes) + 1, theme,
+                club_categories[rng_range(&rng, N_ITEMS(club_categories))],
+                0, 0, (long long)members[c], (long long)members[c] + 10 + rng_range(&rng, 40),
+                founded, GEN_BASE_TIME + 7 * GEN_DAY,
+                weekdays[rng_range(&rng, N_ITEMS(weekdays))], 13 + rng_range(&rng, 5),
+                100 + rng_range(&rng, 400), 100.0 * (1 + rng_range(&rng, 20)), 1);
+    }
+    return close_output(file, CLUBS_FILE);
+}
+
+// ============================================================================
+// STUDENT BLOCKS
+// ============================================================================
+
+typedef struct {
+    GString* out[GEN_STREAM_COUNT];
+    gint64 rows[GEN_STREAM_COUNT];
+    gint64* club_members;       // memberships per club in this block
+    int ready;                  // generated, waiting to be written
+} GenSlot;
+
+typedef struct {
+    const Campus* campus;
+    GenSlot* slots;
+    int n_slots;
+    int n_blocks;
+    int next_block;             // next block handed to a worker
+    int written;                // blocks written so far
+    GMutex lock;
+    GCond cond;
+} GenPipeline;
+
+static int attendance_status(GenRng* rng) {
+    double r = rng_unit(rng);
+    if (r < 0.85) return ATTENDANCE_PRESENT;
+    if (r < 0.92) return ATTENDANCE_LATE;
+    if (r < 0.97) return ATTENDANCE_ABSENT;
+    return ATTENDANCE_EXCUSED;
+}
+
+static void generate_student(const Campus* campus, int sid, GenSlot* slot) {
+    GenRng rng = rng_for(campus->seed, 1, (guint64)sid);
+
+    const char* first = first_names[rng_range(&rng, N_ITEMS(first_names))];
+    const char* last = last_names[rng_range(&rng, N_ITEMS(last_names))];
+    int program = rng_range(&rng, GEN_PROGRAMS);
+    int year = rng_range(&rng, GEN_YEARS);
+    double ability = 0.35 + 0.6 * rng_unit(&rng);
+    long long enrolled = GEN_BASE_TIME - year * 365 * GEN_DAY + rng_range(&rng, 30) * GEN_DAY;
+
+    char login[128], email[160];
+    snprintf(login, sizeof(login), "%s.%s%d", first, last, sid);
+    lowercase_copy(login, login, sizeof(login));
+    snprintf(email, sizeof(email), "%s@etu.ma", login);
+
+    g_string_append_printf(slot->out[GEN_STUDENTS], "%d,%s,%s,%s,06%08d,%d %s %s,%d,%s,%d,%.2f,%lld,%d\n",
+            sid, first, last, email, rng_range(&rng, 100000000),
+            1 + rng_range(&rng, 200), streets[rng_range(&rng, N_ITEMS(streets))],
+            cities[rng_range(&rng, N_ITEMS(cities))],
+            18 + year + rng_range(&rng, 3), programs[program], year + 1,
+            ability * 4.0, enrolled, rng_unit(&rng) < 0.97);
+    slot->rows[GEN_STUDENTS]++;
+
+    char salt[33], hash[129];
+    rng_salt(&rng, salt);
+    auth_hash_password(GEN_PASSWORD, salt, hash);
+    g_string_append_printf(slot->out[GEN_USERS], "%d,%s,%s,%s,%s,%d,%lld,%lld,%d\n",
+            student_user_id(campus, sid), login, email, hash, salt, ROLE_STUDENT,
+            enrolled, enrolled, 1);
+    slot->rows[GEN_USERS]++;
+
+    const int* modules = campus->class_modules[program][year];
+    int n_modules = campus->class_module_count[program][year];
+    for (int i = 0; i < n_modules; i++) {
+        int m = modules[i];
+        for (int e = 0; e < GEN_EXAMS_PER_MODULE; e++) {
+            int present = rng_unit(&rng) < 0.95;
+            double grade = 0.0;
+            if (present) {
+                grade = ability * 20.0 + (rng_unit(&rng) - 0.5) * 6.0;
+                grade = grade < 0.0 ? 0.0 : (grade > 20.0 ? 20.0 : grade);
+                grade = (int)(grade * 4.0 + 0.5) / 4.0;
+            }
+            g_string_append_printf(slot->out[GEN_GRADES], "%d,%d,%.2f,%d\n",
+                    sid, m * GEN_EXAMS_PER_MODULE + e + 1, grade, present);
+            slot->rows[GEN_GRADES]++;
+        }
+
+        int teacher = professor_user_id(module_professor(campus, m));
+        for (int s = 0; s < GEN_SESSIONS_PER_MODULE; s++) {
+            long long date = GEN_BASE_TIME + ((module_semester(m) - 1) * 20 * 7 + (s * 3 + 1) * 7 + m % 5) * GEN_DAY
+                             + 8 * 3600LL;
+            g_string_append_printf(slot->out[GEN_ATTENDANCE], "%d,%d,%d,%lld,%d\n",
+                    sid, m + 1, attendance_status(&rng), date, teacher);
+            slot->rows[GEN_ATTENDANCE]++;
+        }
+    }
+
+    // Memberships get ids from the student id so that blocks need no
+    // shared counter
+    double r = rng_unit(&rng);
+    int n_clubs = r < 0.40 ? 0 : (r < 0.75 ? 1 : (r < 0.93 ? 2 : 3));
+    if (n_clubs > campus->clubs) n_clubs = campus->clubs;
+    int joined[GEN_MAX_CLUBS_PER_STUDENT];
+    for (int k = 0; k < n_clubs; k++) {
+        int club;
+        int duplicate;
+        do {
+            club = rng_range(&rng, campus->clubs);
+            duplicate = 0;
+            for (int j = 0; j < k; j++) duplicate |= joined[j] == club;
+        } while (duplicate);
+        joined[k] = club;
+        slot->club_members[club]++;
+        g_string_append_printf(slot->out[GEN_MEMBERSHIPS], "%d,%d,%d,%lld,%s,%d\n",
+                (sid - 1) * GEN_MAX_CLUBS_PER_STUDENT + k + 1, sid, club + 1,
+                enrolled + rng_range(&rng, 300) * GEN_DAY, "Member", 1);
+        slot->rows[GEN_MEMBERSHIPS]++;
+    }
+
+    r = rng_unit(&rng);
+    int n_notes = n_modules == 0 ? 0 : (r < 0.90 ? 0 : (r < 0.98 ? 1 : 2));
+    for (int k = 0; k < n_notes; k++) {
+        int m = modules[rng_range(&rng, n_modules)];
+        char date[20];
+        format_date(GEN_BASE_TIME + (30 + rng_range(&rng, 240)) * GEN_DAY, date, sizeof(date));
+        g_string_append_printf(slot->out[GEN_PROF_NOTES], "%d,%d,%d,%d,%s,%s\n",
+                (sid - 1) * GEN_MAX_NOTES_PER_STUDENT + k + 1, sid, m + 1,
+                professor_user_id(module_professor(campus, m)), date,
+                note_phrases[rng_range(&rng, N_ITEMS(note_phrases))]);
+        slot->rows[GEN_PROF_NOTES]++;
+    }
+}
+
+static gpointer generate_worker(gpointer data) {
+    GenPipeline* pipeline = data;
+    const Campus* campus = pipeline->campus;
+
+    g_mutex_lock(&pipeline->lock);
+    for (;;) {
+        // Stay at most n_slots blocks ahead of the writer
+        while (pipeline->next_block < pipeline->n_blocks &&
+               pipeline->next_block >= pipeline->written + pipeline->n_slots) {
+            g_cond_wait(&pipeline->cond, &pipeline->lock);
+        }
+        if (pipeline->next_block >= pipeline->n_blocks) break;
+        int block = pipeline->next_block++;
+        g_mutex_unlock(&pipeline->lock);
+
+        GenSlot* slot = &pipeline->slots[block % pipeline->n_slots];
+        for (int s = 0; s < GEN_STREAM_COUNT; s++) {
+            g_string_truncate(slot->out[s], 0);
+            slot->rows[s] = 0;
+        }
+        memset(slot->club_members, 0, sizeof(gint64) * campus->clubs);
+
+        int first = block * GEN_BLOCK_STUDENTS + 1;
+        int last = MIN(first + GEN_BLOCK_STUDENTS - 1, campus->students);
+        for (int sid = first; sid <= last; sid++) {
+            generate_student(campus, sid, slot);
+        }
+
+        g_mutex_lock(&pipeline->lock);
+        slot->ready = 1;
+        g_cond_broadcast(&pipeline->cond);
+    }
+    g_mutex_unlock(&pipeline->lock);
+    return NULL;
+}
+
+// Runs the workers and writes their blocks in order. users must already
+// hold the admin and professor accounts.
+static int generate_students(const Campus* campus, int n_threads, FILE** files,
+                             gint64* rows, gint64* club_members) {
+    GenPipeline pipeline;
+    memset(&pipeline, 0, sizeof(pipeline));
+    pipeline.campus = campus;
+    pipeline.n_blocks = (campus->students + GEN_BLOCK_STUDENTS - 1) / GEN_BLOCK_STUDENTS;
+    pipeline.n_slots = n_threads * GEN_SLOTS_PER_THREAD;
+    pipeline.slots = calloc(pipeline.n_slots, sizeof(GenSlot));
+    if (!pipeline.slots) return 0;
+    for (int i = 0; i < pipeline.n_slots; i++) {
+        for (int s = 0; s < GEN_STREAM_COUNT; s++) {
+            pipeline.slots[i].out[s] = g_string_sized_new(1 << 16);
+        }
+        pipeline.slots[i].club_members = calloc(campus->clubs, sizeof(gint64));
+        if (!pipeline.slots[i].club_members) pipeline.n_slots = 0;
+    }
+    g_mutex_init(&pipeline.lock);
+    g_cond_init(&pipeline.cond);
+
+    int ok = pipeline.n_slots > 0;
+    GThread** threads = calloc(n_threads, sizeof(GThread*));
+    if (!threads) ok = 0;
+    for (int t = 0; ok && t < n_threads; t++) {
+        threads[t] = g_thread_new("generate", generate_worker, &pipeline);
+    }
+
+    int report_every = MAX(pipeline.n_blocks / 10, 1);
+    for (int block = 0; ok && block < pipeline.n_blocks; block++) {
+        GenSlot* slot = &pipeline.slots[block % pipeline.n_slots];
+        g_mutex_lock(&pipeline.lock);
+        while (!slot->ready) g_cond_wait(&pipeline.cond, &pipeline.lock);
+        g_mutex_unlock(&pipeline.lock);
+
+        for (int s = 0; s < GEN_STREAM_COUNT; s++) {
+            if (fwrite(slot->out[s]->str, 1, slot->out[s]->len, files[s]) != slot->out[s]->len) {
+                printf("[ERROR] Failed to write %s\n", stream_files[s]);
+                ok = 0;
+            }
+            rows[s] += slot->rows[s];
+        }
+        for (int c = 0; c < campus->clubs; c++) {
+            club_members[c] += slot->club_members[c];
+        }
+
+        g_mutex_lock(&pipeline.lock);
+        slot->ready = 0;
+        pipeline.written++;
+        if (!ok) pipeline.next_block = pipeline.n_blocks;    // stop the workers
+        g_cond_broadcast(&pipeline.cond);
+        g_mutex_unlock(&pipeline.lock);
+
+        if ((block + 1) % report_every == 0 || block + 1 == pipeline.n_blocks) {
+            printf("[INFO] Students: %d/%d\n", MIN((block + 1) * GEN_BLOCK_STUDENTS, campus->students),
+                   campus->students);
+        }
+    }
+
+    if (!ok && threads) {
+        g_mutex_lock(&pipeline.lock);
+        pipeline.next_block = pipeline.n_blocks;
+        g_cond_broadcast(&pipeline.cond);
+        g_mutex_unlock(&pipeline.lock);
+    }
+    for (int t = 0; threads && t < n_threads; t++) {
+        if (threads[t]) g_thread_join(threads[t]);
+    }
+    free(threads);
+
+    for (int i = 0; i < n_threads * GEN_SLOTS_PER_THREAD; i++) {
+        for (int s = 0; s < GEN_STREAM_COUNT; s++) {
+            g_string_free(pipeline.slots[i].out[s], TRUE);
+        }
+        free(pipeline.slots[i].club_members);
+    }
+    free(pipeline.slots);
+    g_mutex_clear(&pipeline.lock);
+    g_cond_clear(&pipeline.cond);
+    return ok;
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+static void usage(const char* program) {
+    printf("Usage: %s [--students N] [--seed S] [--threads T] [--out DIR]\n", program);
+    printf("  --students N   students to generate, %d to %d (default %d)\n",
+           GEN_MIN_STUDENTS, GEN_MAX_STUDENTS, GEN_DEFAULT_STUDENTS);
+    printf("  --seed S       random seed; the same seed gives the same files (default 1)\n");
+    printf("  --threads T    generator threads (default: number of processors)\n");
+    printf("  --out DIR      output directory (default %s)\n", GEN_DEFAULT_OUT);
+}
+
+int main(int argc, char** argv) {
+    long long students = GEN_DEFAULT_STUDENTS;
+    guint64 seed = 1;
+    int n_threads = (int)g_get_num_processors();
+    const char* out_dir = GEN_DEFAULT_OUT;
+
+    for (int i = 1; i < argc; i++) {
+        const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
+            usage(argv[0]);
+            return 0;
+        } else if (strcmp(argv[i], "--students") == 0 && value) {
+            students = strtoll(value, NULL, 10);
+            i++;
+        } else if (strcmp(argv[i], "--seed") == 0 && value) {
+            seed = g_ascii_strtoull(value, NULL, 10);
+            i++;
+        } else if (strcmp(argv[i], "--threads") == 0 && value) {
+            n_threads = atoi(value);
+            i++;
+        } else if (strcmp(argv[i], "--out") == 0 && value) {
+            out_dir = value;
+            i++;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (students < GEN_MIN_STUDENTS || students > GEN_MAX_STUDENTS) {
+        printf("[ERROR] --students must be between %d and %d\n", GEN_MIN_STUDENTS, GEN_MAX_STUDENTS);
+        return 1;
+    }
+    if (n_threads < 1) n_threads = 1;
+    if (g_mkdir_with_parents(out_dir, 0755) != 0) {
+        printf("[ERROR] Cannot create %s\n", out_dir);
+        return 1;
+    }
+
+    Campus campus;
+    if (!campus_init(&campus, (int)students, seed)) {
+        printf("[ERROR] Out of memory\n");
+        campus_destroy(&campus);
+        return 1;
+    }
+    printf("[INFO] Generating %d students, %d professors, %d modules, %d clubs into %s (seed %llu, %d threads)\n",
+           campus.students, campus.professors, campus.modules, campus.clubs, out_dir,
+           (unsigned long long)seed, n_threads);
+
+    gint64 start = g_get_monotonic_time();
+    int ok = write_professors(&campus, out_dir) && write_modules(&campus, out_dir) &&
+             write_exams(&campus, out_dir);
+
+    FILE* files[GEN_STREAM_COUNT] = { NULL };
+    for (int s = 0; ok && s < GEN_STREAM_COUNT; s++) {
+        files[s] = open_output(out_dir, stream_files[s]);
+        if (!files[s]) ok = 0;
+    }
+
+    gint64 rows[GEN_STREAM_COUNT] = { 0 };
+    gint64* club_members = calloc(campus.clubs, sizeof(gint64));
+    if (!club_members) ok = 0;
+    if (ok) {
+        write_staff_users(&campus, files[GEN_USERS]);
+        rows[GEN_USERS] = 1 + campus.professors;
+        ok = generate_students(&campus, n_threads, files, rows, club_members);
+    }
+    for (int s = 0; s < GEN_STREAM_COUNT; s++) {
+        if (files[s] && !close_output(files[s], stream_files[s])) ok = 0;
+    }
+    if (ok) ok = write_clubs(&campus, out_dir, club_members);
+
+    free(club_members);
+    campus_destroy(&campus);
+    if (!ok) {
+        printf("[ERROR] Generation failed; the files in %s are incomplete\n", out_dir);
+        return 1;
+    }
+
+    double seconds = (g_get_monotonic_time() - start) / 1e6;
+    printf("[OK] Generated in %.1f s:\n", seconds);
+    for (int s = 0; s < GEN_STREAM_COUNT; s++) {
+        printf("  %-22s %lld rows\n", stream_files[s], (long long)rows[s]);
+    }
+    printf("  %-22s %d rows\n", "professors.txt", campus.professors);
+    printf("  %-22s %d rows\n", "modules.txt", campus.modules);
+    printf("  %-22s %d rows\n", "examens.txt", campus.modules * GEN_EXAMS_PER_MODULE);
+    printf("  %-22s %d rows\n", CLUBS_FILE, campus.clubs);
+    printf("  Every account has the password \"%s\"\n", GEN_PASSWORD);
+    return 0;
+}
@@ -0,0 +1,76 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Region allocator. An arena hands out memory by bumping an offset through
+// large blocks and gives it all back at once on reset or destroy, so a table
+// load or a UI callback costs a handful of mallocs however many objects it
+// creates. Nothing allocated from an arena is freed on its own.
+
+#define ARENA_DEFAULT_BLOCK_SIZE 65536
+#define ARENA_ALIGNMENT 16
+
+typedef struct ArenaBlock {
+    struct ArenaBlock* next;    // older block
+    size_t used;
+    size_t size;
+    unsigned char data[];
+} ArenaBlock;
+
+// Lifetime counters, printed by arena_report()
+typedef struct {
+    size_t allocations;         // objects handed out
+    size_t block_mallocs;       // blocks taken from malloc
+    size_t bytes_requested;
+    size_t bytes_reserved;      // block bytes held right now
+    size_t peak_reserved;
+    size_t resets;
+} ArenaCounters;
+
+typedef struct Arena {
+    const char* name;
+    ArenaBlock* blocks;         // newest first
+    size_t block_size;
+    size_t bytes_used;          // handed out since the last reset, padding included
+    ArenaCounters counters;
+    struct Arena* next_live;    // every live arena, for the report
+} Arena;
+
+// Position to roll an arena back to, for temporaries inside one function
+typedef struct {
+    ArenaBlock* block;
+    size_t used;
+    size_t bytes_used;
+} ArenaMark;
+
+// Arena lifecycle. Any thread may create and destroy arenas; one arena is
+// used by one thread at a time.
+Arena* arena_create(const char* name, size_t block_size);
+void arena_destroy(Arena* arena);
+void arena_reset(Arena* arena);
+
+// Allocation
+void* arena_alloc(Arena* arena, size_t size);
+void* arena_calloc(Arena* arena, size_t count, size_t size);
+char* arena_strndup(Arena* arena, const char* text, size_t max_length);
+ArenaMark arena_mark(Arena* arena);
+void arena_release(Arena* arena, ArenaMark mark);
+
+// Per-request scratch arena for result arrays and temporaries. It is reset
+// once the current UI callback returns, so scratch results must not be kept
+// across callbacks or across a nested main loop such as gtk_dialog_run().
+// Main-thread only.
+Arena* arena_scratch(void);
+void arena_scratch_reset(void);
+void arena_scratch_set_reset_hook(void (*schedule_reset)(void));
+void arena_scratch_destroy(void);
+
+// Allocation counters for every live arena
+void arena_report(const char* label);
+// Block bytes held by every live arena together
+size_t arena_total_reserved(void);
+
+#endif // ARENA_H
@@ -0,0 +1,44 @@
+#ifndef ASSET_H
+#define ASSET_H
+
+#include <gtk/gtk.h>
+#include "config.h"
+
+// Images shown by the windows: the logo, the login background. Each file is
+// decoded once per session and each size it is shown at is scaled once;
+// every later window reuses those pixbufs, so opening a window decodes
+// nothing. Sizes are in device pixels, i.e. already multiplied by the
+// screen's scale factor.
+//
+// A path is looked up first in the resources linked into the program under
+// ASSET_RESOURCE_PREFIX (see src/assets.gresource.xml and build.sh), then
+// on disk relative to the working directory.
+//
+// Main thread only; asset_preload() does its decoding on a worker.
+
+typedef struct {
+    const char* path;
+    int width;          // logical pixels
+    int height;
+} AssetSize;
+
+// Borrowed, owned by the cache; NULL if the image cannot be loaded (reported
+// once, not on every call)
+GdkPixbuf* asset_get_pixbuf(const char* path);
+// Exactly width x height device pixels; borrowed
+GdkPixbuf* asset_get_scaled(const char* path, int width, int height);
+
+// Scale factor of the default screen, 1 when unknown
+int asset_scale_factor(void);
+// New GtkImage showing path at width x height logical pixels, sharp on HiDPI
+// screens; NULL if the image cannot be loaded
+GtkWidget* asset_image_new(const char* path, int width, int height);
+
+// Decode and scale the given sizes on a worker so the windows that need them
+// later find them ready. Sizes already cached are skipped.
+void asset_preload(const AssetSize* sizes, int count);
+
+// Main thread, after jobs_shutdown()
+void asset_cache_clear(void);
+
+#endif // ASSET_H
@@ -6,8 +6,11 @@
 #include <string.h>
 #include <time.h>
 #include "config.h"
+#include "tombstone.h"
+#include "table_lock.h"
 
-// Attendance record structure
+// Attendance record structure. Removed records keep their slot with
+// is_deleted set until the list is compacted.
 typedef struct {
     int id;
     int student_id;
@@ -17,6 +20,7 @@ typedef struct {
     char reason[200];
     int teacher_id;
     time_t recorded_time;
+    int is_deleted;
 } AttendanceRecord;
 
 // Attendance list structure
@@ -24,13 +28,20 @@ typedef struct {
     AttendanceRecord* records;
     int count;
     int capacity;
+    Tombstones tombstones;   // removed records awaiting compaction
+    int dirty;               // changed since the last save
+    TableLock* lock;         // shared tables only, see table_lock.h
 } AttendanceList;
 
 // Attendance management functions
 AttendanceList* attendance_list_create(void);
 void attendance_list_destroy(AttendanceList* list);
 int attendance_list_add(AttendanceList* list, AttendanceRecord record);
+int attendance_list_add_locked(AttendanceList* list, AttendanceRecord record);  // caller holds the write lock
 int attendance_list_remove(AttendanceList* list, int record_id);
+int attendance_list_compact(AttendanceList* list);
+int attendance_list_compact_if_needed(AttendanceList* list);
+AttendanceList* attendance_list_snapshot(const AttendanceList* list);
 AttendanceRecord* attendance_list_find_by_id(AttendanceList* list, int record_id);
 AttendanceRecord* attendance_list_find_by_student_date(AttendanceList* list, int student_id, time_t date);
 AttendanceRecord* attendance_list_find_by_course_date(AttendanceList* list, int course_id, time_t date);
@@ -38,6 +49,7 @@ AttendanceRecord* attendance_list_find_by_course_date(AttendanceList* list, int
 // Attendance operations
 int mark_attendance(AttendanceList* list, int student_id, int course_id, time_t date, int status, int teacher_id);
 int update_attendance(AttendanceList* list, int record_id, int new_status, const char* reason);
+// Copies the matching records into a scratch-arena array; do not free it
 int get_attendance_for_date(AttendanceList* list, int course_id, time_t date, AttendanceRecord** records, int* count);
 
 // Attendance display
@@ -6,8 +6,11 @@
 #include <string.h>
 #include <time.h>
 #include "config.h"
+#include "tombstone.h"
+#include "table_lock.h"
 
-// User structure
+// User structure. A removed user keeps its slot with is_deleted set until
+// the list is compacted.
 typedef struct {
     int id;
     char username[50];
@@ -18,6 +21,7 @@ typedef struct {
     time_t created_at;
     time_t last_login;
     int is_active;
+    int is_deleted;
 } User;
 
 // Session structure
@@ -34,6 +38,9 @@ typedef struct {
     User* users;
     int count;
     int capacity;
+    Tombstones tombstones;   // removed users awaiting compaction
+    int dirty;               // changed since the last save
+    TableLock* lock;         // shared tables only, see table_lock.h
 } UserList;
 
 // Function declarations
@@ -41,6 +48,9 @@ UserList* user_list_create(void);
 void user_list_destroy(UserList* list);
 int user_list_add(UserList* list, User user);
 int user_list_remove(UserList* list, int user_id);
+int user_list_compact(UserList* list);
+int user_list_compact_if_needed(UserList* list);
+UserList* user_list_snapshot(const UserList* list);
 User* user_list_find_by_username(UserList* list, const char* username);
 User* user_list_find_by_email(UserList* list, const char* email);
 User* user_list_find_by_id(UserList* list, int user_id);
@@ -0,0 +1,50 @@
+#ifndef AUTOSAVE_H
+#define AUTOSAVE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "config.h"
+
+// Background saving. Table mutators set the table's dirty flag. On a timer
+// the main loop clears the flag of each dirty table and queues it for the
+// saver thread, which copies the table under its read lock (see
+// table_lock.h), writes the copy to disk and frees it. The UI thread pays
+// for neither the copy nor the file; it only waits for a write lock while
+// a copy is being taken.
+
+// Saver thread: copy of the table, or NULL to leave it dirty for next time
+typedef void* (*AutosaveSnapshotFunc)(void* table);
+// Saver thread: write the copy, 1 on success
+typedef int (*AutosaveWriteFunc)(void* snapshot, const char* filename);
+// Saver thread: free the copy
+typedef void (*AutosaveFreeFunc)(void* snapshot);
+// Main thread: called after a round that queued at least one table
+typedef void (*AutosaveCommitFunc)(void* user_data);
+
+typedef struct {
+    const char* name;               // for log lines
+    const char* filename;
+    void* table;
+    int* dirty;                     // the table's dirty flag
+    time_t* last_save_time;         // optional, stamped after a successful write
+    AutosaveSnapshotFunc snapshot;
+    AutosaveWriteFunc write;
+    AutosaveFreeFunc free_snapshot;
+} AutosaveTable;
+
+// Register tables before starting; the descriptor is copied
+int autosave_register(const AutosaveTable* table);
+// At most one hook; NULL removes it
+void autosave_set_commit_hook(AutosaveCommitFunc hook, void* user_data);
+
+// Saver thread and timer
+int autosave_start(unsigned int interval_seconds);
+void autosave_set_interval(unsigned int interval_seconds);
+void autosave_now(void);
+
+// Waits for queued writes, then forgets every table
+void autosave_stop(void);
+
+#endif // AUTOSAVE_H
@@ -0,0 +1,57 @@
+#ifndef BACKUP_H
+#define BACKUP_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "config.h"
+
+// Incremental, deduplicating backups of the data directory.
+//
+// A repository holds a chunk store and one manifest per snapshot:
+//   <repo>/chunks/ab/ab12...   chunk contents, named by their SHA-256
+//   <repo>/snapshots/<name>.manifest
+// Files are cut into content-defined chunks (a gear rolling hash picks
+// the cut points, so an insertion only changes the chunks around it) and
+// a chunk is written only if the store lacks it. A file whose size and
+// modification time match the previous snapshot is not read at all; its
+// chunk list is copied from the old manifest. A backup therefore costs
+// about as much as the data changed since the last one.
+//
+// Chunk and file contents are moved with copy_file_range() where the
+// system has it, so they do not pass through user space. New chunks are
+// flushed to disk together, then the manifest is written, so an
+// interrupted backup leaves no snapshot behind.
+//
+// Only the regular files at the top of the data directory are backed up.
+// Any thread; a file rewritten while it is read is read again.
+
+typedef struct {
+    int files;                  // files in the snapshot
+    int files_read;             // changed since the previous snapshot
+    int chunks;                 // chunks referenced by the snapshot
+    int chunks_written;         // new to the store
+    long long bytes;            // total size of the files
+    long long bytes_read;
+    long long bytes_written;
+} BackupStats;
+
+// Called after each file; return 0 to stop
+typedef int (*BackupProgressFunc)(int files_done, int files_total, void* user_data);
+
+// Back up data_dir into repo_dir and return the new snapshot's name
+// (g_free'd by the caller), or NULL on failure. stats and progress may be
+// NULL.
+char* backup_create(const char* data_dir, const char* repo_dir, BackupStats* stats,
+                    BackupProgressFunc progress, void* user_data);
+
+// Snapshot names, newest first, NULL-terminated; free with g_strfreev.
+// NULL if the repository has none.
+char** backup_list_snapshots(const char* repo_dir, int* count);
+
+// Rebuild the files of a snapshot in target_dir, which is created if
+// needed. Existing files of the same names are replaced.
+int backup_restore(const char* repo_dir, const char* snapshot, const char* target_dir,
+                   BackupStats* stats, BackupProgressFunc progress, void* user_data);
+
+#endif // BACKUP_H
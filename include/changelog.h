@@ -0,0 +1,42 @@
+#ifndef CHANGELOG_H
+#define CHANGELOG_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "table_lock.h"
+
+// Change capture for the shared tables. Every mutator that changes a
+// record of a replicated table reports the record, while it still holds
+// the table's write lock, so a listener sees the changes in the order the
+// tables went through them. Private lists (no lock) report nothing, nor
+// do compaction, sorting and loading, which change no record.
+//
+// Main thread only, like the mutators themselves.
+
+typedef enum {
+    CHANGE_USERS = 0,             // User, keyed by id
+    CHANGE_STUDENTS = 1,          // Student, by id
+    CHANGE_GRADES = 2,            // Note, by (id_etudiant, id_examen)
+    CHANGE_ATTENDANCE = 3,        // AttendanceRecord, by id
+    CHANGE_CLUBS = 4,             // Club, by id
+    CHANGE_MEMBERSHIPS = 5,       // ClubMembership, by id
+    CHANGE_PROF_NOTES = 6,        // ProfessorNote, by id
+    CHANGE_TABLE_COUNT
+} ChangeTable;
+
+typedef enum {
+    CHANGE_INSERT = 1,
+    CHANGE_UPDATE = 2,
+    CHANGE_DELETE = 3             // the record as it was, for its key
+} ChangeOp;
+
+// record points into the table and is only valid during the call
+typedef void (*ChangelogHook)(ChangeTable table, ChangeOp op, const void* record, void* user_data);
+
+// At most one listener; NULL removes it
+void changelog_set_hook(ChangelogHook hook, void* user_data);
+
+// Called by mutators after the change, before table_unlock_write(lock)
+void changelog_record(const TableLock* lock, ChangeTable table, ChangeOp op, const void* record);
+
+#endif // CHANGELOG_H
@@ -6,13 +6,17 @@
 #include <string.h>
 #include <time.h>
 #include "config.h"
+#include "student.h"
+#include "intern.h"
+#include "tombstone.h"
+#include "table_lock.h"
 
 // Club structure
 typedef struct {
     int id;
     char name[MAX_CLUB_LENGTH];
     char description[500];
-    char category[50];
+    InternId category;
     int president_id;
     int advisor_id;
     int member_count;
@@ -26,14 +30,16 @@ typedef struct {
     int is_active;
 } Club;
 
-// Club membership structure
+// Club membership structure. A removed membership keeps its slot with
+// is_deleted set until the list is compacted.
 typedef struct {
     int id;
     int student_id;
     int club_id;
     time_t join_date;
-    char role[50];  // member, secretary, treasurer, president, etc.
+    InternId role;  // member, secretary, treasurer, president, etc.
     int is_active;
+    int is_deleted;
 } ClubMembership;
 
 // Club list structure
@@ -41,6 +47,8 @@ typedef struct {
     Club* clubs;
     int count;
     int capacity;
+    int dirty;               // changed since the last save
+    TableLock* lock;         // shared tables only, see table_lock.h
 } ClubList;
 
 // Membership list structure
@@ -48,13 +56,38 @@ typedef struct {
     ClubMembership* memberships;
     int count;
     int capacity;
+    Tombstones tombstones;   // removed memberships awaiting compaction
+    int dirty;               // changed since the last save
+    TableLock* lock;         // shared tables only, see table_lock.h
 } MembershipList;
 
+// Student id bitset (bit i set = student i is in the set)
+typedef struct {
+    unsigned long long* words;
+    int word_count;
+} ClubBitset;
+
+// Per-club roster bitsets built from the membership list
+typedef struct {
+    int* club_ids;
+    ClubBitset** rosters;
+    int count;
+    int max_student_id;
+} ClubRosterIndex;
+
+// Roster set operations
+typedef enum {
+    CLUB_SET_AND = 0,     // students in both clubs
+    CLUB_SET_OR = 1,      // students in either club
+    CLUB_SET_ANDNOT = 2   // students in the first club but not the second
+} ClubSetOp;
+
 // Principal Club management functions
 ClubList* club_list_create(void);
 void club_list_destroy(ClubList* list);
 int club_list_add(ClubList* list, Club club);
 int club_list_remove(ClubList* list, int club_id);
+ClubList* club_list_snapshot(const ClubList* list);
 Club* club_list_find_by_id(ClubList* list, int club_id);
 Club* club_list_find_by_name(ClubList* list, const char* name);
 void club_list_display_all(ClubList* list);
@@ -63,14 +96,41 @@ void club_list_display_club(Club* club);
 // Principal Membership management functions
 MembershipList* membership_list_create(void);
 void membership_list_destroy(MembershipList* list);
+// A membership id of 0, or one already taken, becomes the next free id
 int membership_list_add(MembershipList* list, ClubMembership membership);
+// Keeps the membership's id as given (a replica mirroring its primary)
+int membership_list_add_with_id(MembershipList* list, ClubMembership membership);
 int membership_list_remove(MembershipList* list, int membership_id);
+int membership_list_compact(MembershipList* list);
+int membership_list_compact_if_needed(MembershipList* list);
+MembershipList* membership_list_snapshot(const MembershipList* list);
 ClubMembership* membership_list_find_by_id(MembershipList* list, int membership_id);
 
 // Principal Membership operations
 int join_club(MembershipList* list, int student_id, int club_id, const char* role);
 int leave_club(MembershipList* list, int student_id, int club_id);
 
+// Roster bitset functions
+ClubBitset* club_bitset_create(int max_student_id);
+void club_bitset_destroy(ClubBitset* set);
+int club_bitset_set(ClubBitset* set, int student_id);
+int club_bitset_clear(ClubBitset* set, int student_id);
+int club_bitset_test(const ClubBitset* set, int student_id);
+void club_bitset_and(ClubBitset* dest, const ClubBitset* a, const ClubBitset* b);
+void club_bitset_or(ClubBitset* dest, const ClubBitset* a, const ClubBitset* b);
+void club_bitset_andnot(ClubBitset* dest, const ClubBitset* a, const ClubBitset* b);
+int club_bitset_count(const ClubBitset* set);
+int club_bitset_to_ids(const ClubBitset* set, int* ids, int max_ids);
+
+// Roster index built from memberships (active memberships only)
+ClubRosterIndex* club_roster_index_build(ClubList* clubs, MembershipList* memberships);
+void club_roster_index_destroy(ClubRosterIndex* index);
+ClubBitset* club_roster_index_get(ClubRosterIndex* index, int club_id);
+int club_roster_index_set_member(ClubRosterIndex* index, int club_id, int student_id, int is_member);
+int club_roster_query(ClubRosterIndex* index, int club_a, int club_b, ClubSetOp op, ClubBitset* result);
+int club_roster_count_in_at_least(ClubRosterIndex* index, int min_clubs);
+int club_roster_count_in_no_club(ClubRosterIndex* index, StudentList* students);
+
 // Principal File operations
 int club_list_save_to_file(ClubList* list, const char* filename);
 int club_list_load_from_file(ClubList* list, const char* filename);
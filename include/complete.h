@@ -0,0 +1,63 @@
+#ifndef COMPLETE_H
+#define COMPLETE_H
+
+#include "student.h"
+#include "professor.h"
+#include "auth.h"
+#include "arena.h"
+
+// Prefix autocomplete over student names, professor names, e-mails and
+// usernames. Keys are folded like the search index and kept in one sorted
+// array, so a prefix is a binary search plus a short forward scan. Key and
+// display strings live in the index's arena; removed records leave their
+// strings behind until the next build.
+
+#define COMPLETE_MAX_KEY 256
+#define COMPLETE_MAX_DISPLAY 256
+
+// Record kinds, usable as a bit mask in queries
+typedef enum {
+    COMPLETE_STUDENT = 1,
+    COMPLETE_PROFESSOR = 2,
+    COMPLETE_USER = 4
+} CompletionKind;
+
+#define COMPLETE_ALL (COMPLETE_STUDENT | COMPLETE_PROFESSOR | COMPLETE_USER)
+
+typedef struct {
+    const char* key;        // folded text the prefix is matched against
+    const char* display;    // text shown in the popup and inserted in the entry
+    int id;
+    int kind;
+} CompletionEntry;
+
+typedef struct {
+    CompletionEntry* entries;   // sorted by key
+    int count;
+    int capacity;
+    Arena* text;                // keys and display strings
+} CompletionIndex;
+
+typedef struct {
+    int id;
+    int kind;
+    const char* display;        // owned by the index, valid until it changes
+} CompletionHit;
+
+// Index lifecycle
+CompletionIndex* completion_index_create(void);
+void completion_index_destroy(CompletionIndex* index);
+int completion_index_build(CompletionIndex* index, StudentList* students,
+                           ProfessorList* professors, UserList* users);
+
+// Mutations
+int completion_index_add_student(CompletionIndex* index, const Student* student);
+int completion_index_add_professor(CompletionIndex* index, const Professor* professor);
+int completion_index_add_user(CompletionIndex* index, const User* user);
+int completion_index_remove(CompletionIndex* index, int kind, int id);
+
+// Queries
+int completion_index_query(CompletionIndex* index, const char* prefix, int kinds,
+                           CompletionHit* hits, int max_hits);
+
+#endif // COMPLETE_H
@@ -4,7 +4,7 @@
 // Application configuration constants
 #define APP_NAME "Student Management System"
 #define APP_VERSION "1.0.0"
-#define MAX_STUDENTS 1000
+#define STUDENT_LIST_INITIAL_CAPACITY 64  // Grows by doubling
 #define MAX_NAME_LENGTH 100
 #define MAX_EMAIL_LENGTH 150
 #define MAX_PHONE_LENGTH 20
@@ -13,6 +13,51 @@
 #define MAX_CLUB_LENGTH 50
 #define MAX_CLUBS 15
 #define MAX_DESC_LENGTH 200  // Maximum description length 
+#define TOMBSTONE_COMPACT_PERCENT 25  // Compact a table once this share of its records is deleted
+#define TOMBSTONE_COMPACT_MIN 64      // ...and at least this many, so small tables are left alone
+#define AUTOSAVE_INTERVAL_SECONDS 30  // Changed tables are written in the background this often
+#define AUTOSAVE_MAX_TABLES 16
+#define JOB_MAX_THREADS 2              // Worker threads for heavy UI actions (exports, statistics)
+#define JOB_PROGRESS_EVERY 256         // Rows between progress reports from a job
+#define EXPORT_BUFFER_SIZE (1 << 20)   // Output buffer of a table export, written out when full
+#define EXPORT_PROGRESS_ROWS 4096      // Rows between progress callbacks of an export
+#define EXPORT_MAX_COLUMNS 32
+#define IMPORT_MAX_THREADS 4           // Parser threads of a bulk import
+#define IMPORT_CHUNK_MIN_BYTES (1 << 20)  // Smaller files are parsed on one thread
+#define BACKUP_DIR "backups"            // Chunk store and snapshot manifests, inside the data directory
+#define BACKUP_CHUNK_MIN 2048           // Content-defined chunk sizes of a backup
+#define BACKUP_CHUNK_AVG_BITS 13        // 8 KB on average
+#define BACKUP_CHUNK_MAX 65536
+#define BACKUP_READ_SIZE (1 << 20)
+#define ASSET_RESOURCE_PREFIX "/org/studentmgmt/app"  // Images linked in with glib-compile-resources
+#define TRACE_BUFFER_EVENTS 65536      // Span events kept per thread when built with TRACE_ENABLED
+#define TRACE_OUTPUT_FILE "student_mgmt_trace.json"  // Written at exit, in the working directory
+#define METRICS_INTERVAL_SECONDS 60    // One line of process and table metrics is appended this often
+#define METRICS_FILE "metrics.ndjson"  // Inside the data directory
+#define METRICS_MAX_TABLES 16
+#define HTTP_SERVER_ADDRESS "127.0.0.1"  // The read API listens on this interface only
+#define HTTP_SERVER_PORT 8080          // Read API, see http_server.h
+#define HTTP_SERVER_IN_GUI 0           // 1 also serves the live tables while the GUI runs
+#define HTTP_SERVER_WORKERS 4          // Threads answering read API requests
+#define HTTP_MAX_CONNECTIONS 4096      // Further connections are closed on accept
+#define HTTP_MAX_REQUEST_BYTES 8192    // Request line and headers; larger requests get 431
+#define HTTP_IDLE_TIMEOUT_MS 30000     // Connections silent for this long are closed
+#define HTTP_DEFAULT_LIMIT 100         // Records in a list response without ?limit=
+#define HTTP_MAX_LIMIT 10000
+#define REPLICA_ENABLED 1              // Publish the tables to shared memory for local readers
+#define REPLICA_SHM_NAME "/student_mgmt_replica"  // Control object, see replica_format.h
+#define REPLICATION_ENABLED 1          // Stream changes to follower instances, see replication.h
+#define REPLICATION_SOCKET_FILE "replication.sock"  // Inside the data directory
+#define REPLICATION_MAX_FOLLOWERS 8    // Further followers are refused
+#define REPLICATION_FLUSH_MS 50        // A batch is sent at the latest this long after its first change
+#define REPLICATION_BATCH_BYTES 65536  // or once it is this large
+#define REPLICATION_BACKLOG_BYTES (16 * 1024 * 1024)  // Sent batches kept for followers that reconnect
+#define REPLICATION_HEARTBEAT_MS 1000  // An idle primary tells its followers it is alive this often
+#define REPLICATION_RETRY_MS 2000      // A follower retries connecting to the primary this often
+#define REPLICATION_QUEUE_BYTES (32 * 1024 * 1024)  // A follower stops reading with this much left to apply
+#define REPLICATION_MAX_FRAME_BYTES (512u * 1024 * 1024)  // Larger frames drop the connection
+#define HEADLESS_LOG_KEEP 5            // rotate-logs keeps logs.txt.1 .. logs.txt.N
+#define GRADE_MAX_SCORE 20.0f          // Grades are out of 20; recompute-gpa maps them onto 0-4
 // File paths
 #define DATA_DIR "c:\\Users\\Karim erradi\\Documents\\c-project1\\data\\"
 #define STUDENTS_FILE "students.txt"
@@ -27,6 +72,10 @@
 // UI settings
 #define WINDOW_WIDTH 1200
 #define WINDOW_HEIGHT 800
+#define SEARCH_DEBOUNCE_MS 150     // Live search waits this long after the last keystroke
+#define SEARCH_MAX_RESULTS 1000    // Ranked hits shown for a live search
+#define COMPLETION_MAX_RESULTS 10  // Suggestions shown under an autocompleting entry
+#define HEALTH_REFRESH_SECONDS 2   // The admin view's System health tab is resampled this often
 // Note: THEME_DARK and THEME_LIGHT are defined in theme.h as enum values
 // These string constants are kept for backward compatibility but should not be used with ThemeType enum
 #define THEME_DARK_STR "dark"
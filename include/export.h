@@ -0,0 +1,85 @@
+#ifndef EXPORT_H
+#define EXPORT_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "config.h"
+#include "student.h"
+#include "grade.h"
+#include "attendance.h"
+#include "club.h"
+#include "prof_note.h"
+
+// Streaming export of one in-memory table to RFC 4180 CSV or to NDJSON
+// (one JSON object per line). Rows are formatted straight from the table
+// into one output buffer of EXPORT_BUFFER_SIZE bytes that is written out
+// whenever it fills, so memory use does not grow with the table.
+//
+// The table's read lock is held for the whole scan, which keeps the file
+// consistent; edits from the UI wait until the export is done. Any thread
+// may export, see table_lock.h.
+
+typedef enum {
+    EXPORT_CSV = 0,
+    EXPORT_NDJSON = 1
+} ExportFormat;
+
+// Which table the export reads from
+typedef enum {
+    EXPORT_STUDENTS = 0,      // StudentList
+    EXPORT_GRADES = 1,        // liste_note, joined with the exam index
+    EXPORT_ATTENDANCE = 2,    // AttendanceList
+    EXPORT_CLUBS = 3,         // ClubList
+    EXPORT_MEMBERSHIPS = 4,   // MembershipList
+    EXPORT_PROF_NOTES = 5,    // ProfessorNoteList
+    EXPORT_KIND_COUNT
+} ExportKind;
+
+// Called with each live record; return 0 to leave it out
+typedef int (*ExportFilterFunc)(const void* record, void* user_data);
+// Called every EXPORT_PROGRESS_ROWS records; return 0 to stop the export
+typedef int (*ExportProgressFunc)(int rows_done, int rows_total, void* user_data);
+
+// Exam id -> module, for the module columns of a grade export. Exams have
+// no lock, so the index is built on the main thread and handed over.
+typedef struct {
+    int exam_id;
+    int module_id;
+    time_t date;
+    char module_name[MAX_NAME_LENGTH];
+} ExportExam;
+
+typedef struct {
+    ExportExam* exams;        // sorted by exam_id
+    int count;
+} ExportExamIndex;
+
+typedef struct {
+    ExportKind kind;
+    ExportFormat format;
+    const char* columns;              // comma-separated column names, NULL for all
+    ExportFilterFunc filter;          // optional
+    ExportProgressFunc progress;      // optional
+    void* user_data;                  // passed to filter and progress
+    const ExportExamIndex* exams;     // optional; without it the exam columns are empty
+} ExportOptions;
+
+// Column layout
+const char* export_kind_name(ExportKind kind);
+int export_kind_from_name(const char* name);    // -1 if unknown
+int export_kind_n_columns(ExportKind kind);
+const char* export_kind_column_name(ExportKind kind, int column);
+int export_columns_check(ExportKind kind, const char* columns);   // 1 if every name is known
+
+// Main thread only
+ExportExamIndex* export_exam_index_build(liste_examen* exams, ListeModules* modules);
+void export_exam_index_destroy(ExportExamIndex* index);
+
+// Return 1 on success and 0 on failure or when progress stopped the
+// export. rows_written may be NULL. A file left incomplete is removed.
+int export_table_to_stream(const void* table, const ExportOptions* options, FILE* out, int* rows_written);
+int export_table_to_file(const void* table, const ExportOptions* options, const char* filename, int* rows_written);
+
+#endif // EXPORT_H
@@ -6,6 +6,9 @@
 #include <string.h>
 #include <time.h>
 #include "config.h"
+#include "intern.h"
+#include "tombstone.h"
+#include "table_lock.h"
 
 // Forward declarations
 typedef struct liste_note_s liste_note;
@@ -23,13 +26,17 @@ typedef struct {
     int niveau;
     int  filiere;
     int semestre;
-    char nom_prenom_enseignent[50];
+    InternId nom_prenom_enseignent;  // interned teacher name
+    int is_deleted;                  // kept in place until the list is compacted
    } Module;
 typedef struct ListeModules_s {
     Module* cours;
     int count;
     int capacity;
     char filename[256];
+    Tombstones tombstones;   // deleted modules awaiting compaction
+    int dirty;               // changed since the last save
+    TableLock* lock;         // shared tables only, see table_lock.h
 } ListeModules;
 typedef struct {
     int id_examen;
@@ -44,11 +51,14 @@ typedef struct {
     int capacity;
     char filename[256];
 }liste_examen;
+// A deleted grade keeps its slot with is_deleted set until the list is
+// compacted
 typedef struct {
     int id_etudiant;
     int id_examen;
     float note_obtenue;
     int present;
+    int is_deleted;
 } Note;
 
 // Grade is an alias for Note for UI compatibility
@@ -59,6 +69,9 @@ typedef struct liste_note_s {
     int count;
     int capacity;
     char file_name[256];
+    Tombstones tombstones;   // deleted grades awaiting compaction
+    int dirty;               // changed since the last save
+    TableLock* lock;         // shared tables only, see table_lock.h
 } liste_note;
 //fct examen
 Examen* creer_examen();
@@ -79,6 +92,7 @@ int trie_liste_examen_nom(int n,liste_examen liste);
 liste_note* creer_liste_note(int capacite);
 Note* cree_note() ;
 int note_ajouter(liste_note *liste, Note *n);
+int note_ajouter_locked(liste_note *liste, const Note *n);  // caller holds the write lock
 void afficher_note(Note *n);
 void afficher_liste_notes(liste_note *liste);
 Note* chercher_note(liste_note *liste, int id_etudiant, int id_examen);
@@ -86,6 +100,9 @@ void afficher_notes_etudiant(liste_note *liste, int id_etudiant);
 void afficher_notes_examen(liste_note *liste, int id_examen);
 void modifier_note(liste_note *liste);
 int note_supprimer(liste_note *liste, int id_etudiant, int id_examen);
+int liste_note_compacter(liste_note *liste);
+int liste_note_compacter_si_besoin(liste_note *liste);
+liste_note* liste_note_copier(const liste_note *liste);
 float calculer_moyenne_etudiant(liste_note *liste, int id_etudiant);
 float calculer_moyenne_examen(liste_note *liste, int id_examen);
 void statistiques_examen(liste_note *liste, int id_examen);
@@ -100,6 +117,9 @@ void detruire_liste_notes(liste_note **liste);
  int cours_ajouter(ListeModules* liste, Module cours);
  int cours_supprimer_par_nom(ListeModules* liste, char* cours_nom);
  int cours_supprimer_par_id(ListeModules *liste, int cours_id);
+ int liste_cours_compacter(ListeModules *liste);
+ int liste_cours_compacter_si_besoin(ListeModules *liste);
+ ListeModules* liste_cours_copier(const ListeModules *liste);
  Module* cours_rechercher_par_id(ListeModules* liste, int cours_id);
  void cours_afficher(Module* m);
  void liste_cours_afficher(ListeModules* liste);
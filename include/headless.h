@@ -0,0 +1,35 @@
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+#include "config.h"
+
+// Batch administration from the command line, without a display:
+//
+//     student_mgmt --headless [--data DIR] <command> [options]
+//
+//     import <students|grades|attendance> FILE [--rejects FILE]
+//     export <table> [--format csv|ndjson] [--columns LIST] [--output FILE]
+//     recompute-gpa
+//     stats
+//     rotate-logs [--keep N]
+//     serve [--bind ADDRESS] [--port N] [--workers N]   (see http_server.h)
+//
+// Only the tables a command needs are loaded, and GTK is never
+// initialised, so a command starts in milliseconds and runs from cron or
+// a CI job. Exports stream to stdout unless --output is given; the
+// modules' log lines go to stderr so they never mix with the data.
+//
+// import and recompute-gpa rewrite the data files, so they must not run
+// while the application has the same data directory open: it would save
+// its own copy of the tables over theirs. They refuse (exit status 1)
+// when the application's replication socket in the data directory
+// answers. On Windows, or in a build with REPLICATION_ENABLED off, that
+// check is not possible and the application has to be closed first.
+//
+// Exit status: 0 on success, 1 when the command failed, 2 on a usage
+// error.
+
+// argv[0] is the program name; the caller strips "--headless"
+int headless_main(int argc, char** argv);
+
+#endif // HEADLESS_H
@@ -0,0 +1,55 @@
+#ifndef HTTP_SERVER_H
+#define HTTP_SERVER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "config.h"
+#include "student.h"
+#include "grade.h"
+#include "attendance.h"
+#include "club.h"
+#include "export.h"
+
+// Read-only JSON API over HTTP/1.1 for the portal and the mobile app:
+//
+//     GET /health
+//     GET /students                    GET /students/{id}
+//     GET /students/{id}/grades        GET /students/{id}/attendance
+//     GET /grades                      GET /attendance
+//     GET /clubs                       GET /clubs/{id}
+//     GET /clubs/{id}/members
+//
+// Lists take ?offset=N&limit=N (default HTTP_DEFAULT_LIMIT, at most
+// HTTP_MAX_LIMIT) and answer with a JSON array; /{id} answers with one
+// object or 404. Records are formatted by the export engine, so the field
+// names are the export column names (see export.h). Other methods get 405 with
+// Allow: GET.
+//
+// One thread runs an epoll loop over non-blocking sockets with keep-alive
+// and hands each complete request to a pool of worker threads. Workers
+// read the tables under their read locks (table_lock.h) and never change
+// them, so the server can run next to the UI. A connection with no traffic
+// for HTTP_IDLE_TIMEOUT_MS is closed.
+//
+// Needs epoll, so it is only built on Linux; elsewhere http_server_start()
+// reports that and returns 0.
+
+// Tables served. The lists must outlive the server; exams may be NULL,
+// which leaves the module columns of grades empty.
+typedef struct {
+    StudentList* students;
+    GradeList* grades;
+    AttendanceList* attendance;
+    ClubList* clubs;
+    MembershipList* memberships;
+    const ExportExamIndex* exams;
+} HttpTables;
+
+// Main thread. address is an IPv4 address to bind, such as "127.0.0.1";
+// workers <= 0 picks HTTP_SERVER_WORKERS. Returns 1 once listening.
+int http_server_start(const char* address, int port, int workers, const HttpTables* tables);
+// Closes every connection and waits for the workers
+void http_server_stop(void);
+
+#endif // HTTP_SERVER_H
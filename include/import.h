@@ -0,0 +1,71 @@
+#ifndef IMPORT_H
+#define IMPORT_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "config.h"
+#include "student.h"
+#include "grade.h"
+#include "attendance.h"
+
+// Bulk import of students, grades or attendance from a CSV file whose
+// first row names the columns, as written by the export engine (see
+// export.h). Unknown columns are ignored.
+//
+// An import runs in two steps:
+//  1. import_parse_file() reads the file, splits it into chunks at record
+//     boundaries and parses and validates the chunks on up to
+//     IMPORT_MAX_THREADS threads. It touches no shared table, so it may
+//     run on a worker thread.
+//  2. import_batch_apply() upserts every valid row into the tables in one
+//     pass on the main thread, holding the table's write lock once for
+//     the whole batch, so readers see all of it or none. Students match by
+//     id, then by e-mail; grades by (student, exam); attendance by id.
+//     Rows without an id get the next free one. Nothing is saved; the
+//     tables are left dirty.
+// Rows refused by either step are kept with the reason and can be written
+// to a report.
+
+typedef enum {
+    IMPORT_STUDENTS = 0,
+    IMPORT_GRADES = 1,
+    IMPORT_ATTENDANCE = 2,
+    IMPORT_KIND_COUNT
+} ImportKind;
+
+typedef struct {
+    int rows;               // data rows read
+    int inserted;
+    int updated;
+    int rejected;
+} ImportCounts;
+
+// Tables an import is applied to. Students are also used to check the
+// student of a grade or attendance row, and exams the exam of a grade;
+// either may be NULL to skip that check.
+typedef struct {
+    StudentList* students;
+    GradeList* grades;
+    AttendanceList* attendance;
+    liste_examen* exams;
+} ImportTargets;
+
+typedef struct ImportBatch ImportBatch;
+
+const char* import_kind_name(ImportKind kind);
+int import_kind_from_name(const char* name);    // -1 if unknown
+
+// Any thread. Returns NULL if the file cannot be read or its header lacks
+// a required column.
+ImportBatch* import_parse_file(ImportKind kind, const char* filename);
+
+// Main thread
+int import_batch_apply(ImportBatch* batch, const ImportTargets* targets);
+
+const ImportCounts* import_batch_counts(const ImportBatch* batch);
+// CSV of the rejected rows: line number, reason, then the row as it was
+int import_batch_write_rejects(const ImportBatch* batch, const char* filename);
+void import_batch_destroy(ImportBatch* batch);
+
+#endif // IMPORT_H
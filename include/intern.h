@@ -0,0 +1,31 @@
+#ifndef INTERN_H
+#define INTERN_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Global string interner for low-cardinality fields (course names,
+// departments, club categories, membership roles, module teachers).
+// Each distinct string is stored once and addressed by a 4-byte id, so
+// records compare and group these fields as integers. Ids are dense,
+// start at 0 for the empty string and stay valid until intern_clear().
+// intern_lookup() may be called from the autosave thread; everything else
+// is main-thread only.
+
+typedef unsigned int InternId;
+
+#define INTERN_EMPTY 0u                    // id of ""
+#define INTERN_NOT_FOUND ((InternId)-1)
+#define INTERN_BLOCK_SIZE 16384
+
+// Interning
+InternId intern_string(const char* text);
+InternId intern_find(const char* text);
+const char* intern_lookup(InternId id);
+int intern_count(void);
+
+// Teardown, invalidates every id handed out so far
+void intern_clear(void);
+
+#endif // INTERN_H
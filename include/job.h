@@ -0,0 +1,55 @@
+#ifndef JOB_H
+#define JOB_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "config.h"
+
+// Background jobs for heavy UI actions. A job's run function executes on a
+// worker thread from a small pool; its progress and its result are handed
+// back to the GTK main loop with g_idle_add, so the done and progress
+// callbacks run on the main thread and may touch widgets.
+//
+// Run functions follow the rules in table_lock.h: they read shared tables
+// under the read lock or through a *_snapshot copy, and never mutate them.
+
+typedef struct Job Job;
+
+// Worker thread: do the work and return the result for the done callback.
+// Long loops should check job_is_cancelled() and report progress.
+typedef void* (*JobRunFunc)(Job* job, void* data);
+// Main thread: called once with the result, unless the job was cancelled.
+// The result belongs to the callback.
+typedef void (*JobDoneFunc)(void* result, void* data);
+// Main thread: the latest progress; reports that arrive faster than the
+// main loop runs are merged
+typedef void (*JobProgressFunc)(double fraction, const char* message, void* data);
+typedef void (*JobFreeFunc)(void* p);
+
+typedef struct {
+    const char* name;               // for log lines
+    JobRunFunc run;
+    JobDoneFunc done;
+    JobProgressFunc progress;       // optional
+    JobFreeFunc free_result;        // optional, frees the result of a cancelled job
+    JobFreeFunc free_data;          // optional, frees data once the job is over
+} JobSpec;
+
+// Main thread. Returns NULL if the job could not be queued; data has been
+// freed with free_data then.
+Job* job_submit(const JobSpec* spec, void* data);
+
+// Main thread. The done and progress callbacks are not called again, so
+// the caller may free whatever they use. The job pointer is invalid after
+// the done callback or a cancel.
+void job_cancel(Job* job);
+
+// Worker thread
+int job_is_cancelled(Job* job);
+void job_report_progress(Job* job, double fraction, const char* message);
+
+// Main thread: cancel every job and wait for the running ones
+void jobs_shutdown(void);
+
+#endif // JOB_H
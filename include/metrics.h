@@ -0,0 +1,67 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "config.h"
+#include "arena.h"
+#include "utils.h"
+
+// Process and table resource metrics: resident memory, CPU, uptime and
+// disk from utils_system_*, plus each registered table's memory, counted
+// as bytes in use (rows) against bytes allocated (capacity). The admin
+// view shows a live sample; metrics_start() also appends one sample per
+// interval to a newline-delimited JSON file, so growth can be followed
+// over a session.
+//
+// Main thread only.
+
+// Registered once per table. The pointers are read on every sample, so
+// they must stay valid until metrics_stop().
+typedef struct {
+    const char* name;
+    const int* count;               // the list's count field
+    const int* capacity;            // the list's capacity field
+    size_t record_size;
+    Arena* const* strings;          // optional, arena holding the table's strings
+} MetricsTable;
+
+typedef struct {
+    const char* name;
+    int rows;
+    int capacity;
+    size_t bytes_used;              // rows, plus the strings handed out
+    size_t bytes_reserved;          // capacity, plus the strings arena's blocks
+} MetricsTableUsage;
+
+typedef struct {
+    time_t taken_at;
+    long uptime_seconds;
+    size_t rss_bytes;
+    float cpu_percent;              // of one core, since the sampler's previous sample
+    size_t disk_total_bytes;        // file system of the data directory
+    size_t disk_free_bytes;
+    size_t arena_bytes;             // every live arena
+    size_t table_bytes_used;        // sums over the tables
+    size_t table_bytes_reserved;
+    int n_tables;
+    MetricsTableUsage tables[METRICS_MAX_TABLES];
+} MetricsSample;
+
+// The descriptor is copied
+int metrics_register_table(const MetricsTable* table);
+
+// cpu belongs to the caller and spans its samples (see CpuSampler)
+void metrics_sample(MetricsSample* sample, CpuSampler* cpu);
+// One JSON object on one line, without the newline; g_free() the result
+char* metrics_sample_to_json(const MetricsSample* sample);
+
+// Appends a sample to filename every interval_seconds from the main loop;
+// disk usage is measured on the file system holding data_dir
+int metrics_start(unsigned int interval_seconds, const char* data_dir, const char* filename);
+// Stops the dump and forgets every table
+void metrics_stop(void);
+
+#endif // METRICS_H
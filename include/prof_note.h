@@ -6,6 +6,7 @@
 #include <string.h>
 #include <time.h>
 #include "config.h"
+#include "table_lock.h"
 
 // Note structure
 typedef struct {
@@ -23,19 +24,24 @@ typedef struct {
     int count;
     int capacity;
     char filename[256];
+    int dirty;               // changed since the last save
+    TableLock* lock;         // shared tables only, see table_lock.h
 } ProfessorNoteList;
 
 // Function declarations
 ProfessorNoteList* prof_note_list_create(void);
 void prof_note_list_destroy(ProfessorNoteList* list);
 int prof_note_create(ProfessorNoteList* list, int student_id, int module_id, int prof_id, const char* content);
+// Appends a complete note, id and date included
+int prof_note_list_add(ProfessorNoteList* list, ProfessorNote note);
+ProfessorNoteList* prof_note_list_snapshot(const ProfessorNoteList* list);
 int prof_note_save(ProfessorNoteList* list, const char* filename);
 int prof_note_load(ProfessorNoteList* list, const char* filename);
 
 // Helper functions
-// Returns a dynamically allocated array of pointers to notes for a specific student
+// Returns an array of pointers to notes for a specific student, or NULL if none
 // count is updated with the number of notes found
-// The caller is responsible for freeing the returned array (but not the notes themselves)
+// The array lives in the scratch arena until the current UI callback returns; do not free it
 ProfessorNote** prof_note_find_by_student(ProfessorNoteList* list, int student_id, int* count);
 ProfessorNote** prof_note_find_by_module(ProfessorNoteList* list, int module_id, int* count);
 
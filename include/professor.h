@@ -7,6 +7,8 @@
 #include <time.h>
 #include "config.h"
 #include "grade.h"
+#include "intern.h"
+#include "table_lock.h"
 
 // Professor structure
 typedef struct {
@@ -16,8 +18,8 @@ typedef struct {
     char email[MAX_EMAIL_LENGTH];
     char phone[MAX_PHONE_LENGTH];
     char address[MAX_ADDRESS_LENGTH];
-    char department[MAX_COURSE_LENGTH];
-    char specialization[MAX_COURSE_LENGTH];
+    InternId department;
+    InternId specialization;
     int years_of_experience;
     char office_location[100];
     time_t hire_date;
@@ -33,6 +35,8 @@ typedef struct {
     char filename[256];
     int auto_save_enabled;
     time_t last_save_time;
+    int dirty;               // changed since the last save
+    TableLock* lock;         // shared tables only, see table_lock.h
 } ProfessorList;
 
 // Function declarations
@@ -40,6 +44,7 @@ ProfessorList* professor_list_create(void);
 void professor_list_destroy(ProfessorList* list);
 int professor_list_add(ProfessorList* list, Professor professor);
 int professor_list_remove(ProfessorList* list, int professor_id);
+ProfessorList* professor_list_snapshot(const ProfessorList* list);
 Professor* professor_list_find_by_id(ProfessorList* list, int professor_id);
 Professor* professor_list_find_by_name(ProfessorList* list, const char* first_name, const char* last_name);
 Professor* professor_list_find_by_email(ProfessorList* list, const char* email);
@@ -52,6 +57,7 @@ void professor_list_sort_by_id(ProfessorList* list);
 void professor_list_sort_by_department(ProfessorList* list);
 int professor_list_update(ProfessorList* list, int professor_id, Professor updated_professor);
 int professor_list_count_by_department(ProfessorList* list, const char* department);
+// Result array lives in the scratch arena until the current UI callback returns
 Professor** professor_list_filter_by_department(ProfessorList* list, const char* department, int* result_count);
 int professor_validate(Professor* professor);
 void professor_print_info(Professor* professor);
@@ -0,0 +1,44 @@
+#ifndef REPLICA_H
+#define REPLICA_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "config.h"
+#include "student.h"
+#include "grade.h"
+#include "attendance.h"
+#include "club.h"
+#include "replica_format.h"
+
+// Publishes immutable, versioned snapshots of the tables into POSIX shared
+// memory so that reporting scripts and other local processes can read
+// them through replica_client.h without loading the text files. The
+// layout is in replica_format.h.
+//
+// The application publishes once at start and then on every autosave
+// round that saves something, so a snapshot holds what was just
+// committed. Publishing copies the tables on the main thread.
+//
+// POSIX only; on Windows replica_start() reports that and returns 0.
+//
+// Main thread only.
+
+typedef struct {
+    StudentList* students;
+    GradeList* grades;
+    AttendanceList* attendance;
+    ClubList* clubs;
+    MembershipList* memberships;
+} ReplicaTables;
+
+// Creates the control object and publishes the first snapshot. The lists
+// must stay valid until replica_stop().
+int replica_start(const char* name, const ReplicaTables* tables);
+// Publishes the tables as they are now under the next generation
+int replica_publish(void);
+// Unlinks the control object and the current snapshot; readers that have
+// it mapped keep it
+void replica_stop(void);
+
+#endif // REPLICA_H
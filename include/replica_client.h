@@ -0,0 +1,56 @@
+#ifndef REPLICA_CLIENT_H
+#define REPLICA_CLIENT_H
+
+#include <stdint.h>
+#include <time.h>
+#include "replica_format.h"
+
+// Reader side of the shared-memory replica (see replica_format.h). Maps
+// the snapshot the application published last and hands out pointers
+// straight into it: nothing is copied or parsed. Needs only libc, so a
+// reporting tool links replica_client.c alone (./build.sh replica).
+//
+//     ReplicaClient* replica = replica_open("/student_mgmt_replica");
+//     const ReplicaStudent* s = replica_find_student(replica, 42);
+//     printf("%s\n", replica_string(replica, s->last_name));
+//     int n;
+//     const ReplicaGrade* grades = replica_student_grades(replica, 42, &n);
+//     replica_close(replica);
+//
+// A mapped snapshot never changes, even after the application publishes a
+// newer one; replica_refresh() moves to the newest. Pointers from a
+// snapshot are valid until the next successful replica_refresh() or
+// replica_close(). One client per thread, or lock around it.
+//
+// POSIX only; on Windows replica_open() returns NULL.
+
+typedef struct ReplicaClient ReplicaClient;
+
+// NULL if nothing is published under name, or on a format mismatch
+ReplicaClient* replica_open(const char* name);
+// 1 if a newer snapshot was mapped, 0 if the current one is the newest,
+// -1 on error (the current one stays mapped)
+int replica_refresh(ReplicaClient* client);
+void replica_close(ReplicaClient* client);
+
+uint64_t replica_generation(const ReplicaClient* client);
+time_t replica_published_at(const ReplicaClient* client);
+
+// Whole tables, in the order given in replica_format.h
+const ReplicaStudent* replica_students(const ReplicaClient* client, int* count);
+const ReplicaGrade* replica_grades(const ReplicaClient* client, int* count);
+const ReplicaAttendance* replica_attendance(const ReplicaClient* client, int* count);
+const ReplicaClub* replica_clubs(const ReplicaClient* client, int* count);
+const ReplicaMembership* replica_memberships(const ReplicaClient* client, int* count);
+
+// Never NULL; "" for an invalid offset
+const char* replica_string(const ReplicaClient* client, ReplicaString string);
+
+// Binary searches; NULL or a count of 0 when nothing matches
+const ReplicaStudent* replica_find_student(const ReplicaClient* client, int student_id);
+const ReplicaClub* replica_find_club(const ReplicaClient* client, int club_id);
+const ReplicaGrade* replica_student_grades(const ReplicaClient* client, int student_id, int* count);
+const ReplicaAttendance* replica_student_attendance(const ReplicaClient* client, int student_id, int* count);
+const ReplicaMembership* replica_club_members(const ReplicaClient* client, int club_id, int* count);
+
+#endif // REPLICA_CLIENT_H
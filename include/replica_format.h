@@ -0,0 +1,128 @@
+#ifndef REPLICA_FORMAT_H
+#define REPLICA_FORMAT_H
+
+#include <stdint.h>
+
+// Layout of the shared-memory read replica (see replica.h for the
+// publisher, replica_client.h for readers). Shared by both sides and
+// independent of the application's own headers.
+//
+// Two kinds of POSIX shared-memory objects:
+//  - the control object, named REPLICA_SHM_NAME, holding the generation
+//    of the current snapshot;
+//  - one snapshot per generation, named "<name>.<pid>.<generation>": a
+//    ReplicaHeader, then each table as an array of fixed-width records,
+//    then a heap of NUL-terminated strings that records refer to by
+//    offset.
+// A snapshot is complete before its generation is stored in the control
+// object and never changes afterwards. The previous snapshot is unlinked,
+// so it lives on only as long as some reader keeps it mapped.
+//
+// Deleted records are left out. Tables are sorted for binary search:
+// students and clubs by id, grades by (student_id, exam_id), attendance by
+// (student_id, date), memberships by (club_id, student_id).
+
+#define REPLICA_MAGIC 0x4c504552u            // "REPL"
+#define REPLICA_FORMAT_VERSION 1
+
+// Offset into the string heap; 0 is the empty string
+typedef uint32_t ReplicaString;
+
+typedef enum {
+    REPLICA_STUDENTS = 0,
+    REPLICA_GRADES = 1,
+    REPLICA_ATTENDANCE = 2,
+    REPLICA_CLUBS = 3,
+    REPLICA_MEMBERSHIPS = 4,
+    REPLICA_TABLE_COUNT
+} ReplicaTableId;
+
+typedef struct {
+    int32_t id;
+    int32_t age;
+    int32_t year;
+    float gpa;
+    int32_t active;
+    ReplicaString first_name;
+    ReplicaString last_name;
+    ReplicaString email;
+    ReplicaString phone;
+    ReplicaString address;
+    ReplicaString course;
+    uint32_t reserved;
+    int64_t enrollment_date;
+} ReplicaStudent;
+
+typedef struct {
+    int32_t student_id;
+    int32_t exam_id;
+    float grade;                        // out of 20
+    int32_t present;
+} ReplicaGrade;
+
+typedef struct {
+    int32_t id;
+    int32_t student_id;
+    int32_t course_id;
+    int32_t status;                     // 0 absent, 1 present, 2 late, 3 excused
+    int32_t teacher_id;
+    ReplicaString reason;
+    int64_t date;
+    int64_t recorded_time;
+} ReplicaAttendance;
+
+typedef struct {
+    int32_t id;
+    int32_t president_id;
+    int32_t advisor_id;
+    int32_t member_count;
+    int32_t max_members;
+    int32_t active;
+    float budget;
+    ReplicaString name;
+    ReplicaString description;
+    ReplicaString category;
+    ReplicaString meeting_day;
+    ReplicaString meeting_time;
+    ReplicaString meeting_location;
+    uint32_t reserved;
+    int64_t founded_date;
+    int64_t last_meeting;
+} ReplicaClub;
+
+typedef struct {
+    int32_t id;
+    int32_t student_id;
+    int32_t club_id;
+    int32_t active;
+    ReplicaString role;
+    uint32_t reserved;
+    int64_t join_date;
+} ReplicaMembership;
+
+typedef struct {
+    uint64_t offset;                    // from the start of the snapshot, 8-byte aligned
+    uint32_t count;
+    uint32_t record_size;               // sizeof the record type, checked by readers
+} ReplicaTableInfo;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t format_version;
+    uint64_t generation;
+    int64_t published_at;               // seconds since the epoch
+    uint64_t size;                      // of the whole snapshot
+    ReplicaTableInfo tables[REPLICA_TABLE_COUNT];
+    uint64_t strings_offset;
+    uint64_t strings_size;
+} ReplicaHeader;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t format_version;
+    int32_t pid;                        // of the publisher, part of snapshot names
+    uint32_t reserved;
+    _Atomic uint64_t generation;        // 0 until the first snapshot
+} ReplicaControl;
+
+#endif // REPLICA_FORMAT_H
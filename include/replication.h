@@ -0,0 +1,92 @@
+#ifndef REPLICATION_H
+#define REPLICATION_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "config.h"
+#include "auth.h"
+#include "student.h"
+#include "grade.h"
+#include "attendance.h"
+#include "club.h"
+#include "prof_note.h"
+#include "changelog.h"
+
+// Change-log replication to read-only follower instances on the same
+// machine, such as the library kiosk, over a Unix domain socket.
+//
+// The primary logs every change the mutators report (changelog.h) as a
+// binary record holding the whole row, numbered by a log sequence number
+// (LSN). Changes are batched: a batch is sent once it reaches
+// REPLICATION_BATCH_BYTES or has waited REPLICATION_FLUSH_MS. Sent batches
+// stay in a backlog of REPLICATION_BACKLOG_BYTES so that a follower can
+// reconnect and resume where it stopped.
+//
+// Backpressure: each follower has a sender thread that blocks on the
+// socket when the follower reads slowly, and a follower stops reading
+// while REPLICATION_QUEUE_BYTES of received changes wait to be applied.
+// The UI thread of the primary never waits for either. A follower that
+// falls behind the backlog, or that connects for the first time, is sent
+// a snapshot of the tables instead, and then the changes after it.
+//
+// The follower applies batches and snapshots on its main thread through
+// the tables' own mutators. A snapshot is applied as a difference, so
+// records that did not change keep their place in the views.
+//
+// Lag is measured from the moment a change entered a batch on the primary
+// to the moment the follower applied it; both ends read the same monotonic
+// clock. replication_get_status() reports it on both sides.
+//
+// POSIX only; on Windows both start functions report that and return 0.
+//
+// Main thread only.
+
+// Tables replicated; the lists must outlive replication
+typedef struct {
+    UserList* users;
+    StudentList* students;
+    GradeList* grades;
+    AttendanceList* attendance;
+    ClubList* clubs;
+    MembershipList* memberships;
+    ProfessorNoteList* prof_notes;
+} ReplicationTables;
+
+// Follower: called after each change applied to a table, with the record
+// as it is now (as it was, for CHANGE_DELETE); lets the caller update the
+// indices it keeps over the tables
+typedef void (*ReplicationApplyFunc)(ChangeTable table, ChangeOp op, const void* record, void* user_data);
+
+typedef enum {
+    REPLICATION_OFF = 0,
+    REPLICATION_PRIMARY = 1,
+    REPLICATION_FOLLOWER = 2
+} ReplicationRole;
+
+typedef struct {
+    ReplicationRole role;
+    int connected;                  // followers connected, or 1 if connected to the primary
+    uint64_t lsn;                   // last change logged (primary) or applied (follower)
+    uint64_t primary_lsn;           // last change the primary has logged, as far as known
+    uint64_t behind;                // changes logged but not yet applied by the slowest follower
+    double lag_ms;                  // change to apply, for the last batch applied
+    double max_lag_ms;              // since start
+    uint64_t snapshots;             // sent or applied
+    uint64_t bytes;                 // sent or received
+} ReplicationStatus;
+
+// Listens on socket_path and logs changes from now on
+int replication_primary_start(const char* socket_path, const ReplicationTables* tables);
+void replication_primary_stop(void);
+
+// Connects to the primary at socket_path, retrying until it is up;
+// apply may be NULL
+int replication_follower_start(const char* socket_path, const ReplicationTables* tables,
+                               ReplicationApplyFunc apply, void* user_data);
+void replication_follower_stop(void);
+
+void replication_get_status(ReplicationStatus* status);
+
+#endif // REPLICATION_H
@@ -0,0 +1,68 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include "student.h"
+
+// Trigram inverted index over student first name, last name, email, course
+// and id. Text is case and accent folded ("Ingénierie" -> "ingenierie").
+// Documents are kept in the same order as the StudentList so a hit can be
+// mapped back to its list index; rebuild after sorting the list. Removed
+// students keep their document slot until the list itself is compacted.
+
+#define SEARCH_ALPHABET 64
+#define SEARCH_TRIGRAM_COUNT (SEARCH_ALPHABET * SEARCH_ALPHABET * SEARCH_ALPHABET)
+#define SEARCH_MAX_TEXT 512
+#define SEARCH_MAX_QUERY 128
+
+// Hit ranking, best first
+#define SEARCH_SCORE_EXACT_ID 0
+#define SEARCH_SCORE_WORD_START 1
+#define SEARCH_SCORE_SUBSTRING 2
+
+// Sorted list of document slots containing one trigram
+typedef struct {
+    int* slots;
+    int count;
+    int capacity;
+} SearchPosting;
+
+typedef struct {
+    int id;
+    char* text;      // folded " first last email course id " text
+    int is_live;
+    int is_listed;   // still holds a StudentList slot, removed or not
+} SearchDoc;
+
+typedef struct {
+    int id;          // student id
+    int index;       // position in the StudentList
+    int score;       // SEARCH_SCORE_*
+} SearchHit;
+
+typedef struct {
+    SearchPosting* postings;   // SEARCH_TRIGRAM_COUNT posting lists
+    SearchDoc* docs;
+    int doc_count;
+    int doc_capacity;
+    int live_count;
+    int* live_tree;            // Fenwick tree over listed docs: slot -> list index
+    int* id_slots;             // open addressing id -> slot, -1 = empty
+    int id_capacity;
+    StudentList* students;     // mirrored list, watched for compaction
+} SearchIndex;
+
+// Index lifecycle
+SearchIndex* search_index_create(void);
+void search_index_destroy(SearchIndex* index);
+int search_index_build(SearchIndex* index, StudentList* students);
+
+// Mutations, mirrored from the StudentList
+int search_index_add_student(SearchIndex* index, const Student* student);
+int search_index_update_student(SearchIndex* index, const Student* student);
+int search_index_remove_student(SearchIndex* index, int student_id);
+
+// Queries
+int search_index_query(SearchIndex* index, const char* query, SearchHit* hits, int max_hits);
+int search_fold_text(const char* text, char* out, int out_size);
+
+#endif // SEARCH_H
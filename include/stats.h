@@ -31,7 +31,8 @@ typedef struct {
 typedef struct {
     int total_students;
     int students_by_year[5];  // Index 0 unused, 1-4 for years
-    int students_by_course[20];  // Top 20 courses
+    int students_by_course[20];  // Top 20 courses, largest first
+    InternId course_ids[20];     // Course of each students_by_course entry
     float average_age;
     int age_distribution[10];  // Age ranges
     float average_gpa;
@@ -78,6 +79,7 @@ typedef struct {
     int most_popular_club_id;
     int least_popular_club_id;
     int clubs_by_category[10];
+    int students_in_any_club;
     int students_in_multiple_clubs;
 } ClubStats;
 
@@ -6,26 +6,47 @@
 #include <string.h>
 #include <time.h>
 #include "config.h"
+#include "intern.h"
+#include "arena.h"
+#include "tombstone.h"
+#include "table_lock.h"
 
-// Student structure
+// Student record. The hot fields scanned by sorts, filters and statistics
+// come first, with the course as an interned id; the other strings are
+// cold and point into the owning list's string arena. A Student built
+// outside a list only borrows its strings until student_list_add copies
+// them in. Removed students stay in place with is_deleted set until the
+// list is compacted; loops over the list skip them.
 typedef struct {
     int id;
-    char first_name[MAX_NAME_LENGTH];
-    char last_name[MAX_NAME_LENGTH];
-    char email[MAX_EMAIL_LENGTH];
-    char phone[MAX_PHONE_LENGTH];
-    char address[MAX_ADDRESS_LENGTH];
     int age;
-    char course[MAX_COURSE_LENGTH];
-    int year;    float gpa;    time_t enrollment_date;
+    int year;
+    float gpa;
     int is_active;
+    int is_deleted;
+    InternId course;
+    time_t enrollment_date;
+    const char* first_name;
+    const char* last_name;
+    const char* email;
+    const char* phone;
+    const char* address;
 } Student;
 
+// Strings live in a per-list arena. Blocks never move, so string pointers
+// stay valid while the list grows.
+#define STUDENT_STRING_BLOCK_SIZE 65536
+
 // Student list structure
 typedef struct {
     Student* students;
     int count;
-    int capacity;
+    int capacity;            // grows geometrically
+    Arena* strings;
+    size_t strings_wasted;   // replaced or removed strings, reclaimed by compaction
+    Tombstones tombstones;   // removed students awaiting compaction
+    int dirty;               // changed since the last save
+    TableLock* lock;         // shared tables only, see table_lock.h
     int is_loaded;          // Flag to track if data is loaded in memory
     char filename[256];      // Source filename for storage
     int auto_save_enabled;   // Flag for automatic saving
@@ -36,7 +57,14 @@ typedef struct {
 StudentList* student_list_create(void);
 void student_list_destroy(StudentList* list);
 int student_list_add(StudentList* list, Student student);
+int student_list_update(StudentList* list, Student* student, const Student* values);
+// The same for a caller that already holds the list's write lock
+int student_list_add_locked(StudentList* list, Student student);
+int student_list_update_locked(StudentList* list, Student* student, const Student* values);
 int student_list_remove(StudentList* list, int student_id);
+int student_list_compact(StudentList* list);
+int student_list_compact_if_needed(StudentList* list);
+StudentList* student_list_snapshot(const StudentList* list);
 Student* student_list_find_by_id(StudentList* list, int student_id);
 Student* student_list_find_by_name(StudentList* list, const char* first_name, const char* last_name);
 Student* student_list_find_by_email(StudentList* list, const char* email);
@@ -63,9 +91,15 @@ int student_validate_phone(const char* phone);
 int student_validate_age(int age);
 int student_validate_gpa(float gpa);
 
+// Quiet checks for batch use: NULL if valid, else the reason (static string)
+const char* student_check_email(const char* email);
+const char* student_check_phone(const char* phone);
+const char* student_check_age(int age);
+const char* student_check_gpa(float gpa);
+
 // Student input functions
 Student student_input_new(void);
-void student_input_edit(Student* student);
+void student_input_edit(StudentList* list, Student* student);
 void student_display_summary(StudentList* list);
 
 #endif // STUDENT_H
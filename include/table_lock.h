@@ -0,0 +1,40 @@
+#ifndef TABLE_LOCK_H
+#define TABLE_LOCK_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// Reader-writer lock for one shared table (the lists in AppState and
+// UIState). Private lists, such as the copies made for autosave, have no
+// lock; every call below is a no-op on NULL.
+//
+// Rules:
+//  1. Only the GTK main thread changes a shared table. The table's own
+//     mutators (add, update, remove, compact, load, sort) take the write
+//     lock themselves. Code that edits a record in place through a pointer
+//     from a find function wraps the edit in table_lock_write() and
+//     table_unlock_write().
+//  2. The main thread holds at most one write lock at a time, and reads
+//     without locking: nobody else writes.
+//  3. Any other thread holds the read lock for as long as it uses the
+//     table or a pointer into it, and never calls a mutator,
+//     intern_string() or the scratch arena. intern_lookup() is safe.
+//  4. Keep read sections short: the UI waits for them the next time it
+//     writes. For long work take a copy with the table's *_snapshot
+//     function, which locks for you, and work on the copy.
+
+typedef struct TableLock TableLock;
+
+// Created on the main thread, which becomes the only allowed writer
+TableLock* table_lock_create(const char* name);
+void table_lock_destroy(TableLock* lock);
+
+// Any thread
+void table_lock_read(TableLock* lock);
+void table_unlock_read(TableLock* lock);
+
+// Main thread only
+void table_lock_write(TableLock* lock);
+void table_unlock_write(TableLock* lock);
+
+#endif // TABLE_LOCK_H
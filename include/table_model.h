@@ -0,0 +1,75 @@
+#ifndef TABLE_MODEL_H
+#define TABLE_MODEL_H
+
+#include <gtk/gtk.h>
+#include "student.h"
+#include "grade.h"
+#include "attendance.h"
+#include "club.h"
+
+// Virtual GtkTreeModel that reads rows straight out of the in-memory lists.
+// Nothing is copied: the view asks for a cell, the model formats that one
+// cell from the backing table. The table must outlive the model.
+
+// Which in-memory table the model reads from
+typedef enum {
+    TABLE_MODEL_STUDENTS = 0,    // StudentList
+    TABLE_MODEL_GRADES = 1,      // liste_note
+    TABLE_MODEL_ATTENDANCE = 2,  // AttendanceList (grouped by course)
+    TABLE_MODEL_CLUBS = 3,       // ClubList
+    TABLE_MODEL_MODULES = 4      // ListeModules
+} TableModelKind;
+
+#define TABLE_MODEL_TYPE            (table_model_get_type())
+#define TABLE_MODEL(obj)            (G_TYPE_CHECK_INSTANCE_CAST((obj), TABLE_MODEL_TYPE, TableModel))
+#define IS_TABLE_MODEL(obj)         (G_TYPE_CHECK_INSTANCE_TYPE((obj), TABLE_MODEL_TYPE))
+
+typedef struct _TableModel TableModel;
+typedef struct _TableModelClass TableModelClass;
+
+struct _TableModel {
+    GObject parent;
+
+    TableModelKind kind;
+    void* table;        // StudentList*, liste_note*, ... depending on kind
+    gint stamp;         // invalidates iters handed out before a reset
+
+    // Optional row map. Entries >= 0 are indices into the table; a negative
+    // entry -1 - i is a group header for the row at table index i.
+    // When rows is NULL the model maps 1:1 onto the table.
+    int* rows;
+    int n_rows;         // row count last announced to the view
+    int n_records;      // table count last announced to the view
+
+    // Record id -> view row + 1, so a mutation touches only its own row.
+    // Grades have no id of their own and are keyed by table index.
+    GHashTable* id_rows;
+};
+
+struct _TableModelClass {
+    GObjectClass parent_class;
+};
+
+// Model lifecycle
+GType table_model_get_type(void);
+TableModel* table_model_new(TableModelKind kind, void* table);
+void table_model_set_rows(TableModel* model, const int* rows, int count);
+void table_model_group_attendance_by_course(TableModel* model);
+
+// Column layout
+int table_model_kind_n_columns(TableModelKind kind);
+const char* table_model_kind_column_title(TableModelKind kind, int column);
+
+// Row access
+int table_model_iter_get_index(TableModel* model, GtkTreeIter* iter);
+gboolean table_model_get_iter_for_index(TableModel* model, int table_index, GtkTreeIter* iter);
+gboolean table_model_get_iter_for_id(TableModel* model, int record_id, GtkTreeIter* iter);
+void table_model_row_changed(TableModel* model, int table_index);
+void table_model_sync(TableModel* model);
+
+// Change propagation, called after the backing list was mutated
+void table_model_record_inserted(TableModel* model);
+void table_model_record_changed(TableModel* model, int record_id);
+void table_model_record_removed(TableModel* model, int record_id);
+
+#endif // TABLE_MODEL_H
@@ -70,6 +70,14 @@ int theme_apply_to_window(GtkWindow* window, ThemeConfig* config);
 int theme_apply_to_widget(GtkWidget* widget, ThemeConfig* config);
 int theme_apply_css(GtkWidget* widget, const char* css_content);
 
+// Stylesheet cache. Each (theme, color scheme) is generated and parsed
+// once; theme_install() makes its provider the only theme provider on the
+// screen, so opening a window parses no CSS and switching themes swaps
+// one provider for another.
+int theme_install(ThemeConfig* config);
+const char* theme_get_css(ThemeConfig* config);    // owned by the cache, valid until the next theme change
+void theme_cache_clear(void);
+
 // CSS generation
 char* theme_generate_css(ThemeConfig* config);
 char* theme_generate_button_css(ThemeConfig* config);
@@ -185,6 +193,7 @@ void theme_print_color_scheme(ColorScheme* scheme);
 #define THEME_DEFAULT_MARGIN_LARGE 16
 #define THEME_DEFAULT_ANIMATION_DURATION 200
 #define THEME_DEFAULT_TRANSPARENCY_LEVEL 0.9
+#define THEME_CSS_CACHE_SIZE 4              // Compiled stylesheets kept for theme switching
 
 // Color constants
 #define THEME_COLOR_WHITE "#FFFFFF"
@@ -0,0 +1,49 @@
+#ifndef TOMBSTONE_H
+#define TOMBSTONE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "config.h"
+
+// Deletes by tombstone. Records carry an is_deleted flag: removing one only
+// sets the flag, so deleting a batch costs O(1) per record instead of
+// shifting the tail of the table every time. Iteration skips flagged
+// records, and a compaction pass squeezes them out once they make up
+// TOMBSTONE_COMPACT_PERCENT of the table. Anything that holds table
+// indices (views, the search index) watches the table and is handed the
+// old -> new index map when that happens.
+
+// remap[old_index] is the new index, or -1 for a dropped record
+typedef void (*TombstoneWatcher)(void* data, const int* remap, int old_count);
+
+typedef struct {
+    TombstoneWatcher callback;
+    void* data;
+} TombstoneWatch;
+
+typedef struct {
+    int dead;                   // flagged records still in the table
+    TombstoneWatch* watches;
+    int watch_count;
+} Tombstones;
+
+// Deletion
+int tombstones_mark(Tombstones* tombstones, int* is_deleted, int count);
+int tombstones_should_compact(const Tombstones* tombstones, int count);
+
+// Compaction, returns the new record count
+int tombstones_compact(Tombstones* tombstones, void* records, size_t record_size,
+                       size_t flag_offset, int count);
+
+// Index holders
+int tombstones_watch(Tombstones* tombstones, TombstoneWatcher callback, void* data);
+void tombstones_unwatch(Tombstones* tombstones, TombstoneWatcher callback, void* data);
+void tombstones_free(Tombstones* tombstones);
+
+// Background compaction: called once when some table crosses the threshold,
+// so the UI can compact from an idle callback
+void tombstones_set_compaction_hook(void (*schedule_compaction)(void));
+void tombstones_compaction_done(void);
+
+#endif // TOMBSTONE_H
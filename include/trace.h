@@ -0,0 +1,78 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "config.h"
+
+// Span tracing of the hot paths (loading, views, statistics, saves, login),
+// written as Chrome trace-event JSON that opens in Perfetto
+// (ui.perfetto.dev) or chrome://tracing.
+//
+// Tracing is compiled in only with -DTRACE_ENABLED (TRACE=1 ./build.sh);
+// otherwise every macro below expands to nothing and costs nothing.
+//
+// Each thread records into its own fixed-size buffer without locking.
+// When a buffer is full, later spans on that thread are dropped whole, so
+// begins and ends always pair up. The buffers are kept until
+// trace_write() dumps them, normally once at exit.
+//
+// Span names must be string literals or otherwise outlive the trace; only
+// the pointer is stored.
+//
+//     TRACE_SCOPE("load grades");          // ends with the enclosing block
+//
+//     TRACE_BEGIN("populate view");
+//     ...
+//     TRACE_END();
+
+#ifdef TRACE_ENABLED
+
+typedef struct {
+    int unused;
+} TraceScope;
+
+// Any thread
+void trace_begin(const char* name);
+void trace_end(void);
+// Names the calling thread in the trace; the first name given sticks
+void trace_thread_name(const char* name);
+
+// Main thread. trace_init() sets time zero and names the main thread.
+void trace_init(void);
+// Writes everything recorded so far; 1 on success
+int trace_write(const char* filename);
+
+static inline TraceScope trace_scope_begin(const char* name) {
+    trace_begin(name);
+    return (TraceScope){ 0 };
+}
+
+static inline void trace_scope_end(TraceScope* scope) {
+    (void)scope;
+    trace_end();
+}
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+
+// The span ends when the enclosing block is left, on any path
+#define TRACE_SCOPE(name) \
+    TraceScope TRACE_CONCAT(trace_scope_, __LINE__) \
+        __attribute__((cleanup(trace_scope_end))) = trace_scope_begin(name)
+#define TRACE_BEGIN(name) trace_begin(name)
+#define TRACE_END() trace_end()
+#define TRACE_THREAD_NAME(name) trace_thread_name(name)
+#define TRACE_INIT() trace_init()
+#define TRACE_WRITE(filename) trace_write(filename)
+
+#else
+
+#define TRACE_SCOPE(name) ((void)0)
+#define TRACE_BEGIN(name) ((void)0)
+#define TRACE_END() ((void)0)
+#define TRACE_THREAD_NAME(name) ((void)0)
+#define TRACE_INIT() ((void)0)
+#define TRACE_WRITE(filename) ((void)0)
+
+#endif // TRACE_ENABLED
+
+#endif // TRACE_H
@@ -11,7 +11,11 @@
 #include "grade.h"
 #include "attendance.h"
 #include "club.h"
+#include "prof_note.h"
 #include "stats.h"
+#include "table_model.h"
+#include "search.h"
+#include "complete.h"
 
 // Type aliases are defined in grade.h (already included above)
 // GradeList = liste_note, CourseList = ListeModules, Grade = Note
@@ -39,12 +43,19 @@ typedef struct {
     User* current_user;  // Currently logged in user for role checking
     UserList* users;
     StudentList* students;
+    SearchIndex* student_search;  // Trigram index over students, may be NULL
+    CompletionIndex* completer;   // Name/email/username prefixes, may be NULL
     GradeList* grades;
     AttendanceList* attendance;
     ClubList* clubs;
     MembershipList* memberships;
+    ClubRosterIndex* club_rosters;  // Active members per club, kept in step with memberships; may be NULL
     CourseList* courses;
+    liste_examen* exams;
+    ProfessorNoteList* prof_notes;
+    ProfessorList* professors;
     UIWindowType current_window_type;
+    int read_only;       // replication follower: actions that change a table are disabled
     int is_dark_theme;
     char current_language[10];
 } UIState;
@@ -186,6 +197,8 @@ const char* ui_get_translated_text(const char* key);
 GtkTreeView* ui_create_treeview_with_columns(const char* column_titles[], int column_count);
 void ui_treeview_add_row(GtkTreeView* treeview, const char* data[], int data_count);
 void ui_treeview_clear(GtkTreeView* treeview);
+GtkTreeView* ui_create_table_treeview(TableModelKind kind);
+void ui_treeview_set_table_model(GtkTreeView* treeview, TableModel* model);
 void ui_treeview_set_selection_callback(GtkTreeView* treeview, GCallback callback, gpointer user_data);
 
 // Student TreeView
@@ -243,6 +256,8 @@ void ui_show_warning_message(GtkWindow* parent, const char* message);
 int ui_show_confirm_message(GtkWindow* parent, const char* message);
 void ui_center_window(GtkWindow* window);
 void ui_set_window_icon(GtkWindow* window, const char* icon_file);
+void ui_disable_if_read_only(GtkWidget* widget, int read_only);
+void ui_entry_attach_completion(GtkEntry* entry, CompletionIndex* index, int kinds);
 
 // Callback functions
 void ui_on_login_button_clicked(GtkButton* button, gpointer user_data);
@@ -253,6 +268,8 @@ void ui_on_delete_student_clicked(GtkButton* button, gpointer user_data);
 void ui_on_search_students_clicked(GtkButton* button, gpointer user_data);
 void ui_on_clear_search_clicked(GtkButton* button, gpointer user_data);
 void ui_on_search_entry_activate(GtkEntry* entry, gpointer user_data);
+void ui_on_search_entry_changed(GtkEditable* editable, gpointer user_data);
+void ui_on_search_entry_destroy(GtkWidget* widget, gpointer user_data);
 void ui_on_student_selection_changed(GtkTreeSelection* selection, gpointer user_data);
 void ui_on_window_destroy(GtkWindow* window, gpointer user_data);
 void ui_on_forgot_password_clicked(GtkWidget* widget, GdkEventButton* event, gpointer user_data);
@@ -289,8 +306,9 @@ void ui_on_refresh_students_clicked(GtkButton* button, gpointer user_data);
 
 // Logo file
 #define UI_LOGO_FILE "src/t1.png"
+#define LOGIN_BACKGROUND_FILE "src/back.jpg"
 
-// Logo functions
+// Logo functions, backed by the image cache in asset.h
 GtkImage* ui_create_logo_image(const char* logo_path, int width, int height);
 void ui_set_window_logo(GtkWindow* window, const char* logo_path);
 
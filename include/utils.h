@@ -101,9 +101,13 @@ int utils_file_get_directory(const char* path, char* directory, size_t size);
 char* utils_file_read_all(const char* filename);
 int utils_file_write_all(const char* filename, const char* content);
 int utils_file_append(const char* filename, const char* content);
+long utils_file_count_lines(FILE* file);
 
 // Path utilities for data files
 char* utils_get_data_file_path(const char* filename, char* buffer, size_t buffer_size);
+// Read and write the data files in dir instead of the default data
+// directory; NULL goes back to the default. For headless tools.
+void utils_set_data_dir(const char* dir);
 char* utils_get_executable_dir(char* buffer, size_t buffer_size);
 
 // Memory utilities
@@ -209,9 +213,23 @@ void utils_log_debug(const char* function, const char* message);
 
 // System utilities
 int utils_system_get_current_time(time_t* current_time);
+// Process metrics, 0 where the platform is not supported (Linux and Windows
+// are). Uptime is seconds since the process started, memory the resident
+// set in bytes, CPU the percent of one core used since the sampler's
+// previous reading, disk the bytes of the file system holding path.
 int utils_system_get_uptime(long* uptime);
 int utils_system_get_memory_usage(size_t* memory_usage);
-int utils_system_get_cpu_usage(float* cpu_usage);
+
+// One per reader of the CPU usage, so readers at different intervals each
+// get their own; zero-initialised, the first reading covers the process
+// lifetime
+typedef struct {
+    double last_cpu;            // process CPU seconds at the previous reading
+    double last_wall;
+    int primed;
+} CpuSampler;
+
+int utils_system_get_cpu_usage(CpuSampler* sampler, float* cpu_usage);
 int utils_system_get_disk_usage(const char* path, size_t* total, size_t* free);
 int utils_system_get_username(char* username, size_t size);
 int utils_system_get_hostname(char* hostname, size_t size);
@@ -20,6 +20,19 @@
 #include "include/utils.h"
 #include "include/ui.h"
 #include "include/prof_note.h"
+#include "include/search.h"
+#include "include/complete.h"
+#include "include/intern.h"
+#include "include/arena.h"
+#include "include/autosave.h"
+#include "include/job.h"
+#include "include/asset.h"
+#include "include/trace.h"
+#include "include/metrics.h"
+#include "include/headless.h"
+#include "include/http_server.h"
+#include "include/replica.h"
+#include "include/replication.h"
 
 // Global application state
 typedef struct {
@@ -30,11 +43,14 @@ typedef struct {
     // Data structures
     UserList *users;
     StudentList *students;
+    SearchIndex *student_search;
+    CompletionIndex *completer;
     ProfessorList *professors;
     GradeList *grades;
     AttendanceList *attendance;
     ClubList *clubs;
     MembershipList *memberships;
+    ClubRosterIndex *club_rosters;
     ListeModules *modules;
     liste_examen *exams;
     ProfessorNoteList *prof_notes;
@@ -72,12 +88,364 @@ static int load_all_data(void);
 static int save_all_data(void);
 static void cleanup_app(void);
 
+/*
+ * Scratch arena reset. Scheduled on first use, so it runs once the
+ * callback that filled the arena has returned to the main loop.
+ */
+static gboolean reset_scratch_arena(gpointer data) {
+    (void)data;
+    arena_scratch_reset();
+    return G_SOURCE_REMOVE;
+}
+
+static void schedule_scratch_reset(void) {
+    g_idle_add(reset_scratch_arena, NULL);
+}
+
+/*
+ * Tombstone compaction. Scheduled when a table's removed records cross
+ * the threshold; runs once the deleting callback has returned, so nothing
+ * on the stack still holds a record pointer. Views and the search index
+ * are remapped through their watchers.
+ */
+static gboolean compact_tables(gpointer data) {
+    (void)data;
+    user_list_compact_if_needed(app_state.users);
+    student_list_compact_if_needed(app_state.students);
+    liste_note_compacter_si_besoin(app_state.grades);
+    attendance_list_compact_if_needed(app_state.attendance);
+    membership_list_compact_if_needed(app_state.memberships);
+    liste_cours_compacter_si_besoin(app_state.modules);
+    tombstones_compaction_done();
+    return G_SOURCE_REMOVE;
+}
+
+static void schedule_compaction(void) {
+    g_idle_add(compact_tables, NULL);
+}
+
+/*
+ * Background autosave. Each table gets a copy, a write and a free function,
+ * all run on the saver thread. The write functions return 1 on success
+ * whatever the underlying save returns.
+ */
+static void* snapshot_users(void* table) { return user_list_snapshot(table); }
+static int write_users(void* copy, const char* filename) { return auth_save_users(copy, filename); }
+static void free_users(void* copy) { user_list_destroy(copy); }
+
+// Students and professors honour their auto_save_enabled flag
+static void* snapshot_students(void* table) {
+    StudentList* students = table;
+    table_lock_read(students->lock);
+    int enabled = students->auto_save_enabled;
+    table_unlock_read(students->lock);
+    return enabled ? student_list_snapshot(students) : NULL;
+}
+static int write_students(void* copy, const char* filename) { return student_list_save_to_file(copy, filename); }
+static void free_students(void* copy) { student_list_destroy(copy); }
+
+static void* snapshot_professors(void* table) {
+    ProfessorList* professors = table;
+    table_lock_read(professors->lock);
+    int enabled = professors->auto_save_enabled;
+    table_unlock_read(professors->lock);
+    return enabled ? professor_list_snapshot(professors) : NULL;
+}
+static int write_professors(void* copy, const char* filename) { return professor_list_save_to_file(copy, filename); }
+static void free_professors(void* copy) { professor_list_destroy(copy); }
+
+// The grade writer refuses an empty list; there is nothing to write then
+static void* snapshot_grades(void* table) { return liste_note_copier(table); }
+static int write_grades(void* copy, const char* filename) {
+    liste_note* grades = copy;
+    return grades->count == 0 || grade_list_save_to_file(grades, filename) == 1;
+}
+static void free_grades(void* copy) { liste_note_destroy(copy); }
+
+static void* snapshot_attendance(void* table) { return attendance_list_snapshot(table); }
+static int write_attendance(void* copy, const char* filename) { return attendance_list_save_to_file(copy, filename); }
+static void free_attendance(void* copy) { attendance_list_destroy(copy); }
+
+static void* snapshot_clubs(void* table) { return club_list_snapshot(table); }
+static int write_clubs(void* copy, const char* filename) { return club_list_save_to_file(copy, filename); }
+static void free_clubs(void* copy) { club_list_destroy(copy); }
+
+static void* snapshot_memberships(void* table) { return membership_list_snapshot(table); }
+static int write_memberships(void* copy, const char* filename) { return membership_list_save_to_file(copy, filename); }
+static void free_memberships(void* copy) { membership_list_destroy(copy); }
+
+// The module writer takes its file name from the list
+static void* snapshot_modules(void* table) { return liste_cours_copier(table); }
+static int write_modules(void* copy, const char* filename) {
+    (void)filename;
+    return sauvegarder_modules_ds_file(*(ListeModules*)copy);
+}
+static void free_modules(void* copy) { liste_module_destroy(copy); }
+
+static void* snapshot_prof_notes(void* table) { return prof_note_list_snapshot(table); }
+static int write_prof_notes(void* copy, const char* filename) { return prof_note_save(copy, filename); }
+static void free_prof_notes(void* copy) { prof_note_list_destroy(copy); }
+
+static void start_autosave(void) {
+    char prof_notes_path[512];
+    snprintf(prof_notes_path, sizeof(prof_notes_path), "%s%s", app_state.data_dir, PROF_NOTES_FILE);
+
+    const AutosaveTable tables[] = {
+        {"users", USERS_FILE, app_state.users, &app_state.users->dirty, NULL,
+         snapshot_users, write_users, free_users},
+        {"students", STUDENTS_FILE, app_state.students, &app_state.students->dirty,
+         &app_state.students->last_save_time, snapshot_students, write_students, free_students},
+        {"professors", app_state.professors->filename, app_state.professors, &app_state.professors->dirty,
+         &app_state.professors->last_save_time, snapshot_professors, write_professors, free_professors},
+        {"grades", GRADES_FILE, app_state.grades, &app_state.grades->dirty, NULL,
+         snapshot_grades, write_grades, free_grades},
+        {"attendance", ATTENDANCE_FILE, app_state.attendance, &app_state.attendance->dirty, NULL,
+         snapshot_attendance, write_attendance, free_attendance},
+        {"clubs", CLUBS_FILE, app_state.clubs, &app_state.clubs->dirty, NULL,
+         snapshot_clubs, write_clubs, free_clubs},
+        {"memberships", MEMBERSHIPS_FILE, app_state.memberships, &app_state.memberships->dirty, NULL,
+         snapshot_memberships, write_memberships, free_memberships},
+        {"modules", app_state.modules->filename, app_state.modules, &app_state.modules->dirty, NULL,
+         snapshot_modules, write_modules, free_modules},
+        {"professor notes", prof_notes_path, app_state.prof_notes, &app_state.prof_notes->dirty, NULL,
+         snapshot_prof_notes, write_prof_notes, free_prof_notes}
+    };
+
+    for (size_t i = 0; i < sizeof(tables) / sizeof(tables[0]); i++) {
+        autosave_register(&tables[i]);
+    }
+    autosave_start(AUTOSAVE_INTERVAL_SECONDS);
+}
+
+/*
+ * Per-table memory accounting for the admin view's System health tab and
+ * the periodic metrics file in the data directory.
+ */
+static void start_metrics(void) {
+    const MetricsTable tables[] = {
+        {"users", &app_state.users->count, &app_state.users->capacity, sizeof(User), NULL},
+        {"students", &app_state.students->count, &app_state.students->capacity, sizeof(Student),
+         &app_state.students->strings},
+        {"professors", &app_state.professors->count, &app_state.professors->capacity, sizeof(Professor), NULL},
+        {"grades", &app_state.grades->count, &app_state.grades->capacity, sizeof(Note), NULL},
+        {"attendance", &app_state.attendance->count, &app_state.attendance->capacity,
+         sizeof(AttendanceRecord), NULL},
+        {"clubs", &app_state.clubs->count, &app_state.clubs->capacity, sizeof(Club), NULL},
+        {"memberships", &app_state.memberships->count, &app_state.memberships->capacity,
+         sizeof(ClubMembership), NULL},
+        {"modules", &app_state.modules->count, &app_state.modules->capacity, sizeof(Module), NULL},
+        {"exams", &app_state.exams->count, &app_state.exams->capacity, sizeof(Examen), NULL},
+        {"professor_notes", &app_state.prof_notes->count, &app_state.prof_notes->capacity,
+         sizeof(ProfessorNote), NULL}
+    };
+
+    for (size_t i = 0; i < sizeof(tables) / sizeof(tables[0]); i++) {
+        metrics_register_table(&tables[i]);
+    }
+
+    char data_dir[UTILS_MAX_PATH_LENGTH];
+    char metrics_path[UTILS_MAX_PATH_LENGTH];
+    if (utils_get_data_file_path("", data_dir, sizeof(data_dir)) &&
+        utils_get_data_file_path(METRICS_FILE, metrics_path, sizeof(metrics_path))) {
+        metrics_start(METRICS_INTERVAL_SECONDS, data_dir, metrics_path);
+    }
+}
+
+/*
+ * Read API for the portal, serving the live tables (see http_server.h).
+ * Exams have no lock, so grades are joined with a snapshot of them taken
+ * here; exams added later show without a module until the next start.
+ */
+static ExportExamIndex* http_exams = NULL;
+
+static void start_http_server(void) {
+    if (!HTTP_SERVER_IN_GUI) return;
+
+    http_exams = export_exam_index_build(app_state.exams, app_state.modules);
+    HttpTables tables = {
+        app_state.students, app_state.grades, app_state.attendance,
+        app_state.clubs, app_state.memberships, http_exams
+    };
+    if (!http_server_start(HTTP_SERVER_ADDRESS, HTTP_SERVER_PORT, HTTP_SERVER_WORKERS, &tables)) {
+        export_exam_index_destroy(http_exams);
+        http_exams = NULL;
+    }
+}
+
+static void stop_http_server(void) {
+    http_server_stop();
+    if (http_exams) {
+        export_exam_index_destroy(http_exams);
+        http_exams = NULL;
+    }
+}
+
+/*
+ * Shared-memory read replica for reporting scripts (see replica.h),
+ * republished whenever an autosave round commits something.
+ */
+static void publish_replica(void* user_data) {
+    (void)user_data;
+    replica_publish();
+}
+
+static void start_replica(void) {
+    if (!REPLICA_ENABLED) return;
+
+    ReplicaTables tables = {
+        app_state.students, app_state.grades, app_state.attendance,
+        app_state.clubs, app_state.memberships
+    };
+    if (replica_start(REPLICA_SHM_NAME, &tables)) {
+        autosave_set_commit_hook(publish_replica, NULL);
+    }
+}
+
+/*
+ * Change-log replication (see replication.h). A normal instance is the
+ * primary; one started with --follow mirrors it read-only and keeps its
+ * open views and the search and completion indices in step with the
+ * changes it applies.
+ */
+static char follow_socket[UTILS_MAX_PATH_LENGTH] = "";
+
+// Table views open on a follower, each tagged with the table it shows
+static GPtrArray* replicated_views = NULL;
+
+static void on_replicated_view_destroy(GtkWidget* view, gpointer data) {
+    (void)data;
+    g_ptr_array_remove(replicated_views, view);
+}
+
+static void track_replicated_view(GtkWindow* window, const char* key, ChangeTable table) {
+    if (!follow_socket[0] || !window) return;
+    GtkWidget* view = g_object_get_data(G_OBJECT(window), key);
+    if (!view) return;
+    
+    if (!replicated_views) replicated_views = g_ptr_array_new();
+    g_object_set_data(G_OBJECT(view), "change-table", GINT_TO_POINTER(table));
+    g_ptr_array_add(replicated_views, view);
+    g_signal_connect(view, "destroy", G_CALLBACK(on_replicated_view_destroy), NULL);
+}
+
+// Grades are keyed by slot, and a delete only carries the old record, so
+// every tombstoned slot with its key is dropped (removed rows are no-ops)
+static void remove_replicated_grade(GtkTreeView* view, const Grade* old) {
+    GradeList* grades = app_state.grades;
+    if (!grades) return;
+    for (int i = 0; i < grades->count; i++) {
+        const Grade* grade = &grades->note[i];
+        if (grade->is_deleted && grade->id_etudiant == old->id_etudiant && grade->id_examen == old->id_examen) {
+            ui_grade_treeview_remove_grade(view, i);
+        }
+    }
+}
+
+// Mirror one applied change into the open views of its table
+static void update_replicated_views(ChangeTable table, ChangeOp op, const void* record) {
+    if (!replicated_views) return;
+    for (guint i = 0; i < replicated_views->len; i++) {
+        GtkTreeView* view = GTK_TREE_VIEW(g_ptr_array_index(replicated_views, i));
+        if (GPOINTER_TO_INT(g_object_get_data(G_OBJECT(view), "change-table")) != (int)table) continue;
+        
+        if (table == CHANGE_STUDENTS) {
+            Student* student = (Student*)record;
+            if (op == CHANGE_INSERT) ui_student_treeview_add_student(view, student);
+            else if (op == CHANGE_UPDATE) ui_student_treeview_update_student(view, student);
+            else ui_student_treeview_remove_student(view, student->id);
+        } else if (table == CHANGE_GRADES) {
+            Grade* grade = (Grade*)record;
+            if (op == CHANGE_INSERT) ui_grade_treeview_add_grade(view, grade);
+            else if (op == CHANGE_UPDATE) ui_grade_treeview_update_grade(view, grade);
+            else remove_replicated_grade(view, grade);
+        } else if (table == CHANGE_ATTENDANCE) {
+            AttendanceRecord* entry = (AttendanceRecord*)record;
+            if (op == CHANGE_INSERT) ui_attendance_treeview_add_record(view, entry);
+            else if (op == CHANGE_UPDATE) ui_attendance_treeview_update_record(view, entry);
+            else ui_attendance_treeview_remove_record(view, entry->id);
+        } else if (table == CHANGE_CLUBS) {
+            Club* club = (Club*)record;
+            if (op == CHANGE_INSERT) ui_club_treeview_add_club(view, club);
+            else if (op == CHANGE_UPDATE) ui_club_treeview_update_club(view, club);
+            else ui_club_treeview_remove_club(view, club->id);
+        }
+    }
+}
+
+static void apply_replicated_change(ChangeTable table, ChangeOp op, const void* record, void* user_data) {
+    (void)user_data;
+    update_replicated_views(table, op, record);
+    if (table == CHANGE_STUDENTS) {
+        const Student* student = record;
+        if (op == CHANGE_INSERT) {
+            search_index_add_student(app_state.student_search, student);
+        } else if (op == CHANGE_UPDATE) {
+            search_index_update_student(app_state.student_search, student);
+            completion_index_remove(app_state.completer, COMPLETE_STUDENT, student->id);
+        } else {
+            search_index_remove_student(app_state.student_search, student->id);
+            completion_index_remove(app_state.completer, COMPLETE_STUDENT, student->id);
+        }
+        if (op != CHANGE_DELETE) completion_index_add_student(app_state.completer, student);
+    } else if (table == CHANGE_MEMBERSHIPS) {
+        const ClubMembership* membership = record;
+        club_roster_index_set_member(app_state.club_rosters, membership->club_id, membership->student_id,
+                                     op != CHANGE_DELETE && membership->is_active);
+    } else if (table == CHANGE_USERS) {
+        const User* user = record;
+        if (op != CHANGE_INSERT) completion_index_remove(app_state.completer, COMPLETE_USER, user->id);
+        if (op != CHANGE_DELETE) completion_index_add_user(app_state.completer, user);
+    }
+}
+
+static void start_replication(void) {
+    ReplicationTables tables = {
+        app_state.users, app_state.students, app_state.grades, app_state.attendance,
+        app_state.clubs, app_state.memberships, app_state.prof_notes
+    };
+    if (follow_socket[0]) {
+        replication_follower_start(follow_socket, &tables, apply_replicated_change, NULL);
+        return;
+    }
+    if (!REPLICATION_ENABLED) return;
+
+    char socket_path[UTILS_MAX_PATH_LENGTH];
+    if (utils_get_data_file_path(REPLICATION_SOCKET_FILE, socket_path, sizeof(socket_path))) {
+        replication_primary_start(socket_path, &tables);
+    }
+}
+
+static void stop_replication(void) {
+    replication_follower_stop();
+    replication_primary_stop();
+}
+
+/*
+ * Give every table shared with UIState a lock, so worker threads can read
+ * it while the UI edits it (rules in table_lock.h). Each list frees its
+ * own lock when destroyed.
+ */
+static void attach_table_locks(void) {
+    app_state.users->lock = table_lock_create("users");
+    app_state.students->lock = table_lock_create("students");
+    app_state.professors->lock = table_lock_create("professors");
+    app_state.grades->lock = table_lock_create("grades");
+    app_state.attendance->lock = table_lock_create("attendance");
+    app_state.clubs->lock = table_lock_create("clubs");
+    app_state.memberships->lock = table_lock_create("memberships");
+    app_state.modules->lock = table_lock_create("modules");
+    app_state.prof_notes->lock = table_lock_create("professor notes");
+}
+
 /*
  * Initialize application data structures
  */
 static int initialize_app_data(void) {
     printf("[INFO] Initializing application data...\n");
     
+    arena_scratch_set_reset_hook(schedule_scratch_reset);
+    tombstones_set_compaction_hook(schedule_compaction);
+    
     // Initialize file manager
     if (file_manager_init() != FILE_SUCCESS) {
         fprintf(stderr, "[ERROR] Failed to initialize file manager\n");
@@ -101,6 +469,20 @@ static int initialize_app_data(void) {
         return -1;
     }
     
+    // Initialize student search index
+    app_state.student_search = search_index_create();
+    if (!app_state.student_search) {
+        fprintf(stderr, "[ERROR] Failed to create student search index\n");
+        return -1;
+    }
+    
+    // Initialize name/email/username autocomplete
+    app_state.completer = completion_index_create();
+    if (!app_state.completer) {
+        fprintf(stderr, "[ERROR] Failed to create completion index\n");
+        return -1;
+    }
+    
     // Initialize professor list
     app_state.professors = professor_list_create();
     if (!app_state.professors) {
@@ -156,12 +538,14 @@ static int initialize_app_data(void) {
         fprintf(stderr, "[ERROR] Failed to create professor notes list\n");
         return -1;
     }
+    attach_table_locks();
     
     // Load data from files
     if (load_all_data() != 0) {
         fprintf(stderr, "[WARNING] Failed to load some data files\n");
         // Continue anyway - files might not exist yet
     }
+    arena_report("after loading data");
     
     // Create default admin user if no users exist
     if (app_state.users->count == 0) {
@@ -170,10 +554,17 @@ static int initialize_app_data(void) {
             fprintf(stderr, "[WARNING] Failed to create default admin user\n");
         } else {
             printf("[OK] Default admin user created (username: admin, password: Admin123!)\n");
-            save_all_data();
         }
     }
     
+    // From here on changed tables are written in the background; a
+    // follower writes nothing, its primary owns the files
+    if (!follow_socket[0]) start_autosave();
+    start_metrics();
+    start_http_server();
+    if (!follow_socket[0]) start_replica();
+    start_replication();
+    
     // Initialize theme
     app_state.current_theme = THEME_LIGHT;
     
@@ -185,24 +576,33 @@ static int initialize_app_data(void) {
  * Load all data from files
  */
 static int load_all_data(void) {
+    TRACE_SCOPE("load_all_data");
     char filepath[512];
     int errors = 0;
     
     // Load users
+    TRACE_BEGIN("load users");
     snprintf(filepath, sizeof(filepath), "%s", USERS_FILE);
     if (auth_load_users(app_state.users, filepath) != 1) {
         fprintf(stderr, "[WARNING] Failed to load users from %s\n", filepath);
         errors++;
     }
+    TRACE_END();
     
     // Load students
+    TRACE_BEGIN("load students");
     snprintf(filepath, sizeof(filepath), "%s", STUDENTS_FILE);
     if (student_list_load_from_file(app_state.students, filepath) != 1) {
         fprintf(stderr, "[WARNING] Failed to load students from %s\n", filepath);
         errors++;
     }
+    TRACE_END();
+    TRACE_BEGIN("build search index");
+    search_index_build(app_state.student_search, app_state.students);
+    TRACE_END();
     
     // Load professors
+    TRACE_BEGIN("load professors");
     snprintf(filepath, sizeof(filepath), "professors.txt");
     if (professor_list_load_from_file(app_state.professors, filepath) != 1) {
         fprintf(stderr, "[WARNING] Failed to load professors from %s\n", filepath);
@@ -210,36 +610,52 @@ static int load_all_data(void) {
     } else {
         printf("[INFO] Loaded %d professors\n", app_state.professors->count);
     }
+    TRACE_END();
+    TRACE_BEGIN("build completion index");
+    completion_index_build(app_state.completer, app_state.students, app_state.professors, app_state.users);
+    TRACE_END();
     
     // Load grades
+    TRACE_BEGIN("load grades");
     snprintf(filepath, sizeof(filepath), "%s", GRADES_FILE);
     if (grade_list_load_from_file(app_state.grades, filepath) != 1) {
         fprintf(stderr, "[WARNING] Failed to load grades from %s\n", filepath);
         errors++;
     }
+    TRACE_END();
     
     // Load attendance
+    TRACE_BEGIN("load attendance");
     snprintf(filepath, sizeof(filepath), "%s", ATTENDANCE_FILE);
     if (attendance_list_load_from_file(app_state.attendance, filepath) != 1) {
         fprintf(stderr, "[WARNING] Failed to load attendance from %s\n", filepath);
         errors++;
     }
+    TRACE_END();
     
     // Load clubs
+    TRACE_BEGIN("load clubs");
     snprintf(filepath, sizeof(filepath), "%s", CLUBS_FILE);
     if (club_list_load_from_file(app_state.clubs, filepath) != 1) {
         fprintf(stderr, "[WARNING] Failed to load clubs from %s\n", filepath);
         errors++;
     }
+    TRACE_END();
     
     // Load memberships
+    TRACE_BEGIN("load memberships");
     snprintf(filepath, sizeof(filepath), "%s", MEMBERSHIPS_FILE);
     if (membership_list_load_from_file(app_state.memberships, filepath) != 1) {
         fprintf(stderr, "[WARNING] Failed to load memberships from %s\n", filepath);
         errors++;
     }
+    TRACE_END();
+    TRACE_BEGIN("build club rosters");
+    app_state.club_rosters = club_roster_index_build(app_state.clubs, app_state.memberships);
+    TRACE_END();
     
     // Load modules
+    TRACE_BEGIN("load modules");
     if (app_state.modules) {
         strcpy(app_state.modules->filename, "modules.txt");
         if (remplire_liste_appartit_file(app_state.modules) != 1) {
@@ -266,7 +682,8 @@ static int load_all_data(void) {
                     m.heures_tp = atoi(sample_modules[i][5]);
                     m.niveau = atoi(sample_modules[i][6]);
                     m.semestre = atoi(sample_modules[i][7]);
-                    strncpy(m.nom_prenom_enseignent, sample_modules[i][8], 49);
+                    m.nom_prenom_enseignent = intern_string(sample_modules[i][8]);
+                    m.is_deleted = 0;
                     app_state.modules->cours[app_state.modules->count++] = m;
                 }
             }
@@ -275,8 +692,10 @@ static int load_all_data(void) {
             printf("[INFO] Loaded %d modules\n", app_state.modules->count);
         }
     }
+    TRACE_END();
     
     // Load exams
+    TRACE_BEGIN("load exams");
     if (app_state.exams) {
         strcpy(app_state.exams->filename, "examens.txt");
         if (liste_examen_a_partir_file(app_state.exams) != 1) {
@@ -310,8 +729,10 @@ static int load_all_data(void) {
             printf("[INFO] Loaded %d exams\n", app_state.exams->count);
         }
     }
+    TRACE_END();
 
     // Load professor notes
+    TRACE_BEGIN("load professor notes");
     snprintf(filepath, sizeof(filepath), "%s", PROF_NOTES_FILE);
     // If loading fails (e.g. file doesn't exist), just continue log it
     // Use full path if PROF_NOTES_FILE is just filename, but config.h defines it as just filename.
@@ -332,6 +753,7 @@ static int load_all_data(void) {
     } else {
         printf("[INFO] No professor notes file found, starting fresh.\n");
     }
+    TRACE_END();
     
     return errors > 0 ? -1 : 0;
 }
@@ -340,17 +762,21 @@ static int load_all_data(void) {
  * Save all data to files
  */
 static int save_all_data(void) {
+    TRACE_SCOPE("save_all_data");
     char filepath[512];
     int errors = 0;
     
     // Save users
+    TRACE_BEGIN("save users");
     snprintf(filepath, sizeof(filepath), "%s", USERS_FILE);
     if (auth_save_users(app_state.users, filepath) != 1) {
         fprintf(stderr, "[ERROR] Failed to save users\n");
         errors++;
     }
+    TRACE_END();
     
     // Save students
+    TRACE_BEGIN("save students");
     snprintf(filepath, sizeof(filepath), "%s", STUDENTS_FILE);
     if (app_state.students && app_state.students->count > 0) {
         printf("[DEBUG] At shutdown: First student is %s %s\n", 
@@ -361,42 +787,53 @@ static int save_all_data(void) {
         fprintf(stderr, "[ERROR] Failed to save students\n");
         errors++;
     }
+    TRACE_END();
     
     // Save grades
+    TRACE_BEGIN("save grades");
     snprintf(filepath, sizeof(filepath), "%s", GRADES_FILE);
     if (grade_list_save_to_file(app_state.grades, filepath) != 1) {
         fprintf(stderr, "[ERROR] Failed to save grades\n");
         errors++;
     }
+    TRACE_END();
     
     // Save attendance
+    TRACE_BEGIN("save attendance");
     snprintf(filepath, sizeof(filepath), "%s", ATTENDANCE_FILE);
     if (attendance_list_save_to_file(app_state.attendance, filepath) != 1) {
         fprintf(stderr, "[ERROR] Failed to save attendance\n");
         errors++;
     }
+    TRACE_END();
     
     // Save clubs
+    TRACE_BEGIN("save clubs");
     snprintf(filepath, sizeof(filepath), "%s", CLUBS_FILE);
     if (club_list_save_to_file(app_state.clubs, filepath) != 1) {
         fprintf(stderr, "[ERROR] Failed to save clubs\n");
         errors++;
     }
+    TRACE_END();
     
     // Save memberships
+    TRACE_BEGIN("save memberships");
     snprintf(filepath, sizeof(filepath), "%s", MEMBERSHIPS_FILE);
     if (membership_list_save_to_file(app_state.memberships, filepath) != 1) {
         fprintf(stderr, "[ERROR] Failed to save memberships\n");
         errors++;
     }
+    TRACE_END();
 
     // Save professor notes
+    TRACE_BEGIN("save professor notes");
     snprintf(filepath, sizeof(filepath), "%s%s", app_state.data_dir, PROF_NOTES_FILE);
     // Assuming prof_note_save handles nulls/errors gracefully or returns 0 on failure
     if (prof_note_save(app_state.prof_notes, filepath) != 1) {
         fprintf(stderr, "[ERROR] Failed to save professor notes\n");
         errors++;
     }
+    TRACE_END();
     
     return errors > 0 ? -1 : 0;
 }
@@ -407,8 +844,17 @@ static int save_all_data(void) {
 static void cleanup_app(void) {
     printf("[INFO] Cleaning up application...\n");
     
-    // Save data before cleanup
-    save_all_data();
+    // Stop background jobs and the read API before the tables they read go away
+    jobs_shutdown();
+    stop_http_server();
+    stop_replication();
+    asset_cache_clear();
+    
+    // Let queued background writes finish, then save everything once more
+    autosave_stop();
+    if (!follow_socket[0]) save_all_data();
+    metrics_stop();
+    replica_stop();
     
     // Destroy session
     if (app_state.session) {
@@ -416,17 +862,35 @@ static void cleanup_app(void) {
         app_state.session = NULL;
     }
     
+    arena_report("at shutdown");
+    
     // Destroy data structures
     if (app_state.users) {
         user_list_destroy(app_state.users);
         app_state.users = NULL;
     }
     
+    // The search index watches the student list, so it goes first
+    if (app_state.student_search) {
+        search_index_destroy(app_state.student_search);
+        app_state.student_search = NULL;
+    }
+    
     if (app_state.students) {
         student_list_destroy(app_state.students);
         app_state.students = NULL;
     }
     
+    if (app_state.completer) {
+        completion_index_destroy(app_state.completer);
+        app_state.completer = NULL;
+    }
+    
+    if (app_state.club_rosters) {
+        club_roster_index_destroy(app_state.club_rosters);
+        app_state.club_rosters = NULL;
+    }
+    
     if (app_state.professors) {
         professor_list_destroy(app_state.professors);
         app_state.professors = NULL;
@@ -469,6 +933,10 @@ static void cleanup_app(void) {
     
     file_manager_cleanup();
     
+    // Interned strings outlive every table that refers to them
+    intern_clear();
+    arena_scratch_destroy();
+    
     printf("[OK] Cleanup complete\n");
 }
 
@@ -519,6 +987,7 @@ static void on_login_clicked(GtkWidget *widget, gpointer data) {
     }
     
     // Attempt login
+    TRACE_SCOPE("login");
     if (auth_login(app_state.users, username, password, app_state.session)) {
         // Check if role matches selection
         if (app_state.session->role != app_state.selected_role) {
@@ -651,8 +1120,7 @@ static void on_create_account_clicked(GtkWidget *widget, gpointer data) {
         int result = auth_register_student(app_state.users, username, email, password);
         
         if (result == 1) {
-            // Success
-            save_all_data();
+            // Success; the autosave thread writes the new user
             gtk_label_set_markup(GTK_LABEL(message_label), 
                 "<span color='green'>Account created successfully! Please login.</span>");
         } else if (result == -1) {
@@ -791,7 +1259,6 @@ static void on_forgot_password_clicked(GtkWidget *widget, gpointer data) {
                     email, code, new_password);
                 
                 if (reset_result == 1) {
-                    save_all_data();
                     gtk_label_set_markup(GTK_LABEL(message_label), 
                         "<span color='green'>Password reset successfully! Please login.</span>");
                 } else if (reset_result == -2) {
@@ -863,14 +1330,9 @@ static void show_login_window(void) {
                                    GTK_STYLE_PROVIDER_PRIORITY_APPLICATION);
     g_object_unref(image_panel_provider);
     
-    GtkWidget *background_image = gtk_image_new_from_file("src/back.jpg");
-    if (gtk_image_get_pixbuf(GTK_IMAGE(background_image))) {
-        GdkPixbuf *pixbuf = gtk_image_get_pixbuf(GTK_IMAGE(background_image));
-        // Scale smaller to show blue borders
-        GdkPixbuf *scaled_pixbuf = gdk_pixbuf_scale_simple(pixbuf, 640, 740, GDK_INTERP_BILINEAR);
-        gtk_image_set_from_pixbuf(GTK_IMAGE(background_image), scaled_pixbuf);
-        g_object_unref(scaled_pixbuf);
-    }
+    // Scaled smaller to show blue borders
+    GtkWidget *background_image = asset_image_new(LOGIN_BACKGROUND_FILE, 640, 740);
+    if (!background_image) background_image = gtk_image_new();
     
     // Add rounded corners to image
     const char *image_css = 
@@ -932,13 +1394,8 @@ static void show_login_window(void) {
     gtk_box_pack_start(GTK_BOX(center_align), main_box, FALSE, FALSE, 0);
     
     // Logo - 15px margin bottom
-    GtkWidget *logo = gtk_image_new_from_file("src/t1.png");
-    if (gtk_image_get_pixbuf(GTK_IMAGE(logo))) {
-        GdkPixbuf *pixbuf = gtk_image_get_pixbuf(GTK_IMAGE(logo));
-        GdkPixbuf *scaled_pixbuf = gdk_pixbuf_scale_simple(pixbuf, 90, 90, GDK_INTERP_BILINEAR);
-        gtk_image_set_from_pixbuf(GTK_IMAGE(logo), scaled_pixbuf);
-        g_object_unref(scaled_pixbuf);
-    }
+    GtkWidget *logo = asset_image_new(UI_LOGO_FILE, 90, 90);
+    if (!logo) logo = gtk_image_new();
     gtk_widget_set_halign(logo, GTK_ALIGN_CENTER);
     gtk_widget_set_margin_bottom(logo, 15);
     gtk_box_pack_start(GTK_BOX(main_box), logo, FALSE, FALSE, 0);
@@ -1064,12 +1521,14 @@ static void show_login_window(void) {
     gtk_widget_set_size_request(create_account_btn, -1, 38);
     g_signal_connect(create_account_btn, "clicked", G_CALLBACK(on_create_account_clicked), message_label);
     gtk_box_pack_start(GTK_BOX(button_box), create_account_btn, TRUE, TRUE, 0);
+    ui_disable_if_read_only(create_account_btn, follow_socket[0] != 0);
     
     // Forgot Password button - Equal width 38px height
     GtkWidget *forgot_password_btn = gtk_button_new_with_label("Forgot Password?");
     gtk_widget_set_size_request(forgot_password_btn, -1, 38);
     g_signal_connect(forgot_password_btn, "clicked", G_CALLBACK(on_forgot_password_clicked), message_label);
     gtk_box_pack_start(GTK_BOX(button_box), forgot_password_btn, TRUE, TRUE, 0);
+    ui_disable_if_read_only(forgot_password_btn, follow_socket[0] != 0);
     
     // Info label - 15px top margin, subtle styling
     GtkWidget *info_label = gtk_label_new(NULL);
@@ -1124,12 +1583,8 @@ static void show_main_window(void) {
     gtk_box_pack_start(GTK_BOX(main_box), header_bar, FALSE, FALSE, 0);
     
     // Logo in header
-    GtkWidget *logo = gtk_image_new_from_file("src/t1.png");
-    if (gtk_image_get_pixbuf(GTK_IMAGE(logo))) {
-        GdkPixbuf *pixbuf = gtk_image_get_pixbuf(GTK_IMAGE(logo));
-        GdkPixbuf *scaled_pixbuf = gdk_pixbuf_scale_simple(pixbuf, 40, 40, GDK_INTERP_BILINEAR);
-        gtk_image_set_from_pixbuf(GTK_IMAGE(logo), scaled_pixbuf);
-        g_object_unref(scaled_pixbuf);
+    GtkWidget *logo = asset_image_new(UI_LOGO_FILE, 40, 40);
+    if (logo) {
         gtk_box_pack_start(GTK_BOX(header_bar), logo, FALSE, FALSE, 5);
     }
     
@@ -1276,7 +1731,8 @@ static void show_main_window(void) {
         gtk_box_pack_start(GTK_BOX(users_box), users_icon, FALSE, FALSE, 2);
         
         char users_text[128];
-        snprintf(users_text, sizeof(users_text), "<span size=\"28000\" weight=\"900\" foreground=\"#2196F3\">%d</span>", app_state.users->count);
+        snprintf(users_text, sizeof(users_text), "<span size=\"28000\" weight=\"900\" foreground=\"#2196F3\">%d</span>",
+                 app_state.users->count - app_state.users->tombstones.dead);
         GtkWidget *users_count = gtk_label_new(NULL);
         gtk_label_set_markup(GTK_LABEL(users_count), users_text);
         gtk_box_pack_start(GTK_BOX(users_box), users_count, FALSE, FALSE, 4);
@@ -1299,7 +1755,7 @@ static void show_main_window(void) {
         gtk_box_pack_start(GTK_BOX(students_box), students_icon, FALSE, FALSE, 2);
         
         char students_text[128];
-        snprintf(students_text, sizeof(students_text), "<span size=\"28000\" weight=\"900\" foreground=\"#1976D2\">%d</span>", app_state.students->count);
+        snprintf(students_text, sizeof(students_text), "<span size=\"28000\" weight=\"900\" foreground=\"#1976D2\">%d</span>", student_list_get_count(app_state.students));
         GtkWidget *students_count = gtk_label_new(NULL);
         gtk_label_set_markup(GTK_LABEL(students_count), students_text);
         gtk_box_pack_start(GTK_BOX(students_box), students_count, FALSE, FALSE, 4);
@@ -1322,7 +1778,8 @@ static void show_main_window(void) {
         gtk_box_pack_start(GTK_BOX(grades_box), grades_icon, FALSE, FALSE, 2);
         
         char grades_text[128];
-        snprintf(grades_text, sizeof(grades_text), "<span size=\"28000\" weight=\"900\" foreground=\"#1E88E5\">%d</span>", app_state.grades->count);
+        snprintf(grades_text, sizeof(grades_text), "<span size=\"28000\" weight=\"900\" foreground=\"#1E88E5\">%d</span>",
+                 app_state.grades->count - app_state.grades->tombstones.dead);
         GtkWidget *grades_count = gtk_label_new(NULL);
         gtk_label_set_markup(GTK_LABEL(grades_count), grades_text);
         gtk_box_pack_start(GTK_BOX(grades_box), grades_count, FALSE, FALSE, 4);
@@ -1367,7 +1824,7 @@ static void show_main_window(void) {
         gtk_box_pack_start(GTK_BOX(students_box), students_icon, FALSE, FALSE, 0);
         
         char students_text[64];
-        snprintf(students_text, sizeof(students_text), "<span size='24000' weight='bold'>%d</span>", app_state.students->count);
+        snprintf(students_text, sizeof(students_text), "<span size='24000' weight='bold'>%d</span>", student_list_get_count(app_state.students));
         GtkWidget *students_count = gtk_label_new(NULL);
         gtk_label_set_markup(GTK_LABEL(students_count), students_text);
         gtk_box_pack_start(GTK_BOX(students_box), students_count, FALSE, FALSE, 0);
@@ -1387,7 +1844,8 @@ static void show_main_window(void) {
         gtk_box_pack_start(GTK_BOX(grades_box), grades_icon, FALSE, FALSE, 0);
         
         char grades_text[64];
-        snprintf(grades_text, sizeof(grades_text), "<span size='24000' weight='bold'>%d</span>", app_state.grades->count);
+        snprintf(grades_text, sizeof(grades_text), "<span size='24000' weight='bold'>%d</span>",
+                 app_state.grades->count - app_state.grades->tombstones.dead);
         GtkWidget *grades_count = gtk_label_new(NULL);
         gtk_label_set_markup(GTK_LABEL(grades_count), grades_text);
         gtk_box_pack_start(GTK_BOX(grades_box), grades_count, FALSE, FALSE, 0);
@@ -1407,7 +1865,8 @@ static void show_main_window(void) {
         gtk_box_pack_start(GTK_BOX(attendance_box), attendance_icon, FALSE, FALSE, 0);
         
         char attendance_text[64];
-        snprintf(attendance_text, sizeof(attendance_text), "<span size='24000' weight='bold'>%d</span>", app_state.attendance->count);
+        snprintf(attendance_text, sizeof(attendance_text), "<span size='24000' weight='bold'>%d</span>",
+                 app_state.attendance->count - app_state.attendance->tombstones.dead);
         GtkWidget *attendance_count = gtk_label_new(NULL);
         gtk_label_set_markup(GTK_LABEL(attendance_count), attendance_text);
         gtk_box_pack_start(GTK_BOX(attendance_box), attendance_count, FALSE, FALSE, 0);
@@ -1843,6 +2302,7 @@ static void show_main_window(void) {
  * Management window callbacks
  */
 static void on_manage_students_clicked(GtkWidget *widget, gpointer data) {
+    TRACE_SCOPE("open students window");
     printf("[INFO] Opening Student Management window...\n");
     
     // Create UI state from app state
@@ -1853,10 +2313,14 @@ static void on_manage_students_clicked(GtkWidget *widget, gpointer data) {
     ui_state->current_session = app_state.session;
     ui_state->users = app_state.users;
     ui_state->students = app_state.students;
+    ui_state->student_search = app_state.student_search;
+    ui_state->completer = app_state.completer;
     ui_state->grades = app_state.grades;
     ui_state->attendance = app_state.attendance;
     ui_state->clubs = app_state.clubs;
     ui_state->memberships = app_state.memberships;
+    ui_state->club_rosters = app_state.club_rosters;
+    ui_state->read_only = follow_socket[0] != 0;
     
     // Create and show student management window
     GtkWindow *student_window = ui_create_student_window(ui_state);
@@ -1869,6 +2333,7 @@ static void on_manage_students_clicked(GtkWidget *widget, gpointer data) {
             ui_student_treeview_populate(treeview, app_state.students);
         }
         
+        track_replicated_view(student_window, "treeview", CHANGE_STUDENTS);
         gtk_window_set_transient_for(student_window, GTK_WINDOW(app_state.main_window));
         g_signal_connect(student_window, "destroy", G_CALLBACK(gtk_widget_destroyed), &ui_state);
         gtk_widget_show_all(GTK_WIDGET(student_window));
@@ -1876,6 +2341,7 @@ static void on_manage_students_clicked(GtkWidget *widget, gpointer data) {
 }
 
 static void on_manage_grades_clicked(GtkWidget *widget, gpointer data) {
+    TRACE_SCOPE("open grades window");
     printf("[INFO] Opening Grade Management window...\n");
     
     UIState *ui_state = (UIState*)malloc(sizeof(UIState));
@@ -1885,14 +2351,19 @@ static void on_manage_grades_clicked(GtkWidget *widget, gpointer data) {
     ui_state->current_session = app_state.session;
     ui_state->users = app_state.users;
     ui_state->students = app_state.students;
+    ui_state->student_search = app_state.student_search;
+    ui_state->completer = app_state.completer;
     ui_state->grades = app_state.grades;
     ui_state->attendance = app_state.attendance;
     ui_state->clubs = app_state.clubs;
     ui_state->memberships = app_state.memberships;
+    ui_state->club_rosters = app_state.club_rosters;
+    ui_state->read_only = follow_socket[0] != 0;
     
     GtkWindow *grade_window = ui_create_grade_window(ui_state);
     if (grade_window) {
         ui_state->current_window = grade_window;
+        track_replicated_view(grade_window, "grades_treeview", CHANGE_GRADES);
         gtk_window_set_transient_for(grade_window, GTK_WINDOW(app_state.main_window));
         g_signal_connect(grade_window, "destroy", G_CALLBACK(gtk_widget_destroyed), &ui_state);
         gtk_widget_show_all(GTK_WIDGET(grade_window));
@@ -1900,6 +2371,7 @@ static void on_manage_grades_clicked(GtkWidget *widget, gpointer data) {
 }
 
 static void on_manage_attendance_clicked(GtkWidget *widget, gpointer data) {
+    TRACE_SCOPE("open attendance window");
     printf("[INFO] Opening Attendance Management window...\n");
     
     UIState *ui_state = (UIState*)malloc(sizeof(UIState));
@@ -1909,14 +2381,19 @@ static void on_manage_attendance_clicked(GtkWidget *widget, gpointer data) {
     ui_state->current_session = app_state.session;
     ui_state->users = app_state.users;
     ui_state->students = app_state.students;
+    ui_state->student_search = app_state.student_search;
+    ui_state->completer = app_state.completer;
     ui_state->grades = app_state.grades;
     ui_state->attendance = app_state.attendance;
     ui_state->clubs = app_state.clubs;
     ui_state->memberships = app_state.memberships;
+    ui_state->club_rosters = app_state.club_rosters;
+    ui_state->read_only = follow_socket[0] != 0;
     
     GtkWindow *attendance_window = ui_create_attendance_window(ui_state);
     if (attendance_window) {
         ui_state->current_window = attendance_window;
+        track_replicated_view(attendance_window, "attendance_treeview", CHANGE_ATTENDANCE);
         gtk_window_set_transient_for(attendance_window, GTK_WINDOW(app_state.main_window));
         g_signal_connect(attendance_window, "destroy", G_CALLBACK(gtk_widget_destroyed), &ui_state);
         gtk_widget_show_all(GTK_WIDGET(attendance_window));
@@ -1924,6 +2401,7 @@ static void on_manage_attendance_clicked(GtkWidget *widget, gpointer data) {
 }
 
 static void on_manage_clubs_clicked(GtkWidget *widget, gpointer data) {
+    TRACE_SCOPE("open clubs window");
     printf("[INFO] Opening Club Management window...\n");
     
     UIState *ui_state = (UIState*)malloc(sizeof(UIState));
@@ -1933,10 +2411,14 @@ static void on_manage_clubs_clicked(GtkWidget *widget, gpointer data) {
     ui_state->current_session = app_state.session;
     ui_state->users = app_state.users;
     ui_state->students = app_state.students;
+    ui_state->student_search = app_state.student_search;
+    ui_state->completer = app_state.completer;
     ui_state->grades = app_state.grades;
     ui_state->attendance = app_state.attendance;
     ui_state->clubs = app_state.clubs;
     ui_state->memberships = app_state.memberships;
+    ui_state->club_rosters = app_state.club_rosters;
+    ui_state->read_only = follow_socket[0] != 0;
     
     // Set current_user from session - CRITICAL for role-based UI!
     if (app_state.session && app_state.session->user_id > 0 && app_state.users) {
@@ -1948,6 +2430,7 @@ static void on_manage_clubs_clicked(GtkWidget *widget, gpointer data) {
     GtkWindow *club_window = ui_create_club_window(ui_state);
     if (club_window) {
         ui_state->current_window = club_window;
+        track_replicated_view(club_window, "treeview", CHANGE_CLUBS);
         gtk_window_set_transient_for(club_window, GTK_WINDOW(app_state.main_window));
         g_signal_connect(club_window, "destroy", G_CALLBACK(gtk_widget_destroyed), &ui_state);
         gtk_widget_show_all(GTK_WIDGET(club_window));
@@ -1977,10 +2460,18 @@ static void on_admin_view_clicked(GtkWidget *widget, gpointer data) {
     ui_state->current_session = app_state.session;
     ui_state->users = app_state.users;
     ui_state->students = app_state.students;
+    ui_state->student_search = app_state.student_search;
+    ui_state->completer = app_state.completer;
     ui_state->grades = app_state.grades;
     ui_state->attendance = app_state.attendance;
     ui_state->clubs = app_state.clubs;
     ui_state->memberships = app_state.memberships;
+    ui_state->club_rosters = app_state.club_rosters;
+    ui_state->read_only = follow_socket[0] != 0;
+    ui_state->courses = app_state.modules;
+    ui_state->exams = app_state.exams;
+    ui_state->prof_notes = app_state.prof_notes;
+    ui_state->professors = app_state.professors;
     
     // Set current_user from session
     if (app_state.session && app_state.session->user_id > 0 && app_state.users) {
@@ -2077,14 +2568,15 @@ static void on_manage_modules_clicked(GtkWidget *widget, gpointer data) {
             // Count only modules for this professor
             for (int i = 0; i < app_state.modules->count; i++) {
                 Module *m = &app_state.modules->cours[i];
+                if (m->is_deleted) continue;
                 // Match professor name using helper function
-                if (professor_name_matches(m->nom_prenom_enseignent, current_user->username)) {
+                if (professor_name_matches(intern_lookup(m->nom_prenom_enseignent), current_user->username)) {
                     module_count++;
                 }
             }
         } else {
             // Admin sees all modules
-            module_count = app_state.modules->count;
+            module_count = app_state.modules->count - app_state.modules->tombstones.dead;
         }
     }
     
@@ -2099,49 +2591,28 @@ static void on_manage_modules_clicked(GtkWidget *widget, gpointer data) {
     gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(scrolled), GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
     gtk_box_pack_start(GTK_BOX(main_box), scrolled, TRUE, TRUE, 0);
     
-    // Create list store
-    GtkListStore *store = gtk_list_store_new(8, 
-        G_TYPE_INT,    // ID
-        G_TYPE_STRING, // Name
-        G_TYPE_STRING, // Description
-        G_TYPE_INT,    // Hours Course
-        G_TYPE_INT,    // Hours TD
-        G_TYPE_INT,    // Hours TP
-        G_TYPE_INT,    // Semester
-        G_TYPE_STRING  // Professor
-    );
-    
-    // Populate with actual data (filtered by professor for teachers)
-    if (app_state.modules && app_state.modules->count > 0) {
-        for (int i = 0; i < app_state.modules->count; i++) {
-            Module *m = &app_state.modules->cours[i];
-            
-            // Filter by professor for teachers
-            if (current_user && current_user->role == ROLE_TEACHER) {
+    // Virtual model over the module list (teachers only see their own rows)
+    TableModel *model = table_model_new(TABLE_MODEL_MODULES, app_state.modules);
+    if (app_state.modules && current_user && current_user->role == ROLE_TEACHER) {
+        int *rows = malloc((app_state.modules->count > 0 ? app_state.modules->count : 1) * sizeof(int));
+        int row_count = 0;
+        if (rows) {
+            for (int i = 0; i < app_state.modules->count; i++) {
+                Module *m = &app_state.modules->cours[i];
+                if (m->is_deleted) continue;
                 // Only show modules assigned to this professor
-                if (!professor_name_matches(m->nom_prenom_enseignent, current_user->username)) {
-                    continue; // Skip this module
+                if (professor_name_matches(intern_lookup(m->nom_prenom_enseignent), current_user->username)) {
+                    rows[row_count++] = i;
                 }
             }
-            
-            GtkTreeIter iter;
-            gtk_list_store_append(store, &iter);
-            gtk_list_store_set(store, &iter,
-                0, m->id,
-                1, m->nom,
-                2, m->description,
-                3, m->heures_cours,
-                4, m->heures_td,
-                5, m->heures_tp,
-                6, m->semestre,
-                7, m->nom_prenom_enseignent,
-                -1);
         }
+        table_model_set_rows(model, rows, row_count);
+        free(rows);
     }
     
     // Create tree view
-    GtkWidget *tree_view = gtk_tree_view_new_with_model(GTK_TREE_MODEL(store));
-    g_object_unref(store);
+    GtkWidget *tree_view = gtk_tree_view_new_with_model(GTK_TREE_MODEL(model));
+    g_object_unref(model);
     
     // Add columns
     GtkCellRenderer *renderer = gtk_cell_renderer_text_new();
@@ -2167,6 +2638,7 @@ static void on_manage_modules_clicked(GtkWidget *widget, gpointer data) {
         // Pass tree_view as data
         g_signal_connect(assign_btn, "clicked", G_CALLBACK(on_assign_professor_clicked), tree_view);
         gtk_box_pack_start(GTK_BOX(button_box), assign_btn, FALSE, FALSE, 0);
+        ui_disable_if_read_only(assign_btn, follow_socket[0] != 0);
     }
     
     // Close button
@@ -2195,10 +2667,9 @@ static void on_assign_professor_clicked(GtkWidget *widget, gpointer data) {
         return;
     }
     
-    // Get the selected module ID and store the iter path
+    // Get the selected module ID
     int module_id;
     gtk_tree_model_get(model, &iter, 0, &module_id, -1);
-    GtkTreePath *path = gtk_tree_model_get_path(model, &iter);
     
     // Find the module
     Module *module = cours_rechercher_par_id(app_state.modules, module_id);
@@ -2210,7 +2681,6 @@ static void on_assign_professor_clicked(GtkWidget *widget, gpointer data) {
                                                     "Module not found.");
         gtk_dialog_run(GTK_DIALOG(dialog));
         gtk_widget_destroy(dialog);
-        gtk_tree_path_free(path);
         return;
     }
     
@@ -2239,31 +2709,14 @@ static void on_assign_professor_clicked(GtkWidget *widget, gpointer data) {
     GtkWidget *module_label = gtk_label_new(info);
     gtk_box_pack_start(GTK_BOX(vbox), module_label, FALSE, FALSE, 5);
     
-    // Professor selection combo box
-    GtkWidget *combo_label = gtk_label_new("Select Professor:");
-    gtk_box_pack_start(GTK_BOX(vbox), combo_label, FALSE, FALSE, 0);
-    
-    GtkWidget *combo = gtk_combo_box_text_new();
-    
-    // Populate combo box with professors - keep all professors to maintain index mapping
-    printf("[DEBUG] Populating professor combo: count=%d\n", app_state.professors ? app_state.professors->count : -1);
-    if (app_state.professors && app_state.professors->professors && app_state.professors->count > 0) {
-        for (int i = 0; i < app_state.professors->count; i++) {
-            Professor *prof = &app_state.professors->professors[i];
-            if (prof) {
-                char prof_text[256];
-                int len = snprintf(prof_text, sizeof(prof_text), "%s %s - %s", 
-                         prof->first_name, prof->last_name, prof->department);
-                printf("[DEBUG] Adding professor %d: %s (len=%d)\n", i, prof_text, len);
-                gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(combo), prof_text);
-            }
-        }
-    } else {
-        printf("[DEBUG] No professors to populate\n");
-        gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(combo), "No professors available");
-    }
+    // Professor selection, completed from the professor names and e-mails
+    GtkWidget *entry_label = gtk_label_new("Select Professor:");
+    gtk_box_pack_start(GTK_BOX(vbox), entry_label, FALSE, FALSE, 0);
     
-    gtk_box_pack_start(GTK_BOX(vbox), combo, FALSE, FALSE, 5);
+    GtkWidget *professor_entry = gtk_entry_new();
+    gtk_entry_set_placeholder_text(GTK_ENTRY(professor_entry), "Type a name or e-mail...");
+    ui_entry_attach_completion(GTK_ENTRY(professor_entry), app_state.completer, COMPLETE_PROFESSOR);
+    gtk_box_pack_start(GTK_BOX(vbox), professor_entry, FALSE, FALSE, 5);
     
     gtk_widget_show_all(dialog);
     
@@ -2272,35 +2725,37 @@ static void on_assign_professor_clicked(GtkWidget *widget, gpointer data) {
     printf("[DEBUG] Dialog response: %d\n", response);
     
     if (response == GTK_RESPONSE_ACCEPT) {
-        gint selected_index = gtk_combo_box_get_active(GTK_COMBO_BOX(combo));
-        printf("[DEBUG] Selected index: %d, Professor count: %d\n", selected_index, app_state.professors ? app_state.professors->count : 0);
+        // The entry holds the "[ID:n] First Last" text of the picked suggestion
+        const char *professor_text = gtk_entry_get_text(GTK_ENTRY(professor_entry));
+        int professor_id = 0;
+        Professor *selected_prof = NULL;
+        if (sscanf(professor_text, "[ID:%d]", &professor_id) == 1 && app_state.professors) {
+            selected_prof = professor_list_find_by_id(app_state.professors, professor_id);
+        }
+        printf("[DEBUG] Selected professor id: %d\n", professor_id);
         
-        if (selected_index >= 0 && app_state.professors && selected_index < app_state.professors->count) {
+        if (selected_prof) {
             // Find the module again after dialog
             module = cours_rechercher_par_id(app_state.modules, module_id);
             if (module && app_state.modules) {
-                Professor *selected_prof = &app_state.professors->professors[selected_index];
                 printf("[DEBUG] Assigning professor: %s %s to module: %s\n", 
                        selected_prof->first_name, selected_prof->last_name, module->nom);
                 
                 // Update module with professor name (first letter of first name + dot + space + last name)
-                snprintf(module->nom_prenom_enseignent, sizeof(module->nom_prenom_enseignent),
-                         "%c. %s", selected_prof->first_name[0], selected_prof->last_name);
+                char teacher[50];
+                snprintf(teacher, sizeof(teacher), "%c. %s", selected_prof->first_name[0], selected_prof->last_name);
+                InternId teacher_id = intern_string(teacher);
+                table_lock_write(app_state.modules->lock);
+                module->nom_prenom_enseignent = teacher_id;
+                app_state.modules->dirty = 1;
+                table_unlock_write(app_state.modules->lock);
                 
-                printf("[DEBUG] About to save modules...\n");
                 printf("[DEBUG] Modules filename: '%s'\n", app_state.modules ? app_state.modules->filename : "NULL");
                 printf("[DEBUG] Modules count: %d\n", app_state.modules ? app_state.modules->count : 0);
-                // Save modules to file - pass by value, let the function handle the copy
-                if (app_state.modules && app_state.modules->filename[0] != '\0' && 
-                    sauvegarder_modules_ds_file(*app_state.modules) == 1) {
-                    printf("[DEBUG] Modules saved successfully\n");
-                    // Update the tree view using the saved path
-                    GtkTreeIter update_iter;
-                    if (gtk_tree_model_get_iter(model, &update_iter, path)) {
-                        gtk_list_store_set(GTK_LIST_STORE(model), &update_iter,
-                                           7, module->nom_prenom_enseignent,
-                                           -1);
-                    }
+                // The autosave thread writes the modules file
+                if (app_state.modules && app_state.modules->filename[0] != '\0') {
+                    // Update the tree view
+                    table_model_row_changed(TABLE_MODEL(model), (int)(module - app_state.modules->cours));
                     
                     GtkWidget *success_dialog = gtk_message_dialog_new(NULL,
                                                                         GTK_DIALOG_MODAL,
@@ -2336,7 +2791,6 @@ static void on_assign_professor_clicked(GtkWidget *widget, gpointer data) {
     
     printf("[DEBUG] Destroying dialog...\n");
     gtk_widget_destroy(dialog);
-    gtk_tree_path_free(path);
     printf("[DEBUG] Assign professor callback complete\n");
 }
 
@@ -2380,6 +2834,7 @@ static void on_manage_notes_clicked(GtkWidget *widget, gpointer data) {
     if (app_state.grades && app_state.grades->count > 0) {
         for (int i = 0; i < app_state.grades->count; i++) {
             Note *note = &app_state.grades->note[i];
+            if (note->is_deleted) continue;
             GtkTreeIter iter;
             gtk_list_store_append(store, &iter);
             
@@ -2415,7 +2870,8 @@ static void on_manage_notes_clicked(GtkWidget *widget, gpointer data) {
     
     // Stats label
     char stats[256];
-    snprintf(stats, sizeof(stats), "Total notes: %d", app_state.grades ? app_state.grades->count : 0);
+    snprintf(stats, sizeof(stats), "Total notes: %d",
+             app_state.grades ? app_state.grades->count - app_state.grades->tombstones.dead : 0);
     GtkWidget *stats_label = gtk_label_new(stats);
     gtk_box_pack_start(GTK_BOX(main_box), stats_label, FALSE, FALSE, 5);
     
@@ -2518,164 +2974,122 @@ static void on_manage_exams_clicked(GtkWidget *widget, gpointer data) {
 }
 
 /*
- * Callback structures and functions for Professor Notes
+ * Widgets of the exam statistics view
  */
-typedef struct {
-    GtkWidget *student_id_entry;
-    GtkWidget *exam_combo;
-    GtkWidget *grade_entry;
-    GtkWidget *attendance_check;
-    GtkWidget *result_label;
-} CreateNoteWidgets;
-
 typedef struct {
     GtkWidget *combo;
     GtkWidget *label;
 } StatsWidgets;
 
+/*
+ * Grades of one exam, gathered on a worker thread for the statistics and
+ * grade filter views. The grades table is scanned under its read lock; the
+ * student names are looked up afterwards under the students lock, so the
+ * job never holds two locks at once.
+ */
 typedef struct {
     int student_id;
-    GtkWidget *grade_entry;
-    GtkWidget *attendance_check;
-} StudentGradeRow;
+    float grade;
+    int present;
+    char student_name[128];
+} ExamGradeRow;
 
 typedef struct {
-    GtkWidget *exam_combo;
-    GtkWidget *result_label;
-    StudentGradeRow *rows;
+    ExamGradeRow *rows;         // NULL when only the counts were asked for
     int row_count;
-} BatchGradeWidgets;
+    int present, absent, passed;
+    float sum, min, max;
+} ExamGrades;
 
-static void cleanup_batch_grade_widgets(GtkWidget *window, gpointer data) {
-    BatchGradeWidgets *bgw = (BatchGradeWidgets*)data;
-    if (bgw) {
-        if (bgw->rows) {
-            g_free(bgw->rows);
-        }
-        g_free(bgw);
+static void exam_grades_free(void *p) {
+    ExamGrades *grades = (ExamGrades*)p;
+    if (grades) {
+        g_free(grades->rows);
+        g_free(grades);
     }
 }
 
-static void on_create_batch_grades_clicked(GtkWidget *widget, gpointer data) {
-    BatchGradeWidgets *w = (BatchGradeWidgets*)data;
-    
-    int exam_index = gtk_combo_box_get_active(GTK_COMBO_BOX(w->exam_combo));
-    if (exam_index < 0 || !app_state.exams) {
-        gtk_label_set_markup(GTK_LABEL(w->result_label), 
-            "<span foreground='red'>Error: Please select an exam</span>");
-        return;
-    }
-    
-    int exam_id = app_state.exams->exam[exam_index].id_examen;
-    int success_count = 0;
-    int error_count = 0;
-    
-    // Create grades for all students with non-zero values
-    for (int i = 0; i < w->row_count; i++) {
-        float grade = gtk_spin_button_get_value(GTK_SPIN_BUTTON(w->rows[i].grade_entry));
-        int present = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(w->rows[i].attendance_check)) ? 1 : 0;
+static ExamGrades *exam_grades_collect(Job *job, int exam_id, int with_rows) {
+    ExamGrades *out = g_new0(ExamGrades, 1);
+    out->min = 20;
+    liste_note *grades = app_state.grades;
+    
+    table_lock_read(grades->lock);
+    int capacity = 0;
+    for (int i = 0; i < grades->count && !job_is_cancelled(job); i++) {
+        Note *note = &grades->note[i];
+        if (note->is_deleted || note->id_examen != exam_id) continue;
+        
+        if (note->present) {
+            out->present++;
+            out->sum += note->note_obtenue;
+            if (note->note_obtenue < out->min) out->min = note->note_obtenue;
+            if (note->note_obtenue > out->max) out->max = note->note_obtenue;
+            if (note->note_obtenue >= 10.0) out->passed++;
+        } else {
+            out->absent++;
+        }
         
-        // Only create grade if student was marked as present or if they have a grade entered
-        if (present || grade > 0) {
-            if (professor_create_note_for_student(app_state.grades, w->rows[i].student_id, exam_id, grade, present)) {
-                success_count++;
-            } else {
-                error_count++;
+        if (with_rows) {
+            if (out->row_count == capacity) {
+                capacity = capacity ? capacity * 2 : 64;
+                out->rows = g_renew(ExamGradeRow, out->rows, capacity);
             }
+            ExamGradeRow *row = &out->rows[out->row_count++];
+            row->student_id = note->id_etudiant;
+            row->grade = note->note_obtenue;
+            row->present = note->present;
+            strcpy(row->student_name, "Unknown");
         }
     }
+    table_unlock_read(grades->lock);
     
-    // Save grades to file if any were created
-    if (success_count > 0 && app_state.grades) {
-        sauvegarder_notes_ds_file(app_state.grades);
-        printf("[INFO] Saved %d new grades to file\n", success_count);
-    }
-    
-    // Show result
-    char result_msg[512];
-    if (success_count > 0 && error_count == 0) {
-        snprintf(result_msg, sizeof(result_msg), 
-            "<span foreground='green' weight='bold'>✓ Successfully created %d grade(s)</span>", 
-            success_count);
-    } else if (success_count > 0 && error_count > 0) {
-        snprintf(result_msg, sizeof(result_msg), 
-            "<span foreground='orange' weight='bold'>⚠ Created %d grade(s), %d failed (may already exist)</span>", 
-            success_count, error_count);
-    } else if (error_count > 0) {
-        snprintf(result_msg, sizeof(result_msg), 
-            "<span foreground='red' weight='bold'>✗ Failed to create grades (%d errors)</span>", 
-            error_count);
-    } else {
-        snprintf(result_msg, sizeof(result_msg), 
-            "<span foreground='blue'>No grades to create (select students and enter grades)</span>");
+    if (!with_rows || !app_state.students) return out;
+    
+    table_lock_read(app_state.students->lock);
+    for (int i = 0; i < out->row_count && !job_is_cancelled(job); i++) {
+        ExamGradeRow *row = &out->rows[i];
+        for (int j = 0; j < app_state.students->count; j++) {
+            Student *student = &app_state.students->students[j];
+            if (student->id == row->student_id && !student->is_deleted) {
+                snprintf(row->student_name, sizeof(row->student_name), "%s %s",
+                         student->first_name, student->last_name);
+                break;
+            }
+        }
+        if (i % JOB_PROGRESS_EVERY == 0) {
+            job_report_progress(job, (double)i / out->row_count, "Looking up students");
+        }
     }
-    gtk_label_set_markup(GTK_LABEL(w->result_label), result_msg);
+    table_unlock_read(app_state.students->lock);
+    return out;
 }
 
-static void on_create_grade_clicked(GtkWidget *widget, gpointer data) {
-    CreateNoteWidgets *w = (CreateNoteWidgets*)data;
-    
-    const char *student_id_str = gtk_entry_get_text(GTK_ENTRY(w->student_id_entry));
-    int student_id = atoi(student_id_str);
-    
-    int exam_index = gtk_combo_box_get_active(GTK_COMBO_BOX(w->exam_combo));
-    if (exam_index < 0 || !app_state.exams) {
-        gtk_label_set_markup(GTK_LABEL(w->result_label), 
-            "<span foreground='red'>Error: Please select an exam</span>");
-        return;
-    }
-    
-    int exam_id = app_state.exams->exam[exam_index].id_examen;
-    float grade = gtk_spin_button_get_value(GTK_SPIN_BUTTON(w->grade_entry));
-    int present = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(w->attendance_check)) ? 1 : 0;
-    
-    // Create the note
-    if (professor_create_note_for_student(app_state.grades, student_id, exam_id, grade, present)) {
-        char success_msg[256];
-        snprintf(success_msg, sizeof(success_msg), 
-            "<span foreground='green'>✓ Grade successfully created for Student %d (%.2f/20)</span>", 
-            student_id, grade);
-        gtk_label_set_markup(GTK_LABEL(w->result_label), success_msg);
-        
-        // Clear form
-        gtk_entry_set_text(GTK_ENTRY(w->student_id_entry), "");
-        gtk_spin_button_set_value(GTK_SPIN_BUTTON(w->grade_entry), 10.0);
-    } else {
-        gtk_label_set_markup(GTK_LABEL(w->result_label), 
-            "<span foreground='red'>✗ Failed to create grade. Check student/exam ID or if grade already exists.</span>");
-    }
+/*
+ * Exam statistics: the label keeps a reference so a closed window is not
+ * a problem when the result arrives
+ */
+typedef struct {
+    GtkWidget *label;
+    int exam_id;
+    char exam_name[100];
+} ExamStatsJob;
+
+static void exam_stats_job_free(void *p) {
+    ExamStatsJob *data = (ExamStatsJob*)p;
+    g_object_unref(data->label);
+    g_free(data);
 }
 
-static void on_show_stats_clicked(GtkWidget *widget, gpointer data) {
-    StatsWidgets *w = (StatsWidgets*)data;
-    
-    int exam_index = gtk_combo_box_get_active(GTK_COMBO_BOX(w->combo));
-    if (exam_index < 0 || !app_state.exams || !app_state.grades) {
-        gtk_label_set_text(GTK_LABEL(w->label), "No exam selected or no data available");
-        return;
-    }
-    
-    int exam_id = app_state.exams->exam[exam_index].id_examen;
-    char *exam_name = app_state.exams->exam[exam_index].nom_module;
-    
-    // Calculate statistics
-    float sum = 0, min = 20, max = 0;
-    int count = 0, present = 0, absent = 0, passed = 0;
-    
-    for (int i = 0; i < app_state.grades->count; i++) {
-        if (app_state.grades->note[i].id_examen == exam_id) {
-            if (app_state.grades->note[i].present) {
-                present++;
-                sum += app_state.grades->note[i].note_obtenue;
-                count++;
-                if (app_state.grades->note[i].note_obtenue < min) min = app_state.grades->note[i].note_obtenue;
-                if (app_state.grades->note[i].note_obtenue > max) max = app_state.grades->note[i].note_obtenue;
-                if (app_state.grades->note[i].note_obtenue >= 10.0) passed++;
-            } else {
-                absent++;
-            }
-        }
-    }
+static void *exam_stats_run(Job *job, void *data) {
+    ExamStatsJob *stats = (ExamStatsJob*)data;
+    return exam_grades_collect(job, stats->exam_id, 0);
+}
+
+static void exam_stats_done(void *result, void *data) {
+    ExamStatsJob *job = (ExamStatsJob*)data;
+    ExamGrades *g = (ExamGrades*)result;
+    int count = g->present;
     
     char stats_text[1024];
     if (count > 0) {
@@ -2691,24 +3105,46 @@ static void on_show_stats_clicked(GtkWidget *widget, gpointer data) {
             "Failed (<10): %d\n"
             "Pass rate: %.2f%%\n"
             "Absence rate: %.2f%%",
-            exam_name, exam_id,
-            present + absent,
-            present,
-            absent,
-            count > 0 ? sum / count : 0,
-            min,
-            max,
-            passed,
-            count - passed,
-            count > 0 ? (passed * 100.0 / count) : 0,
-            (present + absent) > 0 ? (absent * 100.0 / (present + absent)) : 0
+            job->exam_name, job->exam_id,
+            g->present + g->absent,
+            g->present,
+            g->absent,
+            g->sum / count,
+            g->min,
+            g->max,
+            g->passed,
+            count - g->passed,
+            g->passed * 100.0 / count,
+            (g->present + g->absent) > 0 ? (g->absent * 100.0 / (g->present + g->absent)) : 0
         );
     } else {
         snprintf(stats_text, sizeof(stats_text), 
-            "<b>No grades found for exam: %s</b>", exam_name);
+            "<b>No grades found for exam: %s</b>", job->exam_name);
     }
     
-    gtk_label_set_markup(GTK_LABEL(w->label), stats_text);
+    gtk_label_set_markup(GTK_LABEL(job->label), stats_text);
+    exam_grades_free(g);
+}
+
+static void on_show_stats_clicked(GtkWidget *widget, gpointer data) {
+    StatsWidgets *w = (StatsWidgets*)data;
+    
+    int exam_index = gtk_combo_box_get_active(GTK_COMBO_BOX(w->combo));
+    if (exam_index < 0 || !app_state.exams || !app_state.grades) {
+        gtk_label_set_text(GTK_LABEL(w->label), "No exam selected or no data available");
+        return;
+    }
+    
+    ExamStatsJob *stats = g_new0(ExamStatsJob, 1);
+    stats->label = g_object_ref(w->label);
+    stats->exam_id = app_state.exams->exam[exam_index].id_examen;
+    snprintf(stats->exam_name, sizeof(stats->exam_name), "%s", app_state.exams->exam[exam_index].nom_module);
+    
+    gtk_label_set_markup(GTK_LABEL(w->label), "<i>Computing statistics...</i>");
+    
+    const JobSpec spec = {"exam statistics", exam_stats_run, exam_stats_done, NULL,
+                          exam_grades_free, exam_stats_job_free};
+    job_submit(&spec, stats);
 }
 
 /*
@@ -2719,18 +3155,32 @@ typedef struct {
     GtkWidget *tree_view;
     GtkWidget *exam_combo;
     GtkWidget *stats_label;
+    Job *job;                   // filter running in the background, if any
 } GradeFilterData;
 
-static void on_filter_grades_by_exam(GtkWidget *widget, gpointer data) {
-    GradeFilterData *filter_data = (GradeFilterData*)data;
-    int exam_index = gtk_combo_box_get_active(GTK_COMBO_BOX(filter_data->exam_combo));
-    
-    if (exam_index < 0 || !app_state.exams || !app_state.grades) {
-        return;
-    }
-    
-    // Get the selected exam ID
-    int exam_id = app_state.exams->exam[exam_index].id_examen;
+// The worker only sees the exam id; the widgets are used from the callbacks,
+// which are not called once the window has cancelled the job
+typedef struct {
+    GradeFilterData *filter;
+    int exam_id;
+} GradeFilterJob;
+
+static void *grade_filter_run(Job *job, void *data) {
+    GradeFilterJob *filter_job = (GradeFilterJob*)data;
+    return exam_grades_collect(job, filter_job->exam_id, 1);
+}
+
+static void grade_filter_progress(double fraction, const char *message, void *data) {
+    GradeFilterData *filter_data = ((GradeFilterJob*)data)->filter;
+    char text[160];
+    snprintf(text, sizeof(text), "<i>%s... %d%%</i>", message, (int)(fraction * 100));
+    gtk_label_set_markup(GTK_LABEL(filter_data->stats_label), text);
+}
+
+static void grade_filter_done(void *result, void *data) {
+    GradeFilterData *filter_data = ((GradeFilterJob*)data)->filter;
+    ExamGrades *g = (ExamGrades*)result;
+    filter_data->job = NULL;
     
     // Get the tree view model
     GtkTreeModel *model = gtk_tree_view_get_model(GTK_TREE_VIEW(filter_data->tree_view));
@@ -2739,70 +3189,62 @@ static void on_filter_grades_by_exam(GtkWidget *widget, gpointer data) {
     // Clear existing data
     gtk_list_store_clear(store);
     
-    // Populate with filtered data
-    int total_count = 0;
-    int present_count = 0;
-    int absent_count = 0;
-    int passed_count = 0;
-    float sum_grades = 0.0;
-    
-    for (int i = 0; i < app_state.grades->count; i++) {
-        Note *note = &app_state.grades->note[i];
+    for (int i = 0; i < g->row_count; i++) {
+        ExamGradeRow *row = &g->rows[i];
+        GtkTreeIter iter;
+        gtk_list_store_append(store, &iter);
         
-        if (note->id_examen == exam_id) {
-            GtkTreeIter iter;
-            gtk_list_store_append(store, &iter);
-            
-            // Find student name
-            char student_name[128] = "Unknown";
-            if (app_state.students) {
-                for (int j = 0; j < app_state.students->count; j++) {
-                    if (app_state.students->students[j].id == note->id_etudiant) {
-                        snprintf(student_name, sizeof(student_name), "%s %s",
-                                app_state.students->students[j].first_name,
-                                app_state.students->students[j].last_name);
-                        break;
-                    }
-                }
-            }
-            
-            char attendance[20];
-            snprintf(attendance, sizeof(attendance), "%s", note->present ? "Present" : "Absent");
-            
-            char *color = note->note_obtenue >= 10.0 ? "green" : "red";
-            
-            gtk_list_store_set(store, &iter,
-                0, note->id_etudiant,
-                1, student_name,
-                2, note->note_obtenue,
-                3, attendance,
-                4, color,
-                -1);
-            
-            total_count++;
-            if (note->present) {
-                present_count++;
-                sum_grades += note->note_obtenue;
-                if (note->note_obtenue >= 10.0) passed_count++;
-            } else {
-                absent_count++;
-            }
-        }
+        char *color = row->grade >= 10.0 ? "green" : "red";
+        
+        gtk_list_store_set(store, &iter,
+            0, row->student_id,
+            1, row->student_name,
+            2, row->grade,
+            3, row->present ? "Present" : "Absent",
+            4, color,
+            -1);
     }
     
     // Update statistics
     char stats[512];
-    if (present_count > 0) {
+    if (g->present > 0) {
         snprintf(stats, sizeof(stats),
                 "<b>Statistics:</b>  Total: %d  |  Present: %d  |  Absent: %d  |  "
                 "Passed: %d (%.1f%%)  |  Average: %.2f/20",
-                total_count, present_count, absent_count, passed_count,
-                (present_count > 0) ? (passed_count * 100.0 / present_count) : 0.0,
-                (present_count > 0) ? (sum_grades / present_count) : 0.0);
+                g->row_count, g->present, g->absent, g->passed,
+                g->passed * 100.0 / g->present,
+                g->sum / g->present);
     } else {
         snprintf(stats, sizeof(stats), "<b>No grades found for this exam</b>");
     }
     gtk_label_set_markup(GTK_LABEL(filter_data->stats_label), stats);
+    exam_grades_free(g);
+}
+
+static void on_filter_grades_by_exam(GtkWidget *widget, gpointer data) {
+    GradeFilterData *filter_data = (GradeFilterData*)data;
+    int exam_index = gtk_combo_box_get_active(GTK_COMBO_BOX(filter_data->exam_combo));
+    
+    if (exam_index < 0 || !app_state.exams || !app_state.grades) {
+        return;
+    }
+    
+    // A newer selection replaces a filter still running
+    job_cancel(filter_data->job);
+    GradeFilterJob *filter_job = g_new0(GradeFilterJob, 1);
+    filter_job->filter = filter_data;
+    filter_job->exam_id = app_state.exams->exam[exam_index].id_examen;
+    gtk_label_set_markup(GTK_LABEL(filter_data->stats_label), "<i>Loading grades...</i>");
+    
+    const JobSpec spec = {"grade filter", grade_filter_run, grade_filter_done, grade_filter_progress,
+                          exam_grades_free, g_free};
+    filter_data->job = job_submit(&spec, filter_job);
+}
+
+static void on_grade_filter_window_destroy(GtkWidget *widget, gpointer data) {
+    GradeFilterData *filter_data = (GradeFilterData*)data;
+    job_cancel(filter_data->job);
+    g_free(filter_data);
 }
 
 static void on_professor_create_notes_clicked(GtkWidget *widget, gpointer data) {
@@ -2923,14 +3365,14 @@ static void on_professor_create_notes_clicked(GtkWidget *widget, gpointer data)
     g_signal_connect_swapped(close_btn, "clicked", G_CALLBACK(gtk_widget_destroy), window);
     
     // Setup filter callback
-    GradeFilterData *filter_data = g_new(GradeFilterData, 1);
+    GradeFilterData *filter_data = g_new0(GradeFilterData, 1);
     filter_data->tree_view = tree_view;
     filter_data->exam_combo = exam_combo;
     filter_data->stats_label = stats_label;
     
     g_signal_connect(view_btn, "clicked", G_CALLBACK(on_filter_grades_by_exam), filter_data);
     g_signal_connect(exam_combo, "changed", G_CALLBACK(on_filter_grades_by_exam), filter_data);
-    g_signal_connect(window, "destroy", G_CALLBACK(g_free), filter_data);
+    g_signal_connect(window, "destroy", G_CALLBACK(on_grade_filter_window_destroy), filter_data);
     
     // Load first exam automatically
     if (app_state.exams && app_state.exams->count > 0) {
@@ -2945,7 +3387,7 @@ static void on_professor_create_notes_clicked(GtkWidget *widget, gpointer data)
  */
 typedef struct {
     GtkWidget *module_combo;
-    GtkWidget *student_combo;
+    GtkWidget *student_entry;
     GtkWidget *content_entry;
     GtkWidget *tree_view;
     GtkWidget *window;
@@ -2958,12 +3400,10 @@ static void on_add_note_clicked(GtkWidget *widget, gpointer data) {
     int module_idx = gtk_combo_box_get_active(GTK_COMBO_BOX(w->module_combo));
     if (module_idx < 0) return;
     
-    char *student_text = gtk_combo_box_text_get_active_text(GTK_COMBO_BOX_TEXT(w->student_combo));
-    if (!student_text) return;
-    
+    // The entry holds the "[ID:n] First Last" text of the picked suggestion
+    const char *student_text = gtk_entry_get_text(GTK_ENTRY(w->student_entry));
     int student_id = 0;
-    sscanf(student_text, "[ID:%d]", &student_id);
-    g_free(student_text);
+    if (sscanf(student_text, "[ID:%d]", &student_id) != 1) return;
     
     const char *content = gtk_entry_get_text(GTK_ENTRY(w->content_entry));
     if (strlen(content) == 0) return;
@@ -3034,6 +3474,7 @@ static void on_professor_text_notes_clicked(GtkWidget *widget, gpointer data) {
     GtkWidget *module_combo = gtk_combo_box_text_new();
     if (app_state.modules) {
         for(int i=0; i<app_state.modules->count; i++) {
+            if (app_state.modules->cours[i].is_deleted) continue;
             char buf[256];
             snprintf(buf, sizeof(buf), "[ID:%d] %s", app_state.modules->cours[i].id, app_state.modules->cours[i].nom);
             gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(module_combo), buf);
@@ -3042,15 +3483,10 @@ static void on_professor_text_notes_clicked(GtkWidget *widget, gpointer data) {
     gtk_box_pack_start(GTK_BOX(add_box), module_combo, FALSE, FALSE, 0);
     
     gtk_box_pack_start(GTK_BOX(add_box), gtk_label_new("Select Student:"), FALSE, FALSE, 0);
-    GtkWidget *student_combo = gtk_combo_box_text_new();
-    if (app_state.students) {
-        for(int i=0; i<app_state.students->count; i++) {
-            char buf[256];
-            snprintf(buf, sizeof(buf), "[ID:%d] %s %s", app_state.students->students[i].id, app_state.students->students[i].first_name, app_state.students->students[i].last_name);
-            gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(student_combo), buf);
-        }
-    }
-    gtk_box_pack_start(GTK_BOX(add_box), student_combo, FALSE, FALSE, 0);
+    GtkWidget *student_entry = gtk_entry_new();
+    gtk_entry_set_placeholder_text(GTK_ENTRY(student_entry), "Type a name or e-mail...");
+    ui_entry_attach_completion(GTK_ENTRY(student_entry), app_state.completer, COMPLETE_STUDENT);
+    gtk_box_pack_start(GTK_BOX(add_box), student_entry, FALSE, FALSE, 0);
     
     gtk_box_pack_start(GTK_BOX(add_box), gtk_label_new("Note Content:"), FALSE, FALSE, 0);
     GtkWidget *content_entry = gtk_entry_new();
@@ -3093,7 +3529,7 @@ static void on_professor_text_notes_clicked(GtkWidget *widget, gpointer data) {
     
     TextNoteWidgets *w = g_new(TextNoteWidgets, 1);
     w->module_combo = module_combo;
-    w->student_combo = student_combo;
+    w->student_entry = student_entry;
     w->content_entry = content_entry;
     w->tree_view = tree_view;
     w->window = window;
@@ -3101,6 +3537,7 @@ static void on_professor_text_notes_clicked(GtkWidget *widget, gpointer data) {
     GtkWidget *add_btn = gtk_button_new_with_label("Add Note");
     g_signal_connect(add_btn, "clicked", G_CALLBACK(on_add_note_clicked), w);
     gtk_box_pack_start(GTK_BOX(add_box), add_btn, FALSE, FALSE, 5);
+    ui_disable_if_read_only(add_btn, follow_socket[0] != 0);
     
     g_signal_connect_swapped(window, "destroy", G_CALLBACK(g_free), w);
     
@@ -3174,7 +3611,12 @@ static void on_student_view_notes_clicked(GtkWidget *widget, gpointer data) {
  */
 static void on_activate(GtkApplication *app, gpointer user_data) {
     printf("[INFO] Application activated\n");
+    // The main window's images are scaled while the user logs in
+    static const AssetSize main_window_assets[] = {
+        { UI_LOGO_FILE, 40, 40 },
+    };
     show_login_window();
+    asset_preload(main_window_assets, G_N_ELEMENTS(main_window_assets));
 }
 
 /*
@@ -3189,10 +3631,37 @@ static void on_shutdown(GApplication *app, gpointer user_data) {
  * Main entry point
  */
 int main(int argc, char *argv[]) {
+    // Batch commands run before anything else and never touch GTK
+    if (argc > 1 && strcmp(argv[1], "--headless") == 0) {
+        argv[1] = argv[0];
+        return headless_main(argc - 1, argv + 1);
+    }
+
+    // --follow [SOCKET]: read-only mirror of the running instance; taken
+    // out of argv before GTK parses it
+    GApplicationFlags app_flags = G_APPLICATION_DEFAULT_FLAGS;
+    if (argc > 1 && strcmp(argv[1], "--follow") == 0) {
+        int used = 1;
+        if (argc > 2 && argv[2][0] != '-') {
+            g_strlcpy(follow_socket, argv[2], sizeof(follow_socket));
+            used = 2;
+        } else if (!utils_get_data_file_path(REPLICATION_SOCKET_FILE, follow_socket, sizeof(follow_socket))) {
+            fprintf(stderr, "[ERROR] No replication socket path\n");
+            return EXIT_FAILURE;
+        }
+        for (int i = 1; i + used < argc; i++) argv[i] = argv[i + used];
+        argc -= used;
+        argv[argc] = NULL;
+        // A second instance of the same application id would otherwise
+        // just activate the primary's window
+        app_flags |= G_APPLICATION_NON_UNIQUE;
+    }
+
     printf("\n╔══════════════════════════════════════════════════════════╗\n");
     printf("║     STUDENT MANAGEMENT SYSTEM v%s                 ║\n", APP_VERSION);
     printf("║     GTK Application                                      ║\n");
     printf("╚══════════════════════════════════════════════════════════╝\n\n");
+    TRACE_INIT();
     
     // Initialize application data
     if (initialize_app_data() != 0) {
@@ -3201,7 +3670,7 @@ int main(int argc, char *argv[]) {
     }
     
     // Create GTK application
-    app_state.app = gtk_application_new("org.studentmgmt.app", G_APPLICATION_DEFAULT_FLAGS);
+    app_state.app = gtk_application_new("org.studentmgmt.app", app_flags);
     if (!app_state.app) {
         fprintf(stderr, "[ERROR] Failed to create GTK application\n");
         cleanup_app();
@@ -3220,5 +3689,6 @@ int main(int argc, char *argv[]) {
     g_object_unref(app_state.app);
     
     printf("[INFO] Application exited with status %d\n", status);
+    TRACE_WRITE(TRACE_OUTPUT_FILE);
     return status;
 }
@@ -0,0 +1,252 @@
+#include "arena.h"
+#include <stdint.h>
+#include <glib.h>
+
+// Table copies may create and destroy arenas on worker threads
+static GMutex g_live_lock;
+static Arena* g_live_arenas = NULL;
+static Arena* g_scratch = NULL;
+static void (*g_scratch_schedule_reset)(void) = NULL;
+static int g_scratch_reset_pending = 0;
+
+// ============================================================================
+// BLOCKS
+// ============================================================================
+
+static ArenaBlock* arena_new_block(Arena* arena, size_t min_size) {
+    size_t size = min_size > arena->block_size ? min_size : arena->block_size;
+    ArenaBlock* block = (ArenaBlock*)malloc(sizeof(ArenaBlock) + size);
+    if (block == NULL) {
+        printf("[ERROR] Failed to allocate block for arena '%s'\n", arena->name);
+        return NULL;
+    }
+    block->next = arena->blocks;
+    block->used = 0;
+    block->size = size;
+    arena->blocks = block;
+
+    arena->counters.block_mallocs++;
+    arena->counters.bytes_reserved += size;
+    if (arena->counters.bytes_reserved > arena->counters.peak_reserved) {
+        arena->counters.peak_reserved = arena->counters.bytes_reserved;
+    }
+    return block;
+}
+
+static void arena_free_block(Arena* arena, ArenaBlock* block) {
+    arena->counters.bytes_reserved -= block->size;
+    free(block);
+}
+
+// Bytes to skip so the next allocation in block starts aligned
+static size_t arena_padding(const ArenaBlock* block, size_t alignment) {
+    uintptr_t address = (uintptr_t)(block->data + block->used);
+    return (alignment - (address & (alignment - 1))) & (alignment - 1);
+}
+
+static void* arena_bump(Arena* arena, size_t size, size_t alignment) {
+    if (arena == NULL) return NULL;
+
+    ArenaBlock* block = arena->blocks;
+    size_t padding = block != NULL ? arena_padding(block, alignment) : 0;
+    if (block == NULL || block->size - block->used < padding + size) {
+        block = arena_new_block(arena, size + alignment);
+        if (block == NULL) return NULL;
+        padding = arena_padding(block, alignment);
+    }
+
+    void* memory = block->data + block->used + padding;
+    block->used += padding + size;
+    arena->bytes_used += padding + size;
+    arena->counters.allocations++;
+    arena->counters.bytes_requested += size;
+    return memory;
+}
+
+// ============================================================================
+// ARENA LIFECYCLE
+// ============================================================================
+
+Arena* arena_create(const char* name, size_t block_size) {
+    Arena* arena = (Arena*)calloc(1, sizeof(Arena));
+    if (arena == NULL) {
+        printf("[ERROR] Failed to create arena '%s'\n", name ? name : "");
+        return NULL;
+    }
+    arena->name = name ? name : "arena";
+    arena->block_size = block_size > 0 ? block_size : ARENA_DEFAULT_BLOCK_SIZE;
+
+    g_mutex_lock(&g_live_lock);
+    arena->next_live = g_live_arenas;
+    g_live_arenas = arena;
+    g_mutex_unlock(&g_live_lock);
+    return arena;
+}
+
+void arena_destroy(Arena* arena) {
+    if (arena == NULL) return;
+
+    g_mutex_lock(&g_live_lock);
+    for (Arena** link = &g_live_arenas; *link != NULL; link = &(*link)->next_live) {
+        if (*link == arena) {
+            *link = arena->next_live;
+            break;
+        }
+    }
+    g_mutex_unlock(&g_live_lock);
+
+    ArenaBlock* block = arena->blocks;
+    while (block != NULL) {
+        ArenaBlock* next = block->next;
+        free(block);
+        block = next;
+    }
+    free(arena);
+}
+
+// Drop everything allocated so far. The largest block is kept so the next
+// load of the same size needs no malloc at all.
+void arena_reset(Arena* arena) {
+    if (arena == NULL) return;
+
+    ArenaBlock* keep = NULL;
+    for (ArenaBlock* block = arena->blocks; block != NULL; block = block->next) {
+        if (keep == NULL || block->size > keep->size) keep = block;
+    }
+
+    ArenaBlock* block = arena->blocks;
+    while (block != NULL) {
+        ArenaBlock* next = block->next;
+        if (block != keep) arena_free_block(arena, block);
+        block = next;
+    }
+
+    if (keep != NULL) {
+        keep->next = NULL;
+        keep->used = 0;
+    }
+    arena->blocks = keep;
+    arena->bytes_used = 0;
+    arena->counters.resets++;
+}
+
+// ============================================================================
+// ALLOCATION
+// ============================================================================
+
+void* arena_alloc(Arena* arena, size_t size) {
+    return arena_bump(arena, size, ARENA_ALIGNMENT);
+}
+
+void* arena_calloc(Arena* arena, size_t count, size_t size) {
+    if (size != 0 && count > (size_t)-1 / size) return NULL;
+    void* memory = arena_bump(arena, count * size, ARENA_ALIGNMENT);
+    if (memory != NULL) memset(memory, 0, count * size);
+    return memory;
+}
+
+// Copy a string, cut to max_length - 1 characters like the fixed-size
+// fields it stands in for. Strings are packed without alignment.
+char* arena_strndup(Arena* arena, const char* text, size_t max_length) {
+    if (text == NULL) text = "";
+    size_t length = max_length > 0 ? strnlen(text, max_length - 1) : strlen(text);
+
+    char* copy = (char*)arena_bump(arena, length + 1, 1);
+    if (copy == NULL) return NULL;
+    memcpy(copy, text, length);
+    copy[length] = '\0';
+    return copy;
+}
+
+ArenaMark arena_mark(Arena* arena) {
+    ArenaMark mark = {0};
+    if (arena != NULL) {
+        mark.block = arena->blocks;
+        mark.used = arena->blocks != NULL ? arena->blocks->used : 0;
+        mark.bytes_used = arena->bytes_used;
+    }
+    return mark;
+}
+
+// Give back everything allocated since the mark
+void arena_release(Arena* arena, ArenaMark mark) {
+    if (arena == NULL) return;
+
+    while (arena->blocks != NULL && arena->blocks != mark.block) {
+        ArenaBlock* next = arena->blocks->next;
+        arena_free_block(arena, arena->blocks);
+        arena->blocks = next;
+    }
+    if (arena->blocks != NULL) {
+        arena->blocks->used = mark.used;
+    }
+    arena->bytes_used = mark.bytes_used;
+}
+
+// ============================================================================
+// SCRATCH ARENA
+// ============================================================================
+
+// The scratch arena, asking the UI to reset it once the current callback
+// is over
+Arena* arena_scratch(void) {
+    if (g_scratch == NULL) {
+        g_scratch = arena_create("scratch", ARENA_DEFAULT_BLOCK_SIZE);
+        if (g_scratch == NULL) return NULL;
+    }
+    if (g_scratch_schedule_reset != NULL && !g_scratch_reset_pending) {
+        g_scratch_reset_pending = 1;
+        g_scratch_schedule_reset();
+    }
+    return g_scratch;
+}
+
+void arena_scratch_reset(void) {
+    arena_reset(g_scratch);
+    g_scratch_reset_pending = 0;
+}
+
+void arena_scratch_set_reset_hook(void (*schedule_reset)(void)) {
+    g_scratch_schedule_reset = schedule_reset;
+    g_scratch_reset_pending = 0;
+}
+
+void arena_scratch_destroy(void) {
+    arena_destroy(g_scratch);
+    g_scratch = NULL;
+    g_scratch_reset_pending = 0;
+}
+
+// ============================================================================
+// REPORTING
+// ============================================================================
+
+// One line per live arena: objects handed out against mallocs actually made
+void arena_report(const char* label) {
+    size_t allocations = 0, block_mallocs = 0, reserved = 0;
+
+    printf("[INFO] Arena allocations %s:\n", label ? label : "");
+    g_mutex_lock(&g_live_lock);
+    for (Arena* arena = g_live_arenas; arena != NULL; arena = arena->next_live) {
+        const ArenaCounters* c = &arena->counters;
+        printf("  %-20s %9zu allocs from %5zu mallocs, %8.1f KB held (peak %.1f KB), %zu resets\n",
+               arena->name, c->allocations, c->block_mallocs,
+               c->bytes_reserved / 1024.0, c->peak_reserved / 1024.0, c->resets);
+        allocations += c->allocations;
+        block_mallocs += c->block_mallocs;
+        reserved += c->bytes_reserved;
+    }
+    g_mutex_unlock(&g_live_lock);
+    printf("  %-20s %9zu allocs from %5zu mallocs, %8.1f KB held\n",
+           "total", allocations, block_mallocs, reserved / 1024.0);
+}
+
+size_t arena_total_reserved(void) {
+    size_t reserved = 0;
+    g_mutex_lock(&g_live_lock);
+    for (Arena* arena = g_live_arenas; arena != NULL; arena = arena->next_live) {
+        reserved += arena->counters.bytes_reserved;
+    }
+    g_mutex_unlock(&g_live_lock);
+    return reserved;
+}
@@ -0,0 +1,237 @@
+#include "asset.h"
+#include "job.h"
+
+static GHashTable* g_originals = NULL;  // path -> decoded pixbuf, NULL once it failed to load
+static GHashTable* g_scaled = NULL;     // "path|width|height" -> scaled pixbuf
+
+// g_object_unref does not take NULL, and failed loads are kept as NULL
+static void asset_pixbuf_unref(gpointer pixbuf) {
+    if (pixbuf) g_object_unref(pixbuf);
+}
+
+static void asset_cache_init(void) {
+    if (g_originals) return;
+    g_originals = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, asset_pixbuf_unref);
+    g_scaled = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_object_unref);
+}
+
+static char* asset_scaled_key(const char* path, int width, int height) {
+    return g_strdup_printf("%s|%d|%d", path, width, height);
+}
+
+// ============================================================================
+// DECODING
+// ============================================================================
+
+// Any thread. Linked-in resources take precedence over the file on disk.
+static GdkPixbuf* asset_decode(const char* path, GError** error) {
+    char* resource = g_strconcat(ASSET_RESOURCE_PREFIX "/", path, NULL);
+    GdkPixbuf* pixbuf;
+    if (g_resources_get_info(resource, G_RESOURCE_LOOKUP_FLAGS_NONE, NULL, NULL, NULL)) {
+        pixbuf = gdk_pixbuf_new_from_resource(resource, error);
+    } else {
+        pixbuf = gdk_pixbuf_new_from_file(path, error);
+    }
+    g_free(resource);
+    return pixbuf;
+}
+
+static GdkPixbuf* asset_scale(GdkPixbuf* original, int width, int height) {
+    if (gdk_pixbuf_get_width(original) == width && gdk_pixbuf_get_height(original) == height) {
+        return g_object_ref(original);
+    }
+    return gdk_pixbuf_scale_simple(original, width, height, GDK_INTERP_BILINEAR);
+}
+
+// ============================================================================
+// LOOKUP
+// ============================================================================
+
+GdkPixbuf* asset_get_pixbuf(const char* path) {
+    if (!path) return NULL;
+    asset_cache_init();
+
+    gpointer cached;
+    if (g_hash_table_lookup_extended(g_originals, path, NULL, &cached)) {
+        return cached;
+    }
+
+    GError* error = NULL;
+    GdkPixbuf* pixbuf = asset_decode(path, &error);
+    if (!pixbuf) {
+        printf("[WARNING] Failed to load image %s: %s\n", path, error ? error->message : "unknown error");
+        if (error) g_error_free(error);
+    }
+    // Remember failures too, so a missing file is reported once
+    g_hash_table_insert(g_originals, g_strdup(path), pixbuf);
+    return pixbuf;
+}
+
+GdkPixbuf* asset_get_scaled(const char* path, int width, int height) {
+    if (!path || width <= 0 || height <= 0) return NULL;
+    asset_cache_init();
+
+    char* key = asset_scaled_key(path, width, height);
+    GdkPixbuf* scaled = g_hash_table_lookup(g_scaled, key);
+    if (scaled) {
+        g_free(key);
+        return scaled;
+    }
+
+    GdkPixbuf* original = asset_get_pixbuf(path);
+    if (!original) {
+        g_free(key);
+        return NULL;
+    }
+    scaled = asset_scale(original, width, height);
+    g_hash_table_insert(g_scaled, key, scaled);
+    return scaled;
+}
+
+int asset_scale_factor(void) {
+    GdkDisplay* display = gdk_display_get_default();
+    if (!display) return 1;
+
+    GdkMonitor* monitor = gdk_display_get_primary_monitor(display);
+    if (!monitor) monitor = gdk_display_get_monitor(display, 0);
+    int scale = monitor ? gdk_monitor_get_scale_factor(monitor) : 1;
+    return scale > 0 ? scale : 1;
+}
+
+GtkWidget* asset_image_new(const char* path, int width, int height) {
+    int scale = asset_scale_factor();
+    GdkPixbuf* pixbuf = asset_get_scaled(path, width * scale, height * scale);
+    if (!pixbuf) return NULL;
+
+    if (scale == 1) {
+        return gtk_image_new_from_pixbuf(pixbuf);
+    }
+    // A surface carrying the scale is drawn at width x height logical
+    // pixels without being stretched again
+    cairo_surface_t* surface = gdk_cairo_surface_create_from_pixbuf(pixbuf, scale, NULL);
+    GtkWidget* image = gtk_image_new_from_surface(surface);
+    cairo_surface_destroy(surface);
+    return image;
+}
+
+// ============================================================================
+// PRELOADING
+// ============================================================================
+
+typedef struct {
+    char* path;
+    int width;              // device pixels
+    int height;
+    GdkPixbuf* original;    // from the cache, or decoded by the worker
+    GdkPixbuf* scaled;
+} AssetPreloadItem;
+
+typedef struct {
+    AssetPreloadItem* items;
+    int count;
+} AssetPreload;
+
+static void asset_preload_free(void* p) {
+    AssetPreload* preload = p;
+    for (int i = 0; i < preload->count; i++) {
+        g_free(preload->items[i].path);
+        if (preload->items[i].original) g_object_unref(preload->items[i].original);
+        if (preload->items[i].scaled) g_object_unref(preload->items[i].scaled);
+    }
+    free(preload->items);
+    free(preload);
+}
+
+static void* asset_preload_run(Job* job, void* data) {
+    AssetPreload* preload = data;
+    for (int i = 0; i < preload->count && !job_is_cancelled(job); i++) {
+        AssetPreloadItem* item = &preload->items[i];
+
+        // Several sizes of one file share its decode
+        for (int j = 0; j < i && !item->original; j++) {
+            if (preload->items[j].original && strcmp(preload->items[j].path, item->path) == 0) {
+                item->original = g_object_ref(preload->items[j].original);
+            }
+        }
+        if (!item->original) {
+            // A failure is left for asset_get_pixbuf() to report
+            item->original = asset_decode(item->path, NULL);
+            if (!item->original) continue;
+        }
+        item->scaled = asset_scale(item->original, item->width, item->height);
+    }
+    return preload;
+}
+
+static void asset_preload_done(void* result, void* data) {
+    AssetPreload* preload = result;
+    asset_cache_init();
+
+    // A window may have loaded the same image in the meantime; keep its copy
+    for (int i = 0; i < preload->count; i++) {
+        AssetPreloadItem* item = &preload->items[i];
+        if (item->original && !g_hash_table_contains(g_originals, item->path)) {
+            g_hash_table_insert(g_originals, g_strdup(item->path), g_object_ref(item->original));
+        }
+        if (item->scaled) {
+            char* key = asset_scaled_key(item->path, item->width, item->height);
+            if (g_hash_table_contains(g_scaled, key)) {
+                g_free(key);
+            } else {
+                g_hash_table_insert(g_scaled, key, g_object_ref(item->scaled));
+            }
+        }
+    }
+    // data is the same object and is freed by free_data
+}
+
+void asset_preload(const AssetSize* sizes, int count) {
+    if (!sizes || count <= 0) return;
+    asset_cache_init();
+
+    AssetPreload* preload = calloc(1, sizeof(AssetPreload));
+    if (!preload) return;
+    preload->items = calloc(count, sizeof(AssetPreloadItem));
+    if (!preload->items) {
+        free(preload);
+        return;
+    }
+
+    int scale = asset_scale_factor();
+    for (int i = 0; i < count; i++) {
+        int width = sizes[i].width * scale;
+        int height = sizes[i].height * scale;
+        char* key = asset_scaled_key(sizes[i].path, width, height);
+        int cached = g_hash_table_contains(g_scaled, key);
+        g_free(key);
+        if (cached) continue;
+
+        AssetPreloadItem* item = &preload->items[preload->count++];
+        item->path = g_strdup(sizes[i].path);
+        item->width = width;
+        item->height = height;
+        GdkPixbuf* original = g_hash_table_lookup(g_originals, sizes[i].path);
+        item->original = original ? g_object_ref(original) : NULL;
+    }
+
+    if (preload->count == 0) {
+        asset_preload_free(preload);
+        return;
+    }
+
+    JobSpec spec = {
+        .name = "asset preload",
+        .run = asset_preload_run,
+        .done = asset_preload_done,
+        .free_data = asset_preload_free
+    };
+    job_submit(&spec, preload);
+}
+
+void asset_cache_clear(void) {
+    if (!g_originals) return;
+    g_hash_table_destroy(g_scaled);
+    g_hash_table_destroy(g_originals);
+    g_scaled = NULL;
+    g_originals = NULL;
+}
@@ -1,15 +1,17 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <stddef.h>
 #include <string.h>
 #include <time.h>
 #include "attendance.h"
 #include "config.h"
-#include "ui.h"
 #include "file_manager.h"
 #include "utils.h"
 #include "stats.h"
 #include "auth.h"
 #include "club.h"
+#include "arena.h"
+#include "changelog.h"
 
 
 
@@ -19,6 +21,9 @@ AttendanceList* attendance_list_create() {
 
     list->count = 0;
     list->capacity = 40;
+    memset(&list->tombstones, 0, sizeof(Tombstones));
+    list->dirty = 0;
+    list->lock = NULL;
     list->records = (AttendanceRecord*)malloc(sizeof(AttendanceRecord) * list->capacity);
     if (!list->records) {
         free(list);
@@ -34,6 +39,8 @@ void attendance_list_destroy(AttendanceList* list) {
         free(list->records);
         list->records = NULL;
     }
+    tombstones_free(&list->tombstones);
+    table_lock_destroy(list->lock);
     list->count = 0;
     list->capacity = 0;
     free(list);
@@ -43,34 +50,97 @@ int attendance_list_add(AttendanceList *list, AttendanceRecord record) {
     if (list == NULL)
         return 0;
 
-    if (list->count >= list->capacity)
-        return 0;
+    table_lock_write(list->lock);
+    int ok = attendance_list_add_locked(list, record);
+    table_unlock_write(list->lock);
+    return ok;
+}
 
+// As attendance_list_add, for a caller that holds the write lock over a batch
+int attendance_list_add_locked(AttendanceList* list, AttendanceRecord record) {
+    if (list->count >= list->capacity) {
+        int new_capacity = (list->capacity == 0) ? 10 : list->capacity * 2;
+        AttendanceRecord* records = (AttendanceRecord*)realloc(list->records, new_capacity * sizeof(AttendanceRecord));
+        if (records == NULL) return 0;
+        list->records = records;
+        list->capacity = new_capacity;
+    }
+    record.is_deleted = 0;
     list->records[list->count++] = record;
+    list->dirty = 1;
+    changelog_record(list->lock, CHANGE_ATTENDANCE, CHANGE_INSERT, &list->records[list->count - 1]);
     return 1;
 }
 
+// Flags the record; later records keep their slots until compaction
 int attendance_list_remove(AttendanceList* list, int record_id) {
     if (list == NULL || list->count == 0)
         return 0;
 
-    for (int i = 0; i < list->count; i++) {
-        if (list->records[i].id == record_id) {
-            for (int j = i; j < list->count - 1; j++) {
-                list->records[j] = list->records[j + 1];
-            }
-            list->count--;
-            return 1;
+    AttendanceRecord* record = attendance_list_find_by_id(list, record_id);
+    if (record == NULL)
+        return 0;
+    table_lock_write(list->lock);
+    list->dirty = 1;
+    int removed = tombstones_mark(&list->tombstones, &record->is_deleted, list->count);
+    if (removed) changelog_record(list->lock, CHANGE_ATTENDANCE, CHANGE_DELETE, record);
+    table_unlock_write(list->lock);
+    return removed;
+}
+
+// Squeeze out removed records. Returns the number dropped.
+int attendance_list_compact(AttendanceList* list) {
+    if (list == NULL || list->records == NULL)
+        return 0;
+
+    table_lock_write(list->lock);
+    int old_count = list->count;
+    list->count = tombstones_compact(&list->tombstones, list->records, sizeof(AttendanceRecord),
+                                     offsetof(AttendanceRecord, is_deleted), list->count);
+    table_unlock_write(list->lock);
+    return old_count - list->count;
+}
+
+int attendance_list_compact_if_needed(AttendanceList* list) {
+    if (list == NULL || !tombstones_should_compact(&list->tombstones, list->count))
+        return 0;
+    return attendance_list_compact(list);
+}
+
+// Copy of the live records, safe to take from any thread
+AttendanceList* attendance_list_snapshot(const AttendanceList* list) {
+    if (list == NULL)
+        return NULL;
+
+    AttendanceList* copy = attendance_list_create();
+    if (copy == NULL)
+        return NULL;
+
+    table_lock_read(list->lock);
+    int live = list->count - list->tombstones.dead;
+    if (live > copy->capacity) {
+        AttendanceRecord* records = (AttendanceRecord*)realloc(copy->records, sizeof(AttendanceRecord) * live);
+        if (!records) {
+            table_unlock_read(list->lock);
+            attendance_list_destroy(copy);
+            return NULL;
         }
+        copy->records = records;
+        copy->capacity = live;
     }
-    return 0;
+    for (int i = 0; i < list->count; i++) {
+        if (list->records[i].is_deleted) continue;
+        copy->records[copy->count++] = list->records[i];
+    }
+    table_unlock_read(list->lock);
+    return copy;
 }
 
 AttendanceRecord* attendance_list_find_by_id(AttendanceList* list, int record_id) {
     if (list == NULL)
         return NULL;
     for (int i = 0; i < list->count; i++) {
-        if (list->records[i].id == record_id) {
+        if (list->records[i].id == record_id && !list->records[i].is_deleted) {
             return &(list->records[i]);
         }
     }
@@ -81,6 +151,8 @@ AttendanceRecord* attendance_list_find_by_student_date(AttendanceList* list, int
     if (list == NULL)
         return NULL;
     for (int i = 0; i < list->count; i++) {
+        if (list->records[i].is_deleted)
+            continue;
         if (list->records[i].student_id == student_id) {
             struct tm tm1 = *localtime(&date);
             struct tm tm2 = *localtime(&(list->records[i].recorded_time));
@@ -99,6 +171,8 @@ AttendanceRecord* attendance_list_find_by_course_date(AttendanceList* list, int
     if (list == NULL)
         return NULL;
     for (int i = 0; i < list->count; i++) {
+        if (list->records[i].is_deleted)
+            continue;
         if (list->records[i].course_id == course_id) {
             struct tm tm1 = *localtime(&date);
             struct tm tm2 = *localtime(&(list->records[i].date));
@@ -120,10 +194,12 @@ int mark_attendance(AttendanceList* list, int student_id, int course_id, time_t
     }
     
     // Check if we need to reallocate
+    table_lock_write(list->lock);
     if(list->count >= list->capacity){
         int new_capacity = (list->capacity == 0) ? 10 : list->capacity * 2;
         AttendanceRecord* newblock = (AttendanceRecord *)realloc(list->records, new_capacity * sizeof(AttendanceRecord));
         if(!newblock){
+            table_unlock_write(list->lock);
             printf("erreur de reallocation ");
             return -1;
         }
@@ -149,9 +225,13 @@ int mark_attendance(AttendanceList* list, int student_id, int course_id, time_t
     newrecord.teacher_id = teacher_id;
     strcpy(newrecord.reason, ""); 
     newrecord.recorded_time = time(NULL); // temps exacte d'enregistrement 
+    newrecord.is_deleted = 0;
 
     list->records[list->count] = newrecord;
     list->count++;
+    list->dirty = 1;
+    changelog_record(list->lock, CHANGE_ATTENDANCE, CHANGE_INSERT, &list->records[list->count - 1]);
+    table_unlock_write(list->lock);
 
     return 0;
 }
@@ -162,12 +242,16 @@ int update_attendance(AttendanceList* list, int record_id, int new_status, const
     }
     
     for(int i = 0 ; i < list->count ; i++){
-        if(list->records[i].id == record_id){
+        if(list->records[i].id == record_id && !list->records[i].is_deleted){
+            table_lock_write(list->lock);
             list->records[i].status = new_status ;
             if(reason != NULL){
             strncpy(list->records[i].reason , reason , 199);
             list->records[i].reason[199] = '\0';
             }
+            list->dirty = 1;
+            changelog_record(list->lock, CHANGE_ATTENDANCE, CHANGE_UPDATE, &list->records[i]);
+            table_unlock_write(list->lock);
             return 0;
         }
     }
@@ -186,6 +270,7 @@ int get_attendance_for_date(AttendanceList* list,int course_id,time_t date,Atten
 
    
     for (int i = 0; i < list->count; i++) {
+        if (list->records[i].is_deleted) continue;
         if (list->records[i].course_id == course_id && list->records[i].date == date){
             (*count)++;
         }
@@ -197,13 +282,16 @@ int get_attendance_for_date(AttendanceList* list,int course_id,time_t date,Atten
     }
 
   
-    *records = malloc(sizeof(AttendanceRecord) * (*count));
+    // scratch result, valid until the current UI callback returns
+    *records = arena_alloc(arena_scratch(), sizeof(AttendanceRecord) * (*count));
     if (*records == NULL) {
+        *count = 0;
         return -1; 
     }
 
     int index = 0;
     for (int i = 0; i < list->count; i++) {
+        if (list->records[i].is_deleted) continue;
         if (list->records[i].course_id == course_id &&
             list->records[i].date == date)
         {
@@ -221,16 +309,20 @@ void attendance_list_display_all(AttendanceList* list) {
         return;
     }
     
-    if (list->count == 0) {
+    int live = list->count - list->tombstones.dead;
+    if (live == 0) {
         printf("Attendance list is empty\n");
         return;
     }
     
     printf("\n=== ALL ATTENDANCE RECORDS ===\n");
-    printf("Total records: %d\n\n", list->count);
+    printf("Total records: %d\n\n", live);
     
+    int shown = 0;
     for (int i = 0; i < list->count; i++) {
-        printf("Record %d:\n", i + 1);
+        if (list->records[i].is_deleted)
+            continue;
+        printf("Record %d:\n", ++shown);
         attendance_display_record(&(list->records[i]));
         printf("--------------------\n");
     }
@@ -291,6 +383,9 @@ int attendance_list_save_to_file(AttendanceList* list, const char* filename) {
         return -1;
     }
 
+    // Removed records are never written; squeeze them out if enough piled up
+    attendance_list_compact_if_needed(list);
+
     FILE* fp = fopen(full_path, "w");
     if (!fp) {
         printf("[ERROR] Failed to open attendance file for writing: %s\n", full_path);
@@ -299,6 +394,8 @@ int attendance_list_save_to_file(AttendanceList* list, const char* filename) {
 
     for (int i = 0; i < list->count; i++) {
         AttendanceRecord* rec = &list->records[i];
+        if (rec->is_deleted)
+            continue;
         fprintf(fp, "%d,%d,%d,%lld,%d\n",
                 rec->student_id,
                 rec->course_id,
@@ -308,7 +405,7 @@ int attendance_list_save_to_file(AttendanceList* list, const char* filename) {
     }
 
     fclose(fp);
-    printf("[OK] Saved %d attendance records to %s\n", list->count, full_path);
+    printf("[OK] Saved %d attendance records to %s\n", list->count - list->tombstones.dead, full_path);
     return 1;
 }
 
@@ -328,7 +425,9 @@ int attendance_list_load_from_file(AttendanceList* list, const char* filename){
         return -1;
     }
 
+    table_lock_write(list->lock);
     list->count = 0;
+    list->tombstones.dead = 0;
     char line[256];
     while (fgets(line, sizeof(line), fp)) {
         if (list->count >= list->capacity) {
@@ -336,6 +435,7 @@ int attendance_list_load_from_file(AttendanceList* list, const char* filename){
             AttendanceRecord* new_records = (AttendanceRecord*)realloc(list->records,
                                                 sizeof(AttendanceRecord) * new_cap);
             if (!new_records) {
+                table_unlock_write(list->lock);
                 fclose(fp);
                 return -1;
             }
@@ -343,7 +443,9 @@ int attendance_list_load_from_file(AttendanceList* list, const char* filename){
             list->capacity = new_cap;
         }
 
-        AttendanceRecord rec;
+        // The file has no id, reason or recording time; ids follow file
+        // order and the record counts as recorded on its date
+        AttendanceRecord rec = { 0 };
         long long date_tmp;
         if (sscanf(line, "%d,%d,%d,%lld,%d",
                    &rec.student_id,
@@ -352,10 +454,14 @@ int attendance_list_load_from_file(AttendanceList* list, const char* filename){
                    &date_tmp,
                    &rec.teacher_id) == 5) {
             rec.date = (time_t)date_tmp;
+            rec.recorded_time = rec.date;
+            rec.id = list->count + 1;
             list->records[list->count++] = rec;
         }
     }
 
+    list->dirty = 0;
+    table_unlock_write(list->lock);
     fclose(fp);
     printf("[OK] Loaded %d attendance records from %s\n", list->count, filename);
     return 1;
@@ -1,8 +1,11 @@
 #include "auth.h"
 #include "utils.h"
 #include "config.h"
+#include "trace.h"
+#include "changelog.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <stddef.h>
 #include <string.h>
 #include <time.h>
 
@@ -32,6 +35,9 @@ UserList* user_list_create(void) {
 
     liste->capacity = 1500;
     liste->count = 0;
+    memset(&liste->tombstones, 0, sizeof(Tombstones));
+    liste->dirty = 0;
+    liste->lock = NULL;
     liste->users = (User*)malloc(sizeof(User) * liste->capacity);
 
     if (!liste->users) {
@@ -49,6 +55,8 @@ void user_list_destroy(UserList* list) {
     if (list->users) {
         free(list->users);
     }
+    tombstones_free(&list->tombstones);
+    table_lock_destroy(list->lock);
 
     free(list);
 }
@@ -67,13 +75,6 @@ int user_list_add(UserList* list, User user) {
         return 0;
     }
 
-    // Resize if needed
-    if (list->count >= list->capacity) {
-        if (!user_list_resize(list, list->capacity * 2)) {
-            return 0;
-        }
-    }
-
     // Assign ID if not set
     if (user.id == 0) {
         user.id = next_user_id++;
@@ -84,8 +85,17 @@ int user_list_add(UserList* list, User user) {
         user.created_at = time(NULL);
     }
 
+    table_lock_write(list->lock);
+    if (list->count >= list->capacity && !user_list_resize(list, list->capacity * 2)) {
+        table_unlock_write(list->lock);
+        return 0;
+    }
+    user.is_deleted = 0;
     list->users[list->count] = user;
     list->count++;
+    list->dirty = 1;
+    changelog_record(list->lock, CHANGE_USERS, CHANGE_INSERT, &list->users[list->count - 1]);
+    table_unlock_write(list->lock);
 
     return 1;
 }
@@ -94,31 +104,73 @@ int user_list_remove(UserList* list, int user_id) {
         return 0;
     }
 
-    int index = -1;
-    for (int i = 0; i < list->count; i++) {
-        if (list->users[i].id == user_id) {
-            index = i;
-            break;
-        }
-    }
-
-    if (index == -1) {
+    // Only flag the user; the ones after it keep their slots until compaction
+    User* user = user_list_find_by_id(list, user_id);
+    if (user == NULL) {
         return 0;
     }
 
-    // Shift remaining users
-    for (int i = index; i < list->count - 1; i++) {
-        list->users[i] = list->users[i + 1];
+    table_lock_write(list->lock);
+    list->dirty = 1;
+    int removed = tombstones_mark(&list->tombstones, &user->is_deleted, list->count);
+    if (removed) changelog_record(list->lock, CHANGE_USERS, CHANGE_DELETE, user);
+    table_unlock_write(list->lock);
+    return removed;
+}
+
+// Squeeze out removed users and give back spare capacity.
+// Returns the number dropped.
+int user_list_compact(UserList* list) {
+    if (list == NULL || list->users == NULL) {
+        return 0;
     }
 
-    list->count--;
+    table_lock_write(list->lock);
+    int old_count = list->count;
+    list->count = tombstones_compact(&list->tombstones, list->users, sizeof(User),
+                                     offsetof(User, is_deleted), list->count);
 
     // Shrink if capacity is much larger than count
     if (list->capacity > 10 && list->count < list->capacity / 4) {
         user_list_resize(list, list->capacity / 2);
     }
+    table_unlock_write(list->lock);
 
-    return 1;
+    return old_count - list->count;
+}
+
+int user_list_compact_if_needed(UserList* list) {
+    if (list == NULL || !tombstones_should_compact(&list->tombstones, list->count)) {
+        return 0;
+    }
+    return user_list_compact(list);
+}
+
+// Copy of the live users, safe to take from any thread
+UserList* user_list_snapshot(const UserList* list) {
+    if (list == NULL) {
+        return NULL;
+    }
+
+    UserList* copy = user_list_create();
+    if (copy == NULL) {
+        return NULL;
+    }
+
+    table_lock_read(list->lock);
+    int live = list->count - list->tombstones.dead;
+    int ok = list->users != NULL && (live <= copy->capacity || user_list_resize(copy, live));
+    for (int i = 0; ok && i < list->count; i++) {
+        if (list->users[i].is_deleted) continue;
+        copy->users[copy->count++] = list->users[i];
+    }
+    table_unlock_read(list->lock);
+
+    if (!ok) {
+        user_list_destroy(copy);
+        return NULL;
+    }
+    return copy;
 }
 User* user_list_find_by_username(UserList* list, const char* username) {
     if (list == NULL || !username) {
@@ -126,6 +178,7 @@ User* user_list_find_by_username(UserList* list, const char* username) {
     }
 
     for (int i = 0; i < list->count; i++) {
+        if (list->users[i].is_deleted) continue;
         if (strcmp(list->users[i].username, username) == 0) {
             return &list->users[i];
         }
@@ -139,7 +192,7 @@ User* user_list_find_by_id(UserList* list, int user_id) {
     }
 
     for (int i = 0; i < list->count; i++) {
-        if (list->users[i].id == user_id) {
+        if (list->users[i].id == user_id && !list->users[i].is_deleted) {
             return &list->users[i];
         }
     }
@@ -152,6 +205,7 @@ User* user_list_find_by_email(UserList* list, const char* email) {
     }
 
     for (int i = 0; i < list->count; i++) {
+        if (list->users[i].is_deleted) continue;
         if (strcmp(list->users[i].email, email) == 0) {
             return &list->users[i];
         }
@@ -236,10 +290,12 @@ void session_destroy(Session* session) {
 }
 
 int auth_login(UserList* list, const char* username, const char* password, Session* session) {
+    TRACE_SCOPE("auth_login");
     if (list == NULL || username == NULL || password == NULL || session == NULL) {
         return 0;
     }
     for (int i = 0; i < list->count; i++) {
+        if (list->users[i].is_deleted) continue;
         if ((strcmp(list->users[i].username, username) == 0 || 
              strcmp(list->users[i].email, username) == 0) &&
             list->users[i].is_active == 1) {
@@ -249,7 +305,11 @@ int auth_login(UserList* list, const char* username, const char* password, Sessi
                 session->role = list->users[i].role;
                 session->login_time = time(NULL);
                 session->is_valid = 1;
+                table_lock_write(list->lock);
                 list->users[i].last_login = time(NULL);
+                list->dirty = 1;
+                changelog_record(list->lock, CHANGE_USERS, CHANGE_UPDATE, &list->users[i]);
+                table_unlock_write(list->lock);
 
                 return 1;
             }
@@ -300,8 +360,12 @@ int auth_change_password(UserList* list, int user_id, const char* old_password,
     }
 
     // Generate new salt and hash new password
+    table_lock_write(list->lock);
     auth_generate_salt(user->salt);
     auth_hash_password(new_password, user->salt, user->password_hash);
+    list->dirty = 1;
+    changelog_record(list->lock, CHANGE_USERS, CHANGE_UPDATE, user);
+    table_unlock_write(list->lock);
 
     return 1;
 }
@@ -409,10 +473,14 @@ int auth_save_users(UserList* list, const char* filename) {
         return 0;
     }
 
+    // Removed users are never written; squeeze them out if enough piled up
+    user_list_compact_if_needed(list);
+
     // Write users in text format: username,email,role,salt,password_hash,created_at,last_login,is_active
-    printf("[DEBUG] Saving %d users to %s:\n", list->count, filename);
+    printf("[DEBUG] Saving %d users to %s:\n", list->count - list->tombstones.dead, filename);
     for (int i = 0; i < list->count; i++) {
         User* user = &list->users[i];
+        if (user->is_deleted) continue;
         printf("[DEBUG]   %d. %s (%s) - Role: %d\n", i+1, user->username, user->email, user->role);
         int written = fprintf(file, "%s,%s,%d,%s,%s,%ld,%ld,%d\n",
                 user->username,
@@ -434,7 +502,7 @@ int auth_save_users(UserList* list, const char* filename) {
     fflush(file);
     
     fclose(file);
-    printf("[OK] Saved %d users to %s\n", list->count, filename);
+    printf("[OK] Saved %d users to %s\n", list->count - list->tombstones.dead, filename);
     return 1;
 }
 
@@ -455,6 +523,18 @@ int auth_load_users(UserList* list, const char* filename) {
         return 0;
     }
 
+    // Records are parsed straight into the table, so readers wait for the
+    // whole load
+    table_lock_write(list->lock);
+
+    // Size the table for the whole file with one realloc
+    long lines = utils_file_count_lines(file);
+    if (lines > list->capacity && !user_list_resize(list, (int)lines)) {
+        table_unlock_write(list->lock);
+        fclose(file);
+        return 0;
+    }
+
     char line[1024];
     int count = 0;
 
@@ -469,12 +549,14 @@ int auth_load_users(UserList* list, const char* filename) {
         // Resize if needed
         if (count >= list->capacity) {
             if (!user_list_resize(list, list->capacity * 2)) {
+                table_unlock_write(list->lock);
                 fclose(file);
                 return 0;
             }
         }
 
         User* user = &list->users[count];
+        user->is_deleted = 0;
         
         // Make a working copy of the line for strtok
         char linecopy[1024];
@@ -558,6 +640,9 @@ int auth_load_users(UserList* list, const char* filename) {
     }
 
     list->count = count;
+    list->tombstones.dead = 0;
+    list->dirty = 0;
+    table_unlock_write(list->lock);
     fclose(file);
     printf("[OK] Loaded %d users from %s\n", count, full_path);
     return 1;
@@ -628,9 +713,10 @@ void auth_display_all_users(UserList* list) {
         return;
     }
 
-    printf("Total Users: %d\n\n", list->count);
+    printf("Total Users: %d\n\n", list->count - list->tombstones.dead);
 
     for (int i = 0; i < list->count; i++) {
+        if (list->users[i].is_deleted) continue;
         auth_display_user(&list->users[i]);
     }
 }
@@ -647,6 +733,8 @@ int user_list_save_to_file(UserList* list, const char* filename) {
         return -1;
     }
 
+    user_list_compact_if_needed(list);
+
     FILE* file = fopen(full_path, "w");
     if (!file) {
         printf("[ERROR] Failed to open file for writing: %s\n", full_path);
@@ -655,6 +743,7 @@ int user_list_save_to_file(UserList* list, const char* filename) {
 
     for (int i = 0; i < list->count; i++) {
         User* u = &list->users[i];
+        if (u->is_deleted) continue;
         fprintf(file, "%d,%s,%s,%s,%s,%d,%lld,%lld,%d\n",
                 u->id,
                 u->username,
@@ -668,7 +757,7 @@ int user_list_save_to_file(UserList* list, const char* filename) {
     }
     
     fclose(file);
-    printf("[OK] Saved %d users to %s\n", list->count, full_path);
+    printf("[OK] Saved %d users to %s\n", list->count - list->tombstones.dead, full_path);
     return 0;
 }
 
@@ -689,12 +778,21 @@ int user_list_load_from_file(UserList* list, const char* filename) {
         return -1;
     }
 
+    table_lock_write(list->lock);
+    long lines = utils_file_count_lines(file);
+    if (lines > list->capacity && !user_list_resize(list, (int)lines)) {
+        table_unlock_write(list->lock);
+        fclose(file);
+        return -1;
+    }
+
     char line[1024];
     int index = 0;
     while (fgets(line, sizeof(line), file)) {
         if (index >= list->capacity) {
             int new_cap = list->capacity * 2;
             if (!user_list_resize(list, new_cap)) {
+                table_unlock_write(list->lock);
                 fclose(file);
                 return -1;
             }
@@ -716,6 +814,7 @@ int user_list_load_from_file(UserList* list, const char* filename) {
         if (fields == 9) {
             u.created_at = (time_t)created_at_tmp;
             u.last_login = (time_t)last_login_tmp;
+            u.is_deleted = 0;
             list->users[index++] = u;
             if (u.id >= next_user_id) {
                 next_user_id = u.id + 1;
@@ -724,6 +823,9 @@ int user_list_load_from_file(UserList* list, const char* filename) {
     }
 
     list->count = index;
+    list->tombstones.dead = 0;
+    list->dirty = 0;
+    table_unlock_write(list->lock);
     fclose(file);
     printf("[OK] Loaded %d users from %s\n", index, filename);
     return 0;
@@ -814,8 +916,12 @@ int auth_reset_password_with_code(UserList* list, const char* email, const char*
     }
 
     // Generate new salt and hash new password
+    table_lock_write(list->lock);
     auth_generate_salt(user->salt);
     auth_hash_password(new_password, user->salt, user->password_hash);
+    list->dirty = 1;
+    changelog_record(list->lock, CHANGE_USERS, CHANGE_UPDATE, user);
+    table_unlock_write(list->lock);
 
     return 1; // Success
 }
@@ -0,0 +1,190 @@
+#include "autosave.h"
+#include "trace.h"
+#include <glib.h>
+
+typedef struct {
+    AutosaveTable table;
+    char filename[512];
+    int in_flight;              // a copy is queued or being written
+} AutosaveEntry;
+
+typedef struct {
+    AutosaveEntry* entry;
+    int result;                 // AUTOSAVE_WRITTEN, _FAILED or _SKIPPED
+} AutosaveJob;
+
+enum { AUTOSAVE_WRITTEN, AUTOSAVE_FAILED, AUTOSAVE_SKIPPED };
+
+static AutosaveEntry g_entries[AUTOSAVE_MAX_TABLES];
+static int g_entry_count = 0;
+
+static GThread* g_saver = NULL;
+static GAsyncQueue* g_pending = NULL;    // main -> saver
+static GAsyncQueue* g_finished = NULL;   // saver -> main
+static AutosaveJob g_stop_job;           // tells the saver to exit
+static guint g_timer = 0;
+static AutosaveCommitFunc g_commit_hook = NULL;
+static void* g_commit_data = NULL;
+
+// ============================================================================
+// SAVER THREAD
+// ============================================================================
+
+// Copies each queued table under its read lock, then writes and frees the
+// copy without holding anything
+static gpointer autosave_thread(gpointer data) {
+    (void)data;
+    TRACE_THREAD_NAME("autosave");
+    for (;;) {
+        AutosaveJob* job = (AutosaveJob*)g_async_queue_pop(g_pending);
+        if (job == &g_stop_job) break;
+
+        const AutosaveTable* table = &job->entry->table;
+        TRACE_SCOPE(table->name);
+        void* snapshot = table->snapshot(table->table);
+        if (snapshot == NULL) {
+            job->result = AUTOSAVE_SKIPPED;
+        } else {
+            int ok = table->write(snapshot, job->entry->filename) == 1;
+            job->result = ok ? AUTOSAVE_WRITTEN : AUTOSAVE_FAILED;
+            table->free_snapshot(snapshot);
+        }
+        g_async_queue_push(g_finished, job);
+    }
+    return NULL;
+}
+
+// ============================================================================
+// MAIN THREAD
+// ============================================================================
+
+// Take back the jobs the saver is done with. A failed or skipped table is
+// left dirty so the next round tries again.
+static void autosave_collect(void) {
+    if (g_finished == NULL) return;
+
+    AutosaveJob* job;
+    while ((job = (AutosaveJob*)g_async_queue_try_pop(g_finished)) != NULL) {
+        AutosaveEntry* entry = job->entry;
+        if (job->result == AUTOSAVE_WRITTEN) {
+            if (entry->table.last_save_time) *entry->table.last_save_time = time(NULL);
+        } else {
+            if (job->result == AUTOSAVE_FAILED) {
+                printf("[WARNING] Autosave of %s failed, retrying next round\n", entry->table.name);
+            }
+            *entry->table.dirty = 1;
+        }
+        entry->in_flight = 0;
+        g_free(job);
+    }
+}
+
+// Queue every dirty table. The flag is cleared before the saver copies the
+// table, so an edit made meanwhile is either in the copy or dirties the
+// table again. A table still in the queue waits for the next round.
+static void autosave_queue_dirty(void) {
+    int queued = 0;
+    for (int i = 0; i < g_entry_count; i++) {
+        AutosaveEntry* entry = &g_entries[i];
+        if (!*entry->table.dirty || entry->in_flight) continue;
+
+        AutosaveJob* job = g_new0(AutosaveJob, 1);
+        job->entry = entry;
+        *entry->table.dirty = 0;
+        entry->in_flight = 1;
+        g_async_queue_push(g_pending, job);
+        queued++;
+    }
+    if (queued > 0 && g_commit_hook) g_commit_hook(g_commit_data);
+}
+
+static gboolean autosave_tick(gpointer data) {
+    (void)data;
+    autosave_collect();
+    autosave_queue_dirty();
+    return G_SOURCE_CONTINUE;
+}
+
+// ============================================================================
+// API
+// ============================================================================
+
+int autosave_register(const AutosaveTable* table) {
+    if (table == NULL || table->table == NULL || table->dirty == NULL || table->filename == NULL ||
+        !table->snapshot || !table->write || !table->free_snapshot) {
+        printf("[ERROR] Invalid autosave table\n");
+        return 0;
+    }
+    if (g_saver != NULL) {
+        printf("[ERROR] Autosave tables must be registered before autosave_start\n");
+        return 0;
+    }
+    if (g_entry_count >= AUTOSAVE_MAX_TABLES) {
+        printf("[ERROR] Too many autosave tables\n");
+        return 0;
+    }
+
+    AutosaveEntry* entry = &g_entries[g_entry_count++];
+    memset(entry, 0, sizeof(AutosaveEntry));
+    entry->table = *table;
+    if (entry->table.name == NULL) entry->table.name = table->filename;
+    strncpy(entry->filename, table->filename, sizeof(entry->filename) - 1);
+    return 1;
+}
+
+void autosave_set_commit_hook(AutosaveCommitFunc hook, void* user_data) {
+    g_commit_hook = hook;
+    g_commit_data = user_data;
+}
+
+int autosave_start(unsigned int interval_seconds) {
+    if (g_saver != NULL) return 1;
+
+    g_pending = g_async_queue_new();
+    g_finished = g_async_queue_new();
+    g_saver = g_thread_try_new("autosave", autosave_thread, NULL, NULL);
+    if (g_saver == NULL) {
+        printf("[WARNING] Could not start the autosave thread, saving on exit only\n");
+        g_async_queue_unref(g_pending);
+        g_async_queue_unref(g_finished);
+        g_pending = g_finished = NULL;
+        return 0;
+    }
+
+    autosave_set_interval(interval_seconds);
+    printf("[OK] Autosave every %u s for %d tables\n", interval_seconds, g_entry_count);
+    return 1;
+}
+
+// 0 turns the timer off; autosave_now() still works
+void autosave_set_interval(unsigned int interval_seconds) {
+    if (g_timer != 0) {
+        g_source_remove(g_timer);
+        g_timer = 0;
+    }
+    if (g_saver != NULL && interval_seconds > 0) {
+        g_timer = g_timeout_add_seconds(interval_seconds, autosave_tick, NULL);
+    }
+}
+
+// Queue every dirty table right away instead of waiting for the timer
+void autosave_now(void) {
+    if (g_saver == NULL) return;
+    autosave_tick(NULL);
+}
+
+void autosave_stop(void) {
+    autosave_set_interval(0);
+
+    if (g_saver != NULL) {
+        g_async_queue_push(g_pending, &g_stop_job);
+        g_thread_join(g_saver);
+        g_saver = NULL;
+
+        autosave_collect();
+        g_async_queue_unref(g_pending);
+        g_async_queue_unref(g_finished);
+        g_pending = g_finished = NULL;
+    }
+    g_entry_count = 0;
+}
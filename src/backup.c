@@ -0,0 +1,699 @@
+#define _GNU_SOURCE     // copy_file_range, syncfs
+#include "backup.h"
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <time.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/sendfile.h>
+#endif
+#if defined(_WIN32) || defined(_WIN64)
+#include <io.h>
+#endif
+
+// Chunks and files are raw bytes; Windows would translate line endings
+#ifndef O_BINARY
+#define O_BINARY 0
+#endif
+
+#define BACKUP_MANIFEST_MAGIC "backup-manifest 1"
+#define BACKUP_HASH_LENGTH 64           // SHA-256 in hex
+#define BACKUP_READ_RETRIES 3
+
+#if BACKUP_READ_SIZE < BACKUP_CHUNK_MAX
+#error "BACKUP_READ_SIZE must hold a whole chunk"
+#endif
+
+typedef struct {
+    char hash[BACKUP_HASH_LENGTH + 1];
+    unsigned int length;
+} BackupChunk;
+
+typedef struct {
+    char* name;                 // relative to the data directory
+    long long size;
+    long long mtime;            // nanoseconds where the system has them
+    BackupChunk* chunks;
+    int chunk_count;
+    int chunk_capacity;
+} BackupFile;
+
+typedef struct {
+    BackupFile* files;
+    int count;
+    int capacity;
+} BackupManifest;
+
+// State of one backup run
+typedef struct {
+    const char* repo_dir;
+    uint64_t gear[256];
+    GChecksum* checksum;
+    unsigned char* buffer;      // BACKUP_READ_SIZE
+    GPtrArray* written;         // paths of the chunks this run stored, synced before the manifest
+    BackupStats stats;
+} Backup;
+
+// ============================================================================
+// PLATFORM
+// ============================================================================
+
+static int sync_fd(int fd) {
+#if defined(_WIN32) || defined(_WIN64)
+    return _commit(fd);
+#else
+    return fsync(fd);
+#endif
+}
+
+// Move a finished .tmp file into place. rename() does not replace an
+// existing file on Windows, so the target is removed first there; a crash
+// in between loses only that one file, which the next run writes again.
+static int replace_file(const char* tmp, const char* path) {
+#if defined(_WIN32) || defined(_WIN64)
+    g_remove(path);
+#endif
+    return g_rename(tmp, path) == 0;
+}
+
+// ============================================================================
+// MANIFESTS
+// ============================================================================
+
+static void manifest_clear(BackupManifest* manifest) {
+    for (int i = 0; i < manifest->count; i++) {
+        g_free(manifest->files[i].name);
+        free(manifest->files[i].chunks);
+    }
+    free(manifest->files);
+    memset(manifest, 0, sizeof(*manifest));
+}
+
+static BackupFile* manifest_add_file(BackupManifest* manifest, const char* name, long long size, long long mtime) {
+    if (manifest->count == manifest->capacity) {
+        int new_capacity = manifest->capacity > 0 ? manifest->capacity * 2 : 16;
+        BackupFile* files = (BackupFile*)realloc(manifest->files, new_capacity * sizeof(BackupFile));
+        if (files == NULL) return NULL;
+        manifest->files = files;
+        manifest->capacity = new_capacity;
+    }
+    BackupFile* file = &manifest->files[manifest->count++];
+    memset(file, 0, sizeof(*file));
+    file->name = g_strdup(name);
+    file->size = size;
+    file->mtime = mtime;
+    return file;
+}
+
+static int file_add_chunk(BackupFile* file, const char* hash, unsigned int length) {
+    if (file->chunk_count == file->chunk_capacity) {
+        int new_capacity = file->chunk_capacity > 0 ? file->chunk_capacity * 2 : 8;
+        BackupChunk* chunks = (BackupChunk*)realloc(file->chunks, new_capacity * sizeof(BackupChunk));
+        if (chunks == NULL) return 0;
+        file->chunks = chunks;
+        file->chunk_capacity = new_capacity;
+    }
+    BackupChunk* chunk = &file->chunks[file->chunk_count++];
+    memcpy(chunk->hash, hash, BACKUP_HASH_LENGTH);
+    chunk->hash[BACKUP_HASH_LENGTH] = '\0';
+    chunk->length = length;
+    return 1;
+}
+
+static const BackupFile* manifest_find(const BackupManifest* manifest, const char* name) {
+    for (int i = 0; i < manifest->count; i++) {
+        if (strcmp(manifest->files[i].name, name) == 0) return &manifest->files[i];
+    }
+    return NULL;
+}
+
+static char* manifest_path(const char* repo_dir, const char* snapshot) {
+    char* file_name = g_strconcat(snapshot, ".manifest", NULL);
+    char* path = g_build_filename(repo_dir, "snapshots", file_name, NULL);
+    g_free(file_name);
+    return path;
+}
+
+// One "file <size> <mtime> <chunks> <name>" line per file, followed by one
+// "<sha256> <length>" line per chunk
+static int manifest_save(const BackupManifest* manifest, const char* path) {
+    char* tmp = g_strconcat(path, ".tmp", NULL);
+    FILE* out = fopen(tmp, "wb");
+    if (out == NULL) {
+        printf("[ERROR] Could not create %s\n", tmp);
+        g_free(tmp);
+        return 0;
+    }
+
+    fprintf(out, "%s\n", BACKUP_MANIFEST_MAGIC);
+    for (int i = 0; i < manifest->count; i++) {
+        const BackupFile* file = &manifest->files[i];
+        fprintf(out, "file %lld %lld %d %s\n", file->size, file->mtime, file->chunk_count, file->name);
+        for (int c = 0; c < file->chunk_count; c++) {
+            fprintf(out, "%s %u\n", file->chunks[c].hash, file->chunks[c].length);
+        }
+    }
+
+    int ok = fflush(out) == 0 && !ferror(out) && sync_fd(fileno(out)) == 0;
+    if (fclose(out) != 0) ok = 0;
+    if (ok) ok = replace_file(tmp, path);
+    if (!ok) {
+        printf("[ERROR] Could not write the backup manifest %s\n", path);
+        g_remove(tmp);
+    }
+    g_free(tmp);
+    return ok;
+}
+
+static int manifest_load(BackupManifest* manifest, const char* path) {
+    FILE* in = fopen(path, "rb");
+    if (in == NULL) return 0;
+
+    char line[1024];
+    int ok = fgets(line, sizeof(line), in) != NULL &&
+             strncmp(line, BACKUP_MANIFEST_MAGIC, strlen(BACKUP_MANIFEST_MAGIC)) == 0;
+    BackupFile* file = NULL;
+    while (ok && fgets(line, sizeof(line), in) != NULL) {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (strncmp(line, "file ", 5) == 0) {
+            long long size, mtime;
+            int count, name_offset = 0;
+            if (sscanf(line + 5, "%lld %lld %d %n", &size, &mtime, &count, &name_offset) < 3 ||
+                name_offset == 0 || line[5 + name_offset] == '\0') {
+                ok = 0;
+                break;
+            }
+            file = manifest_add_file(manifest, line + 5 + name_offset, size, mtime);
+            ok = file != NULL;
+        } else {
+            char hash[BACKUP_HASH_LENGTH + 1];
+            unsigned int length;
+            ok = file != NULL && sscanf(line, "%64s %u", hash, &length) == 2 &&
+                 strlen(hash) == BACKUP_HASH_LENGTH && file_add_chunk(file, hash, length);
+        }
+    }
+    fclose(in);
+
+    // The chunks of each file must add up to its size
+    for (int i = 0; ok && i < manifest->count; i++) {
+        long long total = 0;
+        for (int c = 0; c < manifest->files[i].chunk_count; c++) total += manifest->files[i].chunks[c].length;
+        ok = total == manifest->files[i].size;
+    }
+    if (!ok) {
+        printf("[ERROR] Backup manifest %s is damaged\n", path);
+        manifest_clear(manifest);
+    }
+    return ok;
+}
+
+// ============================================================================
+// FILE I/O
+// ============================================================================
+
+static long long stat_mtime(const struct stat* st) {
+#if defined(__linux__)
+    return (long long)st->st_mtim.tv_sec * 1000000000LL + st->st_mtim.tv_nsec;
+#else
+    return (long long)st->st_mtime * 1000000000LL;
+#endif
+}
+
+static int write_all(int fd, const void* data, size_t length) {
+    const char* p = (const char*)data;
+    while (length > 0) {
+        ssize_t n = write(fd, p, length);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return 0;
+        p += n;
+        length -= (size_t)n;
+    }
+    return 1;
+}
+
+// Append length bytes of in_fd, from in_offset, to out_fd. The kernel
+// copies them when it can (and may share the blocks on a copy-on-write
+// file system); otherwise they go through a buffer.
+static int copy_range(int in_fd, off_t in_offset, int out_fd, size_t length) {
+#if defined(__linux__)
+    loff_t offset = in_offset;
+    while (length > 0) {
+        ssize_t n = copy_file_range(in_fd, &offset, out_fd, NULL, length, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;      // not supported across these file systems
+        length -= (size_t)n;
+    }
+    off_t send_offset = (off_t)offset;
+    while (length > 0) {
+        ssize_t n = sendfile(out_fd, in_fd, &send_offset, length);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        length -= (size_t)n;
+    }
+    in_offset = send_offset;
+#endif
+    // The calls above take explicit offsets and leave the file position alone
+    if (length > 0 && lseek(in_fd, in_offset, SEEK_SET) < 0) return 0;
+    char buffer[16384];
+    while (length > 0) {
+        ssize_t n = read(in_fd, buffer, length < sizeof(buffer) ? length : sizeof(buffer));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0 || !write_all(out_fd, buffer, (size_t)n)) return 0;
+        length -= (size_t)n;
+    }
+    return 1;
+}
+
+static char* chunk_path(const char* repo_dir, const char* hash) {
+    char fanout[3] = { hash[0], hash[1], '\0' };
+    return g_build_filename(repo_dir, "chunks", fanout, hash, NULL);
+}
+
+// ============================================================================
+// CHUNKING
+// ============================================================================
+
+// The cut points, and so the chunk names, depend on this table; it is
+// derived from a fixed seed so every run agrees
+static void gear_init(uint64_t* gear) {
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    for (int i = 0; i < 256; i++) {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        gear[i] = z ^ (z >> 31);
+    }
+}
+
+// Length of the next chunk: the first position past BACKUP_CHUNK_MIN where
+// the top bits of the rolling hash of the last 64 bytes are all zero
+static size_t next_cut(const uint64_t* gear, const unsigned char* data, size_t length) {
+    if (length <= BACKUP_CHUNK_MIN) return length;
+    size_t limit = length < BACKUP_CHUNK_MAX ? length : BACKUP_CHUNK_MAX;
+    uint64_t hash = 0;
+    for (size_t i = BACKUP_CHUNK_MIN; i < limit; i++) {
+        hash = (hash << 1) + gear[data[i]];
+        if ((hash >> (64 - BACKUP_CHUNK_AVG_BITS)) == 0) return i + 1;
+    }
+    return limit;
+}
+
+// Write a chunk unless the store has it. The bytes are written from the
+// buffer they were hashed from, so what is stored always matches its name.
+// Chunks are not synced one by one, see sync_chunks(); one cut short by a
+// crash before the sync has the wrong size and is written again.
+static int store_chunk(Backup* backup, const char* hash, const unsigned char* data, size_t length) {
+    char* path = chunk_path(backup->repo_dir, hash);
+    GStatBuf st;
+    if (g_stat(path, &st) == 0 && st.st_size == (off_t)length) {
+        g_free(path);
+        return 1;
+    }
+
+    char* dir = g_path_get_dirname(path);
+    g_mkdir_with_parents(dir, 0755);
+    g_free(dir);
+
+    char* tmp = g_strconcat(path, ".tmp", NULL);
+    int fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC | O_BINARY, 0644);
+    int ok = fd >= 0 && write_all(fd, data, length);
+    if (fd >= 0 && close(fd) != 0) ok = 0;
+    if (ok) ok = replace_file(tmp, path);
+    if (ok) {
+        backup->stats.chunks_written++;
+        backup->stats.bytes_written += (long long)length;
+        g_ptr_array_add(backup->written, path);
+    } else {
+        printf("[ERROR] Could not write backup chunk %s\n", path);
+        g_remove(tmp);
+        g_free(path);
+    }
+    g_free(tmp);
+    return ok;
+}
+
+// Make the chunks stored by this run durable, together, before the
+// manifest that names them is saved
+static int sync_chunks(Backup* backup) {
+    if (backup->written->len == 0) return 1;
+#if defined(__linux__)
+    // One call flushes the chunk files and their directory entries
+    int repo = open(backup->repo_dir, O_RDONLY);
+    int synced = repo >= 0 && syncfs(repo) == 0;
+    if (repo >= 0) close(repo);
+    if (synced) return 1;
+#endif
+    int ok = 1;
+    for (guint i = 0; ok && i < backup->written->len; i++) {
+        const char* path = (const char*)g_ptr_array_index(backup->written, i);
+        int fd = open(path, O_RDWR | O_BINARY);
+        ok = fd >= 0 && sync_fd(fd) == 0;
+        if (fd >= 0) close(fd);
+    }
+#if !defined(_WIN32) && !defined(_WIN64)
+    // The fan-out directories hold the new names
+    GHashTable* dirs = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    for (guint i = 0; ok && i < backup->written->len; i++) {
+        char* dir = g_path_get_dirname((const char*)g_ptr_array_index(backup->written, i));
+        if (g_hash_table_contains(dirs, dir)) {
+            g_free(dir);
+            continue;
+        }
+        int fd = open(dir, O_RDONLY);
+        ok = fd >= 0 && fsync(fd) == 0;
+        if (fd >= 0) close(fd);
+        g_hash_table_add(dirs, dir);
+    }
+    g_hash_table_destroy(dirs);
+#endif
+    if (!ok) printf("[ERROR] Could not flush the new backup chunks to disk\n");
+    return ok;
+}
+
+// Cut an open file into chunks, store the new ones and list them in file
+static int backup_read_file(Backup* backup, int fd, BackupFile* file) {
+    size_t filled = 0;
+    int eof = 0;
+    while (!eof) {
+        while (!eof && filled < BACKUP_READ_SIZE) {
+            ssize_t n = read(fd, backup->buffer + filled, BACKUP_READ_SIZE - filled);
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0) return 0;
+            if (n == 0) eof = 1;
+            filled += (size_t)n;
+            backup->stats.bytes_read += n;
+        }
+
+        // Keep a whole chunk's worth in the buffer until the end of the file
+        size_t start = 0;
+        while (filled - start >= BACKUP_CHUNK_MAX || (eof && start < filled)) {
+            const unsigned char* data = backup->buffer + start;
+            size_t length = next_cut(backup->gear, data, filled - start);
+
+            g_checksum_reset(backup->checksum);
+            g_checksum_update(backup->checksum, data, (gssize)length);
+            const char* hash = g_checksum_get_string(backup->checksum);
+            if (!store_chunk(backup, hash, data, length) || !file_add_chunk(file, hash, (unsigned int)length)) {
+                return 0;
+            }
+            start += length;
+        }
+        memmove(backup->buffer, backup->buffer + start, filled - start);
+        filled -= start;
+    }
+    return 1;
+}
+
+// Add one file to the manifest, reusing the previous snapshot's chunk list
+// when the file has not changed since
+static int backup_add_file(Backup* backup, const char* data_dir, const char* name,
+                           const BackupManifest* previous, BackupManifest* manifest) {
+    char* path = g_build_filename(data_dir, name, NULL);
+    BackupFile* file = manifest_add_file(manifest, name, 0, 0);
+    int ok = 0;
+
+    for (int attempt = 0; file != NULL && attempt < BACKUP_READ_RETRIES && !ok; attempt++) {
+        int fd = open(path, O_RDONLY | O_BINARY);
+        struct stat before, after;
+        if (fd < 0 || fstat(fd, &before) != 0) {
+            printf("[ERROR] Could not open %s for backup\n", path);
+            if (fd >= 0) close(fd);
+            break;
+        }
+        file->size = (long long)before.st_size;
+        file->mtime = stat_mtime(&before);
+        file->chunk_count = 0;
+
+        const BackupFile* old = manifest_find(previous, name);
+        if (old != NULL && old->size == file->size && old->mtime == file->mtime) {
+            ok = 1;
+            for (int c = 0; c < old->chunk_count && ok; c++) {
+                ok = file_add_chunk(file, old->chunks[c].hash, old->chunks[c].length);
+            }
+            close(fd);
+            break;
+        }
+
+        ok = backup_read_file(backup, fd, file) && fstat(fd, &after) == 0;
+        close(fd);
+        if (!ok) {
+            printf("[ERROR] Could not back up %s\n", path);
+            break;
+        }
+        // Rewritten meanwhile (by the autosave thread, say): read it again
+        if (after.st_size != before.st_size || stat_mtime(&after) != file->mtime) {
+            ok = 0;
+            continue;
+        }
+        backup->stats.files_read++;
+    }
+
+    if (ok) {
+        backup->stats.files++;
+        backup->stats.chunks += file->chunk_count;
+        backup->stats.bytes += file->size;
+    }
+    g_free(path);
+    return ok;
+}
+
+// ============================================================================
+// SNAPSHOTS
+// ============================================================================
+
+static gint compare_names_descending(gconstpointer a, gconstpointer b) {
+    return -strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+static gint compare_names(gconstpointer a, gconstpointer b) {
+    return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+char** backup_list_snapshots(const char* repo_dir, int* count) {
+    if (count) *count = 0;
+    char* path = g_build_filename(repo_dir, "snapshots", NULL);
+    GDir* dir = g_dir_open(path, 0, NULL);
+    g_free(path);
+    if (dir == NULL) return NULL;
+
+    GPtrArray* names = g_ptr_array_new();
+    const char* entry;
+    while ((entry = g_dir_read_name(dir)) != NULL) {
+        if (g_str_has_suffix(entry, ".manifest")) {
+            g_ptr_array_add(names, g_strndup(entry, strlen(entry) - strlen(".manifest")));
+        }
+    }
+    g_dir_close(dir);
+
+    if (names->len == 0) {
+        g_ptr_array_free(names, TRUE);
+        return NULL;
+    }
+    // Names are timestamps, so the newest sorts last
+    g_ptr_array_sort(names, compare_names_descending);
+    if (count) *count = (int)names->len;
+    g_ptr_array_add(names, NULL);
+    return (char**)g_ptr_array_free(names, FALSE);
+}
+
+// The regular files at the top of the data directory, sorted
+static GPtrArray* list_data_files(const char* data_dir) {
+    GError* error = NULL;
+    GDir* dir = g_dir_open(data_dir, 0, &error);
+    if (dir == NULL) {
+        printf("[ERROR] Could not read %s: %s\n", data_dir, error ? error->message : "unknown error");
+        if (error) g_error_free(error);
+        return NULL;
+    }
+
+    GPtrArray* names = g_ptr_array_new_with_free_func(g_free);
+    const char* entry;
+    while ((entry = g_dir_read_name(dir)) != NULL) {
+        if (entry[0] == '.' || g_str_has_suffix(entry, ".tmp")) continue;
+        char* path = g_build_filename(data_dir, entry, NULL);
+        if (g_file_test(path, G_FILE_TEST_IS_REGULAR)) g_ptr_array_add(names, g_strdup(entry));
+        g_free(path);
+    }
+    g_dir_close(dir);
+    g_ptr_array_sort(names, compare_names);
+    return names;
+}
+
+// Timestamp, with a counter if a snapshot was already taken this second
+static char* new_snapshot_name(const char* repo_dir) {
+    char stamp[32];
+    time_t now = time(NULL);
+    struct tm* tm_info = localtime(&now);
+    if (tm_info == NULL || strftime(stamp, sizeof(stamp), "%Y%m%d_%H%M%S", tm_info) == 0) {
+        snprintf(stamp, sizeof(stamp), "%lld", (long long)now);
+    }
+
+    char* name = g_strdup(stamp);
+    for (int n = 2;; n++) {
+        char* path = manifest_path(repo_dir, name);
+        int taken = g_file_test(path, G_FILE_TEST_EXISTS);
+        g_free(path);
+        if (!taken) return name;
+        g_free(name);
+        name = g_strdup_printf("%s_%d", stamp, n);
+    }
+}
+
+char* backup_create(const char* data_dir, const char* repo_dir, BackupStats* stats,
+                    BackupProgressFunc progress, void* user_data) {
+    if (data_dir == NULL || repo_dir == NULL) {
+        printf("[ERROR] Invalid backup arguments\n");
+        return NULL;
+    }
+
+    char* chunks_dir = g_build_filename(repo_dir, "chunks", NULL);
+    char* snapshots_dir = g_build_filename(repo_dir, "snapshots", NULL);
+    int dirs_ok = g_mkdir_with_parents(chunks_dir, 0755) == 0 && g_mkdir_with_parents(snapshots_dir, 0755) == 0;
+    g_free(chunks_dir);
+    g_free(snapshots_dir);
+    if (!dirs_ok) {
+        printf("[ERROR] Could not create the backup repository %s\n", repo_dir);
+        return NULL;
+    }
+
+    GPtrArray* names = list_data_files(data_dir);
+    if (names == NULL) return NULL;
+
+    // Unchanged files are taken from the latest snapshot
+    BackupManifest previous = {0};
+    char** snapshots = backup_list_snapshots(repo_dir, NULL);
+    if (snapshots != NULL) {
+        char* path = manifest_path(repo_dir, snapshots[0]);
+        if (!manifest_load(&previous, path)) {
+            printf("[WARNING] Reading every file again, the last snapshot is unusable\n");
+        }
+        g_free(path);
+        g_strfreev(snapshots);
+    }
+
+    Backup backup;
+    memset(&backup, 0, sizeof(backup));
+    backup.repo_dir = repo_dir;
+    gear_init(backup.gear);
+    backup.checksum = g_checksum_new(G_CHECKSUM_SHA256);
+    backup.buffer = (unsigned char*)malloc(BACKUP_READ_SIZE);
+    backup.written = g_ptr_array_new_with_free_func(g_free);
+
+    BackupManifest manifest = {0};
+    int ok = backup.buffer != NULL;
+    for (guint i = 0; ok && i < names->len; i++) {
+        ok = backup_add_file(&backup, data_dir, (const char*)g_ptr_array_index(names, i), &previous, &manifest);
+        if (ok && progress && !progress((int)i + 1, (int)names->len, user_data)) ok = 0;
+    }
+
+    char* snapshot = NULL;
+    if (ok && sync_chunks(&backup)) {
+        snapshot = new_snapshot_name(repo_dir);
+        char* path = manifest_path(repo_dir, snapshot);
+        if (!manifest_save(&manifest, path)) {
+            g_free(snapshot);
+            snapshot = NULL;
+        }
+        g_free(path);
+    }
+
+    if (snapshot != NULL) {
+        printf("[OK] Backup %s: %d files, %d read, %d new chunks (%lld of %lld bytes stored)\n",
+               snapshot, backup.stats.files, backup.stats.files_read, backup.stats.chunks_written,
+               backup.stats.bytes_written, backup.stats.bytes);
+        if (stats) *stats = backup.stats;
+    }
+    manifest_clear(&manifest);
+    manifest_clear(&previous);
+    g_checksum_free(backup.checksum);
+    free(backup.buffer);
+    g_ptr_array_free(backup.written, TRUE);
+    g_ptr_array_free(names, TRUE);
+    return snapshot;
+}
+
+// ============================================================================
+// RESTORE
+// ============================================================================
+
+// Manifests name files directly inside the data directory
+static int safe_file_name(const char* name) {
+    return name[0] != '\0' && name[0] != '.' && strchr(name, '/') == NULL && strchr(name, '\\') == NULL;
+}
+
+static int restore_file(const char* repo_dir, const BackupFile* file, const char* target_dir) {
+    char* path = g_build_filename(target_dir, file->name, NULL);
+    char* tmp = g_strconcat(path, ".tmp", NULL);
+    int out = open(tmp, O_WRONLY | O_CREAT | O_TRUNC | O_BINARY, 0644);
+    int ok = out >= 0;
+
+    for (int c = 0; ok && c < file->chunk_count; c++) {
+        const BackupChunk* chunk = &file->chunks[c];
+        char* source = chunk_path(repo_dir, chunk->hash);
+        int in = open(source, O_RDONLY | O_BINARY);
+        struct stat st;
+        ok = in >= 0 && fstat(in, &st) == 0 && st.st_size == (off_t)chunk->length &&
+             copy_range(in, 0, out, chunk->length);
+        if (!ok) printf("[ERROR] Backup chunk %s is missing or damaged\n", source);
+        if (in >= 0) close(in);
+        g_free(source);
+    }
+
+    if (out >= 0 && close(out) != 0) ok = 0;
+    if (ok) ok = replace_file(tmp, path);
+    if (!ok) g_remove(tmp);
+    g_free(tmp);
+    g_free(path);
+    return ok;
+}
+
+int backup_restore(const char* repo_dir, const char* snapshot, const char* target_dir,
+                   BackupStats* stats, BackupProgressFunc progress, void* user_data) {
+    if (repo_dir == NULL || snapshot == NULL || target_dir == NULL) {
+        printf("[ERROR] Invalid restore arguments\n");
+        return 0;
+    }
+
+    BackupManifest manifest = {0};
+    char* path = manifest_path(repo_dir, snapshot);
+    int ok = manifest_load(&manifest, path);
+    if (!ok) printf("[ERROR] Could not read snapshot %s\n", snapshot);
+    g_free(path);
+
+    if (ok && g_mkdir_with_parents(target_dir, 0755) != 0) {
+        printf("[ERROR] Could not create %s\n", target_dir);
+        ok = 0;
+    }
+
+    BackupStats restored;
+    memset(&restored, 0, sizeof(restored));
+    for (int i = 0; ok && i < manifest.count; i++) {
+        const BackupFile* file = &manifest.files[i];
+        if (!safe_file_name(file->name)) {
+            printf("[ERROR] Snapshot %s names an unsafe file '%s'\n", snapshot, file->name);
+            ok = 0;
+            break;
+        }
+        ok = restore_file(repo_dir, file, target_dir);
+        if (ok) {
+            restored.files++;
+            restored.chunks += file->chunk_count;
+            restored.bytes += file->size;
+            restored.bytes_written += file->size;
+        }
+        if (ok && progress && !progress(i + 1, manifest.count, user_data)) ok = 0;
+    }
+
+    if (ok) {
+        printf("[OK] Restored snapshot %s to %s: %d files, %lld bytes\n",
+               snapshot, target_dir, restored.files, restored.bytes);
+        if (stats) *stats = restored;
+    }
+    manifest_clear(&manifest);
+    return ok;
+}
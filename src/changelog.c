@@ -0,0 +1,14 @@
+#include "changelog.h"
+
+static ChangelogHook g_hook = NULL;
+static void* g_hook_data = NULL;
+
+void changelog_set_hook(ChangelogHook hook, void* user_data) {
+    g_hook = hook;
+    g_hook_data = user_data;
+}
+
+void changelog_record(const TableLock* lock, ChangeTable table, ChangeOp op, const void* record) {
+    if (g_hook == NULL || lock == NULL || record == NULL) return;
+    g_hook(table, op, record, g_hook_data);
+}
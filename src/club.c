@@ -1,6 +1,5 @@
 #include "student.h"
 #include "config.h"
-#include "ui.h"
 #include "file_manager.h"
 #include "stats.h"
 #include "auth.h"
@@ -8,8 +7,10 @@
 #include "grade.h"
 #include "club.h"
 #include "utils.h"
+#include "changelog.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <stddef.h>
 #include <string.h>
 #include <time.h>
 #include <sys/time.h>
@@ -29,6 +30,8 @@ ClubList* club_list_create(void){
     list->clubs = clubs;
     list->count = 0;
     list->capacity = MAX_CLUBS;
+    list->dirty = 0;
+    list->lock = NULL;
     return list;    
 
 }
@@ -39,6 +42,7 @@ void club_list_destroy(ClubList* list){
     if(list->clubs != NULL){
         free(list->clubs);
     }
+    table_lock_destroy(list->lock);
     free(list);
 }
 
@@ -50,8 +54,12 @@ int club_list_add(ClubList* list, Club new_club){
         printf("error: club list is full\n");
         return 0;
     }
+    table_lock_write(list->lock);
     list->clubs[list->count] = new_club;
     list->count++;
+    list->dirty = 1;
+    changelog_record(list->lock, CHANGE_CLUBS, CHANGE_INSERT, &list->clubs[list->count - 1]);
+    table_unlock_write(list->lock);
     return 1;
 }
 int club_list_remove(ClubList* list, int club_id){
@@ -60,16 +68,48 @@ int club_list_remove(ClubList* list, int club_id){
     }
     for(int i = 0; i < list->count; i++){
         if(list->clubs[i].id == club_id){
+            table_lock_write(list->lock);
+            changelog_record(list->lock, CHANGE_CLUBS, CHANGE_DELETE, &list->clubs[i]);
             for(int j = i; j < list->count - 1; j++){
                 list->clubs[j] = list->clubs[j + 1];
             }
             memset(&list->clubs[list->count - 1], 0, sizeof(Club));
             list->count--;
+            list->dirty = 1;
+            table_unlock_write(list->lock);
             return 1;
         }
     }
     return 0;
 }
+// Copy of the clubs, safe to take from any thread
+ClubList* club_list_snapshot(const ClubList* list){
+    if(list == NULL){
+        return NULL;
+    }
+    ClubList* copy = club_list_create();
+    if(copy == NULL){
+        return NULL;
+    }
+    table_lock_read(list->lock);
+    if(list->count > copy->capacity){
+        Club* clubs = realloc(copy->clubs, sizeof(Club) * list->count);
+        if(clubs == NULL){
+            table_unlock_read(list->lock);
+            printf("error: could not allocate clubs snapshot\n");
+            club_list_destroy(copy);
+            return NULL;
+        }
+        copy->clubs = clubs;
+        copy->capacity = list->count;
+    }
+    if(list->clubs != NULL){
+        memcpy(copy->clubs, list->clubs, sizeof(Club) * list->count);
+        copy->count = list->count;
+    }
+    table_unlock_read(list->lock);
+    return copy;
+}
 Club* club_list_find_by_id(ClubList* list, int club_id){
     if(list == NULL || list->clubs == NULL){
         printf("list is null\n");
@@ -106,7 +146,7 @@ void club_list_display_all(ClubList* list){
     printf("ID: %d\n", list->clubs[i].id);
     printf("Name: %s\n", list->clubs[i].name);
     printf("Description: %s\n", list->clubs[i].description);
-    printf("Category: %s\n", list->clubs[i].category);
+    printf("Category: %s\n", intern_lookup(list->clubs[i].category));
     printf("President ID: %d\n", list->clubs[i].president_id);
     printf("Advisor ID: %d\n", list->clubs[i].advisor_id);
     printf("Member Count: %d\n", list->clubs[i].member_count);
@@ -126,7 +166,7 @@ void club_list_display_club(Club* club){
     printf("ID: %d\n", club->id);
     printf("Name: %s\n", club->name);
     printf("Description: %s\n", club->description);
-    printf("Category: %s\n", club->category);
+    printf("Category: %s\n", intern_lookup(club->category));
     printf("President ID: %d\n", club->president_id);
     printf("Advisor ID: %d\n", club->advisor_id);
     printf("Member Count: %d\n", club->member_count);
@@ -150,6 +190,9 @@ MembershipList* membership_list_create(void) {
     }
     list->capacity = 16;
     list->count = 0;
+    memset(&list->tombstones, 0, sizeof(Tombstones));
+    list->dirty = 0;
+    list->lock = NULL;
     list->memberships = (ClubMembership*)malloc(sizeof(ClubMembership) * list->capacity);
     if (list->memberships == NULL) {
         printf("error: could not allocate memory for memberships array\n");
@@ -166,19 +209,25 @@ void membership_list_destroy(MembershipList* list) {
     if (list->memberships != NULL) {
         free(list->memberships);
     }
+    tombstones_free(&list->tombstones);
+    table_lock_destroy(list->lock);
     free(list);
 }
 
-int membership_list_add(MembershipList* list, ClubMembership membership) {
+// Appends under the write lock; with renumber set, a missing id or one a
+// live membership already holds becomes the next free one
+static int membership_list_append(MembershipList* list, ClubMembership membership, int renumber) {
     if (list == NULL || list->memberships == NULL) {
         printf("error: invalid arguments to membership_list_add\n");
         return 0;
     }
     
+    table_lock_write(list->lock);
     if (list->count >= list->capacity) {
         int new_capacity = list->capacity * 2;
         ClubMembership* new_memberships = (ClubMembership*)realloc(list->memberships, sizeof(ClubMembership) * new_capacity);
         if (new_memberships == NULL) {
+            table_unlock_write(list->lock);
             printf("error: could not allocate more memory for memberships\n");
             return 0;
         }
@@ -186,29 +235,104 @@ int membership_list_add(MembershipList* list, ClubMembership membership) {
         list->capacity = new_capacity;
     }
     
+    // Ids are not dense (removals, generated data), so count + 1 may be
+    // taken; removed memberships still hold back their ids from max_id
+    if (renumber) {
+        int max_id = 0;
+        int taken = 0;
+        for (int i = 0; i < list->count; i++) {
+            if (list->memberships[i].id > max_id) max_id = list->memberships[i].id;
+            if (!list->memberships[i].is_deleted && list->memberships[i].id == membership.id) taken = 1;
+        }
+        if (membership.id <= 0 || taken) membership.id = max_id + 1;
+    }
+
+    membership.is_deleted = 0;
     list->memberships[list->count++] = membership;
+    list->dirty = 1;
+    changelog_record(list->lock, CHANGE_MEMBERSHIPS, CHANGE_INSERT, &list->memberships[list->count - 1]);
+    table_unlock_write(list->lock);
     return 1;
 }
 
+int membership_list_add(MembershipList* list, ClubMembership membership) {
+    return membership_list_append(list, membership, 1);
+}
+
+int membership_list_add_with_id(MembershipList* list, ClubMembership membership) {
+    return membership_list_append(list, membership, 0);
+}
+
 int membership_list_remove(MembershipList* list, int membership_id) {
     if (list == NULL || list->memberships == NULL) {
         printf("error: invalid arguments to membership_list_remove\n");
         return 0;
     }
     
-    for (int i = 0; i < list->count; i++) {
-        if (list->memberships[i].id == membership_id) {
-            for (int j = i; j < list->count - 1; j++) {
-                list->memberships[j] = list->memberships[j + 1];
-            }
-            list->count--;
-            return 1;
-        }
+    // Only flag it; the memberships after it keep their slots until compaction
+    ClubMembership* membership = membership_list_find_by_id(list, membership_id);
+    if (membership != NULL) {
+        table_lock_write(list->lock);
+        tombstones_mark(&list->tombstones, &membership->is_deleted, list->count);
+        list->dirty = 1;
+        changelog_record(list->lock, CHANGE_MEMBERSHIPS, CHANGE_DELETE, membership);
+        table_unlock_write(list->lock);
+        return 1;
     }
     printf("error: membership with id %d not found\n", membership_id);
     return 0;
 }
 
+// Squeeze out removed memberships. Returns the number dropped.
+int membership_list_compact(MembershipList* list) {
+    if (list == NULL || list->memberships == NULL) {
+        return 0;
+    }
+    table_lock_write(list->lock);
+    int old_count = list->count;
+    list->count = tombstones_compact(&list->tombstones, list->memberships, sizeof(ClubMembership),
+                                     offsetof(ClubMembership, is_deleted), list->count);
+    table_unlock_write(list->lock);
+    return old_count - list->count;
+}
+
+int membership_list_compact_if_needed(MembershipList* list) {
+    if (list == NULL || !tombstones_should_compact(&list->tombstones, list->count)) {
+        return 0;
+    }
+    return membership_list_compact(list);
+}
+
+// Copy of the live memberships, safe to take from any thread
+MembershipList* membership_list_snapshot(const MembershipList* list) {
+    if (list == NULL) {
+        return NULL;
+    }
+    MembershipList* copy = membership_list_create();
+    if (copy == NULL) {
+        return NULL;
+    }
+    table_lock_read(list->lock);
+    int live = list->count - list->tombstones.dead;
+    if (live > copy->capacity) {
+        ClubMembership* memberships = realloc(copy->memberships, sizeof(ClubMembership) * live);
+        if (memberships == NULL) {
+            table_unlock_read(list->lock);
+            printf("error: could not allocate memberships snapshot\n");
+            membership_list_destroy(copy);
+            return NULL;
+        }
+        copy->memberships = memberships;
+        copy->capacity = live;
+    }
+    for (int i = 0; list->memberships != NULL && i < list->count; i++) {
+        if (list->memberships[i].is_deleted) continue;
+        copy->memberships[copy->count++] = list->memberships[i];
+    }
+    table_unlock_read(list->lock);
+    return copy;
+}
+
 ClubMembership* membership_list_find_by_id(MembershipList* list, int membership_id) {
     if (list == NULL || list->memberships == NULL) {
         printf("error: invalid arguments to membership_list_find_by_id\n");
@@ -216,13 +340,341 @@ ClubMembership* membership_list_find_by_id(MembershipList* list, int membership_
     }
     
     for (int i = 0; i < list->count; i++) {
-        if (list->memberships[i].id == membership_id) {
+        if (list->memberships[i].id == membership_id && !list->memberships[i].is_deleted) {
             return &list->memberships[i];
         }
     }
     return NULL;
 }
 
+// ============================================================================
+// ROSTER BITSETS
+// ============================================================================
+
+#define CLUB_BITSET_WORD_BITS 64
+
+ClubBitset* club_bitset_create(int max_student_id) {
+    if (max_student_id < 0) {
+        max_student_id = 0;
+    }
+    ClubBitset* set = (ClubBitset*)malloc(sizeof(ClubBitset));
+    if (set == NULL) {
+        printf("error: could not allocate memory for club bitset\n");
+        return NULL;
+    }
+    set->word_count = max_student_id / CLUB_BITSET_WORD_BITS + 1;
+    set->words = (unsigned long long*)calloc(set->word_count, sizeof(unsigned long long));
+    if (set->words == NULL) {
+        printf("error: could not allocate memory for club bitset words\n");
+        free(set);
+        return NULL;
+    }
+    return set;
+}
+
+void club_bitset_destroy(ClubBitset* set) {
+    if (set == NULL) {
+        return;
+    }
+    free(set->words);
+    free(set);
+}
+
+int club_bitset_set(ClubBitset* set, int student_id) {
+    if (set == NULL || student_id < 0 || student_id / CLUB_BITSET_WORD_BITS >= set->word_count) {
+        return 0;
+    }
+    set->words[student_id / CLUB_BITSET_WORD_BITS] |= 1ULL << (student_id % CLUB_BITSET_WORD_BITS);
+    return 1;
+}
+
+int club_bitset_clear(ClubBitset* set, int student_id) {
+    if (set == NULL || student_id < 0 || student_id / CLUB_BITSET_WORD_BITS >= set->word_count) {
+        return 0;
+    }
+    set->words[student_id / CLUB_BITSET_WORD_BITS] &= ~(1ULL << (student_id % CLUB_BITSET_WORD_BITS));
+    return 1;
+}
+
+// Widens the set to hold max_student_id; the new words start empty
+static int club_bitset_grow(ClubBitset* set, int max_student_id) {
+    int word_count = max_student_id / CLUB_BITSET_WORD_BITS + 1;
+    if (word_count <= set->word_count) return 1;
+    unsigned long long* words = (unsigned long long*)realloc(set->words, sizeof(unsigned long long) * word_count);
+    if (words == NULL) {
+        printf("error: could not allocate memory for club bitset words\n");
+        return 0;
+    }
+    memset(words + set->word_count, 0, sizeof(unsigned long long) * (word_count - set->word_count));
+    set->words = words;
+    set->word_count = word_count;
+    return 1;
+}
+
+int club_bitset_test(const ClubBitset* set, int student_id) {
+    if (set == NULL || student_id < 0 || student_id / CLUB_BITSET_WORD_BITS >= set->word_count) {
+        return 0;
+    }
+    return (set->words[student_id / CLUB_BITSET_WORD_BITS] >> (student_id % CLUB_BITSET_WORD_BITS)) & 1ULL;
+}
+
+// Binary operations work on the common prefix; dest words past either input are cleared
+void club_bitset_and(ClubBitset* dest, const ClubBitset* a, const ClubBitset* b) {
+    if (dest == NULL || a == NULL || b == NULL) return;
+    for (int i = 0; i < dest->word_count; i++) {
+        unsigned long long wa = i < a->word_count ? a->words[i] : 0;
+        unsigned long long wb = i < b->word_count ? b->words[i] : 0;
+        dest->words[i] = wa & wb;
+    }
+}
+
+void club_bitset_or(ClubBitset* dest, const ClubBitset* a, const ClubBitset* b) {
+    if (dest == NULL || a == NULL || b == NULL) return;
+    for (int i = 0; i < dest->word_count; i++) {
+        unsigned long long wa = i < a->word_count ? a->words[i] : 0;
+        unsigned long long wb = i < b->word_count ? b->words[i] : 0;
+        dest->words[i] = wa | wb;
+    }
+}
+
+void club_bitset_andnot(ClubBitset* dest, const ClubBitset* a, const ClubBitset* b) {
+    if (dest == NULL || a == NULL || b == NULL) return;
+    for (int i = 0; i < dest->word_count; i++) {
+        unsigned long long wa = i < a->word_count ? a->words[i] : 0;
+        unsigned long long wb = i < b->word_count ? b->words[i] : 0;
+        dest->words[i] = wa & ~wb;
+    }
+}
+
+int club_bitset_count(const ClubBitset* set) {
+    if (set == NULL) return 0;
+    int count = 0;
+    for (int i = 0; i < set->word_count; i++) {
+        count += __builtin_popcountll(set->words[i]);
+    }
+    return count;
+}
+
+// Writes up to max_ids student ids in ascending order, returns the number written
+int club_bitset_to_ids(const ClubBitset* set, int* ids, int max_ids) {
+    if (set == NULL || ids == NULL) return 0;
+    int n = 0;
+    for (int i = 0; i < set->word_count && n < max_ids; i++) {
+        unsigned long long w = set->words[i];
+        while (w != 0 && n < max_ids) {
+            int bit = __builtin_ctzll(w);
+            ids[n++] = i * CLUB_BITSET_WORD_BITS + bit;
+            w &= w - 1;
+        }
+    }
+    return n;
+}
+
+ClubRosterIndex* club_roster_index_build(ClubList* clubs, MembershipList* memberships) {
+    if (clubs == NULL || clubs->clubs == NULL) {
+        printf("error: invalid arguments to club_roster_index_build\n");
+        return NULL;
+    }
+
+    ClubRosterIndex* index = (ClubRosterIndex*)calloc(1, sizeof(ClubRosterIndex));
+    if (index == NULL) {
+        printf("error: could not allocate memory for roster index\n");
+        return NULL;
+    }
+
+    // Size every roster for the largest student id so operations stay word-aligned
+    int max_id = 0;
+    if (memberships != NULL && memberships->memberships != NULL) {
+        for (int i = 0; i < memberships->count; i++) {
+            if (memberships->memberships[i].is_deleted) continue;
+            if (memberships->memberships[i].student_id > max_id) {
+                max_id = memberships->memberships[i].student_id;
+            }
+        }
+    }
+    index->max_student_id = max_id;
+
+    int n = clubs->count > 0 ? clubs->count : 1;
+    index->club_ids = (int*)malloc(sizeof(int) * n);
+    index->rosters = (ClubBitset**)calloc(n, sizeof(ClubBitset*));
+    if (index->club_ids == NULL || index->rosters == NULL) {
+        printf("error: could not allocate memory for club rosters\n");
+        club_roster_index_destroy(index);
+        return NULL;
+    }
+
+    for (int i = 0; i < clubs->count; i++) {
+        index->rosters[i] = club_bitset_create(max_id);
+        if (index->rosters[i] == NULL) {
+            club_roster_index_destroy(index);
+            return NULL;
+        }
+        index->club_ids[i] = clubs->clubs[i].id;
+        index->count++;
+    }
+
+    if (memberships != NULL && memberships->memberships != NULL) {
+        for (int i = 0; i < memberships->count; i++) {
+            ClubMembership* m = &memberships->memberships[i];
+            if (!m->is_active || m->is_deleted) continue;
+            ClubBitset* roster = club_roster_index_get(index, m->club_id);
+            if (roster != NULL) {
+                club_bitset_set(roster, m->student_id);
+            }
+        }
+    }
+
+    return index;
+}
+
+void club_roster_index_destroy(ClubRosterIndex* index) {
+    if (index == NULL) {
+        return;
+    }
+    if (index->rosters != NULL) {
+        for (int i = 0; i < index->count; i++) {
+            club_bitset_destroy(index->rosters[i]);
+        }
+        free(index->rosters);
+    }
+    free(index->club_ids);
+    free(index);
+}
+
+ClubBitset* club_roster_index_get(ClubRosterIndex* index, int club_id) {
+    if (index == NULL) return NULL;
+    for (int i = 0; i < index->count; i++) {
+        if (index->club_ids[i] == club_id) {
+            return index->rosters[i];
+        }
+    }
+    return NULL;
+}
+
+// Keeps a built index in step with one membership change: sets or clears the
+// student's bit, adding the club or widening every roster when needed
+int club_roster_index_set_member(ClubRosterIndex* index, int club_id, int student_id, int is_member) {
+    if (index == NULL || student_id < 0) return 0;
+
+    ClubBitset* roster = club_roster_index_get(index, club_id);
+    if (!is_member) {
+        return roster == NULL || club_bitset_clear(roster, student_id);
+    }
+
+    if (student_id > index->max_student_id) {
+        for (int i = 0; i < index->count; i++) {
+            if (!club_bitset_grow(index->rosters[i], student_id)) return 0;
+        }
+        index->max_student_id = student_id;
+    }
+    if (roster == NULL) {
+        // A club created after the index was built
+        int* club_ids = (int*)realloc(index->club_ids, sizeof(int) * (index->count + 1));
+        if (club_ids == NULL) {
+            printf("error: could not allocate memory for club rosters\n");
+            return 0;
+        }
+        index->club_ids = club_ids;
+        ClubBitset** rosters = (ClubBitset**)realloc(index->rosters, sizeof(ClubBitset*) * (index->count + 1));
+        if (rosters == NULL) {
+            printf("error: could not allocate memory for club rosters\n");
+            return 0;
+        }
+        index->rosters = rosters;
+        roster = club_bitset_create(index->max_student_id);
+        if (roster == NULL) return 0;
+        index->club_ids[index->count] = club_id;
+        index->rosters[index->count++] = roster;
+    }
+    return club_bitset_set(roster, student_id);
+}
+
+// Combines two club rosters into result (may be NULL), returns the resulting student count
+int club_roster_query(ClubRosterIndex* index, int club_a, int club_b, ClubSetOp op, ClubBitset* result) {
+    ClubBitset* a = club_roster_index_get(index, club_a);
+    ClubBitset* b = club_roster_index_get(index, club_b);
+    if (a == NULL || b == NULL) {
+        printf("error: unknown club id in roster query (%d, %d)\n", club_a, club_b);
+        return -1;
+    }
+
+    ClubBitset* dest = result;
+    if (dest == NULL) {
+        dest = club_bitset_create(index->max_student_id);
+        if (dest == NULL) return -1;
+    }
+
+    switch (op) {
+        case CLUB_SET_AND:
+            club_bitset_and(dest, a, b);
+            break;
+        case CLUB_SET_OR:
+            club_bitset_or(dest, a, b);
+            break;
+        case CLUB_SET_ANDNOT:
+            club_bitset_andnot(dest, a, b);
+            break;
+    }
+
+    int count = club_bitset_count(dest);
+    if (dest != result) {
+        club_bitset_destroy(dest);
+    }
+    return count;
+}
+
+// Counts students who are members of at least min_clubs clubs.
+// Keeps one "in at least k clubs" word per level and folds each roster in.
+int club_roster_count_in_at_least(ClubRosterIndex* index, int min_clubs) {
+    if (index == NULL || index->count == 0) return 0;
+    if (min_clubs <= 0) min_clubs = 1;
+    if (min_clubs > index->count) return 0;
+
+    unsigned long long* levels = (unsigned long long*)malloc(sizeof(unsigned long long) * (min_clubs + 1));
+    if (levels == NULL) {
+        printf("error: could not allocate memory for roster levels\n");
+        return 0;
+    }
+
+    int words = index->rosters[0]->word_count;
+    int count = 0;
+    for (int w = 0; w < words; w++) {
+        memset(levels, 0, sizeof(unsigned long long) * (min_clubs + 1));
+        levels[0] = ~0ULL;
+        for (int c = 0; c < index->count; c++) {
+            unsigned long long bits = index->rosters[c]->words[w];
+            for (int k = min_clubs; k >= 1; k--) {
+                levels[k] |= levels[k - 1] & bits;
+            }
+        }
+        count += __builtin_popcountll(levels[min_clubs]);
+    }
+
+    free(levels);
+    return count;
+}
+
+// Counts students from the student list who hold no active club membership
+int club_roster_count_in_no_club(ClubRosterIndex* index, StudentList* students) {
+    if (index == NULL || students == NULL || students->students == NULL) return 0;
+
+    ClubBitset* any = club_bitset_create(index->max_student_id);
+    if (any == NULL) return 0;
+    for (int c = 0; c < index->count; c++) {
+        club_bitset_or(any, any, index->rosters[c]);
+    }
+
+    int count = 0;
+    for (int i = 0; i < students->count; i++) {
+        if (students->students[i].is_deleted) continue;
+        if (!club_bitset_test(any, students->students[i].id)) {
+            count++;
+        }
+    }
+
+    club_bitset_destroy(any);
+    return count;
+}
 
 
 
@@ -255,7 +707,7 @@ int club_list_save_to_file(ClubList* list, const char* filename) {
             c->id,
             c->name,
             c->description,
-            c->category,
+            intern_lookup(c->category),
             c->president_id,
             c->advisor_id,
             c->member_count,
@@ -292,8 +744,10 @@ int club_list_load_from_file(ClubList* list, const char* filename){
         return 0;
     }
 
+    table_lock_write(list->lock);
     list->count = 0;
     char line[2048];
+    char category[MAX_CLUB_LENGTH];
     
     // Read all clubs in text format
     while (fgets(line, sizeof(line), file)) {
@@ -303,6 +757,7 @@ int club_list_load_from_file(ClubList* list, const char* filename){
             Club* new_clubs = realloc(list->clubs, sizeof(Club) * new_capacity);
             if (!new_clubs) {
                 printf("error: could not allocate more memory for clubs\n");
+                table_unlock_write(list->lock);
                 fclose(file);
                 return 0;
             }
@@ -318,7 +773,7 @@ int club_list_load_from_file(ClubList* list, const char* filename){
             &c->id,
             c->name,
             c->description,
-            c->category,
+            category,
             &c->president_id,
             &c->advisor_id,
             &c->member_count,
@@ -333,6 +788,7 @@ int club_list_load_from_file(ClubList* list, const char* filename){
         );
 
         if (fields == 15) {
+            c->category = intern_string(category);
             c->founded_date = (time_t)founded;
             c->last_meeting = (time_t)last_meet;
             list->count++;
@@ -341,6 +797,8 @@ int club_list_load_from_file(ClubList* list, const char* filename){
         }
     }
 
+    list->dirty = 0;
+    table_unlock_write(list->lock);
     fclose(file);
     printf("[OK] Loaded %d clubs from %s\n", list->count, full_path);
     return 1;
@@ -357,6 +815,9 @@ int membership_list_save_to_file(MembershipList* list, const char* filename) {
         return 0;
     }
     
+    // Removed memberships are never written; squeeze them out if enough piled up
+    membership_list_compact_if_needed(list);
+    
     FILE* file = fopen(full_path, "w");
     if (file == NULL) {
         printf("error: could not open file %s for writing\n", full_path);
@@ -364,12 +825,13 @@ int membership_list_save_to_file(MembershipList* list, const char* filename) {
     }
     for (int i = 0; i < list->count; i++) {
         ClubMembership* mmbsh = &list->memberships[i];
+        if (mmbsh->is_deleted) continue;
         fprintf(file, "%d,%d,%d,%lld,%s,%d\n",
             mmbsh->id,
             mmbsh->student_id,
             mmbsh->club_id,
             (long long)mmbsh->join_date,
-            mmbsh->role,
+            intern_lookup(mmbsh->role),
             mmbsh->is_active
         );
     }
@@ -391,12 +853,19 @@ int membership_list_load_from_file(MembershipList* list, const char* filename){
     FILE* file = fopen(full_path, "r");
     if (!file) {
         printf("warning: could not open file %s for reading (will start with empty list)\n", full_path);
+        table_lock_write(list->lock);
         list->count = 0;
+        list->tombstones.dead = 0;
+        list->dirty = 0;
+        table_unlock_write(list->lock);
         return 1;
     }
 
+    table_lock_write(list->lock);
     list->count = 0;
+    list->tombstones.dead = 0;
     char line[256];
+    char role[50];
     
     // Read memberships line by line
     while (fgets(line, sizeof(line), file)) {
@@ -406,6 +875,7 @@ int membership_list_load_from_file(MembershipList* list, const char* filename){
             ClubMembership* new_memberships = realloc(list->memberships, sizeof(ClubMembership) * new_capacity);
             if (!new_memberships) {
                 printf("error: could not allocate more memory for memberships\n");
+                table_unlock_write(list->lock);
                 fclose(file);
                 return 0;
             }
@@ -422,11 +892,12 @@ int membership_list_load_from_file(MembershipList* list, const char* filename){
             &m->student_id,
             &m->club_id,
             &join_date,
-            m->role,
+            role,
             &m->is_active
         );
 
         if (fields == 6) {
+            m->role = intern_string(role);
             m->join_date = (time_t)join_date;
             list->count++;
         } else {
@@ -434,6 +905,8 @@ int membership_list_load_from_file(MembershipList* list, const char* filename){
         }
     }
 
+    list->dirty = 0;
+    table_unlock_write(list->lock);
     fclose(file);
     printf("[OK] Loaded %d memberships from %s\n", list->count, filename);
     return 1;
@@ -444,6 +917,7 @@ int membership_list_load_from_file(MembershipList* list, const char* filename){
 // Function to create a new club (asks user for input)
 Club club_input_new(void) {
     Club c;
+    char category[MAX_CLUB_LENGTH];
     printf("Les informations du club :\n");
     printf("Id: ");
     scanf("%d", &c.id);
@@ -455,7 +929,8 @@ Club club_input_new(void) {
     scanf(" %[^\n]", c.description);
 
     printf("Category: ");
-    scanf(" %[^\n]", c.category);
+    scanf(" %49[^\n]", category);
+    c.category = intern_string(category);
 
     printf("President_id: ");
     scanf("%d", &c.president_id);
@@ -485,6 +960,7 @@ Club club_input_new(void) {
 
 // Function to edit a club's information
 void club_input_edit(Club* club) {
+    char category[MAX_CLUB_LENGTH];
     int choice;
     printf("\nQue voulez-vous modifier ?\n");
     printf(" 1 -> Id\n");
@@ -522,7 +998,8 @@ void club_input_edit(Club* club) {
         break;
     case 4:
         printf("Nouveau Category: ");
-        scanf(" %[^\n]", club->category);
+        scanf(" %49[^\n]", category);
+        club->category = intern_string(category);
         printf("Category modifiée.\n");
         break;
     case 5:
@@ -590,7 +1067,7 @@ void club_display_summary(ClubList* list) {
         printf("%-5d %-30s %-20s %-8d %-8d %-10s\n",
                club->id,
                club->name,
-               club->category,
+               intern_lookup(club->category),
                club->member_count,
                club->max_members,
                club->is_active ? "Active" : "Inactive");
@@ -605,11 +1082,10 @@ int join_club(MembershipList* list, int student_id, int club_id, const char* rol
     if (!list || !role) return 0;
 
     ClubMembership mmbsh;
-    mmbsh.id = 0; // Should be assigned properly elsewhere (e.g., unique id system)
+    mmbsh.id = 0;   // assigned by membership_list_add
     mmbsh.student_id = student_id;
     mmbsh.club_id = club_id;
-    strncpy(mmbsh.role, role, sizeof(mmbsh.role) - 1);
-    mmbsh.role[sizeof(mmbsh.role) - 1] = '\0';
+    mmbsh.role = intern_string(role);
     mmbsh.is_active = 1;
 
     int day, month, year;
@@ -639,6 +1115,7 @@ int leave_club(MembershipList* list, int student_id, int club_id) {
     if (list == NULL) return 0;
     // Find membership by student_id and club_id, then remove
     for (int i = 0; i < list->count; i++) {
+        if (list->memberships[i].is_deleted) continue;
         if (list->memberships[i].student_id == student_id && 
             list->memberships[i].club_id == club_id) {
             return membership_list_remove(list, list->memberships[i].id);
@@ -653,25 +1130,32 @@ int club_list_init_predefined(ClubList* list) {
     
     time_t now = time(NULL);
     Club predefined_clubs[] = {
-        {1, "Quran Club", "Islamic studies and Quran recitation", CLUB_CATEGORY_RELIGIOUS, 
+        {1, "Quran Club", "Islamic studies and Quran recitation", 0,
          0, 0, 0, 50, now, 0, "Friday", "14:00", "Room 101", 0.0, 1},
-        {2, "Sport Club", "Physical activities and sports competitions", CLUB_CATEGORY_SPORTS, 
+        {2, "Sport Club", "Physical activities and sports competitions", 0,
          0, 0, 0, 100, now, 0, "Wednesday", "16:00", "Gymnasium", 0.0, 1},
-        {3, "Chess Club", "Strategic thinking and chess tournaments", CLUB_CATEGORY_ACADEMIC, 
+        {3, "Chess Club", "Strategic thinking and chess tournaments", 0,
          0, 0, 0, 30, now, 0, "Tuesday", "15:00", "Room 205", 0.0, 1},
-        {4, "01 Club", "Binary and computer science fundamentals", CLUB_CATEGORY_TECHNOLOGY, 
+        {4, "01 Club", "Binary and computer science fundamentals", 0,
          0, 0, 0, 40, now, 0, "Thursday", "14:00", "Lab 1", 0.0, 1},
-        {5, "Tech Club", "Technology innovation and programming", CLUB_CATEGORY_TECHNOLOGY, 
+        {5, "Tech Club", "Technology innovation and programming", 0,
          0, 0, 0, 60, now, 0, "Monday", "15:00", "Lab 2", 0.0, 1},
-        {6, "CSS Club", "Web design and creative styling", CLUB_CATEGORY_TECHNOLOGY, 
+        {6, "CSS Club", "Web design and creative styling", 0,
          0, 0, 0, 35, now, 0, "Wednesday", "14:00", "Lab 3", 0.0, 1},
-        {7, "TGD Club", "Team game development and collaboration", CLUB_CATEGORY_TECHNOLOGY, 
+        {7, "TGD Club", "Team game development and collaboration", 0,
          0, 0, 0, 45, now, 0, "Friday", "16:00", "Room 305", 0.0, 1}
     };
     
+    // Category of each club above, interned before adding
+    const char* categories[] = {
+        CLUB_CATEGORY_RELIGIOUS, CLUB_CATEGORY_SPORTS, CLUB_CATEGORY_ACADEMIC, CLUB_CATEGORY_TECHNOLOGY,
+        CLUB_CATEGORY_TECHNOLOGY, CLUB_CATEGORY_TECHNOLOGY, CLUB_CATEGORY_TECHNOLOGY
+    };
+    
     // Only add clubs that don't already exist
     int added = 0;
     for (int i = 0; i < 7; i++) {
+        predefined_clubs[i].category = intern_string(categories[i]);
         Club* existing = club_list_find_by_name(list, predefined_clubs[i].name);
         if (existing == NULL) {
             if (club_list_add(list, predefined_clubs[i])) {
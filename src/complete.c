@@ -0,0 +1,242 @@
+#include "complete.h"
+#include "search.h"
+
+// ============================================================================
+// ENTRY STORAGE
+// ============================================================================
+
+static int compare_completion_entries(const void* a, const void* b) {
+    const CompletionEntry* ea = (const CompletionEntry*)a;
+    const CompletionEntry* eb = (const CompletionEntry*)b;
+    int cmp = strcmp(ea->key, eb->key);
+    if (cmp != 0) return cmp;
+    if (ea->kind != eb->kind) return ea->kind - eb->kind;
+    return ea->id - eb->id;
+}
+
+static int completion_index_reserve(CompletionIndex* index, int needed) {
+    if (needed <= index->capacity) return 1;
+
+    int new_capacity = index->capacity > 0 ? index->capacity * 2 : 256;
+    while (new_capacity < needed) new_capacity *= 2;
+
+    CompletionEntry* entries = (CompletionEntry*)realloc(index->entries, new_capacity * sizeof(CompletionEntry));
+    if (!entries) {
+        printf("[ERROR] Failed to grow completion index\n");
+        return 0;
+    }
+    index->entries = entries;
+    index->capacity = new_capacity;
+    return 1;
+}
+
+// First entry whose key is >= the given key
+static int completion_index_lower_bound(const CompletionIndex* index, const char* key) {
+    int lo = 0, hi = index->count;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (strcmp(index->entries[mid].key, key) < 0) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+// Store one key for a record. Keys that fold to nothing are skipped.
+// display must already live in the index's arena; a record's keys share it.
+// With keep_sorted the entry is inserted in place, otherwise appended.
+static int completion_index_put(CompletionIndex* index, int kind, int id,
+                                const char* raw_key, const char* display, int keep_sorted) {
+    char key[COMPLETE_MAX_KEY];
+    int len = search_fold_text(raw_key, key, sizeof(key));
+    if (len == 0) return 1;
+
+    if (!completion_index_reserve(index, index->count + 1)) return 0;
+
+    CompletionEntry entry;
+    entry.key = arena_strndup(index->text, key, 0);
+    if (!entry.key) {
+        printf("[ERROR] Failed to store completion entry\n");
+        return 0;
+    }
+    entry.display = display;
+    entry.id = id;
+    entry.kind = kind;
+
+    int pos = index->count;
+    if (keep_sorted) {
+        pos = completion_index_lower_bound(index, entry.key);
+        memmove(&index->entries[pos + 1], &index->entries[pos],
+                (index->count - pos) * sizeof(CompletionEntry));
+    }
+    index->entries[pos] = entry;
+    index->count++;
+    return 1;
+}
+
+// Copy a display string into the index's arena
+static const char* completion_index_store_display(CompletionIndex* index, const char* display) {
+    const char* copy = arena_strndup(index->text, display, 0);
+    if (!copy) printf("[ERROR] Failed to store completion entry\n");
+    return copy;
+}
+
+static int completion_index_put_student(CompletionIndex* index, const Student* s, int keep_sorted) {
+    char buffer[COMPLETE_MAX_DISPLAY];
+    char key[COMPLETE_MAX_KEY];
+    snprintf(buffer, sizeof(buffer), "[ID:%d] %s %s", s->id, s->first_name, s->last_name);
+    const char* display = completion_index_store_display(index, buffer);
+    if (!display) return 0;
+
+    snprintf(key, sizeof(key), "%s %s", s->first_name, s->last_name);
+    if (!completion_index_put(index, COMPLETE_STUDENT, s->id, key, display, keep_sorted)) return 0;
+    snprintf(key, sizeof(key), "%s %s", s->last_name, s->first_name);
+    if (!completion_index_put(index, COMPLETE_STUDENT, s->id, key, display, keep_sorted)) return 0;
+    return completion_index_put(index, COMPLETE_STUDENT, s->id, s->email, display, keep_sorted);
+}
+
+static int completion_index_put_professor(CompletionIndex* index, const Professor* p, int keep_sorted) {
+    char buffer[COMPLETE_MAX_DISPLAY];
+    char key[COMPLETE_MAX_KEY];
+    snprintf(buffer, sizeof(buffer), "[ID:%d] %s %s", p->id, p->first_name, p->last_name);
+    const char* display = completion_index_store_display(index, buffer);
+    if (!display) return 0;
+
+    snprintf(key, sizeof(key), "%s %s", p->first_name, p->last_name);
+    if (!completion_index_put(index, COMPLETE_PROFESSOR, p->id, key, display, keep_sorted)) return 0;
+    snprintf(key, sizeof(key), "%s %s", p->last_name, p->first_name);
+    if (!completion_index_put(index, COMPLETE_PROFESSOR, p->id, key, display, keep_sorted)) return 0;
+    return completion_index_put(index, COMPLETE_PROFESSOR, p->id, p->email, display, keep_sorted);
+}
+
+static int completion_index_put_user(CompletionIndex* index, const User* u, int keep_sorted) {
+    const char* display = completion_index_store_display(index, u->username);
+    if (!display) return 0;
+    if (!completion_index_put(index, COMPLETE_USER, u->id, u->username, display, keep_sorted)) return 0;
+    return completion_index_put(index, COMPLETE_USER, u->id, u->email, display, keep_sorted);
+}
+
+// ============================================================================
+// INDEX LIFECYCLE
+// ============================================================================
+
+CompletionIndex* completion_index_create(void) {
+    CompletionIndex* index = (CompletionIndex*)calloc(1, sizeof(CompletionIndex));
+    if (!index) {
+        printf("[ERROR] Failed to create completion index\n");
+        return NULL;
+    }
+    index->text = arena_create("completion keys", ARENA_DEFAULT_BLOCK_SIZE);
+    if (!index->text) {
+        free(index);
+        return NULL;
+    }
+    return index;
+}
+
+void completion_index_destroy(CompletionIndex* index) {
+    if (!index) return;
+    arena_destroy(index->text);
+    free(index->entries);
+    free(index);
+}
+
+// Append every key, then sort once
+int completion_index_build(CompletionIndex* index, StudentList* students,
+                           ProfessorList* professors, UserList* users) {
+    if (!index) return 0;
+    index->count = 0;
+    arena_reset(index->text);
+
+    int ok = 1;
+    if (students) {
+        for (int i = 0; ok && i < students->count; i++) {
+            if (students->students[i].is_deleted) continue;
+            ok = completion_index_put_student(index, &students->students[i], 0);
+        }
+    }
+    if (professors) {
+        for (int i = 0; ok && i < professors->count; i++) {
+            ok = completion_index_put_professor(index, &professors->professors[i], 0);
+        }
+    }
+    if (users) {
+        for (int i = 0; ok && i < users->count; i++) {
+            if (users->users[i].is_deleted) continue;
+            ok = completion_index_put_user(index, &users->users[i], 0);
+        }
+    }
+
+    qsort(index->entries, index->count, sizeof(CompletionEntry), compare_completion_entries);
+    return ok;
+}
+
+// ============================================================================
+// MUTATIONS
+// ============================================================================
+
+int completion_index_add_student(CompletionIndex* index, const Student* student) {
+    if (!index || !student) return 0;
+    return completion_index_put_student(index, student, 1);
+}
+
+int completion_index_add_professor(CompletionIndex* index, const Professor* professor) {
+    if (!index || !professor) return 0;
+    return completion_index_put_professor(index, professor, 1);
+}
+
+int completion_index_add_user(CompletionIndex* index, const User* user) {
+    if (!index || !user) return 0;
+    return completion_index_put_user(index, user, 1);
+}
+
+// Drop every key of a record; edits are a remove followed by an add
+int completion_index_remove(CompletionIndex* index, int kind, int id) {
+    if (!index) return 0;
+
+    int kept = 0;
+    for (int i = 0; i < index->count; i++) {
+        CompletionEntry* entry = &index->entries[i];
+        if (entry->kind != kind || entry->id != id) {
+            index->entries[kept++] = *entry;
+        }
+    }
+
+    int removed = index->count - kept;
+    index->count = kept;
+    return removed > 0;
+}
+
+// ============================================================================
+// QUERIES
+// ============================================================================
+
+// Up to max_hits records whose keys start with the prefix, in key order,
+// one hit per record
+int completion_index_query(CompletionIndex* index, const char* prefix, int kinds,
+                           CompletionHit* hits, int max_hits) {
+    if (!index || !prefix || !hits || max_hits <= 0) return 0;
+
+    char folded[COMPLETE_MAX_KEY];
+    int len = search_fold_text(prefix, folded, sizeof(folded));
+    if (len == 0) return 0;
+
+    int count = 0;
+    for (int i = completion_index_lower_bound(index, folded);
+         i < index->count && count < max_hits && strncmp(index->entries[i].key, folded, len) == 0;
+         i++) {
+        CompletionEntry* entry = &index->entries[i];
+        if (!(entry->kind & kinds)) continue;
+
+        int duplicate = 0;
+        for (int j = 0; j < count && !duplicate; j++) {
+            duplicate = hits[j].id == entry->id && hits[j].kind == entry->kind;
+        }
+        if (duplicate) continue;
+
+        hits[count].id = entry->id;
+        hits[count].kind = entry->kind;
+        hits[count].display = entry->display;
+        count++;
+    }
+    return count;
+}
@@ -0,0 +1,539 @@
+#include "export.h"
+#include <stddef.h>
+#include <math.h>
+
+typedef enum {
+    COL_INT,            // int
+    COL_FLOAT,          // float
+    COL_TIME,           // time_t, written as seconds since the epoch
+    COL_CHARS,          // char array
+    COL_STRING,         // const char*
+    COL_INTERN,         // InternId
+    COL_EXAM_MODULE_ID, // the following read the exam id and look it up
+    COL_EXAM_MODULE,
+    COL_EXAM_DATE
+} ColumnType;
+
+typedef struct {
+    const char* name;
+    ColumnType type;
+    size_t offset;
+} ExportColumn;
+
+typedef struct {
+    const char* name;
+    const ExportColumn* columns;
+    int column_count;
+    size_t record_size;
+    int deleted_offset;         // -1 when the table has no tombstones
+} ExportTableInfo;
+
+#define COLUMN(rec, field, type, name) { name, type, offsetof(rec, field) }
+#define N_COLUMNS(columns) ((int)(sizeof(columns) / sizeof(columns[0])))
+
+static const ExportColumn student_columns[] = {
+    COLUMN(Student, id, COL_INT, "id"),
+    COLUMN(Student, first_name, COL_STRING, "first_name"),
+    COLUMN(Student, last_name, COL_STRING, "last_name"),
+    COLUMN(Student, email, COL_STRING, "email"),
+    COLUMN(Student, phone, COL_STRING, "phone"),
+    COLUMN(Student, address, COL_STRING, "address"),
+    COLUMN(Student, age, COL_INT, "age"),
+    COLUMN(Student, course, COL_INTERN, "course"),
+    COLUMN(Student, year, COL_INT, "year"),
+    COLUMN(Student, gpa, COL_FLOAT, "gpa"),
+    COLUMN(Student, enrollment_date, COL_TIME, "enrollment_date"),
+    COLUMN(Student, is_active, COL_INT, "active"),
+};
+
+static const ExportColumn grade_columns[] = {
+    COLUMN(Note, id_etudiant, COL_INT, "student_id"),
+    COLUMN(Note, id_examen, COL_INT, "exam_id"),
+    COLUMN(Note, id_examen, COL_EXAM_MODULE_ID, "module_id"),
+    COLUMN(Note, id_examen, COL_EXAM_MODULE, "module"),
+    COLUMN(Note, id_examen, COL_EXAM_DATE, "exam_date"),
+    COLUMN(Note, note_obtenue, COL_FLOAT, "grade"),
+    COLUMN(Note, present, COL_INT, "present"),
+};
+
+static const ExportColumn attendance_columns[] = {
+    COLUMN(AttendanceRecord, id, COL_INT, "id"),
+    COLUMN(AttendanceRecord, student_id, COL_INT, "student_id"),
+    COLUMN(AttendanceRecord, course_id, COL_INT, "course_id"),
+    COLUMN(AttendanceRecord, date, COL_TIME, "date"),
+    COLUMN(AttendanceRecord, status, COL_INT, "status"),
+    COLUMN(AttendanceRecord, reason, COL_CHARS, "reason"),
+    COLUMN(AttendanceRecord, teacher_id, COL_INT, "teacher_id"),
+    COLUMN(AttendanceRecord, recorded_time, COL_TIME, "recorded_time"),
+};
+
+static const ExportColumn club_columns[] = {
+    COLUMN(Club, id, COL_INT, "id"),
+    COLUMN(Club, name, COL_CHARS, "name"),
+    COLUMN(Club, description, COL_CHARS, "description"),
+    COLUMN(Club, category, COL_INTERN, "category"),
+    COLUMN(Club, president_id, COL_INT, "president_id"),
+    COLUMN(Club, advisor_id, COL_INT, "advisor_id"),
+    COLUMN(Club, member_count, COL_INT, "member_count"),
+    COLUMN(Club, max_members, COL_INT, "max_members"),
+    COLUMN(Club, founded_date, COL_TIME, "founded_date"),
+    COLUMN(Club, last_meeting, COL_TIME, "last_meeting"),
+    COLUMN(Club, meeting_day, COL_CHARS, "meeting_day"),
+    COLUMN(Club, meeting_time, COL_CHARS, "meeting_time"),
+    COLUMN(Club, meeting_location, COL_CHARS, "meeting_location"),
+    COLUMN(Club, budget, COL_FLOAT, "budget"),
+    COLUMN(Club, is_active, COL_INT, "active"),
+};
+
+static const ExportColumn membership_columns[] = {
+    COLUMN(ClubMembership, id, COL_INT, "id"),
+    COLUMN(ClubMembership, student_id, COL_INT, "student_id"),
+    COLUMN(ClubMembership, club_id, COL_INT, "club_id"),
+    COLUMN(ClubMembership, join_date, COL_TIME, "join_date"),
+    COLUMN(ClubMembership, role, COL_INTERN, "role"),
+    COLUMN(ClubMembership, is_active, COL_INT, "active"),
+};
+
+static const ExportColumn prof_note_columns[] = {
+    COLUMN(ProfessorNote, id, COL_INT, "id"),
+    COLUMN(ProfessorNote, student_id, COL_INT, "student_id"),
+    COLUMN(ProfessorNote, module_id, COL_INT, "module_id"),
+    COLUMN(ProfessorNote, professor_id, COL_INT, "professor_id"),
+    COLUMN(ProfessorNote, content, COL_CHARS, "content"),
+    COLUMN(ProfessorNote, date, COL_CHARS, "date"),
+};
+
+static const ExportTableInfo table_info[EXPORT_KIND_COUNT] = {
+    { "students", student_columns, N_COLUMNS(student_columns),
+      sizeof(Student), offsetof(Student, is_deleted) },
+    { "grades", grade_columns, N_COLUMNS(grade_columns),
+      sizeof(Note), offsetof(Note, is_deleted) },
+    { "attendance", attendance_columns, N_COLUMNS(attendance_columns),
+      sizeof(AttendanceRecord), offsetof(AttendanceRecord, is_deleted) },
+    { "clubs", club_columns, N_COLUMNS(club_columns), sizeof(Club), -1 },
+    { "memberships", membership_columns, N_COLUMNS(membership_columns),
+      sizeof(ClubMembership), offsetof(ClubMembership, is_deleted) },
+    { "prof_notes", prof_note_columns, N_COLUMNS(prof_note_columns), sizeof(ProfessorNote), -1 },
+};
+
+// ============================================================================
+// COLUMN LAYOUT
+// ============================================================================
+
+static int export_kind_valid(ExportKind kind) {
+    return (int)kind >= 0 && kind < EXPORT_KIND_COUNT;
+}
+
+const char* export_kind_name(ExportKind kind) {
+    return export_kind_valid(kind) ? table_info[kind].name : NULL;
+}
+
+int export_kind_from_name(const char* name) {
+    for (int kind = 0; name != NULL && kind < EXPORT_KIND_COUNT; kind++) {
+        if (strcmp(table_info[kind].name, name) == 0) return kind;
+    }
+    return -1;
+}
+
+int export_kind_n_columns(ExportKind kind) {
+    return export_kind_valid(kind) ? table_info[kind].column_count : 0;
+}
+
+const char* export_kind_column_name(ExportKind kind, int column) {
+    if (column < 0 || column >= export_kind_n_columns(kind)) return NULL;
+    return table_info[kind].columns[column].name;
+}
+
+// Turn "id,email" into column indices; NULL or "" selects every column
+static int export_parse_columns(const ExportTableInfo* info, const char* spec, int* selected) {
+    if (spec == NULL || spec[0] == '\0') {
+        for (int i = 0; i < info->column_count; i++) selected[i] = i;
+        return info->column_count;
+    }
+
+    int count = 0;
+    const char* p = spec;
+    while (*p) {
+        const char* end = strchr(p, ',');
+        size_t len = end ? (size_t)(end - p) : strlen(p);
+        while (len > 0 && *p == ' ') { p++; len--; }
+        while (len > 0 && p[len - 1] == ' ') len--;
+
+        int found = -1;
+        for (int i = 0; i < info->column_count; i++) {
+            if (strlen(info->columns[i].name) == len && strncmp(info->columns[i].name, p, len) == 0) {
+                found = i;
+                break;
+            }
+        }
+        if (found < 0 || count >= EXPORT_MAX_COLUMNS) {
+            printf("[ERROR] Unknown or too many export columns for %s: '%.*s'\n", info->name, (int)len, p);
+            return 0;
+        }
+        selected[count++] = found;
+        if (!end) break;
+        p = end + 1;
+    }
+    return count;
+}
+
+int export_columns_check(ExportKind kind, const char* columns) {
+    int selected[EXPORT_MAX_COLUMNS];
+    return export_kind_valid(kind) && export_parse_columns(&table_info[kind], columns, selected) > 0;
+}
+
+// ============================================================================
+// EXAM INDEX
+// ============================================================================
+
+static int export_exam_compare(const void* a, const void* b) {
+    int x = ((const ExportExam*)a)->exam_id;
+    int y = ((const ExportExam*)b)->exam_id;
+    return (x > y) - (x < y);
+}
+
+ExportExamIndex* export_exam_index_build(liste_examen* exams, ListeModules* modules) {
+    ExportExamIndex* index = (ExportExamIndex*)calloc(1, sizeof(ExportExamIndex));
+    if (index == NULL) {
+        printf("[ERROR] Failed to allocate exam index\n");
+        return NULL;
+    }
+    if (exams == NULL || exams->count == 0) return index;
+
+    index->exams = (ExportExam*)calloc(exams->count, sizeof(ExportExam));
+    if (index->exams == NULL) {
+        printf("[ERROR] Failed to allocate exam index\n");
+        free(index);
+        return NULL;
+    }
+
+    for (int i = 0; i < exams->count; i++) {
+        Examen* exam = &exams->exam[i];
+        ExportExam* entry = &index->exams[index->count++];
+        entry->exam_id = exam->id_examen;
+        entry->module_id = exam->id_module;
+        entry->date = exam->date_examen;
+
+        // Prefer the module's full name; the exam only keeps a short copy
+        const char* name = exam->nom_module;
+        for (int m = 0; modules != NULL && m < modules->count; m++) {
+            if (modules->cours[m].id == exam->id_module && !modules->cours[m].is_deleted) {
+                name = modules->cours[m].nom;
+                break;
+            }
+        }
+        snprintf(entry->module_name, sizeof(entry->module_name), "%s", name);
+    }
+    qsort(index->exams, index->count, sizeof(ExportExam), export_exam_compare);
+    return index;
+}
+
+void export_exam_index_destroy(ExportExamIndex* index) {
+    if (index == NULL) return;
+    free(index->exams);
+    free(index);
+}
+
+static const ExportExam* export_exam_find(const ExportExamIndex* index, int exam_id) {
+    if (index == NULL || index->count == 0) return NULL;
+    ExportExam key;
+    key.exam_id = exam_id;
+    return (const ExportExam*)bsearch(&key, index->exams, index->count, sizeof(ExportExam), export_exam_compare);
+}
+
+// ============================================================================
+// OUTPUT BUFFER
+// ============================================================================
+
+typedef struct {
+    FILE* out;
+    char* data;
+    size_t used;
+    int failed;                 // a write to out failed
+} ExportBuffer;
+
+static void buffer_flush(ExportBuffer* b) {
+    if (b->used > 0 && !b->failed && fwrite(b->data, 1, b->used, b->out) != b->used) {
+        b->failed = 1;
+    }
+    b->used = 0;
+}
+
+static void buffer_put(ExportBuffer* b, const char* s, size_t n) {
+    while (n > 0) {
+        if (b->used == EXPORT_BUFFER_SIZE) buffer_flush(b);
+        size_t chunk = EXPORT_BUFFER_SIZE - b->used;
+        if (chunk > n) chunk = n;
+        memcpy(b->data + b->used, s, chunk);
+        b->used += chunk;
+        s += chunk;
+        n -= chunk;
+    }
+}
+
+static void buffer_putc(ExportBuffer* b, char c) {
+    if (b->used == EXPORT_BUFFER_SIZE) buffer_flush(b);
+    b->data[b->used++] = c;
+}
+
+static void buffer_put_int(ExportBuffer* b, long long value) {
+    char digits[24];
+    int n = sizeof(digits);
+    unsigned long long v = value < 0 ? 0ULL - (unsigned long long)value : (unsigned long long)value;
+    do {
+        digits[--n] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v > 0);
+    if (value < 0) digits[--n] = '-';
+    buffer_put(b, digits + n, sizeof(digits) - n);
+}
+
+// ============================================================================
+// FIELD ENCODING
+// ============================================================================
+
+// RFC 4180: quote a field holding a comma, quote or line break, and double
+// the quotes inside it
+static void csv_put_text(ExportBuffer* b, const char* s) {
+    size_t len = strlen(s);
+    if (strcspn(s, ",\"\r\n") == len) {
+        buffer_put(b, s, len);
+        return;
+    }
+
+    buffer_putc(b, '"');
+    for (const char* p = s; *p; p++) {
+        if (*p == '"') buffer_putc(b, '"');
+        buffer_putc(b, *p);
+    }
+    buffer_putc(b, '"');
+}
+
+static void json_put_text(ExportBuffer* b, const char* s) {
+    static const char hex[] = "0123456789abcdef";
+    buffer_putc(b, '"');
+    for (const unsigned char* p = (const unsigned char*)s; *p; p++) {
+        switch (*p) {
+            case '"':  buffer_put(b, "\\\"", 2); break;
+            case '\\': buffer_put(b, "\\\\", 2); break;
+            case '\n': buffer_put(b, "\\n", 2); break;
+            case '\r': buffer_put(b, "\\r", 2); break;
+            case '\t': buffer_put(b, "\\t", 2); break;
+            default:
+                if (*p < 0x20) {
+                    char escape[6] = { '\\', 'u', '0', '0', hex[*p >> 4], hex[*p & 15] };
+                    buffer_put(b, escape, sizeof(escape));
+                } else {
+                    buffer_putc(b, (char)*p);
+                }
+        }
+    }
+    buffer_putc(b, '"');
+}
+
+static void put_text(ExportBuffer* b, ExportFormat format, const char* s) {
+    if (format == EXPORT_NDJSON) json_put_text(b, s ? s : "");
+    else csv_put_text(b, s ? s : "");
+}
+
+// A missing value: an empty CSV field or JSON null
+static void put_null(ExportBuffer* b, ExportFormat format) {
+    if (format == EXPORT_NDJSON) buffer_put(b, "null", 4);
+}
+
+static void put_float(ExportBuffer* b, ExportFormat format, double value) {
+    if (isnan(value) || isinf(value)) {
+        put_null(b, format);
+        return;
+    }
+    char text[32];
+    int n = snprintf(text, sizeof(text), "%g", value);
+    buffer_put(b, text, n);
+}
+
+static void put_field(ExportBuffer* b, const ExportOptions* options, const ExportColumn* column,
+                      const char* record) {
+    const void* field = record + column->offset;
+    const ExportExam* exam = NULL;
+    if (column->type >= COL_EXAM_MODULE_ID) {
+        exam = export_exam_find(options->exams, *(const int*)field);
+        if (exam == NULL) {
+            put_null(b, options->format);
+            return;
+        }
+    }
+
+    switch (column->type) {
+        case COL_INT:      buffer_put_int(b, *(const int*)field); break;
+        case COL_FLOAT:    put_float(b, options->format, *(const float*)field); break;
+        case COL_TIME:     buffer_put_int(b, (long long)*(const time_t*)field); break;
+        case COL_CHARS:    put_text(b, options->format, (const char*)field); break;
+        case COL_STRING:   put_text(b, options->format, *(const char* const*)field); break;
+        case COL_INTERN:   put_text(b, options->format, intern_lookup(*(const InternId*)field)); break;
+        case COL_EXAM_MODULE_ID: buffer_put_int(b, exam->module_id); break;
+        case COL_EXAM_MODULE:    put_text(b, options->format, exam->module_name); break;
+        case COL_EXAM_DATE:      buffer_put_int(b, (long long)exam->date); break;
+    }
+}
+
+static void put_row(ExportBuffer* b, const ExportOptions* options, const ExportTableInfo* info,
+                    const int* selected, int selected_count, const char* record) {
+    if (options->format == EXPORT_NDJSON) buffer_putc(b, '{');
+    for (int c = 0; c < selected_count; c++) {
+        const ExportColumn* column = &info->columns[selected[c]];
+        if (c > 0) buffer_putc(b, ',');
+        if (options->format == EXPORT_NDJSON) {
+            json_put_text(b, column->name);
+            buffer_putc(b, ':');
+        }
+        put_field(b, options, column, record);
+    }
+    if (options->format == EXPORT_NDJSON) buffer_put(b, "}\n", 2);
+    else buffer_put(b, "\r\n", 2);
+}
+
+// ============================================================================
+// EXPORT
+// ============================================================================
+
+// The table's lock; set once at start, so it may be read before locking
+static TableLock* export_table_lock(ExportKind kind, const void* table) {
+    switch (kind) {
+        case EXPORT_STUDENTS: return ((const StudentList*)table)->lock;
+        case EXPORT_GRADES: return ((const liste_note*)table)->lock;
+        case EXPORT_ATTENDANCE: return ((const AttendanceList*)table)->lock;
+        case EXPORT_CLUBS: return ((const ClubList*)table)->lock;
+        case EXPORT_MEMBERSHIPS: return ((const MembershipList*)table)->lock;
+        case EXPORT_PROF_NOTES: return ((const ProfessorNoteList*)table)->lock;
+        default: return NULL;
+    }
+}
+
+// Records and count; call with the read lock held, as adding a record may
+// move the array
+static void export_table_source(ExportKind kind, const void* table, const char** records, int* count) {
+    *records = NULL;
+    *count = 0;
+    switch (kind) {
+        case EXPORT_STUDENTS: {
+            const StudentList* list = (const StudentList*)table;
+            *records = (const char*)list->students; *count = list->count;
+            break;
+        }
+        case EXPORT_GRADES: {
+            const liste_note* list = (const liste_note*)table;
+            *records = (const char*)list->note; *count = list->count;
+            break;
+        }
+        case EXPORT_ATTENDANCE: {
+            const AttendanceList* list = (const AttendanceList*)table;
+            *records = (const char*)list->records; *count = list->count;
+            break;
+        }
+        case EXPORT_CLUBS: {
+            const ClubList* list = (const ClubList*)table;
+            *records = (const char*)list->clubs; *count = list->count;
+            break;
+        }
+        case EXPORT_MEMBERSHIPS: {
+            const MembershipList* list = (const MembershipList*)table;
+            *records = (const char*)list->memberships; *count = list->count;
+            break;
+        }
+        case EXPORT_PROF_NOTES: {
+            const ProfessorNoteList* list = (const ProfessorNoteList*)table;
+            *records = (const char*)list->notes; *count = list->count;
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+int export_table_to_stream(const void* table, const ExportOptions* options, FILE* out, int* rows_written) {
+    if (rows_written) *rows_written = 0;
+    if (table == NULL || options == NULL || out == NULL || !export_kind_valid(options->kind)) {
+        printf("[ERROR] Invalid export arguments\n");
+        return 0;
+    }
+
+    const ExportTableInfo* info = &table_info[options->kind];
+    int selected[EXPORT_MAX_COLUMNS];
+    int selected_count = export_parse_columns(info, options->columns, selected);
+    if (selected_count == 0) return 0;
+
+    ExportBuffer buffer = { out, (char*)malloc(EXPORT_BUFFER_SIZE), 0, 0 };
+    if (buffer.data == NULL) {
+        printf("[ERROR] Failed to allocate export buffer\n");
+        return 0;
+    }
+
+    if (options->format == EXPORT_CSV) {
+        for (int c = 0; c < selected_count; c++) {
+            if (c > 0) buffer_putc(&buffer, ',');
+            csv_put_text(&buffer, info->columns[selected[c]].name);
+        }
+        buffer_put(&buffer, "\r\n", 2);
+    }
+
+    const char* records;
+    int count;
+    TableLock* lock = export_table_lock(options->kind, table);
+    int rows = 0;
+    int stopped = 0;
+
+    table_lock_read(lock);
+    export_table_source(options->kind, table, &records, &count);
+    if (records == NULL) count = 0;
+    for (int i = 0; i < count && !buffer.failed; i++) {
+        const char* record = records + (size_t)i * info->record_size;
+        if (info->deleted_offset >= 0 && *(const int*)(record + info->deleted_offset)) continue;
+        if (options->filter && !options->filter(record, options->user_data)) continue;
+
+        put_row(&buffer, options, info, selected, selected_count, record);
+        rows++;
+
+        if (options->progress && (i + 1) % EXPORT_PROGRESS_ROWS == 0 &&
+            !options->progress(i + 1, count, options->user_data)) {
+            stopped = 1;
+            break;
+        }
+    }
+    table_unlock_read(lock);
+
+    buffer_flush(&buffer);
+    free(buffer.data);
+    if (fflush(out) != 0) buffer.failed = 1;
+
+    if (buffer.failed) {
+        printf("[ERROR] Failed to write the %s export\n", info->name);
+        return 0;
+    }
+    if (rows_written) *rows_written = rows;
+    return !stopped;
+}
+
+int export_table_to_file(const void* table, const ExportOptions* options, const char* filename, int* rows_written) {
+    if (rows_written) *rows_written = 0;
+    if (filename == NULL) {
+        printf("[ERROR] No export file given\n");
+        return 0;
+    }
+
+    // Binary mode keeps the CRLF line ends of CSV as they are
+    FILE* file = fopen(filename, "wb");
+    if (file == NULL) {
+        printf("[ERROR] Could not open %s for export\n", filename);
+        return 0;
+    }
+    // Rows are already buffered in EXPORT_BUFFER_SIZE blocks
+    setvbuf(file, NULL, _IONBF, 0);
+
+    int ok = export_table_to_stream(table, options, file, rows_written);
+    if (fclose(file) != 0) ok = 0;
+    if (!ok) {
+        remove(filename);
+        if (rows_written) *rows_written = 0;
+    }
+    return ok;
+}
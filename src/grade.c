@@ -1,6 +1,5 @@
 #include "student.h"
 #include "config.h"
-#include "ui.h"
 #include "file_manager.h"
 // #include "report.h"  // Commented out - file doesn't exist
 #include "stats.h"
@@ -8,8 +7,10 @@
 #include "attendance.h"
 #include "grade.h"
 #include "utils.h"
+#include "changelog.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <stddef.h>
 #include <string.h>
 #include <time.h>
 
@@ -355,6 +356,9 @@ liste_note* creer_liste_note(int capacite) {
     liste->count = 0;
     liste->capacity = capacite;
     strcpy(liste->file_name, "liste_des_notes.txt");
+    memset(&liste->tombstones, 0, sizeof(Tombstones));
+    liste->dirty = 0;
+    liste->lock = NULL;
 
     return liste;
 }
@@ -391,6 +395,15 @@ Note* cree_note() {
 int note_ajouter(liste_note *liste, Note *n) {
     if (liste == NULL || n == NULL) return 0;
 
+    table_lock_write(liste->lock);
+    int ok = note_ajouter_locked(liste, n);
+    table_unlock_write(liste->lock);
+    if (ok) free(n);
+    return ok;
+}
+
+// Appends a copy of n, for a caller that holds the write lock over a batch
+int note_ajouter_locked(liste_note *liste, const Note *n) {
     if (liste->count >= liste->capacity) {
         liste->capacity *= 2;
         liste->note = (Note*)realloc(liste->note,
@@ -398,8 +411,11 @@ int note_ajouter(liste_note *liste, Note *n) {
         if (liste->note == NULL) return 0;
     }
 
-    liste->note[liste->count++] = *n;
-    free(n);
+    liste->note[liste->count] = *n;
+    liste->note[liste->count].is_deleted = 0;
+    liste->count++;
+    liste->dirty = 1;
+    changelog_record(liste->lock, CHANGE_GRADES, CHANGE_INSERT, &liste->note[liste->count - 1]);
     return 1;
 }
 
@@ -422,7 +438,7 @@ void afficher_liste_notes(liste_note *liste) {
         return;
     }
 
-    if (liste->count == 0) {
+    if (liste->count - liste->tombstones.dead == 0) {
         printf("\nNo grades to display.\n");
         return;
     }
@@ -432,17 +448,19 @@ void afficher_liste_notes(liste_note *liste) {
     printf("+--------------+------------+--------------+----------+\n");
 
     for (int i = 0; i < liste->count; i++) {
+        if (liste->note[i].is_deleted) continue;
         afficher_note(&liste->note[i]);
     }
 
     printf("+--------------+------------+--------------+----------+\n");
-    printf("Total: %d note(s)\n\n", liste->count);
+    printf("Total: %d note(s)\n\n", liste->count - liste->tombstones.dead);
 }
 
 Note* chercher_note(liste_note *liste, int id_etudiant, int id_examen) {
     if (liste == NULL) return NULL;
 
     for (int i = 0; i < liste->count; i++) {
+        if (liste->note[i].is_deleted) continue;
         if (liste->note[i].id_etudiant == id_etudiant &&
             liste->note[i].id_examen == id_examen) {
             return &liste->note[i];
@@ -464,6 +482,7 @@ void afficher_notes_etudiant(liste_note *liste, int id_etudiant) {
     printf("+--------------+------------+--------------+----------+\n");
 
     for (int i = 0; i < liste->count; i++) {
+        if (liste->note[i].is_deleted) continue;
         if (liste->note[i].id_etudiant == id_etudiant) {
             afficher_note(&liste->note[i]);
             trouve = 1;
@@ -489,6 +508,7 @@ void afficher_notes_examen(liste_note *liste, int id_examen) {
     printf("+--------------+------------+--------------+----------+\n");
 
     for (int i = 0; i < liste->count; i++) {
+        if (liste->note[i].is_deleted) continue;
         if (liste->note[i].id_examen == id_examen) {
             afficher_note(&liste->note[i]);
             trouve = 1;
@@ -562,25 +582,60 @@ void modifier_note(liste_note *liste) {
             return;
     }
 
+    liste->dirty = 1;
     printf(" Grade successfully modified!\n");
 }
 
 
+// Only flags the grade: the grades after it keep their index (the grade
+// view is keyed by it) until the list is compacted
 int note_supprimer(liste_note *liste, int id_etudiant, int id_examen) {
     if (liste == NULL || liste->count == 0) return 0;
 
-    for (int i = 0; i < liste->count; i++) {
-        if (liste->note[i].id_etudiant == id_etudiant &&
-            liste->note[i].id_examen == id_examen) {
+    Note *n = chercher_note(liste, id_etudiant, id_examen);
+    if (n == NULL) return 0;
+    table_lock_write(liste->lock);
+    liste->dirty = 1;
+    int supprimee = tombstones_mark(&liste->tombstones, &n->is_deleted, liste->count);
+    if (supprimee) changelog_record(liste->lock, CHANGE_GRADES, CHANGE_DELETE, n);
+    table_unlock_write(liste->lock);
+    return supprimee;
+}
 
-            for (int j = i; j < liste->count - 1; j++) {
-                liste->note[j] = liste->note[j + 1];
-            }
-            liste->count--;
-            return 1;
+// Squeeze out deleted grades. Returns the number dropped.
+int liste_note_compacter(liste_note *liste) {
+    if (liste == NULL || liste->note == NULL) return 0;
+
+    table_lock_write(liste->lock);
+    int ancien = liste->count;
+    liste->count = tombstones_compact(&liste->tombstones, liste->note, sizeof(Note),
+                                      offsetof(Note, is_deleted), liste->count);
+    table_unlock_write(liste->lock);
+    return ancien - liste->count;
+}
+
+int liste_note_compacter_si_besoin(liste_note *liste) {
+    if (liste == NULL || !tombstones_should_compact(&liste->tombstones, liste->count)) return 0;
+    return liste_note_compacter(liste);
+}
+
+// Copy of the live grades, safe to take from any thread while the
+// original keeps changing
+liste_note* liste_note_copier(const liste_note *liste) {
+    if (liste == NULL) return NULL;
+
+    table_lock_read(liste->lock);
+    int vivantes = liste->count - liste->tombstones.dead;
+    liste_note *copie = creer_liste_note(vivantes > 0 ? vivantes : 1);
+    if (copie != NULL) {
+        for (int i = 0; i < liste->count; i++) {
+            if (liste->note[i].is_deleted) continue;
+            copie->note[copie->count++] = liste->note[i];
         }
+        strcpy(copie->file_name, liste->file_name);
     }
-    return 0;
+    table_unlock_read(liste->lock);
+    return copie;
 }
 float calculer_moyenne_etudiant(liste_note *liste, int id_etudiant) {
     if (liste == NULL || liste->count == 0) return -1;
@@ -589,6 +644,7 @@ float calculer_moyenne_etudiant(liste_note *liste, int id_etudiant) {
     int count = 0;
 
     for (int i = 0; i < liste->count; i++) {
+        if (liste->note[i].is_deleted) continue;
         if (liste->note[i].id_etudiant == id_etudiant &&
             liste->note[i].present == 1) {
             somme += liste->note[i].note_obtenue;
@@ -606,6 +662,7 @@ float calculer_moyenne_examen(liste_note *liste, int id_examen) {
     int count = 0;
 
     for (int i = 0; i < liste->count; i++) {
+        if (liste->note[i].is_deleted) continue;
         if (liste->note[i].id_examen == id_examen &&
             liste->note[i].present == 1) {
             somme += liste->note[i].note_obtenue;
@@ -626,6 +683,7 @@ void statistiques_examen(liste_note *liste, int id_examen) {
     int count = 0, presents = 0, absents = 0, admis = 0;
 
     for (int i = 0; i < liste->count; i++) {
+        if (liste->note[i].is_deleted) continue;
         if (liste->note[i].id_examen == id_examen) {
             if (liste->note[i].present) {
                 presents++;
@@ -670,6 +728,9 @@ int sauvegarder_notes_ds_file(liste_note *liste) {
         return 0;
     }
 
+    // Deleted grades are never written; squeeze them out if enough piled up
+    liste_note_compacter_si_besoin(liste);
+
     FILE *p = fopen(full_path, "w");
     if (p == NULL) {
         printf("Error opening file!\n");
@@ -677,6 +738,7 @@ int sauvegarder_notes_ds_file(liste_note *liste) {
     }
 
     for (int i = 0; i < liste->count; i++) {
+        if (liste->note[i].is_deleted) continue;
         int written = fprintf(p, "%d,%d,%.2f,%d\n",
                 liste->note[i].id_etudiant,
                 liste->note[i].id_examen,
@@ -691,7 +753,7 @@ int sauvegarder_notes_ds_file(liste_note *liste) {
 
     fflush(p);
     fclose(p);
-    printf(" %d note(s) sauvegardee(s)\n", liste->count);
+    printf(" %d note(s) sauvegardee(s)\n", liste->count - liste->tombstones.dead);
     return 1;
 }
 int charger_notes_depuis_file(liste_note *liste) {
@@ -708,6 +770,19 @@ int charger_notes_depuis_file(liste_note *liste) {
         printf("Error opening file!\n");
         return 0;
     }
+    table_lock_write(liste->lock);
+    // Size the table for the whole file instead of stopping at capacity
+    long lignes = utils_file_count_lines(p);
+    if (lignes > liste->capacity) {
+        Note *notes = (Note*)realloc(liste->note, lignes * sizeof(Note));
+        if (notes == NULL) {
+            table_unlock_write(liste->lock);
+            fclose(p);
+            return 0;
+        }
+        liste->note = notes;
+        liste->capacity = (int)lignes;
+    }
 int i=0;
    while(i<liste->capacity){
         int n=fscanf(p, "%d,%d,%f,%d",
@@ -716,17 +791,25 @@ int i=0;
                            &liste->note[i].note_obtenue,
                            &liste->note[i].present);
         if(n!=4) break;
+        liste->note[i].is_deleted = 0;
         i++;
    }
   liste->count=i;
+  liste->tombstones.dead=0;
+  liste->dirty=0;
+    table_unlock_write(liste->lock);
     fclose(p);
     printf(" %d grade(s) loaded\n", liste->count);
     return 1;
 }
 
 void trier_notes_par_etudiant(liste_note *liste) {
-    if (liste == NULL || liste->count <= 1) return;
+    if (liste == NULL) return;
+    // Sorting moves every grade anyway, so drop deleted ones first
+    liste_note_compacter(liste);
+    if (liste->count <= 1) return;
 
+    table_lock_write(liste->lock);
     for (int i = 0; i < liste->count - 1; i++) {
         for (int j = i + 1; j < liste->count; j++) {
             if (liste->note[j].id_etudiant < liste->note[i].id_etudiant) {
@@ -736,6 +819,7 @@ void trier_notes_par_etudiant(liste_note *liste) {
             }
         }
     }
+    table_unlock_write(liste->lock);
     printf("List sorted by student ID\n");
 }
 
@@ -747,6 +831,8 @@ void detruire_liste_notes(liste_note **liste) {
     (*liste)->note = NULL;
     (*liste)->count = 0;
     (*liste)->capacity = 0;
+    tombstones_free(&(*liste)->tombstones);
+    table_lock_destroy((*liste)->lock);
     free(*liste);
     *liste = NULL;
 
@@ -768,7 +854,9 @@ void detruire_liste_notes(liste_note **liste) {
     printf("Which major does it concern:\n1-PREPARATORY_YEARS_TO_ENGINEERING_CYCLE.\n2-COMPUTER_ENGINEERING.\n3-CIVIL_ENGINEERING.\n4-WATER_ENVIRONMENT_ENGINEERING.\n5-ENERGETIC_ENGINEERING.\n6-MECHANICAL_ENGINEERING \n num:");scanf("%d",&cour->filiere);
           }  while((cour->filiere>6)||(cour->filiere<1));
    printf("For which semester:\t");scanf("%d",&cour->semestre);
-       printf("Teacher's full name:\t");scanf(" %[^\n]",cour->nom_prenom_enseignent);
+       char teacher[50];
+       printf("Teacher's full name:\t");scanf(" %49[^\n]",teacher);
+       cour->nom_prenom_enseignent=intern_string(teacher);
        return(cour);
 
 }
@@ -779,6 +867,9 @@ ListeModules* liste_cours_creer(){
     coursliste->count=0;
    coursliste->capacity=300;
    strcpy(coursliste->filename,"liste_des_modules.txt");
+   memset(&coursliste->tombstones,0,sizeof(Tombstones));
+   coursliste->dirty=0;
+   coursliste->lock=NULL;
    return(coursliste);
 }
 void liste_cours_detruire(ListeModules** liste){
@@ -787,12 +878,18 @@ void liste_cours_detruire(ListeModules** liste){
     (*liste)->cours=NULL;
     (*liste)->count=0;
     (*liste)->capacity=0;
+    tombstones_free(&(*liste)->tombstones);
+    table_lock_destroy((*liste)->lock);
     free(*liste);
     (*liste)=NULL;
 }
 int cours_ajouter(ListeModules* liste, Module cours){
    if(liste->count<liste->capacity){
+    table_lock_write(liste->lock);
+    cours.is_deleted=0;
     (liste)->cours[liste->count++] =cours;
+    liste->dirty=1;
+    table_unlock_write(liste->lock);
     return(1);}
 
 return(0);
@@ -800,11 +897,12 @@ return(0);
 int cours_supprimer_par_nom(ListeModules* liste, char* cours_nom){
 if(liste->count!=0){
         for(int i=0;i<liste->count;i++){
-            if(strcmp((liste)->cours[i].nom,cours_nom)==0){
-                 for(int j=i;j<liste->count-1;j++)
-                   (liste)->cours[j]=(liste)->cours[j+1];
-                 liste->count--;
-                 return(1);
+            if(!liste->cours[i].is_deleted && strcmp((liste)->cours[i].nom,cours_nom)==0){
+                 table_lock_write(liste->lock);
+                 liste->dirty=1;
+                 int supprime=tombstones_mark(&liste->tombstones,&liste->cours[i].is_deleted,liste->count);
+                 table_unlock_write(liste->lock);
+                 return(supprime);
             }
         }
 
@@ -814,22 +912,58 @@ return(0);
 }
 int cours_supprimer_par_id(ListeModules *liste, int cours_id){
 if(liste->count!=0){
-        for(int i=0;i<liste->count;i++){
-            if(liste->cours[i].id==cours_id){
-                 for(int j=i;j<liste->count-1;j++)
-                   (liste)->cours[j]=(liste)->cours[j+1];
-                 liste->count--;
-                 return(1);
-            }
+        // Only flag the module; the ones after it keep their slots until compaction
+        Module* m=cours_rechercher_par_id(liste,cours_id);
+        if(m!=NULL){
+            table_lock_write(liste->lock);
+            liste->dirty=1;
+            int supprime=tombstones_mark(&liste->tombstones,&m->is_deleted,liste->count);
+            table_unlock_write(liste->lock);
+            return(supprime);
         }
 
     }
 
 return(0);
 }
+// Squeeze out deleted modules. Returns the number dropped.
+int liste_cours_compacter(ListeModules *liste){
+    if(liste==NULL || liste->cours==NULL) return(0);
+    table_lock_write(liste->lock);
+    int ancien=liste->count;
+    liste->count=tombstones_compact(&liste->tombstones,liste->cours,sizeof(Module),
+                                    offsetof(Module,is_deleted),liste->count);
+    table_unlock_write(liste->lock);
+    return(ancien-liste->count);
+}
+int liste_cours_compacter_si_besoin(ListeModules *liste){
+    if(liste==NULL || !tombstones_should_compact(&liste->tombstones,liste->count)) return(0);
+    return liste_cours_compacter(liste);
+}
+// Copy of the live modules, safe to take from any thread
+ListeModules* liste_cours_copier(const ListeModules *liste){
+    if(liste==NULL) return(NULL);
+    ListeModules* copie=(ListeModules*)calloc(1,sizeof(ListeModules));
+    if(copie==NULL) return(NULL);
+    table_lock_read(liste->lock);
+    copie->capacity=liste->count>0 ? liste->count : 1;
+    copie->cours=(Module*)malloc(sizeof(Module)*copie->capacity);
+    if(copie->cours==NULL){
+        table_unlock_read(liste->lock);
+        free(copie);
+        return(NULL);
+    }
+    for(int i=0;i<liste->count;i++){
+        if(!liste->cours[i].is_deleted)
+            copie->cours[copie->count++]=liste->cours[i];
+    }
+    strcpy(copie->filename,liste->filename);
+    table_unlock_read(liste->lock);
+    return(copie);
+}
 Module* cours_rechercher_par_id(ListeModules* liste, int cours_id){
     for(int i=0;i<liste->count;i++){
-        if(liste->cours[i].id==cours_id)
+        if(liste->cours[i].id==cours_id && !liste->cours[i].is_deleted)
             return(&liste->cours[i]);
     }
 return(NULL);
@@ -850,7 +984,7 @@ else{
         m->heures_td,
         m->heures_tp,
         m->semestre,
-        m->nom_prenom_enseignent,
+        intern_lookup(m->nom_prenom_enseignent),
         m->filiere,
         m->niveau
     );
@@ -864,7 +998,7 @@ void liste_cours_afficher(ListeModules* liste){
         return;
     }
 
-    if (liste->count == 0) {
+    if (liste->count - liste->tombstones.dead == 0) {
         printf("No modules to display.\n");
         return;
     }
@@ -874,6 +1008,7 @@ void liste_cours_afficher(ListeModules* liste){
     printf("+-----+-------------------------+----------+----------+----------+-----+-----------------------------+-----------+-----------+\n");
     for (int i = 0; i < liste->count; i++) {
         Module* m = &liste->cours[i];
+        if (m->is_deleted) continue;
         printf("| %-3d | %-23s | %-8d | %-8d | %-8d | %-3d | %-27s | %-9d | %-9d |\n",
             m->id,
             m->nom,
@@ -881,7 +1016,7 @@ void liste_cours_afficher(ListeModules* liste){
             m->heures_td,
             m->heures_tp,
             m->semestre,
-            m->nom_prenom_enseignent,
+            intern_lookup(m->nom_prenom_enseignent),
             m->filiere,
             m->niveau
         );
@@ -893,7 +1028,7 @@ void cours_afficher_depuis_un_liste_par_id(ListeModules liste,int id){
         return;
     }
     for (int i = 0; i < liste.count; i++) {
-            if(liste.cours[i].id==id){ Module m = liste.cours[i];
+            if(liste.cours[i].id==id && !liste.cours[i].is_deleted){ Module m = liste.cours[i];
              printf("\n+-----+-------------------------+----------+----------+----------+-----+-----------------------------+-----------+-----------+\n");
     printf("| ID  | Name                     | Course(h) | Tutorial(h) | Practical(h) | Sem | Teacher                    | Major     | Level     |\n");
     printf("+-----+-------------------------+----------+----------+----------+-----+-----------------------------+-----------+-----------+\n");
@@ -904,7 +1039,7 @@ void cours_afficher_depuis_un_liste_par_id(ListeModules liste,int id){
             m.heures_td,
             m.heures_tp,
             m.semestre,
-            m.nom_prenom_enseignent,
+            intern_lookup(m.nom_prenom_enseignent),
             m.filiere,
             m.niveau
         ); return;}
@@ -918,7 +1053,7 @@ void cours_afficher_depuis_un_liste_par_nom(ListeModules liste,char *nom){
         return;
     }
     for (int i = 0; i < liste.count; i++) {
-            if(strcmp(liste.cours[i].nom,nom)==0){ Module m = liste.cours[i];
+            if(!liste.cours[i].is_deleted && strcmp(liste.cours[i].nom,nom)==0){ Module m = liste.cours[i];
              printf("\n+-----+-------------------------+----------+----------+----------+-----+-----------------------------+-----------+-----------+\n");
     printf("| ID  | Name                     | Course(h) | Tutorial(h) | Practical(h) | Sem | Teacher                    | Major     | Level     |\n");
     printf("+-----+-------------------------+----------+----------+----------+-----+-----------------------------+-----------+-----------+\n");
@@ -929,7 +1064,7 @@ void cours_afficher_depuis_un_liste_par_nom(ListeModules liste,char *nom){
             m.heures_td,
             m.heures_tp,
             m.semestre,
-            m.nom_prenom_enseignent,
+            intern_lookup(m.nom_prenom_enseignent),
             m.filiere,
             m.niveau
         ); return;}
@@ -938,7 +1073,7 @@ void cours_afficher_depuis_un_liste_par_nom(ListeModules liste,char *nom){
 }
 Module* chercher_module_par_nom(ListeModules liste,char* nom){
   for(int i=0;i<liste.count;i++){
-    if(strcmp((liste.cours[i].nom),nom)==0)
+    if(!liste.cours[i].is_deleted && strcmp((liste.cours[i].nom),nom)==0)
     {
         return(&liste.cours[i]);
     }
@@ -948,7 +1083,7 @@ Module* chercher_module_par_nom(ListeModules liste,char* nom){
 }
 Module* chercher_module_par_id(ListeModules liste,int id){
   for(int i=0;i<liste.count;i++){
-    if(liste.cours[i].id==id)
+    if(liste.cours[i].id==id && !liste.cours[i].is_deleted)
     {
         return(&liste.cours[i]);
     }
@@ -1013,8 +1148,12 @@ void modidier_cours(ListeModules liste){
             scanf("%d", &m->semestre);
             break;
         case 10:
+            {
+            char teacher[50];
             printf("New teacher's name and surname: ");
-             scanf(" %[^\n]",m->nom_prenom_enseignent);
+             scanf(" %49[^\n]",teacher);
+            m->nom_prenom_enseignent=intern_string(teacher);
+            }
             break;
         default:
             printf("Invalid choice!\n");
@@ -1030,6 +1169,7 @@ if (!utils_get_data_file_path(liste.filename, full_path, sizeof(full_path))) {
 }
 FILE *p=fopen(full_path,"w");
 for(int i=0;i<liste.count;i++){
+    if(liste.cours[i].is_deleted) continue;
     fprintf(p,"%d,%s,%s,%d,%d,%d,%d,%d,%d,%s\n",liste.cours[i].id,
             liste.cours[i].nom,
             liste.cours[i].description,
@@ -1039,7 +1179,7 @@ for(int i=0;i<liste.count;i++){
             liste.cours[i].niveau,
             liste.cours[i].filiere,
             liste.cours[i].semestre,
-            liste.cours[i].nom_prenom_enseignent
+            intern_lookup(liste.cours[i].nom_prenom_enseignent)
 );
 }
 fclose(p);
@@ -1056,6 +1196,8 @@ int remplire_liste_appartit_file(ListeModules *liste){
     FILE *p = fopen(full_path,"r");
     if(p == NULL) return 0;
 
+    char teacher[50];
+    table_lock_write(liste->lock);
     while (!feof(p)) {
         Module m;
 
@@ -1069,10 +1211,12 @@ int remplire_liste_appartit_file(ListeModules *liste){
             &m.niveau,
             &m.filiere,
             &m.semestre,
-            m.nom_prenom_enseignent
+            teacher
         );
 
        if(n == 10) {
+            m.nom_prenom_enseignent = intern_string(teacher);
+            m.is_deleted = 0;
             if(liste->count < liste->capacity) {
                 liste->cours[liste->count] = m;
                 liste->count++;            }
@@ -1085,6 +1229,8 @@ int remplire_liste_appartit_file(ListeModules *liste){
         }
         printf("---\n");
     }
+    liste->dirty = 0;
+    table_unlock_write(liste->lock);
     fclose(p);
     return 1;
 }
@@ -1148,14 +1294,14 @@ return(0);
 }
 void liste_cours_niveau(ListeModules liste,int niveaux){
 for(int i=0;i<liste.count;i++){
-    if(liste.cours[i].niveau==niveaux){
+    if(!liste.cours[i].is_deleted && liste.cours[i].niveau==niveaux){
         cours_afficher(&liste.cours[i]);
     }
 }
 }
 void liste_cours_filiere(ListeModules liste,int filiere){
 for(int i=0;i<liste.count;i++){
-    if(liste.cours[i].filiere==filiere){
+    if(!liste.cours[i].is_deleted && liste.cours[i].filiere==filiere){
         cours_afficher(&liste.cours[i]);
     }
 }
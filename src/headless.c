@@ -0,0 +1,583 @@
+#include "headless.h"
+#include "student.h"
+#include "grade.h"
+#include "attendance.h"
+#include "club.h"
+#include "prof_note.h"
+#include "stats.h"
+#include "import.h"
+#include "export.h"
+#include "http_server.h"
+#include "arena.h"
+#include "utils.h"
+#include <glib.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#if defined(_WIN32) || defined(_WIN64)
+#include <io.h>
+#else
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+
+// Tables a command needs; nothing else is created or loaded
+enum {
+    NEED_STUDENTS = 1 << 0,
+    NEED_GRADES = 1 << 1,
+    NEED_ATTENDANCE = 1 << 2,
+    NEED_CLUBS = 1 << 3,
+    NEED_MEMBERSHIPS = 1 << 4,
+    NEED_MODULES = 1 << 5,
+    NEED_EXAMS = 1 << 6,
+    NEED_PROF_NOTES = 1 << 7
+};
+
+typedef struct {
+    StudentList* students;
+    liste_note* grades;
+    AttendanceList* attendance;
+    ClubList* clubs;
+    MembershipList* memberships;
+    ListeModules* modules;
+    liste_examen* exams;
+    ProfessorNoteList* prof_notes;
+} HeadlessTables;
+
+typedef int (*HeadlessCommandFunc)(int argc, char** argv);
+
+typedef struct {
+    const char* name;
+    HeadlessCommandFunc run;
+    const char* usage;
+} HeadlessCommand;
+
+// The process's real stdout. stdout itself is pointed at stderr so the
+// modules' printf() logging never lands in exported data.
+static FILE* g_out = NULL;
+
+// ============================================================================
+// TABLES
+// ============================================================================
+
+static void tables_destroy(HeadlessTables* t) {
+    if (t->students) student_list_destroy(t->students);
+    if (t->grades) liste_note_destroy(t->grades);
+    if (t->attendance) attendance_list_destroy(t->attendance);
+    if (t->clubs) club_list_destroy(t->clubs);
+    if (t->memberships) membership_list_destroy(t->memberships);
+    if (t->modules) liste_module_destroy(t->modules);
+    if (t->exams) liste_examen_destroy(t->exams);
+    if (t->prof_notes) prof_note_list_destroy(t->prof_notes);
+    memset(t, 0, sizeof(*t));
+}
+
+// Missing files load as empty tables, as they do in the application
+static int tables_load(HeadlessTables* t, unsigned int need) {
+    memset(t, 0, sizeof(*t));
+
+    if (need & NEED_STUDENTS) {
+        t->students = student_list_create();
+        if (!t->students) goto oom;
+        student_list_load_from_file(t->students, STUDENTS_FILE);
+    }
+    if (need & NEED_GRADES) {
+        t->grades = liste_note_create();
+        if (!t->grades) goto oom;
+        grade_list_load_from_file(t->grades, GRADES_FILE);
+    }
+    if (need & NEED_ATTENDANCE) {
+        t->attendance = attendance_list_create();
+        if (!t->attendance) goto oom;
+        attendance_list_load_from_file(t->attendance, ATTENDANCE_FILE);
+    }
+    if (need & NEED_CLUBS) {
+        t->clubs = club_list_create();
+        if (!t->clubs) goto oom;
+        club_list_load_from_file(t->clubs, CLUBS_FILE);
+    }
+    if (need & NEED_MEMBERSHIPS) {
+        t->memberships = membership_list_create();
+        if (!t->memberships) goto oom;
+        membership_list_load_from_file(t->memberships, MEMBERSHIPS_FILE);
+    }
+    if (need & NEED_MODULES) {
+        t->modules = liste_module_create();
+        if (!t->modules) goto oom;
+        strcpy(t->modules->filename, "modules.txt");
+        remplire_liste_appartit_file(t->modules);
+    }
+    if (need & NEED_EXAMS) {
+        t->exams = liste_examen_create();
+        if (!t->exams) goto oom;
+        strcpy(t->exams->filename, "examens.txt");
+        liste_examen_a_partir_file(t->exams);
+    }
+    if (need & NEED_PROF_NOTES) {
+        t->prof_notes = prof_note_list_create();
+        if (!t->prof_notes) goto oom;
+        char path[UTILS_MAX_PATH_LENGTH];
+        if (utils_get_data_file_path(PROF_NOTES_FILE, path, sizeof(path)) && utils_file_exists(path)) {
+            prof_note_load(t->prof_notes, path);
+        }
+    }
+    return 1;
+
+oom:
+    printf("[ERROR] Out of memory\n");
+    tables_destroy(t);
+    return 0;
+}
+
+// A running GUI instance owns the data directory: it keeps every table in
+// memory and its autosave would overwrite what a command writes. Such an
+// instance listens on the replication socket, so a socket that accepts a
+// connection means the files must be left alone. (Not detected on Windows,
+// or with REPLICATION_ENABLED off; see headless.h.)
+static int data_dir_in_use(void) {
+#if defined(_WIN32) || defined(_WIN64)
+    return 0;
+#else
+    char path[UTILS_MAX_PATH_LENGTH];
+    if (!utils_get_data_file_path(REPLICATION_SOCKET_FILE, path, sizeof(path)) || !utils_file_exists(path)) {
+        return 0;
+    }
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path)) return 0;
+    strcpy(addr.sun_path, path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return 0;
+    // A socket left behind by a crashed instance refuses the connection
+    int live = connect(fd, (struct sockaddr*)&addr, sizeof(addr)) == 0;
+    close(fd);
+    return live;
+#endif
+}
+
+// Commands that write the data files call this before loading anything
+static int refuse_if_data_dir_in_use(void) {
+    if (!data_dir_in_use()) return 0;
+    printf("[ERROR] The application is running on this data directory; close it first\n");
+    return 1;
+}
+
+// ============================================================================
+// COMMANDS
+// ============================================================================
+
+static int command_import(int argc, char** argv) {
+    if (argc < 3) return 2;
+    int kind = import_kind_from_name(argv[1]);
+    if (kind < 0) {
+        printf("[ERROR] Unknown import kind: %s\n", argv[1]);
+        return 2;
+    }
+    const char* filename = argv[2];
+    const char* rejects = NULL;
+    for (int i = 3; i < argc; i++) {
+        if (strcmp(argv[i], "--rejects") == 0 && i + 1 < argc) {
+            rejects = argv[++i];
+        } else {
+            return 2;
+        }
+    }
+
+    if (refuse_if_data_dir_in_use()) return 1;
+
+    // Parsing needs no table, so a malformed file fails before any load
+    ImportBatch* batch = import_parse_file((ImportKind)kind, filename);
+    if (!batch) return 1;
+
+    unsigned int need = NEED_STUDENTS;
+    if (kind == IMPORT_GRADES) need |= NEED_GRADES | NEED_EXAMS;
+    if (kind == IMPORT_ATTENDANCE) need |= NEED_ATTENDANCE;
+    HeadlessTables t;
+    if (!tables_load(&t, need)) {
+        import_batch_destroy(batch);
+        return 1;
+    }
+
+    ImportTargets targets = { t.students, t.grades, t.attendance, t.exams };
+    int ok = import_batch_apply(batch, &targets);
+    const ImportCounts* counts = import_batch_counts(batch);
+
+    if (ok) {
+        switch (kind) {
+            case IMPORT_STUDENTS:
+                ok = student_list_save_to_file(t.students, STUDENTS_FILE) == 1;
+                break;
+            case IMPORT_GRADES:
+                ok = grade_list_save_to_file(t.grades, GRADES_FILE) == 1;
+                break;
+            case IMPORT_ATTENDANCE:
+                ok = attendance_list_save_to_file(t.attendance, ATTENDANCE_FILE) == 1;
+                break;
+        }
+    }
+    if (counts->rejected > 0 && rejects) {
+        import_batch_write_rejects(batch, rejects);
+    }
+
+    fprintf(g_out, "{\"kind\": \"%s\", \"rows\": %d, \"inserted\": %d, \"updated\": %d, \"rejected\": %d, "
+                   "\"saved\": %s}\n",
+            import_kind_name((ImportKind)kind), counts->rows, counts->inserted, counts->updated,
+            counts->rejected, ok ? "true" : "false");
+
+    import_batch_destroy(batch);
+    tables_destroy(&t);
+    return ok ? 0 : 1;
+}
+
+static int command_export(int argc, char** argv) {
+    if (argc < 2) return 2;
+    int kind = export_kind_from_name(argv[1]);
+    if (kind < 0) {
+        printf("[ERROR] Unknown table: %s\n", argv[1]);
+        return 2;
+    }
+
+    ExportOptions options = { 0 };
+    options.kind = (ExportKind)kind;
+    options.format = EXPORT_CSV;
+    const char* output = NULL;
+    for (int i = 2; i < argc; i++) {
+        const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!value) return 2;
+        if (strcmp(argv[i], "--format") == 0) {
+            if (strcmp(value, "csv") == 0) {
+                options.format = EXPORT_CSV;
+            } else if (strcmp(value, "ndjson") == 0) {
+                options.format = EXPORT_NDJSON;
+            } else {
+                printf("[ERROR] Unknown format: %s\n", value);
+                return 2;
+            }
+        } else if (strcmp(argv[i], "--columns") == 0) {
+            options.columns = value;
+        } else if (strcmp(argv[i], "--output") == 0) {
+            output = value;
+        } else {
+            return 2;
+        }
+        i++;
+    }
+    if (options.columns && !export_columns_check(options.kind, options.columns)) {
+        printf("[ERROR] Unknown column in: %s\n", options.columns);
+        return 2;
+    }
+
+    static const unsigned int need[EXPORT_KIND_COUNT] = {
+        [EXPORT_STUDENTS] = NEED_STUDENTS,
+        [EXPORT_GRADES] = NEED_GRADES | NEED_MODULES | NEED_EXAMS,
+        [EXPORT_ATTENDANCE] = NEED_ATTENDANCE,
+        [EXPORT_CLUBS] = NEED_CLUBS,
+        [EXPORT_MEMBERSHIPS] = NEED_MEMBERSHIPS,
+        [EXPORT_PROF_NOTES] = NEED_PROF_NOTES,
+    };
+    HeadlessTables t;
+    if (!tables_load(&t, need[kind])) return 1;
+    const void* tables[EXPORT_KIND_COUNT] = {
+        t.students, t.grades, t.attendance, t.clubs, t.memberships, t.prof_notes
+    };
+
+    ExportExamIndex* exams = NULL;
+    if (options.kind == EXPORT_GRADES) {
+        exams = export_exam_index_build(t.exams, t.modules);
+        options.exams = exams;
+    }
+
+    int rows = 0;
+    int ok;
+    if (output) {
+        ok = export_table_to_file(tables[kind], &options, output, &rows);
+    } else {
+        ok = export_table_to_stream(tables[kind], &options, g_out, &rows);
+        ok = fflush(g_out) == 0 && ok;
+    }
+    if (ok) printf("[OK] Exported %d %s rows\n", rows, export_kind_name(options.kind));
+
+    if (exams) export_exam_index_destroy(exams);
+    tables_destroy(&t);
+    return ok ? 0 : 1;
+}
+
+typedef struct {
+    float sum;
+    int count;
+} GradeTotal;
+
+// GPA on the 0-4 scale from the mean of each student's present grades in
+// one pass over the grades. Students without a grade keep their GPA.
+static int command_recompute_gpa(int argc, char** argv) {
+    (void)argv;
+    if (argc != 1) return 2;
+    if (refuse_if_data_dir_in_use()) return 1;
+
+    HeadlessTables t;
+    if (!tables_load(&t, NEED_STUDENTS | NEED_GRADES)) return 1;
+
+    GHashTable* totals = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
+    for (int i = 0; i < t.grades->count; i++) {
+        const Note* note = &t.grades->note[i];
+        if (note->is_deleted || note->present != 1) continue;
+        GradeTotal* total = g_hash_table_lookup(totals, GINT_TO_POINTER(note->id_etudiant));
+        if (!total) {
+            total = g_new0(GradeTotal, 1);
+            g_hash_table_insert(totals, GINT_TO_POINTER(note->id_etudiant), total);
+        }
+        total->sum += note->note_obtenue;
+        total->count++;
+    }
+
+    int updated = 0;
+    for (int i = 0; i < t.students->count; i++) {
+        Student* student = &t.students->students[i];
+        if (student->is_deleted) continue;
+        const GradeTotal* total = g_hash_table_lookup(totals, GINT_TO_POINTER(student->id));
+        if (!total) continue;
+
+        float gpa = total->sum / total->count / GRADE_MAX_SCORE * 4.0f;
+        if (gpa < 0.0f) gpa = 0.0f;
+        if (gpa > 4.0f) gpa = 4.0f;
+        // Stored with two decimals; rounding first keeps reruns from
+        // rewriting unchanged students
+        gpa = roundf(gpa * 100.0f) / 100.0f;
+        if (fabsf(gpa - student->gpa) > 0.001f) {
+            student->gpa = gpa;
+            updated++;
+        }
+    }
+    g_hash_table_destroy(totals);
+
+    int ok = 1;
+    if (updated > 0) {
+        t.students->dirty = 1;
+        ok = student_list_save_to_file(t.students, STUDENTS_FILE) == 1;
+    }
+    fprintf(g_out, "{\"students\": %d, \"updated\": %d, \"saved\": %s}\n",
+            t.students->count, updated, ok ? "true" : "false");
+
+    tables_destroy(&t);
+    return ok ? 0 : 1;
+}
+
+static int command_stats(int argc, char** argv) {
+    (void)argv;
+    if (argc != 1) return 2;
+
+    HeadlessTables t;
+    if (!tables_load(&t, NEED_STUDENTS | NEED_GRADES | NEED_ATTENDANCE | NEED_CLUBS |
+                         NEED_MEMBERSHIPS | NEED_MODULES)) {
+        return 1;
+    }
+    SystemStats* stats = calculate_system_stats(t.students, t.modules, t.grades,
+                                                t.attendance, t.clubs, t.memberships);
+    if (!stats) {
+        tables_destroy(&t);
+        return 1;
+    }
+
+    fprintf(g_out, "{\"students\": %d, \"active_students\": %d, \"inactive_students\": %d, "
+                   "\"courses\": %d, \"grades\": %d, \"attendance_records\": %d, \"clubs\": %d, "
+                   "\"memberships\": %d, \"time\": %lld}\n",
+            stats->total_students, stats->active_students, stats->inactive_students,
+            stats->total_courses, stats->total_grades, stats->total_attendance_records,
+            stats->total_clubs, stats->total_memberships, (long long)stats->last_updated);
+
+    free_system_stats(stats);
+    tables_destroy(&t);
+    return 0;
+}
+
+// logs.txt becomes logs.txt.1, logs.txt.1 becomes logs.txt.2 and so on;
+// the oldest is dropped. A fresh empty log is left in place.
+static int command_rotate_logs(int argc, char** argv) {
+    int keep = HEADLESS_LOG_KEEP;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--keep") == 0 && i + 1 < argc) {
+            keep = atoi(argv[++i]);
+        } else {
+            return 2;
+        }
+    }
+    if (keep < 1) {
+        printf("[ERROR] --keep must be at least 1\n");
+        return 2;
+    }
+
+    char log_path[UTILS_MAX_PATH_LENGTH];
+    if (!utils_get_data_file_path(LOGS_FILE, log_path, sizeof(log_path))) return 1;
+    if (!utils_file_exists(log_path)) {
+        printf("[INFO] No %s to rotate\n", log_path);
+        return 0;
+    }
+
+    // rename() does not replace an existing file on Windows, so each
+    // target is removed first
+    char from[UTILS_MAX_PATH_LENGTH + 16], to[UTILS_MAX_PATH_LENGTH + 16];
+    snprintf(to, sizeof(to), "%s.%d", log_path, keep);
+    remove(to);
+    for (int n = keep - 1; n >= 1; n--) {
+        snprintf(from, sizeof(from), "%s.%d", log_path, n);
+        snprintf(to, sizeof(to), "%s.%d", log_path, n + 1);
+        if (utils_file_exists(from) && rename(from, to) != 0) {
+            printf("[ERROR] Cannot rename %s to %s\n", from, to);
+            return 1;
+        }
+    }
+    snprintf(to, sizeof(to), "%s.1", log_path);
+    if (rename(log_path, to) != 0) {
+        printf("[ERROR] Cannot rename %s to %s\n", log_path, to);
+        return 1;
+    }
+
+    FILE* f = fopen(log_path, "w");
+    if (f) fclose(f);
+    printf("[OK] Rotated %s, keeping %d\n", log_path, keep);
+    return 0;
+}
+
+// Serves the read API (http_server.h) from the tables as loaded, until
+// SIGINT or SIGTERM
+static int command_serve(int argc, char** argv) {
+    const char* address = HTTP_SERVER_ADDRESS;
+    int port = HTTP_SERVER_PORT;
+    int workers = HTTP_SERVER_WORKERS;
+    for (int i = 1; i < argc; i++) {
+        const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!value) return 2;
+        if (strcmp(argv[i], "--bind") == 0) {
+            address = value;
+        } else if (strcmp(argv[i], "--port") == 0) {
+            port = atoi(value);
+        } else if (strcmp(argv[i], "--workers") == 0) {
+            workers = atoi(value);
+        } else {
+            return 2;
+        }
+        i++;
+    }
+
+    HeadlessTables t;
+    if (!tables_load(&t, NEED_STUDENTS | NEED_GRADES | NEED_ATTENDANCE | NEED_CLUBS |
+                         NEED_MEMBERSHIPS | NEED_MODULES | NEED_EXAMS)) {
+        return 1;
+    }
+    ExportExamIndex* exams = export_exam_index_build(t.exams, t.modules);
+    HttpTables tables = { t.students, t.grades, t.attendance, t.clubs, t.memberships, exams };
+
+    int ok = 0;
+#if defined(_WIN32) || defined(_WIN64)
+    ok = http_server_start(address, port, workers, &tables);
+#else
+    // Blocked before the server's threads exist, so they inherit the mask
+    // and the signals are left to sigwait() here
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, NULL);
+
+    ok = http_server_start(address, port, workers, &tables);
+    if (ok) {
+        int signal_number = 0;
+        sigwait(&signals, &signal_number);
+        printf("[INFO] Signal %d received, stopping\n", signal_number);
+        http_server_stop();
+    }
+#endif
+
+    export_exam_index_destroy(exams);
+    tables_destroy(&t);
+    return ok ? 0 : 1;
+}
+
+static int command_help(int argc, char** argv);
+
+static const HeadlessCommand commands[] = {
+    { "import", command_import,
+      "import <students|grades|attendance> FILE [--rejects FILE]" },
+    { "export", command_export,
+      "export <students|grades|attendance|clubs|memberships|prof_notes>\n"
+      "         [--format csv|ndjson] [--columns LIST] [--output FILE]" },
+    { "recompute-gpa", command_recompute_gpa, "recompute-gpa" },
+    { "stats", command_stats, "stats" },
+    { "rotate-logs", command_rotate_logs, "rotate-logs [--keep N]" },
+    { "serve", command_serve, "serve [--bind ADDRESS] [--port N] [--workers N]" },
+    { "help", command_help, "help" },
+};
+
+static int command_help(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+    fprintf(stderr, "Usage: student_mgmt --headless [--data DIR] <command> [options]\n\nCommands:\n");
+    for (int i = 0; i < (int)G_N_ELEMENTS(commands); i++) {
+        fprintf(stderr, "  %s\n", commands[i].usage);
+    }
+    return 0;
+}
+
+// ============================================================================
+// ENTRY POINT
+// ============================================================================
+
+static int redirect_stdout(void) {
+    fflush(stdout);
+    int fd = dup(fileno(stdout));
+    if (fd < 0) return 0;
+    g_out = fdopen(fd, "w");
+    if (!g_out) {
+        close(fd);
+        return 0;
+    }
+    dup2(fileno(stderr), fileno(stdout));
+    return 1;
+}
+
+int headless_main(int argc, char** argv) {
+    int i = 1;
+    if (i + 1 < argc && strcmp(argv[i], "--data") == 0) {
+        utils_set_data_dir(argv[i + 1]);
+        i += 2;
+    }
+    if (i >= argc) {
+        command_help(0, NULL);
+        return 2;
+    }
+
+    const HeadlessCommand* command = NULL;
+    for (int c = 0; c < (int)G_N_ELEMENTS(commands); c++) {
+        if (strcmp(argv[i], commands[c].name) == 0) command = &commands[c];
+    }
+    if (!command) {
+        fprintf(stderr, "[ERROR] Unknown command: %s\n", argv[i]);
+        command_help(0, NULL);
+        return 2;
+    }
+    if (!redirect_stdout()) {
+        fprintf(stderr, "[ERROR] Cannot redirect stdout\n");
+        return 1;
+    }
+
+    int status = command->run(argc - i, argv + i);
+    if (status == 2) fprintf(stderr, "Usage: student_mgmt --headless %s\n", command->usage);
+
+    if (fclose(g_out) != 0 && status == 0) status = 1;
+    g_out = NULL;
+    arena_scratch_destroy();
+    return status;
+}
+
+#ifdef HEADLESS_MAIN
+// Stand-alone build without GTK: ./build.sh cli
+int main(int argc, char** argv) {
+    return headless_main(argc, argv);
+}
+#endif
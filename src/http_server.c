@@ -0,0 +1,768 @@
+#define _GNU_SOURCE     // accept4, memmem, strcasestr
+#include "http_server.h"
+
+#ifdef __linux__
+
+#include <glib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stddef.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <strings.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#define HTTP_EPOLL_EVENTS 256
+#define HTTP_SWEEP_MS 1000          // idle connections are looked for this often
+
+// Owned by the loop thread, except while busy: then a worker owns it until
+// it hands it back through the done queue
+typedef struct {
+    int fd;
+    char request[HTTP_MAX_REQUEST_BYTES];
+    size_t received;
+    size_t request_len;         // bytes of the request being answered
+    int busy;                   // a worker holds the connection
+    int closing;                // dropped while busy; freed when handed back
+    int peer_closed;            // the client shut down its side after sending
+    int keep_alive;
+    gint64 last_active;         // monotonic time of the last bytes in or out
+    char header[256];
+    size_t header_len;
+    char* body;
+    size_t body_len;
+    size_t sent;                // of header and body
+} HttpConnection;
+
+typedef struct {
+    const char* collection;     // first path segment
+    const char* sub;            // segment after the id, NULL for the record itself
+    ExportKind kind;
+    int key_offset;             // int field compared with the id; -1 if there is no /{id}
+} HttpRoute;
+
+typedef struct {
+    int key_offset;             // -1 for no key
+    int key;
+    int offset;
+    int limit;
+    int matched;
+} HttpFilter;
+
+typedef struct {
+    HttpTables tables;
+    int listen_fd;
+    int spare_fd;               // given up to accept and drop a connection when out of descriptors
+    int accept_paused;          // listen_fd unwatched until the next sweep
+    int epoll_fd;
+    int wake_fd;                // eventfd: finished requests, or stop
+    GThread* loop;
+    GThreadPool* workers;
+    GAsyncQueue* done;          // connections handed back by the workers
+    GHashTable* connections;    // every open connection, loop thread only
+    atomic_int stopping;
+} HttpServer;
+
+static HttpServer* g_server = NULL;
+
+static const HttpRoute routes[] = {
+    { "students", NULL, EXPORT_STUDENTS, offsetof(Student, id) },
+    { "students", "grades", EXPORT_GRADES, offsetof(Note, id_etudiant) },
+    { "students", "attendance", EXPORT_ATTENDANCE, offsetof(AttendanceRecord, student_id) },
+    { "grades", NULL, EXPORT_GRADES, -1 },
+    { "attendance", NULL, EXPORT_ATTENDANCE, offsetof(AttendanceRecord, id) },
+    { "clubs", NULL, EXPORT_CLUBS, offsetof(Club, id) },
+    { "clubs", "members", EXPORT_MEMBERSHIPS, offsetof(ClubMembership, club_id) },
+};
+
+// ============================================================================
+// HANDLERS (worker threads)
+// ============================================================================
+
+static const char* http_reason(int status) {
+    switch (status) {
+        case 200: return "OK";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 431: return "Request Header Fields Too Large";
+        default:  return "Internal Server Error";
+    }
+}
+
+static void http_respond(HttpConnection* conn, int status, char* body, size_t body_len) {
+    conn->body = body;
+    conn->body_len = body_len;
+    conn->sent = 0;
+    int n = snprintf(conn->header, sizeof(conn->header),
+                     "HTTP/1.1 %d %s\r\nContent-Type: application/json\r\n%s"
+                     "Content-Length: %zu\r\nConnection: %s\r\n\r\n",
+                     status, http_reason(status), status == 405 ? "Allow: GET\r\n" : "",
+                     body_len, conn->keep_alive ? "keep-alive" : "close");
+    conn->header_len = (size_t)n;
+}
+
+static void http_respond_error(HttpConnection* conn, int status) {
+    // Bodies are released with free(), so no GLib allocation here
+    char* body = malloc(64);
+    if (body) snprintf(body, 64, "{\"error\":\"%s\"}", http_reason(status));
+    http_respond(conn, status, body, body ? strlen(body) : 0);
+}
+
+static void http_wake(HttpServer* server) {
+    uint64_t one = 1;
+    // Fails only when the counter is about to overflow, and then the loop
+    // is awake anyway
+    ssize_t n = write(server->wake_fd, &one, sizeof(one));
+    (void)n;
+}
+
+static int http_filter(const void* record, void* user_data) {
+    HttpFilter* filter = user_data;
+    if (filter->key_offset >= 0 && *(const int*)((const char*)record + filter->key_offset) != filter->key) {
+        return 0;
+    }
+    int index = filter->matched++;
+    return index >= filter->offset && index - filter->offset < filter->limit;
+}
+
+// Stops the scan once the page is full
+static int http_progress(int rows_done, int rows_total, void* user_data) {
+    (void)rows_done;
+    (void)rows_total;
+    const HttpFilter* filter = user_data;
+    return filter->matched - filter->offset < filter->limit;
+}
+
+static const void* http_table(const HttpTables* tables, ExportKind kind) {
+    switch (kind) {
+        case EXPORT_STUDENTS:    return tables->students;
+        case EXPORT_GRADES:      return tables->grades;
+        case EXPORT_ATTENDANCE:  return tables->attendance;
+        case EXPORT_CLUBS:       return tables->clubs;
+        case EXPORT_MEMBERSHIPS: return tables->memberships;
+        default:                 return NULL;
+    }
+}
+
+// The matching records as NDJSON, one object per line
+static int http_export(const HttpTables* tables, ExportKind kind, HttpFilter* filter,
+                       char** ndjson, size_t* len, int* rows) {
+    const void* table = http_table(tables, kind);
+    *ndjson = NULL;
+    *len = 0;
+    *rows = 0;
+    if (table == NULL) return 0;
+
+    FILE* out = open_memstream(ndjson, len);
+    if (out == NULL) return 0;
+
+    ExportOptions options = { 0 };
+    options.kind = kind;
+    options.format = EXPORT_NDJSON;
+    options.filter = http_filter;
+    options.progress = http_progress;
+    options.user_data = filter;
+    options.exams = tables->exams;
+
+    int ok = export_table_to_stream(table, &options, out, rows);
+    // A stop from http_progress is a full page, not a failure
+    if (!ok && !ferror(out) && filter->matched - filter->offset >= filter->limit) ok = 1;
+    if (fclose(out) != 0) ok = 0;
+    if (!ok) {
+        free(*ndjson);
+        *ndjson = NULL;
+    }
+    return ok;
+}
+
+// Turns the lines into a JSON array in place: the newline between two
+// objects becomes a comma and the last one the closing bracket
+static char* http_ndjson_to_array(char* ndjson, size_t* len) {
+    char* array = realloc(ndjson, *len + 3);
+    if (array == NULL) return NULL;
+    if (*len == 0) {
+        memcpy(array, "[]", 3);
+        *len = 2;
+        return array;
+    }
+    memmove(array + 1, array, *len);
+    array[0] = '[';
+    for (size_t i = 1; i < *len; i++) {
+        if (array[i] == '\n') array[i] = ',';
+    }
+    array[*len] = ']';
+    *len += 1;
+    return array;
+}
+
+static int http_query_int(const char* query, const char* name, int fallback, int* value) {
+    *value = fallback;
+    size_t name_len = strlen(name);
+    const char* p = query;
+    while (p && *p) {
+        if (strncmp(p, name, name_len) == 0 && p[name_len] == '=') {
+            char* end;
+            long n = strtol(p + name_len + 1, &end, 10);
+            if (end == p + name_len + 1 || (*end && *end != '&') || n < 0 || n > INT_MAX / 2) return 0;
+            *value = (int)n;
+        }
+        p = strchr(p, '&');
+        if (p) p++;
+    }
+    return 1;
+}
+
+static int http_parse_id(const char* s, size_t len, int* id) {
+    if (len == 0 || len > 9) return 0;
+    int n = 0;
+    for (size_t i = 0; i < len; i++) {
+        if (s[i] < '0' || s[i] > '9') return 0;
+        n = n * 10 + (s[i] - '0');
+    }
+    *id = n;
+    return 1;
+}
+
+static void http_route(const HttpTables* tables, HttpConnection* conn, char* path, const char* query) {
+    if (strcmp(path, "/health") == 0) {
+        char* body = strdup("{\"status\":\"ok\"}");
+        http_respond(conn, body ? 200 : 500, body, body ? strlen(body) : 0);
+        return;
+    }
+
+    // /collection[/id[/sub]]
+    char* segments[4] = { NULL };
+    int n_segments = 0;
+    for (char* p = path; *p == '/' && n_segments < 4; ) {
+        *p++ = '\0';
+        segments[n_segments++] = p;
+        p = strchr(p, '/');
+        if (!p) break;
+    }
+    if (n_segments == 0 || n_segments > 3 || segments[n_segments - 1][0] == '\0') {
+        http_respond_error(conn, 404);
+        return;
+    }
+
+    int id = 0;
+    if (n_segments >= 2 && !http_parse_id(segments[1], strlen(segments[1]), &id)) {
+        http_respond_error(conn, 404);
+        return;
+    }
+    const char* sub = n_segments == 3 ? segments[2] : NULL;
+    const HttpRoute* route = NULL;
+    for (size_t i = 0; i < G_N_ELEMENTS(routes); i++) {
+        if (strcmp(routes[i].collection, segments[0]) != 0) continue;
+        if ((sub == NULL) != (routes[i].sub == NULL)) continue;
+        if (sub && strcmp(routes[i].sub, sub) != 0) continue;
+        route = &routes[i];
+        break;
+    }
+    if (route == NULL || (n_segments >= 2 && route->key_offset < 0)) {
+        http_respond_error(conn, 404);
+        return;
+    }
+
+    HttpFilter filter = { -1, 0, 0, 1, 0 };
+    int single = n_segments == 2;
+    if (n_segments >= 2) {
+        filter.key_offset = route->key_offset;
+        filter.key = id;
+    }
+    if (!single) {
+        if (!http_query_int(query, "offset", 0, &filter.offset) ||
+            !http_query_int(query, "limit", HTTP_DEFAULT_LIMIT, &filter.limit)) {
+            http_respond_error(conn, 400);
+            return;
+        }
+        if (filter.limit > HTTP_MAX_LIMIT) filter.limit = HTTP_MAX_LIMIT;
+    }
+
+    char* body;
+    size_t len;
+    int rows;
+    if (!http_export(tables, route->kind, &filter, &body, &len, &rows)) {
+        http_respond_error(conn, 500);
+        return;
+    }
+    if (single) {
+        if (rows == 0) {
+            free(body);
+            http_respond_error(conn, 404);
+            return;
+        }
+        len--;      // the newline
+    } else {
+        char* array = http_ndjson_to_array(body, &len);
+        if (array == NULL) {
+            free(body);
+            http_respond_error(conn, 500);
+            return;
+        }
+        body = array;
+    }
+    http_respond(conn, 200, body, len);
+}
+
+static int http_header_is(const char* line, const char* name) {
+    size_t n = strlen(name);
+    return strncasecmp(line, name, n) == 0 && line[n] == ':';
+}
+
+static void http_handle(gpointer data, gpointer user_data) {
+    HttpConnection* conn = data;
+    HttpServer* server = user_data;
+
+    // The request ends with an empty line; make it a string
+    char* request = conn->request;
+    request[conn->request_len - 2] = '\0';
+
+    char* line_end = strstr(request, "\r\n");
+    char* method = request;
+    char* target = NULL;
+    char* version = NULL;
+    if (line_end) {
+        *line_end = '\0';
+        target = strchr(method, ' ');
+        version = target ? strchr(target + 1, ' ') : NULL;
+    }
+    int status = 0;
+    if (!target || !version) {
+        status = 400;
+    } else {
+        *target++ = '\0';
+        *version++ = '\0';
+        conn->keep_alive = strcmp(version, "HTTP/1.1") == 0;
+        if (strncmp(version, "HTTP/1.", 7) != 0) status = 400;
+    }
+
+    int has_body = 0;
+    char* line = status == 0 ? line_end + 2 : NULL;
+    while (line && *line) {
+        char* next = strstr(line, "\r\n");
+        if (next) *next = '\0';
+        if (http_header_is(line, "Connection")) {
+            const char* value = line + strlen("Connection:");
+            if (strcasestr(value, "close")) conn->keep_alive = 0;
+            else if (strcasestr(value, "keep-alive")) conn->keep_alive = 1;
+        } else if (http_header_is(line, "Transfer-Encoding") ||
+                   (http_header_is(line, "Content-Length") && atoi(line + strlen("Content-Length:")) != 0)) {
+            // Bodies are not read, so the connection cannot be reused
+            has_body = 1;
+        }
+        line = status == 0 && next ? next + 2 : NULL;
+    }
+    // The client will send nothing more, so this is the last answer
+    if (conn->peer_closed) conn->keep_alive = 0;
+
+    if (status != 0) {
+        conn->keep_alive = 0;
+        http_respond_error(conn, status);
+    } else if (strcmp(method, "GET") != 0) {
+        if (has_body) conn->keep_alive = 0;
+        http_respond_error(conn, 405);
+    } else if (has_body) {
+        conn->keep_alive = 0;
+        http_respond_error(conn, 400);
+    } else {
+        char* query = strchr(target, '?');
+        if (query) *query++ = '\0';
+        http_route(&server->tables, conn, target, query);
+    }
+
+    g_async_queue_push(server->done, conn);
+    http_wake(server);
+}
+
+// ============================================================================
+// EVENT LOOP (loop thread)
+// ============================================================================
+
+static void http_connection_close(HttpServer* server, HttpConnection* conn) {
+    epoll_ctl(server->epoll_fd, EPOLL_CTL_DEL, conn->fd, NULL);
+    close(conn->fd);
+    g_hash_table_remove(server->connections, conn);
+    free(conn->body);
+    free(conn);
+}
+
+static void http_watch(HttpServer* server, HttpConnection* conn, uint32_t events) {
+    struct epoll_event event = { 0 };
+    event.events = events;
+    event.data.ptr = conn;
+    epoll_ctl(server->epoll_fd, EPOLL_CTL_MOD, conn->fd, &event);
+}
+
+// Hands the connection to a worker if a whole request has arrived.
+// Returns 0 if the connection was closed.
+static int http_dispatch(HttpServer* server, HttpConnection* conn) {
+    char* end = memmem(conn->request, conn->received, "\r\n\r\n", 4);
+    if (end == NULL) {
+        if (conn->peer_closed) {
+            // Nothing more will arrive to complete it
+            http_connection_close(server, conn);
+            return 0;
+        }
+        if (conn->received == sizeof(conn->request)) {
+            conn->keep_alive = 0;
+            conn->request_len = conn->received;
+            http_respond_error(conn, 431);
+            http_watch(server, conn, EPOLLOUT);
+        }
+        return 1;
+    }
+
+    conn->request_len = (size_t)(end - conn->request) + 4;
+    conn->busy = 1;
+    // Nothing is read while a worker has the request
+    http_watch(server, conn, 0);
+    g_thread_pool_push(server->workers, conn, NULL);
+    return 1;
+}
+
+// Returns 0 if the connection was closed
+static int http_send(HttpServer* server, HttpConnection* conn) {
+    while (conn->sent < conn->header_len + conn->body_len) {
+        struct iovec iov[2];
+        int n_iov = 0;
+        if (conn->sent < conn->header_len) {
+            iov[n_iov].iov_base = conn->header + conn->sent;
+            iov[n_iov++].iov_len = conn->header_len - conn->sent;
+            iov[n_iov].iov_base = conn->body;
+            iov[n_iov++].iov_len = conn->body_len;
+        } else {
+            iov[n_iov].iov_base = conn->body + (conn->sent - conn->header_len);
+            iov[n_iov++].iov_len = conn->body_len - (conn->sent - conn->header_len);
+        }
+        struct msghdr msg = { 0 };
+        msg.msg_iov = iov;
+        msg.msg_iovlen = n_iov;
+
+        ssize_t n = sendmsg(conn->fd, &msg, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                http_watch(server, conn, EPOLLOUT);
+                return 1;
+            }
+            http_connection_close(server, conn);
+            return 0;
+        }
+        conn->sent += (size_t)n;
+        conn->last_active = g_get_monotonic_time();
+    }
+
+    // Done: drop the answered request and look at what came after it
+    free(conn->body);
+    conn->body = NULL;
+    conn->body_len = conn->header_len = conn->sent = 0;
+    if (!conn->keep_alive) {
+        http_connection_close(server, conn);
+        return 0;
+    }
+    conn->received -= conn->request_len;
+    memmove(conn->request, conn->request + conn->request_len, conn->received);
+    conn->request_len = 0;
+    http_watch(server, conn, EPOLLIN | EPOLLRDHUP);
+    return http_dispatch(server, conn);
+}
+
+static void http_receive(HttpServer* server, HttpConnection* conn) {
+    while (conn->received < sizeof(conn->request)) {
+        ssize_t n = recv(conn->fd, conn->request + conn->received, sizeof(conn->request) - conn->received, 0);
+        if (n > 0) {
+            conn->received += (size_t)n;
+            conn->last_active = g_get_monotonic_time();
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        if (n < 0) {
+            http_connection_close(server, conn);
+            return;
+        }
+        // Closed by the peer: a request it sent before that is still answered
+        conn->peer_closed = 1;
+        http_watch(server, conn, 0);
+        break;
+    }
+    http_dispatch(server, conn);
+}
+
+// Out of descriptors: the pending connection would keep the level-triggered
+// listen_fd ready forever. The spare descriptor makes room to accept and
+// drop it; without one, accepting pauses until the next sweep.
+static void http_accept_overflow(HttpServer* server) {
+    if (server->spare_fd >= 0) {
+        close(server->spare_fd);
+        int fd = accept4(server->listen_fd, NULL, NULL, SOCK_CLOEXEC);
+        if (fd >= 0) close(fd);
+        server->spare_fd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+        if (fd >= 0) return;
+    }
+    struct epoll_event event = { 0 };
+    event.data.ptr = &server->listen_fd;
+    epoll_ctl(server->epoll_fd, EPOLL_CTL_MOD, server->listen_fd, &event);
+    server->accept_paused = 1;
+}
+
+static void http_accept(HttpServer* server) {
+    for (;;) {
+        int fd = accept4(server->listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EMFILE || errno == ENFILE) {
+                http_accept_overflow(server);
+                if (!server->accept_paused) continue;
+            }
+            return;     // EAGAIN, or paused
+        }
+        if (g_hash_table_size(server->connections) >= HTTP_MAX_CONNECTIONS) {
+            close(fd);
+            continue;
+        }
+        int on = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+
+        HttpConnection* conn = calloc(1, sizeof(HttpConnection));
+        if (conn == NULL) {
+            close(fd);
+            continue;
+        }
+        conn->fd = fd;
+        conn->last_active = g_get_monotonic_time();
+        struct epoll_event event = { 0 };
+        event.events = EPOLLIN | EPOLLRDHUP;
+        event.data.ptr = conn;
+        if (epoll_ctl(server->epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0) {
+            close(fd);
+            free(conn);
+            continue;
+        }
+        g_hash_table_add(server->connections, conn);
+    }
+}
+
+// Responses the workers have finished
+static void http_collect(HttpServer* server) {
+    // Resets the counter; the queue says what is actually pending
+    uint64_t count;
+    ssize_t n = read(server->wake_fd, &count, sizeof(count));
+    (void)n;
+    HttpConnection* conn;
+    while ((conn = g_async_queue_try_pop(server->done)) != NULL) {
+        conn->busy = 0;
+        if (conn->closing) {
+            http_connection_close(server, conn);
+        } else {
+            http_send(server, conn);
+        }
+    }
+}
+
+// Closes connections that sent or took nothing for HTTP_IDLE_TIMEOUT_MS,
+// such as a client that stopped halfway through its request. Connections
+// a worker holds are left to it.
+static void http_sweep(HttpServer* server) {
+    if (server->accept_paused) {
+        struct epoll_event event = { 0 };
+        event.events = EPOLLIN;
+        event.data.ptr = &server->listen_fd;
+        epoll_ctl(server->epoll_fd, EPOLL_CTL_MOD, server->listen_fd, &event);
+        server->accept_paused = 0;
+    }
+
+    gint64 cutoff = g_get_monotonic_time() - (gint64)HTTP_IDLE_TIMEOUT_MS * 1000;
+    GHashTableIter iter;
+    gpointer key;
+    g_hash_table_iter_init(&iter, server->connections);
+    while (g_hash_table_iter_next(&iter, &key, NULL)) {
+        HttpConnection* conn = key;
+        if (conn->busy || conn->last_active > cutoff) continue;
+        g_hash_table_iter_remove(&iter);
+        epoll_ctl(server->epoll_fd, EPOLL_CTL_DEL, conn->fd, NULL);
+        close(conn->fd);
+        free(conn->body);
+        free(conn);
+    }
+}
+
+static gpointer http_loop(gpointer data) {
+    HttpServer* server = data;
+    struct epoll_event events[HTTP_EPOLL_EVENTS];
+    gint64 next_sweep = g_get_monotonic_time() + HTTP_SWEEP_MS * 1000;
+
+    while (!atomic_load(&server->stopping)) {
+        int n = epoll_wait(server->epoll_fd, events, HTTP_EPOLL_EVENTS, HTTP_SWEEP_MS);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            printf("[ERROR] HTTP server: epoll_wait failed (%s)\n", g_strerror(errno));
+            break;
+        }
+        if (g_get_monotonic_time() >= next_sweep) {
+            http_sweep(server);
+            next_sweep = g_get_monotonic_time() + HTTP_SWEEP_MS * 1000;
+        }
+        for (int i = 0; i < n; i++) {
+            void* ptr = events[i].data.ptr;
+            uint32_t flags = events[i].events;
+            if (ptr == &server->listen_fd) {
+                http_accept(server);
+                continue;
+            }
+            if (ptr == &server->wake_fd) {
+                http_collect(server);
+                continue;
+            }
+
+            HttpConnection* conn = ptr;
+            // A connection may already be gone if an earlier event in this
+            // batch closed it
+            if (!g_hash_table_contains(server->connections, conn)) continue;
+            if (conn->busy) {
+                // Only errors and hang-ups arrive while a worker has it
+                epoll_ctl(server->epoll_fd, EPOLL_CTL_DEL, conn->fd, NULL);
+                conn->closing = 1;
+            } else if (flags & (EPOLLERR | EPOLLHUP)) {
+                http_connection_close(server, conn);
+            } else if (flags & EPOLLOUT) {
+                http_send(server, conn);
+            } else if (flags & (EPOLLIN | EPOLLRDHUP)) {
+                http_receive(server, conn);
+            }
+        }
+    }
+    return NULL;
+}
+
+// ============================================================================
+// START / STOP (main thread)
+// ============================================================================
+
+static void http_server_free(HttpServer* server) {
+    if (server->workers) g_thread_pool_free(server->workers, FALSE, TRUE);
+    if (server->connections) {
+        // Includes those the workers handed back after the loop stopped
+        GHashTableIter iter;
+        gpointer key;
+        g_hash_table_iter_init(&iter, server->connections);
+        while (g_hash_table_iter_next(&iter, &key, NULL)) {
+            HttpConnection* conn = key;
+            close(conn->fd);
+            free(conn->body);
+            free(conn);
+        }
+        g_hash_table_destroy(server->connections);
+    }
+    if (server->done) g_async_queue_unref(server->done);
+    if (server->listen_fd >= 0) close(server->listen_fd);
+    if (server->spare_fd >= 0) close(server->spare_fd);
+    if (server->epoll_fd >= 0) close(server->epoll_fd);
+    if (server->wake_fd >= 0) close(server->wake_fd);
+    g_free(server);
+}
+
+int http_server_start(const char* address, int port, int workers, const HttpTables* tables) {
+    if (g_server) {
+        printf("[WARNING] HTTP server already running\n");
+        return 0;
+    }
+    if (tables == NULL || port <= 0 || port > 65535) {
+        printf("[ERROR] Invalid HTTP server arguments\n");
+        return 0;
+    }
+    if (workers <= 0) workers = HTTP_SERVER_WORKERS;
+    if (address == NULL) address = HTTP_SERVER_ADDRESS;
+
+    HttpServer* server = g_new0(HttpServer, 1);
+    server->tables = *tables;
+    server->listen_fd = server->spare_fd = server->epoll_fd = server->wake_fd = -1;
+
+    struct sockaddr_in addr = { 0 };
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((uint16_t)port);
+    if (inet_pton(AF_INET, address, &addr.sin_addr) != 1) {
+        printf("[ERROR] HTTP server: invalid address %s\n", address);
+        http_server_free(server);
+        return 0;
+    }
+
+    int on = 1;
+    server->listen_fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (server->listen_fd < 0 ||
+        setsockopt(server->listen_fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on)) != 0 ||
+        bind(server->listen_fd, (struct sockaddr*)&addr, sizeof(addr)) != 0 ||
+        listen(server->listen_fd, SOMAXCONN) != 0) {
+        printf("[ERROR] HTTP server: cannot listen on %s:%d (%s)\n", address, port, g_strerror(errno));
+        http_server_free(server);
+        return 0;
+    }
+
+    server->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    server->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    server->spare_fd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+    if (server->epoll_fd < 0 || server->wake_fd < 0) {
+        printf("[ERROR] HTTP server: %s\n", g_strerror(errno));
+        http_server_free(server);
+        return 0;
+    }
+    struct epoll_event event = { 0 };
+    event.events = EPOLLIN;
+    event.data.ptr = &server->listen_fd;
+    epoll_ctl(server->epoll_fd, EPOLL_CTL_ADD, server->listen_fd, &event);
+    event.data.ptr = &server->wake_fd;
+    epoll_ctl(server->epoll_fd, EPOLL_CTL_ADD, server->wake_fd, &event);
+
+    GError* error = NULL;
+    server->connections = g_hash_table_new(g_direct_hash, g_direct_equal);
+    server->done = g_async_queue_new();
+    server->workers = g_thread_pool_new(http_handle, server, workers, TRUE, &error);
+    if (server->workers == NULL) {
+        printf("[ERROR] HTTP server: %s\n", error ? error->message : "no worker threads");
+        g_clear_error(&error);
+        http_server_free(server);
+        return 0;
+    }
+    server->loop = g_thread_new("http", http_loop, server);
+
+    g_server = server;
+    printf("[INFO] HTTP server listening on http://%s:%d (%d workers)\n", address, port, workers);
+    return 1;
+}
+
+void http_server_stop(void) {
+    HttpServer* server = g_server;
+    if (server == NULL) return;
+    g_server = NULL;
+
+    atomic_store(&server->stopping, 1);
+    http_wake(server);
+    g_thread_join(server->loop);
+    http_server_free(server);
+    printf("[INFO] HTTP server stopped\n");
+}
+
+#else
+
+int http_server_start(const char* address, int port, int workers, const HttpTables* tables) {
+    (void)address;
+    (void)port;
+    (void)workers;
+    (void)tables;
+    printf("[WARNING] The HTTP server needs epoll and is only available on Linux\n");
+    return 0;
+}
+
+void http_server_stop(void) {
+}
+
+#endif // __linux__
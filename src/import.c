@@ -0,0 +1,857 @@
+#include "import.h"
+#include "arena.h"
+#include "changelog.h"
+#include <glib.h>
+#include <errno.h>
+#include <limits.h>
+#include <math.h>
+#include <stdarg.h>
+
+#define IMPORT_MAX_FIELDS 32
+#define IMPORT_TEXT_BLOCK_SIZE (1 << 20)
+
+// Where a row came from, for the rejects report
+typedef struct {
+    int line;
+    int raw_length;
+    const char* raw;            // the record in the file buffer, line end excluded
+} RowHead;
+
+typedef struct {
+    RowHead head;
+    Student student;            // course is left empty, see below
+    const char* course;         // interned when the row is applied (main thread)
+} StudentRow;
+
+typedef struct {
+    RowHead head;
+    Note grade;
+} GradeRow;
+
+typedef struct {
+    RowHead head;
+    AttendanceRecord record;
+} AttendanceRow;
+
+typedef struct {
+    RowHead head;
+    const char* reason;
+} ImportReject;
+
+typedef struct {
+    ImportReject* items;
+    int count;
+    int capacity;
+} RejectList;
+
+typedef struct ImportChunk ImportChunk;
+typedef const char* (*RowParseFunc)(ImportChunk* chunk, const char** fields, int field_count, const RowHead* head);
+
+typedef struct {
+    const char* name;
+    const char* const* fields;  // column names, in the order of the F_* constants
+    int field_count;
+    const int* required;        // F_* constants, -1 terminated
+    size_t row_size;
+    RowParseFunc parse;
+} ImportKindInfo;
+
+// One slice of the file, parsed by one thread
+struct ImportChunk {
+    const ImportBatch* batch;
+    const char* begin;
+    const char* end;
+    int first_line;
+    Arena* text;                // unquoted field values
+    char* rows;                 // row_size each
+    int count;
+    int capacity;
+    RejectList rejects;
+    int failed;                 // out of memory
+};
+
+struct ImportBatch {
+    ImportKind kind;
+    char* data;                 // the whole file
+    size_t size;
+    const char* header;         // raw header row, for the report
+    int header_length;
+    int columns[IMPORT_MAX_FIELDS];     // field -> column in the file, -1 if absent
+    ImportChunk chunks[IMPORT_MAX_THREADS];
+    int chunk_count;
+    RejectList rejects;         // refused while applying
+    Arena* messages;            // header values and apply-time reasons
+    ImportCounts counts;
+    int applied;
+};
+
+// ============================================================================
+// COLUMNS
+// ============================================================================
+
+// The names match the export columns so an export can be imported back
+enum { S_ID, S_FIRST_NAME, S_LAST_NAME, S_EMAIL, S_PHONE, S_ADDRESS, S_AGE, S_COURSE,
+       S_YEAR, S_GPA, S_ENROLLMENT_DATE, S_ACTIVE };
+static const char* const student_fields[] = {
+    "id", "first_name", "last_name", "email", "phone", "address", "age", "course",
+    "year", "gpa", "enrollment_date", "active"
+};
+static const int student_required[] = { S_FIRST_NAME, S_LAST_NAME, S_EMAIL, -1 };
+
+enum { G_STUDENT_ID, G_EXAM_ID, G_GRADE, G_PRESENT };
+static const char* const grade_fields[] = { "student_id", "exam_id", "grade", "present" };
+static const int grade_required[] = { G_STUDENT_ID, G_EXAM_ID, G_GRADE, -1 };
+
+enum { A_ID, A_STUDENT_ID, A_COURSE_ID, A_DATE, A_STATUS, A_REASON, A_TEACHER_ID, A_RECORDED_TIME };
+static const char* const attendance_fields[] = {
+    "id", "student_id", "course_id", "date", "status", "reason", "teacher_id", "recorded_time"
+};
+static const int attendance_required[] = { A_STUDENT_ID, A_COURSE_ID, A_DATE, A_STATUS, -1 };
+
+static const char* parse_student_row(ImportChunk* chunk, const char** fields, int field_count, const RowHead* head);
+static const char* parse_grade_row(ImportChunk* chunk, const char** fields, int field_count, const RowHead* head);
+static const char* parse_attendance_row(ImportChunk* chunk, const char** fields, int field_count, const RowHead* head);
+
+#define N_FIELDS(fields) ((int)(sizeof(fields) / sizeof(fields[0])))
+
+static const ImportKindInfo kind_info[IMPORT_KIND_COUNT] = {
+    { "students", student_fields, N_FIELDS(student_fields), student_required,
+      sizeof(StudentRow), parse_student_row },
+    { "grades", grade_fields, N_FIELDS(grade_fields), grade_required,
+      sizeof(GradeRow), parse_grade_row },
+    { "attendance", attendance_fields, N_FIELDS(attendance_fields), attendance_required,
+      sizeof(AttendanceRow), parse_attendance_row },
+};
+
+const char* import_kind_name(ImportKind kind) {
+    return (int)kind >= 0 && kind < IMPORT_KIND_COUNT ? kind_info[kind].name : NULL;
+}
+
+int import_kind_from_name(const char* name) {
+    for (int kind = 0; name != NULL && kind < IMPORT_KIND_COUNT; kind++) {
+        if (strcmp(kind_info[kind].name, name) == 0) return kind;
+    }
+    return -1;
+}
+
+// ============================================================================
+// CSV READING
+// ============================================================================
+
+// Read one RFC 4180 record at *pos into fields (values past max_fields are
+// dropped) and return how many it had. Quoted values lose their quotes
+// and doubled quotes. Values are copied into text; *lines counts the line
+// breaks consumed.
+static int csv_read_record(const char** pos, const char* end, Arena* text,
+                           const char** fields, int max_fields, int* lines) {
+    const char* p = *pos;
+    int count = 0;
+
+    for (;;) {
+        const char* value;
+        if (p < end && *p == '"') {
+            const char* start = ++p;
+            while (p < end) {
+                if (*p == '"') {
+                    if (p + 1 < end && p[1] == '"') { p += 2; continue; }
+                    break;
+                }
+                if (*p == '\n') (*lines)++;
+                p++;
+            }
+
+            char* out = (char*)arena_alloc(text, (size_t)(p - start) + 1);
+            if (out != NULL) {
+                size_t n = 0;
+                for (const char* s = start; s < p; s++) {
+                    out[n++] = *s;
+                    if (*s == '"') s++;
+                }
+                out[n] = '\0';
+            }
+            value = out;
+
+            // Skip the closing quote and anything stray before the delimiter
+            while (p < end && *p != ',' && *p != '\n') p++;
+        } else {
+            const char* start = p;
+            while (p < end && *p != ',' && *p != '\n') p++;
+            const char* stop = p;
+            if (stop > start && stop[-1] == '\r') stop--;
+            value = arena_strndup(text, start, (size_t)(stop - start) + 1);
+        }
+
+        if (count < max_fields) fields[count] = value ? value : "";
+        count++;
+        if (value == NULL) return -1;
+
+        if (p >= end) break;
+        if (*p++ == ',') continue;
+        (*lines)++;
+        break;
+    }
+
+    *pos = p;
+    return count;
+}
+
+// Value of a field in the current record, NULL if the file lacks the column
+static const char* field_value(const ImportBatch* batch, const char** fields, int field_count, int field) {
+    int column = batch->columns[field];
+    return column >= 0 && column < field_count ? fields[column] : NULL;
+}
+
+// Missing and empty values take the fallback; anything else must be a number
+static int parse_int(const char* text, int fallback, int* out) {
+    if (text == NULL || *text == '\0') {
+        *out = fallback;
+        return 1;
+    }
+    char* end;
+    errno = 0;
+    long value = strtol(text, &end, 10);
+    while (*end == ' ') end++;
+    if (errno != 0 || end == text || *end != '\0' || value < INT_MIN || value > INT_MAX) return 0;
+    *out = (int)value;
+    return 1;
+}
+
+static int parse_time(const char* text, time_t fallback, time_t* out) {
+    if (text == NULL || *text == '\0') {
+        *out = fallback;
+        return 1;
+    }
+    char* end;
+    errno = 0;
+    long long value = strtoll(text, &end, 10);
+    while (*end == ' ') end++;
+    if (errno != 0 || end == text || *end != '\0') return 0;
+    *out = (time_t)value;
+    return 1;
+}
+
+static int parse_float(const char* text, float fallback, float* out) {
+    if (text == NULL || *text == '\0') {
+        *out = fallback;
+        return 1;
+    }
+    char* end;
+    errno = 0;
+    double value = strtod(text, &end);
+    while (*end == ' ') end++;
+    if (errno != 0 || end == text || *end != '\0' || isnan(value) || isinf(value)) return 0;
+    *out = (float)value;
+    return 1;
+}
+
+// ============================================================================
+// ROW VALIDATION (parser threads)
+// ============================================================================
+
+static int chunk_append_row(ImportChunk* chunk, const void* row) {
+    size_t row_size = kind_info[chunk->batch->kind].row_size;
+    if (chunk->count == chunk->capacity) {
+        int new_capacity = chunk->capacity > 0 ? chunk->capacity * 2 : 1024;
+        char* rows = (char*)realloc(chunk->rows, new_capacity * row_size);
+        if (rows == NULL) {
+            chunk->failed = 1;
+            return 0;
+        }
+        chunk->rows = rows;
+        chunk->capacity = new_capacity;
+    }
+    memcpy(chunk->rows + chunk->count * row_size, row, row_size);
+    chunk->count++;
+    return 1;
+}
+
+static int reject_add(RejectList* list, const RowHead* head, const char* reason) {
+    if (list->count == list->capacity) {
+        int new_capacity = list->capacity > 0 ? list->capacity * 2 : 64;
+        ImportReject* items = (ImportReject*)realloc(list->items, new_capacity * sizeof(ImportReject));
+        if (items == NULL) return 0;
+        list->items = items;
+        list->capacity = new_capacity;
+    }
+    list->items[list->count].head = *head;
+    list->items[list->count].reason = reason;
+    list->count++;
+    return 1;
+}
+
+static int text_fits(const char* text, size_t limit) {
+    return text == NULL || strlen(text) < limit;
+}
+
+#define FIELD(f) field_value(chunk->batch, fields, field_count, (f))
+
+static const char* parse_student_row(ImportChunk* chunk, const char** fields, int field_count, const RowHead* head) {
+    StudentRow row;
+    memset(&row, 0, sizeof(row));
+    row.head = *head;
+    Student* s = &row.student;
+
+    s->first_name = FIELD(S_FIRST_NAME);
+    s->last_name = FIELD(S_LAST_NAME);
+    s->email = FIELD(S_EMAIL);
+    s->phone = FIELD(S_PHONE) ? FIELD(S_PHONE) : "";
+    s->address = FIELD(S_ADDRESS) ? FIELD(S_ADDRESS) : "";
+    row.course = FIELD(S_COURSE) ? FIELD(S_COURSE) : "";
+
+    if (!parse_int(FIELD(S_ID), 0, &s->id) || s->id < 0) return "invalid id";
+    if (!s->first_name || !*s->first_name || !text_fits(s->first_name, MAX_NAME_LENGTH)) return "missing or too long first name";
+    if (!s->last_name || !*s->last_name || !text_fits(s->last_name, MAX_NAME_LENGTH)) return "missing or too long last name";
+    // The quiet checks: this runs on worker threads, and reasons go to the report
+    const char* reason = student_check_email(s->email);
+    if (reason) return reason;
+    if (*s->phone && (reason = student_check_phone(s->phone))) return reason;
+    if (!text_fits(s->address, MAX_ADDRESS_LENGTH)) return "address too long";
+    if (!text_fits(row.course, MAX_COURSE_LENGTH)) return "course too long";
+
+    const char* age = FIELD(S_AGE);
+    if (!parse_int(age, 0, &s->age)) return "invalid age";
+    if (age && *age && (reason = student_check_age(s->age))) return reason;
+    if (!parse_int(FIELD(S_YEAR), 1, &s->year) || s->year < 0) return "invalid year";
+    if (!parse_float(FIELD(S_GPA), 0.0f, &s->gpa)) return "invalid GPA";
+    if ((reason = student_check_gpa(s->gpa))) return reason;
+    if (!parse_time(FIELD(S_ENROLLMENT_DATE), time(NULL), &s->enrollment_date)) return "invalid enrollment date";
+    if (!parse_int(FIELD(S_ACTIVE), 1, &s->is_active) || (s->is_active != 0 && s->is_active != 1)) return "active must be 0 or 1";
+
+    chunk_append_row(chunk, &row);
+    return NULL;
+}
+
+static const char* parse_grade_row(ImportChunk* chunk, const char** fields, int field_count, const RowHead* head) {
+    GradeRow row;
+    memset(&row, 0, sizeof(row));
+    row.head = *head;
+    Note* n = &row.grade;
+
+    if (!parse_int(FIELD(G_STUDENT_ID), 0, &n->id_etudiant) || n->id_etudiant <= 0) return "invalid student id";
+    if (!parse_int(FIELD(G_EXAM_ID), 0, &n->id_examen) || n->id_examen <= 0) return "invalid exam id";
+    if (!parse_float(FIELD(G_GRADE), -1.0f, &n->note_obtenue) || n->note_obtenue < 0 || n->note_obtenue > 20) return "grade must be between 0 and 20";
+    if (!parse_int(FIELD(G_PRESENT), 1, &n->present) || (n->present != 0 && n->present != 1)) return "present must be 0 or 1";
+
+    chunk_append_row(chunk, &row);
+    return NULL;
+}
+
+static const char* parse_attendance_row(ImportChunk* chunk, const char** fields, int field_count, const RowHead* head) {
+    AttendanceRow row;
+    memset(&row, 0, sizeof(row));
+    row.head = *head;
+    AttendanceRecord* r = &row.record;
+
+    const char* reason = FIELD(A_REASON) ? FIELD(A_REASON) : "";
+    if (!parse_int(FIELD(A_ID), 0, &r->id) || r->id < 0) return "invalid id";
+    if (!parse_int(FIELD(A_STUDENT_ID), 0, &r->student_id) || r->student_id <= 0) return "invalid student id";
+    if (!parse_int(FIELD(A_COURSE_ID), 0, &r->course_id) || r->course_id <= 0) return "invalid course id";
+    if (!parse_time(FIELD(A_DATE), 0, &r->date) || r->date <= 0) return "invalid date";
+    if (!parse_int(FIELD(A_STATUS), -1, &r->status) || r->status < ATTENDANCE_ABSENT || r->status > ATTENDANCE_EXCUSED) return "status must be 0 to 3";
+    if (!text_fits(reason, sizeof(r->reason))) return "reason too long";
+    if (!parse_int(FIELD(A_TEACHER_ID), 0, &r->teacher_id) || r->teacher_id < 0) return "invalid teacher id";
+    if (!parse_time(FIELD(A_RECORDED_TIME), time(NULL), &r->recorded_time)) return "invalid recorded time";
+    strcpy(r->reason, reason);
+
+    chunk_append_row(chunk, &row);
+    return NULL;
+}
+
+#undef FIELD
+
+static gpointer import_chunk_parse(gpointer data) {
+    ImportChunk* chunk = (ImportChunk*)data;
+    const ImportKindInfo* info = &kind_info[chunk->batch->kind];
+    const char* fields[IMPORT_MAX_FIELDS];
+    const char* p = chunk->begin;
+    int line = chunk->first_line;
+
+    while (p < chunk->end && !chunk->failed) {
+        RowHead head = { line, 0, p };
+        int field_count = csv_read_record(&p, chunk->end, chunk->text, fields, IMPORT_MAX_FIELDS, &line);
+        if (field_count < 0) {
+            chunk->failed = 1;
+            break;
+        }
+        if (field_count == 1 && fields[0][0] == '\0') continue;    // blank line
+
+        const char* raw_end = p;
+        while (raw_end > head.raw && (raw_end[-1] == '\n' || raw_end[-1] == '\r')) raw_end--;
+        head.raw_length = (int)(raw_end - head.raw);
+
+        const char* reason = info->parse(chunk, fields, field_count, &head);
+        if (reason != NULL && !reject_add(&chunk->rejects, &head, reason)) chunk->failed = 1;
+    }
+    return NULL;
+}
+
+// ============================================================================
+// PARSING
+// ============================================================================
+
+static ImportBatch* import_batch_new(ImportKind kind) {
+    ImportBatch* batch = (ImportBatch*)calloc(1, sizeof(ImportBatch));
+    if (batch == NULL) return NULL;
+    batch->kind = kind;
+    batch->messages = arena_create("import messages", ARENA_DEFAULT_BLOCK_SIZE);
+    if (batch->messages == NULL) {
+        free(batch);
+        return NULL;
+    }
+    return batch;
+}
+
+// Map the header row onto the fields of the kind
+static int import_read_header(ImportBatch* batch, const char** pos, const char* end, int* line) {
+    const ImportKindInfo* info = &kind_info[batch->kind];
+    const char* names[IMPORT_MAX_FIELDS];
+    batch->header = *pos;
+    int count = csv_read_record(pos, end, batch->messages, names, IMPORT_MAX_FIELDS, line);
+
+    const char* header_end = *pos;
+    while (header_end > batch->header && (header_end[-1] == '\n' || header_end[-1] == '\r')) header_end--;
+    batch->header_length = (int)(header_end - batch->header);
+
+    for (int f = 0; f < IMPORT_MAX_FIELDS; f++) batch->columns[f] = -1;
+    for (int c = 0; c < count && c < IMPORT_MAX_FIELDS; c++) {
+        char* name = g_strstrip(g_ascii_strdown(names[c], -1));
+        for (int f = 0; f < info->field_count; f++) {
+            if (strcmp(name, info->fields[f]) == 0 && batch->columns[f] < 0) batch->columns[f] = c;
+        }
+        g_free(name);
+    }
+
+    for (const int* f = info->required; *f >= 0; f++) {
+        if (batch->columns[*f] < 0) {
+            printf("[ERROR] Import of %s needs a '%s' column\n", info->name, info->fields[*f]);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Cut the data rows into up to IMPORT_MAX_THREADS slices that end on a
+// record boundary. Line breaks inside quoted values are not boundaries,
+// so the quotes are tracked from the start.
+static void import_split(ImportBatch* batch, const char* begin, const char* end, int first_line) {
+    size_t size = (size_t)(end - begin);
+    int wanted = (int)(size / IMPORT_CHUNK_MIN_BYTES);
+    int processors = (int)g_get_num_processors();
+    if (wanted > processors) wanted = processors;
+    if (wanted > IMPORT_MAX_THREADS) wanted = IMPORT_MAX_THREADS;
+    if (wanted < 1) wanted = 1;
+
+    const char* starts[IMPORT_MAX_THREADS + 1];
+    int lines[IMPORT_MAX_THREADS + 1];
+    int count = 1;
+    starts[0] = begin;
+    lines[0] = first_line;
+
+    int line = first_line;
+    int in_quotes = 0;
+    for (const char* p = begin; p < end && count < wanted; p++) {
+        if (*p == '"') {
+            in_quotes = !in_quotes;
+        } else if (*p == '\n') {
+            line++;
+            if (!in_quotes && (size_t)(p + 1 - begin) >= size / wanted * count) {
+                starts[count] = p + 1;
+                lines[count] = line;
+                count++;
+            }
+        }
+    }
+    starts[count] = end;
+
+    batch->chunk_count = count;
+    for (int i = 0; i < count; i++) {
+        ImportChunk* chunk = &batch->chunks[i];
+        chunk->batch = batch;
+        chunk->begin = starts[i];
+        chunk->end = starts[i + 1];
+        chunk->first_line = lines[i];
+    }
+}
+
+ImportBatch* import_parse_file(ImportKind kind, const char* filename) {
+    if ((int)kind < 0 || kind >= IMPORT_KIND_COUNT || filename == NULL) {
+        printf("[ERROR] Invalid import arguments\n");
+        return NULL;
+    }
+
+    ImportBatch* batch = import_batch_new(kind);
+    if (batch == NULL) {
+        printf("[ERROR] Failed to allocate import batch\n");
+        return NULL;
+    }
+
+    GError* error = NULL;
+    gsize size = 0;
+    if (!g_file_get_contents(filename, &batch->data, &size, &error)) {
+        printf("[ERROR] Could not read %s: %s\n", filename, error ? error->message : "unknown error");
+        if (error) g_error_free(error);
+        import_batch_destroy(batch);
+        return NULL;
+    }
+    batch->size = size;
+
+    const char* p = batch->data;
+    const char* end = batch->data + size;
+    if (size >= 3 && memcmp(p, "\xEF\xBB\xBF", 3) == 0) p += 3;    // UTF-8 byte order mark
+
+    int line = 1;
+    if (!import_read_header(batch, &p, end, &line)) {
+        import_batch_destroy(batch);
+        return NULL;
+    }
+    import_split(batch, p, end, line);
+
+    // The first slice is parsed here, the others on their own threads
+    GThread* threads[IMPORT_MAX_THREADS] = { NULL };
+    for (int i = 0; i < batch->chunk_count; i++) {
+        ImportChunk* chunk = &batch->chunks[i];
+        chunk->text = arena_create("import text", IMPORT_TEXT_BLOCK_SIZE);
+        if (chunk->text == NULL) {
+            chunk->failed = 1;
+            continue;
+        }
+        if (i > 0) threads[i] = g_thread_try_new("import", import_chunk_parse, chunk, NULL);
+    }
+    for (int i = 0; i < batch->chunk_count; i++) {
+        ImportChunk* chunk = &batch->chunks[i];
+        if (chunk->text != NULL && threads[i] == NULL) import_chunk_parse(chunk);
+    }
+
+    int failed = 0;
+    for (int i = 0; i < batch->chunk_count; i++) {
+        ImportChunk* chunk = &batch->chunks[i];
+        if (threads[i] != NULL) g_thread_join(threads[i]);
+        failed |= chunk->failed;
+        batch->counts.rows += chunk->count + chunk->rejects.count;
+        batch->counts.rejected += chunk->rejects.count;
+    }
+
+    if (failed) {
+        printf("[ERROR] Out of memory while importing %s\n", filename);
+        import_batch_destroy(batch);
+        return NULL;
+    }
+    printf("[OK] Parsed %d %s rows from %s on %d thread(s), %d rejected\n",
+           batch->counts.rows, kind_info[kind].name, filename, batch->chunk_count, batch->counts.rejected);
+    return batch;
+}
+
+// ============================================================================
+// APPLYING (main thread)
+// ============================================================================
+
+static void batch_reject(ImportBatch* batch, const RowHead* head, const char* format, ...) {
+    char reason[256];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(reason, sizeof(reason), format, args);
+    va_end(args);
+
+    const char* copy = arena_strndup(batch->messages, reason, sizeof(reason));
+    reject_add(&batch->rejects, head, copy ? copy : "rejected");
+    batch->counts.rejected++;
+}
+
+#define FOR_EACH_ROW(batch, type, row)                                              \
+    for (int chunk_index_ = 0; chunk_index_ < (batch)->chunk_count; chunk_index_++) \
+        for (type* row = (type*)(batch)->chunks[chunk_index_].rows;                 \
+             row < (type*)(batch)->chunks[chunk_index_].rows + (batch)->chunks[chunk_index_].count; row++)
+
+// Live student ids, to check the student of a grade or attendance row
+static GHashTable* student_id_set(StudentList* students) {
+    if (students == NULL || students->students == NULL) return NULL;
+    GHashTable* ids = g_hash_table_new(g_direct_hash, g_direct_equal);
+    for (int i = 0; i < students->count; i++) {
+        if (!students->students[i].is_deleted) g_hash_table_add(ids, GINT_TO_POINTER(students->students[i].id));
+    }
+    return ids;
+}
+
+static int import_apply_students(ImportBatch* batch, StudentList* list) {
+    // Both map to list index + 1
+    GHashTable* by_id = g_hash_table_new(g_direct_hash, g_direct_equal);
+    GHashTable* by_email = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    int max_id = 0;
+    for (int i = 0; i < list->count; i++) {
+        Student* s = &list->students[i];
+        if (s->is_deleted) continue;
+        g_hash_table_insert(by_id, GINT_TO_POINTER(s->id), GINT_TO_POINTER(i + 1));
+        g_hash_table_insert(by_email, g_ascii_strdown(s->email, -1), GINT_TO_POINTER(i + 1));
+        if (s->id > max_id) max_id = s->id;
+    }
+
+    // One write section for the whole batch: readers see all of it or none
+    table_lock_write(list->lock);
+    FOR_EACH_ROW(batch, StudentRow, row) {
+        Student values = row->student;
+        values.course = intern_string(row->course);
+
+        char* email_key = g_ascii_strdown(values.email, -1);
+        int id_index = values.id > 0 ? GPOINTER_TO_INT(g_hash_table_lookup(by_id, GINT_TO_POINTER(values.id))) : 0;
+        int email_index = GPOINTER_TO_INT(g_hash_table_lookup(by_email, email_key));
+        int index = id_index ? id_index : email_index;
+
+        if (email_index && email_index != index) {
+            batch_reject(batch, &row->head, "email already used by student %d", list->students[email_index - 1].id);
+            g_free(email_key);
+            continue;
+        }
+
+        if (index) {
+            Student* current = &list->students[index - 1];
+            char* old_key = g_ascii_strdown(current->email, -1);
+            values.id = current->id;
+            if (!student_list_update_locked(list, current, &values)) {
+                batch_reject(batch, &row->head, "could not update student %d", values.id);
+                g_free(old_key);
+                g_free(email_key);
+                continue;
+            }
+            if (strcmp(old_key, email_key) != 0) g_hash_table_remove(by_email, old_key);
+            g_hash_table_insert(by_email, email_key, GINT_TO_POINTER(index));
+            g_free(old_key);
+            batch->counts.updated++;
+        } else {
+            if (values.id <= 0) values.id = max_id + 1;
+            if (!student_list_add_locked(list, values)) {
+                batch_reject(batch, &row->head, "could not add student");
+                g_free(email_key);
+                continue;
+            }
+            if (values.id > max_id) max_id = values.id;
+            g_hash_table_insert(by_id, GINT_TO_POINTER(values.id), GINT_TO_POINTER(list->count));
+            g_hash_table_insert(by_email, email_key, GINT_TO_POINTER(list->count));
+            batch->counts.inserted++;
+        }
+    }
+    table_unlock_write(list->lock);
+
+    g_hash_table_destroy(by_id);
+    g_hash_table_destroy(by_email);
+    return 1;
+}
+
+static int import_apply_grades(ImportBatch* batch, GradeList* list, StudentList* students, liste_examen* exams) {
+    GHashTable* student_ids = student_id_set(students);
+    GHashTable* exam_ids = NULL;
+    if (exams != NULL) {
+        exam_ids = g_hash_table_new(g_direct_hash, g_direct_equal);
+        for (int i = 0; i < exams->count; i++) g_hash_table_add(exam_ids, GINT_TO_POINTER(exams->exam[i].id_examen));
+    }
+
+    // (student, exam) -> list index + 1; the keys live in one array
+    gint64* keys = g_new(gint64, list->count + batch->counts.rows + 1);
+    int key_count = 0;
+    GHashTable* by_pair = g_hash_table_new(g_int64_hash, g_int64_equal);
+    for (int i = 0; i < list->count; i++) {
+        Note* n = &list->note[i];
+        if (n->is_deleted) continue;
+        keys[key_count] = ((gint64)n->id_etudiant << 32) | (guint32)n->id_examen;
+        g_hash_table_insert(by_pair, &keys[key_count++], GINT_TO_POINTER(i + 1));
+    }
+
+    table_lock_write(list->lock);
+    FOR_EACH_ROW(batch, GradeRow, row) {
+        const Note* grade = &row->grade;
+        if (student_ids && !g_hash_table_contains(student_ids, GINT_TO_POINTER(grade->id_etudiant))) {
+            batch_reject(batch, &row->head, "unknown student %d", grade->id_etudiant);
+            continue;
+        }
+        if (exam_ids && !g_hash_table_contains(exam_ids, GINT_TO_POINTER(grade->id_examen))) {
+            batch_reject(batch, &row->head, "unknown exam %d", grade->id_examen);
+            continue;
+        }
+
+        keys[key_count] = ((gint64)grade->id_etudiant << 32) | (guint32)grade->id_examen;
+        int index = GPOINTER_TO_INT(g_hash_table_lookup(by_pair, &keys[key_count]));
+        if (index) {
+            list->note[index - 1].note_obtenue = grade->note_obtenue;
+            list->note[index - 1].present = grade->present;
+            list->dirty = 1;
+            changelog_record(list->lock, CHANGE_GRADES, CHANGE_UPDATE, &list->note[index - 1]);
+            batch->counts.updated++;
+            continue;
+        }
+
+        if (!note_ajouter_locked(list, grade)) {
+            batch_reject(batch, &row->head, "could not add grade");
+            continue;
+        }
+        g_hash_table_insert(by_pair, &keys[key_count++], GINT_TO_POINTER(list->count));
+        batch->counts.inserted++;
+    }
+    table_unlock_write(list->lock);
+
+    g_hash_table_destroy(by_pair);
+    g_free(keys);
+    if (exam_ids) g_hash_table_destroy(exam_ids);
+    if (student_ids) g_hash_table_destroy(student_ids);
+    return 1;
+}
+
+static int import_apply_attendance(ImportBatch* batch, AttendanceList* list, StudentList* students) {
+    GHashTable* student_ids = student_id_set(students);
+    GHashTable* by_id = g_hash_table_new(g_direct_hash, g_direct_equal);
+    int max_id = 0;
+    for (int i = 0; i < list->count; i++) {
+        AttendanceRecord* r = &list->records[i];
+        if (r->is_deleted) continue;
+        g_hash_table_insert(by_id, GINT_TO_POINTER(r->id), GINT_TO_POINTER(i + 1));
+        if (r->id > max_id) max_id = r->id;
+    }
+
+    table_lock_write(list->lock);
+    FOR_EACH_ROW(batch, AttendanceRow, row) {
+        AttendanceRecord record = row->record;
+        if (student_ids && !g_hash_table_contains(student_ids, GINT_TO_POINTER(record.student_id))) {
+            batch_reject(batch, &row->head, "unknown student %d", record.student_id);
+            continue;
+        }
+
+        int index = record.id > 0 ? GPOINTER_TO_INT(g_hash_table_lookup(by_id, GINT_TO_POINTER(record.id))) : 0;
+        if (index) {
+            list->records[index - 1] = record;
+            list->dirty = 1;
+            changelog_record(list->lock, CHANGE_ATTENDANCE, CHANGE_UPDATE, &list->records[index - 1]);
+            batch->counts.updated++;
+            continue;
+        }
+
+        if (record.id <= 0) record.id = max_id + 1;
+        if (!attendance_list_add_locked(list, record)) {
+            batch_reject(batch, &row->head, "could not add attendance record");
+            continue;
+        }
+        if (record.id > max_id) max_id = record.id;
+        g_hash_table_insert(by_id, GINT_TO_POINTER(record.id), GINT_TO_POINTER(list->count));
+        batch->counts.inserted++;
+    }
+    table_unlock_write(list->lock);
+
+    g_hash_table_destroy(by_id);
+    if (student_ids) g_hash_table_destroy(student_ids);
+    return 1;
+}
+
+int import_batch_apply(ImportBatch* batch, const ImportTargets* targets) {
+    if (batch == NULL || targets == NULL || batch->applied) {
+        printf("[ERROR] Invalid import batch\n");
+        return 0;
+    }
+
+    int ok = 0;
+    switch (batch->kind) {
+        case IMPORT_STUDENTS:
+            ok = targets->students && targets->students->students &&
+                 import_apply_students(batch, targets->students);
+            break;
+        case IMPORT_GRADES:
+            ok = targets->grades &&
+                 import_apply_grades(batch, targets->grades, targets->students, targets->exams);
+            break;
+        case IMPORT_ATTENDANCE:
+            ok = targets->attendance &&
+                 import_apply_attendance(batch, targets->attendance, targets->students);
+            break;
+        default:
+            break;
+    }
+    if (!ok) {
+        printf("[ERROR] The %s table is not loaded\n", kind_info[batch->kind].name);
+        return 0;
+    }
+
+    batch->applied = 1;
+    printf("[OK] Imported %s: %d added, %d updated, %d rejected\n", kind_info[batch->kind].name,
+           batch->counts.inserted, batch->counts.updated, batch->counts.rejected);
+    return 1;
+}
+
+// ============================================================================
+// REPORT
+// ============================================================================
+
+const ImportCounts* import_batch_counts(const ImportBatch* batch) {
+    return batch ? &batch->counts : NULL;
+}
+
+static int reject_compare(const void* a, const void* b) {
+    int x = ((const ImportReject*)a)->head.line;
+    int y = ((const ImportReject*)b)->head.line;
+    return (x > y) - (x < y);
+}
+
+static void report_put_text(FILE* file, const char* text) {
+    if (strcspn(text, ",\"\r\n") == strlen(text)) {
+        fputs(text, file);
+        return;
+    }
+    fputc('"', file);
+    for (const char* p = text; *p; p++) {
+        if (*p == '"') fputc('"', file);
+        fputc(*p, file);
+    }
+    fputc('"', file);
+}
+
+int import_batch_write_rejects(const ImportBatch* batch, const char* filename) {
+    if (batch == NULL || filename == NULL) return 0;
+
+    int total = batch->rejects.count;
+    for (int i = 0; i < batch->chunk_count; i++) total += batch->chunks[i].rejects.count;
+
+    ImportReject* all = (ImportReject*)malloc((total + 1) * sizeof(ImportReject));
+    if (all == NULL) {
+        printf("[ERROR] Failed to allocate the import report\n");
+        return 0;
+    }
+    int n = 0;
+    for (int i = 0; i < batch->chunk_count; i++) {
+        memcpy(all + n, batch->chunks[i].rejects.items, batch->chunks[i].rejects.count * sizeof(ImportReject));
+        n += batch->chunks[i].rejects.count;
+    }
+    memcpy(all + n, batch->rejects.items, batch->rejects.count * sizeof(ImportReject));
+    qsort(all, total, sizeof(ImportReject), reject_compare);
+
+    FILE* file = fopen(filename, "wb");
+    if (file == NULL) {
+        printf("[ERROR] Could not open %s for the import report\n", filename);
+        free(all);
+        return 0;
+    }
+
+    // The original columns follow, so fixed rows can be cut out and imported again
+    fputs("line,error,", file);
+    fwrite(batch->header, 1, batch->header_length, file);
+    fputs("\r\n", file);
+    for (int i = 0; i < total; i++) {
+        fprintf(file, "%d,", all[i].head.line);
+        report_put_text(file, all[i].reason);
+        fputc(',', file);
+        fwrite(all[i].head.raw, 1, all[i].head.raw_length, file);
+        fputs("\r\n", file);
+    }
+
+    int ok = !ferror(file);
+    if (fclose(file) != 0) ok = 0;
+    free(all);
+    return ok;
+}
+
+void import_batch_destroy(ImportBatch* batch) {
+    if (batch == NULL) return;
+    for (int i = 0; i < batch->chunk_count; i++) {
+        arena_destroy(batch->chunks[i].text);
+        free(batch->chunks[i].rows);
+        free(batch->chunks[i].rejects.items);
+    }
+    free(batch->rejects.items);
+    arena_destroy(batch->messages);
+    g_free(batch->data);
+    free(batch);
+}
@@ -0,0 +1,192 @@
+#include "intern.h"
+#include "arena.h"
+#include <stdatomic.h>
+
+// Arrays replaced by a grow, kept until intern_clear() so a lookup racing
+// with the grow can finish reading the old one
+typedef struct RetiredStrings {
+    struct RetiredStrings* next;
+    const char** strings;
+} RetiredStrings;
+
+typedef struct {
+    Arena* text;             // string storage; blocks never move so lookups stay valid
+    const char** _Atomic strings;  // id -> text
+    unsigned int* hashes;    // id -> hash of text
+    _Atomic int count;
+    int capacity;
+    RetiredStrings* retired;
+    InternId* slots;         // open addressing, id + 1 (0 = empty)
+    int slot_capacity;       // power of two
+} InternTable;
+
+static InternTable g_intern = {0};
+
+// ============================================================================
+// HASHING AND STORAGE
+// ============================================================================
+
+static unsigned int intern_hash(const char* text) {
+    unsigned int hash = 2166136261u;
+    for (const unsigned char* p = (const unsigned char*)text; *p; p++) {
+        hash ^= *p;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static const char* intern_store(const char* text) {
+    if (g_intern.text == NULL) {
+        g_intern.text = arena_create("interned strings", INTERN_BLOCK_SIZE);
+        if (g_intern.text == NULL) return NULL;
+    }
+    return arena_strndup(g_intern.text, text, 0);
+}
+
+static int intern_grow_slots(void) {
+    int new_capacity = g_intern.slot_capacity > 0 ? g_intern.slot_capacity * 2 : 256;
+    InternId* slots = (InternId*)calloc(new_capacity, sizeof(InternId));
+    if (slots == NULL) {
+        printf("[ERROR] Failed to grow intern table\n");
+        return 0;
+    }
+
+    unsigned int mask = (unsigned int)new_capacity - 1;
+    for (int id = 0; id < g_intern.count; id++) {
+        unsigned int slot = g_intern.hashes[id] & mask;
+        while (slots[slot] != 0) slot = (slot + 1) & mask;
+        slots[slot] = (InternId)id + 1;
+    }
+
+    free(g_intern.slots);
+    g_intern.slots = slots;
+    g_intern.slot_capacity = new_capacity;
+    return 1;
+}
+
+// The id -> text array is copied rather than realloc'd: the saver thread
+// may be reading the old one, so it is retired instead of freed
+static int intern_grow_strings(void) {
+    int new_capacity = g_intern.capacity > 0 ? g_intern.capacity * 2 : 128;
+    const char** strings = (const char**)malloc(new_capacity * sizeof(const char*));
+    RetiredStrings* retired = (RetiredStrings*)malloc(sizeof(RetiredStrings));
+    if (strings == NULL || retired == NULL) {
+        printf("[ERROR] Failed to grow intern table\n");
+        free(strings);
+        free(retired);
+        return 0;
+    }
+    if (g_intern.count > 0) {
+        memcpy(strings, g_intern.strings, g_intern.count * sizeof(const char*));
+    }
+    retired->strings = g_intern.strings;
+    retired->next = g_intern.retired;
+    g_intern.retired = retired;
+    atomic_store_explicit(&g_intern.strings, strings, memory_order_release);
+
+    unsigned int* hashes = (unsigned int*)realloc(g_intern.hashes, new_capacity * sizeof(unsigned int));
+    if (hashes == NULL) {
+        printf("[ERROR] Failed to grow intern table\n");
+        return 0;
+    }
+    g_intern.hashes = hashes;
+    g_intern.capacity = new_capacity;
+    return 1;
+}
+
+// Slot holding text, or the empty slot where it would go
+static unsigned int intern_probe(const char* text, unsigned int hash) {
+    unsigned int mask = (unsigned int)g_intern.slot_capacity - 1;
+    unsigned int slot = hash & mask;
+    while (g_intern.slots[slot] != 0) {
+        InternId id = g_intern.slots[slot] - 1;
+        if (g_intern.hashes[id] == hash && strcmp(g_intern.strings[id], text) == 0) {
+            break;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+static InternId intern_insert(const char* text, unsigned int hash) {
+    // Keep the table at most half full
+    if ((g_intern.count + 1) * 2 > g_intern.slot_capacity && !intern_grow_slots()) {
+        return INTERN_NOT_FOUND;
+    }
+    if (g_intern.count >= g_intern.capacity && !intern_grow_strings()) {
+        return INTERN_NOT_FOUND;
+    }
+
+    const char* copy = intern_store(text);
+    if (copy == NULL) return INTERN_NOT_FOUND;
+
+    // Publish the count last, so a reader that sees the id sees its text
+    InternId id = (InternId)g_intern.count;
+    g_intern.strings[id] = copy;
+    g_intern.hashes[id] = hash;
+    g_intern.slots[intern_probe(text, hash)] = id + 1;
+    atomic_store_explicit(&g_intern.count, (int)id + 1, memory_order_release);
+    return id;
+}
+
+// ============================================================================
+// INTERNING
+// ============================================================================
+
+// Id of text, adding it on first sight. Falls back to INTERN_EMPTY when
+// out of memory so callers always get a printable id.
+InternId intern_string(const char* text) {
+    if (text == NULL || text[0] == '\0') {
+        text = "";
+    }
+
+    // Id 0 is reserved for the empty string
+    if (g_intern.count == 0 && intern_insert("", intern_hash("")) != INTERN_EMPTY) {
+        return INTERN_EMPTY;
+    }
+
+    unsigned int hash = intern_hash(text);
+    unsigned int slot = intern_probe(text, hash);
+    if (g_intern.slots[slot] != 0) {
+        return g_intern.slots[slot] - 1;
+    }
+
+    InternId id = intern_insert(text, hash);
+    return id == INTERN_NOT_FOUND ? INTERN_EMPTY : id;
+}
+
+// Id of text if it was interned before, INTERN_NOT_FOUND otherwise
+InternId intern_find(const char* text) {
+    if (text == NULL) text = "";
+    if (g_intern.count == 0) {
+        return text[0] == '\0' ? INTERN_EMPTY : INTERN_NOT_FOUND;
+    }
+
+    unsigned int slot = intern_probe(text, intern_hash(text));
+    return g_intern.slots[slot] != 0 ? g_intern.slots[slot] - 1 : INTERN_NOT_FOUND;
+}
+
+// Safe to call from the saver thread while the main thread interns
+const char* intern_lookup(InternId id) {
+    int count = atomic_load_explicit(&g_intern.count, memory_order_acquire);
+    if (id >= (InternId)count) return "";
+    return atomic_load_explicit(&g_intern.strings, memory_order_acquire)[id];
+}
+
+int intern_count(void) {
+    return g_intern.count;
+}
+
+void intern_clear(void) {
+    while (g_intern.retired != NULL) {
+        RetiredStrings* next = g_intern.retired->next;
+        free(g_intern.retired->strings);
+        free(g_intern.retired);
+        g_intern.retired = next;
+    }
+    arena_destroy(g_intern.text);
+    free(g_intern.strings);
+    free(g_intern.hashes);
+    free(g_intern.slots);
+    memset(&g_intern, 0, sizeof(g_intern));
+}
@@ -0,0 +1,171 @@
+#include "job.h"
+#include "trace.h"
+#include <glib.h>
+#include <stdatomic.h>
+
+struct Job {
+    JobSpec spec;
+    void* data;
+    void* result;
+    atomic_int cancelled;
+    atomic_int refs;            // the finish idle, plus one per queued progress idle
+
+    GMutex progress_lock;       // guards the three fields below
+    double fraction;
+    char message[128];
+    int progress_queued;
+
+    Job* next_live;             // main thread only
+};
+
+static GThreadPool* g_pool = NULL;
+static Job* g_live_jobs = NULL;
+
+// ============================================================================
+// LIFETIME
+// ============================================================================
+
+static void job_unref(Job* job) {
+    if (atomic_fetch_sub(&job->refs, 1) != 1) return;
+
+    if (job->result != NULL && job->spec.free_result) {
+        job->spec.free_result(job->result);
+    }
+    if (job->spec.free_data) {
+        job->spec.free_data(job->data);
+    }
+    g_mutex_clear(&job->progress_lock);
+    free(job);
+}
+
+static void job_unlink(Job* job) {
+    for (Job** link = &g_live_jobs; *link != NULL; link = &(*link)->next_live) {
+        if (*link == job) {
+            *link = job->next_live;
+            break;
+        }
+    }
+}
+
+// ============================================================================
+// MAIN LOOP SIDE
+// ============================================================================
+
+static gboolean job_progress_idle(gpointer user_data) {
+    Job* job = (Job*)user_data;
+
+    g_mutex_lock(&job->progress_lock);
+    double fraction = job->fraction;
+    char message[sizeof(job->message)];
+    memcpy(message, job->message, sizeof(message));
+    job->progress_queued = 0;
+    g_mutex_unlock(&job->progress_lock);
+
+    if (!job_is_cancelled(job) && job->spec.progress) {
+        job->spec.progress(fraction, message, job->data);
+    }
+    job_unref(job);
+    return G_SOURCE_REMOVE;
+}
+
+// Queued after the last progress report, so it runs after it
+static gboolean job_finish_idle(gpointer user_data) {
+    Job* job = (Job*)user_data;
+    job_unlink(job);
+
+    if (!job_is_cancelled(job) && job->spec.done) {
+        TRACE_SCOPE("job done");
+        void* result = job->result;
+        job->result = NULL;
+        job->spec.done(result, job->data);
+    }
+    job_unref(job);
+    return G_SOURCE_REMOVE;
+}
+
+// ============================================================================
+// WORKER SIDE
+// ============================================================================
+
+static void job_thread(gpointer data, gpointer pool_data) {
+    (void)pool_data;
+    Job* job = (Job*)data;
+
+    // A job cancelled while still queued never starts
+    if (!job_is_cancelled(job)) {
+        TRACE_THREAD_NAME("job worker");
+        TRACE_BEGIN(job->spec.name);
+        job->result = job->spec.run(job, job->data);
+        TRACE_END();
+    }
+    g_idle_add(job_finish_idle, job);
+}
+
+int job_is_cancelled(Job* job) {
+    return job == NULL || atomic_load(&job->cancelled);
+}
+
+void job_report_progress(Job* job, double fraction, const char* message) {
+    if (job == NULL) return;
+
+    g_mutex_lock(&job->progress_lock);
+    job->fraction = fraction;
+    snprintf(job->message, sizeof(job->message), "%s", message ? message : "");
+    if (!job->progress_queued) {
+        job->progress_queued = 1;
+        atomic_fetch_add(&job->refs, 1);
+        g_idle_add(job_progress_idle, job);
+    }
+    g_mutex_unlock(&job->progress_lock);
+}
+
+// ============================================================================
+// API
+// ============================================================================
+
+Job* job_submit(const JobSpec* spec, void* data) {
+    if (spec == NULL || spec->run == NULL) {
+        printf("[ERROR] Invalid job\n");
+        return NULL;
+    }
+
+    if (g_pool == NULL) {
+        g_pool = g_thread_pool_new(job_thread, NULL, JOB_MAX_THREADS, FALSE, NULL);
+    }
+    Job* job = (Job*)calloc(1, sizeof(Job));
+    if (g_pool == NULL || job == NULL) {
+        printf("[ERROR] Could not start job '%s'\n", spec->name ? spec->name : "job");
+        free(job);
+        if (spec->free_data) spec->free_data(data);
+        return NULL;
+    }
+
+    job->spec = *spec;
+    if (job->spec.name == NULL) job->spec.name = "job";
+    job->data = data;
+    atomic_init(&job->cancelled, 0);
+    atomic_init(&job->refs, 1);
+    g_mutex_init(&job->progress_lock);
+
+    job->next_live = g_live_jobs;
+    g_live_jobs = job;
+    g_thread_pool_push(g_pool, job, NULL);
+    return job;
+}
+
+void job_cancel(Job* job) {
+    if (job == NULL) return;
+    atomic_store(&job->cancelled, 1);
+}
+
+void jobs_shutdown(void) {
+    for (Job* job = g_live_jobs; job != NULL; job = job->next_live) {
+        job_cancel(job);
+    }
+    if (g_pool != NULL) {
+        // Waits for the running jobs; the queued ones see the cancel and
+        // return at once
+        g_thread_pool_free(g_pool, FALSE, TRUE);
+        g_pool = NULL;
+    }
+}
@@ -0,0 +1,138 @@
+#include "metrics.h"
+#include "utils.h"
+#include <glib.h>
+
+static MetricsTable g_tables[METRICS_MAX_TABLES];
+static int g_table_count = 0;
+
+static char g_disk_path[UTILS_MAX_PATH_LENGTH] = ".";
+static char* g_dump_file = NULL;
+static guint g_timer = 0;
+static CpuSampler g_dump_cpu;      // the dump's own, apart from the admin view's
+
+// ============================================================================
+// SAMPLING
+// ============================================================================
+
+int metrics_register_table(const MetricsTable* table) {
+    if (table == NULL || table->name == NULL || table->count == NULL || table->capacity == NULL) {
+        printf("[ERROR] Invalid metrics table\n");
+        return 0;
+    }
+    if (g_table_count >= METRICS_MAX_TABLES) {
+        printf("[ERROR] Too many metrics tables (max %d)\n", METRICS_MAX_TABLES);
+        return 0;
+    }
+    g_tables[g_table_count++] = *table;
+    return 1;
+}
+
+void metrics_sample(MetricsSample* sample, CpuSampler* cpu) {
+    if (sample == NULL) return;
+    memset(sample, 0, sizeof(*sample));
+
+    sample->taken_at = time(NULL);
+    utils_system_get_uptime(&sample->uptime_seconds);
+    utils_system_get_memory_usage(&sample->rss_bytes);
+    utils_system_get_cpu_usage(cpu, &sample->cpu_percent);
+    utils_system_get_disk_usage(g_disk_path, &sample->disk_total_bytes, &sample->disk_free_bytes);
+    sample->arena_bytes = arena_total_reserved();
+
+    for (int i = 0; i < g_table_count; i++) {
+        const MetricsTable* table = &g_tables[i];
+        MetricsTableUsage* usage = &sample->tables[sample->n_tables++];
+        usage->name = table->name;
+        usage->rows = *table->count;
+        usage->capacity = *table->capacity;
+        usage->bytes_used = (size_t)usage->rows * table->record_size;
+        usage->bytes_reserved = (size_t)usage->capacity * table->record_size;
+
+        const Arena* strings = table->strings ? *table->strings : NULL;
+        if (strings) {
+            usage->bytes_used += strings->bytes_used;
+            usage->bytes_reserved += strings->counters.bytes_reserved;
+        }
+        sample->table_bytes_used += usage->bytes_used;
+        sample->table_bytes_reserved += usage->bytes_reserved;
+    }
+}
+
+char* metrics_sample_to_json(const MetricsSample* sample) {
+    if (sample == NULL) return NULL;
+
+    GString* json = g_string_new(NULL);
+    g_string_append_printf(json,
+        "{\"time\": %lld, \"uptime_s\": %ld, \"rss_bytes\": %zu, \"cpu_percent\": %.1f, "
+        "\"disk_total_bytes\": %zu, \"disk_free_bytes\": %zu, \"arena_bytes\": %zu, "
+        "\"table_bytes_used\": %zu, \"table_bytes_reserved\": %zu, \"tables\": {",
+        (long long)sample->taken_at, sample->uptime_seconds, sample->rss_bytes,
+        sample->cpu_percent, sample->disk_total_bytes, sample->disk_free_bytes,
+        sample->arena_bytes, sample->table_bytes_used, sample->table_bytes_reserved);
+    for (int i = 0; i < sample->n_tables; i++) {
+        const MetricsTableUsage* usage = &sample->tables[i];
+        // Table names are fixed identifiers chosen by the caller
+        g_string_append_printf(json,
+            "%s\"%s\": {\"rows\": %d, \"capacity\": %d, \"bytes_used\": %zu, \"bytes_reserved\": %zu}",
+            i ? ", " : "", usage->name, usage->rows, usage->capacity,
+            usage->bytes_used, usage->bytes_reserved);
+    }
+    g_string_append(json, "}}");
+    return g_string_free(json, FALSE);
+}
+
+// ============================================================================
+// PERIODIC DUMP
+// ============================================================================
+
+static int metrics_append(const char* filename) {
+    MetricsSample sample;
+    metrics_sample(&sample, &g_dump_cpu);
+    char* line = metrics_sample_to_json(&sample);
+
+    FILE* f = fopen(filename, "a");
+    if (f == NULL) {
+        printf("[WARNING] Cannot append metrics to %s\n", filename);
+        g_free(line);
+        return 0;
+    }
+    fprintf(f, "%s\n", line);
+    fclose(f);
+    g_free(line);
+    return 1;
+}
+
+static gboolean metrics_tick(gpointer data) {
+    (void)data;
+    if (g_dump_file) metrics_append(g_dump_file);
+    return G_SOURCE_CONTINUE;
+}
+
+int metrics_start(unsigned int interval_seconds, const char* data_dir, const char* filename) {
+    if (filename == NULL || interval_seconds == 0) return 0;
+    if (g_timer) {
+        printf("[WARNING] Metrics dump already running\n");
+        return 0;
+    }
+    if (data_dir && data_dir[0]) {
+        snprintf(g_disk_path, sizeof(g_disk_path), "%s", data_dir);
+    }
+    g_dump_file = g_strdup(filename);
+    memset(&g_dump_cpu, 0, sizeof(g_dump_cpu));
+
+    // A first line right away marks the start of the session
+    metrics_append(g_dump_file);
+    g_timer = g_timeout_add_seconds(interval_seconds, metrics_tick, NULL);
+    return 1;
+}
+
+void metrics_stop(void) {
+    if (g_timer) {
+        g_source_remove(g_timer);
+        g_timer = 0;
+        // The last line shows the state at shutdown
+        metrics_append(g_dump_file);
+    }
+    g_free(g_dump_file);
+    g_dump_file = NULL;
+    g_table_count = 0;
+}
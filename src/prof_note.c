@@ -1,4 +1,22 @@
 #include "../include/prof_note.h"
+#include "../include/arena.h"
+#include "../include/utils.h"
+#include "../include/changelog.h"
+
+// Grow the notes array to hold at least needed notes in one realloc
+static int prof_note_reserve(ProfessorNoteList* list, int needed) {
+    if (needed <= list->capacity) return 1;
+    
+    int new_capacity = list->capacity > 0 ? list->capacity : 100;
+    while (new_capacity < needed) new_capacity *= 2;
+    
+    ProfessorNote* new_notes = (ProfessorNote*)realloc(list->notes, sizeof(ProfessorNote) * new_capacity);
+    if (!new_notes) return 0;
+    
+    list->notes = new_notes;
+    list->capacity = new_capacity;
+    return 1;
+}
 
 ProfessorNoteList* prof_note_list_create(void) {
     ProfessorNoteList* list = (ProfessorNoteList*)malloc(sizeof(ProfessorNoteList));
@@ -8,6 +26,8 @@ ProfessorNoteList* prof_note_list_create(void) {
     list->count = 0;
     list->notes = (ProfessorNote*)malloc(sizeof(ProfessorNote) * list->capacity);
     list->filename[0] = '\0';
+    list->dirty = 0;
+    list->lock = NULL;
     
     if (!list->notes) {
         free(list);
@@ -22,6 +42,7 @@ void prof_note_list_destroy(ProfessorNoteList* list) {
         if (list->notes) {
             free(list->notes);
         }
+        table_lock_destroy(list->lock);
         free(list);
     }
 }
@@ -30,13 +51,10 @@ int prof_note_create(ProfessorNoteList* list, int student_id, int module_id, int
     if (!list || !content) return 0;
     
     // Resize if needed
-    if (list->count >= list->capacity) {
-        int new_capacity = list->capacity * 2;
-        ProfessorNote* new_notes = (ProfessorNote*)realloc(list->notes, sizeof(ProfessorNote) * new_capacity);
-        if (!new_notes) return 0;
-        
-        list->notes = new_notes;
-        list->capacity = new_capacity;
+    table_lock_write(list->lock);
+    if (!prof_note_reserve(list, list->count + 1)) {
+        table_unlock_write(list->lock);
+        return 0;
     }
     
     ProfessorNote* note = &list->notes[list->count];
@@ -62,9 +80,47 @@ int prof_note_create(ProfessorNoteList* list, int student_id, int module_id, int
     strftime(note->date, sizeof(note->date), "%Y-%m-%d", t);
     
     list->count++;
+    list->dirty = 1;
+    changelog_record(list->lock, CHANGE_PROF_NOTES, CHANGE_INSERT, note);
+    table_unlock_write(list->lock);
     return 1;
 }
 
+int prof_note_list_add(ProfessorNoteList* list, ProfessorNote note) {
+    if (!list) return 0;
+
+    table_lock_write(list->lock);
+    if (!prof_note_reserve(list, list->count + 1)) {
+        table_unlock_write(list->lock);
+        return 0;
+    }
+    list->notes[list->count++] = note;
+    list->dirty = 1;
+    changelog_record(list->lock, CHANGE_PROF_NOTES, CHANGE_INSERT, &list->notes[list->count - 1]);
+    table_unlock_write(list->lock);
+    return 1;
+}
+
+// Copy of the notes, safe to take from any thread
+ProfessorNoteList* prof_note_list_snapshot(const ProfessorNoteList* list) {
+    if (!list) return NULL;
+    
+    ProfessorNoteList* copy = prof_note_list_create();
+    if (!copy) return NULL;
+    
+    table_lock_read(list->lock);
+    if (!prof_note_reserve(copy, list->count)) {
+        table_unlock_read(list->lock);
+        prof_note_list_destroy(copy);
+        return NULL;
+    }
+    memcpy(copy->notes, list->notes, sizeof(ProfessorNote) * list->count);
+    copy->count = list->count;
+    strcpy(copy->filename, list->filename);
+    table_unlock_read(list->lock);
+    return copy;
+}
+
 int prof_note_save(ProfessorNoteList* list, const char* filename) {
     if (!list || !filename) return 0;
     
@@ -102,17 +158,21 @@ int prof_note_load(ProfessorNoteList* list, const char* filename) {
     FILE* f = fopen(filename, "r");
     if (!f) return 0;
     
+    // Size the array for the whole file up front
+    table_lock_write(list->lock);
+    long lines = utils_file_count_lines(f);
+    if (lines > 0 && !prof_note_reserve(list, list->count + (int)lines)) {
+        table_unlock_write(list->lock);
+        fclose(f);
+        return 0;
+    }
+    
     char line[1024];
     while (fgets(line, sizeof(line), f)) {
-        if (list->count >= list->capacity) {
-            int new_capacity = list->capacity * 2;
-            ProfessorNote* new_notes = (ProfessorNote*)realloc(list->notes, sizeof(ProfessorNote) * new_capacity);
-            if (!new_notes) {
-                fclose(f);
-                return 0;
-            }
-            list->notes = new_notes;
-            list->capacity = new_capacity;
+        if (!prof_note_reserve(list, list->count + 1)) {
+            table_unlock_write(list->lock);
+            fclose(f);
+            return 0;
         }
         
         ProfessorNote* n = &list->notes[list->count];
@@ -133,51 +193,41 @@ int prof_note_load(ProfessorNoteList* list, const char* filename) {
         }
     }
     
+    list->dirty = 0;
+    table_unlock_write(list->lock);
     fclose(f);
     return 1;
 }
 
-ProfessorNote** prof_note_find_by_student(ProfessorNoteList* list, int student_id, int* count) {
+// Collect the notes matching one field into a scratch array
+static ProfessorNote** prof_note_collect(ProfessorNoteList* list, int by_module, int key, int* count) {
     if (!list || !count) return NULL;
     
     *count = 0;
-    // temporary array, could be optimized
-    ProfessorNote** result = (ProfessorNote**)malloc(sizeof(ProfessorNote*) * list->count);
-    if (!result) return NULL;
-    
     for (int i = 0; i < list->count; i++) {
-        if (list->notes[i].student_id == student_id) {
-            result[*count] = &list->notes[i];
-            (*count)++;
-        }
+        int value = by_module ? list->notes[i].module_id : list->notes[i].student_id;
+        if (value == key) (*count)++;
     }
+    if (*count == 0) return NULL;
     
-    if (*count == 0) {
-        free(result);
+    ProfessorNote** result = (ProfessorNote**)arena_alloc(arena_scratch(), sizeof(ProfessorNote*) * (*count));
+    if (!result) {
+        *count = 0;
         return NULL;
     }
     
+    int index = 0;
+    for (int i = 0; i < list->count; i++) {
+        int value = by_module ? list->notes[i].module_id : list->notes[i].student_id;
+        if (value == key) result[index++] = &list->notes[i];
+    }
     return result;
 }
 
+ProfessorNote** prof_note_find_by_student(ProfessorNoteList* list, int student_id, int* count) {
+    return prof_note_collect(list, 0, student_id, count);
+}
+
 ProfessorNote** prof_note_find_by_module(ProfessorNoteList* list, int module_id, int* count) {
-    if (!list || !count) return NULL;
-    
-    *count = 0;
-    ProfessorNote** result = (ProfessorNote**)malloc(sizeof(ProfessorNote*) * list->count);
-    if (!result) return NULL;
-    
-    for (int i = 0; i < list->count; i++) {
-        if (list->notes[i].module_id == module_id) {
-            result[*count] = &list->notes[i];
-            (*count)++;
-        }
-    }
-    
-    if (*count == 0) {
-        free(result);
-        return NULL;
-    }
-    
-    return result;
+    return prof_note_collect(list, 1, module_id, count);
 }
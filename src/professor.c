@@ -1,5 +1,7 @@
 #include "../include/professor.h"
 #include "../include/utils.h"
+#include "../include/arena.h"
+#include "../include/changelog.h"
 #include <ctype.h>
 
 #define INITIAL_CAPACITY 100
@@ -24,6 +26,8 @@ ProfessorList* professor_list_create(void) {
     list->is_loaded = 0;
     list->auto_save_enabled = 0;
     list->last_save_time = time(NULL);
+    list->dirty = 0;
+    list->lock = NULL;
     strcpy(list->filename, "data/professors.txt");
     
     return list;
@@ -36,6 +40,7 @@ void professor_list_destroy(ProfessorList* list) {
     if (list->professors) {
         free(list->professors);
     }
+    table_lock_destroy(list->lock);
     free(list);
 }
 
@@ -53,10 +58,12 @@ int professor_list_add(ProfessorList* list, Professor professor) {
     }
     
     // Check if we need to expand capacity
+    table_lock_write(list->lock);
     if (list->count >= list->capacity) {
         int new_capacity = list->capacity * 2;
         Professor* new_professors = (Professor*)realloc(list->professors, new_capacity * sizeof(Professor));
         if (!new_professors) {
+            table_unlock_write(list->lock);
             fprintf(stderr, "Error: Memory reallocation failed\n");
             return 0;
         }
@@ -66,9 +73,9 @@ int professor_list_add(ProfessorList* list, Professor professor) {
     
     list->professors[list->count++] = professor;
     
-    if (list->auto_save_enabled) {
-        professor_list_save_to_file(list, list->filename);
-    }
+    // The autosave thread writes the list if auto_save_enabled is set
+    list->dirty = 1;
+    table_unlock_write(list->lock);
     
     return 1;
 }
@@ -80,14 +87,13 @@ int professor_list_remove(ProfessorList* list, int professor_id) {
     for (int i = 0; i < list->count; i++) {
         if (list->professors[i].id == professor_id) {
             // Shift all elements after this one
+            table_lock_write(list->lock);
             for (int j = i; j < list->count - 1; j++) {
                 list->professors[j] = list->professors[j + 1];
             }
             list->count--;
-            
-            if (list->auto_save_enabled) {
-                professor_list_save_to_file(list, list->filename);
-            }
+            list->dirty = 1;
+            table_unlock_write(list->lock);
             
             return 1;
         }
@@ -165,8 +171,8 @@ void professor_list_display_professor(Professor* professor) {
     printf("Name: %s %s\n", professor->first_name, professor->last_name);
     printf("Email: %s\n", professor->email);
     printf("Phone: %s\n", professor->phone);
-    printf("Department: %s\n", professor->department);
-    printf("Specialization: %s\n", professor->specialization);
+    printf("Department: %s\n", intern_lookup(professor->department));
+    printf("Specialization: %s\n", intern_lookup(professor->specialization));
     printf("Years of Experience: %d\n", professor->years_of_experience);
     printf("Office: %s\n", professor->office_location);
     printf("Status: %s\n", professor->is_active ? "Active" : "Inactive");
@@ -197,8 +203,8 @@ int professor_list_save_to_file(ProfessorList* list, const char* filename) {
                 p->email,
                 p->phone,
                 p->address,
-                p->department,
-                p->specialization,
+                intern_lookup(p->department),
+                intern_lookup(p->specialization),
                 p->years_of_experience,
                 p->office_location,
                 (long)p->hire_date,
@@ -229,9 +235,12 @@ int professor_list_load_from_file(ProfessorList* list, const char* filename) {
     }
     
     // Clear existing data
+    table_lock_write(list->lock);
     list->count = 0;
+    table_unlock_write(list->lock);
     
     char line[1024];
+    char department[MAX_COURSE_LENGTH], specialization[MAX_COURSE_LENGTH];
     while (fgets(line, sizeof(line), file)) {
         Professor professor = {0};
         long hire_date_long;
@@ -243,20 +252,23 @@ int professor_list_load_from_file(ProfessorList* list, const char* filename) {
                    professor.email,
                    professor.phone,
                    professor.address,
-                   professor.department,
-                   professor.specialization,
+                   department,
+                   specialization,
                    &professor.years_of_experience,
                    professor.office_location,
                    &hire_date_long,
                    &professor.is_active) == 12) {
             
             professor.hire_date = (time_t)hire_date_long;
+            professor.department = intern_string(department);
+            professor.specialization = intern_string(specialization);
             professor_list_add(list, professor);
         }
     }
     
     fclose(file);
     list->is_loaded = 1;
+    list->dirty = 0;
     strcpy(list->filename, filename);
     
     return 1;
@@ -285,25 +297,60 @@ static int compare_by_id(const void* a, const void* b) {
 static int compare_by_department(const void* a, const void* b) {
     Professor* p1 = (Professor*)a;
     Professor* p2 = (Professor*)b;
-    return strcasecmp(p1->department, p2->department);
+    if (p1->department == p2->department) return 0;
+    return strcasecmp(intern_lookup(p1->department), intern_lookup(p2->department));
+}
+
+// Copy of the professors, safe to take from any thread
+ProfessorList* professor_list_snapshot(const ProfessorList* list) {
+    if (!list) return NULL;
+    
+    ProfessorList* copy = professor_list_create();
+    if (!copy) return NULL;
+    
+    table_lock_read(list->lock);
+    if (list->count > copy->capacity) {
+        Professor* professors = (Professor*)realloc(copy->professors, list->count * sizeof(Professor));
+        if (!professors) {
+            table_unlock_read(list->lock);
+            fprintf(stderr, "Error: Memory allocation failed for professors snapshot\n");
+            professor_list_destroy(copy);
+            return NULL;
+        }
+        copy->professors = professors;
+        copy->capacity = list->count;
+    }
+    memcpy(copy->professors, list->professors, list->count * sizeof(Professor));
+    copy->count = list->count;
+    copy->is_loaded = list->is_loaded;
+    copy->auto_save_enabled = list->auto_save_enabled;
+    strcpy(copy->filename, list->filename);
+    table_unlock_read(list->lock);
+    return copy;
 }
 
 // Sort professors by name
 void professor_list_sort_by_name(ProfessorList* list) {
     if (!list || list->count <= 1) return;
+    table_lock_write(list->lock);
     qsort(list->professors, list->count, sizeof(Professor), compare_by_name);
+    table_unlock_write(list->lock);
 }
 
 // Sort professors by ID
 void professor_list_sort_by_id(ProfessorList* list) {
     if (!list || list->count <= 1) return;
+    table_lock_write(list->lock);
     qsort(list->professors, list->count, sizeof(Professor), compare_by_id);
+    table_unlock_write(list->lock);
 }
 
 // Sort professors by department
 void professor_list_sort_by_department(ProfessorList* list) {
     if (!list || list->count <= 1) return;
+    table_lock_write(list->lock);
     qsort(list->professors, list->count, sizeof(Professor), compare_by_department);
+    table_unlock_write(list->lock);
 }
 
 // Update professor information
@@ -318,26 +365,52 @@ int professor_list_update(ProfessorList* list, int professor_id, Professor updat
     
     // Keep the original ID
     updated_professor.id = professor_id;
+    table_lock_write(list->lock);
     *professor = updated_professor;
-    
-    if (list->auto_save_enabled) {
-        professor_list_save_to_file(list, list->filename);
-    }
+    list->dirty = 1;
+    table_unlock_write(list->lock);
     
     return 1;
 }
 
-// Count professors by department
+// Department ids whose name matches, ignoring case. Spellings that differ
+// only in case intern to different ids, so more than one may match.
+// The mask is a scratch allocation.
+static unsigned char* professor_department_mask(const char* department) {
+    int id_count = intern_count();
+    unsigned char* mask = (unsigned char*)arena_calloc(arena_scratch(), id_count + 1, 1);
+    if (!mask) return NULL;
+    
+    for (int id = 0; id < id_count; id++) {
+        mask[id] = strcasecmp(intern_lookup((InternId)id), department) == 0;
+    }
+    return mask;
+}
+
+// Count professors by department: histogram the department ids once,
+// then add up the buckets whose name matches
 int professor_list_count_by_department(ProfessorList* list, const char* department) {
     if (!list || !department) return 0;
     
-    int count = 0;
+    Arena* scratch = arena_scratch();
+    ArenaMark mark = arena_mark(scratch);
+    int id_count = intern_count();
+    int* histogram = (int*)arena_calloc(scratch, id_count + 1, sizeof(int));
+    if (!histogram) return 0;
+    
     for (int i = 0; i < list->count; i++) {
-        if (strcasecmp(list->professors[i].department, department) == 0) {
-            count++;
+        InternId id = list->professors[i].department;
+        if (id < (InternId)id_count) histogram[id]++;
+    }
+    
+    int count = 0;
+    for (int id = 0; id < id_count; id++) {
+        if (histogram[id] > 0 && strcasecmp(intern_lookup((InternId)id), department) == 0) {
+            count += histogram[id];
         }
     }
     
+    arena_release(scratch, mark);
     return count;
 }
 
@@ -351,18 +424,22 @@ Professor** professor_list_filter_by_department(ProfessorList* list, const char*
         return NULL;
     }
     
-    Professor** results = (Professor**)malloc(count * sizeof(Professor*));
-    if (!results) {
+    Arena* scratch = arena_scratch();
+    Professor** results = (Professor**)arena_alloc(scratch, count * sizeof(Professor*));
+    ArenaMark mark = arena_mark(scratch);
+    unsigned char* mask = professor_department_mask(department);
+    if (!results || !mask) {
         *result_count = 0;
         return NULL;
     }
     
     int index = 0;
     for (int i = 0; i < list->count; i++) {
-        if (strcasecmp(list->professors[i].department, department) == 0) {
+        if (mask[list->professors[i].department]) {
             results[index++] = &list->professors[i];
         }
     }
+    arena_release(scratch, mark);
     
     *result_count = count;
     return results;
@@ -387,7 +464,7 @@ int professor_validate(Professor* professor) {
         return 0;
     }
     
-    if (strlen(professor->department) == 0) {
+    if (professor->department == INTERN_EMPTY) {
         fprintf(stderr, "Error: Professor department cannot be empty\n");
         return 0;
     }
@@ -409,8 +486,8 @@ void professor_print_info(Professor* professor) {
     printf("║ Name:            %-38s║\n", full_name);
     printf("║ Email:           %-38s║\n", professor->email);
     printf("║ Phone:           %-38s║\n", professor->phone);
-    printf("║ Department:      %-38s║\n", professor->department);
-    printf("║ Specialization:  %-38s║\n", professor->specialization);
+    printf("║ Department:      %-38s║\n", intern_lookup(professor->department));
+    printf("║ Specialization:  %-38s║\n", intern_lookup(professor->specialization));
     printf("║ Experience:      %-38d║\n", professor->years_of_experience);
     printf("║ Office:          %-38s║\n", professor->office_location);
     printf("║ Status:          %-38s║\n", professor->is_active ? "Active" : "Inactive");
@@ -492,11 +569,6 @@ int professor_create_notes_for_exam(liste_note* grades, liste_examen* exams, int
     printf("Failed: %d notes\n", failed_count);
     printf("Total: %d notes\n", count);
     
-    // Auto-save if any notes were created
-    if (success_count > 0) {
-        sauvegarder_notes_ds_file(grades);
-    }
-    
     return success_count;
 }
 
@@ -521,14 +593,16 @@ int professor_modify_student_note(liste_note* grades, int student_id, int exam_i
     }
     
     float old_note = note->note_obtenue;
+    table_lock_write(grades->lock);
     note->note_obtenue = new_note;
+    // Written by the autosave thread
+    grades->dirty = 1;
+    changelog_record(grades->lock, CHANGE_GRADES, CHANGE_UPDATE, note);
+    table_unlock_write(grades->lock);
     
     printf("Note modified successfully: Student %d - Exam %d\n", student_id, exam_id);
     printf("Old grade: %.2f -> New grade: %.2f\n", old_note, new_note);
     
-    // Auto-save
-    sauvegarder_notes_ds_file(grades);
-    
     return 1;
 }
 
@@ -550,7 +624,8 @@ int professor_can_modify_note(Professor* professor, ListeModules* modules, int e
     
     int has_modules = 0;
     for (int i = 0; i < modules->count; i++) {
-        if (strstr(modules->cours[i].nom_prenom_enseignent, professor->last_name) != NULL) {
+        if (modules->cours[i].is_deleted) continue;
+        if (strstr(intern_lookup(modules->cours[i].nom_prenom_enseignent), professor->last_name) != NULL) {
             has_modules = 1;
             break;
         }
@@ -574,6 +649,7 @@ void professor_display_notes_by_exam(liste_note* grades, int exam_id) {
     
     int count = 0;
     for (int i = 0; i < grades->count; i++) {
+        if (grades->note[i].is_deleted) continue;
         if (grades->note[i].id_examen == exam_id) {
             const char* attendance = grades->note[i].present ? "Present" : "Absent";
             const char* status = grades->note[i].note_obtenue >= 10.0 ? "PASSED" : "FAILED";
@@ -628,7 +704,8 @@ int professor_get_module_count(Professor* professor, ListeModules* modules) {
     
     int count = 0;
     for (int i = 0; i < modules->count; i++) {
-        if (strstr(modules->cours[i].nom_prenom_enseignent, professor->last_name) != NULL) {
+        if (modules->cours[i].is_deleted) continue;
+        if (strstr(intern_lookup(modules->cours[i].nom_prenom_enseignent), professor->last_name) != NULL) {
             count++;
         }
     }
@@ -661,7 +738,8 @@ Module** professor_get_modules(Professor* professor, ListeModules* modules, int*
     // Fill array with matching modules
     int idx = 0;
     for (int i = 0; i < modules->count && idx < module_count; i++) {
-        if (strstr(modules->cours[i].nom_prenom_enseignent, professor->last_name) != NULL) {
+        if (modules->cours[i].is_deleted) continue;
+        if (strstr(intern_lookup(modules->cours[i].nom_prenom_enseignent), professor->last_name) != NULL) {
             result[idx++] = &modules->cours[i];
         }
     }
@@ -0,0 +1,370 @@
+#define _POSIX_C_SOURCE 200809L    // shm_open, posix_fallocate, ftruncate
+#include "replica.h"
+#include "trace.h"
+
+#if !defined(_WIN32) && !defined(_WIN64)
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+typedef struct {
+    uint32_t counts[REPLICA_TABLE_COUNT];
+    size_t strings_size;
+    size_t size;
+    uint64_t offsets[REPLICA_TABLE_COUNT];
+    uint64_t strings_offset;
+} ReplicaLayout;
+
+typedef struct {
+    char* heap;
+    size_t used;
+} ReplicaHeap;
+
+static const size_t record_sizes[REPLICA_TABLE_COUNT] = {
+    sizeof(ReplicaStudent), sizeof(ReplicaGrade), sizeof(ReplicaAttendance),
+    sizeof(ReplicaClub), sizeof(ReplicaMembership)
+};
+
+static ReplicaTables g_tables;
+static char g_name[256] = "";
+static ReplicaControl* g_control = NULL;
+static uint64_t g_generation = 0;
+static char g_current[320] = "";             // name of the published snapshot
+
+// ============================================================================
+// LAYOUT
+// ============================================================================
+
+static size_t string_size(const char* s) {
+    return s && *s ? strlen(s) + 1 : 0;
+}
+
+#define ALIGN8(n) (((n) + 7) & ~(size_t)7)
+
+// Counts the live records and the string bytes they need
+static void replica_measure(ReplicaLayout* layout) {
+    memset(layout, 0, sizeof(*layout));
+    size_t strings = 1;         // the empty string at offset 0
+
+    const StudentList* students = g_tables.students;
+    for (int i = 0; students && i < students->count; i++) {
+        const Student* s = &students->students[i];
+        if (s->is_deleted) continue;
+        layout->counts[REPLICA_STUDENTS]++;
+        strings += string_size(s->first_name) + string_size(s->last_name) + string_size(s->email) +
+                   string_size(s->phone) + string_size(s->address) + string_size(intern_lookup(s->course));
+    }
+    const liste_note* grades = g_tables.grades;
+    for (int i = 0; grades && i < grades->count; i++) {
+        if (!grades->note[i].is_deleted) layout->counts[REPLICA_GRADES]++;
+    }
+    const AttendanceList* attendance = g_tables.attendance;
+    for (int i = 0; attendance && i < attendance->count; i++) {
+        const AttendanceRecord* a = &attendance->records[i];
+        if (a->is_deleted) continue;
+        layout->counts[REPLICA_ATTENDANCE]++;
+        strings += string_size(a->reason);
+    }
+    const ClubList* clubs = g_tables.clubs;
+    for (int i = 0; clubs && i < clubs->count; i++) {
+        const Club* c = &clubs->clubs[i];
+        layout->counts[REPLICA_CLUBS]++;
+        strings += string_size(c->name) + string_size(c->description) + string_size(intern_lookup(c->category)) +
+                   string_size(c->meeting_day) + string_size(c->meeting_time) + string_size(c->meeting_location);
+    }
+    const MembershipList* memberships = g_tables.memberships;
+    for (int i = 0; memberships && i < memberships->count; i++) {
+        const ClubMembership* m = &memberships->memberships[i];
+        if (m->is_deleted) continue;
+        layout->counts[REPLICA_MEMBERSHIPS]++;
+        strings += string_size(intern_lookup(m->role));
+    }
+
+    size_t offset = ALIGN8(sizeof(ReplicaHeader));
+    for (int t = 0; t < REPLICA_TABLE_COUNT; t++) {
+        layout->offsets[t] = offset;
+        offset = ALIGN8(offset + (size_t)layout->counts[t] * record_sizes[t]);
+    }
+    layout->strings_offset = offset;
+    layout->strings_size = strings;
+    layout->size = offset + strings;
+}
+
+// ============================================================================
+// COPY
+// ============================================================================
+
+static ReplicaString heap_put(ReplicaHeap* heap, const char* s) {
+    size_t n = string_size(s);
+    if (n == 0) return 0;
+    ReplicaString offset = (ReplicaString)heap->used;
+    memcpy(heap->heap + heap->used, s, n);
+    heap->used += n;
+    return offset;
+}
+
+static int compare_students(const void* a, const void* b) {
+    const ReplicaStudent* x = a;
+    const ReplicaStudent* y = b;
+    return (x->id > y->id) - (x->id < y->id);
+}
+
+static int compare_grades(const void* a, const void* b) {
+    const ReplicaGrade* x = a;
+    const ReplicaGrade* y = b;
+    if (x->student_id != y->student_id) return (x->student_id > y->student_id) - (x->student_id < y->student_id);
+    return (x->exam_id > y->exam_id) - (x->exam_id < y->exam_id);
+}
+
+static int compare_attendance(const void* a, const void* b) {
+    const ReplicaAttendance* x = a;
+    const ReplicaAttendance* y = b;
+    if (x->student_id != y->student_id) return (x->student_id > y->student_id) - (x->student_id < y->student_id);
+    return (x->date > y->date) - (x->date < y->date);
+}
+
+static int compare_clubs(const void* a, const void* b) {
+    const ReplicaClub* x = a;
+    const ReplicaClub* y = b;
+    return (x->id > y->id) - (x->id < y->id);
+}
+
+static int compare_memberships(const void* a, const void* b) {
+    const ReplicaMembership* x = a;
+    const ReplicaMembership* y = b;
+    if (x->club_id != y->club_id) return (x->club_id > y->club_id) - (x->club_id < y->club_id);
+    return (x->student_id > y->student_id) - (x->student_id < y->student_id);
+}
+
+static void replica_fill(char* base, const ReplicaLayout* layout, uint64_t generation) {
+    ReplicaHeap heap = { base + layout->strings_offset, 1 };
+    heap.heap[0] = '\0';
+
+    ReplicaStudent* rs = (ReplicaStudent*)(base + layout->offsets[REPLICA_STUDENTS]);
+    const StudentList* students = g_tables.students;
+    for (int i = 0, n = 0; students && i < students->count; i++) {
+        const Student* s = &students->students[i];
+        if (s->is_deleted) continue;
+        ReplicaStudent* r = &rs[n++];
+        r->id = s->id;
+        r->age = s->age;
+        r->year = s->year;
+        r->gpa = s->gpa;
+        r->active = s->is_active;
+        r->first_name = heap_put(&heap, s->first_name);
+        r->last_name = heap_put(&heap, s->last_name);
+        r->email = heap_put(&heap, s->email);
+        r->phone = heap_put(&heap, s->phone);
+        r->address = heap_put(&heap, s->address);
+        r->course = heap_put(&heap, intern_lookup(s->course));
+        r->enrollment_date = (int64_t)s->enrollment_date;
+    }
+    qsort(rs, layout->counts[REPLICA_STUDENTS], sizeof(*rs), compare_students);
+
+    ReplicaGrade* rg = (ReplicaGrade*)(base + layout->offsets[REPLICA_GRADES]);
+    const liste_note* grades = g_tables.grades;
+    for (int i = 0, n = 0; grades && i < grades->count; i++) {
+        const Note* g = &grades->note[i];
+        if (g->is_deleted) continue;
+        ReplicaGrade* r = &rg[n++];
+        r->student_id = g->id_etudiant;
+        r->exam_id = g->id_examen;
+        r->grade = g->note_obtenue;
+        r->present = g->present;
+    }
+    qsort(rg, layout->counts[REPLICA_GRADES], sizeof(*rg), compare_grades);
+
+    ReplicaAttendance* ra = (ReplicaAttendance*)(base + layout->offsets[REPLICA_ATTENDANCE]);
+    const AttendanceList* attendance = g_tables.attendance;
+    for (int i = 0, n = 0; attendance && i < attendance->count; i++) {
+        const AttendanceRecord* a = &attendance->records[i];
+        if (a->is_deleted) continue;
+        ReplicaAttendance* r = &ra[n++];
+        r->id = a->id;
+        r->student_id = a->student_id;
+        r->course_id = a->course_id;
+        r->status = a->status;
+        r->teacher_id = a->teacher_id;
+        r->reason = heap_put(&heap, a->reason);
+        r->date = (int64_t)a->date;
+        r->recorded_time = (int64_t)a->recorded_time;
+    }
+    qsort(ra, layout->counts[REPLICA_ATTENDANCE], sizeof(*ra), compare_attendance);
+
+    ReplicaClub* rc = (ReplicaClub*)(base + layout->offsets[REPLICA_CLUBS]);
+    const ClubList* clubs = g_tables.clubs;
+    for (int i = 0; clubs && i < clubs->count; i++) {
+        const Club* c = &clubs->clubs[i];
+        ReplicaClub* r = &rc[i];
+        r->id = c->id;
+        r->president_id = c->president_id;
+        r->advisor_id = c->advisor_id;
+        r->member_count = c->member_count;
+        r->max_members = c->max_members;
+        r->active = c->is_active;
+        r->budget = c->budget;
+        r->name = heap_put(&heap, c->name);
+        r->description = heap_put(&heap, c->description);
+        r->category = heap_put(&heap, intern_lookup(c->category));
+        r->meeting_day = heap_put(&heap, c->meeting_day);
+        r->meeting_time = heap_put(&heap, c->meeting_time);
+        r->meeting_location = heap_put(&heap, c->meeting_location);
+        r->founded_date = (int64_t)c->founded_date;
+        r->last_meeting = (int64_t)c->last_meeting;
+    }
+    qsort(rc, layout->counts[REPLICA_CLUBS], sizeof(*rc), compare_clubs);
+
+    ReplicaMembership* rm = (ReplicaMembership*)(base + layout->offsets[REPLICA_MEMBERSHIPS]);
+    const MembershipList* memberships = g_tables.memberships;
+    for (int i = 0, n = 0; memberships && i < memberships->count; i++) {
+        const ClubMembership* m = &memberships->memberships[i];
+        if (m->is_deleted) continue;
+        ReplicaMembership* r = &rm[n++];
+        r->id = m->id;
+        r->student_id = m->student_id;
+        r->club_id = m->club_id;
+        r->active = m->is_active;
+        r->role = heap_put(&heap, intern_lookup(m->role));
+        r->join_date = (int64_t)m->join_date;
+    }
+    qsort(rm, layout->counts[REPLICA_MEMBERSHIPS], sizeof(*rm), compare_memberships);
+
+    ReplicaHeader* header = (ReplicaHeader*)base;
+    header->magic = REPLICA_MAGIC;
+    header->format_version = REPLICA_FORMAT_VERSION;
+    header->generation = generation;
+    header->published_at = (int64_t)time(NULL);
+    header->size = layout->size;
+    for (int t = 0; t < REPLICA_TABLE_COUNT; t++) {
+        header->tables[t].offset = layout->offsets[t];
+        header->tables[t].count = layout->counts[t];
+        header->tables[t].record_size = (uint32_t)record_sizes[t];
+    }
+    header->strings_offset = layout->strings_offset;
+    header->strings_size = layout->strings_size;
+}
+
+// ============================================================================
+// API
+// ============================================================================
+
+int replica_publish(void) {
+    if (g_control == NULL) return 0;
+    TRACE_SCOPE("replica publish");
+
+    ReplicaLayout layout;
+    replica_measure(&layout);
+    if (layout.strings_size > UINT32_MAX) {
+        printf("[ERROR] Replica strings exceed 4 GiB, not published\n");
+        return 0;
+    }
+
+    uint64_t generation = g_generation + 1;
+    char name[sizeof(g_current)];
+    snprintf(name, sizeof(name), "%s.%d.%llu", g_name, (int)getpid(), (unsigned long long)generation);
+
+    shm_unlink(name);
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        printf("[ERROR] Cannot create replica %s (%s)\n", name, strerror(errno));
+        return 0;
+    }
+    // Reserve the pages now: a full /dev/shm would otherwise show up as
+    // SIGBUS while copying
+    int err = posix_fallocate(fd, 0, (off_t)layout.size);
+    char* base = err == 0 ? mmap(NULL, layout.size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+    close(fd);
+    if (base == MAP_FAILED) {
+        printf("[ERROR] Cannot map replica %s (%s)\n", name, strerror(err ? err : errno));
+        shm_unlink(name);
+        return 0;
+    }
+
+    replica_fill(base, &layout, generation);
+    munmap(base, layout.size);
+
+    // Readers that load the new generation see a complete snapshot
+    atomic_store_explicit(&g_control->generation, generation, memory_order_release);
+    if (g_current[0]) shm_unlink(g_current);
+    snprintf(g_current, sizeof(g_current), "%s", name);
+    g_generation = generation;
+    return 1;
+}
+
+int replica_start(const char* name, const ReplicaTables* tables) {
+    if (g_control != NULL) {
+        printf("[WARNING] Replica already started\n");
+        return 0;
+    }
+    if (name == NULL || name[0] != '/' || tables == NULL) {
+        printf("[ERROR] Invalid replica arguments\n");
+        return 0;
+    }
+    g_tables = *tables;
+    snprintf(g_name, sizeof(g_name), "%s", name);
+
+    // A control object left by a crashed run is replaced; its readers
+    // notice the new publisher pid
+    shm_unlink(g_name);
+    int fd = shm_open(g_name, O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0 || ftruncate(fd, sizeof(ReplicaControl)) != 0) {
+        printf("[ERROR] Cannot create replica %s (%s)\n", g_name, strerror(errno));
+        if (fd >= 0) close(fd);
+        return 0;
+    }
+    void* control = mmap(NULL, sizeof(ReplicaControl), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (control == MAP_FAILED) {
+        printf("[ERROR] Cannot map replica %s (%s)\n", g_name, strerror(errno));
+        shm_unlink(g_name);
+        return 0;
+    }
+
+    g_control = control;
+    g_control->magic = REPLICA_MAGIC;
+    g_control->format_version = REPLICA_FORMAT_VERSION;
+    g_control->pid = (int32_t)getpid();
+    atomic_store(&g_control->generation, 0);
+    g_generation = 0;
+    g_current[0] = '\0';
+
+    if (!replica_publish()) {
+        replica_stop();
+        return 0;
+    }
+    printf("[OK] Read replica published at %s\n", g_name);
+    return 1;
+}
+
+void replica_stop(void) {
+    if (g_control == NULL) return;
+    if (g_current[0]) shm_unlink(g_current);
+    shm_unlink(g_name);
+    munmap(g_control, sizeof(ReplicaControl));
+    g_control = NULL;
+    g_current[0] = '\0';
+    g_generation = 0;
+}
+
+#else
+
+int replica_start(const char* name, const ReplicaTables* tables) {
+    (void)name;
+    (void)tables;
+    printf("[WARNING] The read replica needs POSIX shared memory and is not available on Windows\n");
+    return 0;
+}
+
+int replica_publish(void) {
+    return 0;
+}
+
+void replica_stop(void) {
+}
+
+#endif
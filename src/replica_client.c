@@ -0,0 +1,336 @@
+#include "replica_client.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(_WIN32) && !defined(_WIN64)
+
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// A snapshot can be replaced between reading the control object and
+// opening it; that many tries before giving up
+#define REPLICA_OPEN_ATTEMPTS 8
+
+struct ReplicaClient {
+    char name[256];
+    int32_t pid;
+    char* base;
+    size_t size;
+    const ReplicaHeader* header;
+};
+
+static const size_t record_sizes[REPLICA_TABLE_COUNT] = {
+    sizeof(ReplicaStudent), sizeof(ReplicaGrade), sizeof(ReplicaAttendance),
+    sizeof(ReplicaClub), sizeof(ReplicaMembership)
+};
+
+// ============================================================================
+// MAPPING
+// ============================================================================
+
+// 1 with the current publisher and generation, 0 if nothing is published
+static int replica_read_control(const char* name, int32_t* pid, uint64_t* generation) {
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) return 0;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(ReplicaControl)) {
+        close(fd);
+        return 0;
+    }
+    ReplicaControl* control = mmap(NULL, sizeof(ReplicaControl), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (control == MAP_FAILED) return 0;
+
+    int ok = control->magic == REPLICA_MAGIC && control->format_version == REPLICA_FORMAT_VERSION;
+    *pid = control->pid;
+    *generation = atomic_load_explicit(&control->generation, memory_order_acquire);
+    munmap(control, sizeof(ReplicaControl));
+    return ok && *generation != 0;
+}
+
+// Checks that every table and the string heap lie inside the snapshot, so
+// the accessors below need no bounds checks of their own
+static int replica_valid(const char* base, size_t size, uint64_t generation) {
+    if (size < sizeof(ReplicaHeader)) return 0;
+    const ReplicaHeader* header = (const ReplicaHeader*)base;
+    if (header->magic != REPLICA_MAGIC || header->format_version != REPLICA_FORMAT_VERSION ||
+        header->generation != generation || header->size != size) {
+        return 0;
+    }
+    for (int t = 0; t < REPLICA_TABLE_COUNT; t++) {
+        const ReplicaTableInfo* table = &header->tables[t];
+        if (table->record_size != record_sizes[t] || table->offset % 8 != 0 || table->offset > size ||
+            (uint64_t)table->count * table->record_size > size - table->offset) {
+            return 0;
+        }
+    }
+    if (header->strings_size == 0 || header->strings_offset > size ||
+        header->strings_size > size - header->strings_offset ||
+        base[header->strings_offset + header->strings_size - 1] != '\0') {
+        return 0;
+    }
+    return 1;
+}
+
+// 1 once the snapshot is mapped, 0 if it is gone (a newer one replaced it)
+static int replica_map(ReplicaClient* client, int32_t pid, uint64_t generation) {
+    char name[320];
+    snprintf(name, sizeof(name), "%s.%d.%llu", client->name, (int)pid, (unsigned long long)generation);
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) return 0;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return 0;
+    }
+    size_t size = (size_t)st.st_size;
+    char* base = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return 0;
+    if (!replica_valid(base, size, generation)) {
+        munmap(base, size);
+        return 0;
+    }
+
+    if (client->base) munmap(client->base, client->size);
+    client->pid = pid;
+    client->base = base;
+    client->size = size;
+    client->header = (const ReplicaHeader*)base;
+    return 1;
+}
+
+// ============================================================================
+// API
+// ============================================================================
+
+ReplicaClient* replica_open(const char* name) {
+    if (name == NULL || strlen(name) >= sizeof(((ReplicaClient*)0)->name)) return NULL;
+    ReplicaClient* client = calloc(1, sizeof(ReplicaClient));
+    if (client == NULL) return NULL;
+    snprintf(client->name, sizeof(client->name), "%s", name);
+
+    if (replica_refresh(client) != 1) {
+        free(client);
+        return NULL;
+    }
+    return client;
+}
+
+int replica_refresh(ReplicaClient* client) {
+    if (client == NULL) return -1;
+    for (int attempt = 0; attempt < REPLICA_OPEN_ATTEMPTS; attempt++) {
+        int32_t pid;
+        uint64_t generation;
+        if (!replica_read_control(client->name, &pid, &generation)) return -1;
+        if (client->header && client->pid == pid && client->header->generation == generation) return 0;
+        if (replica_map(client, pid, generation)) return 1;
+    }
+    return -1;
+}
+
+void replica_close(ReplicaClient* client) {
+    if (client == NULL) return;
+    if (client->base) munmap(client->base, client->size);
+    free(client);
+}
+
+uint64_t replica_generation(const ReplicaClient* client) {
+    return client ? client->header->generation : 0;
+}
+
+time_t replica_published_at(const ReplicaClient* client) {
+    return client ? (time_t)client->header->published_at : 0;
+}
+
+static const void* replica_table(const ReplicaClient* client, ReplicaTableId table, int* count) {
+    if (client == NULL) {
+        if (count) *count = 0;
+        return NULL;
+    }
+    const ReplicaTableInfo* info = &client->header->tables[table];
+    if (count) *count = (int)info->count;
+    return client->base + info->offset;
+}
+
+const ReplicaStudent* replica_students(const ReplicaClient* client, int* count) {
+    return replica_table(client, REPLICA_STUDENTS, count);
+}
+
+const ReplicaGrade* replica_grades(const ReplicaClient* client, int* count) {
+    return replica_table(client, REPLICA_GRADES, count);
+}
+
+const ReplicaAttendance* replica_attendance(const ReplicaClient* client, int* count) {
+    return replica_table(client, REPLICA_ATTENDANCE, count);
+}
+
+const ReplicaClub* replica_clubs(const ReplicaClient* client, int* count) {
+    return replica_table(client, REPLICA_CLUBS, count);
+}
+
+const ReplicaMembership* replica_memberships(const ReplicaClient* client, int* count) {
+    return replica_table(client, REPLICA_MEMBERSHIPS, count);
+}
+
+const char* replica_string(const ReplicaClient* client, ReplicaString string) {
+    if (client == NULL || string >= client->header->strings_size) return "";
+    return client->base + client->header->strings_offset + string;
+}
+
+// ============================================================================
+// LOOKUPS
+// ============================================================================
+
+// First record whose int32 key is >= key, in a table sorted on that key
+static int lower_bound(const char* records, int count, size_t record_size, size_t key_offset, int32_t key) {
+    int low = 0, high = count;
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        int32_t value;
+        memcpy(&value, records + (size_t)mid * record_size + key_offset, sizeof(value));
+        if (value < key) low = mid + 1;
+        else high = mid;
+    }
+    return low;
+}
+
+// The run of records whose key equals key
+static const void* replica_range(const ReplicaClient* client, ReplicaTableId table, size_t key_offset,
+                                 int32_t key, int* count) {
+    int total;
+    const char* records = replica_table(client, table, &total);
+    size_t size = record_sizes[table];
+    int first = records ? lower_bound(records, total, size, key_offset, key) : 0;
+    int last = first;
+    while (last < total) {
+        int32_t value;
+        memcpy(&value, records + (size_t)last * size + key_offset, sizeof(value));
+        if (value != key) break;
+        last++;
+    }
+    if (count) *count = last - first;
+    return last > first ? records + (size_t)first * size : NULL;
+}
+
+const ReplicaStudent* replica_find_student(const ReplicaClient* client, int student_id) {
+    return replica_range(client, REPLICA_STUDENTS, offsetof(ReplicaStudent, id), student_id, NULL);
+}
+
+const ReplicaClub* replica_find_club(const ReplicaClient* client, int club_id) {
+    return replica_range(client, REPLICA_CLUBS, offsetof(ReplicaClub, id), club_id, NULL);
+}
+
+const ReplicaGrade* replica_student_grades(const ReplicaClient* client, int student_id, int* count) {
+    return replica_range(client, REPLICA_GRADES, offsetof(ReplicaGrade, student_id), student_id, count);
+}
+
+const ReplicaAttendance* replica_student_attendance(const ReplicaClient* client, int student_id, int* count) {
+    return replica_range(client, REPLICA_ATTENDANCE, offsetof(ReplicaAttendance, student_id), student_id, count);
+}
+
+const ReplicaMembership* replica_club_members(const ReplicaClient* client, int club_id, int* count) {
+    return replica_range(client, REPLICA_MEMBERSHIPS, offsetof(ReplicaMembership, club_id), club_id, count);
+}
+
+#else
+
+ReplicaClient* replica_open(const char* name) {
+    (void)name;
+    return NULL;
+}
+
+int replica_refresh(ReplicaClient* client) {
+    (void)client;
+    return -1;
+}
+
+void replica_close(ReplicaClient* client) {
+    (void)client;
+}
+
+uint64_t replica_generation(const ReplicaClient* client) {
+    (void)client;
+    return 0;
+}
+
+time_t replica_published_at(const ReplicaClient* client) {
+    (void)client;
+    return 0;
+}
+
+const ReplicaStudent* replica_students(const ReplicaClient* client, int* count) {
+    (void)client;
+    if (count) *count = 0;
+    return NULL;
+}
+
+const ReplicaGrade* replica_grades(const ReplicaClient* client, int* count) {
+    (void)client;
+    if (count) *count = 0;
+    return NULL;
+}
+
+const ReplicaAttendance* replica_attendance(const ReplicaClient* client, int* count) {
+    (void)client;
+    if (count) *count = 0;
+    return NULL;
+}
+
+const ReplicaClub* replica_clubs(const ReplicaClient* client, int* count) {
+    (void)client;
+    if (count) *count = 0;
+    return NULL;
+}
+
+const ReplicaMembership* replica_memberships(const ReplicaClient* client, int* count) {
+    (void)client;
+    if (count) *count = 0;
+    return NULL;
+}
+
+const char* replica_string(const ReplicaClient* client, ReplicaString string) {
+    (void)client;
+    (void)string;
+    return "";
+}
+
+const ReplicaStudent* replica_find_student(const ReplicaClient* client, int student_id) {
+    (void)client;
+    (void)student_id;
+    return NULL;
+}
+
+const ReplicaClub* replica_find_club(const ReplicaClient* client, int club_id) {
+    (void)client;
+    (void)club_id;
+    return NULL;
+}
+
+const ReplicaGrade* replica_student_grades(const ReplicaClient* client, int student_id, int* count) {
+    (void)client;
+    (void)student_id;
+    if (count) *count = 0;
+    return NULL;
+}
+
+const ReplicaAttendance* replica_student_attendance(const ReplicaClient* client, int student_id, int* count) {
+    (void)client;
+    (void)student_id;
+    if (count) *count = 0;
+    return NULL;
+}
+
+const ReplicaMembership* replica_club_members(const ReplicaClient* client, int club_id, int* count) {
+    (void)client;
+    (void)club_id;
+    if (count) *count = 0;
+    return NULL;
+}
+
+#endif
@@ -0,0 +1,1768 @@
+#include "replication.h"
+
+#if !defined(_WIN32) && !defined(_WIN64)
+
+#include <glib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include "intern.h"
+#include "tombstone.h"
+#include "trace.h"
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0              // SO_NOSIGPIPE is set on the socket instead
+#endif
+
+#define REPLICATION_MAGIC 0x474f4c52u       // "RLOG"
+#define REPLICATION_VERSION 1
+#define REPLICATION_ACK_MS 100              // follower: acknowledge applied changes this often
+#define REPLICATION_APPLY_BUDGET (4 * REPLICATION_BATCH_BYTES)  // per main loop iteration
+
+// ============================================================================
+// WIRE FORMAT
+// ============================================================================
+//
+// Frames in host byte order, as both ends run on the same machine: a
+// FrameHeader, then length bytes of payload.
+//   HELLO      follower -> primary, first on each connection
+//   BATCH      primary -> follower: BatchHeader, then count entries with
+//              consecutive LSNs from first_lsn
+//   SNAPSHOT   primary -> follower: SnapshotHeader, then one entry per record
+//   HEARTBEAT  primary -> follower, when there was nothing to send
+//   ACK        follower -> primary
+// An entry is an EntryHeader followed by the record, encoded as below.
+
+enum { FRAME_HELLO = 1, FRAME_BATCH, FRAME_SNAPSHOT, FRAME_HEARTBEAT, FRAME_ACK };
+
+typedef struct {
+    uint32_t type;
+    uint32_t length;
+} FrameHeader;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t epoch;                 // primary the follower last heard from, 0 for none
+    uint64_t next_lsn;              // first change it has not received
+} HelloFrame;
+
+typedef struct {
+    uint64_t first_lsn;
+    uint32_t count;
+    uint32_t reserved;
+    int64_t logged_at;              // monotonic time of the first change
+} BatchHeader;
+
+// Each table is copied under its own read lock and holds every change up
+// to its table_lsn; the log resumes at the lowest of them
+typedef struct {
+    uint64_t epoch;
+    uint64_t next_lsn;
+    uint64_t table_lsn[CHANGE_TABLE_COUNT];
+    uint32_t count;
+    uint32_t reserved;
+} SnapshotHeader;
+
+typedef struct {
+    uint64_t lsn;                   // last change logged
+    int64_t sent_at;
+} HeartbeatFrame;
+
+typedef struct {
+    uint64_t applied_lsn;
+    int64_t lag_us;                 // of the last batch applied
+} AckFrame;
+
+typedef struct {
+    uint8_t table;                  // ChangeTable
+    uint8_t op;                     // ChangeOp
+    uint16_t reserved;
+    uint32_t length;
+} EntryHeader;
+
+static int send_all(int fd, const void* data, size_t length) {
+    const char* p = data;
+    while (length > 0) {
+        ssize_t n = send(fd, p, length, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return 0;
+        }
+        p += n;
+        length -= (size_t)n;
+    }
+    return 1;
+}
+
+static int recv_all(int fd, void* data, size_t length) {
+    char* p = data;
+    while (length > 0) {
+        ssize_t n = recv(fd, p, length, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return 0;
+        p += n;
+        length -= (size_t)n;
+    }
+    return 1;
+}
+
+static int send_frame(int fd, uint32_t type, const void* payload, uint32_t length) {
+    FrameHeader header = { type, length };
+    return send_all(fd, &header, sizeof(header)) && send_all(fd, payload, length);
+}
+
+static void socket_setup(int fd) {
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+#ifdef SO_NOSIGPIPE
+    int on = 1;
+    setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+}
+
+static int socket_address(const char* path, struct sockaddr_un* addr) {
+    memset(addr, 0, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr->sun_path)) return 0;
+    strcpy(addr->sun_path, path);
+    return 1;
+}
+
+static int socket_connect(const char* path) {
+    struct sockaddr_un addr;
+    if (!socket_address(path, &addr)) return -1;
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    socket_setup(fd);
+    if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void wake(int fd) {
+    char byte = 1;
+    if (write(fd, &byte, 1) < 0) {
+        // Full pipe: a wake-up is already pending
+    }
+}
+
+static void drain(int fd) {
+    char buffer[64];
+    while (read(fd, buffer, sizeof(buffer)) > 0) {
+    }
+}
+
+static int wake_pipe(int fds[2]) {
+    if (pipe(fds) != 0) return 0;
+    for (int i = 0; i < 2; i++) {
+        fcntl(fds[i], F_SETFD, FD_CLOEXEC);
+        fcntl(fds[i], F_SETFL, O_NONBLOCK);
+    }
+    return 1;
+}
+
+// ============================================================================
+// RECORDS
+// ============================================================================
+//
+// Fields one after the other: integers as int32, times as int64, floats as
+// float, strings and interned ids as a uint32 length and the characters
+// with their terminating NUL. The encoding of a record is canonical, so
+// two records are equal when their encodings are.
+
+typedef union {
+    User user;
+    Student student;
+    Note grade;
+    AttendanceRecord attendance;
+    Club club;
+    ClubMembership membership;
+    ProfessorNote note;
+} ReplicationRecord;
+
+typedef struct {
+    const uint8_t* data;
+    size_t left;
+    int ok;
+} Reader;
+
+static void put_i32(GByteArray* out, int32_t value) {
+    g_byte_array_append(out, (const guint8*)&value, sizeof(value));
+}
+
+static void put_i64(GByteArray* out, int64_t value) {
+    g_byte_array_append(out, (const guint8*)&value, sizeof(value));
+}
+
+static void put_f32(GByteArray* out, float value) {
+    g_byte_array_append(out, (const guint8*)&value, sizeof(value));
+}
+
+static void put_str(GByteArray* out, const char* s) {
+    if (s == NULL) s = "";
+    uint32_t length = (uint32_t)strlen(s) + 1;
+    g_byte_array_append(out, (const guint8*)&length, sizeof(length));
+    g_byte_array_append(out, (const guint8*)s, length);
+}
+
+static void put_interned(GByteArray* out, InternId id) {
+    put_str(out, intern_lookup(id));
+}
+
+static void get_bytes(Reader* in, void* out, size_t length) {
+    if (!in->ok || in->left < length) {
+        in->ok = 0;
+        memset(out, 0, length);
+        return;
+    }
+    memcpy(out, in->data, length);
+    in->data += length;
+    in->left -= length;
+}
+
+static int32_t get_i32(Reader* in) {
+    int32_t value;
+    get_bytes(in, &value, sizeof(value));
+    return value;
+}
+
+static int64_t get_i64(Reader* in) {
+    int64_t value;
+    get_bytes(in, &value, sizeof(value));
+    return value;
+}
+
+static float get_f32(Reader* in) {
+    float value;
+    get_bytes(in, &value, sizeof(value));
+    return value;
+}
+
+// Points into the frame
+static const char* get_str(Reader* in) {
+    uint32_t length;
+    get_bytes(in, &length, sizeof(length));
+    if (!in->ok || length == 0 || length > in->left || in->data[length - 1] != '\0') {
+        in->ok = 0;
+        return "";
+    }
+    const char* s = (const char*)in->data;
+    in->data += length;
+    in->left -= length;
+    return s;
+}
+
+static void get_chars(Reader* in, char* buffer, size_t size) {
+    g_strlcpy(buffer, get_str(in), size);
+}
+
+// Main thread: interning is not thread safe
+static InternId get_interned(Reader* in) {
+    return intern_string(get_str(in));
+}
+
+// Users -----------------------------------------------------------------------
+
+static void user_encode(GByteArray* out, const void* record) {
+    const User* user = record;
+    put_i32(out, user->id);
+    put_str(out, user->username);
+    put_str(out, user->email);
+    put_str(out, user->password_hash);
+    put_str(out, user->salt);
+    put_i32(out, (int32_t)user->role);
+    put_i64(out, (int64_t)user->created_at);
+    put_i64(out, (int64_t)user->last_login);
+    put_i32(out, user->is_active);
+}
+
+static int user_decode(Reader* in, ReplicationRecord* record) {
+    User* user = &record->user;
+    memset(user, 0, sizeof(*user));
+    user->id = get_i32(in);
+    get_chars(in, user->username, sizeof(user->username));
+    get_chars(in, user->email, sizeof(user->email));
+    get_chars(in, user->password_hash, sizeof(user->password_hash));
+    get_chars(in, user->salt, sizeof(user->salt));
+    user->role = (UserRole)get_i32(in);
+    user->created_at = (time_t)get_i64(in);
+    user->last_login = (time_t)get_i64(in);
+    user->is_active = get_i32(in);
+    return in->ok;
+}
+
+static int64_t user_key(const void* record) { return ((const User*)record)->id; }
+static int user_count(const void* list) { return ((const UserList*)list)->count; }
+static TableLock* user_lock(const void* list) { return ((const UserList*)list)->lock; }
+
+static const void* user_get(const void* list, int index) {
+    const User* user = &((const UserList*)list)->users[index];
+    return user->is_deleted ? NULL : user;
+}
+
+static int user_insert(void* list, const ReplicationRecord* record) {
+    return user_list_add(list, record->user);
+}
+
+static int user_update(void* table, int index, const ReplicationRecord* record) {
+    UserList* list = table;
+    table_lock_write(list->lock);
+    list->users[index] = record->user;
+    list->dirty = 1;
+    changelog_record(list->lock, CHANGE_USERS, CHANGE_UPDATE, &list->users[index]);
+    table_unlock_write(list->lock);
+    return 1;
+}
+
+static int user_remove(void* table, int index) {
+    UserList* list = table;
+    table_lock_write(list->lock);
+    int removed = tombstones_mark(&list->tombstones, &list->users[index].is_deleted, list->count);
+    list->dirty = 1;
+    if (removed) changelog_record(list->lock, CHANGE_USERS, CHANGE_DELETE, &list->users[index]);
+    table_unlock_write(list->lock);
+    return removed;
+}
+
+// Students --------------------------------------------------------------------
+
+static void student_encode(GByteArray* out, const void* record) {
+    const Student* student = record;
+    put_i32(out, student->id);
+    put_i32(out, student->age);
+    put_i32(out, student->year);
+    put_f32(out, student->gpa);
+    put_i32(out, student->is_active);
+    put_interned(out, student->course);
+    put_i64(out, (int64_t)student->enrollment_date);
+    put_str(out, student->first_name);
+    put_str(out, student->last_name);
+    put_str(out, student->email);
+    put_str(out, student->phone);
+    put_str(out, student->address);
+}
+
+// The strings are borrowed from the frame; the list copies them in
+static int student_decode(Reader* in, ReplicationRecord* record) {
+    Student* student = &record->student;
+    memset(student, 0, sizeof(*student));
+    student->id = get_i32(in);
+    student->age = get_i32(in);
+    student->year = get_i32(in);
+    student->gpa = get_f32(in);
+    student->is_active = get_i32(in);
+    student->course = get_interned(in);
+    student->enrollment_date = (time_t)get_i64(in);
+    student->first_name = get_str(in);
+    student->last_name = get_str(in);
+    student->email = get_str(in);
+    student->phone = get_str(in);
+    student->address = get_str(in);
+    return in->ok;
+}
+
+static int64_t student_key(const void* record) { return ((const Student*)record)->id; }
+static int student_count(const void* list) { return ((const StudentList*)list)->count; }
+static TableLock* student_lock(const void* list) { return ((const StudentList*)list)->lock; }
+
+static const void* student_get(const void* list, int index) {
+    const Student* student = &((const StudentList*)list)->students[index];
+    return student->is_deleted ? NULL : student;
+}
+
+static int student_insert(void* list, const ReplicationRecord* record) {
+    return student_list_add(list, record->student);
+}
+
+static int student_update(void* table, int index, const ReplicationRecord* record) {
+    StudentList* list = table;
+    return student_list_update(list, &list->students[index], &record->student);
+}
+
+static int student_remove(void* table, int index) {
+    StudentList* list = table;
+    return student_list_remove(list, list->students[index].id);
+}
+
+// Grades ----------------------------------------------------------------------
+
+static void grade_encode(GByteArray* out, const void* record) {
+    const Note* grade = record;
+    put_i32(out, grade->id_etudiant);
+    put_i32(out, grade->id_examen);
+    put_f32(out, grade->note_obtenue);
+    put_i32(out, grade->present);
+}
+
+static int grade_decode(Reader* in, ReplicationRecord* record) {
+    Note* grade = &record->grade;
+    memset(grade, 0, sizeof(*grade));
+    grade->id_etudiant = get_i32(in);
+    grade->id_examen = get_i32(in);
+    grade->note_obtenue = get_f32(in);
+    grade->present = get_i32(in);
+    return in->ok;
+}
+
+static int64_t grade_key(const void* record) {
+    const Note* grade = record;
+    return ((int64_t)grade->id_etudiant << 32) | (uint32_t)grade->id_examen;
+}
+
+static int grade_count(const void* list) { return ((const GradeList*)list)->count; }
+static TableLock* grade_lock(const void* list) { return ((const GradeList*)list)->lock; }
+
+static const void* grade_get(const void* list, int index) {
+    const Note* grade = &((const GradeList*)list)->note[index];
+    return grade->is_deleted ? NULL : grade;
+}
+
+static int grade_insert(void* list, const ReplicationRecord* record) {
+    Note* copy = (Note*)malloc(sizeof(Note));
+    if (copy == NULL) return 0;
+    *copy = record->grade;
+    if (!note_ajouter(list, copy)) {    // frees copy on success
+        free(copy);
+        return 0;
+    }
+    return 1;
+}
+
+static int grade_update(void* table, int index, const ReplicationRecord* record) {
+    GradeList* list = table;
+    table_lock_write(list->lock);
+    list->note[index].note_obtenue = record->grade.note_obtenue;
+    list->note[index].present = record->grade.present;
+    list->dirty = 1;
+    changelog_record(list->lock, CHANGE_GRADES, CHANGE_UPDATE, &list->note[index]);
+    table_unlock_write(list->lock);
+    return 1;
+}
+
+static int grade_remove(void* table, int index) {
+    GradeList* list = table;
+    table_lock_write(list->lock);
+    int removed = tombstones_mark(&list->tombstones, &list->note[index].is_deleted, list->count);
+    list->dirty = 1;
+    if (removed) changelog_record(list->lock, CHANGE_GRADES, CHANGE_DELETE, &list->note[index]);
+    table_unlock_write(list->lock);
+    return removed;
+}
+
+// Attendance ------------------------------------------------------------------
+
+static void attendance_encode(GByteArray* out, const void* record) {
+    const AttendanceRecord* attendance = record;
+    put_i32(out, attendance->id);
+    put_i32(out, attendance->student_id);
+    put_i32(out, attendance->course_id);
+    put_i64(out, (int64_t)attendance->date);
+    put_i32(out, attendance->status);
+    put_str(out, attendance->reason);
+    put_i32(out, attendance->teacher_id);
+    put_i64(out, (int64_t)attendance->recorded_time);
+}
+
+static int attendance_decode(Reader* in, ReplicationRecord* record) {
+    AttendanceRecord* attendance = &record->attendance;
+    memset(attendance, 0, sizeof(*attendance));
+    attendance->id = get_i32(in);
+    attendance->student_id = get_i32(in);
+    attendance->course_id = get_i32(in);
+    attendance->date = (time_t)get_i64(in);
+    attendance->status = get_i32(in);
+    get_chars(in, attendance->reason, sizeof(attendance->reason));
+    attendance->teacher_id = get_i32(in);
+    attendance->recorded_time = (time_t)get_i64(in);
+    return in->ok;
+}
+
+static int64_t attendance_key(const void* record) { return ((const AttendanceRecord*)record)->id; }
+static int attendance_count(const void* list) { return ((const AttendanceList*)list)->count; }
+static TableLock* attendance_lock(const void* list) { return ((const AttendanceList*)list)->lock; }
+
+static const void* attendance_get(const void* list, int index) {
+    const AttendanceRecord* attendance = &((const AttendanceList*)list)->records[index];
+    return attendance->is_deleted ? NULL : attendance;
+}
+
+static int attendance_insert(void* list, const ReplicationRecord* record) {
+    return attendance_list_add(list, record->attendance);
+}
+
+static int attendance_update(void* table, int index, const ReplicationRecord* record) {
+    AttendanceList* list = table;
+    table_lock_write(list->lock);
+    list->records[index] = record->attendance;
+    list->dirty = 1;
+    changelog_record(list->lock, CHANGE_ATTENDANCE, CHANGE_UPDATE, &list->records[index]);
+    table_unlock_write(list->lock);
+    return 1;
+}
+
+static int attendance_remove(void* table, int index) {
+    AttendanceList* list = table;
+    table_lock_write(list->lock);
+    int removed = tombstones_mark(&list->tombstones, &list->records[index].is_deleted, list->count);
+    list->dirty = 1;
+    if (removed) changelog_record(list->lock, CHANGE_ATTENDANCE, CHANGE_DELETE, &list->records[index]);
+    table_unlock_write(list->lock);
+    return removed;
+}
+
+// Clubs -----------------------------------------------------------------------
+
+static void club_encode(GByteArray* out, const void* record) {
+    const Club* club = record;
+    put_i32(out, club->id);
+    put_str(out, club->name);
+    put_str(out, club->description);
+    put_interned(out, club->category);
+    put_i32(out, club->president_id);
+    put_i32(out, club->advisor_id);
+    put_i32(out, club->member_count);
+    put_i32(out, club->max_members);
+    put_i64(out, (int64_t)club->founded_date);
+    put_i64(out, (int64_t)club->last_meeting);
+    put_str(out, club->meeting_day);
+    put_str(out, club->meeting_time);
+    put_str(out, club->meeting_location);
+    put_f32(out, club->budget);
+    put_i32(out, club->is_active);
+}
+
+static int club_decode(Reader* in, ReplicationRecord* record) {
+    Club* club = &record->club;
+    memset(club, 0, sizeof(*club));
+    club->id = get_i32(in);
+    get_chars(in, club->name, sizeof(club->name));
+    get_chars(in, club->description, sizeof(club->description));
+    club->category = get_interned(in);
+    club->president_id = get_i32(in);
+    club->advisor_id = get_i32(in);
+    club->member_count = get_i32(in);
+    club->max_members = get_i32(in);
+    club->founded_date = (time_t)get_i64(in);
+    club->last_meeting = (time_t)get_i64(in);
+    get_chars(in, club->meeting_day, sizeof(club->meeting_day));
+    get_chars(in, club->meeting_time, sizeof(club->meeting_time));
+    get_chars(in, club->meeting_location, sizeof(club->meeting_location));
+    club->budget = get_f32(in);
+    club->is_active = get_i32(in);
+    return in->ok;
+}
+
+static int64_t club_key(const void* record) { return ((const Club*)record)->id; }
+static int club_count(const void* list) { return ((const ClubList*)list)->count; }
+static TableLock* club_lock(const void* list) { return ((const ClubList*)list)->lock; }
+
+static const void* club_get(const void* list, int index) {
+    return &((const ClubList*)list)->clubs[index];
+}
+
+// The list has a fixed capacity, set when it was loaded; the follower
+// mirrors the primary's clubs whatever its own file held
+static int club_insert(void* table, const ReplicationRecord* record) {
+    ClubList* list = table;
+    if (list->clubs && list->count >= list->capacity) {
+        table_lock_write(list->lock);
+        Club* clubs = realloc(list->clubs, sizeof(Club) * (size_t)list->capacity * 2);
+        if (clubs) {
+            list->clubs = clubs;
+            list->capacity *= 2;
+        }
+        table_unlock_write(list->lock);
+    }
+    return club_list_add(list, record->club);
+}
+
+static int club_update(void* table, int index, const ReplicationRecord* record) {
+    ClubList* list = table;
+    table_lock_write(list->lock);
+    list->clubs[index] = record->club;
+    list->dirty = 1;
+    changelog_record(list->lock, CHANGE_CLUBS, CHANGE_UPDATE, &list->clubs[index]);
+    table_unlock_write(list->lock);
+    return 1;
+}
+
+static int club_remove(void* table, int index) {
+    ClubList* list = table;
+    return club_list_remove(list, list->clubs[index].id);
+}
+
+// Memberships -----------------------------------------------------------------
+
+static void membership_encode(GByteArray* out, const void* record) {
+    const ClubMembership* membership = record;
+    put_i32(out, membership->id);
+    put_i32(out, membership->student_id);
+    put_i32(out, membership->club_id);
+    put_i64(out, (int64_t)membership->join_date);
+    put_interned(out, membership->role);
+    put_i32(out, membership->is_active);
+}
+
+static int membership_decode(Reader* in, ReplicationRecord* record) {
+    ClubMembership* membership = &record->membership;
+    memset(membership, 0, sizeof(*membership));
+    membership->id = get_i32(in);
+    membership->student_id = get_i32(in);
+    membership->club_id = get_i32(in);
+    membership->join_date = (time_t)get_i64(in);
+    membership->role = get_interned(in);
+    membership->is_active = get_i32(in);
+    return in->ok;
+}
+
+static int64_t membership_key(const void* record) { return ((const ClubMembership*)record)->id; }
+static int membership_count(const void* list) { return ((const MembershipList*)list)->count; }
+static TableLock* membership_lock(const void* list) { return ((const MembershipList*)list)->lock; }
+
+static const void* membership_get(const void* list, int index) {
+    const ClubMembership* membership = &((const MembershipList*)list)->memberships[index];
+    return membership->is_deleted ? NULL : membership;
+}
+
+static int membership_insert(void* list, const ReplicationRecord* record) {
+    return membership_list_add_with_id(list, record->membership);
+}
+
+static int membership_update(void* table, int index, const ReplicationRecord* record) {
+    MembershipList* list = table;
+    table_lock_write(list->lock);
+    list->memberships[index] = record->membership;
+    list->dirty = 1;
+    changelog_record(list->lock, CHANGE_MEMBERSHIPS, CHANGE_UPDATE, &list->memberships[index]);
+    table_unlock_write(list->lock);
+    return 1;
+}
+
+static int membership_remove(void* table, int index) {
+    MembershipList* list = table;
+    table_lock_write(list->lock);
+    int removed = tombstones_mark(&list->tombstones, &list->memberships[index].is_deleted, list->count);
+    list->dirty = 1;
+    if (removed) changelog_record(list->lock, CHANGE_MEMBERSHIPS, CHANGE_DELETE, &list->memberships[index]);
+    table_unlock_write(list->lock);
+    return removed;
+}
+
+// Professor notes -------------------------------------------------------------
+
+static void prof_note_encode(GByteArray* out, const void* record) {
+    const ProfessorNote* note = record;
+    put_i32(out, note->id);
+    put_i32(out, note->student_id);
+    put_i32(out, note->module_id);
+    put_i32(out, note->professor_id);
+    put_str(out, note->content);
+    put_str(out, note->date);
+}
+
+static int prof_note_decode(Reader* in, ReplicationRecord* record) {
+    ProfessorNote* note = &record->note;
+    memset(note, 0, sizeof(*note));
+    note->id = get_i32(in);
+    note->student_id = get_i32(in);
+    note->module_id = get_i32(in);
+    note->professor_id = get_i32(in);
+    get_chars(in, note->content, sizeof(note->content));
+    get_chars(in, note->date, sizeof(note->date));
+    return in->ok;
+}
+
+static int64_t prof_note_key(const void* record) { return ((const ProfessorNote*)record)->id; }
+static int prof_note_count(const void* list) { return ((const ProfessorNoteList*)list)->count; }
+static TableLock* prof_note_lock(const void* list) { return ((const ProfessorNoteList*)list)->lock; }
+
+static const void* prof_note_get(const void* list, int index) {
+    return &((const ProfessorNoteList*)list)->notes[index];
+}
+
+static int prof_note_insert(void* list, const ReplicationRecord* record) {
+    return prof_note_list_add(list, record->note);
+}
+
+static int prof_note_update(void* table, int index, const ReplicationRecord* record) {
+    ProfessorNoteList* list = table;
+    table_lock_write(list->lock);
+    list->notes[index] = record->note;
+    list->dirty = 1;
+    changelog_record(list->lock, CHANGE_PROF_NOTES, CHANGE_UPDATE, &list->notes[index]);
+    table_unlock_write(list->lock);
+    return 1;
+}
+
+// Notes have no tombstones; the ones after it move down
+static int prof_note_remove(void* table, int index) {
+    ProfessorNoteList* list = table;
+    table_lock_write(list->lock);
+    changelog_record(list->lock, CHANGE_PROF_NOTES, CHANGE_DELETE, &list->notes[index]);
+    memmove(&list->notes[index], &list->notes[index + 1],
+            (size_t)(list->count - index - 1) * sizeof(ProfessorNote));
+    list->count--;
+    list->dirty = 1;
+    table_unlock_write(list->lock);
+    return 1;
+}
+
+// Per table, in ChangeTable order ---------------------------------------------
+
+typedef struct {
+    const char* name;
+    size_t record_size;
+    void (*encode)(GByteArray* out, const void* record);
+    int (*decode)(Reader* in, ReplicationRecord* record);
+    int64_t (*key)(const void* record);
+    int (*count)(const void* list);
+    const void* (*get)(const void* list, int index);   // NULL for a removed record
+    TableLock* (*lock)(const void* list);
+    // Follower, main thread
+    int (*insert)(void* list, const ReplicationRecord* record);
+    int (*update)(void* list, int index, const ReplicationRecord* record);
+    int (*remove)(void* list, int index);
+} TableOps;
+
+#define TABLE_OPS(name, type, prefix) \
+    { name, sizeof(type), prefix##_encode, prefix##_decode, prefix##_key, prefix##_count, prefix##_get, \
+      prefix##_lock, prefix##_insert, prefix##_update, prefix##_remove }
+
+static const TableOps table_ops[CHANGE_TABLE_COUNT] = {
+    TABLE_OPS("users", User, user),
+    TABLE_OPS("students", Student, student),
+    TABLE_OPS("grades", Note, grade),
+    TABLE_OPS("attendance", AttendanceRecord, attendance),
+    TABLE_OPS("clubs", Club, club),
+    TABLE_OPS("memberships", ClubMembership, membership),
+    TABLE_OPS("professor notes", ProfessorNote, prof_note),
+};
+
+static void* replication_table(const ReplicationTables* tables, int table) {
+    switch (table) {
+        case CHANGE_USERS: return tables->users;
+        case CHANGE_STUDENTS: return tables->students;
+        case CHANGE_GRADES: return tables->grades;
+        case CHANGE_ATTENDANCE: return tables->attendance;
+        case CHANGE_CLUBS: return tables->clubs;
+        case CHANGE_MEMBERSHIPS: return tables->memberships;
+        case CHANGE_PROF_NOTES: return tables->prof_notes;
+        default: return NULL;
+    }
+}
+
+static void append_entry(GByteArray* out, int table, ChangeOp op, const void* record) {
+    EntryHeader entry = { (uint8_t)table, (uint8_t)op, 0, 0 };
+    guint at = out->len;
+    g_byte_array_append(out, (const guint8*)&entry, sizeof(entry));
+    table_ops[table].encode(out, record);
+    entry.length = out->len - at - (guint)sizeof(entry);
+    memcpy(out->data + at, &entry, sizeof(entry));
+}
+
+// ============================================================================
+// PRIMARY
+// ============================================================================
+
+typedef struct {
+    uint64_t first_lsn;
+    uint64_t last_lsn;
+    GBytes* frame;                  // ready to send
+} LogBatch;
+
+struct Primary;
+
+// One connected follower, served by its own sender thread
+typedef struct {
+    struct Primary* primary;
+    int fd;
+    int wake[2];                    // new batches or stop
+    GThread* thread;
+    uint64_t next_lsn;              // sender thread only
+    uint64_t acked_lsn;             // under the primary's lock
+    int64_t lag_us;                 // reported by the follower, under the lock
+    atomic_int done;                // the thread has returned
+} PrimaryLink;
+
+typedef struct Primary {
+    ReplicationTables tables;
+    char socket_path[sizeof(((struct sockaddr_un*)0)->sun_path)];
+    int listen_fd;
+    int stop_pipe[2];
+    GThread* acceptor;
+    uint64_t epoch;                 // tells this run's LSNs from an earlier run's
+    _Atomic uint64_t lsn;           // last change logged, written by the main thread
+
+    // Main thread only: the batch being filled
+    GByteArray* pending;
+    uint64_t pending_first;
+    uint32_t pending_count;
+    int64_t pending_since;
+    guint flush_timer;
+
+    GMutex lock;                    // everything below
+    GQueue backlog;                 // LogBatch, oldest first
+    size_t backlog_bytes;
+    GPtrArray* links;               // PrimaryLink
+    uint64_t snapshots;
+    uint64_t bytes_sent;
+    int64_t max_lag_us;
+    atomic_int stopping;
+} Primary;
+
+static Primary* g_primary = NULL;
+
+static void log_batch_free(gpointer data) {
+    LogBatch* batch = data;
+    g_bytes_unref(batch->frame);
+    g_free(batch);
+}
+
+// Hands the pending batch to the senders
+static void primary_flush(Primary* primary) {
+    if (primary->flush_timer) {
+        g_source_remove(primary->flush_timer);
+        primary->flush_timer = 0;
+    }
+    if (primary->pending == NULL) return;
+
+    GByteArray* frame = primary->pending;
+    primary->pending = NULL;
+    FrameHeader header = { FRAME_BATCH, frame->len - (uint32_t)sizeof(FrameHeader) };
+    BatchHeader batch = { primary->pending_first, primary->pending_count, 0, primary->pending_since };
+    memcpy(frame->data, &header, sizeof(header));
+    memcpy(frame->data + sizeof(header), &batch, sizeof(batch));
+
+    LogBatch* log = g_new0(LogBatch, 1);
+    log->first_lsn = batch.first_lsn;
+    log->last_lsn = batch.first_lsn + batch.count - 1;
+    log->frame = g_byte_array_free_to_bytes(frame);
+
+    g_mutex_lock(&primary->lock);
+    g_queue_push_tail(&primary->backlog, log);
+    primary->backlog_bytes += g_bytes_get_size(log->frame);
+    // The newest batch always stays, however large
+    while (primary->backlog_bytes > REPLICATION_BACKLOG_BYTES && primary->backlog.length > 1) {
+        LogBatch* oldest = g_queue_pop_head(&primary->backlog);
+        primary->backlog_bytes -= g_bytes_get_size(oldest->frame);
+        log_batch_free(oldest);
+    }
+    for (guint i = 0; i < primary->links->len; i++) {
+        PrimaryLink* link = g_ptr_array_index(primary->links, i);
+        wake(link->wake[1]);
+    }
+    g_mutex_unlock(&primary->lock);
+}
+
+static gboolean primary_flush_tick(gpointer data) {
+    Primary* primary = data;
+    primary->flush_timer = 0;
+    primary_flush(primary);
+    return G_SOURCE_REMOVE;
+}
+
+// Changelog hook: runs inside the mutator, under the table's write lock
+static void primary_on_change(ChangeTable table, ChangeOp op, const void* record, void* data) {
+    Primary* primary = data;
+    uint64_t lsn = atomic_load_explicit(&primary->lsn, memory_order_relaxed) + 1;
+
+    if (primary->pending == NULL) {
+        primary->pending = g_byte_array_new();
+        g_byte_array_set_size(primary->pending, sizeof(FrameHeader) + sizeof(BatchHeader));
+        primary->pending_first = lsn;
+        primary->pending_count = 0;
+        primary->pending_since = g_get_monotonic_time();
+    }
+    append_entry(primary->pending, table, op, record);
+    primary->pending_count++;
+    atomic_store_explicit(&primary->lsn, lsn, memory_order_release);
+
+    if (primary->pending->len >= REPLICATION_BATCH_BYTES) {
+        primary_flush(primary);
+    } else if (primary->flush_timer == 0) {
+        primary->flush_timer = g_timeout_add(REPLICATION_FLUSH_MS, primary_flush_tick, primary);
+    }
+}
+
+// Sender thread. Each table is copied under its read lock; the main thread
+// logs a change under the write lock, so a table's copy holds exactly the
+// changes up to the LSN read while copying it.
+static int primary_send_snapshot(PrimaryLink* link) {
+    Primary* primary = link->primary;
+    TRACE_SCOPE("replication snapshot");
+
+    GByteArray* frame = g_byte_array_new();
+    g_byte_array_set_size(frame, sizeof(FrameHeader) + sizeof(SnapshotHeader));
+    SnapshotHeader snapshot;
+    memset(&snapshot, 0, sizeof(snapshot));
+    snapshot.epoch = primary->epoch;
+    snapshot.next_lsn = UINT64_MAX;
+
+    for (int t = 0; t < CHANGE_TABLE_COUNT; t++) {
+        const TableOps* ops = &table_ops[t];
+        const void* list = replication_table(&primary->tables, t);
+        TableLock* lock = list ? ops->lock(list) : NULL;
+        table_lock_read(lock);
+        snapshot.table_lsn[t] = atomic_load_explicit(&primary->lsn, memory_order_acquire);
+        int count = list ? ops->count(list) : 0;
+        for (int i = 0; i < count; i++) {
+            const void* record = ops->get(list, i);
+            if (record == NULL) continue;
+            append_entry(frame, t, CHANGE_INSERT, record);
+            snapshot.count++;
+        }
+        table_unlock_read(lock);
+        if (snapshot.table_lsn[t] + 1 < snapshot.next_lsn) snapshot.next_lsn = snapshot.table_lsn[t] + 1;
+    }
+
+    FrameHeader header = { FRAME_SNAPSHOT, frame->len - (uint32_t)sizeof(FrameHeader) };
+    memcpy(frame->data, &header, sizeof(header));
+    memcpy(frame->data + sizeof(header), &snapshot, sizeof(snapshot));
+    int ok = send_all(link->fd, frame->data, frame->len);
+
+    if (ok) {
+        char* size = g_format_size(frame->len);
+        printf("[INFO] Replication: sent a snapshot of %u records (%s) to a follower\n", snapshot.count, size);
+        g_free(size);
+        link->next_lsn = snapshot.next_lsn;
+        g_mutex_lock(&primary->lock);
+        primary->snapshots++;
+        primary->bytes_sent += frame->len;
+        g_mutex_unlock(&primary->lock);
+    }
+    g_byte_array_free(frame, TRUE);
+    return ok;
+}
+
+static int primary_read_ack(PrimaryLink* link) {
+    FrameHeader header;
+    AckFrame ack;
+    if (!recv_all(link->fd, &header, sizeof(header))) return 0;
+    if (header.type != FRAME_ACK || header.length != sizeof(ack) || !recv_all(link->fd, &ack, sizeof(ack))) {
+        return 0;
+    }
+    Primary* primary = link->primary;
+    g_mutex_lock(&primary->lock);
+    link->acked_lsn = ack.applied_lsn;
+    link->lag_us = ack.lag_us;
+    if (ack.lag_us > primary->max_lag_us) primary->max_lag_us = ack.lag_us;
+    g_mutex_unlock(&primary->lock);
+    return 1;
+}
+
+// Every acknowledgement already waiting, so they never pile up in the socket
+static int primary_read_acks(PrimaryLink* link) {
+    struct pollfd fds = { link->fd, POLLIN, 0 };
+    do {
+        if (!primary_read_ack(link)) return 0;
+    } while (poll(&fds, 1, 0) > 0 && (fds.revents & (POLLIN | POLLHUP | POLLERR)));
+    return 1;
+}
+
+// The follower can resume at next_lsn if every change from there on is
+// still in the backlog or not sent yet
+static int primary_can_resume(Primary* primary, uint64_t next_lsn) {
+    if (next_lsn == 0 || next_lsn > atomic_load(&primary->lsn) + 1) return 0;
+    g_mutex_lock(&primary->lock);
+    LogBatch* oldest = g_queue_peek_head(&primary->backlog);
+    int ok = oldest == NULL || next_lsn >= oldest->first_lsn;
+    g_mutex_unlock(&primary->lock);
+    return ok;
+}
+
+static gpointer primary_link_thread(gpointer data) {
+    PrimaryLink* link = data;
+    Primary* primary = link->primary;
+    TRACE_THREAD_NAME("replication sender");
+
+    FrameHeader header;
+    HelloFrame hello;
+    if (!recv_all(link->fd, &header, sizeof(header)) || header.type != FRAME_HELLO ||
+        header.length != sizeof(hello) || !recv_all(link->fd, &hello, sizeof(hello)) ||
+        hello.magic != REPLICATION_MAGIC || hello.version != REPLICATION_VERSION) {
+        printf("[WARNING] Replication: refused a connection that is not a follower\n");
+        goto done;
+    }
+    if (hello.epoch == primary->epoch && primary_can_resume(primary, hello.next_lsn)) {
+        link->next_lsn = hello.next_lsn;
+        printf("[INFO] Replication: follower resumed at change %llu\n", (unsigned long long)hello.next_lsn);
+    } else if (!primary_send_snapshot(link)) {
+        goto done;
+    }
+
+    while (!atomic_load(&primary->stopping)) {
+        // Take references to the batches still to send
+        GPtrArray* frames = g_ptr_array_new_with_free_func((GDestroyNotify)g_bytes_unref);
+        uint64_t last_lsn = 0;
+        int behind = 0;
+        g_mutex_lock(&primary->lock);
+        LogBatch* oldest = g_queue_peek_head(&primary->backlog);
+        if (oldest && link->next_lsn < oldest->first_lsn) {
+            behind = 1;
+        } else {
+            GList* l = primary->backlog.tail;
+            while (l && ((LogBatch*)l->data)->first_lsn > link->next_lsn) l = l->prev;
+            for (l = l ? l : primary->backlog.head; l; l = l->next) {
+                LogBatch* batch = l->data;
+                if (batch->last_lsn < link->next_lsn) continue;
+                g_ptr_array_add(frames, g_bytes_ref(batch->frame));
+                last_lsn = batch->last_lsn;
+            }
+        }
+        g_mutex_unlock(&primary->lock);
+
+        if (behind) {
+            g_ptr_array_unref(frames);
+            printf("[WARNING] Replication: a follower fell behind the backlog, resending a snapshot\n");
+            if (!primary_send_snapshot(link)) break;
+            continue;
+        }
+
+        // Blocks while the follower is not reading: that holds back this
+        // thread only
+        size_t sent = 0;
+        int ok = 1;
+        for (guint i = 0; i < frames->len && ok; i++) {
+            gsize size;
+            const void* bytes = g_bytes_get_data(g_ptr_array_index(frames, i), &size);
+            ok = send_all(link->fd, bytes, size);
+            sent += size;
+        }
+        g_ptr_array_unref(frames);
+        if (!ok) break;
+        if (sent > 0) {
+            link->next_lsn = last_lsn + 1;
+            g_mutex_lock(&primary->lock);
+            primary->bytes_sent += sent;
+            g_mutex_unlock(&primary->lock);
+        }
+
+        // Acknowledgements, new batches, or a heartbeat after a quiet spell
+        struct pollfd fds[2] = { { link->fd, POLLIN, 0 }, { link->wake[0], POLLIN, 0 } };
+        int n = poll(fds, 2, sent > 0 ? 0 : REPLICATION_HEARTBEAT_MS);
+        if (n < 0 && errno != EINTR) break;
+        if (n == 0 && sent == 0) {
+            HeartbeatFrame heartbeat = { atomic_load(&primary->lsn), g_get_monotonic_time() };
+            if (!send_frame(link->fd, FRAME_HEARTBEAT, &heartbeat, sizeof(heartbeat))) break;
+        }
+        if (fds[1].revents & POLLIN) drain(link->wake[0]);
+        if ((fds[0].revents & (POLLIN | POLLHUP | POLLERR)) && !primary_read_acks(link)) break;
+    }
+
+done:
+    if (!atomic_load(&primary->stopping)) printf("[INFO] Replication: follower disconnected\n");
+    shutdown(link->fd, SHUT_RDWR);
+    atomic_store(&link->done, 1);
+    return NULL;
+}
+
+static void primary_link_free(PrimaryLink* link) {
+    g_thread_join(link->thread);
+    close(link->fd);
+    close(link->wake[0]);
+    close(link->wake[1]);
+    g_free(link);
+}
+
+// Joins the senders of followers that went away
+static void primary_reap(Primary* primary) {
+    GPtrArray* finished = g_ptr_array_new();
+    g_mutex_lock(&primary->lock);
+    for (guint i = primary->links->len; i-- > 0;) {
+        PrimaryLink* link = g_ptr_array_index(primary->links, i);
+        if (atomic_load(&link->done)) {
+            g_ptr_array_add(finished, link);
+            g_ptr_array_remove_index(primary->links, i);
+        }
+    }
+    g_mutex_unlock(&primary->lock);
+    for (guint i = 0; i < finished->len; i++) primary_link_free(g_ptr_array_index(finished, i));
+    g_ptr_array_free(finished, TRUE);
+}
+
+static gpointer primary_accept_thread(gpointer data) {
+    Primary* primary = data;
+    TRACE_THREAD_NAME("replication");
+
+    for (;;) {
+        struct pollfd fds[2] = { { primary->listen_fd, POLLIN, 0 }, { primary->stop_pipe[0], POLLIN, 0 } };
+        if (poll(fds, 2, -1) < 0 && errno != EINTR) break;
+        if (fds[1].revents & POLLIN) break;
+        if (!(fds[0].revents & POLLIN)) continue;
+
+        int fd = accept(primary->listen_fd, NULL, NULL);
+        if (fd < 0) continue;
+        socket_setup(fd);
+        primary_reap(primary);
+
+        g_mutex_lock(&primary->lock);
+        int full = primary->links->len >= REPLICATION_MAX_FOLLOWERS;
+        g_mutex_unlock(&primary->lock);
+        PrimaryLink* link = full ? NULL : g_new0(PrimaryLink, 1);
+        if (link == NULL || !wake_pipe(link->wake)) {
+            printf("[WARNING] Replication: refused a follower, %d already connected\n", REPLICATION_MAX_FOLLOWERS);
+            g_free(link);
+            close(fd);
+            continue;
+        }
+        link->primary = primary;
+        link->fd = fd;
+        g_mutex_lock(&primary->lock);
+        g_ptr_array_add(primary->links, link);
+        g_mutex_unlock(&primary->lock);
+        link->thread = g_thread_new("replication sender", primary_link_thread, link);
+        printf("[INFO] Replication: follower connected\n");
+    }
+    return NULL;
+}
+
+int replication_primary_start(const char* socket_path, const ReplicationTables* tables) {
+    if (g_primary) return 1;
+    if (socket_path == NULL || tables == NULL) {
+        printf("[ERROR] Invalid replication arguments\n");
+        return 0;
+    }
+    struct sockaddr_un addr;
+    if (!socket_address(socket_path, &addr)) {
+        printf("[ERROR] Replication: socket path too long: %s\n", socket_path);
+        return 0;
+    }
+
+    // A socket file left by a crash refuses connections; a live primary
+    // accepts them and keeps its socket
+    int other = socket_connect(socket_path);
+    if (other >= 0) {
+        close(other);
+        printf("[WARNING] Replication: another instance already accepts followers on %s\n", socket_path);
+        return 0;
+    }
+    unlink(socket_path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || (socket_setup(fd), bind(fd, (struct sockaddr*)&addr, sizeof(addr))) != 0 ||
+        chmod(socket_path, S_IRUSR | S_IWUSR) != 0 || listen(fd, REPLICATION_MAX_FOLLOWERS) != 0) {
+        printf("[ERROR] Replication: cannot listen on %s (%s)\n", socket_path, g_strerror(errno));
+        if (fd >= 0) close(fd);
+        unlink(socket_path);
+        return 0;
+    }
+
+    Primary* primary = g_new0(Primary, 1);
+    if (!wake_pipe(primary->stop_pipe)) {
+        printf("[ERROR] Replication: %s\n", g_strerror(errno));
+        close(fd);
+        unlink(socket_path);
+        g_free(primary);
+        return 0;
+    }
+    primary->tables = *tables;
+    g_strlcpy(primary->socket_path, socket_path, sizeof(primary->socket_path));
+    primary->listen_fd = fd;
+    primary->epoch = ((uint64_t)g_random_int() << 32) | g_random_int() | 1;
+    g_mutex_init(&primary->lock);
+    g_queue_init(&primary->backlog);
+    primary->links = g_ptr_array_new();
+
+    g_primary = primary;
+    changelog_set_hook(primary_on_change, primary);
+    primary->acceptor = g_thread_new("replication", primary_accept_thread, primary);
+    printf("[OK] Replication: accepting followers on %s\n", socket_path);
+    return 1;
+}
+
+void replication_primary_stop(void) {
+    Primary* primary = g_primary;
+    if (primary == NULL) return;
+
+    changelog_set_hook(NULL, NULL);
+    primary_flush(primary);
+    atomic_store(&primary->stopping, 1);
+    wake(primary->stop_pipe[1]);
+    g_thread_join(primary->acceptor);
+    close(primary->listen_fd);
+    unlink(primary->socket_path);
+
+    // Unblock senders stuck on a follower that stopped reading
+    g_mutex_lock(&primary->lock);
+    for (guint i = 0; i < primary->links->len; i++) {
+        PrimaryLink* link = g_ptr_array_index(primary->links, i);
+        shutdown(link->fd, SHUT_RDWR);
+        wake(link->wake[1]);
+    }
+    g_mutex_unlock(&primary->lock);
+    for (guint i = 0; i < primary->links->len; i++) primary_link_free(g_ptr_array_index(primary->links, i));
+    g_ptr_array_free(primary->links, TRUE);
+
+    g_queue_clear_full(&primary->backlog, log_batch_free);
+    close(primary->stop_pipe[0]);
+    close(primary->stop_pipe[1]);
+    g_mutex_clear(&primary->lock);
+    g_free(primary);
+    g_primary = NULL;
+}
+
+// ============================================================================
+// FOLLOWER
+// ============================================================================
+
+typedef struct {
+    ReplicationTables tables;
+    ReplicationApplyFunc apply;
+    void* apply_data;
+    char socket_path[sizeof(((struct sockaddr_un*)0)->sun_path)];
+    int stop_pipe[2];
+    GThread* receiver;
+    atomic_int stopping;
+
+    // Receiver thread only: where the received log stands
+    uint64_t epoch;
+    uint64_t next_lsn;
+    atomic_int resync;              // set by the main thread: reconnect for a snapshot
+
+    // Frames received and not yet applied, oldest first
+    GAsyncQueue* received;
+    atomic_int apply_scheduled;
+
+    // Main thread only
+    int broken;                                // a batch failed to decode; batches wait for a snapshot
+    uint64_t table_lsn[CHANGE_TABLE_COUNT];    // changes already in the last snapshot
+    GHashTable* index[CHANGE_TABLE_COUNT];     // key -> position + 1
+    int index_count[CHANGE_TABLE_COUNT];       // table count the index was built for
+    GByteArray* scratch;
+
+    GMutex lock;                    // everything below
+    GCond drained;
+    int fd;                         // connection to the primary, -1 when there is none
+    size_t queued_bytes;
+    uint64_t applied_lsn;
+    uint64_t primary_lsn;
+    int64_t lag_us;
+    int64_t max_lag_us;
+    uint64_t snapshots;
+    uint64_t bytes_received;
+} Follower;
+
+static Follower* g_follower = NULL;
+
+// Main thread ---------------------------------------------------------------
+
+static void follower_notify(Follower* follower, int table, ChangeOp op, const void* record) {
+    if (follower->apply) follower->apply((ChangeTable)table, op, record, follower->apply_data);
+}
+
+static void follower_drop_index(Follower* follower, int table) {
+    if (follower->index[table]) g_hash_table_destroy(follower->index[table]);
+    follower->index[table] = NULL;
+}
+
+static void follower_index_put(Follower* follower, int table, int64_t key, int position) {
+    int64_t* stored = g_new(int64_t, 1);
+    *stored = key;
+    g_hash_table_replace(follower->index[table], stored, GINT_TO_POINTER(position + 1));
+}
+
+// Position of the live record with this key, or -1. The index survives
+// between batches; it is rebuilt when the table changed size behind its
+// back (compaction, a removal that shifts) or an entry went stale (a sort).
+static int follower_find(Follower* follower, int table, const void* list, int64_t key) {
+    const TableOps* ops = &table_ops[table];
+    for (int attempt = 0; attempt < 2; attempt++) {
+        int count = ops->count(list);
+        if (follower->index[table] == NULL || follower->index_count[table] != count) {
+            follower_drop_index(follower, table);
+            follower->index[table] = g_hash_table_new_full(g_int64_hash, g_int64_equal, g_free, NULL);
+            follower->index_count[table] = count;
+            for (int i = 0; i < count; i++) {
+                const void* record = ops->get(list, i);
+                if (record) follower_index_put(follower, table, ops->key(record), i);
+            }
+        }
+        int position = GPOINTER_TO_INT(g_hash_table_lookup(follower->index[table], &key)) - 1;
+        if (position < 0) return -1;
+        const void* record = ops->get(list, position);
+        if (record && ops->key(record) == key) return position;
+        follower_drop_index(follower, table);
+    }
+    return -1;
+}
+
+static int follower_insert(Follower* follower, int table, void* list, const ReplicationRecord* record) {
+    const TableOps* ops = &table_ops[table];
+    if (!ops->insert(list, record)) {
+        printf("[WARNING] Replication: could not add a record to %s\n", ops->name);
+        return 0;
+    }
+    int position = ops->count(list) - 1;
+    if (follower->index[table]) {
+        follower_index_put(follower, table, ops->key(record), position);
+        follower->index_count[table] = position + 1;
+    }
+    follower_notify(follower, table, CHANGE_INSERT, ops->get(list, position));
+    return 1;
+}
+
+static int follower_remove(Follower* follower, int table, void* list, int position) {
+    const TableOps* ops = &table_ops[table];
+    ReplicationRecord old;
+    memcpy(&old, ops->get(list, position), ops->record_size);
+    if (!ops->remove(list, position)) return 0;
+    int64_t key = ops->key(&old);
+    if (follower->index[table]) g_hash_table_remove(follower->index[table], &key);
+    follower_notify(follower, table, CHANGE_DELETE, &old);
+    return 1;
+}
+
+// Updates the record unless it already holds these values
+static int follower_update(Follower* follower, int table, void* list, int position,
+                           const ReplicationRecord* record, const uint8_t* encoded, size_t length) {
+    const TableOps* ops = &table_ops[table];
+    g_byte_array_set_size(follower->scratch, 0);
+    ops->encode(follower->scratch, ops->get(list, position));
+    if (follower->scratch->len == length && memcmp(follower->scratch->data, encoded, length) == 0) return 0;
+    if (!ops->update(list, position, record)) return 0;
+    follower_notify(follower, table, CHANGE_UPDATE, ops->get(list, position));
+    return 1;
+}
+
+static void follower_apply_batch(Follower* follower, const uint8_t* payload, size_t length) {
+    TRACE_SCOPE("replication apply");
+    // Applying later changes over a gap would silently diverge
+    if (follower->broken) return;
+
+    BatchHeader batch;
+    Reader in = { payload, length, 1 };
+    get_bytes(&in, &batch, sizeof(batch));
+
+    uint32_t i;
+    for (i = 0; i < batch.count && in.ok; i++) {
+        uint64_t lsn = batch.first_lsn + i;
+        EntryHeader entry;
+        get_bytes(&in, &entry, sizeof(entry));
+        if (!in.ok || entry.table >= CHANGE_TABLE_COUNT || entry.length > in.left) break;
+        Reader record_in = { in.data, entry.length, 1 };
+        const uint8_t* encoded = in.data;
+        in.data += entry.length;
+        in.left -= entry.length;
+
+        int table = entry.table;
+        void* list = replication_table(&follower->tables, table);
+        if (list == NULL || lsn <= follower->table_lsn[table] || lsn <= follower->applied_lsn) continue;
+
+        ReplicationRecord record;
+        if (!table_ops[table].decode(&record_in, &record)) break;
+        int position = follower_find(follower, table, list, table_ops[table].key(&record));
+        if (entry.op == CHANGE_DELETE) {
+            if (position >= 0) follower_remove(follower, table, list, position);
+        } else if (position >= 0) {
+            follower_update(follower, table, list, position, &record, encoded, entry.length);
+        } else {
+            follower_insert(follower, table, list, &record);
+        }
+    }
+    if (i < batch.count) {
+        // The rest of the batch is lost: stay at the last applied change and
+        // have the receiver reconnect without an epoch, which gets a snapshot
+        printf("[ERROR] Replication: malformed batch at change %llu, asking for a snapshot\n",
+               (unsigned long long)(batch.first_lsn + i));
+        follower->broken = 1;
+        atomic_store(&follower->resync, 1);
+        return;
+    }
+
+    int64_t lag = g_get_monotonic_time() - batch.logged_at;
+    g_mutex_lock(&follower->lock);
+    if (batch.count > 0 && batch.first_lsn + batch.count - 1 > follower->applied_lsn) {
+        follower->applied_lsn = batch.first_lsn + batch.count - 1;
+    }
+    follower->lag_us = lag;
+    if (lag > follower->max_lag_us) follower->max_lag_us = lag;
+    g_mutex_unlock(&follower->lock);
+}
+
+// Applies the snapshot as a difference with the tables: changed records are
+// updated, the ones the primary no longer has removed, then new ones added
+static void follower_apply_snapshot(Follower* follower, const uint8_t* payload, size_t length) {
+    TRACE_SCOPE("replication snapshot");
+    SnapshotHeader snapshot;
+    Reader in = { payload, length, 1 };
+    get_bytes(&in, &snapshot, sizeof(snapshot));
+
+    GHashTable* seen[CHANGE_TABLE_COUNT];
+    for (int t = 0; t < CHANGE_TABLE_COUNT; t++) seen[t] = g_hash_table_new_full(g_int64_hash, g_int64_equal, g_free, NULL);
+    GPtrArray* missing = g_ptr_array_new();    // entries to add, once the removed records made room
+    int added = 0, changed = 0, removed = 0;
+
+    uint32_t i;
+    for (i = 0; i < snapshot.count && in.ok; i++) {
+        EntryHeader entry;
+        get_bytes(&in, &entry, sizeof(entry));
+        if (!in.ok || entry.table >= CHANGE_TABLE_COUNT || entry.length > in.left) break;
+        Reader record_in = { in.data, entry.length, 1 };
+        const uint8_t* encoded = in.data;
+        in.data += entry.length;
+        in.left -= entry.length;
+
+        int table = entry.table;
+        void* list = replication_table(&follower->tables, table);
+        ReplicationRecord record;
+        if (list == NULL) continue;
+        if (!table_ops[table].decode(&record_in, &record)) break;
+
+        int64_t* key = g_new(int64_t, 1);
+        *key = table_ops[table].key(&record);
+        g_hash_table_add(seen[table], key);
+        int position = follower_find(follower, table, list, *key);
+        if (position >= 0) {
+            changed += follower_update(follower, table, list, position, &record, encoded, entry.length);
+        } else {
+            g_ptr_array_add(missing, (gpointer)(encoded - sizeof(entry)));
+        }
+    }
+
+    if (i < snapshot.count) {
+        // Keep the records rather than remove what a broken snapshot left out
+        printf("[ERROR] Replication: malformed snapshot, keeping the tables as they are\n");
+    } else {
+        // Last first, so removals that shift the records after them do not
+        // move the ones still to remove
+        for (int t = 0; t < CHANGE_TABLE_COUNT; t++) {
+            void* list = replication_table(&follower->tables, t);
+            if (list == NULL) continue;
+            const TableOps* ops = &table_ops[t];
+            for (int position = ops->count(list) - 1; position >= 0; position--) {
+                const void* record = ops->get(list, position);
+                if (record == NULL) continue;
+                int64_t key = ops->key(record);
+                if (!g_hash_table_contains(seen[t], &key)) removed += follower_remove(follower, t, list, position);
+            }
+            follower->table_lsn[t] = snapshot.table_lsn[t];
+        }
+        follower->broken = 0;
+    }
+    // Decoded once already, so well formed
+    for (guint m = 0; m < missing->len; m++) {
+        EntryHeader entry;
+        memcpy(&entry, missing->pdata[m], sizeof(entry));
+        Reader record_in = { (const uint8_t*)missing->pdata[m] + sizeof(entry), entry.length, 1 };
+        ReplicationRecord record;
+        table_ops[entry.table].decode(&record_in, &record);
+        added += follower_insert(follower, entry.table, replication_table(&follower->tables, entry.table), &record);
+    }
+    g_ptr_array_free(missing, TRUE);
+    for (int t = 0; t < CHANGE_TABLE_COUNT; t++) g_hash_table_destroy(seen[t]);
+
+    g_mutex_lock(&follower->lock);
+    follower->applied_lsn = snapshot.next_lsn - 1;
+    follower->snapshots++;
+    g_mutex_unlock(&follower->lock);
+    printf("[OK] Replication: applied a snapshot of %u records (%d added, %d changed, %d removed)\n",
+           snapshot.count, added, changed, removed);
+}
+
+static gboolean follower_apply_pending(gpointer data) {
+    Follower* follower = data;
+    atomic_store(&follower->apply_scheduled, 0);
+
+    size_t applied = 0;
+    GBytes* frame;
+    while (applied < REPLICATION_APPLY_BUDGET && (frame = g_async_queue_try_pop(follower->received)) != NULL) {
+        gsize size;
+        const uint8_t* data_bytes = g_bytes_get_data(frame, &size);
+        FrameHeader header;
+        memcpy(&header, data_bytes, sizeof(header));
+        if (header.type == FRAME_SNAPSHOT) {
+            follower_apply_snapshot(follower, data_bytes + sizeof(header), header.length);
+        } else {
+            follower_apply_batch(follower, data_bytes + sizeof(header), header.length);
+        }
+        g_bytes_unref(frame);
+        applied += size;
+
+        g_mutex_lock(&follower->lock);
+        follower->queued_bytes -= size;
+        g_cond_broadcast(&follower->drained);
+        g_mutex_unlock(&follower->lock);
+    }
+
+    // Out of budget: let the UI draw, then go on, unless the receiver has
+    // scheduled another run meanwhile
+    if (applied >= REPLICATION_APPLY_BUDGET && g_async_queue_length(follower->received) > 0 &&
+        !atomic_exchange(&follower->apply_scheduled, 1)) {
+        return G_SOURCE_CONTINUE;
+    }
+    return G_SOURCE_REMOVE;
+}
+
+// Receiver thread -------------------------------------------------------------
+
+// Waits for the main thread when too much is queued, which stops reading
+// from the socket and so holds back the primary's sender
+static void follower_enqueue(Follower* follower, GBytes* frame) {
+    g_mutex_lock(&follower->lock);
+    while (follower->queued_bytes > REPLICATION_QUEUE_BYTES && !atomic_load(&follower->stopping)) {
+        g_cond_wait(&follower->drained, &follower->lock);
+    }
+    follower->queued_bytes += g_bytes_get_size(frame);
+    g_mutex_unlock(&follower->lock);
+
+    g_async_queue_push(follower->received, frame);
+    if (!atomic_exchange(&follower->apply_scheduled, 1)) g_idle_add(follower_apply_pending, follower);
+}
+
+// 0 when the connection should be dropped
+static int follower_receive(Follower* follower, int fd) {
+    FrameHeader header;
+    if (!recv_all(fd, &header, sizeof(header))) return 0;
+    if (header.length > REPLICATION_MAX_FRAME_BYTES) {
+        printf("[ERROR] Replication: refused a frame of %u bytes\n", header.length);
+        return 0;
+    }
+    uint8_t* frame = g_malloc(sizeof(header) + header.length);
+    memcpy(frame, &header, sizeof(header));
+    if (!recv_all(fd, frame + sizeof(header), header.length)) {
+        g_free(frame);
+        return 0;
+    }
+    g_mutex_lock(&follower->lock);
+    follower->bytes_received += sizeof(header) + header.length;
+    g_mutex_unlock(&follower->lock);
+
+    const uint8_t* payload = frame + sizeof(header);
+    uint64_t announced = 0;
+    if (header.type == FRAME_HEARTBEAT && header.length == sizeof(HeartbeatFrame)) {
+        HeartbeatFrame heartbeat;
+        memcpy(&heartbeat, payload, sizeof(heartbeat));
+        announced = heartbeat.lsn;
+        g_free(frame);
+        frame = NULL;
+    } else if (header.type == FRAME_BATCH && header.length >= sizeof(BatchHeader)) {
+        BatchHeader batch;
+        memcpy(&batch, payload, sizeof(batch));
+        if (batch.first_lsn > follower->next_lsn) {
+            printf("[WARNING] Replication: changes %llu to %llu are missing, asking for a snapshot\n",
+                   (unsigned long long)follower->next_lsn, (unsigned long long)batch.first_lsn - 1);
+            follower->epoch = 0;
+            g_free(frame);
+            return 0;
+        }
+        if (batch.first_lsn + batch.count > follower->next_lsn) follower->next_lsn = batch.first_lsn + batch.count;
+        announced = follower->next_lsn - 1;
+    } else if (header.type == FRAME_SNAPSHOT && header.length >= sizeof(SnapshotHeader)) {
+        SnapshotHeader snapshot;
+        memcpy(&snapshot, payload, sizeof(snapshot));
+        follower->epoch = snapshot.epoch;
+        follower->next_lsn = snapshot.next_lsn;
+        announced = snapshot.next_lsn - 1;
+    } else {
+        printf("[ERROR] Replication: unexpected frame %u from the primary\n", header.type);
+        g_free(frame);
+        return 0;
+    }
+
+    g_mutex_lock(&follower->lock);
+    if (announced > follower->primary_lsn) follower->primary_lsn = announced;
+    g_mutex_unlock(&follower->lock);
+    if (frame) follower_enqueue(follower, g_bytes_new_take(frame, sizeof(header) + header.length));
+    return 1;
+}
+
+static void follower_session(Follower* follower, int fd) {
+    HelloFrame hello = { REPLICATION_MAGIC, REPLICATION_VERSION, follower->epoch, follower->next_lsn };
+    if (!send_frame(fd, FRAME_HELLO, &hello, sizeof(hello))) return;
+
+    uint64_t acked = 0;
+    while (!atomic_load(&follower->stopping)) {
+        struct pollfd fds[2] = { { fd, POLLIN, 0 }, { follower->stop_pipe[0], POLLIN, 0 } };
+        int n = poll(fds, 2, REPLICATION_ACK_MS);
+        if (n < 0 && errno != EINTR) return;
+        if (fds[1].revents & POLLIN) return;
+        if ((fds[0].revents & (POLLIN | POLLHUP | POLLERR)) && !follower_receive(follower, fd)) return;
+        if (atomic_exchange(&follower->resync, 0)) {
+            follower->epoch = 0;
+            return;
+        }
+
+        g_mutex_lock(&follower->lock);
+        AckFrame ack = { follower->applied_lsn, follower->lag_us };
+        g_mutex_unlock(&follower->lock);
+        if (ack.applied_lsn != acked) {
+            if (!send_frame(fd, FRAME_ACK, &ack, sizeof(ack))) return;
+            acked = ack.applied_lsn;
+        }
+    }
+}
+
+static gpointer follower_thread(gpointer data) {
+    Follower* follower = data;
+    TRACE_THREAD_NAME("replication");
+
+    int waiting = 0;
+    while (!atomic_load(&follower->stopping)) {
+        int fd = socket_connect(follower->socket_path);
+        if (fd < 0) {
+            if (!waiting) printf("[INFO] Replication: waiting for the primary at %s\n", follower->socket_path);
+            waiting = 1;
+            struct pollfd stop = { follower->stop_pipe[0], POLLIN, 0 };
+            poll(&stop, 1, REPLICATION_RETRY_MS);
+            continue;
+        }
+        waiting = 0;
+        g_mutex_lock(&follower->lock);
+        follower->fd = fd;
+        g_mutex_unlock(&follower->lock);
+        printf("[OK] Replication: connected to the primary\n");
+
+        follower_session(follower, fd);
+
+        g_mutex_lock(&follower->lock);
+        follower->fd = -1;
+        g_mutex_unlock(&follower->lock);
+        close(fd);
+        if (!atomic_load(&follower->stopping)) printf("[WARNING] Replication: lost the primary, reconnecting\n");
+    }
+    return NULL;
+}
+
+int replication_follower_start(const char* socket_path, const ReplicationTables* tables,
+                               ReplicationApplyFunc apply, void* user_data) {
+    if (g_follower) return 1;
+    if (g_primary) {
+        printf("[ERROR] Replication: this instance is already a primary\n");
+        return 0;
+    }
+    struct sockaddr_un addr;
+    if (socket_path == NULL || tables == NULL || !socket_address(socket_path, &addr)) {
+        printf("[ERROR] Invalid replication arguments\n");
+        return 0;
+    }
+
+    Follower* follower = g_new0(Follower, 1);
+    if (!wake_pipe(follower->stop_pipe)) {
+        printf("[ERROR] Replication: %s\n", g_strerror(errno));
+        g_free(follower);
+        return 0;
+    }
+    follower->tables = *tables;
+    follower->apply = apply;
+    follower->apply_data = user_data;
+    g_strlcpy(follower->socket_path, socket_path, sizeof(follower->socket_path));
+    follower->next_lsn = 1;
+    follower->fd = -1;
+    follower->received = g_async_queue_new_full((GDestroyNotify)g_bytes_unref);
+    follower->scratch = g_byte_array_new();
+    g_mutex_init(&follower->lock);
+    g_cond_init(&follower->drained);
+
+    g_follower = follower;
+    follower->receiver = g_thread_new("replication", follower_thread, follower);
+    return 1;
+}
+
+void replication_follower_stop(void) {
+    Follower* follower = g_follower;
+    if (follower == NULL) return;
+
+    g_mutex_lock(&follower->lock);
+    atomic_store(&follower->stopping, 1);
+    if (follower->fd >= 0) shutdown(follower->fd, SHUT_RDWR);
+    g_cond_broadcast(&follower->drained);
+    g_mutex_unlock(&follower->lock);
+    wake(follower->stop_pipe[1]);
+    g_thread_join(follower->receiver);
+
+    while (g_idle_remove_by_data(follower)) {
+    }
+    g_async_queue_unref(follower->received);
+    for (int t = 0; t < CHANGE_TABLE_COUNT; t++) follower_drop_index(follower, t);
+    g_byte_array_free(follower->scratch, TRUE);
+    close(follower->stop_pipe[0]);
+    close(follower->stop_pipe[1]);
+    g_cond_clear(&follower->drained);
+    g_mutex_clear(&follower->lock);
+    g_free(follower);
+    g_follower = NULL;
+}
+
+// ============================================================================
+// STATUS
+// ============================================================================
+
+void replication_get_status(ReplicationStatus* status) {
+    if (status == NULL) return;
+    memset(status, 0, sizeof(*status));
+
+    if (g_primary) {
+        Primary* primary = g_primary;
+        status->role = REPLICATION_PRIMARY;
+        status->lsn = status->primary_lsn = atomic_load(&primary->lsn);
+        g_mutex_lock(&primary->lock);
+        uint64_t slowest = status->lsn;
+        int64_t lag = 0;
+        for (guint i = 0; i < primary->links->len; i++) {
+            PrimaryLink* link = g_ptr_array_index(primary->links, i);
+            if (atomic_load(&link->done)) continue;
+            status->connected++;
+            if (link->acked_lsn < slowest) slowest = link->acked_lsn;
+            if (link->lag_us > lag) lag = link->lag_us;
+        }
+        status->behind = status->lsn - slowest;
+        status->lag_ms = lag / 1000.0;
+        status->max_lag_ms = primary->max_lag_us / 1000.0;
+        status->snapshots = primary->snapshots;
+        status->bytes = primary->bytes_sent;
+        g_mutex_unlock(&primary->lock);
+    } else if (g_follower) {
+        Follower* follower = g_follower;
+        status->role = REPLICATION_FOLLOWER;
+        g_mutex_lock(&follower->lock);
+        status->connected = follower->fd >= 0;
+        status->lsn = follower->applied_lsn;
+        status->primary_lsn = follower->primary_lsn > follower->applied_lsn ? follower->primary_lsn
+                                                                            : follower->applied_lsn;
+        status->behind = status->primary_lsn - status->lsn;
+        status->lag_ms = follower->lag_us / 1000.0;
+        status->max_lag_ms = follower->max_lag_us / 1000.0;
+        status->snapshots = follower->snapshots;
+        status->bytes = follower->bytes_received;
+        g_mutex_unlock(&follower->lock);
+    }
+}
+
+#else
+
+int replication_primary_start(const char* socket_path, const ReplicationTables* tables) {
+    (void)socket_path;
+    (void)tables;
+    printf("[WARNING] Replication needs Unix domain sockets and is not available on Windows\n");
+    return 0;
+}
+
+void replication_primary_stop(void) {
+}
+
+int replication_follower_start(const char* socket_path, const ReplicationTables* tables,
+                               ReplicationApplyFunc apply, void* user_data) {
+    (void)socket_path;
+    (void)tables;
+    (void)apply;
+    (void)user_data;
+    printf("[WARNING] Replication needs Unix domain sockets and is not available on Windows\n");
+    return 0;
+}
+
+void replication_follower_stop(void) {
+}
+
+void replication_get_status(ReplicationStatus* status) {
+    if (status) memset(status, 0, sizeof(*status));
+}
+
+#endif
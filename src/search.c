@@ -0,0 +1,644 @@
+#include "search.h"
+#include <ctype.h>
+#include <stdlib.h>
+
+#define SEARCH_COMPACT_MIN_DEAD 1024
+
+// Latin-1 supplement (U+00C0..U+00FF, UTF-8 0xC3 0x80..0xBF) folded to ASCII
+static const char* latin1_fold[64] = {
+    "a", "a", "a", "a", "a", "a", "ae", "c", "e", "e", "e", "e", "i", "i", "i", "i",
+    "d", "n", "o", "o", "o", "o", "o", " ", "o", "u", "u", "u", "u", "y", "th", "ss",
+    "a", "a", "a", "a", "a", "a", "ae", "c", "e", "e", "e", "e", "i", "i", "i", "i",
+    "d", "n", "o", "o", "o", "o", "o", " ", "o", "u", "u", "u", "u", "y", "th", "y"
+};
+
+// ============================================================================
+// TEXT FOLDING
+// ============================================================================
+
+// Lowercase, strip accents and collapse everything that is not a letter,
+// digit or e-mail punctuation into single spaces. Returns folded length.
+int search_fold_text(const char* text, char* out, int out_size) {
+    if (!out || out_size <= 0) return 0;
+    out[0] = '\0';
+    if (!text) return 0;
+
+    const unsigned char* p = (const unsigned char*)text;
+    int len = 0;
+
+    while (*p && len < out_size - 1) {
+        char single[2] = {0, 0};
+        const char* repl = single;
+        unsigned char c = *p;
+
+        if (c < 0x80) {
+            p++;
+            if (isalnum(c)) single[0] = (char)tolower(c);
+            else if (c == '@' || c == '.' || c == '-' || c == '_') single[0] = (char)c;
+            else single[0] = ' ';
+        } else if (c == 0xC3 && (p[1] & 0xC0) == 0x80) {
+            repl = latin1_fold[p[1] - 0x80];
+            p += 2;
+        } else if (c == 0xC5 && (p[1] == 0x92 || p[1] == 0x93)) {
+            repl = "oe";
+            p += 2;
+        } else {
+            // Any other multi-byte character acts as a separator
+            p++;
+            while ((*p & 0xC0) == 0x80) p++;
+            single[0] = ' ';
+        }
+
+        for (int i = 0; repl[i] && len < out_size - 1; i++) {
+            if (repl[i] == ' ') {
+                if (len > 0 && out[len - 1] != ' ') out[len++] = ' ';
+            } else {
+                out[len++] = repl[i];
+            }
+        }
+    }
+
+    while (len > 0 && out[len - 1] == ' ') len--;
+    out[len] = '\0';
+    return len;
+}
+
+static int search_char_code(unsigned char c) {
+    if (c >= 'a' && c <= 'z') return 2 + (c - 'a');
+    if (c >= '0' && c <= '9') return 28 + (c - '0');
+    switch (c) {
+        case '@': return 38;
+        case '.': return 39;
+        case '-': return 40;
+        case '_': return 41;
+        default:  return 1;
+    }
+}
+
+static int search_trigram(const char* s) {
+    return search_char_code((unsigned char)s[0]) * SEARCH_ALPHABET * SEARCH_ALPHABET +
+           search_char_code((unsigned char)s[1]) * SEARCH_ALPHABET +
+           search_char_code((unsigned char)s[2]);
+}
+
+// Folded document text, padded with spaces so word starts form trigrams
+static int search_student_text(const Student* student, char* out, int out_size) {
+    char raw[SEARCH_MAX_TEXT];
+    snprintf(raw, sizeof(raw), "%s %s %s %s %d",
+             student->first_name, student->last_name, student->email,
+             intern_lookup(student->course), student->id);
+
+    out[0] = ' ';
+    int len = 1 + search_fold_text(raw, out + 1, out_size - 2);
+    out[len++] = ' ';
+    out[len] = '\0';
+    return len;
+}
+
+static int search_text_has_trigram(const char* text, const char* trigram) {
+    char needle[4] = {trigram[0], trigram[1], trigram[2], '\0'};
+    return strstr(text, needle) != NULL;
+}
+
+// ============================================================================
+// POSTING LISTS
+// ============================================================================
+
+static int search_posting_reserve(SearchPosting* posting, int needed) {
+    if (needed <= posting->capacity) return 1;
+
+    int new_capacity = posting->capacity > 0 ? posting->capacity * 2 : 4;
+    while (new_capacity < needed) new_capacity *= 2;
+
+    int* slots = (int*)realloc(posting->slots, new_capacity * sizeof(int));
+    if (!slots) {
+        printf("[ERROR] Failed to grow search posting list\n");
+        return 0;
+    }
+    posting->slots = slots;
+    posting->capacity = new_capacity;
+    return 1;
+}
+
+// Binary search; returns the position, or -1 - insertion point
+static int search_posting_find(const SearchPosting* posting, int slot) {
+    int lo = 0, hi = posting->count - 1;
+    while (lo <= hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (posting->slots[mid] == slot) return mid;
+        if (posting->slots[mid] < slot) lo = mid + 1;
+        else hi = mid - 1;
+    }
+    return -1 - lo;
+}
+
+// Slots are handed out in increasing order, so appends keep the list sorted
+static int search_posting_append(SearchPosting* posting, int slot) {
+    if (posting->count > 0 && posting->slots[posting->count - 1] == slot) return 1;
+    if (!search_posting_reserve(posting, posting->count + 1)) return 0;
+    posting->slots[posting->count++] = slot;
+    return 1;
+}
+
+static int search_posting_insert(SearchPosting* posting, int slot) {
+    int pos = search_posting_find(posting, slot);
+    if (pos >= 0) return 1;
+    pos = -1 - pos;
+
+    if (!search_posting_reserve(posting, posting->count + 1)) return 0;
+    memmove(&posting->slots[pos + 1], &posting->slots[pos], (posting->count - pos) * sizeof(int));
+    posting->slots[pos] = slot;
+    posting->count++;
+    return 1;
+}
+
+static void search_posting_remove(SearchPosting* posting, int slot) {
+    int pos = search_posting_find(posting, slot);
+    if (pos < 0) return;
+    memmove(&posting->slots[pos], &posting->slots[pos + 1], (posting->count - pos - 1) * sizeof(int));
+    posting->count--;
+}
+
+static void search_index_post_text(SearchIndex* index, const char* text, int slot) {
+    for (int i = 0; text[i] && text[i + 1] && text[i + 2]; i++) {
+        search_posting_append(&index->postings[search_trigram(text + i)], slot);
+    }
+}
+
+// ============================================================================
+// LIVE DOCUMENT RANKS (Fenwick tree)
+// ============================================================================
+
+static void search_live_add(SearchIndex* index, int slot, int delta) {
+    for (int i = slot + 1; i <= index->doc_capacity; i += i & -i) {
+        index->live_tree[i] += delta;
+    }
+}
+
+// Number of listed documents in slots [0, slot]
+static int search_live_rank(const SearchIndex* index, int slot) {
+    int sum = 0;
+    for (int i = slot + 1; i > 0; i -= i & -i) {
+        sum += index->live_tree[i];
+    }
+    return sum;
+}
+
+static void search_live_rebuild(SearchIndex* index) {
+    memset(index->live_tree, 0, (index->doc_capacity + 1) * sizeof(int));
+    for (int i = 1; i <= index->doc_capacity; i++) {
+        if (i <= index->doc_count && index->docs[i - 1].is_listed) {
+            index->live_tree[i] += 1;
+        }
+        int parent = i + (i & -i);
+        if (parent <= index->doc_capacity) {
+            index->live_tree[parent] += index->live_tree[i];
+        }
+    }
+}
+
+// ============================================================================
+// ID MAP
+// ============================================================================
+
+static int search_id_hash(int id, int capacity) {
+    return (int)(((unsigned int)id * 2654435761u) & (unsigned int)(capacity - 1));
+}
+
+static int search_id_lookup(const SearchIndex* index, int id) {
+    if (index->id_capacity == 0) return -1;
+    for (int i = search_id_hash(id, index->id_capacity);
+         index->id_slots[i] != -1;
+         i = (i + 1) & (index->id_capacity - 1)) {
+        SearchDoc* doc = &index->docs[index->id_slots[i]];
+        if (doc->is_live && doc->id == id) return index->id_slots[i];
+    }
+    return -1;
+}
+
+static void search_id_insert(SearchIndex* index, int id, int slot) {
+    int i = search_id_hash(id, index->id_capacity);
+    while (index->id_slots[i] != -1) {
+        i = (i + 1) & (index->id_capacity - 1);
+    }
+    index->id_slots[i] = slot;
+}
+
+// Rehash live documents into a table of at least the given capacity
+static int search_id_rebuild(SearchIndex* index, int min_capacity) {
+    int capacity = 64;
+    while (capacity < min_capacity) capacity *= 2;
+
+    int* slots = (int*)malloc(capacity * sizeof(int));
+    if (!slots) {
+        printf("[ERROR] Failed to allocate search id map\n");
+        return 0;
+    }
+    memset(slots, -1, capacity * sizeof(int));
+
+    free(index->id_slots);
+    index->id_slots = slots;
+    index->id_capacity = capacity;
+
+    for (int slot = 0; slot < index->doc_count; slot++) {
+        if (index->docs[slot].is_live) {
+            search_id_insert(index, index->docs[slot].id, slot);
+        }
+    }
+    return 1;
+}
+
+// ============================================================================
+// INDEX LIFECYCLE
+// ============================================================================
+
+SearchIndex* search_index_create(void) {
+    SearchIndex* index = (SearchIndex*)calloc(1, sizeof(SearchIndex));
+    if (!index) {
+        printf("[ERROR] Failed to create search index\n");
+        return NULL;
+    }
+
+    index->postings = (SearchPosting*)calloc(SEARCH_TRIGRAM_COUNT, sizeof(SearchPosting));
+    index->live_tree = (int*)calloc(1, sizeof(int));
+    if (!index->postings || !index->live_tree || !search_id_rebuild(index, 64)) {
+        printf("[ERROR] Failed to allocate search index tables\n");
+        search_index_destroy(index);
+        return NULL;
+    }
+    return index;
+}
+
+static void search_index_on_students_compacted(void* data, const int* remap, int old_count);
+
+void search_index_destroy(SearchIndex* index) {
+    if (!index) return;
+
+    if (index->students) {
+        tombstones_unwatch(&index->students->tombstones, search_index_on_students_compacted, index);
+    }
+
+    if (index->postings) {
+        for (int i = 0; i < SEARCH_TRIGRAM_COUNT; i++) {
+            free(index->postings[i].slots);
+        }
+        free(index->postings);
+    }
+    for (int i = 0; i < index->doc_count; i++) {
+        free(index->docs[i].text);
+    }
+    free(index->docs);
+    free(index->live_tree);
+    free(index->id_slots);
+    free(index);
+}
+
+static void search_index_clear(SearchIndex* index) {
+    for (int i = 0; i < SEARCH_TRIGRAM_COUNT; i++) {
+        index->postings[i].count = 0;
+    }
+    for (int i = 0; i < index->doc_count; i++) {
+        free(index->docs[i].text);
+    }
+    index->doc_count = 0;
+    index->live_count = 0;
+    search_live_rebuild(index);
+    search_id_rebuild(index, 64);
+}
+
+static int search_index_reserve_docs(SearchIndex* index, int needed) {
+    if (needed <= index->doc_capacity) return 1;
+
+    int new_capacity = index->doc_capacity > 0 ? index->doc_capacity * 2 : 256;
+    while (new_capacity < needed) new_capacity *= 2;
+
+    SearchDoc* docs = (SearchDoc*)realloc(index->docs, new_capacity * sizeof(SearchDoc));
+    if (!docs) {
+        printf("[ERROR] Failed to grow search documents\n");
+        return 0;
+    }
+    index->docs = docs;
+
+    int* tree = (int*)realloc(index->live_tree, (new_capacity + 1) * sizeof(int));
+    if (!tree) {
+        printf("[ERROR] Failed to grow search rank tree\n");
+        return 0;
+    }
+    index->live_tree = tree;
+    index->doc_capacity = new_capacity;
+    search_live_rebuild(index);
+    return 1;
+}
+
+static int search_index_add_doc(SearchIndex* index, int id, const char* text, int len) {
+    if (!search_index_reserve_docs(index, index->doc_count + 1)) return 0;
+    if ((index->doc_count + 1) * 2 > index->id_capacity &&
+        !search_id_rebuild(index, (index->doc_count + 1) * 4)) {
+        return 0;
+    }
+
+    char* copy = (char*)malloc(len + 1);
+    if (!copy) {
+        printf("[ERROR] Failed to store search text\n");
+        return 0;
+    }
+    memcpy(copy, text, len + 1);
+
+    int slot = index->doc_count++;
+    index->docs[slot].id = id;
+    index->docs[slot].text = copy;
+    index->docs[slot].is_live = 1;
+    index->docs[slot].is_listed = 1;
+    index->live_count++;
+    search_live_add(index, slot, 1);
+    search_id_insert(index, id, slot);
+    search_index_post_text(index, copy, slot);
+    return 1;
+}
+
+// Placeholder for a removed student that still holds its list slot
+static int search_index_add_removed_doc(SearchIndex* index) {
+    if (!search_index_reserve_docs(index, index->doc_count + 1)) return 0;
+
+    int slot = index->doc_count++;
+    index->docs[slot].id = -1;
+    index->docs[slot].text = NULL;
+    index->docs[slot].is_live = 0;
+    index->docs[slot].is_listed = 1;
+    search_live_add(index, slot, 1);
+    return 1;
+}
+
+// Documents that no longer stand for any list slot
+static int search_index_unlisted(const SearchIndex* index) {
+    if (index->doc_count == 0) return 0;
+    return index->doc_count - search_live_rank(index, index->doc_count - 1);
+}
+
+// Drop unlisted documents once they outnumber live ones
+static void search_index_compact(SearchIndex* index) {
+    for (int i = 0; i < SEARCH_TRIGRAM_COUNT; i++) {
+        index->postings[i].count = 0;
+    }
+
+    int kept = 0;
+    for (int slot = 0; slot < index->doc_count; slot++) {
+        if (index->docs[slot].is_listed) {
+            index->docs[kept++] = index->docs[slot];
+        }
+    }
+    index->doc_count = kept;
+
+    for (int slot = 0; slot < index->doc_count; slot++) {
+        if (index->docs[slot].is_live) {
+            search_index_post_text(index, index->docs[slot].text, slot);
+        }
+    }
+    search_live_rebuild(index);
+    search_id_rebuild(index, index->doc_count * 4);
+}
+
+static void search_index_compact_if_needed(SearchIndex* index) {
+    int unlisted = search_index_unlisted(index);
+    if (unlisted > SEARCH_COMPACT_MIN_DEAD && unlisted > index->live_count) {
+        search_index_compact(index);
+    }
+}
+
+// The student list squeezed out its removed records: the k-th listed
+// document is list slot k, so dropped slots stop being listed
+static void search_index_on_students_compacted(void* data, const int* remap, int old_count) {
+    SearchIndex* index = (SearchIndex*)data;
+    if (!remap) return;
+
+    int listed = 0;
+    for (int slot = 0; slot < index->doc_count && listed < old_count; slot++) {
+        SearchDoc* doc = &index->docs[slot];
+        if (!doc->is_listed) continue;
+
+        if (remap[listed++] < 0) {
+            if (doc->is_live) {
+                free(doc->text);
+                doc->text = NULL;
+                doc->is_live = 0;
+                index->live_count--;
+            }
+            doc->is_listed = 0;
+            search_live_add(index, slot, -1);
+        }
+    }
+    search_index_compact_if_needed(index);
+}
+
+int search_index_build(SearchIndex* index, StudentList* students) {
+    if (!index || !students) return 0;
+
+    search_index_clear(index);
+    if (!search_index_reserve_docs(index, students->count)) return 0;
+
+    if (index->students != students) {
+        if (index->students) {
+            tombstones_unwatch(&index->students->tombstones, search_index_on_students_compacted, index);
+        }
+        if (!tombstones_watch(&students->tombstones, search_index_on_students_compacted, index)) return 0;
+        index->students = students;
+    }
+
+    char text[SEARCH_MAX_TEXT];
+    for (int i = 0; i < students->count; i++) {
+        if (students->students[i].is_deleted) {
+            if (!search_index_add_removed_doc(index)) return 0;
+            continue;
+        }
+        int len = search_student_text(&students->students[i], text, sizeof(text));
+        if (!search_index_add_doc(index, students->students[i].id, text, len)) return 0;
+    }
+    return 1;
+}
+
+// ============================================================================
+// MUTATIONS
+// ============================================================================
+
+// The student was appended to the end of the list
+int search_index_add_student(SearchIndex* index, const Student* student) {
+    if (!index || !student) return 0;
+
+    char text[SEARCH_MAX_TEXT];
+    int len = search_student_text(student, text, sizeof(text));
+    return search_index_add_doc(index, student->id, text, len);
+}
+
+// Re-post only the trigrams that differ between the old and new text
+int search_index_update_student(SearchIndex* index, const Student* student) {
+    if (!index || !student) return 0;
+
+    int slot = search_id_lookup(index, student->id);
+    if (slot < 0) {
+        printf("[ERROR] Student %d is not in the search index\n", student->id);
+        return 0;
+    }
+
+    char text[SEARCH_MAX_TEXT];
+    int len = search_student_text(student, text, sizeof(text));
+    char* old_text = index->docs[slot].text;
+    if (strcmp(old_text, text) == 0) return 1;
+
+    char* copy = (char*)malloc(len + 1);
+    if (!copy) {
+        printf("[ERROR] Failed to store search text\n");
+        return 0;
+    }
+    memcpy(copy, text, len + 1);
+
+    for (int i = 0; old_text[i] && old_text[i + 1] && old_text[i + 2]; i++) {
+        if (!search_text_has_trigram(copy, old_text + i)) {
+            search_posting_remove(&index->postings[search_trigram(old_text + i)], slot);
+        }
+    }
+    for (int i = 0; copy[i] && copy[i + 1] && copy[i + 2]; i++) {
+        if (!search_text_has_trigram(old_text, copy + i)) {
+            search_posting_insert(&index->postings[search_trigram(copy + i)], slot);
+        }
+    }
+
+    free(old_text);
+    index->docs[slot].text = copy;
+    return 1;
+}
+
+// Dead slots stay in the posting lists until the next compaction. The
+// student is only tombstoned in the list, so its slot stays listed until
+// the list compacts too.
+int search_index_remove_student(SearchIndex* index, int student_id) {
+    if (!index) return 0;
+
+    int slot = search_id_lookup(index, student_id);
+    if (slot < 0) return 0;
+
+    index->docs[slot].is_live = 0;
+    free(index->docs[slot].text);
+    index->docs[slot].text = NULL;
+    index->live_count--;
+    return 1;
+}
+
+// ============================================================================
+// QUERIES
+// ============================================================================
+
+static int compare_search_hits(const void* a, const void* b) {
+    const SearchHit* ha = (const SearchHit*)a;
+    const SearchHit* hb = (const SearchHit*)b;
+    if (ha->score != hb->score) return ha->score - hb->score;
+    return ha->index - hb->index;
+}
+
+static int search_index_match(SearchIndex* index, int slot, const char* folded,
+                              const char* id_text, SearchHit* hit) {
+    SearchDoc* doc = &index->docs[slot];
+    if (!doc->is_live) return 0;
+
+    const char* pos = strstr(doc->text, folded);
+    if (!pos) return 0;
+
+    char doc_id[16];
+    snprintf(doc_id, sizeof(doc_id), "%d", doc->id);
+
+    hit->id = doc->id;
+    hit->index = search_live_rank(index, slot) - 1;
+    if (id_text && strcmp(id_text, doc_id) == 0) hit->score = SEARCH_SCORE_EXACT_ID;
+    else if (pos[-1] == ' ') hit->score = SEARCH_SCORE_WORD_START;
+    else hit->score = SEARCH_SCORE_SUBSTRING;
+    return 1;
+}
+
+static int search_hits_push(SearchHit** hits, int* count, int* capacity, SearchHit hit) {
+    if (*count >= *capacity) {
+        int new_capacity = *capacity > 0 ? *capacity * 2 : 64;
+        SearchHit* grown = (SearchHit*)realloc(*hits, new_capacity * sizeof(SearchHit));
+        if (!grown) return 0;
+        *hits = grown;
+        *capacity = new_capacity;
+    }
+    (*hits)[(*count)++] = hit;
+    return 1;
+}
+
+// Ranked matches for a query (exact id, then word start, then substring;
+// list order within a rank). Returns the number of hits written.
+int search_index_query(SearchIndex* index, const char* query, SearchHit* hits, int max_hits) {
+    if (!index || !query || !hits || max_hits <= 0) return 0;
+
+    char folded[SEARCH_MAX_QUERY];
+    int len = search_fold_text(query, folded, sizeof(folded));
+    if (len == 0) return 0;
+
+    // A query made only of digits may be an exact student id
+    const char* id_text = folded;
+    for (int i = 0; i < len; i++) {
+        if (!isdigit((unsigned char)folded[i])) {
+            id_text = NULL;
+            break;
+        }
+    }
+
+    SearchHit* all = NULL;
+    int count = 0, capacity = 0;
+    SearchHit hit;
+
+    // Slots are scanned in list order, so once max_hits word-start hits are
+    // in hand no later document can outrank them
+    int ranked = 0;
+    int exact_slot = -1;
+    if (id_text && len < 10) {
+        exact_slot = search_id_lookup(index, atoi(id_text));
+        if (exact_slot >= 0 && search_index_match(index, exact_slot, folded, id_text, &hit) &&
+            search_hits_push(&all, &count, &capacity, hit)) {
+            ranked++;
+        }
+    }
+
+    if (len < 3) {
+        // Too short for a trigram: scan the folded texts
+        for (int slot = 0; slot < index->doc_count && ranked < max_hits; slot++) {
+            if (slot == exact_slot || !search_index_match(index, slot, folded, id_text, &hit)) continue;
+            if (!search_hits_push(&all, &count, &capacity, hit)) break;
+            if (hit.score <= SEARCH_SCORE_WORD_START) ranked++;
+        }
+    } else {
+        // The rarest trigram drives the scan, the others filter
+        int rarest = search_trigram(folded);
+        for (int i = 1; i + 2 < len; i++) {
+            int trigram = search_trigram(folded + i);
+            if (index->postings[trigram].count < index->postings[rarest].count) {
+                rarest = trigram;
+            }
+        }
+
+        SearchPosting* driver = &index->postings[rarest];
+        for (int p = 0; p < driver->count && ranked < max_hits; p++) {
+            int slot = driver->slots[p];
+            if (slot == exact_slot) continue;
+
+            int candidate = 1;
+            for (int i = 0; candidate && i + 2 < len; i++) {
+                int trigram = search_trigram(folded + i);
+                if (trigram != rarest && search_posting_find(&index->postings[trigram], slot) < 0) {
+                    candidate = 0;
+                }
+            }
+            if (!candidate || !search_index_match(index, slot, folded, id_text, &hit)) continue;
+            if (!search_hits_push(&all, &count, &capacity, hit)) break;
+            if (hit.score <= SEARCH_SCORE_WORD_START) ranked++;
+        }
+    }
+
+    if (count > 1) {
+        qsort(all, count, sizeof(SearchHit), compare_search_hits);
+    }
+    if (count > max_hits) count = max_hits;
+    if (count > 0) memcpy(hits, all, count * sizeof(SearchHit));
+    free(all);
+    return count;
+}
@@ -1,4 +1,5 @@
 #include "stats.h"
+#include "trace.h"
 
 // Type aliases to match header declarations
 typedef liste_note GradeList;
@@ -22,6 +23,7 @@ static float grade_level_to_numeric(int grade_level) {
 SystemStats* calculate_system_stats(StudentList* students, CourseList* courses, 
                                    GradeList* grades, AttendanceList* attendance, 
                                    ClubList* clubs, MembershipList* memberships) {
+    TRACE_SCOPE("calculate_system_stats");
     SystemStats* stats = (SystemStats*)malloc(sizeof(SystemStats));
     if (!stats) return NULL;
     
@@ -29,8 +31,9 @@ SystemStats* calculate_system_stats(StudentList* students, CourseList* courses,
     
     // Count students
     if (students) {
-        stats->total_students = students->count;
+        stats->total_students = student_list_get_count(students);
         for (int i = 0; i < students->count; i++) {
+            if (students->students[i].is_deleted) continue;
             if (students->students[i].is_active) {
                 stats->active_students++;
             } else {
@@ -46,12 +49,12 @@ SystemStats* calculate_system_stats(StudentList* students, CourseList* courses,
     
     // Count grades
     if (grades) {
-        stats->total_grades = grades->count;
+        stats->total_grades = grades->count - grades->tombstones.dead;
     }
     
     // Count attendance records
     if (attendance) {
-        stats->total_attendance_records = attendance->count;
+        stats->total_attendance_records = attendance->count - attendance->tombstones.dead;
     }
     
     // Count clubs
@@ -61,7 +64,7 @@ SystemStats* calculate_system_stats(StudentList* students, CourseList* courses,
     
     // Count memberships
     if (memberships) {
-        stats->total_memberships = memberships->count;
+        stats->total_memberships = memberships->count - memberships->tombstones.dead;
     }
     
     stats->last_updated = time(NULL);
@@ -103,14 +106,15 @@ void free_system_stats(SystemStats* stats) {
 
 
 StudentStats* calculate_student_stats(StudentList* students, GradeList* grades) {
-    if (!students || students->count == 0) return NULL;
+    TRACE_SCOPE("calculate_student_stats");
+    if (!students || student_list_get_count(students) == 0) return NULL;
     
     StudentStats* stats = (StudentStats*)malloc(sizeof(StudentStats));
     if (!stats) return NULL;
     
     memset(stats, 0, sizeof(StudentStats));
     
-    stats->total_students = students->count;
+    stats->total_students = student_list_get_count(students);
     
     int total_age = 0;
     int student_count_with_age = 0;
@@ -120,6 +124,7 @@ StudentStats* calculate_student_stats(StudentList* students, GradeList* grades)
     // Calculate statistics for each student
     for (int i = 0; i < students->count; i++) {
         Student* s = &students->students[i];
+        if (s->is_deleted) continue;
         
         // Count by year
         if (s->year >= 1 && s->year <= 4) {
@@ -161,16 +166,44 @@ StudentStats* calculate_student_stats(StudentList* students, GradeList* grades)
         stats->average_gpa = total_gpa / student_count_with_gpa;
     }
     
+    // Group by course: histogram the interned course ids, then keep the
+    // largest buckets
+    int course_id_count = intern_count();
+    int* course_histogram = (int*)calloc(course_id_count + 1, sizeof(int));
+    if (course_histogram) {
+        for (int i = 0; i < students->count; i++) {
+            if (students->students[i].is_deleted) continue;
+            InternId course = students->students[i].course;
+            if (course < (InternId)course_id_count) course_histogram[course]++;
+        }
+        for (int slot = 0; slot < 20; slot++) {
+            int best = -1;
+            for (int id = 0; id < course_id_count; id++) {
+                if (course_histogram[id] > 0 && (best < 0 || course_histogram[id] > course_histogram[best])) {
+                    best = id;
+                }
+            }
+            if (best < 0) break;
+            stats->course_ids[slot] = (InternId)best;
+            stats->students_by_course[slot] = course_histogram[best];
+            course_histogram[best] = 0;
+        }
+        free(course_histogram);
+    }
+    
     // Find top and struggling performers
     if (student_count_with_gpa > 0) {
         // Create temporary array of students for sorting
         Student* sorted_students = (Student*)malloc(students->count * sizeof(Student));
         if (sorted_students) {
-            memcpy(sorted_students, students->students, students->count * sizeof(Student));
+            int live = 0;
+            for (int i = 0; i < students->count; i++) {
+                if (!students->students[i].is_deleted) sorted_students[live++] = students->students[i];
+            }
             
             // Sort by GPA (descending)
-            for (int i = 0; i < students->count - 1; i++) {
-                for (int j = 0; j < students->count - i - 1; j++) {
+            for (int i = 0; i < live - 1; i++) {
+                for (int j = 0; j < live - i - 1; j++) {
                     if (sorted_students[j].gpa < sorted_students[j + 1].gpa) {
                         Student temp = sorted_students[j];
                         sorted_students[j] = sorted_students[j + 1];
@@ -180,15 +213,15 @@ StudentStats* calculate_student_stats(StudentList* students, GradeList* grades)
             }
             
             // Copy top 10 performers
-            int top_count = (students->count < 10) ? students->count : 10;
+            int top_count = (live < 10) ? live : 10;
             for (int i = 0; i < top_count; i++) {
                 stats->top_performers[i] = sorted_students[i];
             }
             
             // Copy struggling students (bottom 10)
-            int bottom_start = (students->count > 10) ? students->count - 10 : 0;
+            int bottom_start = (live > 10) ? live - 10 : 0;
             int struggling_count = 0;
-            for (int i = students->count - 1; i >= bottom_start && struggling_count < 10; i--) {
+            for (int i = live - 1; i >= bottom_start && struggling_count < 10; i--) {
                 stats->struggling_students[struggling_count] = sorted_students[i];
                 struggling_count++;
             }
@@ -220,6 +253,12 @@ void display_student_stats(StudentStats* stats) {
     }
     printf("\n");
     
+    printf("Distribution by Course:\n");
+    for (int i = 0; i < 20 && stats->students_by_course[i] > 0; i++) {
+        printf("  %s: %d students\n", intern_lookup(stats->course_ids[i]), stats->students_by_course[i]);
+    }
+    printf("\n");
+    
     printf("Average Age: %.1f years\n\n", stats->average_age);
     
     printf("Age Distribution:\n");
@@ -277,14 +316,15 @@ void free_student_stats(StudentStats* stats) {
 
 
 GradeStats* calculate_grade_stats(GradeList* grades, CourseList* courses) {
-    if (!grades || grades->count == 0) return NULL;
+    TRACE_SCOPE("calculate_grade_stats");
+    if (!grades || grades->count - grades->tombstones.dead == 0) return NULL;
     
     GradeStats* stats = (GradeStats*)malloc(sizeof(GradeStats));
     if (!stats) return NULL;
     
     memset(stats, 0, sizeof(GradeStats));
     
-    stats->total_grades = grades->count;
+    stats->total_grades = grades->count - grades->tombstones.dead;
     stats->highest_gpa = 0.0f;
     stats->lowest_gpa = 4.0f;
     
@@ -292,6 +332,7 @@ GradeStats* calculate_grade_stats(GradeList* grades, CourseList* courses) {
     for (int i = 0; i < grades->count; i++) {
         Grade* g = &grades->note[i];
         
+        if (g->is_deleted) continue;
         if (g->present == 0) continue;  // Skip absent students
         
         // Convert 0-20 scale to grade level (A=16-20, B=14-15, C=12-13, D=10-11, F=0-9)
@@ -379,20 +420,22 @@ void free_grade_stats(GradeStats* stats) {
 
 
 AttendanceStats* calculate_attendance_stats(AttendanceList* attendance) {
-    if (!attendance || attendance->count == 0) return NULL;
+    TRACE_SCOPE("calculate_attendance_stats");
+    if (!attendance || attendance->count - attendance->tombstones.dead == 0) return NULL;
     
     AttendanceStats* stats = (AttendanceStats*)malloc(sizeof(AttendanceStats));
     if (!stats) return NULL;
     
     memset(stats, 0, sizeof(AttendanceStats));
     
-    stats->total_records = attendance->count;
+    stats->total_records = attendance->count - attendance->tombstones.dead;
     
     int month_counts[12] = {0};
     
     // Analyze each attendance record
     for (int i = 0; i < attendance->count; i++) {
         AttendanceRecord* a = &attendance->records[i];
+        if (a->is_deleted) continue;
         
         // Count by status
         switch (a->status) {
@@ -480,6 +523,7 @@ void free_attendance_stats(AttendanceStats* stats) {
 
 
 ClubStats* calculate_club_stats(ClubList* clubs, MembershipList* memberships) {
+    TRACE_SCOPE("calculate_club_stats");
     if (!clubs || clubs->count == 0) return NULL;
     
     ClubStats* stats = (ClubStats*)malloc(sizeof(ClubStats));
@@ -493,6 +537,9 @@ ClubStats* calculate_club_stats(ClubList* clubs, MembershipList* memberships) {
     int min_members = -1;
     int first_active_club_found = 0;
     
+    // Build per-club roster bitsets once instead of scanning memberships per club
+    ClubRosterIndex* rosters = club_roster_index_build(clubs, memberships);
+    
     // Analyze each club
     for (int i = 0; i < clubs->count; i++) {
         Club* c = &clubs->clubs[i];
@@ -501,16 +548,8 @@ ClubStats* calculate_club_stats(ClubList* clubs, MembershipList* memberships) {
             stats->active_clubs++;
         }
         
-        // Count memberships for this club
-        int club_members = 0;
-        if (memberships) {
-            for (int j = 0; j < memberships->count; j++) {
-                if (memberships->memberships[j].club_id == c->id &&
-                    memberships->memberships[j].is_active) {
-                    club_members++;
-                }
-            }
-        }
+        // Count members of this club
+        int club_members = rosters ? club_bitset_count(club_roster_index_get(rosters, c->id)) : 0;
         
         // Track most/least popular clubs
         if (club_members > max_members) {
@@ -529,6 +568,7 @@ ClubStats* calculate_club_stats(ClubList* clubs, MembershipList* memberships) {
     // Count total memberships
     if (memberships) {
         for (int i = 0; i < memberships->count; i++) {
+            if (memberships->memberships[i].is_deleted) continue;
             stats->total_memberships++;
             if (memberships->memberships[i].is_active) {
                 stats->active_memberships++;
@@ -536,6 +576,13 @@ ClubStats* calculate_club_stats(ClubList* clubs, MembershipList* memberships) {
         }
     }
     
+    // Students spread across clubs
+    if (rosters) {
+        stats->students_in_any_club = club_roster_count_in_at_least(rosters, 1);
+        stats->students_in_multiple_clubs = club_roster_count_in_at_least(rosters, 2);
+        club_roster_index_destroy(rosters);
+    }
+    
     // Calculate average members per club
     if (stats->active_clubs > 0) {
         stats->average_members_per_club = 
@@ -563,6 +610,9 @@ void display_club_stats(ClubStats* stats) {
     
     printf("Average Members per Club: %.1f\n\n", stats->average_members_per_club);
     
+    printf("Students in at least one club: %d\n", stats->students_in_any_club);
+    printf("Students in multiple clubs: %d\n\n", stats->students_in_multiple_clubs);
+    
     printf("Most Popular Club ID: %d\n", stats->most_popular_club_id);
     printf("Least Popular Club ID: %d\n", stats->least_popular_club_id);
     
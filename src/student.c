@@ -1,6 +1,5 @@
 #include "student.h"
 #include "config.h"
-#include "ui.h"
 #include "file_manager.h"
 // #include "report.h"  // Commented out - file doesn't exist
 #include "stats.h"
@@ -8,32 +7,125 @@
 #include "attendance.h"
 #include "grade.h"
 #include "club.h"
+#include "changelog.h"
 #include "utils.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <stddef.h>
 #include <string.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <sys/stat.h>
 
+// ============================================================================
+// STRING ARENA
+// ============================================================================
+
+// Arena bytes taken by a student's strings
+static size_t student_string_bytes(const Student* s) {
+    return strlen(s->first_name) + strlen(s->last_name) + strlen(s->email) +
+           strlen(s->phone) + strlen(s->address) + 5;
+}
+
+// Copy a student's strings into the arena, leaving the student untouched on failure
+static int student_arena_store_student(Arena* strings, Student* s) {
+    const char* first_name = arena_strndup(strings, s->first_name, MAX_NAME_LENGTH);
+    const char* last_name = arena_strndup(strings, s->last_name, MAX_NAME_LENGTH);
+    const char* email = arena_strndup(strings, s->email, MAX_EMAIL_LENGTH);
+    const char* phone = arena_strndup(strings, s->phone, MAX_PHONE_LENGTH);
+    const char* address = arena_strndup(strings, s->address, MAX_ADDRESS_LENGTH);
+    if (!first_name || !last_name || !email || !phone || !address) {
+        return 0;
+    }
+
+    s->first_name = first_name;
+    s->last_name = last_name;
+    s->email = email;
+    s->phone = phone;
+    s->address = address;
+    return 1;
+}
+
+// Once most of the arena is garbage, move the live strings into a fresh
+// arena. Records keep their slots; only their string pointers change.
+static void student_list_compact_strings(StudentList* list) {
+    if (list->strings_wasted < STUDENT_STRING_BLOCK_SIZE ||
+        list->strings_wasted * 2 < list->strings->bytes_used) {
+        return;
+    }
+
+    // Size the first block of the new arena up front, and take it before
+    // moving anything, so the move cannot fail half way
+    size_t needed = 1;
+    for (int i = 0; i < list->count; i++) {
+        if (list->students[i].is_deleted) continue;
+        needed += student_string_bytes(&list->students[i]);
+    }
+
+    Arena* fresh = arena_create("student strings", needed);
+    if (fresh == NULL || arena_strndup(fresh, "", 0) == NULL) {
+        printf("[WARNING] Skipping student string compaction, out of memory\n");
+        arena_destroy(fresh);
+        return;
+    }
+
+    for (int i = 0; i < list->count; i++) {
+        if (list->students[i].is_deleted) continue;
+        student_arena_store_student(fresh, &list->students[i]);
+    }
+    fresh->block_size = STUDENT_STRING_BLOCK_SIZE;
+
+    arena_destroy(list->strings);
+    list->strings = fresh;
+    list->strings_wasted = 0;
+}
+
+// Make room for at least needed records with a single realloc
+static int student_list_reserve(StudentList* list, int needed) {
+    if (needed <= list->capacity) return 1;
+
+    int new_capacity = list->capacity > 0 ? list->capacity : STUDENT_LIST_INITIAL_CAPACITY;
+    while (new_capacity < needed) new_capacity *= 2;
+
+    Student* new_students = (Student*)realloc(list->students, new_capacity * sizeof(Student));
+    if (new_students == NULL) {
+        printf("Error: Unable to allocate more memory for students\n");
+        return 0;
+    }
+    list->students = new_students;
+    list->capacity = new_capacity;
+    return 1;
+}
+
+// ============================================================================
+// STUDENT LIST
+// ============================================================================
+
 StudentList* student_list_create(void) {
-    StudentList* list = (StudentList*)malloc(sizeof(StudentList));
+    StudentList* list = (StudentList*)calloc(1, sizeof(StudentList));
     if (list == NULL) {
         printf("Error: Failed to create student list\n");
         return NULL;
     }
     
-    // Allocate memory for the students array
-    list->students = (Student*)malloc(MAX_STUDENTS * sizeof(Student));
+    // Start small; student_list_add doubles the array as needed
+    list->students = (Student*)malloc(STUDENT_LIST_INITIAL_CAPACITY * sizeof(Student));
     if (list->students == NULL) {
         printf("Error: Failed to allocate memory for students array\n");
         free(list);
         return NULL;
     }
     
+    list->strings = arena_create("student strings", STUDENT_STRING_BLOCK_SIZE);
+    if (list->strings == NULL) {
+        free(list->students);
+        free(list);
+        return NULL;
+    }
+    
     // Initialize all fields
     list->count = 0;
-    list->capacity = MAX_STUDENTS;
+    list->capacity = STUDENT_LIST_INITIAL_CAPACITY;
     list->is_loaded = 0;
     // Set the first character of the filename to the null terminator,
     // making the filename an empty string to indicate no file is set yet.
@@ -53,6 +145,9 @@ void student_list_destroy(StudentList* list) {
     if (list->students != NULL) {
         free(list->students);
     }
+    arena_destroy(list->strings);
+    tombstones_free(&list->tombstones);
+    table_lock_destroy(list->lock);
     
     // Free the list structure itself
     free(list);
@@ -61,41 +156,125 @@ int student_list_add(StudentList* list, Student student){
     if (list == NULL || list->students == NULL) {
         printf("ERROR DE LISTE OR STUDENT  ");
         return 0;
-    }else{
-        if (list->count >= list->capacity) {
-            printf("Error: Student list is full, cannot add new student.\n");
-            return 0;
-        }
-        list->students[list->count] = student;
-        list->count++;
-        return 1;
     }
 
-    
+    table_lock_write(list->lock);
+    int ok = student_list_add_locked(list, student);
+    table_unlock_write(list->lock);
+    return ok;
+}
+
+// As student_list_add, for a caller that holds the write lock over a batch
+int student_list_add_locked(StudentList* list, Student student) {
+    if (!student_list_reserve(list, list->count + 1)) return 0;
+
+    // The caller's strings are only borrowed; keep our own copies
+    if (!student_arena_store_student(list->strings, &student)) return 0;
+    student.is_deleted = 0;
+    list->students[list->count] = student;
+    list->count++;
+    list->dirty = 1;
+    changelog_record(list->lock, CHANGE_STUDENTS, CHANGE_INSERT, &list->students[list->count - 1]);
+    return 1;
+}
 
+// Overwrite a listed student with new values. Changed strings are appended
+// to the arena, so values may point at the student's current strings.
+int student_list_update(StudentList* list, Student* student, const Student* values) {
+    if (list == NULL || student == NULL || values == NULL) {
+        printf("Error: Invalid arguments to student_list_update\n");
+        return 0;
+    }
 
+    table_lock_write(list->lock);
+    int ok = student_list_update_locked(list, student, values);
+    table_unlock_write(list->lock);
+    return ok;
 }
+
+// As student_list_update, for a caller that holds the write lock
+int student_list_update_locked(StudentList* list, Student* student, const Student* values) {
+    Student updated = *values;
+    if (!student_arena_store_student(list->strings, &updated)) return 0;
+
+    list->strings_wasted += student_string_bytes(student);
+    *student = updated;
+    list->dirty = 1;
+    student_list_compact_strings(list);
+    changelog_record(list->lock, CHANGE_STUDENTS, CHANGE_UPDATE, student);
+    return 1;
+}
+
 int student_list_remove(StudentList* list, int student_id) {
     if (list == NULL || list->students == NULL) {
         printf("Error: Invalid student list\n");
         return 0;
     }
 
-    for (int i = 0; i < list->count; i++) {
-        if (list->students[i].id == student_id) {
-            for (int j = i; j < list->count - 1; j++) {
-                list->students[j] = list->students[j + 1];
-            }
-
-            memset(&list->students[list->count - 1], 0, sizeof(Student));
-            list->count--;
-            return 1;
-        }
+    // Only flag the record; the slots after it stay where they are until
+    // the list is compacted
+    Student* student = student_list_find_by_id(list, student_id);
+    if (student != NULL) {
+        table_lock_write(list->lock);
+        list->strings_wasted += student_string_bytes(student);
+        student->first_name = student->last_name = student->email = "";
+        student->phone = student->address = "";
+        tombstones_mark(&list->tombstones, &student->is_deleted, list->count);
+        list->dirty = 1;
+        student_list_compact_strings(list);
+        changelog_record(list->lock, CHANGE_STUDENTS, CHANGE_DELETE, student);
+        table_unlock_write(list->lock);
+        return 1;
     }
 
     printf("Error: Student with ID %d not found\n", student_id);
     return 0;
 }
+
+// Squeeze out removed students, keeping the order of the others.
+// Returns the number of records dropped.
+int student_list_compact(StudentList* list) {
+    if (list == NULL || list->students == NULL) return 0;
+
+    table_lock_write(list->lock);
+    int old_count = list->count;
+    list->count = tombstones_compact(&list->tombstones, list->students, sizeof(Student),
+                                     offsetof(Student, is_deleted), list->count);
+    table_unlock_write(list->lock);
+    return old_count - list->count;
+}
+
+int student_list_compact_if_needed(StudentList* list) {
+    if (list == NULL || !tombstones_should_compact(&list->tombstones, list->count)) return 0;
+    return student_list_compact(list);
+}
+
+// Copy of the live students, safe to take from any thread. The strings are
+// copied too: the original arena may be compacted while the copy is in use.
+StudentList* student_list_snapshot(const StudentList* list) {
+    if (list == NULL) return NULL;
+
+    StudentList* copy = student_list_create();
+    if (copy == NULL) return NULL;
+
+    table_lock_read(list->lock);
+    int ok = list->students != NULL &&
+             student_list_reserve(copy, list->count - list->tombstones.dead);
+    for (int i = 0; ok && i < list->count; i++) {
+        if (list->students[i].is_deleted) continue;
+        ok = student_list_add(copy, list->students[i]);
+    }
+    copy->is_loaded = list->is_loaded;
+    copy->auto_save_enabled = list->auto_save_enabled;
+    strcpy(copy->filename, list->filename);
+    table_unlock_read(list->lock);
+
+    if (!ok) {
+        student_list_destroy(copy);
+        return NULL;
+    }
+    return copy;
+}
 Student* student_list_find_by_id(StudentList* list, int student_id) {
     if (list == NULL || list->students == NULL) {
         printf("Error: Invalid student list\n");
@@ -103,7 +282,7 @@ Student* student_list_find_by_id(StudentList* list, int student_id) {
     }
     
     for (int i = 0; i < list->count; i++) {
-        if (list->students[i].id == student_id) {
+        if (list->students[i].id == student_id && !list->students[i].is_deleted) {
             return &list->students[i];
         }
     }
@@ -122,6 +301,7 @@ Student* student_list_find_by_name(StudentList* list, const char* first_name, co
     }
 
     for (int i = 0; i < list->count; i++) {
+        if (list->students[i].is_deleted) continue;
         if (strcmp(list->students[i].first_name, first_name) == 0 && 
             strcmp(list->students[i].last_name, last_name) == 0) {
             return &list->students[i];
@@ -147,6 +327,7 @@ Student* student_list_find_by_email(StudentList* list, const char* email) {
     }
 
     for (int i = 0; i < list->count; i++) {
+        if (list->students[i].is_deleted) continue;
         if (strcmp(list->students[i].email, email) == 0) {
             return &list->students[i];
         }
@@ -159,12 +340,14 @@ void student_list_display_all(StudentList* list){
        printf("Error: Invalid student list\n");
        return;
     }
-    if(list->count==0){
+    if(student_list_get_count(list)==0){
        printf("LIST IS EMPTY \n");
        return;
     }
+    int shown = 0;
     for(int i = 0; i < list->count; i++) {
-       printf("\nStudent %d:\n", i + 1);
+       if (list->students[i].is_deleted) continue;
+       printf("\nStudent %d:\n", ++shown);
        printf("ID: %d\n", list->students[i].id);
        printf("First Name: %s\n", list->students[i].first_name);
        printf("Last Name: %s\n", list->students[i].last_name);
@@ -198,6 +381,9 @@ int student_list_save_to_file(StudentList* list, const char* filename) {
         return 0;
     }
     
+    // Removed students are never written; squeeze them out if enough piled up
+    student_list_compact_if_needed(list);
+    
     char full_path[UTILS_MAX_PATH_LENGTH];
     if (!utils_get_data_file_path(filename, full_path, sizeof(full_path))) {
         printf("[ERROR] Failed to construct path for: %s\n", filename);
@@ -212,6 +398,7 @@ int student_list_save_to_file(StudentList* list, const char* filename) {
     
     for (int i = 0; i < list->count; i++) {
         Student* s = &list->students[i];
+        if (s->is_deleted) continue;
         fprintf(file, "%d,%s,%s,%s,%s,%s,%d,%s,%d,%.2f,%lld,%d\n",
             s->id,
             s->first_name,
@@ -220,7 +407,7 @@ int student_list_save_to_file(StudentList* list, const char* filename) {
             s->phone,
             s->address,
             s->age,
-            s->course,
+            intern_lookup(s->course),
             s->year,
             s->gpa,
             (long long)s->enrollment_date,
@@ -229,7 +416,7 @@ int student_list_save_to_file(StudentList* list, const char* filename) {
     }
     
     fclose(file);
-    printf("[OK] Saved %d students to %s\n", list->count, full_path);
+    printf("[OK] Saved %d students to %s\n", student_list_get_count(list), full_path);
     return 1;
 }
 int student_list_load_from_file(StudentList* list, const char* filename){
@@ -254,20 +441,41 @@ int student_list_load_from_file(StudentList* list, const char* filename){
         return 0;
     }
 
+    // Reloading replaces the current contents; the strings arena keeps its
+    // largest block, and the records array is sized from the line count
+    // once instead of doubling through the load
+    table_lock_write(list->lock);
+    list->count = 0;
+    list->strings_wasted = 0;
+    list->tombstones.dead = 0;
+    if (list->strings != NULL) {
+        arena_reset(list->strings);
+    } else {
+        list->strings = arena_create("student strings", STUDENT_STRING_BLOCK_SIZE);
+    }
+    long lines = utils_file_count_lines(file);
+    int reserved = list->strings != NULL && (lines <= 0 || student_list_reserve(list, (int)lines));
+    table_unlock_write(list->lock);
+    if (!reserved) {
+        fclose(file);
+        return 0;
+    }
+
     char line[512];
-    int index = 0;
+    char first_name[sizeof(line)], last_name[sizeof(line)], email[sizeof(line)];
+    char phone[sizeof(line)], address[sizeof(line)], course[sizeof(line)];
     while (fgets(line, sizeof(line), file)) {
-        Student s;
+        Student s = {0};
         long long enrollment_date_temp;
         int fields = sscanf(line, "%d,%[^,],%[^,],%[^,],%[^,],%[^,],%d,%[^,],%d,%f,%lld,%d",
             &s.id,
-            s.first_name,
-            s.last_name,
-            s.email,
-            s.phone,
-            s.address,
+            first_name,
+            last_name,
+            email,
+            phone,
+            address,
             &s.age,
-            s.course,
+            course,
             &s.year,
             &s.gpa,
             &enrollment_date_temp,
@@ -275,24 +483,20 @@ int student_list_load_from_file(StudentList* list, const char* filename){
         );
         if (fields == 12) {
             s.enrollment_date = (time_t)enrollment_date_temp;
-            if (index < list->capacity) {
-                list->students[index++] = s;
-            } else {
-                int new_capacity = list->capacity ? list->capacity * 2 : 16;
-                Student *new_students = realloc(list->students, sizeof(Student) * new_capacity);
-                if (!new_students) {
-                    printf("Error: Unable to allocate more memory for students\n");
-                    fclose(file);
-                    return 0;
-                }
-                list->students = new_students;
-                list->capacity = new_capacity;
-                list->students[index++] = s;
+            s.first_name = first_name;
+            s.last_name = last_name;
+            s.email = email;
+            s.phone = phone;
+            s.address = address;
+            s.course = intern_string(course);
+            if (!student_list_add(list, s)) {
+                fclose(file);
+                return 0;
             }
         }
     }
-    list->count = index;
     fclose(file);
+    list->dirty = 0;
     return 1;
 }
 void student_list_sort_by_name(StudentList* list) {
@@ -300,7 +504,10 @@ void student_list_sort_by_name(StudentList* list) {
         printf("Error: Invalid student list\n");
         return;
     }
+    // Sorting moves every record anyway, so drop removed ones first
+    student_list_compact(list);
     // Simple bubble sort by last_name, then first_name if last names equal
+    table_lock_write(list->lock);
     for (int i = 0; i < list->count - 1; i++) {
         for (int j = 0; j < list->count - 1 - i; j++) {
             int cmp = strcmp(list->students[j].last_name, list->students[j + 1].last_name);
@@ -311,11 +518,15 @@ void student_list_sort_by_name(StudentList* list) {
             }
         }
     }
+    table_unlock_write(list->lock);
 }
 
 // Sort students by ID in ascending order
 void student_list_sort_by_id(StudentList* list) {
-    if (list == NULL || list->students == NULL || list->count < 2) return;
+    if (list == NULL || list->students == NULL) return;
+    student_list_compact(list);
+    if (list->count < 2) return;
+    table_lock_write(list->lock);
     for (int i = 0; i < list->count - 1; i++) {
         for (int j = 0; j < list->count - i - 1; j++) {
             if (list->students[j].id > list->students[j + 1].id) {
@@ -325,11 +536,15 @@ void student_list_sort_by_id(StudentList* list) {
             }
         }
     }
+    table_unlock_write(list->lock);
 }
 
 // Sort students by GPA in descending order (highest first)
 void student_list_sort_by_gpa(StudentList* list) {
-    if (list == NULL || list->students == NULL || list->count < 2) return;
+    if (list == NULL || list->students == NULL) return;
+    student_list_compact(list);
+    if (list->count < 2) return;
+    table_lock_write(list->lock);
     for (int i = 0; i < list->count - 1; i++) {
         for (int j = 0; j < list->count - i - 1; j++) {
             if (list->students[j].gpa < list->students[j + 1].gpa) {
@@ -339,18 +554,20 @@ void student_list_sort_by_gpa(StudentList* list) {
             }
         }
     }
+    table_unlock_write(list->lock);
 }
 
+// Live students, not counting removed ones awaiting compaction
 int student_list_get_count(StudentList* list) {
     if (list == NULL) return 0;
-    return list->count;
+    return list->count - list->tombstones.dead;
 }
 Student* student_list_get_student(StudentList* list, int index){
     if(list == NULL || list->students == NULL){
         return NULL;
     }
     // Is true if index is in valid range
-    if(index >= 0 && index < list->count) {
+    if(index >= 0 && index < list->count && !list->students[index].is_deleted) {
         return &list->students[index];
     } else {
         return NULL;
@@ -375,17 +592,20 @@ int student_list_ensure_loaded(StudentList* list){
     }
     
     // Ensure students array is allocated
+    table_lock_write(list->lock);
     if (list->students == NULL) {
-        list->students = (Student*)malloc(MAX_STUDENTS * sizeof(Student));
+        list->students = (Student*)malloc(STUDENT_LIST_INITIAL_CAPACITY * sizeof(Student));
         if (list->students == NULL) {
+            table_unlock_write(list->lock);
             printf("Error: Failed to allocate memory for students array\n");
             return 0;
         }
-        list->capacity = MAX_STUDENTS;
+        list->capacity = STUDENT_LIST_INITIAL_CAPACITY;
     }
     
     // Reset count before loading to avoid appending to existing data
     list->count = 0;
+    table_unlock_write(list->lock);
     
     // Try to load data from file
     if (student_list_load_from_file(list, list->filename) == 0) {
@@ -427,10 +647,15 @@ int student_list_save_and_unload(StudentList* list){
     list->last_save_time = time(NULL);
     
     // Free the students array to unload from memory
+    table_lock_write(list->lock);
     if (list->students != NULL) {
         free(list->students);
         list->students = NULL;
     }
+    arena_destroy(list->strings);
+    list->strings = NULL;
+    list->strings_wasted = 0;
+    list->tombstones.dead = 0;
     
     // Reset count and capacity
     list->count = 0;
@@ -438,6 +663,7 @@ int student_list_save_and_unload(StudentList* list){
     
     // Mark as not loaded
     list->is_loaded = 0;
+    table_unlock_write(list->lock);
     
     return 1;
 }
@@ -488,42 +714,38 @@ void student_list_set_filename(StudentList* list, const char* filename){
     list->filename[sizeof(list->filename) - 1] = '\0'; // Ensure null termination
 }
 
-// Email Validation: Checks for emptiness, length, valid structure, and valid domain
-int student_validate_email(const char* email) {
+// Email check: emptiness, length, valid structure and a dotted domain.
+// The student_check_* functions print nothing (import workers use them) and
+// return NULL for a valid value, otherwise the reason as a static string.
+const char* student_check_email(const char* email) {
     if (!email || strlen(email) == 0 || strlen(email) > MAX_EMAIL_LENGTH) {
-        printf("Invalid email: Length is 0 or exceeds maximum.\n");
-        return 0;
+        return "email is empty or too long";
     }
-    char* at_pos = strchr(email, '@');
+    const char* at_pos = strchr(email, '@');
     if (!at_pos || strchr(at_pos + 1, '@')) {
-        printf("Invalid email format. Please use format: user@domain.com\n");
-        return 0;
+        return "email must contain exactly one @";
     }
     // Check that there's at least one character before @
     if (at_pos == email) {
-        printf("Invalid email format. Please use format: user@domain.com\n");
-        return 0;
+        return "email has nothing before the @";
     }
     // Check that domain has at least one dot
-    char* dot = strchr(at_pos + 1, '.');
+    const char* dot = strchr(at_pos + 1, '.');
     if (!dot || dot == at_pos + 1) {
-        printf("Invalid email format. Please use format: user@domain.com\n");
-        return 0;
+        return "email domain must look like domain.com";
     }
     // Check that there's at least one character after the last dot
-    char* last_dot = strrchr(at_pos + 1, '.');
+    const char* last_dot = strrchr(at_pos + 1, '.');
     if (last_dot && strlen(last_dot + 1) == 0) {
-        printf("Invalid email format. Please use format: user@domain.com\n");
-        return 0;
+        return "email domain must not end with a dot";
     }
-    return 1;
+    return NULL;
 }
 
-// Phone Validation: Checks if phone contains valid characters and is in valid length
-int student_validate_phone(const char* phone) {
+// Phone check: valid characters, length and enough digits
+const char* student_check_phone(const char* phone) {
     if (!phone || strlen(phone) == 0 || strlen(phone) > MAX_PHONE_LENGTH || strlen(phone) < 10) {
-        printf("Invalid phone: Empty, too short, or too long.\n");
-        return 0;
+        return "phone is empty, too short or too long";
     }
     int digit_count = 0;
     for (size_t i = 0; i < strlen(phone); i++) {
@@ -531,12 +753,49 @@ int student_validate_phone(const char* phone) {
         if (c >= '0' && c <= '9') {
             digit_count++;  // Count digits
         } else if (c != '+' && c != '-' && c != '(' && c != ')' && c != ' ' && c != '.') {
-            printf("Invalid phone format: Only digits, +, -, (, ), spaces, and dots are allowed.\n");
-            return 0;
+            return "phone may only hold digits, +, -, (, ), spaces and dots";
         }
     }
     if (digit_count < 7) {
-        printf("Invalid phone format: Phone must contain at least 7 digits.\n");
+        return "phone must contain at least 7 digits";
+    }
+    return NULL;
+}
+
+// Age check: between 18 and 100
+const char* student_check_age(int age) {
+    if (age < 18 || age > 100) {
+        return "age must be between 18 and 100";
+    }
+    return NULL;
+}
+
+// GPA check: between 0.0 and 4.0
+const char* student_check_gpa(float gpa) {
+    if (gpa < 0.0 || gpa > 4.0) {
+        return "GPA must be between 0.0 and 4.0";
+    }
+    return NULL;
+}
+
+// Email Validation: Checks for emptiness, length, valid structure, and valid domain
+int student_validate_email(const char* email) {
+    if (!email || strlen(email) == 0 || strlen(email) > MAX_EMAIL_LENGTH) {
+        printf("Invalid email: Length is 0 or exceeds maximum.\n");
+        return 0;
+    }
+    if (student_check_email(email)) {
+        printf("Invalid email format. Please use format: user@domain.com\n");
+        return 0;
+    }
+    return 1;
+}
+
+// Phone Validation: Checks if phone contains valid characters and is in valid length
+int student_validate_phone(const char* phone) {
+    const char* reason = student_check_phone(phone);
+    if (reason) {
+        printf("Invalid phone: %s.\n", reason);
         return 0;
     }
     return 1;
@@ -544,7 +803,7 @@ int student_validate_phone(const char* phone) {
 
 // Age Validation: Checks if age is between 18 and 100
 int student_validate_age(int age) {
-    if (age < 18 || age > 100) {
+    if (student_check_age(age)) {
         printf("Age must be between 18 and 100 years\n");
         return 0;
     }
@@ -553,36 +812,42 @@ int student_validate_age(int age) {
 
 // GPA Validation: Checks if GPA is between 0.0 and 4.0
 int student_validate_gpa(float gpa) {
-    if (gpa < 0.0 || gpa > 4.0) {
+    if (student_check_gpa(gpa)) {
         printf("GPA must be between 0.0 and 4.0\n");
         return 0;
     }
     return 1;
 }
 
+// The returned student borrows static buffers until the next call;
+// student_list_add or student_list_update copy them into the list
 Student student_input_new() {
-    Student s;
+    static char first_name[MAX_NAME_LENGTH], last_name[MAX_NAME_LENGTH];
+    static char email[MAX_EMAIL_LENGTH], phone[MAX_PHONE_LENGTH];
+    static char address[MAX_ADDRESS_LENGTH];
+    char course[MAX_COURSE_LENGTH];
+    Student s = {0};
     int n;
 
     printf("ID: ");
     scanf("%d", &s.id);
 
     printf("Nom: ");
-    scanf("%s", s.first_name);
+    scanf("%99s", first_name);
 
     printf("Prenom: ");
-    scanf("%s", s.last_name);
+    scanf("%99s", last_name);
 
     do {
         printf("Email: ");
-        scanf("%s", s.email);
-        n = student_validate_email(s.email);
+        scanf("%149s", email);
+        n = student_validate_email(email);
     } while (n == 0);
 
     do {
         printf("Telephone: ");
-        scanf("%s", s.phone);
-        n = student_validate_phone(s.phone);
+        scanf("%19s", phone);
+        n = student_validate_phone(phone);
     } while (n == 0);
 
     do {
@@ -592,10 +857,10 @@ Student student_input_new() {
     } while (n == 0);
 
     printf("Filiere: ");
-    scanf(" %[^\n]", s.course);
+    scanf(" %49[^\n]", course);
 
     printf("Adresse: ");
-    scanf(" %[^\n]", s.address);
+    scanf(" %199[^\n]", address);
 
     printf("Year: ");
     scanf("%d", &s.year);
@@ -606,13 +871,21 @@ Student student_input_new() {
         n = student_validate_gpa(s.gpa);
     } while (n == 0);
 
+    s.first_name = first_name;
+    s.last_name = last_name;
+    s.email = email;
+    s.phone = phone;
+    s.address = address;
+    s.course = intern_string(course);
     s.enrollment_date = time(0);
     s.is_active = 1;
 
     return s;
 }
 
-void student_input_edit(Student* student) {
+void student_input_edit(StudentList* list, Student* student) {
+    char text[MAX_ADDRESS_LENGTH];
+    Student values = *student;
     int choice;
     printf("\nEdit student info (for now: just select and re-enter value, no validation):\n");
     printf("1 - Prenom\n");
@@ -633,65 +906,72 @@ void student_input_edit(Student* student) {
     switch (choice) {
         case 1:
             printf("Nouveau prenom: ");
-            scanf("%s", student->last_name);
+            scanf("%199s", text);
+            values.last_name = text;
             break;
         case 2:
             printf("Nouveau nom: ");
-            scanf("%s", student->first_name);
+            scanf("%199s", text);
+            values.first_name = text;
             break;
         case 3:
             printf("Nouvel email: ");
-            scanf("%s", student->email);
+            scanf("%199s", text);
+            values.email = text;
             break;
         case 4:
             printf("Nouveau telephone: ");
-            scanf("%s", student->phone);
+            scanf("%199s", text);
+            values.phone = text;
             break;
         case 5:
             printf("Nouvel age: ");
-            scanf("%d", &student->age);
+            scanf("%d", &values.age);
             break;
         case 7:
             printf("Nouvelle filiere: ");
-            scanf(" %[^\n]", student->course);
+            scanf(" %199[^\n]", text);
+            values.course = intern_string(text);
             break;
         case 8:
             printf("Nouvelle enrollment_date (timestamp entier): ");
             {
                 long long temp;
                 scanf("%lld", &temp);
-                student->enrollment_date = (time_t)temp;
+                values.enrollment_date = (time_t)temp;
             }
             break;
         case 9:
             printf("is_active (0/1): ");
-            scanf("%d", &student->is_active);
+            scanf("%d", &values.is_active);
             break;
         case 10:
             printf("Nouvelle adresse: ");
-            scanf(" %[^\n]", student->address);
+            scanf(" %199[^\n]", text);
+            values.address = text;
             break;
         case 11:
             printf("Nouvelle annee: ");
-            scanf("%d", &student->year);
+            scanf("%d", &values.year);
             break;
         case 12:
             printf("Nouveau GPA (0.0-4.0): ");
-            scanf("%f", &student->gpa);
+            scanf("%f", &values.gpa);
             break;
         case 13:
             printf("Modifier tout:\n");
-            *student = student_input_new();
+            values = student_input_new();
             break;
         case 0:
         default:
             // Annuler ou choix invalide, ne rien faire
-            break;
+            return;
     }
+    student_list_update(list, student, &values);
 }
 
 void student_display_summary(StudentList* list) {
-    if (!list || list->count == 0) {
+    if (!list || student_list_get_count(list) == 0) {
         printf("Aucun étudiant à afficher.\n");
         return;
     }
@@ -699,9 +979,10 @@ void student_display_summary(StudentList* list) {
     printf("------------------------------------------------------------------------------------------------------------\n");
     for (int i = 0; i < list->count; i++) {
         Student s = list->students[i];
+        if (s.is_deleted) continue;
         printf("| %-3d | %-15s | %-15s | %-22s | %-12s | %-3d | %.2f | %-6d | %-14s |\n",
-               s.id, s.first_name, s.last_name, s.email, s.phone, s.age, s.gpa, s.is_active, s.course);
+               s.id, s.first_name, s.last_name, s.email, s.phone, s.age, s.gpa, s.is_active, intern_lookup(s.course));
     }
     printf("------------------------------------------------------------------------------------------------------------\n");
-    printf("Total: %d étudiant(s)\n", list->count);
+    printf("Total: %d étudiant(s)\n", student_list_get_count(list));
 }
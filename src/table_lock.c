@@ -0,0 +1,56 @@
+#include "table_lock.h"
+#include <glib.h>
+
+struct TableLock {
+    const char* name;
+    GRWLock rwlock;
+    GThread* writer;            // the thread that created the lock
+};
+
+// ============================================================================
+// LIFECYCLE
+// ============================================================================
+
+TableLock* table_lock_create(const char* name) {
+    TableLock* lock = (TableLock*)calloc(1, sizeof(TableLock));
+    if (lock == NULL) {
+        printf("[ERROR] Failed to create table lock\n");
+        return NULL;
+    }
+    lock->name = name ? name : "table";
+    g_rw_lock_init(&lock->rwlock);
+    lock->writer = g_thread_self();
+    return lock;
+}
+
+void table_lock_destroy(TableLock* lock) {
+    if (lock == NULL) return;
+    g_rw_lock_clear(&lock->rwlock);
+    free(lock);
+}
+
+// ============================================================================
+// LOCKING
+// ============================================================================
+
+void table_lock_read(TableLock* lock) {
+    if (lock != NULL) g_rw_lock_reader_lock(&lock->rwlock);
+}
+
+void table_unlock_read(TableLock* lock) {
+    if (lock != NULL) g_rw_lock_reader_unlock(&lock->rwlock);
+}
+
+// A write from another thread breaks rule 1; say so rather than deadlock
+// quietly or race with unlocked main-thread readers
+void table_lock_write(TableLock* lock) {
+    if (lock == NULL) return;
+    if (g_thread_self() != lock->writer) {
+        printf("[WARNING] Table '%s' written off the main thread\n", lock->name);
+    }
+    g_rw_lock_writer_lock(&lock->rwlock);
+}
+
+void table_unlock_write(TableLock* lock) {
+    if (lock != NULL) g_rw_lock_writer_unlock(&lock->rwlock);
+}
@@ -0,0 +1,801 @@
+#include "table_model.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <limits.h>
+
+// Placeholder for a row about to be deleted; reads as an empty row
+#define TABLE_MODEL_ROW_DROPPED INT_MAX
+
+static void table_model_tree_model_init(GtkTreeModelIface* iface);
+
+G_DEFINE_TYPE_WITH_CODE(TableModel, table_model, G_TYPE_OBJECT,
+                        G_IMPLEMENT_INTERFACE(GTK_TYPE_TREE_MODEL, table_model_tree_model_init))
+
+// ============================================================================
+// COLUMN LAYOUT
+// ============================================================================
+
+static const char* student_titles[] = {"ID", "First Name", "Last Name", "Email", "Filiere", "GPA"};
+static const char* grade_titles[] = {"Student ID", "Exam ID", "Module", "Grade", "Present"};
+static const char* attendance_titles[] = {"ID", "Student ID", "Course ID", "Date", "Status"};
+static const char* club_titles[] = {"ID", "Name", "Category", "Members", "Status"};
+static const char* module_titles[] = {"ID", "Module Name", "Description", "H.Cours", "H.TD", "H.TP", "Sem", "Professor"};
+
+int table_model_kind_n_columns(TableModelKind kind) {
+    switch (kind) {
+        case TABLE_MODEL_STUDENTS:   return 6;
+        case TABLE_MODEL_GRADES:     return 5;
+        case TABLE_MODEL_ATTENDANCE: return 5;
+        case TABLE_MODEL_CLUBS:      return 5;
+        case TABLE_MODEL_MODULES:    return 8;
+    }
+    return 0;
+}
+
+const char* table_model_kind_column_title(TableModelKind kind, int column) {
+    if (column < 0 || column >= table_model_kind_n_columns(kind)) return "";
+    switch (kind) {
+        case TABLE_MODEL_STUDENTS:   return student_titles[column];
+        case TABLE_MODEL_GRADES:     return grade_titles[column];
+        case TABLE_MODEL_ATTENDANCE: return attendance_titles[column];
+        case TABLE_MODEL_CLUBS:      return club_titles[column];
+        case TABLE_MODEL_MODULES:    return module_titles[column];
+    }
+    return "";
+}
+
+// Modules keep the integer columns the old list store had; everything else
+// is text so existing gtk_tree_model_get(..., 0, &id_str) callers still work
+static GType table_model_kind_column_type(TableModelKind kind, int column) {
+    if (kind == TABLE_MODEL_MODULES && column != 1 && column != 2 && column != 7) {
+        return G_TYPE_INT;
+    }
+    return G_TYPE_STRING;
+}
+
+// ============================================================================
+// ROW MAPPING
+// ============================================================================
+
+static int table_model_table_count(TableModel* model) {
+    if (!model->table) return 0;
+    switch (model->kind) {
+        case TABLE_MODEL_STUDENTS:   return ((StudentList*)model->table)->count;
+        case TABLE_MODEL_GRADES:     return ((liste_note*)model->table)->count;
+        case TABLE_MODEL_ATTENDANCE: return ((AttendanceList*)model->table)->count;
+        case TABLE_MODEL_CLUBS:      return ((ClubList*)model->table)->count;
+        case TABLE_MODEL_MODULES:    return ((ListeModules*)model->table)->count;
+    }
+    return 0;
+}
+
+// Deleted-record flags of the backing table; clubs still delete by shifting
+static Tombstones* table_model_tombstones(TableModel* model) {
+    if (!model->table) return NULL;
+    switch (model->kind) {
+        case TABLE_MODEL_STUDENTS:   return &((StudentList*)model->table)->tombstones;
+        case TABLE_MODEL_GRADES:     return &((liste_note*)model->table)->tombstones;
+        case TABLE_MODEL_ATTENDANCE: return &((AttendanceList*)model->table)->tombstones;
+        case TABLE_MODEL_MODULES:    return &((ListeModules*)model->table)->tombstones;
+        case TABLE_MODEL_CLUBS:      return NULL;
+    }
+    return NULL;
+}
+
+static int table_model_is_deleted(TableModel* model, int index) {
+    switch (model->kind) {
+        case TABLE_MODEL_STUDENTS:   return ((StudentList*)model->table)->students[index].is_deleted;
+        case TABLE_MODEL_GRADES:     return ((liste_note*)model->table)->note[index].is_deleted;
+        case TABLE_MODEL_ATTENDANCE: return ((AttendanceList*)model->table)->records[index].is_deleted;
+        case TABLE_MODEL_MODULES:    return ((ListeModules*)model->table)->cours[index].is_deleted;
+        case TABLE_MODEL_CLUBS:      return 0;
+    }
+    return 0;
+}
+
+// Raw row map entry for a view row (negative means group header)
+static int table_model_entry(TableModel* model, int row) {
+    return model->rows ? model->rows[row] : row;
+}
+
+static gboolean table_model_fill_iter(TableModel* model, int row, GtkTreeIter* iter) {
+    if (row < 0 || row >= model->n_rows) return FALSE;
+    iter->stamp = model->stamp;
+    iter->user_data = GINT_TO_POINTER(row);
+    iter->user_data2 = NULL;
+    iter->user_data3 = NULL;
+    return TRUE;
+}
+
+static int table_model_iter_row(TableModel* model, GtkTreeIter* iter) {
+    if (!iter || iter->stamp != model->stamp) return -1;
+    return GPOINTER_TO_INT(iter->user_data);
+}
+
+// Stable key of the record at a table index
+static int table_model_record_id(TableModel* model, int index) {
+    switch (model->kind) {
+        case TABLE_MODEL_STUDENTS:   return ((StudentList*)model->table)->students[index].id;
+        case TABLE_MODEL_GRADES:     return index;
+        case TABLE_MODEL_ATTENDANCE: return ((AttendanceList*)model->table)->records[index].id;
+        case TABLE_MODEL_CLUBS:      return ((ClubList*)model->table)->clubs[index].id;
+        case TABLE_MODEL_MODULES:    return ((ListeModules*)model->table)->cours[index].id;
+    }
+    return index;
+}
+
+static void table_model_index_row(TableModel* model, int row) {
+    int entry = table_model_entry(model, row);
+    if (entry < 0 || entry >= table_model_table_count(model)) return;
+    g_hash_table_insert(model->id_rows,
+                        GINT_TO_POINTER(table_model_record_id(model, entry)),
+                        GINT_TO_POINTER(row + 1));
+}
+
+// Rebuild the id map from the given view row onwards
+static void table_model_index_ids_from(TableModel* model, int first_row) {
+    if (first_row <= 0) g_hash_table_remove_all(model->id_rows);
+    for (int row = first_row > 0 ? first_row : 0; row < model->n_rows; row++) {
+        table_model_index_row(model, row);
+    }
+}
+
+static int table_model_find_row(TableModel* model, int record_id) {
+    gpointer row = g_hash_table_lookup(model->id_rows, GINT_TO_POINTER(record_id));
+    return row ? GPOINTER_TO_INT(row) - 1 : -1;
+}
+
+static void table_model_emit_inserted(TableModel* model, int row) {
+    GtkTreeIter iter;
+    table_model_fill_iter(model, row, &iter);
+    GtkTreePath* path = gtk_tree_path_new();
+    gtk_tree_path_append_index(path, row);
+    gtk_tree_model_row_inserted(GTK_TREE_MODEL(model), path, &iter);
+    gtk_tree_path_free(path);
+}
+
+static void table_model_emit_deleted(TableModel* model, int row) {
+    GtkTreePath* path = gtk_tree_path_new();
+    gtk_tree_path_append_index(path, row);
+    gtk_tree_model_row_deleted(GTK_TREE_MODEL(model), path);
+    gtk_tree_path_free(path);
+}
+
+// ============================================================================
+// CELL FORMATTING
+// ============================================================================
+
+static void table_model_set_text(GValue* value, const char* text) {
+    g_value_init(value, G_TYPE_STRING);
+    g_value_set_string(value, text);
+}
+
+static void table_model_set_int_text(GValue* value, int number) {
+    char buffer[16];
+    snprintf(buffer, sizeof(buffer), "%d", number);
+    table_model_set_text(value, buffer);
+}
+
+static void table_model_student_value(Student* s, int column, GValue* value) {
+    char buffer[32];
+    switch (column) {
+        case 0: table_model_set_int_text(value, s->id); break;
+        case 1: table_model_set_text(value, s->first_name); break;
+        case 2: table_model_set_text(value, s->last_name); break;
+        case 3: table_model_set_text(value, s->email); break;
+        case 4: table_model_set_text(value, intern_lookup(s->course)); break;
+        default:
+            snprintf(buffer, sizeof(buffer), "%.2f", s->gpa);
+            table_model_set_text(value, buffer);
+            break;
+    }
+}
+
+static void table_model_grade_value(Note* n, int column, GValue* value) {
+    char buffer[32];
+    switch (column) {
+        case 0: table_model_set_int_text(value, n->id_etudiant); break;
+        case 1: table_model_set_int_text(value, n->id_examen); break;
+        case 2: table_model_set_text(value, ""); break;  // Module name not in structure
+        case 3:
+            snprintf(buffer, sizeof(buffer), "%.2f", n->note_obtenue);
+            table_model_set_text(value, buffer);
+            break;
+        default: table_model_set_text(value, n->present ? "Yes" : "No"); break;
+    }
+}
+
+static const char* table_model_attendance_status(int status) {
+    switch (status) {
+        case 0: return "Absent";
+        case 1: return "Present";
+        case 2: return "Late";
+        case 3: return "Excused";
+        default: return "Unknown";
+    }
+}
+
+static void table_model_attendance_value(AttendanceRecord* r, int column, GValue* value) {
+    char buffer[64];
+    switch (column) {
+        case 0: table_model_set_int_text(value, r->id); break;
+        case 1: table_model_set_int_text(value, r->student_id); break;
+        case 2: table_model_set_int_text(value, r->course_id); break;
+        case 3: {
+            struct tm* timeinfo = localtime(&r->recorded_time);
+            if (timeinfo) {
+                strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M", timeinfo);
+            } else {
+                buffer[0] = '\0';
+            }
+            table_model_set_text(value, buffer);
+            break;
+        }
+        default: table_model_set_text(value, table_model_attendance_status(r->status)); break;
+    }
+}
+
+static void table_model_attendance_header_value(AttendanceRecord* r, int column, GValue* value) {
+    char header[128];
+    if (column == 1) {
+        snprintf(header, sizeof(header), "═══ COURSE ID: %d ═══", r->course_id);
+        table_model_set_text(value, header);
+    } else {
+        table_model_set_text(value, "");
+    }
+}
+
+static void table_model_club_value(Club* c, int column, GValue* value) {
+    switch (column) {
+        case 0: table_model_set_int_text(value, c->id); break;
+        case 1: table_model_set_text(value, c->name); break;
+        case 2: table_model_set_text(value, intern_lookup(c->category)); break;
+        case 3: table_model_set_int_text(value, c->member_count); break;
+        default: table_model_set_text(value, c->is_active ? "Active" : "Inactive"); break;
+    }
+}
+
+static void table_model_module_value(Module* m, int column, GValue* value) {
+    switch (column) {
+        case 1: table_model_set_text(value, m->nom); return;
+        case 2: table_model_set_text(value, m->description); return;
+        case 7: table_model_set_text(value, intern_lookup(m->nom_prenom_enseignent)); return;
+    }
+
+    g_value_init(value, G_TYPE_INT);
+    switch (column) {
+        case 0: g_value_set_int(value, m->id); break;
+        case 3: g_value_set_int(value, m->heures_cours); break;
+        case 4: g_value_set_int(value, m->heures_td); break;
+        case 5: g_value_set_int(value, m->heures_tp); break;
+        default: g_value_set_int(value, m->semestre); break;
+    }
+}
+
+// ============================================================================
+// GTK TREE MODEL INTERFACE
+// ============================================================================
+
+static GtkTreeModelFlags table_model_get_flags(GtkTreeModel* tree_model) {
+    return GTK_TREE_MODEL_LIST_ONLY;
+}
+
+static gint table_model_get_n_columns(GtkTreeModel* tree_model) {
+    return table_model_kind_n_columns(TABLE_MODEL(tree_model)->kind);
+}
+
+static GType table_model_get_column_type(GtkTreeModel* tree_model, gint index) {
+    return table_model_kind_column_type(TABLE_MODEL(tree_model)->kind, index);
+}
+
+static gboolean table_model_get_iter(GtkTreeModel* tree_model, GtkTreeIter* iter, GtkTreePath* path) {
+    if (gtk_tree_path_get_depth(path) != 1) return FALSE;
+    return table_model_fill_iter(TABLE_MODEL(tree_model), gtk_tree_path_get_indices(path)[0], iter);
+}
+
+static GtkTreePath* table_model_get_path(GtkTreeModel* tree_model, GtkTreeIter* iter) {
+    int row = table_model_iter_row(TABLE_MODEL(tree_model), iter);
+    if (row < 0) return NULL;
+
+    GtkTreePath* path = gtk_tree_path_new();
+    gtk_tree_path_append_index(path, row);
+    return path;
+}
+
+static void table_model_get_value(GtkTreeModel* tree_model, GtkTreeIter* iter, gint column, GValue* value) {
+    TableModel* model = TABLE_MODEL(tree_model);
+    int row = table_model_iter_row(model, iter);
+    int entry = row >= 0 ? table_model_entry(model, row) : 0;
+    int header = entry < 0;
+    int index = header ? -1 - entry : entry;
+
+    // Row vanished from under the view (table shrank before a sync)
+    if (row < 0 || index >= table_model_table_count(model)) {
+        if (table_model_kind_column_type(model->kind, column) == G_TYPE_INT) {
+            g_value_init(value, G_TYPE_INT);
+        } else {
+            table_model_set_text(value, "");
+        }
+        return;
+    }
+
+    switch (model->kind) {
+        case TABLE_MODEL_STUDENTS:
+            table_model_student_value(&((StudentList*)model->table)->students[index], column, value);
+            break;
+        case TABLE_MODEL_GRADES:
+            table_model_grade_value(&((liste_note*)model->table)->note[index], column, value);
+            break;
+        case TABLE_MODEL_ATTENDANCE: {
+            AttendanceRecord* record = &((AttendanceList*)model->table)->records[index];
+            if (header) {
+                table_model_attendance_header_value(record, column, value);
+            } else {
+                table_model_attendance_value(record, column, value);
+            }
+            break;
+        }
+        case TABLE_MODEL_CLUBS:
+            table_model_club_value(&((ClubList*)model->table)->clubs[index], column, value);
+            break;
+        case TABLE_MODEL_MODULES:
+            table_model_module_value(&((ListeModules*)model->table)->cours[index], column, value);
+            break;
+    }
+}
+
+static gboolean table_model_iter_next(GtkTreeModel* tree_model, GtkTreeIter* iter) {
+    TableModel* model = TABLE_MODEL(tree_model);
+    int row = table_model_iter_row(model, iter);
+    if (row < 0 || !table_model_fill_iter(model, row + 1, iter)) {
+        iter->stamp = 0;
+        return FALSE;
+    }
+    return TRUE;
+}
+
+static gboolean table_model_iter_children(GtkTreeModel* tree_model, GtkTreeIter* iter, GtkTreeIter* parent) {
+    if (parent) return FALSE;
+    return table_model_fill_iter(TABLE_MODEL(tree_model), 0, iter);
+}
+
+static gboolean table_model_iter_has_child(GtkTreeModel* tree_model, GtkTreeIter* iter) {
+    return FALSE;
+}
+
+static gint table_model_iter_n_children(GtkTreeModel* tree_model, GtkTreeIter* iter) {
+    if (iter) return 0;
+    return TABLE_MODEL(tree_model)->n_rows;
+}
+
+static gboolean table_model_iter_nth_child(GtkTreeModel* tree_model, GtkTreeIter* iter,
+                                           GtkTreeIter* parent, gint n) {
+    if (parent) return FALSE;
+    return table_model_fill_iter(TABLE_MODEL(tree_model), n, iter);
+}
+
+static gboolean table_model_iter_parent(GtkTreeModel* tree_model, GtkTreeIter* iter, GtkTreeIter* child) {
+    return FALSE;
+}
+
+static void table_model_tree_model_init(GtkTreeModelIface* iface) {
+    iface->get_flags = table_model_get_flags;
+    iface->get_n_columns = table_model_get_n_columns;
+    iface->get_column_type = table_model_get_column_type;
+    iface->get_iter = table_model_get_iter;
+    iface->get_path = table_model_get_path;
+    iface->get_value = table_model_get_value;
+    iface->iter_next = table_model_iter_next;
+    iface->iter_children = table_model_iter_children;
+    iface->iter_has_child = table_model_iter_has_child;
+    iface->iter_n_children = table_model_iter_n_children;
+    iface->iter_nth_child = table_model_iter_nth_child;
+    iface->iter_parent = table_model_iter_parent;
+}
+
+// ============================================================================
+// OBJECT LIFECYCLE
+// ============================================================================
+
+static void table_model_on_compacted(void* data, const int* remap, int old_count);
+
+static void table_model_finalize(GObject* object) {
+    TableModel* model = TABLE_MODEL(object);
+    Tombstones* tombstones = table_model_tombstones(model);
+    if (tombstones) tombstones_unwatch(tombstones, table_model_on_compacted, model);
+    free(model->rows);
+    model->rows = NULL;
+    g_hash_table_destroy(model->id_rows);
+    G_OBJECT_CLASS(table_model_parent_class)->finalize(object);
+}
+
+static void table_model_class_init(TableModelClass* klass) {
+    G_OBJECT_CLASS(klass)->finalize = table_model_finalize;
+}
+
+static void table_model_init(TableModel* model) {
+    model->stamp = g_random_int();
+    model->rows = NULL;
+    model->n_rows = 0;
+    model->n_records = 0;
+    model->id_rows = g_hash_table_new(g_direct_hash, g_direct_equal);
+}
+
+// Row map over every record still in the table, or none if nothing was deleted
+static void table_model_map_live(TableModel* model) {
+    int count = table_model_table_count(model);
+    Tombstones* tombstones = table_model_tombstones(model);
+
+    free(model->rows);
+    model->rows = NULL;
+    model->n_rows = count;
+    model->n_records = count;
+
+    if (tombstones && tombstones->dead > 0) {
+        model->rows = (int*)malloc((count > 0 ? count : 1) * sizeof(int));
+        if (!model->rows) {
+            printf("[ERROR] Failed to allocate row map for %d rows\n", count);
+            model->n_rows = 0;
+        } else {
+            model->n_rows = 0;
+            for (int i = 0; i < count; i++) {
+                if (!table_model_is_deleted(model, i)) model->rows[model->n_rows++] = i;
+            }
+        }
+    }
+    table_model_index_ids_from(model, 0);
+}
+
+TableModel* table_model_new(TableModelKind kind, void* table) {
+    TableModel* model = g_object_new(TABLE_MODEL_TYPE, NULL);
+    model->kind = kind;
+    model->table = table;
+    table_model_map_live(model);
+
+    Tombstones* tombstones = table_model_tombstones(model);
+    if (tombstones) tombstones_watch(tombstones, table_model_on_compacted, model);
+    return model;
+}
+
+// Replace the row map. Meant for models not yet attached to a view; an
+// attached view would need a fresh model to pick up the new row count.
+void table_model_set_rows(TableModel* model, const int* rows, int count) {
+    if (!model) return;
+
+    free(model->rows);
+    model->rows = NULL;
+    model->stamp++;
+    model->n_records = table_model_table_count(model);
+
+    if (!rows) {
+        table_model_map_live(model);
+        return;
+    }
+
+    model->rows = (int*)malloc((count > 0 ? count : 1) * sizeof(int));
+    if (!model->rows) {
+        printf("[ERROR] Failed to allocate row map for %d rows\n", count);
+        model->n_rows = 0;
+        g_hash_table_remove_all(model->id_rows);
+        return;
+    }
+    memcpy(model->rows, rows, count * sizeof(int));
+    model->n_rows = count;
+    table_model_index_ids_from(model, 0);
+}
+
+typedef struct {
+    int course_id;
+    int index;
+} CourseRow;
+
+static int compare_course_rows(const void* a, const void* b) {
+    const CourseRow* ra = (const CourseRow*)a;
+    const CourseRow* rb = (const CourseRow*)b;
+    if (ra->course_id != rb->course_id) return ra->course_id < rb->course_id ? -1 : 1;
+    return ra->index - rb->index;
+}
+
+// Order attendance by course and insert one header row per course
+void table_model_group_attendance_by_course(TableModel* model) {
+    if (!model || model->kind != TABLE_MODEL_ATTENDANCE || !model->table) return;
+
+    AttendanceList* attendance = (AttendanceList*)model->table;
+    if (attendance->count == 0) {
+        table_model_set_rows(model, NULL, 0);
+        return;
+    }
+
+    CourseRow* sorted = (CourseRow*)malloc(attendance->count * sizeof(CourseRow));
+    int* rows = (int*)malloc(2 * attendance->count * sizeof(int));
+    if (!sorted || !rows) {
+        free(sorted);
+        free(rows);
+        return;
+    }
+
+    int live = 0;
+    for (int i = 0; i < attendance->count; i++) {
+        if (attendance->records[i].is_deleted) continue;
+        sorted[live].course_id = attendance->records[i].course_id;
+        sorted[live].index = i;
+        live++;
+    }
+    qsort(sorted, live, sizeof(CourseRow), compare_course_rows);
+
+    int count = 0;
+    for (int i = 0; i < live; i++) {
+        if (i == 0 || sorted[i].course_id != sorted[i - 1].course_id) {
+            rows[count++] = -1 - sorted[i].index;
+        }
+        rows[count++] = sorted[i].index;
+    }
+
+    table_model_set_rows(model, rows, count);
+    free(sorted);
+    free(rows);
+}
+
+// ============================================================================
+// ROW ACCESS
+// ============================================================================
+
+// Table index behind an iter, or -1 for group headers and stale iters
+int table_model_iter_get_index(TableModel* model, GtkTreeIter* iter) {
+    if (!model) return -1;
+    int row = table_model_iter_row(model, iter);
+    if (row < 0 || row >= model->n_rows) return -1;
+    int entry = table_model_entry(model, row);
+    return entry < 0 ? -1 : entry;
+}
+
+gboolean table_model_get_iter_for_index(TableModel* model, int table_index, GtkTreeIter* iter) {
+    if (!model || table_index < 0 || table_index >= table_model_table_count(model)) return FALSE;
+    if (!model->rows) return table_model_fill_iter(model, table_index, iter);
+    return table_model_get_iter_for_id(model, table_model_record_id(model, table_index), iter);
+}
+
+gboolean table_model_get_iter_for_id(TableModel* model, int record_id, GtkTreeIter* iter) {
+    if (!model) return FALSE;
+    return table_model_fill_iter(model, table_model_find_row(model, record_id), iter);
+}
+
+// Tell the view a table row was edited in place
+void table_model_row_changed(TableModel* model, int table_index) {
+    GtkTreeIter iter;
+    if (!table_model_get_iter_for_index(model, table_index, &iter)) return;
+
+    GtkTreePath* path = table_model_get_path(GTK_TREE_MODEL(model), &iter);
+    gtk_tree_model_row_changed(GTK_TREE_MODEL(model), path, &iter);
+    gtk_tree_path_free(path);
+}
+
+// Announce rows appended to or dropped from the tail of an unmapped table
+void table_model_sync(TableModel* model) {
+    if (!model || model->rows) return;
+
+    int count = table_model_table_count(model);
+    int old_rows = model->n_rows;
+
+    while (model->n_rows < count) {
+        int row = model->n_rows++;
+        table_model_index_row(model, row);
+        table_model_emit_inserted(model, row);
+    }
+
+    while (model->n_rows > count) {
+        table_model_emit_deleted(model, --model->n_rows);
+    }
+    if (model->n_rows < old_rows) {
+        table_model_index_ids_from(model, 0);
+    }
+    model->n_records = count;
+}
+
+// ============================================================================
+// CHANGE PROPAGATION
+// ============================================================================
+
+// Insert a row map entry at a view row, growing the map by one
+static int table_model_map_insert(TableModel* model, int row, int entry) {
+    int* grown = (int*)realloc(model->rows, (model->n_rows + 1) * sizeof(int));
+    if (!grown) {
+        printf("[ERROR] Failed to grow row map\n");
+        return 0;
+    }
+    model->rows = grown;
+    memmove(&model->rows[row + 1], &model->rows[row], (model->n_rows - row) * sizeof(int));
+    model->rows[row] = entry;
+    model->n_rows++;
+    return 1;
+}
+
+static void table_model_map_remove(TableModel* model, int row) {
+    memmove(&model->rows[row], &model->rows[row + 1], (model->n_rows - row - 1) * sizeof(int));
+    model->n_rows--;
+}
+
+// View row after the last record of a course, or -1 if the course has no group yet
+static int table_model_attendance_group_end(TableModel* model, int course_id) {
+    AttendanceList* attendance = (AttendanceList*)model->table;
+    int end = -1;
+    for (int row = 0; row < model->n_rows; row++) {
+        int entry = model->rows[row];
+        int index = entry < 0 ? -1 - entry : entry;
+        if (attendance->records[index].course_id == course_id) {
+            end = row + 1;
+        } else if (end >= 0) {
+            break;
+        }
+    }
+    return end;
+}
+
+static void table_model_insert_index(TableModel* model, int index) {
+    if (model->kind == TABLE_MODEL_ATTENDANCE) {
+        AttendanceList* attendance = (AttendanceList*)model->table;
+        int row = table_model_attendance_group_end(model, attendance->records[index].course_id);
+        if (row < 0) {
+            // New course: header and record go at the end
+            row = model->n_rows;
+            if (!table_model_map_insert(model, row, -1 - index)) return;
+            table_model_emit_inserted(model, row);
+            row++;
+        }
+        if (!table_model_map_insert(model, row, index)) return;
+        table_model_index_ids_from(model, row);
+        table_model_emit_inserted(model, row);
+        return;
+    }
+
+    // Filtered views append the new record at the end
+    int row = model->n_rows;
+    if (!table_model_map_insert(model, row, index)) return;
+    table_model_index_row(model, row);
+    table_model_emit_inserted(model, row);
+}
+
+// The backing list appended records; show them without touching other rows
+void table_model_record_inserted(TableModel* model) {
+    if (!model) return;
+    if (!model->rows) {
+        table_model_sync(model);
+        return;
+    }
+
+    int count = table_model_table_count(model);
+    for (int index = model->n_records; index < count; index++) {
+        table_model_insert_index(model, index);
+    }
+    model->n_records = count;
+}
+
+void table_model_record_changed(TableModel* model, int record_id) {
+    GtkTreeIter iter;
+    if (!table_model_get_iter_for_id(model, record_id, &iter)) return;
+
+    GtkTreePath* path = table_model_get_path(GTK_TREE_MODEL(model), &iter);
+    gtk_tree_model_row_changed(GTK_TREE_MODEL(model), path, &iter);
+    gtk_tree_path_free(path);
+}
+
+// Turn an unmapped model into an explicit 1:1 row map
+static int table_model_map_all(TableModel* model) {
+    if (model->rows) return 1;
+
+    model->rows = (int*)malloc((model->n_rows > 0 ? model->n_rows : 1) * sizeof(int));
+    if (!model->rows) {
+        printf("[ERROR] Failed to allocate row map for %d rows\n", model->n_rows);
+        return 0;
+    }
+    for (int row = 0; row < model->n_rows; row++) {
+        model->rows[row] = row;
+    }
+    return 1;
+}
+
+// Drop a row and keep the group header above it pointing into its own group.
+// The caller has already unmapped the removed record's id; only the rows
+// below it move up, so only their ids are re-pointed.
+static void table_model_remove_row(TableModel* model, int row) {
+    table_model_map_remove(model, row);
+
+    int drop_header = 0;
+    if (row > 0 && model->rows[row - 1] < 0) {
+        if (row < model->n_rows && model->rows[row] >= 0) {
+            model->rows[row - 1] = -1 - model->rows[row];
+        } else {
+            drop_header = 1;
+        }
+    }
+
+    table_model_index_ids_from(model, row);
+    table_model_emit_deleted(model, row);
+
+    if (drop_header) {
+        table_model_map_remove(model, row - 1);
+        table_model_index_ids_from(model, row - 1);
+        table_model_emit_deleted(model, row - 1);
+    }
+}
+
+// The backing list tombstoned a record, or (clubs) dropped it and shifted
+// the ones after it down
+void table_model_record_removed(TableModel* model, int record_id) {
+    if (!model) return;
+    int row = table_model_find_row(model, record_id);
+    if (row < 0) return;
+
+    // The record keeps its slot until the table compacts, so no index moves
+    if (table_model_tombstones(model)) {
+        if (!table_model_map_all(model)) return;
+        g_hash_table_remove(model->id_rows, GINT_TO_POINTER(record_id));
+        table_model_remove_row(model, row);
+        return;
+    }
+
+    if (!model->rows) {
+        model->n_rows--;
+        model->n_records--;
+        if (model->kind == TABLE_MODEL_GRADES) {
+            // Keyed by index: only the old last key goes stale
+            g_hash_table_remove(model->id_rows, GINT_TO_POINTER(model->n_rows));
+        } else {
+            g_hash_table_remove(model->id_rows, GINT_TO_POINTER(record_id));
+            table_model_index_ids_from(model, row);
+        }
+        table_model_emit_deleted(model, row);
+        return;
+    }
+
+    int index = model->rows[row];
+    model->n_records--;
+    g_hash_table_remove(model->id_rows, GINT_TO_POINTER(record_id));
+
+    // Later table entries moved down by one
+    for (int i = 0; i < model->n_rows; i++) {
+        if (model->rows[i] > index) model->rows[i]--;
+        else if (model->rows[i] < -1 - index) model->rows[i]++;
+    }
+
+    table_model_remove_row(model, row);
+}
+
+// The backing table squeezed out its tombstones. Surviving rows are pointed
+// at their new slots first so the view never reads a moved record through a
+// stale entry, then the rows of dropped records are deleted bottom-up.
+static void table_model_on_compacted(void* data, const int* remap, int old_count) {
+    TableModel* model = (TableModel*)data;
+    if (!remap || !table_model_map_all(model)) return;
+
+    int group_first = -1;   // first surviving record below, within the group
+    for (int row = model->n_rows - 1; row >= 0; row--) {
+        int entry = model->rows[row];
+        if (entry >= 0) {
+            int moved = entry < old_count ? remap[entry] : -1;
+            model->rows[row] = moved >= 0 ? moved : TABLE_MODEL_ROW_DROPPED;
+            if (moved >= 0) group_first = moved;
+        } else {
+            model->rows[row] = group_first >= 0 ? -1 - group_first : TABLE_MODEL_ROW_DROPPED;
+            group_first = -1;
+        }
+    }
+
+    // Each row leaves rows[] before its row_deleted, so the view only ever
+    // sees the model as it is after that one deletion. Removed records have
+    // normally left the view already; the rows dropped here are few.
+    for (int row = model->n_rows - 1; row >= 0; row--) {
+        if (model->rows[row] != TABLE_MODEL_ROW_DROPPED) continue;
+        table_model_map_remove(model, row);
+        table_model_emit_deleted(model, row);
+    }
+
+    model->n_records = 0;
+    for (int i = 0; i < old_count; i++) {
+        if (remap[i] >= 0) model->n_records++;
+    }
+    // Grades are keyed by table index, which just changed for every row
+    table_model_index_ids_from(model, 0);
+}
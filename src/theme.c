@@ -938,84 +938,196 @@ char* theme_generate_dialog_css(ThemeConfig* config) {
 }
 
 // ============================================================================
-// THEME APPLICATION
+// STYLESHEET CACHE
 // ============================================================================
 
-int theme_apply_theme(ThemeConfig* config, GtkApplication* app) {
-    if (!config || !app) return 0;
-    
+// Everything the stylesheet is generated from, with the unused tail of each
+// string zeroed so two keys compare with memcmp
+typedef struct {
+    ThemeType theme;            // THEME_LIGHT or THEME_DARK
+    ColorScheme colors;
+    char font_family[50];
+    int metrics[14];
+} ThemeCssKey;
+
+typedef struct {
+    ThemeCssKey key;
+    char* css;
+    GtkCssProvider* provider;
+    unsigned long last_used;    // 0 for a free slot
+} ThemeCssEntry;
+
+static ThemeCssEntry g_css_cache[THEME_CSS_CACHE_SIZE];
+static unsigned long g_css_clock = 0;
+static GtkCssProvider* g_screen_provider = NULL;   // the one on the screen, referenced
+
+static void theme_key_text(char* text, size_t size) {
+    size_t length = strnlen(text, size);
+    memset(text + length, 0, size - length);
+}
+
+#define THEME_KEY_TEXT(field) theme_key_text(field, sizeof(field))
+
+static void theme_css_key(const ThemeConfig* config, ThemeCssKey* key) {
+    memset(key, 0, sizeof(*key));
+    key->theme = (config->current_theme == THEME_DARK) ? THEME_DARK : THEME_LIGHT;
+    key->colors = (key->theme == THEME_DARK) ? config->dark_colors : config->light_colors;
+    THEME_KEY_TEXT(key->colors.name);
+    THEME_KEY_TEXT(key->colors.background_color);
+    THEME_KEY_TEXT(key->colors.foreground_color);
+    THEME_KEY_TEXT(key->colors.primary_color);
+    THEME_KEY_TEXT(key->colors.secondary_color);
+    THEME_KEY_TEXT(key->colors.accent_color);
+    THEME_KEY_TEXT(key->colors.error_color);
+    THEME_KEY_TEXT(key->colors.warning_color);
+    THEME_KEY_TEXT(key->colors.success_color);
+    THEME_KEY_TEXT(key->colors.info_color);
+    THEME_KEY_TEXT(key->colors.border_color);
+    THEME_KEY_TEXT(key->colors.selection_color);
+    THEME_KEY_TEXT(key->colors.hover_color);
+    THEME_KEY_TEXT(key->colors.disabled_color);
+    memcpy(key->font_family, config->font_family, sizeof(key->font_family));
+    THEME_KEY_TEXT(key->font_family);
+
+    const int metrics[] = {
+        config->font_size, config->font_size_large, config->font_size_small, config->border_radius,
+        config->padding_small, config->padding_medium, config->padding_large,
+        config->margin_small, config->margin_medium, config->margin_large,
+        config->animation_duration, config->enable_animations, config->enable_transparency,
+        (int)(config->transparency_level * 1000)
+    };
+    memcpy(key->metrics, metrics, sizeof(key->metrics));
+}
+
+static void theme_css_entry_clear(ThemeCssEntry* entry) {
+    if (entry->provider) g_object_unref(entry->provider);
+    free(entry->css);
+    memset(entry, 0, sizeof(*entry));
+}
+
+// Generate and parse the stylesheet of config, or find it from last time
+static ThemeCssEntry* theme_css_lookup(ThemeConfig* config) {
+    ThemeCssKey key;
+    theme_css_key(config, &key);
+
+    ThemeCssEntry* slot = NULL;
+    for (int i = 0; i < THEME_CSS_CACHE_SIZE; i++) {
+        ThemeCssEntry* entry = &g_css_cache[i];
+        if (entry->last_used && memcmp(&entry->key, &key, sizeof(key)) == 0) {
+            entry->last_used = ++g_css_clock;
+            return entry;
+        }
+        // A free slot, else the least recently used one not on the screen
+        if (entry->provider == g_screen_provider && entry->last_used) continue;
+        if (!slot || entry->last_used < slot->last_used) slot = entry;
+    }
+    if (!slot) return NULL;
+
+    gint64 started = g_get_monotonic_time();
     char* css = theme_generate_css(config);
-    if (!css) return 0;
-    
+    if (!css) return NULL;
+
     GtkCssProvider* provider = gtk_css_provider_new();
     GError* error = NULL;
-    
-    if (gtk_css_provider_load_from_data(provider, css, -1, &error)) {
-        GdkDisplay* display = gdk_display_get_default();
-        GdkScreen* screen = gdk_display_get_default_screen(display);
-        gtk_style_context_add_provider_for_screen(
-            screen,
-            GTK_STYLE_PROVIDER(provider),
-            GTK_STYLE_PROVIDER_PRIORITY_APPLICATION
-        );
-        g_object_unref(provider);
-        free(css);
-        return 1;
-    } else {
-        if (error) {
-            g_error_free(error);
-        }
+    if (!gtk_css_provider_load_from_data(provider, css, -1, &error)) {
+        fprintf(stderr, "[ERROR] Failed to load CSS: %s\n", error ? error->message : "Unknown error");
+        if (error) g_error_free(error);
         g_object_unref(provider);
         free(css);
+        return NULL;
+    }
+
+    theme_css_entry_clear(slot);
+    slot->key = key;
+    slot->css = css;
+    slot->provider = provider;
+    slot->last_used = ++g_css_clock;
+    printf("[INFO] %s theme stylesheet compiled in %.1f ms (%zu bytes)\n",
+           theme_type_to_string(key.theme), (g_get_monotonic_time() - started) / 1000.0, strlen(css));
+    return slot;
+}
+
+// Make provider the only theme provider on the screen
+static int theme_install_provider(GtkCssProvider* provider) {
+    if (provider == g_screen_provider) return 1;
+
+    GdkScreen* screen = gdk_screen_get_default();
+    if (!screen) {
+        fprintf(stderr, "[ERROR] Failed to get default screen\n");
         return 0;
     }
+    if (g_screen_provider) {
+        gtk_style_context_remove_provider_for_screen(screen, GTK_STYLE_PROVIDER(g_screen_provider));
+        g_object_unref(g_screen_provider);
+    }
+    gtk_style_context_add_provider_for_screen(screen, GTK_STYLE_PROVIDER(provider),
+                                              GTK_STYLE_PROVIDER_PRIORITY_USER);
+    g_screen_provider = g_object_ref(provider);
+    return 1;
+}
+
+int theme_install(ThemeConfig* config) {
+    if (!config) return 0;
+    ThemeCssEntry* entry = theme_css_lookup(config);
+    return entry ? theme_install_provider(entry->provider) : 0;
+}
+
+const char* theme_get_css(ThemeConfig* config) {
+    if (!config) return NULL;
+    ThemeCssEntry* entry = theme_css_lookup(config);
+    return entry ? entry->css : NULL;
+}
+
+void theme_cache_clear(void) {
+    if (g_screen_provider) {
+        GdkScreen* screen = gdk_screen_get_default();
+        if (screen) {
+            gtk_style_context_remove_provider_for_screen(screen, GTK_STYLE_PROVIDER(g_screen_provider));
+        }
+        g_object_unref(g_screen_provider);
+        g_screen_provider = NULL;
+    }
+    for (int i = 0; i < THEME_CSS_CACHE_SIZE; i++) {
+        theme_css_entry_clear(&g_css_cache[i]);
+    }
 }
 
+// ============================================================================
+// THEME APPLICATION
+// ============================================================================
+
+int theme_apply_theme(ThemeConfig* config, GtkApplication* app) {
+    if (!config || !app) return 0;
+    return theme_install(config);
+}
+
+// The stylesheet is screen-wide, so this only makes sure the current
+// theme's provider is the installed one; usually there is nothing to do
 int theme_apply_to_window(GtkWindow* window, ThemeConfig* config) {
     if (!window || !config) return 0;
-    
-    GtkWidget* widget = GTK_WIDGET(window);
-    return theme_apply_to_widget(widget, config);
+    return theme_install(config);
 }
 
 int theme_apply_to_widget(GtkWidget* widget, ThemeConfig* config) {
     if (!widget || !config) return 0;
-    
-    char* css = theme_generate_css(config);
-    if (!css) return 0;
-    
-    int result = theme_apply_css(widget, css);
-    free(css);
-    return result;
+    return theme_install(config);
 }
 
+// Replace the theme provider with one built from css_content. It is not
+// cached; the next theme_install() puts the cached stylesheet back.
 int theme_apply_css(GtkWidget* widget, const char* css_content) {
     if (!css_content) {
         printf("[WARNING] No CSS content provided\n");
         return 0;
     }
     
-    printf("[DEBUG] CSS Content:\n%s\n", css_content);
-    printf("[DEBUG] CSS Length: %zu bytes\n", strlen(css_content));
-    
     GtkCssProvider* provider = gtk_css_provider_new();
     GError* error = NULL;
     
     if (gtk_css_provider_load_from_data(provider, css_content, -1, &error)) {
-        // Apply CSS globally to all widgets on the default screen
-        GdkScreen* screen = gdk_screen_get_default();
-        if (screen) {
-            gtk_style_context_add_provider_for_screen(
-                screen,
-                GTK_STYLE_PROVIDER(provider),
-                GTK_STYLE_PROVIDER_PRIORITY_USER
-            );
-            printf("[INFO] Theme CSS applied successfully to screen\n");
-        } else {
-            fprintf(stderr, "[ERROR] Failed to get default screen\n");
-        }
+        int result = theme_install_provider(provider);
         g_object_unref(provider);
-        return 1;
+        return result;
     } else {
         if (error) {
             fprintf(stderr, "[ERROR] Failed to load CSS: %s\n", error->message);
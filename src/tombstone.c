@@ -0,0 +1,134 @@
+#include "tombstone.h"
+
+static void (*g_schedule_compaction)(void) = NULL;
+static int g_compaction_pending = 0;
+
+// ============================================================================
+// DELETION
+// ============================================================================
+
+// Flag a record as deleted. Returns 0 if it already was.
+int tombstones_mark(Tombstones* tombstones, int* is_deleted, int count) {
+    if (!tombstones || !is_deleted || *is_deleted) return 0;
+
+    *is_deleted = 1;
+    tombstones->dead++;
+
+    if (g_schedule_compaction && !g_compaction_pending &&
+        tombstones_should_compact(tombstones, count)) {
+        g_compaction_pending = 1;
+        g_schedule_compaction();
+    }
+    return 1;
+}
+
+int tombstones_should_compact(const Tombstones* tombstones, int count) {
+    if (!tombstones || tombstones->dead < TOMBSTONE_COMPACT_MIN) return 0;
+    return (long)tombstones->dead * 100 >= (long)count * TOMBSTONE_COMPACT_PERCENT;
+}
+
+// ============================================================================
+// COMPACTION
+// ============================================================================
+
+// Slide live records down over the flagged ones, run by run, keeping their
+// order. Watchers get the index map before it is thrown away.
+int tombstones_compact(Tombstones* tombstones, void* records, size_t record_size,
+                       size_t flag_offset, int count) {
+    if (!tombstones || !records || tombstones->dead == 0) return count;
+
+    unsigned char* base = (unsigned char*)records;
+    int* remap = NULL;
+    if (tombstones->watch_count > 0) {
+        remap = (int*)malloc((count > 0 ? count : 1) * sizeof(int));
+        if (!remap) {
+            printf("[WARNING] Skipping compaction, out of memory\n");
+            return count;
+        }
+    }
+
+    int live = 0;
+    int i = 0;
+    while (i < count) {
+        int run_start = i;
+        while (i < count && !*(int*)(base + i * record_size + flag_offset)) {
+            if (remap) remap[i] = live + (i - run_start);
+            i++;
+        }
+
+        int run = i - run_start;
+        if (run > 0 && live != run_start) {
+            memmove(base + live * record_size, base + run_start * record_size, run * record_size);
+        }
+        live += run;
+
+        while (i < count && *(int*)(base + i * record_size + flag_offset)) {
+            if (remap) remap[i] = -1;
+            i++;
+        }
+    }
+    tombstones->dead = 0;
+
+    for (int w = 0; w < tombstones->watch_count; w++) {
+        tombstones->watches[w].callback(tombstones->watches[w].data, remap, count);
+    }
+    free(remap);
+    return live;
+}
+
+// ============================================================================
+// INDEX HOLDERS
+// ============================================================================
+
+int tombstones_watch(Tombstones* tombstones, TombstoneWatcher callback, void* data) {
+    if (!tombstones || !callback) return 0;
+
+    for (int w = 0; w < tombstones->watch_count; w++) {
+        if (tombstones->watches[w].callback == callback && tombstones->watches[w].data == data) {
+            return 1;
+        }
+    }
+
+    TombstoneWatch* watches = (TombstoneWatch*)realloc(tombstones->watches,
+        (tombstones->watch_count + 1) * sizeof(TombstoneWatch));
+    if (!watches) {
+        printf("[ERROR] Failed to register compaction watcher\n");
+        return 0;
+    }
+    watches[tombstones->watch_count].callback = callback;
+    watches[tombstones->watch_count].data = data;
+    tombstones->watches = watches;
+    tombstones->watch_count++;
+    return 1;
+}
+
+void tombstones_unwatch(Tombstones* tombstones, TombstoneWatcher callback, void* data) {
+    if (!tombstones) return;
+
+    for (int w = 0; w < tombstones->watch_count; w++) {
+        if (tombstones->watches[w].callback == callback && tombstones->watches[w].data == data) {
+            tombstones->watches[w] = tombstones->watches[--tombstones->watch_count];
+            return;
+        }
+    }
+}
+
+void tombstones_free(Tombstones* tombstones) {
+    if (!tombstones) return;
+    free(tombstones->watches);
+    memset(tombstones, 0, sizeof(Tombstones));
+}
+
+// ============================================================================
+// BACKGROUND COMPACTION
+// ============================================================================
+
+void tombstones_set_compaction_hook(void (*schedule_compaction)(void)) {
+    g_schedule_compaction = schedule_compaction;
+    g_compaction_pending = 0;
+}
+
+// The scheduled pass ran; the next table to cross the threshold schedules another
+void tombstones_compaction_done(void) {
+    g_compaction_pending = 0;
+}
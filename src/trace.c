@@ -0,0 +1,172 @@
+#include "trace.h"
+
+#ifdef TRACE_ENABLED
+
+#include <glib.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef struct {
+    const char* name;
+    gint64 ts;          // microseconds since trace_init()
+    char phase;         // 'B' or 'E'
+} TraceEvent;
+
+typedef struct TraceBuffer TraceBuffer;
+
+// Written only by its own thread. count is published with release order
+// after the event it covers, so trace_write() on another thread reads only
+// complete events.
+struct TraceBuffer {
+    TraceEvent events[TRACE_BUFFER_EVENTS];
+    atomic_int count;
+    int open;                   // recorded begins still waiting for their end
+    int overflow_depth;         // dropped begins still waiting for their end
+    int dropped;
+    int tid;
+    const char* name;
+    TraceBuffer* next;          // registry link, set once before publishing
+};
+
+static _Atomic(TraceBuffer*) g_buffers = NULL;
+static atomic_int g_next_tid = 1;
+static gint64 g_start = 0;
+static GPrivate g_thread_buffer = G_PRIVATE_INIT(NULL);   // never freed, see trace.h
+
+// ============================================================================
+// RECORDING
+// ============================================================================
+
+static TraceBuffer* trace_buffer(void) {
+    TraceBuffer* buffer = g_private_get(&g_thread_buffer);
+    if (buffer) return buffer;
+
+    buffer = calloc(1, sizeof(TraceBuffer));
+    if (!buffer) return NULL;
+    buffer->tid = atomic_fetch_add(&g_next_tid, 1);
+    g_private_set(&g_thread_buffer, buffer);
+
+    // Lock-free push onto the registry
+    TraceBuffer* head = atomic_load(&g_buffers);
+    do {
+        buffer->next = head;
+    } while (!atomic_compare_exchange_weak(&g_buffers, &head, buffer));
+    return buffer;
+}
+
+static void trace_record(TraceBuffer* buffer, const char* name, char phase) {
+    int count = atomic_load_explicit(&buffer->count, memory_order_relaxed);
+    TraceEvent* event = &buffer->events[count];
+    event->name = name;
+    event->ts = g_get_monotonic_time() - g_start;
+    event->phase = phase;
+    atomic_store_explicit(&buffer->count, count + 1, memory_order_release);
+}
+
+void trace_begin(const char* name) {
+    TraceBuffer* buffer = trace_buffer();
+    if (!buffer) return;
+
+    // Keep a slot for the end of every open span, this one included
+    int count = atomic_load_explicit(&buffer->count, memory_order_relaxed);
+    if (buffer->overflow_depth > 0 || count + buffer->open + 2 > TRACE_BUFFER_EVENTS) {
+        buffer->overflow_depth++;
+        buffer->dropped++;
+        return;
+    }
+    trace_record(buffer, name ? name : "?", 'B');
+    buffer->open++;
+}
+
+void trace_end(void) {
+    TraceBuffer* buffer = trace_buffer();
+    if (!buffer) return;
+
+    if (buffer->overflow_depth > 0) {
+        buffer->overflow_depth--;
+        return;
+    }
+    if (buffer->open == 0) return;    // unbalanced TRACE_END()
+    trace_record(buffer, NULL, 'E');
+    buffer->open--;
+}
+
+void trace_thread_name(const char* name) {
+    TraceBuffer* buffer = trace_buffer();
+    if (buffer && !buffer->name) buffer->name = name;
+}
+
+void trace_init(void) {
+    g_start = g_get_monotonic_time();
+    trace_thread_name("main");
+}
+
+// ============================================================================
+// OUTPUT
+// ============================================================================
+
+static void trace_write_string(FILE* out, const char* s) {
+    fputc('"', out);
+    for (; *s; s++) {
+        unsigned char c = (unsigned char)*s;
+        if (c == '"' || c == '\\') {
+            fprintf(out, "\\%c", c);
+        } else if (c < 0x20) {
+            fprintf(out, "\\u%04x", c);
+        } else {
+            fputc(c, out);
+        }
+    }
+    fputc('"', out);
+}
+
+int trace_write(const char* filename) {
+    if (!filename) return 0;
+
+    FILE* out = fopen(filename, "w");
+    if (!out) {
+        printf("[ERROR] Cannot write trace to %s\n", filename);
+        return 0;
+    }
+
+    fprintf(out, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+    int first = 1;
+    long long events = 0, dropped = 0;
+    for (TraceBuffer* buffer = atomic_load(&g_buffers); buffer; buffer = buffer->next) {
+        int count = atomic_load_explicit(&buffer->count, memory_order_acquire);
+
+        if (buffer->name) {
+            fprintf(out, "%s{\"ph\": \"M\", \"name\": \"thread_name\", \"pid\": 1, \"tid\": %d, "
+                         "\"args\": {\"name\": ", first ? "" : ",\n", buffer->tid);
+            trace_write_string(out, buffer->name);
+            fprintf(out, "}}");
+            first = 0;
+        }
+        for (int i = 0; i < count; i++) {
+            const TraceEvent* event = &buffer->events[i];
+            fprintf(out, "%s{\"ph\": \"%c\", \"pid\": 1, \"tid\": %d, \"ts\": %lld",
+                    first ? "" : ",\n", event->phase, buffer->tid, (long long)event->ts);
+            if (event->name) {
+                fprintf(out, ", \"name\": ");
+                trace_write_string(out, event->name);
+            }
+            fprintf(out, "}");
+            first = 0;
+        }
+        events += count;
+        dropped += buffer->dropped;
+    }
+    fprintf(out, "\n]}\n");
+
+    if (fclose(out) != 0) {
+        printf("[ERROR] Cannot write trace to %s\n", filename);
+        return 0;
+    }
+    printf("[INFO] Trace written to %s (%lld events", filename, events);
+    if (dropped > 0) printf(", %lld spans dropped on full buffers", dropped);
+    printf(")\n");
+    return 1;
+}
+
+#endif // TRACE_ENABLED
@@ -9,6 +9,16 @@
 #include "file_manager.h"
 #include "config.h"
 #include "utils.h"
+#include "job.h"
+#include "export.h"
+#include "import.h"
+#include "backup.h"
+#include "asset.h"
+#include "autosave.h"
+#include "trace.h"
+#include "metrics.h"
+#include "changelog.h"
+#include "replication.h"
 
 #include <gtk/gtk.h>
 #include <glib.h>
@@ -57,7 +67,11 @@ UIState* ui_state_create(void) {
     state->attendance = NULL;
     state->clubs = NULL;
     state->memberships = NULL;
+    state->club_rosters = NULL;
     state->courses = NULL;
+    state->exams = NULL;
+    state->prof_notes = NULL;
+    state->professors = NULL;
     state->current_session = NULL;
     
     return state;
@@ -92,6 +106,8 @@ int ui_init(int argc, char* argv[]) {
 }
 
 void ui_cleanup(void) {
+    theme_cache_clear();
+    asset_cache_clear();
     if (g_theme_config) {
         theme_config_destroy(g_theme_config);
         g_theme_config = NULL;
@@ -726,7 +742,7 @@ GtkWindow* ui_create_student_window(UIState* state) {
     
     GtkLabel* total_label = GTK_LABEL(gtk_label_new(""));
     char total_markup[128];
-    snprintf(total_markup, sizeof(total_markup), "<span size='x-large' weight='bold'>%d</span>", state->students ? state->students->count : 0);
+    snprintf(total_markup, sizeof(total_markup), "<span size='x-large' weight='bold'>%d</span>", student_list_get_count(state->students));
     gtk_label_set_markup(total_label, total_markup);
     gtk_widget_set_halign(GTK_WIDGET(total_label), GTK_ALIGN_START);
     gtk_box_pack_start(total_box, GTK_WIDGET(total_label), FALSE, FALSE, 0);
@@ -834,6 +850,7 @@ GtkWindow* ui_create_student_window(UIState* state) {
         GtkStyleContext* add_context = gtk_widget_get_style_context(GTK_WIDGET(add_btn));
         gtk_style_context_add_class(add_context, "suggested-action");
         gtk_box_pack_start(button_box, GTK_WIDGET(add_btn), FALSE, FALSE, 0);
+        ui_disable_if_read_only(GTK_WIDGET(add_btn), state->read_only);
     }
     
     // Secondary Action Buttons - only for Admin/Teacher
@@ -851,6 +868,8 @@ GtkWindow* ui_create_student_window(UIState* state) {
         GtkStyleContext* delete_context = gtk_widget_get_style_context(GTK_WIDGET(delete_btn));
         gtk_style_context_add_class(delete_context, "destructive-action");
         gtk_box_pack_start(button_box, GTK_WIDGET(delete_btn), FALSE, FALSE, 0);
+        ui_disable_if_read_only(GTK_WIDGET(edit_btn), state->read_only);
+        ui_disable_if_read_only(GTK_WIDGET(delete_btn), state->read_only);
     }
     
     // Spacer
@@ -874,6 +893,8 @@ GtkWindow* ui_create_student_window(UIState* state) {
     g_signal_connect(search_btn, "clicked", G_CALLBACK(ui_on_search_students_clicked), state);
     g_signal_connect(clear_btn, "clicked", G_CALLBACK(ui_on_clear_search_clicked), state);
     g_signal_connect(search_entry, "activate", G_CALLBACK(ui_on_search_entry_activate), state);
+    g_signal_connect(search_entry, "changed", G_CALLBACK(ui_on_search_entry_changed), state);
+    g_signal_connect(search_entry, "destroy", G_CALLBACK(ui_on_search_entry_destroy), NULL);
     if (add_btn) g_signal_connect(add_btn, "clicked", G_CALLBACK(ui_on_add_student_clicked), state);
     if (edit_btn) g_signal_connect(edit_btn, "clicked", G_CALLBACK(ui_on_edit_student_clicked), state);
     if (delete_btn) g_signal_connect(delete_btn, "clicked", G_CALLBACK(ui_on_delete_student_clicked), state);
@@ -986,13 +1007,13 @@ void ui_student_window_add_student(UIState* state) {
             // Create student struct
             Student new_student = {0};
             new_student.id = state->students->count + 1; // Generate new ID
-            strncpy(new_student.first_name, first_name, MAX_NAME_LENGTH - 1);
-            strncpy(new_student.last_name, last_name, MAX_NAME_LENGTH - 1);
-            strncpy(new_student.email, email, MAX_EMAIL_LENGTH - 1);
-            strncpy(new_student.phone, phone, MAX_PHONE_LENGTH - 1);
-            strncpy(new_student.address, address, MAX_ADDRESS_LENGTH - 1);
+            new_student.first_name = first_name;
+            new_student.last_name = last_name;
+            new_student.email = email;
+            new_student.phone = phone;
+            new_student.address = address;
             new_student.age = age;
-            strncpy(new_student.course, course, MAX_COURSE_LENGTH - 1);
+            new_student.course = intern_string(course);
             new_student.year = year;
             new_student.gpa = gpa;
             new_student.enrollment_date = time(NULL);
@@ -1001,13 +1022,12 @@ void ui_student_window_add_student(UIState* state) {
             // Add student
             int id = student_list_add(state->students, new_student);
             if (id > 0) {
-                // Save to file
-                char filepath[512];
-                snprintf(filepath, sizeof(filepath), "%s", STUDENTS_FILE);
-                student_list_save_to_file(state->students, filepath);
-                
-                // Refresh display
-                ui_student_window_refresh_data(state);
+                // Index and show the new row
+                Student* added = &state->students->students[state->students->count - 1];
+                search_index_add_student(state->student_search, added);
+                completion_index_add_student(state->completer, added);
+                GtkTreeView* treeview = GTK_TREE_VIEW(g_object_get_data(G_OBJECT(state->current_window), "treeview"));
+                ui_student_treeview_add_student(treeview, added);
                 ui_show_info_message(state->current_window, "Student added successfully!");
             } else {
                 ui_show_error_message(state->current_window, "Failed to add student");
@@ -1088,7 +1108,7 @@ void ui_student_window_edit_student(UIState* state) {
     gtk_spin_button_set_value(GTK_SPIN_BUTTON(age_spin), student->age);
     
     GtkWidget *course_entry = gtk_entry_new();
-    gtk_entry_set_text(GTK_ENTRY(course_entry), student->course);
+    gtk_entry_set_text(GTK_ENTRY(course_entry), intern_lookup(student->course));
     
     GtkWidget *year_spin = gtk_spin_button_new_with_range(1, 6, 1);
     gtk_spin_button_set_value(GTK_SPIN_BUTTON(year_spin), student->year);
@@ -1142,28 +1162,28 @@ void ui_student_window_edit_student(UIState* state) {
         
         // Update student fields
         printf("[DEBUG] Updating student ID %d: %s -> %s\n", student->id, student->first_name, first_name);
-        strncpy(student->first_name, first_name, MAX_NAME_LENGTH - 1);
-        strncpy(student->last_name, last_name, MAX_NAME_LENGTH - 1);
-        strncpy(student->email, email, MAX_EMAIL_LENGTH - 1);
-        strncpy(student->phone, phone, MAX_PHONE_LENGTH - 1);
-        strncpy(student->address, address, MAX_ADDRESS_LENGTH - 1);
-        student->age = age;
-        strncpy(student->course, course, MAX_COURSE_LENGTH - 1);
-        student->year = year;
-        student->gpa = gpa;
+        Student values = *student;
+        values.first_name = first_name;
+        values.last_name = last_name;
+        values.email = email;
+        values.phone = phone;
+        values.address = address;
+        values.age = age;
+        values.course = intern_string(course);
+        values.year = year;
+        values.gpa = gpa;
+        if (!student_list_update(state->students, student, &values)) {
+            ui_show_error_message(state->current_window, "Failed to update student");
+            gtk_widget_destroy(dialog);
+            return;
+        }
         printf("[DEBUG] Updated student name: %s %s\n", student->first_name, student->last_name);
         
-        // Save to file
-        char filepath[512];
-        snprintf(filepath, sizeof(filepath), "%s", STUDENTS_FILE);
-        printf("[DEBUG] About to save to: %s\n", filepath);
-        printf("[DEBUG] Student in memory BEFORE save: %s %s\n", student->first_name, student->last_name);
-        int result = student_list_save_to_file(state->students, filepath);
-        printf("[DEBUG] Save result: %d\n", result);
-        printf("[DEBUG] Student in memory AFTER save: %s %s\n", student->first_name, student->last_name);
-        
-        // Refresh display
-        ui_student_window_refresh_data(state);
+        // Reindex and redraw the edited row
+        search_index_update_student(state->student_search, student);
+        completion_index_remove(state->completer, COMPLETE_STUDENT, student->id);
+        completion_index_add_student(state->completer, student);
+        ui_student_treeview_update_student(GTK_TREE_VIEW(g_object_get_data(G_OBJECT(state->current_window), "treeview")), student);
         ui_show_info_message(state->current_window, "Student updated successfully!");
     }
     
@@ -1225,13 +1245,10 @@ void ui_student_window_delete_student(UIState* state) {
     if (response == GTK_RESPONSE_YES) {
         // Delete student
         if (student_list_remove(state->students, student_id)) {
-            // Save to file
-            char filepath[512];
-            snprintf(filepath, sizeof(filepath), "%s", STUDENTS_FILE);
-            student_list_save_to_file(state->students, filepath);
-            
-            // Refresh display
-            ui_student_window_refresh_data(state);
+            // Drop the deleted row
+            search_index_remove_student(state->student_search, student_id);
+            completion_index_remove(state->completer, COMPLETE_STUDENT, student_id);
+            ui_student_treeview_remove_student(GTK_TREE_VIEW(g_object_get_data(G_OBJECT(state->current_window), "treeview")), student_id);
             ui_show_info_message(state->current_window, "Student deleted successfully!");
         } else {
             ui_show_error_message(state->current_window, "Failed to delete student");
@@ -1297,6 +1314,9 @@ GtkWindow* ui_create_grade_window(UIState* state) {
         gtk_box_pack_start(modules_btn_box, GTK_WIDGET(add_module_btn), FALSE, FALSE, 0);
         gtk_box_pack_start(modules_btn_box, GTK_WIDGET(edit_module_btn), FALSE, FALSE, 0);
         gtk_box_pack_start(modules_btn_box, GTK_WIDGET(delete_module_btn), FALSE, FALSE, 0);
+        ui_disable_if_read_only(GTK_WIDGET(add_module_btn), state->read_only);
+        ui_disable_if_read_only(GTK_WIDGET(edit_module_btn), state->read_only);
+        ui_disable_if_read_only(GTK_WIDGET(delete_module_btn), state->read_only);
     }
     
     GtkScrolledWindow* modules_scroll = GTK_SCROLLED_WINDOW(gtk_scrolled_window_new(NULL, NULL));
@@ -1322,6 +1342,9 @@ GtkWindow* ui_create_grade_window(UIState* state) {
         gtk_box_pack_start(exams_btn_box, GTK_WIDGET(add_exam_btn), FALSE, FALSE, 0);
         gtk_box_pack_start(exams_btn_box, GTK_WIDGET(edit_exam_btn), FALSE, FALSE, 0);
         gtk_box_pack_start(exams_btn_box, GTK_WIDGET(delete_exam_btn), FALSE, FALSE, 0);
+        ui_disable_if_read_only(GTK_WIDGET(add_exam_btn), state->read_only);
+        ui_disable_if_read_only(GTK_WIDGET(edit_exam_btn), state->read_only);
+        ui_disable_if_read_only(GTK_WIDGET(delete_exam_btn), state->read_only);
     }
     
     GtkScrolledWindow* exams_scroll = GTK_SCROLLED_WINDOW(gtk_scrolled_window_new(NULL, NULL));
@@ -1347,6 +1370,9 @@ GtkWindow* ui_create_grade_window(UIState* state) {
         gtk_box_pack_start(grades_btn_box, GTK_WIDGET(add_grade_btn), FALSE, FALSE, 0);
         gtk_box_pack_start(grades_btn_box, GTK_WIDGET(edit_grade_btn), FALSE, FALSE, 0);
         gtk_box_pack_start(grades_btn_box, GTK_WIDGET(delete_grade_btn), FALSE, FALSE, 0);
+        ui_disable_if_read_only(GTK_WIDGET(add_grade_btn), state->read_only);
+        ui_disable_if_read_only(GTK_WIDGET(edit_grade_btn), state->read_only);
+        ui_disable_if_read_only(GTK_WIDGET(delete_grade_btn), state->read_only);
     }
     
     GtkScrolledWindow* grades_scroll = GTK_SCROLLED_WINDOW(gtk_scrolled_window_new(NULL, NULL));
@@ -1355,6 +1381,7 @@ GtkWindow* ui_create_grade_window(UIState* state) {
     
     GtkTreeView* grades_treeview = ui_create_grade_treeview();
     gtk_container_add(GTK_CONTAINER(grades_scroll), GTK_WIDGET(grades_treeview));
+    g_object_set_data(G_OBJECT(window), "grades_treeview", grades_treeview);
     
     // Populate grades with data
     if (state->grades) {
@@ -1367,7 +1394,8 @@ GtkWindow* ui_create_grade_window(UIState* state) {
     GtkLabel* status_label = GTK_LABEL(gtk_label_new(""));
     if (state->grades) {
         char status_text[128];
-        snprintf(status_text, sizeof(status_text), "Total Grades: %d", state->grades->count);
+        snprintf(status_text, sizeof(status_text), "Total Grades: %d",
+                 state->grades->count - state->grades->tombstones.dead);
         gtk_label_set_text(status_label, status_text);
     }
     gtk_box_pack_start(main_vbox, GTK_WIDGET(status_label), FALSE, FALSE, 0);
@@ -1419,6 +1447,7 @@ GtkWindow* ui_create_attendance_window(UIState* state) {
     
     gtk_box_pack_start(button_box, GTK_WIDGET(mark_btn), FALSE, FALSE, 0);
     gtk_box_pack_start(button_box, GTK_WIDGET(refresh_btn), FALSE, FALSE, 0);
+    ui_disable_if_read_only(GTK_WIDGET(mark_btn), state->read_only);
     
     GtkScrolledWindow* scrolled = GTK_SCROLLED_WINDOW(gtk_scrolled_window_new(NULL, NULL));
     gtk_box_pack_start(main_vbox, GTK_WIDGET(scrolled), TRUE, TRUE, 0);
@@ -1506,6 +1535,7 @@ static void on_attendance_refresh_clicked(GtkButton* btn, gpointer data) {
     // Clear old data and reload
     if (state->attendance->records) {
         state->attendance->count = 0;
+        state->attendance->tombstones.dead = 0;
     }
     attendance_list_load_from_file(state->attendance, "attendance.txt");
     
@@ -1668,7 +1698,7 @@ void ui_attendance_window_mark_attendance(UIState* state) {
     // Populate with all students (default to Present)
     for (int i = 0; i < state->students->count; i++) {
         Student* student = &state->students->students[i];
-        if (student->is_active) {
+        if (student->is_active && !student->is_deleted) {
             GtkTreeIter iter;
             gtk_list_store_append(store, &iter);
             
@@ -1742,11 +1772,9 @@ void ui_attendance_window_mark_attendance(UIState* state) {
             valid = gtk_tree_model_iter_next(GTK_TREE_MODEL(store), &iter);
         }
         
-        // Save to file
         if (saved_count > 0) {
-            attendance_list_save_to_file(state->attendance, "attendance.txt");
-            
-            // Refresh all attendance windows
+            // Add the new rows to all attendance windows
+            AttendanceRecord* last_record = &state->attendance->records[state->attendance->count - 1];
             GList* windows = gtk_window_list_toplevels();
             for (GList* l = windows; l != NULL; l = l->next) {
                 GtkWindow* win = GTK_WINDOW(l->data);
@@ -1754,7 +1782,7 @@ void ui_attendance_window_mark_attendance(UIState* state) {
                 if (title && strstr(title, "Attendance Management")) {
                     GtkTreeView* treeview = (GtkTreeView*)g_object_get_data(G_OBJECT(win), "attendance_treeview");
                     if (treeview && GTK_IS_TREE_VIEW(treeview)) {
-                        ui_attendance_treeview_populate(treeview, state->attendance);
+                        ui_attendance_treeview_add_record(treeview, last_record);
                     }
                 }
             }
@@ -1825,6 +1853,7 @@ void ui_on_add_student_to_club_clicked(GtkButton* button, gpointer user_data) {
     GtkComboBoxText* combo = GTK_COMBO_BOX_TEXT(gtk_combo_box_text_new());
     for (int i = 0; i < state->students->count; i++) {
         Student* s = &state->students->students[i];
+        if (s->is_deleted) continue;
         char text[256];
         snprintf(text, sizeof(text), "%d - %s %s", s->id, s->first_name, s->last_name);
         gtk_combo_box_text_append(combo, NULL, text);
@@ -1840,15 +1869,20 @@ void ui_on_add_student_to_club_clicked(GtkButton* button, gpointer user_data) {
             
             // Create membership
             ClubMembership membership;
-            membership.id = state->memberships ? state->memberships->count + 1 : 1;
+            membership.id = 0;   // assigned by membership_list_add
             membership.student_id = student_id;
             membership.club_id = club->id;
             membership.join_date = time(NULL);
-            strncpy(membership.role, "Member", sizeof(membership.role) - 1);
+            membership.role = intern_string(CLUB_ROLE_MEMBER);
             membership.is_active = 1;
             
             if (membership_list_add(state->memberships, membership)) {
+                club_roster_index_set_member(state->club_rosters, club->id, student_id, 1);
+                table_lock_write(state->clubs->lock);
                 club->member_count++;
+                state->clubs->dirty = 1;
+                changelog_record(state->clubs->lock, CHANGE_CLUBS, CHANGE_UPDATE, club);
+                table_unlock_write(state->clubs->lock);
                 
                 // Show success message
                 GtkWidget* msg = gtk_message_dialog_new(GTK_WINDOW(parent_window),
@@ -1875,7 +1909,7 @@ void ui_on_add_student_to_club_clicked(GtkButton* button, gpointer user_data) {
 // Callback for removing a student from a club
 void ui_on_remove_student_from_club_clicked(GtkButton* button, gpointer user_data) {
     UIState* state = (UIState*)user_data;
-    if (!state || !state->memberships) return;
+    if (!state || !state->memberships || !state->clubs) return;
     
     GtkWidget* parent_window = g_object_get_data(G_OBJECT(button), "parent_window");
     GtkTreeView* tree = g_object_get_data(G_OBJECT(button), "tree");
@@ -1910,8 +1944,15 @@ void ui_on_remove_student_from_club_clicked(GtkButton* button, gpointer user_dat
         "Are you sure you want to remove this student from the club?");
     
     if (gtk_dialog_run(GTK_DIALOG(confirm)) == GTK_RESPONSE_YES) {
+        ClubMembership* membership = membership_list_find_by_id(state->memberships, membership_id);
+        int student_id = membership ? membership->student_id : -1;
         if (membership_list_remove(state->memberships, membership_id)) {
+            club_roster_index_set_member(state->club_rosters, club->id, student_id, 0);
+            table_lock_write(state->clubs->lock);
             club->member_count--;
+            state->clubs->dirty = 1;
+            changelog_record(state->clubs->lock, CHANGE_CLUBS, CHANGE_UPDATE, club);
+            table_unlock_write(state->clubs->lock);
             
             // Show success
             GtkWidget* msg = gtk_message_dialog_new(GTK_WINDOW(parent_window),
@@ -1946,7 +1987,7 @@ void ui_populate_club_members(GtkTreeView* tree, UIState* state, Club* club) {
     if (state->memberships) {
         for (int i = 0; i < state->memberships->count; i++) {
             ClubMembership* m = &state->memberships->memberships[i];
-            if (m->club_id == club->id && m->is_active) {
+            if (m->club_id == club->id && m->is_active && !m->is_deleted) {
                 // Find student
                 Student* student = student_list_find_by_id(state->students, m->student_id);
                 if (student) {
@@ -1963,7 +2004,7 @@ void ui_populate_club_members(GtkTreeView* tree, UIState* state, Club* club) {
                         0, m->id,
                         1, m->student_id,
                         2, name,
-                        3, m->role,
+                        3, intern_lookup(m->role),
                         4, date_str,
                         -1);
                 }
@@ -2091,7 +2132,9 @@ void ui_on_add_club_placeholder(GtkButton* button, gpointer user_data) {
         new_club.id = state->clubs->count + 1;
         strncpy(new_club.name, name, MAX_CLUB_LENGTH - 1);
         strncpy(new_club.description, description, 499);
-        strncpy(new_club.category, gtk_combo_box_text_get_active_text(category_combo), 49);
+        gchar* category = gtk_combo_box_text_get_active_text(category_combo);
+        new_club.category = intern_string(category);
+        g_free(category);
         new_club.max_members = gtk_spin_button_get_value_as_int(max_spin);
         new_club.budget = gtk_spin_button_get_value(budget_spin);
         strncpy(new_club.meeting_day, gtk_combo_box_text_get_active_text(day_combo), 19);
@@ -2107,13 +2150,12 @@ void ui_on_add_club_placeholder(GtkButton* button, gpointer user_data) {
         g_free(description);
         
         if (club_list_add(state->clubs, new_club)) {
-            club_list_save_to_file(state->clubs, "clubs.txt");
             ui_show_info_message(parent_window, "Club added successfully!");
             
-            // Refresh the club list
+            // Show the new row
             GtkTreeView* tree = GTK_TREE_VIEW(g_object_get_data(G_OBJECT(parent_window), "treeview"));
             if (tree) {
-                ui_club_treeview_populate(tree, state->clubs);
+                ui_club_treeview_add_club(tree, &state->clubs->clubs[state->clubs->count - 1]);
             }
         } else {
             ui_show_error_message(parent_window, "Failed to add club!");
@@ -2199,13 +2241,14 @@ void ui_on_edit_club_placeholder(GtkButton* button, gpointer user_data) {
     gtk_combo_box_text_append_text(category_combo, "Cultural");
     
     // Set active category
-    if (strcmp(club->category, "Academic") == 0) gtk_combo_box_set_active(GTK_COMBO_BOX(category_combo), 0);
-    else if (strcmp(club->category, "Sports") == 0) gtk_combo_box_set_active(GTK_COMBO_BOX(category_combo), 1);
-    else if (strcmp(club->category, "Arts") == 0) gtk_combo_box_set_active(GTK_COMBO_BOX(category_combo), 2);
-    else if (strcmp(club->category, "Technology") == 0) gtk_combo_box_set_active(GTK_COMBO_BOX(category_combo), 3);
-    else if (strcmp(club->category, "Religious") == 0) gtk_combo_box_set_active(GTK_COMBO_BOX(category_combo), 4);
-    else if (strcmp(club->category, "Social") == 0) gtk_combo_box_set_active(GTK_COMBO_BOX(category_combo), 5);
-    else if (strcmp(club->category, "Service") == 0) gtk_combo_box_set_active(GTK_COMBO_BOX(category_combo), 6);
+    const char* category = intern_lookup(club->category);
+    if (strcmp(category, "Academic") == 0) gtk_combo_box_set_active(GTK_COMBO_BOX(category_combo), 0);
+    else if (strcmp(category, "Sports") == 0) gtk_combo_box_set_active(GTK_COMBO_BOX(category_combo), 1);
+    else if (strcmp(category, "Arts") == 0) gtk_combo_box_set_active(GTK_COMBO_BOX(category_combo), 2);
+    else if (strcmp(category, "Technology") == 0) gtk_combo_box_set_active(GTK_COMBO_BOX(category_combo), 3);
+    else if (strcmp(category, "Religious") == 0) gtk_combo_box_set_active(GTK_COMBO_BOX(category_combo), 4);
+    else if (strcmp(category, "Social") == 0) gtk_combo_box_set_active(GTK_COMBO_BOX(category_combo), 5);
+    else if (strcmp(category, "Service") == 0) gtk_combo_box_set_active(GTK_COMBO_BOX(category_combo), 6);
     else gtk_combo_box_set_active(GTK_COMBO_BOX(category_combo), 7);
     gtk_grid_attach(grid, GTK_WIDGET(category_combo), 1, 2, 1, 1);
     
@@ -2276,23 +2319,29 @@ void ui_on_edit_club_placeholder(GtkButton* button, gpointer user_data) {
         char* description = gtk_text_buffer_get_text(desc_buffer, &start, &end, FALSE);
         
         // Update club
+        gchar* category = gtk_combo_box_text_get_active_text(category_combo);
+        InternId category_id = intern_string(category);
+        g_free(category);
+        table_lock_write(state->clubs->lock);
         strncpy(club->name, name, MAX_CLUB_LENGTH - 1);
         strncpy(club->description, description, 499);
-        strncpy(club->category, gtk_combo_box_text_get_active_text(category_combo), 49);
+        club->category = category_id;
         club->max_members = gtk_spin_button_get_value_as_int(max_spin);
         club->budget = gtk_spin_button_get_value(budget_spin);
         strncpy(club->meeting_day, gtk_combo_box_text_get_active_text(day_combo), 19);
         strncpy(club->meeting_time, meeting_time, 19);
         strncpy(club->meeting_location, location, 99);
         club->is_active = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(active_check));
+        state->clubs->dirty = 1;
+        changelog_record(state->clubs->lock, CHANGE_CLUBS, CHANGE_UPDATE, club);
+        table_unlock_write(state->clubs->lock);
         
         g_free(description);
-        
-        club_list_save_to_file(state->clubs, "clubs.txt");
+
         ui_show_info_message(parent_window, "Club updated successfully!");
         
-        // Refresh the club list
-        ui_club_treeview_populate(club_tree, state->clubs);
+        // Redraw the edited row
+        ui_club_treeview_update_club(club_tree, club);
     }
     
     gtk_widget_destroy(dialog);
@@ -2336,9 +2385,8 @@ void ui_on_delete_club_placeholder(GtkButton* button, gpointer user_data) {
     
     if (response == GTK_RESPONSE_YES) {
         if (club_list_remove(state->clubs, club_id)) {
-            club_list_save_to_file(state->clubs, "clubs.txt");
             ui_show_info_message(parent_window, "Club deleted successfully!");
-            ui_club_treeview_populate(club_tree, state->clubs);
+            ui_club_treeview_remove_club(club_tree, club_id);
         } else {
             ui_show_error_message(parent_window, "Failed to delete club!");
         }
@@ -2408,6 +2456,8 @@ void ui_on_manage_members_clicked(GtkButton* button, gpointer user_data) {
     gtk_box_pack_start(button_box, GTK_WIDGET(add_btn), FALSE, FALSE, 0);
     gtk_box_pack_start(button_box, GTK_WIDGET(remove_btn), FALSE, FALSE, 0);
     gtk_box_pack_end(button_box, GTK_WIDGET(close_btn), FALSE, FALSE, 0);
+    ui_disable_if_read_only(GTK_WIDGET(add_btn), state->read_only);
+    ui_disable_if_read_only(GTK_WIDGET(remove_btn), state->read_only);
     
     // Members tree view
     GtkScrolledWindow* scrolled = GTK_SCROLLED_WINDOW(gtk_scrolled_window_new(NULL, NULL));
@@ -2526,6 +2576,9 @@ GtkWindow* ui_create_club_window(UIState* state) {
         gtk_box_pack_start(button_box, GTK_WIDGET(edit_btn), FALSE, FALSE, 0);
         gtk_box_pack_start(button_box, GTK_WIDGET(delete_btn), FALSE, FALSE, 0);
         gtk_box_pack_start(button_box, GTK_WIDGET(members_btn), FALSE, FALSE, 0);
+        ui_disable_if_read_only(GTK_WIDGET(add_btn), state->read_only);
+        ui_disable_if_read_only(GTK_WIDGET(edit_btn), state->read_only);
+        ui_disable_if_read_only(GTK_WIDGET(delete_btn), state->read_only);
         
         g_object_set_data(G_OBJECT(add_btn), "state", state);
         g_object_set_data(G_OBJECT(edit_btn), "state", state);
@@ -2549,6 +2602,8 @@ GtkWindow* ui_create_club_window(UIState* state) {
         gtk_box_pack_start(button_box, GTK_WIDGET(join_btn), FALSE, FALSE, 0);
         gtk_box_pack_start(button_box, GTK_WIDGET(leave_btn), FALSE, FALSE, 0);
         gtk_box_pack_start(button_box, GTK_WIDGET(my_clubs_btn), FALSE, FALSE, 0);
+        ui_disable_if_read_only(GTK_WIDGET(join_btn), state->read_only);
+        ui_disable_if_read_only(GTK_WIDGET(leave_btn), state->read_only);
         
         g_object_set_data(G_OBJECT(join_btn), "state", state);
         g_object_set_data(G_OBJECT(leave_btn), "state", state);
@@ -2638,9 +2693,196 @@ void ui_statistics_window_refresh_data(UIState* state) {}
 void ui_statistics_window_generate_report(UIState* state) {}
 void ui_statistics_window_export_data(UIState* state) {}
 
+// ============================================================================
+// BACKGROUND JOB PROGRESS
+// ============================================================================
+
+// Small window showing a job's progress with a Cancel button. Closing it
+// any way cancels the job.
+typedef struct {
+    GtkWidget* window;
+    GtkProgressBar* bar;
+    Job* job;
+} JobProgressWindow;
+
+static void on_job_progress_window_destroy(GtkWidget* widget, gpointer data) {
+    JobProgressWindow* progress = (JobProgressWindow*)data;
+    job_cancel(progress->job);
+    g_free(progress);
+}
+
+static JobProgressWindow* job_progress_window_open(GtkWindow* parent, const char* title) {
+    JobProgressWindow* progress = g_new0(JobProgressWindow, 1);
+    progress->window = gtk_window_new(GTK_WINDOW_TOPLEVEL);
+    gtk_window_set_title(GTK_WINDOW(progress->window), title);
+    gtk_window_set_default_size(GTK_WINDOW(progress->window), 360, -1);
+    if (parent) {
+        gtk_window_set_transient_for(GTK_WINDOW(progress->window), parent);
+        gtk_window_set_position(GTK_WINDOW(progress->window), GTK_WIN_POS_CENTER_ON_PARENT);
+    }
+    
+    GtkBox* vbox = GTK_BOX(gtk_box_new(GTK_ORIENTATION_VERTICAL, 12));
+    gtk_widget_set_margin_all(GTK_WIDGET(vbox), 16);
+    gtk_container_add(GTK_CONTAINER(progress->window), GTK_WIDGET(vbox));
+    
+    progress->bar = GTK_PROGRESS_BAR(gtk_progress_bar_new());
+    gtk_progress_bar_set_show_text(progress->bar, TRUE);
+    gtk_progress_bar_set_text(progress->bar, "Starting...");
+    gtk_box_pack_start(vbox, GTK_WIDGET(progress->bar), FALSE, FALSE, 0);
+    
+    GtkWidget* cancel_btn = gtk_button_new_with_label("Cancel");
+    gtk_widget_set_halign(cancel_btn, GTK_ALIGN_END);
+    gtk_box_pack_start(vbox, cancel_btn, FALSE, FALSE, 0);
+    g_signal_connect_swapped(cancel_btn, "clicked", G_CALLBACK(gtk_widget_destroy), progress->window);
+    
+    g_signal_connect(progress->window, "destroy", G_CALLBACK(on_job_progress_window_destroy), progress);
+    gtk_widget_show_all(progress->window);
+    return progress;
+}
+
+static void job_progress_window_update(JobProgressWindow* progress, double fraction, const char* message) {
+    gtk_progress_bar_set_fraction(progress->bar, fraction);
+    gtk_progress_bar_set_text(progress->bar, message);
+}
+
+// Called from the done callback: the job is over, so there is nothing to cancel
+static void job_progress_window_close(JobProgressWindow* progress) {
+    progress->job = NULL;
+    gtk_widget_destroy(progress->window);
+}
+
+// ============================================================================
+// TABLE EXPORT
+// ============================================================================
+
+typedef struct {
+    const void* table;
+    ExportOptions options;
+    char* columns;              // owned copy of options.columns
+    ExportExamIndex* exams;     // grades only
+    char* filename;
+    UIState* state;
+    JobProgressWindow* progress;
+    Job* job;                   // set by the worker for the progress callback
+} TableExportJob;
+
+typedef struct {
+    int ok;
+    int rows;
+} TableExportResult;
+
+static void table_export_job_free(void* data) {
+    TableExportJob* export_job = (TableExportJob*)data;
+    export_exam_index_destroy(export_job->exams);
+    g_free(export_job->columns);
+    g_free(export_job->filename);
+    g_free(export_job);
+}
+
+static int table_export_report(int rows_done, int rows_total, void* data) {
+    TableExportJob* export_job = (TableExportJob*)data;
+    char message[64];
+    snprintf(message, sizeof(message), "%d of %d rows", rows_done, rows_total);
+    job_report_progress(export_job->job, (double)rows_done / rows_total, message);
+    return !job_is_cancelled(export_job->job);
+}
+
+// Worker thread: the engine streams the table under its read lock
+static void* table_export_run(Job* job, void* data) {
+    TableExportJob* export_job = (TableExportJob*)data;
+    TableExportResult* result = g_new0(TableExportResult, 1);
+    
+    export_job->job = job;
+    export_job->options.progress = table_export_report;
+    export_job->options.user_data = export_job;
+    export_job->options.columns = export_job->columns;
+    export_job->options.exams = export_job->exams;
+    result->ok = export_table_to_file(export_job->table, &export_job->options,
+                                      export_job->filename, &result->rows);
+    return result;
+}
+
+static void table_export_progress(double fraction, const char* message, void* data) {
+    TableExportJob* export_job = (TableExportJob*)data;
+    job_progress_window_update(export_job->progress, fraction, message);
+}
+
+static void table_export_done(void* result, void* data) {
+    TableExportJob* export_job = (TableExportJob*)data;
+    TableExportResult* export_result = (TableExportResult*)result;
+    const char* what = export_kind_name(export_job->options.kind);
+    job_progress_window_close(export_job->progress);
+    
+    GtkWidget* dialog;
+    if (export_result->ok) {
+        // Show success message
+        dialog = gtk_message_dialog_new(GTK_WINDOW(export_job->state->current_window),
+            GTK_DIALOG_MODAL,
+            GTK_MESSAGE_INFO,
+            GTK_BUTTONS_OK,
+            "Successfully exported %d %s rows to %s",
+            export_result->rows, what, export_job->filename);
+    } else {
+        // Show error message
+        dialog = gtk_message_dialog_new(GTK_WINDOW(export_job->state->current_window),
+            GTK_DIALOG_MODAL,
+            GTK_MESSAGE_ERROR,
+            GTK_BUTTONS_OK,
+            "Failed to export %s to %s", what, export_job->filename);
+    }
+    gtk_dialog_run(GTK_DIALOG(dialog));
+    gtk_widget_destroy(dialog);
+    g_free(export_result);
+}
+
+// Export a table in the background behind a progress window. Takes
+// ownership of filename (g_free'd).
+static void table_export_start(UIState* state, ExportKind kind, ExportFormat format,
+                               const char* columns, ExportFilterFunc filter, char* filename) {
+    TableExportJob* export_job = g_new0(TableExportJob, 1);
+    export_job->state = state;
+    export_job->filename = filename;
+    export_job->columns = columns && columns[0] ? g_strdup(columns) : NULL;
+    export_job->options.kind = kind;
+    export_job->options.format = format;
+    export_job->options.filter = filter;
+    
+    switch (kind) {
+        case EXPORT_STUDENTS:    export_job->table = state->students; break;
+        case EXPORT_GRADES:      export_job->table = state->grades; break;
+        case EXPORT_ATTENDANCE:  export_job->table = state->attendance; break;
+        case EXPORT_CLUBS:       export_job->table = state->clubs; break;
+        case EXPORT_MEMBERSHIPS: export_job->table = state->memberships; break;
+        case EXPORT_PROF_NOTES:  export_job->table = state->prof_notes; break;
+        default: break;
+    }
+    // Exams have no lock, so the join is prepared here
+    if (kind == EXPORT_GRADES) {
+        export_job->exams = export_exam_index_build(state->exams, state->courses);
+    }
+    
+    if (!export_job->table) {
+        ui_show_error_message(GTK_WINDOW(state->current_window), "That table is not loaded");
+        table_export_job_free(export_job);
+        return;
+    }
+    
+    char title[64];
+    snprintf(title, sizeof(title), "Exporting %s", export_kind_name(kind));
+    export_job->progress = job_progress_window_open(GTK_WINDOW(state->current_window), title);
+    
+    JobProgressWindow* progress = export_job->progress;
+    const JobSpec spec = {"table export", table_export_run, table_export_done,
+                          table_export_progress, g_free, table_export_job_free};
+    progress->job = job_submit(&spec, export_job);
+    if (!progress->job) {
+        gtk_widget_destroy(progress->window);
+    }
+}
+
 void ui_on_export_students_clicked(GtkButton* button, gpointer user_data) {
     UIState* state = (UIState*)user_data;
-    if (!state || !state->students || state->students->count == 0) {
+    if (!state || !state->students || student_list_get_count(state->students) == 0) {
         GtkWidget* dialog = gtk_message_dialog_new(GTK_WINDOW(state->current_window),
             GTK_DIALOG_MODAL,
             GTK_MESSAGE_WARNING,
@@ -2664,54 +2906,114 @@ void ui_on_export_students_clicked(GtkButton* button, gpointer user_data) {
     
     if (gtk_dialog_run(GTK_DIALOG(dialog)) == GTK_RESPONSE_ACCEPT) {
         char* filename = gtk_file_chooser_get_filename(GTK_FILE_CHOOSER(dialog));
-        
-        FILE* file = fopen(filename, "w");
-        if (file) {
-            // Write CSV header
-            fprintf(file, "ID,First Name,Last Name,Email,Phone,Address,Age,Course,Year,Enrollment Date,Active\n");
-            
-            // Write student data
-            for (int i = 0; i < state->students->count; i++) {
-                Student* s = &state->students->students[i];
-                fprintf(file, "%d,\"%s\",\"%s\",\"%s\",\"%s\",\"%s\",%d,\"%s\",%d,%lld,%d\n",
-                    s->id,
-                    s->first_name,
-                    s->last_name,
-                    s->email,
-                    s->phone,
-                    s->address,
-                    s->age,
-                    s->course,
-                    s->year,
-                    (long long)s->enrollment_date,
-                    s->is_active);
-            }
-            fclose(file);
-            
-            // Show success message
-            GtkWidget* success_dialog = gtk_message_dialog_new(GTK_WINDOW(state->current_window),
-                GTK_DIALOG_MODAL,
-                GTK_MESSAGE_INFO,
-                GTK_BUTTONS_OK,
-                "Successfully exported %d students to %s",
-                state->students->count, filename);
-            gtk_dialog_run(GTK_DIALOG(success_dialog));
-            gtk_widget_destroy(success_dialog);
-        } else {
-            // Show error message
-            GtkWidget* error_dialog = gtk_message_dialog_new(GTK_WINDOW(state->current_window),
-                GTK_DIALOG_MODAL,
-                GTK_MESSAGE_ERROR,
-                GTK_BUTTONS_OK,
-                "Failed to export students to %s", filename);
-            gtk_dialog_run(GTK_DIALOG(error_dialog));
-            gtk_widget_destroy(error_dialog);
+        table_export_start(state, EXPORT_STUDENTS, EXPORT_CSV, NULL, NULL, filename);
+    }
+    
+    gtk_widget_destroy(dialog);
+}
+
+// ============================================================================
+// TABLE IMPORT
+// ============================================================================
+
+typedef struct {
+    ImportKind kind;
+    char* filename;
+    UIState* state;
+    JobProgressWindow* progress;
+} TableImportJob;
+
+static void table_import_job_free(void* data) {
+    TableImportJob* import_job = (TableImportJob*)data;
+    g_free(import_job->filename);
+    g_free(import_job);
+}
+
+static void table_import_result_free(void* result) {
+    import_batch_destroy((ImportBatch*)result);
+}
+
+// Worker thread: reading and validating touch no table
+static void* table_import_run(Job* job, void* data) {
+    TableImportJob* import_job = (TableImportJob*)data;
+    job_report_progress(job, 0.0, "Reading and checking rows");
+    return import_parse_file(import_job->kind, import_job->filename);
+}
+
+static void table_import_progress(double fraction, const char* message, void* data) {
+    TableImportJob* import_job = (TableImportJob*)data;
+    job_progress_window_update(import_job->progress, fraction, message);
+}
+
+// Main thread: apply the whole batch, rebuild the indexes and save once
+static void table_import_done(void* result, void* data) {
+    TableImportJob* import_job = (TableImportJob*)data;
+    ImportBatch* batch = (ImportBatch*)result;
+    UIState* state = import_job->state;
+    const char* what = import_kind_name(import_job->kind);
+    job_progress_window_update(import_job->progress, 1.0, "Applying rows");
+    
+    ImportTargets targets = {state->students, state->grades, state->attendance, state->exams};
+    if (!batch || !import_batch_apply(batch, &targets)) {
+        job_progress_window_close(import_job->progress);
+        char message[320];
+        snprintf(message, sizeof(message), "Failed to import %s from %s (see the log)", what, import_job->filename);
+        ui_show_error_message(GTK_WINDOW(state->current_window), message);
+        import_batch_destroy(batch);
+        return;
+    }
+    
+    const ImportCounts* counts = import_batch_counts(batch);
+    if (import_job->kind == IMPORT_STUDENTS && counts->inserted + counts->updated > 0) {
+        search_index_build(state->student_search, state->students);
+        completion_index_build(state->completer, state->students, state->professors, state->users);
+    }
+    if (counts->inserted + counts->updated > 0) {
+        autosave_now();
+    }
+    
+    char* report = NULL;
+    if (counts->rejected > 0) {
+        report = g_strconcat(import_job->filename, ".rejected.csv", NULL);
+        if (!import_batch_write_rejects(batch, report)) {
+            g_free(report);
+            report = NULL;
         }
-        
-        g_free(filename);
     }
+    job_progress_window_close(import_job->progress);
     
+    GtkWidget* dialog = gtk_message_dialog_new(GTK_WINDOW(state->current_window),
+        GTK_DIALOG_MODAL,
+        counts->rejected > 0 ? GTK_MESSAGE_WARNING : GTK_MESSAGE_INFO,
+        GTK_BUTTONS_OK,
+        "Imported %s from %s\n\n%d rows read, %d added, %d updated, %d rejected%s%s",
+        what, import_job->filename, counts->rows, counts->inserted, counts->updated, counts->rejected,
+        report ? "\nRejected rows: " : "", report ? report : "");
+    gtk_dialog_run(GTK_DIALOG(dialog));
     gtk_widget_destroy(dialog);
+    g_free(report);
+    import_batch_destroy(batch);
+}
+
+// Import a CSV file in the background behind a progress window. Takes
+// ownership of filename (g_free'd).
+static void table_import_start(UIState* state, ImportKind kind, char* filename) {
+    TableImportJob* import_job = g_new0(TableImportJob, 1);
+    import_job->state = state;
+    import_job->kind = kind;
+    import_job->filename = filename;
+    
+    char title[64];
+    snprintf(title, sizeof(title), "Importing %s", import_kind_name(kind));
+    import_job->progress = job_progress_window_open(GTK_WINDOW(state->current_window), title);
+    
+    JobProgressWindow* progress = import_job->progress;
+    const JobSpec spec = {"table import", table_import_run, table_import_done,
+                          table_import_progress, table_import_result_free, table_import_job_free};
+    progress->job = job_submit(&spec, import_job);
+    if (!progress->job) {
+        gtk_widget_destroy(progress->window);
+    }
 }
 
 // ============================================================================
@@ -2824,6 +3126,8 @@ static void on_admin_add_user_clicked(GtkButton* btn, gpointer data) {
     
     GtkWidget* username_entry = gtk_entry_new();
     gtk_entry_set_placeholder_text(GTK_ENTRY(username_entry), "Username");
+    // Suggest existing usernames so duplicates are spotted while typing
+    ui_entry_attach_completion(GTK_ENTRY(username_entry), state->completer, COMPLETE_USER);
     gtk_box_pack_start(content, gtk_label_new("Username:"), FALSE, FALSE, 0);
     gtk_box_pack_start(content, username_entry, FALSE, FALSE, 0);
     
@@ -2869,7 +3173,7 @@ static void on_admin_add_user_clicked(GtkButton* btn, gpointer data) {
             new_user.is_active = 1;
             
             if (user_list_add(state->users, new_user) > 0) {
-                user_list_save_to_file(state->users, "users.txt");
+                completion_index_add_user(state->completer, &new_user);
                 ui_show_info_message(GTK_WINDOW(gtk_widget_get_toplevel(GTK_WIDGET(btn))), 
                                     "User added successfully!");
             } else {
@@ -2882,6 +3186,15 @@ static void on_admin_add_user_clicked(GtkButton* btn, gpointer data) {
     gtk_widget_destroy(dialog);
 }
 
+// Picking a username suggestion fills in its id
+static gboolean on_admin_user_match_selected(GtkEntryCompletion* completion, GtkTreeModel* model,
+                                             GtkTreeIter* iter, gpointer data) {
+    int user_id = 0;
+    gtk_tree_model_get(model, iter, 1, &user_id, -1);
+    gtk_spin_button_set_value(GTK_SPIN_BUTTON(data), user_id);
+    return FALSE;
+}
+
 static void on_admin_delete_user_clicked(GtkButton* btn, gpointer data) {
     UIState* state = (UIState*)data;
     
@@ -2896,11 +3209,23 @@ static void on_admin_delete_user_clicked(GtkButton* btn, gpointer data) {
     gtk_box_set_spacing(content, 12);
     gtk_widget_set_margin_all(GTK_WIDGET(content), 12);
     
+    gtk_box_pack_start(content, gtk_label_new("Find user by name or e-mail:"), FALSE, FALSE, 0);
+    
+    GtkWidget* user_entry = gtk_entry_new();
+    gtk_entry_set_placeholder_text(GTK_ENTRY(user_entry), "Username");
+    gtk_box_pack_start(content, user_entry, FALSE, FALSE, 0);
+    
     gtk_box_pack_start(content, gtk_label_new("Enter User ID to delete:"), FALSE, FALSE, 0);
     
     GtkWidget* id_spin = gtk_spin_button_new_with_range(1, 10000, 1);
     gtk_box_pack_start(content, id_spin, FALSE, FALSE, 0);
     
+    ui_entry_attach_completion(GTK_ENTRY(user_entry), state->completer, COMPLETE_USER);
+    GtkEntryCompletion* user_completion = gtk_entry_get_completion(GTK_ENTRY(user_entry));
+    if (user_completion) {
+        g_signal_connect(user_completion, "match-selected", G_CALLBACK(on_admin_user_match_selected), id_spin);
+    }
+    
     gtk_widget_show_all(dialog);
     
     int response = gtk_dialog_run(GTK_DIALOG(dialog));
@@ -2911,7 +3236,7 @@ static void on_admin_delete_user_clicked(GtkButton* btn, gpointer data) {
             ui_show_error_message(GTK_WINDOW(gtk_widget_get_toplevel(GTK_WIDGET(btn))), 
                                  "Cannot delete currently logged in user!");
         } else if (user_list_remove(state->users, user_id)) {
-            user_list_save_to_file(state->users, "users.txt");
+            completion_index_remove(state->completer, COMPLETE_USER, user_id);
             ui_show_info_message(GTK_WINDOW(gtk_widget_get_toplevel(GTK_WIDGET(btn))), 
                                 "User deleted successfully!");
         } else {
@@ -2955,9 +3280,12 @@ static void on_admin_reset_password_clicked(GtkButton* btn, gpointer data) {
         
         User* user = user_list_find_by_id(state->users, user_id);
         if (user && strlen(new_password) > 0) {
+            table_lock_write(state->users->lock);
             auth_generate_salt(user->salt);
             auth_hash_password(new_password, user->salt, user->password_hash);
-            user_list_save_to_file(state->users, "users.txt");
+            state->users->dirty = 1;
+            changelog_record(state->users->lock, CHANGE_USERS, CHANGE_UPDATE, user);
+            table_unlock_write(state->users->lock);
             ui_show_info_message(GTK_WINDOW(gtk_widget_get_toplevel(GTK_WIDGET(btn))), 
                                 "Password reset successfully!");
         } else {
@@ -2974,33 +3302,338 @@ static void on_admin_manage_roles_clicked(GtkButton* btn, gpointer data) {
                         "Role management interface - Feature coming soon!");
 }
 
+typedef struct {
+    UIState* state;
+    char* data_dir;
+    char* repo_dir;
+    char* snapshot;             // restore only
+    char* target_dir;           // restore only
+    JobProgressWindow* progress;
+    Job* job;                   // set by the worker for the progress callback
+} BackupJob;
+
+typedef struct {
+    int ok;
+    char* snapshot;             // the new one after a backup
+    BackupStats stats;
+} BackupResult;
+
+static void backup_job_free(void* data) {
+    BackupJob* backup_job = (BackupJob*)data;
+    g_free(backup_job->data_dir);
+    g_free(backup_job->repo_dir);
+    g_free(backup_job->snapshot);
+    g_free(backup_job->target_dir);
+    g_free(backup_job);
+}
+
+static void backup_result_free(void* data) {
+    BackupResult* result = (BackupResult*)data;
+    g_free(result->snapshot);
+    g_free(result);
+}
+
+static int backup_job_report(int files_done, int files_total, void* data) {
+    BackupJob* backup_job = (BackupJob*)data;
+    char message[64];
+    snprintf(message, sizeof(message), "%d of %d files", files_done, files_total);
+    job_report_progress(backup_job->job, (double)files_done / files_total, message);
+    return !job_is_cancelled(backup_job->job);
+}
+
+// Worker thread: only files are read and written, no table is touched
+static void* backup_run(Job* job, void* data) {
+    BackupJob* backup_job = (BackupJob*)data;
+    BackupResult* result = g_new0(BackupResult, 1);
+    backup_job->job = job;
+    
+    if (backup_job->snapshot) {
+        result->ok = backup_restore(backup_job->repo_dir, backup_job->snapshot, backup_job->target_dir,
+                                    &result->stats, backup_job_report, backup_job);
+    } else {
+        result->snapshot = backup_create(backup_job->data_dir, backup_job->repo_dir,
+                                         &result->stats, backup_job_report, backup_job);
+        result->ok = result->snapshot != NULL;
+    }
+    return result;
+}
+
+static void backup_progress(double fraction, const char* message, void* data) {
+    BackupJob* backup_job = (BackupJob*)data;
+    job_progress_window_update(backup_job->progress, fraction, message);
+}
+
+static void backup_done(void* result, void* data) {
+    BackupJob* backup_job = (BackupJob*)data;
+    BackupResult* backup_result = (BackupResult*)result;
+    const BackupStats* stats = &backup_result->stats;
+    job_progress_window_close(backup_job->progress);
+    
+    GtkWidget* dialog;
+    if (!backup_result->ok && backup_job->snapshot) {
+        dialog = gtk_message_dialog_new(GTK_WINDOW(backup_job->state->current_window),
+            GTK_DIALOG_MODAL, GTK_MESSAGE_ERROR, GTK_BUTTONS_OK,
+            "Failed to restore backup %s (see the log)", backup_job->snapshot);
+    } else if (!backup_result->ok) {
+        dialog = gtk_message_dialog_new(GTK_WINDOW(backup_job->state->current_window),
+            GTK_DIALOG_MODAL, GTK_MESSAGE_ERROR, GTK_BUTTONS_OK,
+            "Backup failed (see the log)");
+    } else if (backup_job->snapshot) {
+        dialog = gtk_message_dialog_new(GTK_WINDOW(backup_job->state->current_window),
+            GTK_DIALOG_MODAL, GTK_MESSAGE_INFO, GTK_BUTTONS_OK,
+            "Restored backup %s (%d files, %lld KB) to:\n%s\n\n"
+            "Copy the files into the data folder while the application is closed to use them.",
+            backup_job->snapshot, stats->files, stats->bytes / 1024, backup_job->target_dir);
+    } else {
+        dialog = gtk_message_dialog_new(GTK_WINDOW(backup_job->state->current_window),
+            GTK_DIALOG_MODAL, GTK_MESSAGE_INFO, GTK_BUTTONS_OK,
+            "Backup %s created\n\n%d files (%lld KB), %d changed since the last backup\n"
+            "%d new chunks stored (%lld KB)",
+            backup_result->snapshot, stats->files, stats->bytes / 1024, stats->files_read,
+            stats->chunks_written, stats->bytes_written / 1024);
+    }
+    gtk_dialog_run(GTK_DIALOG(dialog));
+    gtk_widget_destroy(dialog);
+    backup_result_free(backup_result);
+}
+
+// Back up the data folder, or restore snapshot into the restore folder,
+// in the background. Takes ownership of snapshot (g_free'd).
+static void backup_start(UIState* state, char* snapshot) {
+    char path[512];
+    BackupJob* backup_job = g_new0(BackupJob, 1);
+    backup_job->state = state;
+    utils_get_data_file_path("", path, sizeof(path));
+    backup_job->data_dir = g_strdup(path);
+    utils_get_data_file_path(BACKUP_DIR, path, sizeof(path));
+    backup_job->repo_dir = g_strdup(path);
+    backup_job->snapshot = snapshot;
+    if (snapshot) {
+        char* restore_dir = g_build_filename("restore", snapshot, NULL);
+        utils_get_data_file_path(restore_dir, path, sizeof(path));
+        backup_job->target_dir = g_strdup(path);
+        g_free(restore_dir);
+    }
+    
+    backup_job->progress = job_progress_window_open(GTK_WINDOW(state->current_window),
+                                                    snapshot ? "Restoring Backup" : "Backing Up");
+    JobProgressWindow* progress = backup_job->progress;
+    const JobSpec spec = {"backup", backup_run, backup_done, backup_progress,
+                          backup_result_free, backup_job_free};
+    progress->job = job_submit(&spec, backup_job);
+    if (!progress->job) {
+        gtk_widget_destroy(progress->window);
+    }
+}
+
+enum { BACKUP_RESPONSE_RESTORE = 1 };
+
 static void on_admin_backup_clicked(GtkButton* btn, gpointer data) {
     UIState* state = (UIState*)data;
+    if (!state) return;
+    GtkWindow* parent = GTK_WINDOW(gtk_widget_get_toplevel(GTK_WIDGET(btn)));
+    
+    char repo_dir[512];
+    utils_get_data_file_path(BACKUP_DIR, repo_dir, sizeof(repo_dir));
+    int snapshot_count = 0;
+    char** snapshots = backup_list_snapshots(repo_dir, &snapshot_count);
+    
+    GtkWidget* dialog = gtk_dialog_new_with_buttons("Backup", parent,
+        GTK_DIALOG_MODAL | GTK_DIALOG_DESTROY_WITH_PARENT,
+        "Cancel", GTK_RESPONSE_CANCEL,
+        "Restore Selected", BACKUP_RESPONSE_RESTORE,
+        "Back Up Now", GTK_RESPONSE_ACCEPT,
+        NULL);
+    gtk_dialog_set_response_sensitive(GTK_DIALOG(dialog), BACKUP_RESPONSE_RESTORE, snapshot_count > 0);
+    
+    GtkGrid* grid = GTK_GRID(gtk_grid_new());
+    gtk_grid_set_row_spacing(grid, 8);
+    gtk_grid_set_column_spacing(grid, 12);
+    gtk_widget_set_margin_all(GTK_WIDGET(grid), 12);
+    gtk_container_add(GTK_CONTAINER(gtk_dialog_get_content_area(GTK_DIALOG(dialog))), GTK_WIDGET(grid));
+    
+    GtkWidget* snapshot_combo = gtk_combo_box_text_new();
+    for (int i = 0; i < snapshot_count; i++) {
+        gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(snapshot_combo), snapshots[i]);
+    }
+    gtk_combo_box_set_active(GTK_COMBO_BOX(snapshot_combo), snapshot_count > 0 ? 0 : -1);
     
-    char backup_subdir[256];
-    time_t now = time(NULL);
-    struct tm* t = localtime(&now);
-    snprintf(backup_subdir, sizeof(backup_subdir), "backups/backup_%04d%02d%02d_%02d%02d%02d",
-             t->tm_year + 1900, t->tm_mon + 1, t->tm_mday,
-             t->tm_hour, t->tm_min, t->tm_sec);
+    GtkWidget* hint = gtk_label_new("Only data changed since the last backup is stored.\n"
+                                    "A restore writes the snapshot to the restore folder.");
+    gtk_label_set_xalign(GTK_LABEL(hint), 0.0);
     
-    char backup_dir[512];
-    utils_get_data_file_path(backup_subdir, backup_dir, sizeof(backup_dir));
+    gtk_grid_attach(grid, gtk_label_new("Snapshots"), 0, 0, 1, 1);
+    gtk_grid_attach(grid, snapshot_combo, 1, 0, 1, 1);
+    gtk_grid_attach(grid, hint, 0, 1, 2, 1);
+    gtk_widget_show_all(dialog);
+    
+    int response = gtk_dialog_run(GTK_DIALOG(dialog));
+    int selected = gtk_combo_box_get_active(GTK_COMBO_BOX(snapshot_combo));
+    gtk_widget_destroy(dialog);
     
-    // Create backup message
-    char msg[256];
-    snprintf(msg, sizeof(msg), "Backup would be created at:\n%s\n\nFeature ready for implementation!", backup_dir);
-    ui_show_info_message(GTK_WINDOW(gtk_widget_get_toplevel(GTK_WIDGET(btn))), msg);
+    if (response == GTK_RESPONSE_ACCEPT) {
+        backup_start(state, NULL);
+    } else if (response == BACKUP_RESPONSE_RESTORE && selected >= 0 && selected < snapshot_count) {
+        backup_start(state, g_strdup(snapshots[selected]));
+    }
+    g_strfreev(snapshots);
+}
+
+// Filter for "Active records only"; tables without an active flag keep everything
+static int export_filter_active_students(const void* record, void* data) {
+    return ((const Student*)record)->is_active;
+}
+
+static int export_filter_active_clubs(const void* record, void* data) {
+    return ((const Club*)record)->is_active;
+}
+
+static int export_filter_active_memberships(const void* record, void* data) {
+    return ((const ClubMembership*)record)->is_active;
 }
 
 static void on_admin_export_clicked(GtkButton* btn, gpointer data) {
-    ui_show_info_message(GTK_WINDOW(gtk_widget_get_toplevel(GTK_WIDGET(btn))), 
-                        "Export all data to CSV/JSON - Feature coming soon!");
+    UIState* state = (UIState*)data;
+    if (!state) return;
+    GtkWindow* parent = GTK_WINDOW(gtk_widget_get_toplevel(GTK_WIDGET(btn)));
+    
+    GtkWidget* dialog = gtk_dialog_new_with_buttons("Export Data", parent,
+        GTK_DIALOG_MODAL | GTK_DIALOG_DESTROY_WITH_PARENT,
+        "Cancel", GTK_RESPONSE_CANCEL,
+        "Export", GTK_RESPONSE_ACCEPT,
+        NULL);
+    
+    GtkGrid* grid = GTK_GRID(gtk_grid_new());
+    gtk_grid_set_row_spacing(grid, 8);
+    gtk_grid_set_column_spacing(grid, 12);
+    gtk_widget_set_margin_all(GTK_WIDGET(grid), 12);
+    gtk_container_add(GTK_CONTAINER(gtk_dialog_get_content_area(GTK_DIALOG(dialog))), GTK_WIDGET(grid));
+    
+    GtkWidget* table_combo = gtk_combo_box_text_new();
+    for (int kind = 0; kind < EXPORT_KIND_COUNT; kind++) {
+        gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(table_combo), export_kind_name(kind));
+    }
+    gtk_combo_box_set_active(GTK_COMBO_BOX(table_combo), EXPORT_STUDENTS);
+    
+    GtkWidget* format_combo = gtk_combo_box_text_new();
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(format_combo), "CSV");
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(format_combo), "NDJSON (one JSON object per line)");
+    gtk_combo_box_set_active(GTK_COMBO_BOX(format_combo), EXPORT_CSV);
+    
+    GtkWidget* columns_entry = gtk_entry_new();
+    gtk_entry_set_placeholder_text(GTK_ENTRY(columns_entry), "All columns, or e.g. id,email");
+    
+    GtkWidget* active_check = gtk_check_button_new_with_label("Active records only");
+    
+    gtk_grid_attach(grid, gtk_label_new("Table"), 0, 0, 1, 1);
+    gtk_grid_attach(grid, table_combo, 1, 0, 1, 1);
+    gtk_grid_attach(grid, gtk_label_new("Format"), 0, 1, 1, 1);
+    gtk_grid_attach(grid, format_combo, 1, 1, 1, 1);
+    gtk_grid_attach(grid, gtk_label_new("Columns"), 0, 2, 1, 1);
+    gtk_grid_attach(grid, columns_entry, 1, 2, 1, 1);
+    gtk_grid_attach(grid, active_check, 1, 3, 1, 1);
+    gtk_widget_show_all(dialog);
+    
+    if (gtk_dialog_run(GTK_DIALOG(dialog)) != GTK_RESPONSE_ACCEPT) {
+        gtk_widget_destroy(dialog);
+        return;
+    }
+    
+    ExportKind kind = (ExportKind)gtk_combo_box_get_active(GTK_COMBO_BOX(table_combo));
+    ExportFormat format = (ExportFormat)gtk_combo_box_get_active(GTK_COMBO_BOX(format_combo));
+    char* columns = g_strdup(gtk_entry_get_text(GTK_ENTRY(columns_entry)));
+    ExportFilterFunc filter = NULL;
+    if (gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(active_check))) {
+        if (kind == EXPORT_STUDENTS) filter = export_filter_active_students;
+        else if (kind == EXPORT_CLUBS) filter = export_filter_active_clubs;
+        else if (kind == EXPORT_MEMBERSHIPS) filter = export_filter_active_memberships;
+    }
+    gtk_widget_destroy(dialog);
+    
+    // Check the column list now rather than fail in the background
+    if (!export_columns_check(kind, columns)) {
+        char message[320];
+        snprintf(message, sizeof(message), "Unknown column in \"%s\" for %s", columns, export_kind_name(kind));
+        g_free(columns);
+        ui_show_error_message(parent, message);
+        return;
+    }
+    
+    GtkWidget* chooser = gtk_file_chooser_dialog_new("Export To",
+        parent,
+        GTK_FILE_CHOOSER_ACTION_SAVE,
+        "Cancel", GTK_RESPONSE_CANCEL,
+        "Export", GTK_RESPONSE_ACCEPT,
+        NULL);
+    char default_name[64];
+    snprintf(default_name, sizeof(default_name), "%s_export.%s",
+             export_kind_name(kind), format == EXPORT_NDJSON ? "ndjson" : "csv");
+    gtk_file_chooser_set_do_overwrite_confirmation(GTK_FILE_CHOOSER(chooser), TRUE);
+    gtk_file_chooser_set_current_name(GTK_FILE_CHOOSER(chooser), default_name);
+    
+    if (gtk_dialog_run(GTK_DIALOG(chooser)) == GTK_RESPONSE_ACCEPT) {
+        char* filename = gtk_file_chooser_get_filename(GTK_FILE_CHOOSER(chooser));
+        table_export_start(state, kind, format, columns, filter, filename);
+    }
+    gtk_widget_destroy(chooser);
+    g_free(columns);
 }
 
 static void on_admin_import_clicked(GtkButton* btn, gpointer data) {
-    ui_show_info_message(GTK_WINDOW(gtk_widget_get_toplevel(GTK_WIDGET(btn))), 
-                        "Import data from external files - Feature coming soon!");
+    UIState* state = (UIState*)data;
+    if (!state) return;
+    GtkWindow* parent = GTK_WINDOW(gtk_widget_get_toplevel(GTK_WIDGET(btn)));
+    
+    GtkWidget* dialog = gtk_dialog_new_with_buttons("Import Data", parent,
+        GTK_DIALOG_MODAL | GTK_DIALOG_DESTROY_WITH_PARENT,
+        "Cancel", GTK_RESPONSE_CANCEL,
+        "Choose File...", GTK_RESPONSE_ACCEPT,
+        NULL);
+    
+    GtkGrid* grid = GTK_GRID(gtk_grid_new());
+    gtk_grid_set_row_spacing(grid, 8);
+    gtk_grid_set_column_spacing(grid, 12);
+    gtk_widget_set_margin_all(GTK_WIDGET(grid), 12);
+    gtk_container_add(GTK_CONTAINER(gtk_dialog_get_content_area(GTK_DIALOG(dialog))), GTK_WIDGET(grid));
+    
+    GtkWidget* table_combo = gtk_combo_box_text_new();
+    for (int kind = 0; kind < IMPORT_KIND_COUNT; kind++) {
+        gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(table_combo), import_kind_name(kind));
+    }
+    gtk_combo_box_set_active(GTK_COMBO_BOX(table_combo), IMPORT_STUDENTS);
+    
+    GtkWidget* hint = gtk_label_new("CSV with a header row naming the columns, as written by Export.\n"
+                                    "Existing records are updated, new ones added.");
+    gtk_label_set_xalign(GTK_LABEL(hint), 0.0);
+    
+    gtk_grid_attach(grid, gtk_label_new("Table"), 0, 0, 1, 1);
+    gtk_grid_attach(grid, table_combo, 1, 0, 1, 1);
+    gtk_grid_attach(grid, hint, 0, 1, 2, 1);
+    gtk_widget_show_all(dialog);
+    
+    if (gtk_dialog_run(GTK_DIALOG(dialog)) != GTK_RESPONSE_ACCEPT) {
+        gtk_widget_destroy(dialog);
+        return;
+    }
+    ImportKind kind = (ImportKind)gtk_combo_box_get_active(GTK_COMBO_BOX(table_combo));
+    gtk_widget_destroy(dialog);
+    
+    GtkWidget* chooser = gtk_file_chooser_dialog_new("Import From",
+        parent,
+        GTK_FILE_CHOOSER_ACTION_OPEN,
+        "Cancel", GTK_RESPONSE_CANCEL,
+        "Import", GTK_RESPONSE_ACCEPT,
+        NULL);
+    GtkFileFilter* csv_filter = gtk_file_filter_new();
+    gtk_file_filter_set_name(csv_filter, "CSV files");
+    gtk_file_filter_add_pattern(csv_filter, "*.csv");
+    gtk_file_chooser_add_filter(GTK_FILE_CHOOSER(chooser), csv_filter);
+    
+    if (gtk_dialog_run(GTK_DIALOG(chooser)) == GTK_RESPONSE_ACCEPT) {
+        char* filename = gtk_file_chooser_get_filename(GTK_FILE_CHOOSER(chooser));
+        table_import_start(state, kind, filename);
+    }
+    gtk_widget_destroy(chooser);
 }
 
 static void on_admin_clear_cache_clicked(GtkButton* btn, gpointer data) {
@@ -3018,6 +3651,227 @@ static void on_admin_system_settings_clicked(GtkButton* btn, gpointer data) {
                         "System configuration panel - Feature coming soon!");
 }
 
+static void on_admin_club_overlap_clicked(GtkButton* btn, gpointer data) {
+    UIState* state = (UIState*)data;
+    if (!state || !state->clubs) return;
+    
+    GtkComboBox* club_a_combo = GTK_COMBO_BOX(g_object_get_data(G_OBJECT(btn), "club_a_combo"));
+    GtkComboBox* club_b_combo = GTK_COMBO_BOX(g_object_get_data(G_OBJECT(btn), "club_b_combo"));
+    GtkComboBox* op_combo = GTK_COMBO_BOX(g_object_get_data(G_OBJECT(btn), "op_combo"));
+    GtkLabel* result_label = GTK_LABEL(g_object_get_data(G_OBJECT(btn), "result_label"));
+    
+    const char* id_a = gtk_combo_box_get_active_id(club_a_combo);
+    const char* id_b = gtk_combo_box_get_active_id(club_b_combo);
+    if (!id_a || !id_b) {
+        gtk_label_set_text(result_label, "Select two clubs");
+        return;
+    }
+    
+    // Built once at startup and kept in step with every membership change
+    if (!state->club_rosters) {
+        gtk_label_set_text(result_label, "Club rosters unavailable");
+        return;
+    }
+    
+    ClubSetOp op = (ClubSetOp)gtk_combo_box_get_active(op_combo);
+    int count = club_roster_query(state->club_rosters, atoi(id_a), atoi(id_b), op, NULL);
+    
+    char result_text[128];
+    snprintf(result_text, sizeof(result_text), "%d student(s)", count < 0 ? 0 : count);
+    gtk_label_set_text(result_label, result_text);
+}
+
+// ============================================================================
+// SYSTEM HEALTH
+// ============================================================================
+
+static void admin_health_append_size(GString* text, size_t bytes) {
+    char* size = g_format_size((guint64)bytes);
+    g_string_append_printf(text, "%12s", size);
+    g_free(size);
+}
+
+static char* admin_health_text(const MetricsSample* sample) {
+    GString* text = g_string_new("Process\n");
+    char* size;
+
+    size = g_format_size((guint64)sample->rss_bytes);
+    g_string_append_printf(text, "  Resident memory   %s\n", size);
+    g_free(size);
+    g_string_append_printf(text, "  CPU               %.1f %% of one core\n", sample->cpu_percent);
+    g_string_append_printf(text, "  Uptime            %ldh %02ldm %02lds\n", sample->uptime_seconds / 3600,
+                           sample->uptime_seconds / 60 % 60, sample->uptime_seconds % 60);
+    size = g_format_size((guint64)sample->arena_bytes);
+    g_string_append_printf(text, "  Arenas            %s\n", size);
+    g_free(size);
+    if (sample->disk_total_bytes > 0) {
+        char* free_size = g_format_size((guint64)sample->disk_free_bytes);
+        size = g_format_size((guint64)sample->disk_total_bytes);
+        g_string_append_printf(text, "  Data disk         %s free of %s\n", free_size, size);
+        g_free(free_size);
+        g_free(size);
+    }
+
+    g_string_append_printf(text, "\n%-18s %10s %10s %12s %12s\n", "Table", "Rows", "Capacity", "In use", "Allocated");
+    for (int i = 0; i < sample->n_tables; i++) {
+        const MetricsTableUsage* usage = &sample->tables[i];
+        g_string_append_printf(text, "  %-16s %10d %10d ", usage->name, usage->rows, usage->capacity);
+        admin_health_append_size(text, usage->bytes_used);
+        g_string_append_c(text, ' ');
+        admin_health_append_size(text, usage->bytes_reserved);
+        g_string_append_c(text, '\n');
+    }
+    g_string_append_printf(text, "  %-16s %10s %10s ", "total", "", "");
+    admin_health_append_size(text, sample->table_bytes_used);
+    g_string_append_c(text, ' ');
+    admin_health_append_size(text, sample->table_bytes_reserved);
+    g_string_append_c(text, '\n');
+
+    ReplicationStatus replication;
+    replication_get_status(&replication);
+    if (replication.role == REPLICATION_PRIMARY) {
+        g_string_append(text, "\nReplication (primary)\n");
+        g_string_append_printf(text, "  Followers         %d\n", replication.connected);
+        g_string_append_printf(text, "  Changes logged    %llu\n", (unsigned long long)replication.lsn);
+        g_string_append_printf(text, "  Slowest behind by %llu changes\n", (unsigned long long)replication.behind);
+    } else if (replication.role == REPLICATION_FOLLOWER) {
+        g_string_append(text, "\nReplication (follower, read-only)\n");
+        g_string_append_printf(text, "  Primary           %s\n", replication.connected ? "connected" : "not connected");
+        g_string_append_printf(text, "  Changes applied   %llu of %llu\n", (unsigned long long)replication.lsn,
+                               (unsigned long long)replication.primary_lsn);
+    }
+    if (replication.role != REPLICATION_OFF) {
+        g_string_append_printf(text, "  Lag               %.0f ms (max %.0f ms)\n", replication.lag_ms,
+                               replication.max_lag_ms);
+        size = g_format_size(replication.bytes);
+        g_string_append_printf(text, "  Snapshots         %llu, %s streamed\n", (unsigned long long)replication.snapshots, size);
+        g_free(size);
+    }
+    return g_string_free(text, FALSE);
+}
+
+static gboolean admin_health_refresh(gpointer data) {
+    GtkTextBuffer* buffer = GTK_TEXT_BUFFER(data);
+    MetricsSample sample;
+    metrics_sample(&sample, g_object_get_data(G_OBJECT(buffer), "cpu-sampler"));
+    char* text = admin_health_text(&sample);
+    gtk_text_buffer_set_text(buffer, text, -1);
+    g_free(text);
+    return G_SOURCE_CONTINUE;
+}
+
+static void on_admin_health_destroy(GtkWidget* widget, gpointer data) {
+    (void)widget;
+    g_source_remove(GPOINTER_TO_UINT(data));
+}
+
+// ============================================================================
+// ADMIN VIEW LOADING
+// ============================================================================
+
+// Widgets filled in once the background load is done; owned by the window
+typedef struct {
+    GtkTextBuffer* users_buffer;
+    GtkLabel* roster_label;
+    Job* job;
+} AdminViewLoad;
+
+typedef struct {
+    UIState* state;
+    AdminViewLoad* view;
+} AdminViewJob;
+
+typedef struct {
+    char* users_text;
+    char* roster_text;          // NULL when there are no clubs
+} AdminViewData;
+
+static void admin_view_data_free(void* p) {
+    AdminViewData* loaded = (AdminViewData*)p;
+    g_free(loaded->users_text);
+    g_free(loaded->roster_text);
+    g_free(loaded);
+}
+
+static char* admin_view_users_text(UserList* users) {
+    table_lock_read(users ? users->lock : NULL);
+    if (!users || users->count - users->tombstones.dead <= 0) {
+        table_unlock_read(users ? users->lock : NULL);
+        return g_strdup("No users data available.");
+    }
+    
+    GString* users_content = g_string_new("");
+    g_string_append_printf(users_content, "Total Users: %d\n\n",
+                           users->count - users->tombstones.dead);
+    g_string_append(users_content, "ID    | Username           | Email                          | Role    | Password Hash\n");
+    g_string_append(users_content, "------+--------------------+--------------------------------+---------+----------------------------------\n");
+    
+    for (int i = 0; i < users->count; i++) {
+        User* user = &users->users[i];
+        if (user->is_deleted) continue;
+        const char* role_str = (user->role == ROLE_ADMIN) ? "Admin" : 
+                               (user->role == ROLE_TEACHER) ? "Teacher" : "Student";
+        
+        g_string_append_printf(users_content, 
+            "%-5d | %-18s | %-30s | %-7s | %.32s...\n",
+            user->id, user->username, user->email, role_str, user->password_hash);
+    }
+    table_unlock_read(users->lock);
+    return g_string_free(users_content, FALSE);
+}
+
+// The roster index needs clubs and memberships together, so it is built
+// from copies rather than by holding two read locks
+static char* admin_view_roster_text(UIState* state) {
+    ClubList* clubs = club_list_snapshot(state->clubs);
+    MembershipList* memberships = membership_list_snapshot(state->memberships);
+    ClubRosterIndex* rosters = clubs ? club_roster_index_build(clubs, memberships) : NULL;
+    club_list_destroy(clubs);
+    membership_list_destroy(memberships);
+    if (!rosters) return NULL;
+    
+    table_lock_read(state->students ? state->students->lock : NULL);
+    int in_no_club = club_roster_count_in_no_club(rosters, state->students);
+    table_unlock_read(state->students ? state->students->lock : NULL);
+    
+    char* text = g_strdup_printf("Students in at least one club: %d\n"
+                                 "Students in two or more clubs: %d\n"
+                                 "Students in no club: %d",
+                                 club_roster_count_in_at_least(rosters, 1),
+                                 club_roster_count_in_at_least(rosters, 2),
+                                 in_no_club);
+    club_roster_index_destroy(rosters);
+    return text;
+}
+
+static void* admin_view_load_run(Job* job, void* data) {
+    UIState* state = ((AdminViewJob*)data)->state;
+    AdminViewData* loaded = g_new0(AdminViewData, 1);
+    
+    loaded->users_text = admin_view_users_text(state->users);
+    job_report_progress(job, 0.5, "Counting club members");
+    if (state->clubs && !job_is_cancelled(job)) {
+        loaded->roster_text = admin_view_roster_text(state);
+    }
+    return loaded;
+}
+
+static void admin_view_load_done(void* result, void* data) {
+    AdminViewLoad* view = ((AdminViewJob*)data)->view;
+    AdminViewData* loaded = (AdminViewData*)result;
+    view->job = NULL;
+    
+    gtk_text_buffer_set_text(view->users_buffer, loaded->users_text, -1);
+    gtk_label_set_text(view->roster_label, loaded->roster_text ? loaded->roster_text : "");
+    admin_view_data_free(loaded);
+}
+
+static void on_admin_view_destroy(GtkWidget* widget, gpointer data) {
+    AdminViewLoad* view = (AdminViewLoad*)data;
+    job_cancel(view->job);
+    g_free(view);
+}
+
 GtkWindow* ui_create_admin_view_window(UIState* state) {
     if (!state) return NULL;
     
@@ -3079,28 +3933,8 @@ GtkWindow* ui_create_admin_view_window(UIState* state) {
     
     GtkTextBuffer* users_buffer = gtk_text_view_get_buffer(users_text);
     
-    // Load users data
-    if (state->users && state->users->count > 0) {
-        GString* users_content = g_string_new("");
-        g_string_append_printf(users_content, "Total Users: %d\n\n", state->users->count);
-        g_string_append(users_content, "ID    | Username           | Email                          | Role    | Password Hash\n");
-        g_string_append(users_content, "------+--------------------+--------------------------------+---------+----------------------------------\n");
-        
-        for (int i = 0; i < state->users->count; i++) {
-            User* user = &state->users->users[i];
-            const char* role_str = (user->role == ROLE_ADMIN) ? "Admin" : 
-                                   (user->role == ROLE_TEACHER) ? "Teacher" : "Student";
-            
-            g_string_append_printf(users_content, 
-                "%-5d | %-18s | %-30s | %-7s | %.32s...\n",
-                user->id, user->username, user->email, role_str, user->password_hash);
-        }
-        
-        gtk_text_buffer_set_text(users_buffer, users_content->str, -1);
-        g_string_free(users_content, TRUE);
-    } else {
-        gtk_text_buffer_set_text(users_buffer, "No users data available.", -1);
-    }
+    // Filled in by the background load
+    gtk_text_buffer_set_text(users_buffer, "Loading users...", -1);
     
     gtk_notebook_append_page(notebook, GTK_WIDGET(users_vbox), 
                             gtk_label_new("👤 Users"));
@@ -3141,7 +3975,7 @@ GtkWindow* ui_create_admin_view_window(UIState* state) {
             
             g_string_append_printf(prof_content,
                 "%-4d | %-25s | %-30s | %-12s | %s\n",
-                prof->id, full_name, prof->email, prof->phone, prof->department);
+                prof->id, full_name, prof->email, prof->phone, intern_lookup(prof->department));
         }
         
         gtk_text_buffer_set_text(prof_buffer, prof_content->str, -1);
@@ -3183,7 +4017,7 @@ GtkWindow* ui_create_admin_view_window(UIState* state) {
     
     GtkLabel* users_count = GTK_LABEL(gtk_label_new(""));
     gtk_label_set_markup(users_count, g_strdup_printf("<span font='32' weight='bold'>%d</span>", 
-                         state->users ? state->users->count : 0));
+                         state->users ? state->users->count - state->users->tombstones.dead : 0));
     gtk_box_pack_start(users_card, GTK_WIDGET(users_count), FALSE, FALSE, 0);
     
     GtkLabel* users_label = GTK_LABEL(gtk_label_new("Total Users"));
@@ -3199,7 +4033,7 @@ GtkWindow* ui_create_admin_view_window(UIState* state) {
     
     GtkLabel* students_count = GTK_LABEL(gtk_label_new(""));
     gtk_label_set_markup(students_count, g_strdup_printf("<span font='32' weight='bold'>%d</span>", 
-                         state->students ? state->students->count : 0));
+                         student_list_get_count(state->students)));
     gtk_box_pack_start(students_card, GTK_WIDGET(students_count), FALSE, FALSE, 0);
     
     GtkLabel* students_label = GTK_LABEL(gtk_label_new("Students"));
@@ -3215,7 +4049,7 @@ GtkWindow* ui_create_admin_view_window(UIState* state) {
     
     GtkLabel* grades_count = GTK_LABEL(gtk_label_new(""));
     gtk_label_set_markup(grades_count, g_strdup_printf("<span font='32' weight='bold'>%d</span>", 
-                         state->grades ? state->grades->count : 0));
+                         state->grades ? state->grades->count - state->grades->tombstones.dead : 0));
     gtk_box_pack_start(grades_card, GTK_WIDGET(grades_count), FALSE, FALSE, 0);
     
     GtkLabel* grades_label = GTK_LABEL(gtk_label_new("Total Grades"));
@@ -3239,9 +4073,92 @@ GtkWindow* ui_create_admin_view_window(UIState* state) {
     
     gtk_grid_attach(stats_grid, GTK_WIDGET(clubs_frame), 1, 1, 1, 1);
     
+    // Club roster statistics (bitset based)
+    GtkFrame* rosters_frame = GTK_FRAME(gtk_frame_new("Club Rosters"));
+    GtkBox* rosters_box = GTK_BOX(gtk_box_new(GTK_ORIENTATION_VERTICAL, 8));
+    gtk_widget_set_margin_all(GTK_WIDGET(rosters_box), 12);
+    gtk_container_add(GTK_CONTAINER(rosters_frame), GTK_WIDGET(rosters_box));
+    gtk_box_pack_start(stats_content, GTK_WIDGET(rosters_frame), FALSE, FALSE, 0);
+    
+    GtkLabel* roster_label = GTK_LABEL(gtk_label_new(state->clubs ? "Counting club members..." : ""));
+    gtk_label_set_xalign(roster_label, 0.0);
+    gtk_box_pack_start(rosters_box, GTK_WIDGET(roster_label), FALSE, FALSE, 0);
+    
+    // Overlap query: club A <op> club B
+    GtkBox* overlap_box = GTK_BOX(gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 8));
+    gtk_box_pack_start(rosters_box, GTK_WIDGET(overlap_box), FALSE, FALSE, 0);
+    
+    GtkWidget* club_a_combo = gtk_combo_box_text_new();
+    GtkWidget* club_b_combo = gtk_combo_box_text_new();
+    if (state->clubs) {
+        for (int i = 0; i < state->clubs->count; i++) {
+            char id_str[16];
+            snprintf(id_str, sizeof(id_str), "%d", state->clubs->clubs[i].id);
+            gtk_combo_box_text_append(GTK_COMBO_BOX_TEXT(club_a_combo), id_str, state->clubs->clubs[i].name);
+            gtk_combo_box_text_append(GTK_COMBO_BOX_TEXT(club_b_combo), id_str, state->clubs->clubs[i].name);
+        }
+    }
+    
+    GtkWidget* op_combo = gtk_combo_box_text_new();
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(op_combo), "and");
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(op_combo), "or");
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(op_combo), "but not");
+    gtk_combo_box_set_active(GTK_COMBO_BOX(op_combo), CLUB_SET_AND);
+    
+    GtkButton* overlap_btn = GTK_BUTTON(gtk_button_new_with_label("Count"));
+    GtkLabel* overlap_result = GTK_LABEL(gtk_label_new(""));
+    
+    gtk_box_pack_start(overlap_box, club_a_combo, FALSE, FALSE, 0);
+    gtk_box_pack_start(overlap_box, op_combo, FALSE, FALSE, 0);
+    gtk_box_pack_start(overlap_box, club_b_combo, FALSE, FALSE, 0);
+    gtk_box_pack_start(overlap_box, GTK_WIDGET(overlap_btn), FALSE, FALSE, 0);
+    gtk_box_pack_start(overlap_box, GTK_WIDGET(overlap_result), FALSE, FALSE, 0);
+    
+    g_object_set_data(G_OBJECT(overlap_btn), "club_a_combo", club_a_combo);
+    g_object_set_data(G_OBJECT(overlap_btn), "club_b_combo", club_b_combo);
+    g_object_set_data(G_OBJECT(overlap_btn), "op_combo", op_combo);
+    g_object_set_data(G_OBJECT(overlap_btn), "result_label", overlap_result);
+    g_signal_connect(overlap_btn, "clicked", G_CALLBACK(on_admin_club_overlap_clicked), state);
+    
     gtk_notebook_append_page(notebook, GTK_WIDGET(stats_vbox), 
                             gtk_label_new("📊 Statistics"));
     
+    // ========== SYSTEM HEALTH TAB ==========
+    GtkBox* health_vbox = GTK_BOX(gtk_box_new(GTK_ORIENTATION_VERTICAL, 12));
+    gtk_widget_set_margin_all(GTK_WIDGET(health_vbox), 12);
+    
+    GtkLabel* health_title = GTK_LABEL(gtk_label_new(""));
+    gtk_label_set_markup(health_title, "<span font='18' weight='bold'>System Health</span>");
+    gtk_box_pack_start(health_vbox, GTK_WIDGET(health_title), FALSE, FALSE, 0);
+    
+    GtkScrolledWindow* health_scroll = GTK_SCROLLED_WINDOW(gtk_scrolled_window_new(NULL, NULL));
+    gtk_scrolled_window_set_policy(health_scroll, GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
+    gtk_box_pack_start(health_vbox, GTK_WIDGET(health_scroll), TRUE, TRUE, 0);
+    
+    GtkTextView* health_text = GTK_TEXT_VIEW(gtk_text_view_new());
+    gtk_text_view_set_editable(health_text, FALSE);
+    gtk_text_view_set_monospace(health_text, TRUE);
+    gtk_container_add(GTK_CONTAINER(health_scroll), GTK_WIDGET(health_text));
+    
+    // Resampled while the window is open
+    GtkTextBuffer* health_buffer = gtk_text_view_get_buffer(health_text);
+    // CPU is measured between this panel's own refreshes
+    g_object_set_data_full(G_OBJECT(health_buffer), "cpu-sampler", g_new0(CpuSampler, 1), g_free);
+    admin_health_refresh(health_buffer);
+    guint health_timer = g_timeout_add_seconds(HEALTH_REFRESH_SECONDS, admin_health_refresh, health_buffer);
+    g_signal_connect(health_text, "destroy", G_CALLBACK(on_admin_health_destroy), GUINT_TO_POINTER(health_timer));
+    
+    GtkLabel* health_info = GTK_LABEL(gtk_label_new(""));
+    gtk_label_set_markup(health_info,
+        "<span foreground='#666'>Tables: bytes of the rows in use against bytes allocated. "
+        "A sample is also appended to " METRICS_FILE " in the data directory every "
+        G_STRINGIFY(METRICS_INTERVAL_SECONDS) " seconds.</span>");
+    gtk_label_set_line_wrap(health_info, TRUE);
+    gtk_box_pack_start(health_vbox, GTK_WIDGET(health_info), FALSE, FALSE, 0);
+    
+    gtk_notebook_append_page(notebook, GTK_WIDGET(health_vbox), 
+                            gtk_label_new("🩺 System Health"));
+    
     // ========== DATA MANAGEMENT TAB ==========
     GtkBox* data_vbox = GTK_BOX(gtk_box_new(GTK_ORIENTATION_VERTICAL, 12));
     gtk_widget_set_margin_all(GTK_WIDGET(data_vbox), 12);
@@ -3273,6 +4190,7 @@ GtkWindow* ui_create_admin_view_window(UIState* state) {
     gtk_widget_set_size_request(GTK_WIDGET(import_btn), 200, 60);
     gtk_grid_attach(data_grid, GTK_WIDGET(import_btn), 0, 1, 1, 1);
     g_signal_connect(import_btn, "clicked", G_CALLBACK(on_admin_import_clicked), state);
+    ui_disable_if_read_only(GTK_WIDGET(import_btn), state->read_only);
     
     // Clear Cache Button
     GtkButton* cache_btn = GTK_BUTTON(gtk_button_new_with_label("🗑️ Clear Cache"));
@@ -3321,24 +4239,28 @@ GtkWindow* ui_create_admin_view_window(UIState* state) {
     gtk_widget_set_size_request(GTK_WIDGET(add_user_btn), 200, 60);
     gtk_grid_attach(usermgmt_grid, GTK_WIDGET(add_user_btn), 0, 0, 1, 1);
     g_signal_connect(add_user_btn, "clicked", G_CALLBACK(on_admin_add_user_clicked), state);
+    ui_disable_if_read_only(GTK_WIDGET(add_user_btn), state->read_only);
     
     // Delete User Button
     GtkButton* del_user_btn = GTK_BUTTON(gtk_button_new_with_label("❌ Delete User"));
     gtk_widget_set_size_request(GTK_WIDGET(del_user_btn), 200, 60);
     gtk_grid_attach(usermgmt_grid, GTK_WIDGET(del_user_btn), 1, 0, 1, 1);
     g_signal_connect(del_user_btn, "clicked", G_CALLBACK(on_admin_delete_user_clicked), state);
+    ui_disable_if_read_only(GTK_WIDGET(del_user_btn), state->read_only);
     
     // Reset Password Button
     GtkButton* reset_pwd_btn = GTK_BUTTON(gtk_button_new_with_label("🔑 Reset Password"));
     gtk_widget_set_size_request(GTK_WIDGET(reset_pwd_btn), 200, 60);
     gtk_grid_attach(usermgmt_grid, GTK_WIDGET(reset_pwd_btn), 0, 1, 1, 1);
     g_signal_connect(reset_pwd_btn, "clicked", G_CALLBACK(on_admin_reset_password_clicked), state);
+    ui_disable_if_read_only(GTK_WIDGET(reset_pwd_btn), state->read_only);
     
     // Manage Roles Button
     GtkButton* roles_btn = GTK_BUTTON(gtk_button_new_with_label("👥 Manage Roles"));
     gtk_widget_set_size_request(GTK_WIDGET(roles_btn), 200, 60);
     gtk_grid_attach(usermgmt_grid, GTK_WIDGET(roles_btn), 1, 1, 1, 1);
     g_signal_connect(roles_btn, "clicked", G_CALLBACK(on_admin_manage_roles_clicked), state);
+    ui_disable_if_read_only(GTK_WIDGET(roles_btn), state->read_only);
     
     // Active Users List
     GtkLabel* active_label = GTK_LABEL(gtk_label_new(""));
@@ -3383,6 +4305,20 @@ GtkWindow* ui_create_admin_view_window(UIState* state) {
     // Simply close the window to return to main dashboard
     g_signal_connect_swapped(back_btn, "clicked", G_CALLBACK(gtk_widget_destroy), window);
     
+    // The user list and the club rosters can be large; read them off the
+    // main thread and fill the widgets in when done
+    AdminViewLoad* view = g_new0(AdminViewLoad, 1);
+    view->users_buffer = users_buffer;
+    view->roster_label = roster_label;
+    g_signal_connect(window, "destroy", G_CALLBACK(on_admin_view_destroy), view);
+    
+    AdminViewJob* load = g_new0(AdminViewJob, 1);
+    load->state = state;
+    load->view = view;
+    const JobSpec spec = {"admin view", admin_view_load_run, admin_view_load_done, NULL,
+                          admin_view_data_free, g_free};
+    view->job = job_submit(&spec, load);
+    
     // Window close handler
     g_signal_connect(window, "destroy", G_CALLBACK(ui_on_window_destroy), state);
     
@@ -3612,50 +4548,74 @@ void ui_treeview_set_selection_callback(GtkTreeView* treeview, GCallback callbac
     g_signal_connect(selection, "changed", callback, user_data);
 }
 
+// Treeview over a virtual table model. Fixed height mode lets the view
+// size rows without asking for every cell, so only visible rows are formatted.
+GtkTreeView* ui_create_table_treeview(TableModelKind kind) {
+    TableModel* model = table_model_new(kind, NULL);
+    GtkTreeView* treeview = GTK_TREE_VIEW(gtk_tree_view_new_with_model(GTK_TREE_MODEL(model)));
+    g_object_unref(model);
+    
+    int column_count = table_model_kind_n_columns(kind);
+    for (int i = 0; i < column_count; i++) {
+        GtkCellRenderer* renderer = gtk_cell_renderer_text_new();
+        GtkTreeViewColumn* column = gtk_tree_view_column_new_with_attributes(
+            table_model_kind_column_title(kind, i), renderer, "text", i, NULL
+        );
+        gtk_tree_view_column_set_sizing(column, GTK_TREE_VIEW_COLUMN_FIXED);
+        gtk_tree_view_column_set_fixed_width(column, 140);
+        gtk_tree_view_column_set_resizable(column, TRUE);
+        gtk_tree_view_append_column(treeview, column);
+    }
+    
+    gtk_tree_view_set_fixed_height_mode(treeview, TRUE);
+    return treeview;
+}
+
+// Hand the view a new model; the view keeps the only reference
+void ui_treeview_set_table_model(GtkTreeView* treeview, TableModel* model) {
+    if (!treeview || !model) return;
+    gtk_tree_view_set_model(treeview, GTK_TREE_MODEL(model));
+    g_object_unref(model);
+}
+
+static TableModel* ui_treeview_get_table_model(GtkTreeView* treeview) {
+    if (!treeview) return NULL;
+    GtkTreeModel* model = gtk_tree_view_get_model(treeview);
+    return (model && IS_TABLE_MODEL(model)) ? TABLE_MODEL(model) : NULL;
+}
+
 // ============================================================================
 // STUDENT TREEVIEW
 // ============================================================================
 
 GtkTreeView* ui_create_student_treeview(void) {
-    const char* columns[] = {"ID", "First Name", "Last Name", "Email", "Filiere"};
-    return ui_create_treeview_with_columns(columns, 6);
+    return ui_create_table_treeview(TABLE_MODEL_STUDENTS);
 }
 
 void ui_student_treeview_populate(GtkTreeView* treeview, StudentList* students) {
     if (!treeview || !students) return;
-    
-    ui_treeview_clear(treeview);
-    
-    for (int i = 0; i < students->count; i++) {
-        Student* s = &students->students[i];
-        char id_str[20];
-        snprintf(id_str, sizeof(id_str), "%d", s->id);
-        
-        const char* data[] = {id_str, s->first_name, s->last_name, s->email, s->course};
-        ui_treeview_add_row(treeview, data, 5);
-    }
+    TRACE_SCOPE("populate student view");
+    ui_treeview_set_table_model(treeview, table_model_new(TABLE_MODEL_STUDENTS, students));
 }
 
+// Row-level updates. Each is called after the backing list was changed and
+// only signals the affected row, so the view never rebuilds.
 void ui_student_treeview_add_student(GtkTreeView* treeview, Student* student) {
-    if (!treeview || !student) return;
-    
-    char id_str[20];
-    snprintf(id_str, sizeof(id_str), "%d", student->id);
-    
-    char gpa_str[20];
-    snprintf(gpa_str, sizeof(gpa_str), "%.2f", student->gpa);
-    
-    const char* data[] = {id_str, student->first_name, student->last_name, 
-                          student->email, student->course, gpa_str};
-    ui_treeview_add_row(treeview, data, 6);
+    TableModel* model = ui_treeview_get_table_model(treeview);
+    if (!model || !student) return;
+    table_model_record_inserted(model);
 }
 
 void ui_student_treeview_update_student(GtkTreeView* treeview, Student* student) {
-    // TODO: Implement update
+    TableModel* model = ui_treeview_get_table_model(treeview);
+    if (!model || !student) return;
+    table_model_record_changed(model, student->id);
 }
 
 void ui_student_treeview_remove_student(GtkTreeView* treeview, int student_id) {
-    // TODO: Implement removal
+    TableModel* model = ui_treeview_get_table_model(treeview);
+    if (!model) return;
+    table_model_record_removed(model, student_id);
 }
 
 // ============================================================================
@@ -3663,182 +4623,110 @@ void ui_student_treeview_remove_student(GtkTreeView* treeview, int student_id) {
 // ============================================================================
 
 GtkTreeView* ui_create_grade_treeview(void) {
-    const char* columns[] = {"Student ID", "Exam ID", "Module", "Grade", "Present"};
-    return ui_create_treeview_with_columns(columns, 5);
+    return ui_create_table_treeview(TABLE_MODEL_GRADES);
 }
 
 void ui_grade_treeview_populate(GtkTreeView* treeview, GradeList* grades) {
     if (!treeview || !grades) return;
+    TRACE_SCOPE("populate grade view");
+    ui_treeview_set_table_model(treeview, table_model_new(TABLE_MODEL_GRADES, grades));
+}
+
+// Grades have no id of their own; rows are keyed by their index in the list
+void ui_grade_treeview_add_grade(GtkTreeView* treeview, Grade* grade) {
+    TableModel* model = ui_treeview_get_table_model(treeview);
+    if (!model || !grade) return;
+    table_model_record_inserted(model);
+}
+
+void ui_grade_treeview_update_grade(GtkTreeView* treeview, Grade* grade) {
+    TableModel* model = ui_treeview_get_table_model(treeview);
+    if (!model || !grade) return;
     
-    GtkListStore* store = GTK_LIST_STORE(gtk_tree_view_get_model(treeview));
-    if (!store) return;
-    
-    // Clear existing data
-    gtk_list_store_clear(store);
+    GradeList* grades = (GradeList*)model->table;
+    if (!grades) return;
     
-    // Add each grade to the tree view
-    for (int i = 0; i < grades->count; i++) {
-        GtkTreeIter iter;
-        gtk_list_store_append(store, &iter);
-        
-        char student_id_str[16], exam_id_str[16], grade_str[16];
-        snprintf(student_id_str, sizeof(student_id_str), "%d", grades->note[i].id_etudiant);
-        snprintf(exam_id_str, sizeof(exam_id_str), "%d", grades->note[i].id_examen);
-        snprintf(grade_str, sizeof(grade_str), "%.2f", grades->note[i].note_obtenue);
-        
-        gtk_list_store_set(store, &iter,
-                          0, student_id_str,
-                          1, exam_id_str,
-                          2, "",  // Module name not in structure
-                          3, grade_str,
-                          4, grades->note[i].present ? "Yes" : "No",
-                          -1);
+    // Accept both a pointer into the list and a detached copy
+    if (grade < grades->note || grade >= grades->note + grades->count) {
+        grade = chercher_note(grades, grade->id_etudiant, grade->id_examen);
+        if (!grade) return;
     }
+    table_model_record_changed(model, (int)(grade - grades->note));
 }
 
-void ui_grade_treeview_add_grade(GtkTreeView* treeview, Grade* grade) {}
-void ui_grade_treeview_update_grade(GtkTreeView* treeview, Grade* grade) {}
-void ui_grade_treeview_remove_grade(GtkTreeView* treeview, int grade_id) {}
+void ui_grade_treeview_remove_grade(GtkTreeView* treeview, int grade_id) {
+    TableModel* model = ui_treeview_get_table_model(treeview);
+    if (!model) return;
+    table_model_record_removed(model, grade_id);
+}
 
 // ============================================================================
 // ATTENDANCE TREEVIEW
 // ============================================================================
 
 GtkTreeView* ui_create_attendance_treeview(void) {
-    const char* columns[] = {"ID", "Student ID", "Course ID", "Date", "Status"};
-    return ui_create_treeview_with_columns(columns, 5);
+    return ui_create_table_treeview(TABLE_MODEL_ATTENDANCE);
 }
 
 void ui_attendance_treeview_populate(GtkTreeView* treeview, AttendanceList* attendance) {
     if (!treeview || !attendance) return;
+    TRACE_SCOPE("populate attendance view");
     
-    GtkListStore* store = GTK_LIST_STORE(gtk_tree_view_get_model(treeview));
-    if (!store) return;
-    
-    // Clear existing data
-    gtk_list_store_clear(store);
-    
-    if (attendance->count == 0) return;
-    
-    // Create a copy of records to sort by course_id
-    AttendanceRecord* sorted_records = (AttendanceRecord*)malloc(attendance->count * sizeof(AttendanceRecord));
-    if (!sorted_records) return;
-    
-    memcpy(sorted_records, attendance->records, attendance->count * sizeof(AttendanceRecord));
-    
-    // Sort records by course_id using bubble sort
-    for (int i = 0; i < attendance->count - 1; i++) {
-        for (int j = 0; j < attendance->count - i - 1; j++) {
-            if (sorted_records[j].course_id > sorted_records[j + 1].course_id) {
-                AttendanceRecord temp = sorted_records[j];
-                sorted_records[j] = sorted_records[j + 1];
-                sorted_records[j + 1] = temp;
-            }
-        }
-    }
-    
-    // Add records grouped by course_id
-    int current_course_id = -1;
-    for (int i = 0; i < attendance->count; i++) {
-        // Add course header when course changes
-        if (sorted_records[i].course_id != current_course_id) {
-            current_course_id = sorted_records[i].course_id;
-            
-            GtkTreeIter header_iter;
-            gtk_list_store_append(store, &header_iter);
-            
-            char course_header[128];
-            snprintf(course_header, sizeof(course_header), "═══ COURSE ID: %d ═══", current_course_id);
-            
-            gtk_list_store_set(store, &header_iter,
-                              0, "",
-                              1, course_header,
-                              2, "",
-                              3, "",
-                              4, "",
-                              -1);
-        }
-        
-        // Add attendance record
-        GtkTreeIter iter;
-        gtk_list_store_append(store, &iter);
-        
-        char id_str[16], student_id_str[16], course_id_str[16];
-        snprintf(id_str, sizeof(id_str), "%d", sorted_records[i].id);
-        snprintf(student_id_str, sizeof(student_id_str), "%d", sorted_records[i].student_id);
-        snprintf(course_id_str, sizeof(course_id_str), "%d", sorted_records[i].course_id);
-        
-        struct tm* timeinfo = localtime(&sorted_records[i].recorded_time);
-        char date_str[64];
-        strftime(date_str, sizeof(date_str), "%Y-%m-%d %H:%M", timeinfo);
-        
-        const char* status_str;
-        switch (sorted_records[i].status) {
-            case 0: status_str = "Absent"; break;
-            case 1: status_str = "Present"; break;
-            case 2: status_str = "Late"; break;
-            case 3: status_str = "Excused"; break;
-            default: status_str = "Unknown"; break;
-        }
-        
-        gtk_list_store_set(store, &iter,
-                          0, id_str,
-                          1, student_id_str,
-                          2, course_id_str,
-                          3, date_str,
-                          4, status_str,
-                          -1);
-    }
-    
-    free(sorted_records);
+    // Records stay where they are; the model only orders indices by course
+    TableModel* model = table_model_new(TABLE_MODEL_ATTENDANCE, attendance);
+    table_model_group_attendance_by_course(model);
+    ui_treeview_set_table_model(treeview, model);
 }
 
-void ui_attendance_treeview_add_record(GtkTreeView* treeview, AttendanceRecord* record) {}
-void ui_attendance_treeview_update_record(GtkTreeView* treeview, AttendanceRecord* record) {}
-void ui_attendance_treeview_remove_record(GtkTreeView* treeview, int record_id) {}
+void ui_attendance_treeview_add_record(GtkTreeView* treeview, AttendanceRecord* record) {
+    TableModel* model = ui_treeview_get_table_model(treeview);
+    if (!model || !record) return;
+    table_model_record_inserted(model);
+}
+
+void ui_attendance_treeview_update_record(GtkTreeView* treeview, AttendanceRecord* record) {
+    TableModel* model = ui_treeview_get_table_model(treeview);
+    if (!model || !record) return;
+    table_model_record_changed(model, record->id);
+}
+
+void ui_attendance_treeview_remove_record(GtkTreeView* treeview, int record_id) {
+    TableModel* model = ui_treeview_get_table_model(treeview);
+    if (!model) return;
+    table_model_record_removed(model, record_id);
+}
 
 // ============================================================================
 // CLUB TREEVIEW
 // ============================================================================
 
 GtkTreeView* ui_create_club_treeview(void) {
-    const char* columns[] = {"ID", "Name", "Category", "Members", "Status"};
-    return ui_create_treeview_with_columns(columns, 5);
+    return ui_create_table_treeview(TABLE_MODEL_CLUBS);
 }
 
 void ui_club_treeview_populate(GtkTreeView* treeview, ClubList* clubs) {
     if (!treeview || !clubs) return;
-    
-    GtkListStore* store = GTK_LIST_STORE(gtk_tree_view_get_model(treeview));
-    if (!store) return;
-    
-    // Clear existing data
-    gtk_list_store_clear(store);
-    
-    // Add each club to the tree view
-    for (int i = 0; i < clubs->count; i++) {
-        GtkTreeIter iter;
-        gtk_list_store_append(store, &iter);
-        
-        char id_str[16], members_str[16];
-        snprintf(id_str, sizeof(id_str), "%d", clubs->clubs[i].id);
-        snprintf(members_str, sizeof(members_str), "%d", clubs->clubs[i].member_count);
-        
-        const char* status_str = clubs->clubs[i].is_active ? "Active" : "Inactive";
-        
-        gtk_list_store_set(store, &iter,
-                          0, id_str,
-                          1, clubs->clubs[i].name,
-                          2, clubs->clubs[i].category,
-                          3, members_str,
-                          4, status_str,
-                          -1);
-    }
+    TRACE_SCOPE("populate club view");
+    ui_treeview_set_table_model(treeview, table_model_new(TABLE_MODEL_CLUBS, clubs));
 }
 
-void ui_club_treeview_add_club(GtkTreeView* treeview, Club* club) {}
-void ui_club_treeview_update_club(GtkTreeView* treeview, Club* club) {}
-void ui_club_treeview_remove_club(GtkTreeView* treeview, int club_id) {}
+void ui_club_treeview_add_club(GtkTreeView* treeview, Club* club) {
+    TableModel* model = ui_treeview_get_table_model(treeview);
+    if (!model || !club) return;
+    table_model_record_inserted(model);
+}
+
+void ui_club_treeview_update_club(GtkTreeView* treeview, Club* club) {
+    TableModel* model = ui_treeview_get_table_model(treeview);
+    if (!model || !club) return;
+    table_model_record_changed(model, club->id);
+}
+
+void ui_club_treeview_remove_club(GtkTreeView* treeview, int club_id) {
+    TableModel* model = ui_treeview_get_table_model(treeview);
+    if (!model) return;
+    table_model_record_removed(model, club_id);
+}
 
 // ============================================================================
 // STATUS BAR
@@ -3957,6 +4845,7 @@ void ui_toolbar_setup_student_buttons(GtkToolbar* toolbar, UIState* state) {
     GtkToolButton* add_btn = ui_create_tool_button("list-add", "Add Student", 
                                                     G_CALLBACK(ui_on_add_student_clicked), state);
     gtk_toolbar_insert(toolbar, GTK_TOOL_ITEM(add_btn), -1);
+    ui_disable_if_read_only(GTK_WIDGET(add_btn), state->read_only);
 }
 
 void ui_toolbar_setup_grade_buttons(GtkToolbar* toolbar, UIState* state) {}
@@ -4002,6 +4891,67 @@ void ui_set_window_icon(GtkWindow* window, const char* icon_file) {
     // TODO: Set window icon
 }
 
+// A follower applies its primary's changes only; an action that would
+// change a table there is greyed out instead
+void ui_disable_if_read_only(GtkWidget* widget, int read_only) {
+    if (!widget || !read_only) return;
+    gtk_widget_set_sensitive(widget, FALSE);
+    gtk_widget_set_tooltip_text(widget, "Read-only: this instance follows a primary");
+}
+
+// ============================================================================
+// AUTOCOMPLETE
+// ============================================================================
+
+// The store already holds only matching rows, so accept all of them
+static gboolean ui_completion_match_all(GtkEntryCompletion* completion, const gchar* key,
+                                        GtkTreeIter* iter, gpointer user_data) {
+    return TRUE;
+}
+
+// Refill the suggestion store with the top matches for the current text
+static void ui_on_completion_entry_changed(GtkEditable* editable, gpointer user_data) {
+    CompletionIndex* index = (CompletionIndex*)user_data;
+    GtkEntry* entry = GTK_ENTRY(editable);
+    GtkEntryCompletion* completion = gtk_entry_get_completion(entry);
+    if (!completion) return;
+
+    GtkListStore* store = GTK_LIST_STORE(gtk_entry_completion_get_model(completion));
+    gtk_list_store_clear(store);
+
+    int kinds = GPOINTER_TO_INT(g_object_get_data(G_OBJECT(entry), "completion-kinds"));
+    CompletionHit hits[COMPLETION_MAX_RESULTS];
+    int hit_count = completion_index_query(index, gtk_entry_get_text(entry), kinds,
+                                           hits, COMPLETION_MAX_RESULTS);
+
+    for (int i = 0; i < hit_count; i++) {
+        GtkTreeIter iter;
+        gtk_list_store_append(store, &iter);
+        gtk_list_store_set(store, &iter, 0, hits[i].display, 1, hits[i].id, -1);
+    }
+}
+
+// Give an entry a suggestion popup fed by the completion index. The popup
+// model has the display text in column 0 and the record id in column 1.
+void ui_entry_attach_completion(GtkEntry* entry, CompletionIndex* index, int kinds) {
+    if (!entry || !index) return;
+
+    GtkListStore* store = gtk_list_store_new(2, G_TYPE_STRING, G_TYPE_INT);
+    GtkEntryCompletion* completion = gtk_entry_completion_new();
+    gtk_entry_completion_set_model(completion, GTK_TREE_MODEL(store));
+    gtk_entry_completion_set_text_column(completion, 0);
+    gtk_entry_completion_set_match_func(completion, ui_completion_match_all, NULL, NULL);
+    gtk_entry_completion_set_minimum_key_length(completion, 1);
+    g_object_unref(store);
+
+    g_object_set_data(G_OBJECT(entry), "completion-kinds", GINT_TO_POINTER(kinds));
+
+    // Connected before the completion so the store is refilled before it filters
+    g_signal_connect(entry, "changed", G_CALLBACK(ui_on_completion_entry_changed), index);
+    gtk_entry_set_completion(entry, completion);
+    g_object_unref(completion);
+}
+
 // ============================================================================
 // LOGO FUNCTIONS
 // ============================================================================
@@ -4009,56 +4959,37 @@ void ui_set_window_icon(GtkWindow* window, const char* icon_file) {
 GtkImage* ui_create_logo_image(const char* logo_path, int width, int height) {
     if (!logo_path) return NULL;
     
-    GError* error = NULL;
-    GdkPixbuf* pixbuf = gdk_pixbuf_new_from_file(logo_path, &error);
+    // Decoded once per session, see asset.h
+    GdkPixbuf* pixbuf = asset_get_pixbuf(logo_path);
+    if (!pixbuf) return NULL;
     
-    if (!pixbuf) {
-        if (error) {
-            g_warning("Failed to load logo from %s: %s", logo_path, error->message);
-            g_error_free(error);
-        }
-        return NULL;
-    }
+    int orig_width = gdk_pixbuf_get_width(pixbuf);
+    int orig_height = gdk_pixbuf_get_height(pixbuf);
+    int new_width = orig_width;
+    int new_height = orig_height;
     
     // Scale the image if dimensions are specified
-    GdkPixbuf* scaled_pixbuf = pixbuf;
     if (width > 0 && height > 0) {
-        int orig_width = gdk_pixbuf_get_width(pixbuf);
-        int orig_height = gdk_pixbuf_get_height(pixbuf);
-        
         // Maintain aspect ratio
         double scale = (double)width / orig_width;
         if (scale * orig_height > height) {
             scale = (double)height / orig_height;
         }
         
-        int new_width = (int)(orig_width * scale);
-        int new_height = (int)(orig_height * scale);
-        
-        scaled_pixbuf = gdk_pixbuf_scale_simple(pixbuf, new_width, new_height, GDK_INTERP_BILINEAR);
-        g_object_unref(pixbuf);
+        new_width = (int)(orig_width * scale);
+        new_height = (int)(orig_height * scale);
     }
     
-    GtkImage* image = GTK_IMAGE(gtk_image_new_from_pixbuf(scaled_pixbuf));
-    g_object_unref(scaled_pixbuf);
-    
-    return image;
+    GtkWidget* image = asset_image_new(logo_path, new_width, new_height);
+    return image ? GTK_IMAGE(image) : NULL;
 }
 
 void ui_set_window_logo(GtkWindow* window, const char* logo_path) {
     if (!window || !logo_path) return;
     
-    GError* error = NULL;
-    GdkPixbuf* pixbuf = gdk_pixbuf_new_from_file(logo_path, &error);
-    
+    GdkPixbuf* pixbuf = asset_get_pixbuf(logo_path);
     if (pixbuf) {
         gtk_window_set_icon(window, pixbuf);
-        g_object_unref(pixbuf);
-    } else {
-        if (error) {
-            g_warning("Failed to load window icon from %s: %s", logo_path, error->message);
-            g_error_free(error);
-        }
     }
 }
 
@@ -4141,9 +5072,35 @@ void ui_on_search_students_clicked(GtkButton* button, gpointer user_data) {
     GtkTreeView* treeview = GTK_TREE_VIEW(g_object_get_data(G_OBJECT(state->current_window), "treeview"));
     if (!treeview || !state->students) return;
     
-    // Create filtered list
-    StudentList* filtered = student_list_create();
-    if (!filtered) return;
+    // Ranked lookup through the trigram index when one is loaded
+    if (state->student_search) {
+        SearchHit* hits = (SearchHit*)malloc(SEARCH_MAX_RESULTS * sizeof(SearchHit));
+        int* rows = (int*)malloc(SEARCH_MAX_RESULTS * sizeof(int));
+        if (!hits || !rows) {
+            free(hits);
+            free(rows);
+            return;
+        }
+        
+        int hit_count = search_index_query(state->student_search, search_text, hits, SEARCH_MAX_RESULTS);
+        for (int i = 0; i < hit_count; i++) {
+            rows[i] = hits[i].index;
+        }
+        
+        TableModel* model = table_model_new(TABLE_MODEL_STUDENTS, state->students);
+        table_model_set_rows(model, rows, hit_count);
+        ui_treeview_set_table_model(treeview, model);
+        
+        printf("[INFO] Search results for '%s': %d student(s) found\n", search_text, hit_count);
+        free(hits);
+        free(rows);
+        return;
+    }
+    
+    // Matching rows are kept as indices into the live list, not copies
+    int* matches = (int*)malloc((state->students->count > 0 ? state->students->count : 1) * sizeof(int));
+    if (!matches) return;
+    int match_count = 0;
     
     // Search in first name, last name, email, course, and ID
     char search_lower[256];
@@ -4157,6 +5114,7 @@ void ui_on_search_students_clicked(GtkButton* button, gpointer user_data) {
     // Iterate through all students
     for (int i = 0; i < state->students->count; i++) {
         Student* student = &state->students->students[i];
+        if (student->is_deleted) continue;
         char student_data[1024];
         
         // Combine student data for search
@@ -4164,7 +5122,7 @@ void ui_on_search_students_clicked(GtkButton* button, gpointer user_data) {
                 student->first_name,
                 student->last_name,
                 student->email,
-                student->course,
+                intern_lookup(student->course),
                 student->id);
         
         // Convert to lowercase
@@ -4174,19 +5132,28 @@ void ui_on_search_students_clicked(GtkButton* button, gpointer user_data) {
         
         // Check if search text is in student data
         if (strstr(student_data, search_lower)) {
-            // Add to filtered list
-            student_list_add(filtered, *student);
+            matches[match_count++] = i;
         }
     }
     
     // Update treeview with filtered results
-    ui_student_treeview_populate(treeview, filtered);
+    TableModel* model = table_model_new(TABLE_MODEL_STUDENTS, state->students);
+    table_model_set_rows(model, matches, match_count);
+    ui_treeview_set_table_model(treeview, model);
     
     // Show status message
-    printf("[INFO] Search results for '%s': %d student(s) found\n", search_text, filtered->count);
+    printf("[INFO] Search results for '%s': %d student(s) found\n", search_text, match_count);
     
-    // Free the filtered list
-    student_list_destroy(filtered);
+    free(matches);
+}
+
+// Drops the search scheduled by the last keystroke, if it has not run yet
+static void ui_search_cancel_pending(GObject* entry) {
+    guint source_id = GPOINTER_TO_UINT(g_object_get_data(entry, "search-timeout"));
+    if (source_id) {
+        g_source_remove(source_id);
+        g_object_set_data(entry, "search-timeout", NULL);
+    }
 }
 
 void ui_on_clear_search_clicked(GtkButton* button, gpointer user_data) {
@@ -4195,7 +5162,12 @@ void ui_on_clear_search_clicked(GtkButton* button, gpointer user_data) {
     
     GtkEntry* search_entry = GTK_ENTRY(g_object_get_data(G_OBJECT(state->current_window), "search-entry"));
     if (search_entry) {
+        // The list is refreshed right below, so neither a pending search nor
+        // the one this change would schedule is wanted
+        ui_search_cancel_pending(G_OBJECT(search_entry));
+        g_signal_handlers_block_by_func(search_entry, ui_on_search_entry_changed, user_data);
         gtk_entry_set_text(search_entry, "");
+        g_signal_handlers_unblock_by_func(search_entry, ui_on_search_entry_changed, user_data);
     }
     
     // Refresh to show all students
@@ -4211,6 +5183,32 @@ void ui_on_search_entry_activate(GtkEntry* entry, gpointer user_data) {
     }
 }
 
+static gboolean ui_on_search_debounce_elapsed(gpointer user_data) {
+    UIState* state = (UIState*)user_data;
+    if (state && state->current_window) {
+        GObject* entry = G_OBJECT(g_object_get_data(G_OBJECT(state->current_window), "search-entry"));
+        if (entry) g_object_set_data(entry, "search-timeout", NULL);
+        ui_on_search_students_clicked(NULL, user_data);
+    }
+    return G_SOURCE_REMOVE;
+}
+
+void ui_on_search_entry_changed(GtkEditable* editable, gpointer user_data) {
+    // Search as you type, once typing pauses
+    guint source_id = GPOINTER_TO_UINT(g_object_get_data(G_OBJECT(editable), "search-timeout"));
+    if (source_id) {
+        g_source_remove(source_id);
+    }
+    
+    source_id = g_timeout_add(SEARCH_DEBOUNCE_MS, ui_on_search_debounce_elapsed, user_data);
+    g_object_set_data(G_OBJECT(editable), "search-timeout", GUINT_TO_POINTER(source_id));
+}
+
+void ui_on_search_entry_destroy(GtkWidget* widget, gpointer user_data) {
+    // Don't let a pending search outlive the window
+    ui_search_cancel_pending(G_OBJECT(widget));
+}
+
 void ui_on_student_selection_changed(GtkTreeSelection* selection, gpointer user_data) {
     // TODO: Handle selection change
 }
@@ -4311,7 +5309,7 @@ int ui_load_data(UIState* state) {
             fprintf(stderr, "[WARNING] Failed to load users\n");
             errors++;
         } else {
-            printf("[OK] Loaded %d users\n", state->users->count);
+            printf("[OK] Loaded %d users\n", state->users->count - state->users->tombstones.dead);
         }
     }
     
@@ -4333,10 +5331,10 @@ int ui_load_data(UIState* state) {
             fprintf(stderr, "[WARNING] Failed to load students\n");
             errors++;
         } else {
-            printf("[OK] Loaded %d students\n", state->students->count);
+            printf("[OK] Loaded %d students\n", student_list_get_count(state->students));
         }
     } else if (state->students->count > 0) {
-        printf("[OK] Using existing student data (%d students)\n", state->students->count);
+        printf("[OK] Using existing student data (%d students)\n", student_list_get_count(state->students));
     }
     
     // Load grades
@@ -4346,7 +5344,7 @@ int ui_load_data(UIState* state) {
             fprintf(stderr, "[WARNING] Failed to load grades\n");
             errors++;
         } else {
-            printf("[OK] Loaded %d grades\n", state->grades->count);
+            printf("[OK] Loaded %d grades\n", state->grades->count - state->grades->tombstones.dead);
         }
     }
     
@@ -4357,7 +5355,7 @@ int ui_load_data(UIState* state) {
             fprintf(stderr, "[WARNING] Failed to load attendance\n");
             errors++;
         } else {
-            printf("[OK] Loaded %d attendance records\n", state->attendance->count);
+            printf("[OK] Loaded %d attendance records\n", state->attendance->count - state->attendance->tombstones.dead);
         }
     }
     
@@ -4391,7 +5389,7 @@ int ui_save_data(UIState* state) {
             fprintf(stderr, "[ERROR] Failed to save users\n");
             errors++;
         } else {
-            printf("[OK] Saved %d users\n", state->users->count);
+            printf("[OK] Saved %d users\n", state->users->count - state->users->tombstones.dead);
         }
     }
     
@@ -4402,7 +5400,7 @@ int ui_save_data(UIState* state) {
             fprintf(stderr, "[ERROR] Failed to save students\n");
             errors++;
         } else {
-            printf("[OK] Saved %d students\n", state->students->count);
+            printf("[OK] Saved %d students\n", student_list_get_count(state->students));
         }
     }
     
@@ -4413,7 +5411,7 @@ int ui_save_data(UIState* state) {
             fprintf(stderr, "[ERROR] Failed to save grades\n");
             errors++;
         } else {
-            printf("[OK] Saved %d grades\n", state->grades->count);
+            printf("[OK] Saved %d grades\n", state->grades->count - state->grades->tombstones.dead);
         }
     }
     
@@ -4424,7 +5422,7 @@ int ui_save_data(UIState* state) {
             fprintf(stderr, "[ERROR] Failed to save attendance\n");
             errors++;
         } else {
-            printf("[OK] Saved %d attendance records\n", state->attendance->count);
+            printf("[OK] Saved %d attendance records\n", state->attendance->count - state->attendance->tombstones.dead);
         }
     }
     
@@ -4526,7 +5524,8 @@ void ui_on_student_join_club(GtkButton* button, gpointer user_data) {
     // Find student by email matching current user
     Student* student = NULL;
     for (int i = 0; i < state->students->count; i++) {
-        if (strcmp(state->students->students[i].email, state->current_user->email) == 0) {
+        if (!state->students->students[i].is_deleted &&
+            strcmp(state->students->students[i].email, state->current_user->email) == 0) {
             student = &state->students->students[i];
             break;
         }
@@ -4541,7 +5540,7 @@ void ui_on_student_join_club(GtkButton* button, gpointer user_data) {
     // Check if already a member
     for (int i = 0; i < state->memberships->count; i++) {
         ClubMembership* m = &state->memberships->memberships[i];
-        if (m->student_id == student->id && m->club_id == club_id && m->is_active) {
+        if (m->student_id == student->id && m->club_id == club_id && m->is_active && !m->is_deleted) {
             char msg[256];
             snprintf(msg, sizeof(msg), "You are already a member of %s!", club_name);
             ui_show_info_message(parent_window, msg);
@@ -4552,28 +5551,30 @@ void ui_on_student_join_club(GtkButton* button, gpointer user_data) {
     
     // Create new membership
     ClubMembership new_membership;
-    new_membership.id = state->memberships->count + 1;
+    new_membership.id = 0;   // assigned by membership_list_add
     new_membership.student_id = student->id;
     new_membership.club_id = club_id;
     new_membership.join_date = time(NULL);
-    strncpy(new_membership.role, "Member", sizeof(new_membership.role) - 1);
+    new_membership.role = intern_string(CLUB_ROLE_MEMBER);
     new_membership.is_active = 1;
     
     if (membership_list_add(state->memberships, new_membership)) {
+        club_roster_index_set_member(state->club_rosters, club_id, student->id, 1);
         // Update club member count
         Club* club = club_list_find_by_id(state->clubs, club_id);
         if (club) {
+            table_lock_write(state->clubs->lock);
             club->member_count++;
-            club_list_save_to_file(state->clubs, "clubs.txt");
+            state->clubs->dirty = 1;
+            changelog_record(state->clubs->lock, CHANGE_CLUBS, CHANGE_UPDATE, club);
+            table_unlock_write(state->clubs->lock);
         }
         
-        membership_list_save_to_file(state->memberships, "club_memberships.txt");
-        
         char msg[256];
         snprintf(msg, sizeof(msg), "Successfully joined %s!", club_name);
         ui_show_info_message(parent_window, msg);
         
-        ui_club_treeview_populate(club_tree, state->clubs);
+        ui_club_treeview_update_club(club_tree, club);
     } else {
         ui_show_error_message(parent_window, "Failed to join club!");
     }
@@ -4616,7 +5617,8 @@ void ui_on_student_leave_club(GtkButton* button, gpointer user_data) {
     // Find student by email matching current user
     Student* student = NULL;
     for (int i = 0; i < state->students->count; i++) {
-        if (strcmp(state->students->students[i].email, state->current_user->email) == 0) {
+        if (!state->students->students[i].is_deleted &&
+            strcmp(state->students->students[i].email, state->current_user->email) == 0) {
             student = &state->students->students[i];
             break;
         }
@@ -4632,24 +5634,30 @@ void ui_on_student_leave_club(GtkButton* button, gpointer user_data) {
     int found = 0;
     for (int i = 0; i < state->memberships->count; i++) {
         ClubMembership* m = &state->memberships->memberships[i];
-        if (m->student_id == student->id && m->club_id == club_id && m->is_active) {
+        if (m->student_id == student->id && m->club_id == club_id && m->is_active && !m->is_deleted) {
+            table_lock_write(state->memberships->lock);
             m->is_active = 0;
+            state->memberships->dirty = 1;
+            changelog_record(state->memberships->lock, CHANGE_MEMBERSHIPS, CHANGE_UPDATE, m);
+            table_unlock_write(state->memberships->lock);
+            club_roster_index_set_member(state->club_rosters, club_id, student->id, 0);
             found = 1;
             
             // Update club member count
             Club* club = club_list_find_by_id(state->clubs, club_id);
             if (club && club->member_count > 0) {
+                table_lock_write(state->clubs->lock);
                 club->member_count--;
-                club_list_save_to_file(state->clubs, "clubs.txt");
+                state->clubs->dirty = 1;
+                changelog_record(state->clubs->lock, CHANGE_CLUBS, CHANGE_UPDATE, club);
+                table_unlock_write(state->clubs->lock);
             }
             
-            membership_list_save_to_file(state->memberships, "club_memberships.txt");
-            
             char msg[256];
             snprintf(msg, sizeof(msg), "Successfully left %s!", club_name);
             ui_show_info_message(parent_window, msg);
             
-            ui_club_treeview_populate(club_tree, state->clubs);
+            ui_club_treeview_update_club(club_tree, club);
             break;
         }
     }
@@ -4679,7 +5687,8 @@ void ui_on_student_view_my_clubs(GtkButton* button, gpointer user_data) {
     // Find student by email matching current user
     Student* student = NULL;
     for (int i = 0; i < state->students->count; i++) {
-        if (strcmp(state->students->students[i].email, state->current_user->email) == 0) {
+        if (!state->students->students[i].is_deleted &&
+            strcmp(state->students->students[i].email, state->current_user->email) == 0) {
             student = &state->students->students[i];
             break;
         }
@@ -4732,7 +5741,7 @@ void ui_on_student_view_my_clubs(GtkButton* button, gpointer user_data) {
     
     for (int i = 0; i < state->memberships->count; i++) {
         ClubMembership* m = &state->memberships->memberships[i];
-        if (m->student_id == student->id && m->is_active) {
+        if (m->student_id == student->id && m->is_active && !m->is_deleted) {
             Club* club = club_list_find_by_id(state->clubs, m->club_id);
             if (club) {
                 char date_str[64];
@@ -4743,8 +5752,8 @@ void ui_on_student_view_my_clubs(GtkButton* button, gpointer user_data) {
                 gtk_list_store_append(store, &iter);
                 gtk_list_store_set(store, &iter,
                     0, club->name,
-                    1, club->category,
-                    2, m->role,
+                    1, intern_lookup(club->category),
+                    2, intern_lookup(m->role),
                     3, date_str,
                     -1);
                 club_count++;
@@ -5,6 +5,7 @@
 
 #if defined(_WIN32) || defined(_WIN64)
 #include <windows.h>
+#include <psapi.h>
 #include <io.h>
 #include <direct.h>
 #include <sys/stat.h>
@@ -18,6 +19,9 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <pwd.h>
+#include <sys/resource.h>
+#include <sys/statvfs.h>
+#include <sys/time.h>
 #endif
 
 // Static variables for error handling
@@ -717,6 +721,32 @@ char* utils_file_read_all(const char* filename) {
     return buffer;
 }
 
+// Lines left in an open file, counting a last line without a newline.
+// The read position is restored, so loaders can size their tables before
+// parsing. Returns -1 if the file cannot be scanned.
+long utils_file_count_lines(FILE* file) {
+    if (!file) return -1;
+    
+    long start = ftell(file);
+    if (start < 0) return -1;
+    
+    char buffer[65536];
+    long lines = 0;
+    char last = '\n';
+    size_t read;
+    while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        for (const char* p = buffer; (p = memchr(p, '\n', buffer + read - p)) != NULL; p++) {
+            lines++;
+        }
+        last = buffer[read - 1];
+    }
+    if (last != '\n') lines++;
+    
+    clearerr(file);
+    if (fseek(file, start, SEEK_SET) != 0) return -1;
+    return lines;
+}
+
 int utils_file_write_all(const char* filename, const char* content) {
     if (!filename || !content) return 0;
     
@@ -781,11 +811,28 @@ char* utils_get_executable_dir(char* buffer, size_t buffer_size) {
     return buffer;
 }
 
+static char g_data_dir_override[UTILS_MAX_PATH_LENGTH] = "";
+
+void utils_set_data_dir(const char* dir) {
+    if (!dir) {
+        g_data_dir_override[0] = '\0';
+        return;
+    }
+    snprintf(g_data_dir_override, sizeof(g_data_dir_override), "%s", dir);
+}
+
 char* utils_get_data_file_path(const char* filename, char* buffer, size_t buffer_size) {
     if (!filename || !buffer || buffer_size == 0) return NULL;
     
     // Use absolute path for data directory
     const char* data_dir_base = "c:\\Users\\Karim erradi\\Documents\\c-project1\\data";
+    const char* separator = "\\";
+    if (g_data_dir_override[0] != '\0') {
+        data_dir_base = g_data_dir_override;
+#if !defined(_WIN32) && !defined(_WIN64)
+        separator = "/";
+#endif
+    }
     
     // Check if filename already contains "data/" prefix
     const char* actual_filename = filename;
@@ -801,7 +848,7 @@ char* utils_get_data_file_path(const char* filename, char* buffer, size_t buffer
         // Just the data directory
         written = snprintf(buffer, buffer_size, "%s", data_dir_base);
     } else {
-        written = snprintf(buffer, buffer_size, "%s\\%s", data_dir_base, actual_filename);
+        written = snprintf(buffer, buffer_size, "%s%s%s", data_dir_base, separator, actual_filename);
     }
     
     if (written > 0 && (size_t)written < buffer_size) {
@@ -1472,33 +1519,150 @@ int utils_system_get_current_time(time_t* current_time) {
     return 1;
 }
 
+#if defined(__linux__)
+// Process start as seconds since boot, from field 22 of /proc/self/stat.
+// The command name in field 2 may contain spaces, so fields are counted
+// from its closing parenthesis.
+static int utils_process_start_since_boot(double* start) {
+    FILE* f = fopen("/proc/self/stat", "r");
+    if (!f) return 0;
+    char line[1024];
+    int ok = fgets(line, sizeof(line), f) != NULL;
+    fclose(f);
+    if (!ok) return 0;
+
+    char* p = strrchr(line, ')');
+    if (!p) return 0;
+    // Field 3 follows ") "; field 22 is 19 fields further on
+    p += 2;
+    for (int field = 3; field < 22; field++) {
+        p = strchr(p, ' ');
+        if (!p) return 0;
+        p++;
+    }
+    long ticks_per_second = sysconf(_SC_CLK_TCK);
+    if (ticks_per_second <= 0) return 0;
+    *start = strtoull(p, NULL, 10) / (double)ticks_per_second;
+    return 1;
+}
+#endif
+
+// Seconds since this process started
 int utils_system_get_uptime(long* uptime) {
     if (!uptime) return 0;
-    // Platform-specific implementation would go here
     *uptime = 0;
+#if defined(_WIN32) || defined(_WIN64)
+    FILETIME created, exited, kernel, user, now;
+    if (!GetProcessTimes(GetCurrentProcess(), &created, &exited, &kernel, &user)) return 0;
+    GetSystemTimeAsFileTime(&now);
+    ULARGE_INTEGER from = { .LowPart = created.dwLowDateTime, .HighPart = created.dwHighDateTime };
+    ULARGE_INTEGER to = { .LowPart = now.dwLowDateTime, .HighPart = now.dwHighDateTime };
+    *uptime = (long)((to.QuadPart - from.QuadPart) / 10000000ULL);
+    return 1;
+#elif defined(__linux__)
+    double start, since_boot;
+    FILE* f = fopen("/proc/uptime", "r");
+    if (!f) return 0;
+    int ok = fscanf(f, "%lf", &since_boot) == 1;
+    fclose(f);
+    if (!ok || !utils_process_start_since_boot(&start)) return 0;
+    *uptime = since_boot > start ? (long)(since_boot - start) : 0;
+    return 1;
+#else
     return 0;
+#endif
 }
 
+// Resident set size in bytes
 int utils_system_get_memory_usage(size_t* memory_usage) {
     if (!memory_usage) return 0;
-    // Platform-specific implementation would go here
     *memory_usage = 0;
+#if defined(_WIN32) || defined(_WIN64)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!K32GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+    *memory_usage = counters.WorkingSetSize;
+    return 1;
+#elif defined(__linux__)
+    // statm: total and resident sizes in pages
+    FILE* f = fopen("/proc/self/statm", "r");
+    if (!f) return 0;
+    unsigned long size, resident;
+    int ok = fscanf(f, "%lu %lu", &size, &resident) == 2;
+    fclose(f);
+    if (!ok) return 0;
+    *memory_usage = (size_t)resident * (size_t)sysconf(_SC_PAGESIZE);
+    return 1;
+#else
     return 0;
+#endif
+}
+
+// Process CPU time (user + system) in seconds and a monotonic wall clock
+static int utils_process_cpu_times(double* cpu_seconds, double* wall_seconds) {
+#if defined(_WIN32) || defined(_WIN64)
+    FILETIME created, exited, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &created, &exited, &kernel, &user)) return 0;
+    ULARGE_INTEGER k = { .LowPart = kernel.dwLowDateTime, .HighPart = kernel.dwHighDateTime };
+    ULARGE_INTEGER u = { .LowPart = user.dwLowDateTime, .HighPart = user.dwHighDateTime };
+    *cpu_seconds = (k.QuadPart + u.QuadPart) / 1e7;
+    *wall_seconds = GetTickCount64() / 1e3;
+    return 1;
+#else
+    struct rusage usage;
+    struct timespec now;
+    if (getrusage(RUSAGE_SELF, &usage) != 0 || clock_gettime(CLOCK_MONOTONIC, &now) != 0) return 0;
+    *cpu_seconds = usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6 +
+                   usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+    *wall_seconds = now.tv_sec + now.tv_nsec / 1e9;
+    return 1;
+#endif
 }
 
-int utils_system_get_cpu_usage(float* cpu_usage) {
-    if (!cpu_usage) return 0;
-    // Platform-specific implementation would go here
+// Percent of one core used by this process since the sampler's previous
+// reading; its first reading averages over the process lifetime
+int utils_system_get_cpu_usage(CpuSampler* sampler, float* cpu_usage) {
+    if (!sampler || !cpu_usage) return 0;
     *cpu_usage = 0.0f;
-    return 0;
+
+    double cpu, wall;
+    if (!utils_process_cpu_times(&cpu, &wall)) return 0;
+
+    double cpu_delta, wall_delta;
+    if (!sampler->primed) {
+        long uptime;
+        cpu_delta = cpu;
+        wall_delta = utils_system_get_uptime(&uptime) && uptime > 0 ? (double)uptime : 0.0;
+    } else {
+        cpu_delta = cpu - sampler->last_cpu;
+        wall_delta = wall - sampler->last_wall;
+    }
+    sampler->last_cpu = cpu;
+    sampler->last_wall = wall;
+    sampler->primed = 1;
+
+    if (wall_delta > 0.0) *cpu_usage = (float)(100.0 * cpu_delta / wall_delta);
+    return 1;
 }
 
+// Size of the file system holding path and the bytes still available to
+// this user, both in bytes
 int utils_system_get_disk_usage(const char* path, size_t* total, size_t* free) {
     if (!path || !total || !free) return 0;
-    // Platform-specific implementation would go here
     *total = 0;
     *free = 0;
-    return 0;
+#if defined(_WIN32) || defined(_WIN64)
+    ULARGE_INTEGER available, capacity;
+    if (!GetDiskFreeSpaceExA(path, &available, &capacity, NULL)) return 0;
+    *total = (size_t)capacity.QuadPart;
+    *free = (size_t)available.QuadPart;
+    return 1;
+#else
+    struct statvfs fs;
+    if (statvfs(path, &fs) != 0) return 0;
+    *total = (size_t)fs.f_blocks * fs.f_frsize;
+    *free = (size_t)fs.f_bavail * fs.f_frsize;
+    return 1;
+#endif
 }
 
 int utils_system_get_username(char* username, size_t size) {
@@ -0,0 +1,177 @@
+// Test program for change-log replication (see include/replication.h).
+// A forked follower mirrors a primary's memberships; a membership added the
+// way the UI adds one must reach the follower as a new row and leave the
+// existing rows alone, even where count + 1 is an id already in use.
+// Build and run with ./build.sh test-replication (Linux and macOS).
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <glib.h>
+#include "include/replication.h"
+#include "include/intern.h"
+
+#define TEST_TIMEOUT_MS 10000
+
+// Sparse ids as in generated data: count + 1 = 4 is taken
+static const int initial_ids[] = { 2, 3, 4 };
+#define INITIAL_COUNT 3
+
+static GMainLoop* loop;
+static MembershipList* memberships;
+static int failures = 0;
+
+static void check(int ok, const char* what) {
+    printf("%s %s\n", ok ? "✓" : "✗", what);
+    if (!ok) failures++;
+}
+
+static MembershipList* create_memberships(void) {
+    MembershipList* list = membership_list_create();
+    list->lock = table_lock_create("memberships");
+    for (int i = 0; i < INITIAL_COUNT; i++) {
+        ClubMembership m = { 0 };
+        m.id = initial_ids[i];
+        m.student_id = 100 + i;
+        m.club_id = 1;
+        m.join_date = 1700000000;
+        m.role = intern_string("member");
+        m.is_active = 1;
+        membership_list_add(list, m);
+    }
+    return list;
+}
+
+static ClubMembership* find(int id) {
+    return membership_list_find_by_id(memberships, id);
+}
+
+static gboolean on_timeout(gpointer data) {
+    (void)data;
+    check(0, "replication finished in time");
+    g_main_loop_quit(loop);
+    return G_SOURCE_REMOVE;
+}
+
+// Follower --------------------------------------------------------------------
+
+static gboolean follower_poll(gpointer data) {
+    (void)data;
+    if (memberships->count < INITIAL_COUNT + 2) return G_SOURCE_CONTINUE;
+
+    check(memberships->count == INITIAL_COUNT + 2, "follower has the new memberships as new rows");
+    for (int i = 0; i < INITIAL_COUNT; i++) {
+        ClubMembership* m = find(initial_ids[i]);
+        check(m && m->student_id == 100 + i, "follower kept an existing membership");
+    }
+    ClubMembership* first = find(5);
+    ClubMembership* second = find(6);
+    check(first && first->student_id == 200 && second && second->student_id == 201,
+          "follower's new memberships have the primary's ids");
+    g_main_loop_quit(loop);
+    return G_SOURCE_REMOVE;
+}
+
+static int run_follower(const char* socket_path) {
+    memberships = create_memberships();
+    ReplicationTables tables = { 0 };
+    tables.memberships = memberships;
+    if (!replication_follower_start(socket_path, &tables, NULL, NULL)) return 1;
+    g_timeout_add(50, follower_poll, NULL);
+    g_timeout_add(TEST_TIMEOUT_MS, on_timeout, NULL);
+    g_main_loop_run(loop);
+    replication_follower_stop();
+    return failures > 0;
+}
+
+// Primary ---------------------------------------------------------------------
+
+static int added = 0;
+
+static gboolean primary_poll(gpointer data) {
+    (void)data;
+    ReplicationStatus status;
+    replication_get_status(&status);
+    if (status.connected == 0 || status.snapshots == 0) return G_SOURCE_CONTINUE;
+
+    if (!added) {
+        // As the club dialogs do: the list picks the id
+        ClubMembership m = { 0 };
+        m.student_id = 200;
+        m.club_id = 1;
+        m.join_date = 1700000100;
+        m.role = intern_string("member");
+        m.is_active = 1;
+        check(membership_list_add(memberships, m), "primary added a membership");
+        check(memberships->memberships[memberships->count - 1].id == 5, "new membership got the next free id");
+
+        // As they used to: count + 1 = 5 is the membership just added
+        m.id = memberships->count + 1;
+        m.student_id = 201;
+        check(membership_list_add(memberships, m), "primary added a membership with a taken id");
+        check(memberships->memberships[memberships->count - 1].id == 6, "taken id replaced by the next free id");
+        added = 1;
+    }
+    return added ? G_SOURCE_REMOVE : G_SOURCE_CONTINUE;
+}
+
+// The follower exits once it has checked the change
+static void on_follower_exit(GPid pid, gint status, gpointer data) {
+    (void)pid;
+    (void)data;
+    check(WIFEXITED(status) && WEXITSTATUS(status) == 0, "follower checks passed");
+    g_main_loop_quit(loop);
+}
+
+static int run_primary(const char* socket_path, pid_t follower) {
+    memberships = create_memberships();
+    ReplicationTables tables = { 0 };
+    tables.memberships = memberships;
+    if (!replication_primary_start(socket_path, &tables)) {
+        kill(follower, SIGTERM);
+        waitpid(follower, NULL, 0);
+        return 1;
+    }
+    g_timeout_add(50, primary_poll, NULL);
+    g_child_watch_add(follower, on_follower_exit, NULL);
+    g_timeout_add(TEST_TIMEOUT_MS, on_timeout, NULL);
+    g_main_loop_run(loop);
+    replication_primary_stop();
+    return failures > 0;
+}
+
+// Ids only count as taken while their membership is live; a replica keeps
+// whatever id its primary assigned
+static void check_membership_ids(void) {
+    MembershipList* list = create_memberships();
+    ClubMembership m = list->memberships[0];
+    membership_list_remove(list, m.id);
+    check(membership_list_add(list, m) && list->memberships[list->count - 1].id == m.id,
+          "id of a removed membership can be given again");
+    m.student_id = 300;
+    check(membership_list_add_with_id(list, m) && list->memberships[list->count - 1].id == m.id,
+          "replicated membership keeps the primary's id");
+    membership_list_destroy(list);
+}
+
+int main(void) {
+    printf("=== Replication Test ===\n\n");
+    check_membership_ids();
+    char socket_path[64];
+    snprintf(socket_path, sizeof(socket_path), "/tmp/test_replication_%d.sock", (int)getpid());
+
+    // Fork before any thread exists
+    fflush(stdout);
+    pid_t follower = fork();
+    if (follower < 0) {
+        perror("fork");
+        return 1;
+    }
+    loop = g_main_loop_new(NULL, FALSE);
+    if (follower == 0) return run_follower(socket_path);
+
+    int result = run_primary(socket_path, follower);
+    printf("\n%s\n", result == 0 ? "All replication checks passed" : "Replication checks FAILED");
+    return result;
+}